@@ -67,6 +67,10 @@ struct hash_table;
 void ac_gather_context_rolls(FILE *f, uint32_t **ibs, uint32_t *ib_dw_sizes, unsigned num_ibs,
                              struct hash_table *annotations, const struct radeon_info *info);
 
+/* ac_ib_stats.c */
+void ac_gather_ib_stats(FILE *f, uint32_t **ibs, uint32_t *ib_dw_sizes, unsigned num_ibs,
+                        const struct radeon_info *info);
+
 /* ac_parse_ib.c */
 
 struct ac_ib_parser {
@@ -0,0 +1,365 @@
+/*
+ * Copyright 2024 Advanced Micro Devices, Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Fast non-printing IB walker for analyzing large IB captures.
+ *
+ * It gathers the number of context rolls, the number of packets per opcode and the number
+ * of writes per register, and prints them in a machine-readable form, one value per line:
+ *    context_rolls <count>
+ *    packet <name> <count>
+ *    reg <name> <count>
+ *
+ * Each IB chunk (IBs are split on chained-IB boundaries) is walked by a separate job,
+ * and the jobs are executed in parallel. The context roll state at the beginning of
+ * a chunk is unknown when its job is executed, so every job tracks all possible initial
+ * states and the results are connected in order afterwards.
+ *
+ * Usage for radeonsi:
+ *    AMD_IB_STATS=filename app
+ */
+
+#include "ac_debug.h"
+#include "sid.h"
+#include "sid_tables.h"
+
+#include "util/u_cpu_detect.h"
+#include "util/u_memory.h"
+#include "util/u_queue.h"
+
+#include <inttypes.h>
+
+#define NUM_CONTEXT_REGS (SI_CONTEXT_REG_SPACE_SIZE / 4)
+#define NUM_SH_REGS      (SI_SH_REG_SPACE_SIZE / 4)
+#define NUM_UCONFIG_REGS (SI_UCONFIG_REG_SPACE_SIZE / 4)
+
+/* The context roll state is (context_busy, MIN2(num_busy_contexts, 2)) as in
+ * ac_gather_context_rolls, encoded as context_busy * 3 + num_busy_contexts.
+ */
+#define NUM_ROLL_STATES 6
+
+struct ac_ib_chunk_stats {
+   const uint32_t *ib;
+   unsigned num_dw;
+   const struct radeon_info *info;
+   struct util_queue_fence fence;
+
+   /* Set if the walker stopped at a packet it can't parse. */
+   bool invalid;
+
+   /* The current state and the number of context rolls for each initial state. */
+   uint8_t roll_state[NUM_ROLL_STATES];
+   uint32_t num_rolls[NUM_ROLL_STATES];
+
+   uint32_t packets[256];
+   uint32_t context_regs[NUM_CONTEXT_REGS];
+   uint32_t sh_regs[NUM_SH_REGS];
+   uint32_t uconfig_regs[NUM_UCONFIG_REGS];
+};
+
+static void ac_ib_stats_draw(struct ac_ib_chunk_stats *chunk)
+{
+   for (unsigned i = 0; i < NUM_ROLL_STATES; i++) {
+      if (chunk->roll_state[i] < 3)
+         chunk->roll_state[i] += 3;
+   }
+}
+
+static unsigned ac_ib_stats_roll_state(unsigned state)
+{
+   if (state < 3)
+      return state;
+
+   /* The busy context is rolled. */
+   return MIN2(state - 3 + 1, 2);
+}
+
+static void ac_ib_stats_roll_context(struct ac_ib_chunk_stats *chunk)
+{
+   for (unsigned i = 0; i < NUM_ROLL_STATES; i++) {
+      unsigned state = chunk->roll_state[i];
+
+      if (state < 3)
+         continue;
+
+      chunk->roll_state[i] = ac_ib_stats_roll_state(state);
+
+      /* Ignore the first context at the beginning or after waiting for idle. */
+      if (chunk->roll_state[i] == 2)
+         chunk->num_rolls[i]++;
+   }
+}
+
+static void ac_ib_stats_wait_idle(struct ac_ib_chunk_stats *chunk)
+{
+   memset(chunk->roll_state, 0, sizeof(chunk->roll_state));
+}
+
+static void ac_ib_stats_set_reg(struct ac_ib_chunk_stats *chunk, unsigned reg_base,
+                                unsigned reg_rel_dw_offset)
+{
+   switch (reg_base) {
+   case SI_CONTEXT_REG_OFFSET:
+      if (reg_rel_dw_offset < NUM_CONTEXT_REGS)
+         chunk->context_regs[reg_rel_dw_offset]++;
+      break;
+   case SI_SH_REG_OFFSET:
+      if (reg_rel_dw_offset < NUM_SH_REGS)
+         chunk->sh_regs[reg_rel_dw_offset]++;
+      break;
+   case CIK_UCONFIG_REG_OFFSET:
+      if (reg_rel_dw_offset < NUM_UCONFIG_REGS)
+         chunk->uconfig_regs[reg_rel_dw_offset]++;
+      break;
+   }
+}
+
+static void ac_ib_stats_set_reg_seq(struct ac_ib_chunk_stats *chunk, unsigned reg_base,
+                                    const uint32_t *body, int count)
+{
+   unsigned reg_rel_dw_offset = body[0] & 0xFFFF;
+
+   for (int i = 0; i < count; i++)
+      ac_ib_stats_set_reg(chunk, reg_base, reg_rel_dw_offset + i);
+}
+
+static void ac_ib_stats_set_reg_pairs(struct ac_ib_chunk_stats *chunk, unsigned reg_base,
+                                      const uint32_t *body, int count)
+{
+   for (int i = 0; i < (count + 1) / 2; i++)
+      ac_ib_stats_set_reg(chunk, reg_base, body[i * 2]);
+}
+
+static void ac_ib_stats_set_reg_pairs_packed(struct ac_ib_chunk_stats *chunk, unsigned reg_base,
+                                             const uint32_t *body, int count)
+{
+   /* The first dword is the register count. */
+   for (int i = 0; i < count / 3; i++) {
+      unsigned offsets = body[1 + i * 3];
+
+      ac_ib_stats_set_reg(chunk, reg_base, offsets & 0xffff);
+      ac_ib_stats_set_reg(chunk, reg_base, offsets >> 16);
+   }
+}
+
+static void ac_ib_stats_walk_chunk(void *job, void *gdata, int thread_index)
+{
+   struct ac_ib_chunk_stats *chunk = (struct ac_ib_chunk_stats *)job;
+   const uint32_t *ib = chunk->ib;
+   unsigned num_dw = chunk->num_dw;
+
+   for (unsigned i = 0; i < NUM_ROLL_STATES; i++)
+      chunk->roll_state[i] = i;
+
+   for (unsigned cur_dw = 0; cur_dw < num_dw;) {
+      uint32_t header = ib[cur_dw++];
+      unsigned type = PKT_TYPE_G(header);
+
+      /* Type-2 packets are 1-dword NOPs. */
+      if (type == 2)
+         continue;
+
+      if (type != 3) {
+         chunk->invalid = true;
+         return;
+      }
+
+      int count = PKT_COUNT_G(header);
+      unsigned op = PKT3_IT_OPCODE_G(header);
+      const uint32_t *body = ib + cur_dw;
+
+      if (cur_dw + count + 1 > num_dw) {
+         chunk->invalid = true;
+         return;
+      }
+
+      chunk->packets[op]++;
+
+      switch (op) {
+      case PKT3_SET_CONTEXT_REG:
+         ac_ib_stats_roll_context(chunk);
+         ac_ib_stats_set_reg_seq(chunk, SI_CONTEXT_REG_OFFSET, body, count);
+         break;
+      case PKT3_SET_CONTEXT_REG_PAIRS:
+         ac_ib_stats_roll_context(chunk);
+         ac_ib_stats_set_reg_pairs(chunk, SI_CONTEXT_REG_OFFSET, body, count);
+         break;
+      case PKT3_SET_CONTEXT_REG_PAIRS_PACKED:
+         ac_ib_stats_roll_context(chunk);
+         ac_ib_stats_set_reg_pairs_packed(chunk, SI_CONTEXT_REG_OFFSET, body, count);
+         break;
+      case PKT3_SET_SH_REG:
+      case PKT3_SET_SH_REG_INDEX:
+         ac_ib_stats_set_reg_seq(chunk, SI_SH_REG_OFFSET, body, count);
+         break;
+      case PKT3_SET_SH_REG_PAIRS:
+         ac_ib_stats_set_reg_pairs(chunk, SI_SH_REG_OFFSET, body, count);
+         break;
+      case PKT3_SET_SH_REG_PAIRS_PACKED:
+      case PKT3_SET_SH_REG_PAIRS_PACKED_N:
+         ac_ib_stats_set_reg_pairs_packed(chunk, SI_SH_REG_OFFSET, body, count);
+         break;
+      case PKT3_SET_UCONFIG_REG:
+      case PKT3_SET_UCONFIG_REG_INDEX:
+         ac_ib_stats_set_reg_seq(chunk, CIK_UCONFIG_REG_OFFSET, body, count);
+         break;
+
+      case PKT3_CLEAR_STATE:
+         ac_ib_stats_roll_context(chunk);
+         break;
+
+      case PKT3_ACQUIRE_MEM:
+         if (G_580_PWS_ENA2(body[0]))
+            ac_ib_stats_wait_idle(chunk);
+         else
+            ac_ib_stats_roll_context(chunk);
+         break;
+
+      case PKT3_WAIT_REG_MEM:
+         ac_ib_stats_wait_idle(chunk);
+         break;
+
+      case PKT3_EVENT_WRITE:
+         if (G_490_EVENT_TYPE(body[0]) == V_028A90_PS_PARTIAL_FLUSH)
+            ac_ib_stats_wait_idle(chunk);
+         break;
+
+      case PKT3_DRAW_INDEX_AUTO:
+      case PKT3_DRAW_INDEX_IMMD:
+      case PKT3_DRAW_INDEX_MULTI_AUTO:
+      case PKT3_DRAW_INDEX_2:
+      case PKT3_DRAW_INDEX_OFFSET_2:
+      case PKT3_DRAW_INDIRECT:
+      case PKT3_DRAW_INDEX_INDIRECT:
+      case PKT3_DRAW_INDIRECT_MULTI:
+      case PKT3_DRAW_INDEX_INDIRECT_MULTI:
+      case PKT3_DISPATCH_MESH_DIRECT:
+      case PKT3_DISPATCH_MESH_INDIRECT_MULTI:
+      case PKT3_DISPATCH_TASKMESH_GFX:
+         ac_ib_stats_draw(chunk);
+         break;
+
+      case PKT3_INDIRECT_BUFFER:
+         /* Chaining. The next chunk is a separate job. */
+         return;
+      }
+
+      cur_dw += count + 1;
+   }
+}
+
+static void ac_ib_stats_print_regs(FILE *f, const struct radeon_info *info, unsigned reg_base,
+                                   const uint64_t *counts, unsigned num_regs)
+{
+   for (unsigned i = 0; i < num_regs; i++) {
+      if (!counts[i])
+         continue;
+
+      unsigned reg_offset = reg_base + i * 4;
+      const struct si_reg *reg = ac_find_register(info->gfx_level, info->family, reg_offset);
+
+      if (reg)
+         fprintf(f, "reg %s %" PRIu64 "\n", sid_strings + reg->name_offset, counts[i]);
+      else
+         fprintf(f, "reg 0x%X %" PRIu64 "\n", reg_offset, counts[i]);
+   }
+}
+
+void ac_gather_ib_stats(FILE *f, uint32_t **ibs, uint32_t *ib_dw_sizes, unsigned num_ibs,
+                        const struct radeon_info *info)
+{
+   struct ac_ib_chunk_stats *chunks = CALLOC(num_ibs, sizeof(*chunks));
+   if (!chunks)
+      return;
+
+   for (unsigned i = 0; i < num_ibs; i++) {
+      chunks[i].ib = ibs[i];
+      chunks[i].num_dw = ib_dw_sizes[i];
+      chunks[i].info = info;
+      util_queue_fence_init(&chunks[i].fence);
+   }
+
+   /* Walk the chunks. */
+   struct util_queue queue = {0};
+   unsigned num_threads = MIN2(num_ibs, util_get_cpu_caps()->nr_cpus);
+
+   if (num_threads > 1 &&
+       util_queue_init(&queue, "ac_ib_stats", num_ibs, num_threads, 0, NULL)) {
+      for (unsigned i = 0; i < num_ibs; i++) {
+         util_queue_add_job(&queue, &chunks[i], &chunks[i].fence, ac_ib_stats_walk_chunk,
+                            NULL, 0);
+      }
+      for (unsigned i = 0; i < num_ibs; i++)
+         util_queue_fence_wait(&chunks[i].fence);
+      util_queue_destroy(&queue);
+   } else {
+      for (unsigned i = 0; i < num_ibs; i++)
+         ac_ib_stats_walk_chunk(&chunks[i], NULL, 0);
+   }
+
+   /* Connect the context roll states of consecutive chunks and sum up the counts. */
+   uint64_t *context_regs = CALLOC(NUM_CONTEXT_REGS, sizeof(uint64_t));
+   uint64_t *sh_regs = CALLOC(NUM_SH_REGS, sizeof(uint64_t));
+   uint64_t *uconfig_regs = CALLOC(NUM_UCONFIG_REGS, sizeof(uint64_t));
+   uint64_t packets[256] = {0};
+   uint64_t num_rolls = 0;
+   unsigned state = 0;
+
+   if (!context_regs || !sh_regs || !uconfig_regs)
+      goto out;
+
+   for (unsigned i = 0; i < num_ibs; i++) {
+      struct ac_ib_chunk_stats *chunk = &chunks[i];
+
+      if (chunk->invalid)
+         fprintf(f, "invalid_chunk %u\n", i);
+
+      num_rolls += chunk->num_rolls[state];
+      state = chunk->roll_state[state];
+
+      for (unsigned j = 0; j < ARRAY_SIZE(packets); j++)
+         packets[j] += chunk->packets[j];
+      for (unsigned j = 0; j < NUM_CONTEXT_REGS; j++)
+         context_regs[j] += chunk->context_regs[j];
+      for (unsigned j = 0; j < NUM_SH_REGS; j++)
+         sh_regs[j] += chunk->sh_regs[j];
+      for (unsigned j = 0; j < NUM_UCONFIG_REGS; j++)
+         uconfig_regs[j] += chunk->uconfig_regs[j];
+   }
+
+   /* Roll the last context like ac_gather_context_rolls does. */
+   if (state >= 3 && ac_ib_stats_roll_state(state) == 2)
+      num_rolls++;
+
+   fprintf(f, "context_rolls %" PRIu64 "\n", num_rolls);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(packets); i++) {
+      if (!packets[i])
+         continue;
+
+      unsigned j;
+      for (j = 0; j < ARRAY_SIZE(packet3_table); j++) {
+         if (packet3_table[j].op == i)
+            break;
+      }
+
+      if (j < ARRAY_SIZE(packet3_table))
+         fprintf(f, "packet %s %" PRIu64 "\n", sid_strings + packet3_table[j].name_offset, packets[i]);
+      else
+         fprintf(f, "packet 0x%02X %" PRIu64 "\n", i, packets[i]);
+   }
+
+   ac_ib_stats_print_regs(f, info, SI_CONTEXT_REG_OFFSET, context_regs, NUM_CONTEXT_REGS);
+   ac_ib_stats_print_regs(f, info, SI_SH_REG_OFFSET, sh_regs, NUM_SH_REGS);
+   ac_ib_stats_print_regs(f, info, CIK_UCONFIG_REG_OFFSET, uconfig_regs, NUM_UCONFIG_REGS);
+
+out:
+   FREE(context_regs);
+   FREE(sh_regs);
+   FREE(uconfig_regs);
+   for (unsigned i = 0; i < num_ibs; i++)
+      util_queue_fence_destroy(&chunks[i].fence);
+   FREE(chunks);
+}
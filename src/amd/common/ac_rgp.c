@@ -1187,24 +1187,14 @@ ac_sqtt_dump_data(const struct radeon_info *rad_info, struct ac_sqtt_trace *sqtt
 #endif
 
 int
-ac_dump_rgp_capture(const struct radeon_info *info, struct ac_sqtt_trace *sqtt_trace,
-                    const struct ac_spm_trace *spm_trace)
+ac_dump_rgp_capture_to_file(const struct radeon_info *info, struct ac_sqtt_trace *sqtt_trace,
+                            const struct ac_spm_trace *spm_trace, const char *filename)
 {
 #if !defined(USE_LIBELF)
    return -1;
 #else
-   char filename[2048];
-   struct tm now;
-   time_t t;
    FILE *f;
 
-   t = time(NULL);
-   now = *localtime(&t);
-
-   snprintf(filename, sizeof(filename), "/tmp/%s_%04d.%02d.%02d_%02d.%02d.%02d.rgp",
-            util_get_process_name(), 1900 + now.tm_year, now.tm_mon + 1, now.tm_mday, now.tm_hour,
-            now.tm_min, now.tm_sec);
-
    f = fopen(filename, "w+");
    if (!f)
       return -1;
@@ -1217,3 +1207,21 @@ ac_dump_rgp_capture(const struct radeon_info *info, struct ac_sqtt_trace *sqtt_t
    return 0;
 #endif
 }
+
+int
+ac_dump_rgp_capture(const struct radeon_info *info, struct ac_sqtt_trace *sqtt_trace,
+                    const struct ac_spm_trace *spm_trace)
+{
+   char filename[2048];
+   struct tm now;
+   time_t t;
+
+   t = time(NULL);
+   now = *localtime(&t);
+
+   snprintf(filename, sizeof(filename), "/tmp/%s_%04d.%02d.%02d_%02d.%02d.%02d.rgp",
+            util_get_process_name(), 1900 + now.tm_year, now.tm_mon + 1, now.tm_mday, now.tm_hour,
+            now.tm_min, now.tm_sec);
+
+   return ac_dump_rgp_capture_to_file(info, sqtt_trace, spm_trace, filename);
+}
@@ -178,6 +178,9 @@ struct rgp_clock_calibration {
 int ac_dump_rgp_capture(const struct radeon_info *info, struct ac_sqtt_trace *sqtt_trace,
                         const struct ac_spm_trace *spm_trace);
 
+int ac_dump_rgp_capture_to_file(const struct radeon_info *info, struct ac_sqtt_trace *sqtt_trace,
+                                const struct ac_spm_trace *spm_trace, const char *filename);
+
 void
 ac_rgp_file_write_elf_object(FILE *output, size_t file_elf_start,
                              struct rgp_code_object_record *record,
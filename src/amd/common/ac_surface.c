@@ -71,9 +71,44 @@
 #define CIASICIDGFXENGINE_ARCTICISLAND 0x0000000D
 #endif
 
+/* Maximum number of surface layouts remembered by ac_compute_surface. */
+#define AC_SURF_CACHE_MAX_ENTRIES 512
+
 struct ac_addrlib {
    ADDR_HANDLE handle;
    simple_mtx_t lock;
+
+   /* Cache of computed surface layouts, protected by cache_lock. */
+   simple_mtx_t cache_lock;
+   struct hash_table *surf_cache;
+};
+
+/* All inputs of ac_compute_surface. The GPU is identified by the radeon_info pointer
+ * because the driver is allowed to change its radeon_info.
+ */
+struct ac_surf_cache_key {
+   const struct radeon_info *info;
+   struct radeon_surf surf;
+   uint32_t width;
+   uint32_t height;
+   uint32_t depth;
+   uint16_t array_size;
+   uint8_t samples;
+   uint8_t storage_samples;
+   uint8_t levels;
+   uint8_t num_channels;
+   uint8_t has_surf_index;
+   uint8_t has_fmask_surf_index;
+   uint8_t is_1d;
+   uint8_t is_3d;
+   uint8_t is_cube;
+   uint8_t is_array;
+   uint32_t mode;
+};
+
+struct ac_surf_cache_entry {
+   struct ac_surf_cache_key key;
+   struct radeon_surf surf;
 };
 
 unsigned ac_pipe_config_to_num_pipes(unsigned pipe_config)
@@ -525,6 +560,16 @@ static ADDR_E_RETURNCODE ADDR_API freeSysMem(const ADDR_FREESYSMEM_INPUT *pInput
    return ADDR_OK;
 }
 
+static uint32_t ac_surf_cache_key_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct ac_surf_cache_key));
+}
+
+static bool ac_surf_cache_key_equal(const void *a, const void *b)
+{
+   return memcmp(a, b, sizeof(struct ac_surf_cache_key)) == 0;
+}
+
 struct ac_addrlib *ac_addrlib_create(const struct radeon_info *info,
                                      uint64_t *max_alignment)
 {
@@ -595,11 +640,25 @@ struct ac_addrlib *ac_addrlib_create(const struct radeon_info *info,
 
    addrlib->handle = addrCreateOutput.hLib;
    simple_mtx_init(&addrlib->lock, mtx_plain);
+   simple_mtx_init(&addrlib->cache_lock, mtx_plain);
+   addrlib->surf_cache = _mesa_hash_table_create(NULL, ac_surf_cache_key_hash,
+                                                 ac_surf_cache_key_equal);
+   if (!addrlib->surf_cache) {
+      ac_addrlib_destroy(addrlib);
+      return NULL;
+   }
    return addrlib;
 }
 
+static void ac_surf_cache_entry_free(struct hash_entry *entry)
+{
+   free(entry->data);
+}
+
 void ac_addrlib_destroy(struct ac_addrlib *addrlib)
 {
+   _mesa_hash_table_destroy(addrlib->surf_cache, ac_surf_cache_entry_free);
+   simple_mtx_destroy(&addrlib->cache_lock);
    simple_mtx_destroy(&addrlib->lock);
    AddrDestroy(addrlib->handle);
    free(addrlib);
@@ -2592,9 +2651,9 @@ static int gfx9_compute_surface(struct ac_addrlib *addrlib, const struct radeon_
    return 0;
 }
 
-int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
-                       const struct ac_surf_config *config, enum radeon_surf_mode mode,
-                       struct radeon_surf *surf)
+static int ac_compute_surface_uncached(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                                       const struct ac_surf_config *config,
+                                       enum radeon_surf_mode mode, struct radeon_surf *surf)
 {
    int r;
 
@@ -2660,6 +2719,87 @@ int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *inf
    return 0;
 }
 
+static void ac_surf_cache_key_init(struct ac_surf_cache_key *key, const struct radeon_info *info,
+                                   const struct ac_surf_config *config,
+                                   enum radeon_surf_mode mode, const struct radeon_surf *surf)
+{
+   memset(key, 0, sizeof(*key));
+   key->info = info;
+   memcpy(&key->surf, surf, sizeof(*surf));
+   key->width = config->info.width;
+   key->height = config->info.height;
+   key->depth = config->info.depth;
+   key->array_size = config->info.array_size;
+   key->samples = config->info.samples;
+   key->storage_samples = config->info.storage_samples;
+   key->levels = config->info.levels;
+   key->num_channels = config->info.num_channels;
+   key->has_surf_index = config->info.surf_index != NULL;
+   key->has_fmask_surf_index = config->info.fmask_surf_index != NULL;
+   key->is_1d = config->is_1d;
+   key->is_3d = config->is_3d;
+   key->is_cube = config->is_cube;
+   key->is_array = config->is_array;
+   key->mode = mode;
+}
+
+/* Apps often create many textures with the same layout, so remember the results and skip
+ * addrlib for them. Layouts that used a surface index for tile swizzling are not cached
+ * because every surface should get a different swizzle.
+ */
+int ac_compute_surface(struct ac_addrlib *addrlib, const struct radeon_info *info,
+                       const struct ac_surf_config *config, enum radeon_surf_mode mode,
+                       struct radeon_surf *surf)
+{
+   struct ac_surf_cache_key key;
+   int r;
+
+   ac_surf_cache_key_init(&key, info, config, mode, surf);
+
+   simple_mtx_lock(&addrlib->cache_lock);
+   struct hash_entry *entry = _mesa_hash_table_search(addrlib->surf_cache, &key);
+   if (entry) {
+      *surf = ((struct ac_surf_cache_entry *)entry->data)->surf;
+      simple_mtx_unlock(&addrlib->cache_lock);
+      return 0;
+   }
+   simple_mtx_unlock(&addrlib->cache_lock);
+
+   /* The surface indices only increase, so if they don't change, they weren't used. */
+   uint32_t surf_index = config->info.surf_index ? p_atomic_read(config->info.surf_index) : 0;
+   uint32_t fmask_surf_index =
+      config->info.fmask_surf_index ? p_atomic_read(config->info.fmask_surf_index) : 0;
+
+   r = ac_compute_surface_uncached(addrlib, info, config, mode, surf);
+   if (r)
+      return r;
+
+   if ((config->info.surf_index && p_atomic_read(config->info.surf_index) != surf_index) ||
+       (config->info.fmask_surf_index &&
+        p_atomic_read(config->info.fmask_surf_index) != fmask_surf_index))
+      return 0;
+
+   struct ac_surf_cache_entry *new_entry = malloc(sizeof(*new_entry));
+   if (!new_entry)
+      return 0;
+
+   new_entry->key = key;
+   new_entry->surf = *surf;
+
+   simple_mtx_lock(&addrlib->cache_lock);
+   if (_mesa_hash_table_num_entries(addrlib->surf_cache) >= AC_SURF_CACHE_MAX_ENTRIES)
+      _mesa_hash_table_clear(addrlib->surf_cache, ac_surf_cache_entry_free);
+
+   entry = _mesa_hash_table_search(addrlib->surf_cache, &key);
+   if (entry) {
+      free(new_entry);
+   } else {
+      _mesa_hash_table_insert(addrlib->surf_cache, &new_entry->key, new_entry);
+   }
+   simple_mtx_unlock(&addrlib->cache_lock);
+   return 0;
+}
+
 /* This is meant to be used for disabling DCC. */
 void ac_surface_zero_dcc_fields(struct radeon_surf *surf)
 {
@@ -9,6 +9,7 @@
 #include "aco_ir.h"
 
 #include "util/memstream.h"
+#include "util/os_time.h"
 
 #include "ac_gpu_info.h"
 #include <array>
@@ -46,9 +47,44 @@ static const std::array<aco_compiler_statistic_info, aco_num_statistics> statist
    ret[aco_statistic_vmem] = aco_compiler_statistic_info{"VMEM", "Number of VMEM instructions"};
    ret[aco_statistic_smem] = aco_compiler_statistic_info{"SMEM", "Number of SMEM instructions"};
    ret[aco_statistic_vopd] = aco_compiler_statistic_info{"VOPD", "Number of VOPD instructions"};
+   ret[aco_statistic_arena_kib] =
+      aco_compiler_statistic_info{"Arena KiB", "Peak size of the compiler's IR arena in KiB"};
+   ret[aco_statistic_isel_us] =
+      aco_compiler_statistic_info{"ISel us", "Instruction selection time in microseconds"};
+   ret[aco_statistic_opt_us] =
+      aco_compiler_statistic_info{"Opt us", "Value numbering and optimizer time in microseconds"};
+   ret[aco_statistic_spill_us] =
+      aco_compiler_statistic_info{"Spill us", "Spiller time in microseconds"};
+   ret[aco_statistic_sched_us] =
+      aco_compiler_statistic_info{"Sched us", "Scheduler time in microseconds"};
+   ret[aco_statistic_ra_us] =
+      aco_compiler_statistic_info{"RA us", "Register allocation time in microseconds"};
+   ret[aco_statistic_waitcnt_us] =
+      aco_compiler_statistic_info{"Waitcnt us", "Wait state and NOP insertion time in microseconds"};
    return ret;
 }();
 
+/* Adds the time spent in its scope to a compile time statistic. */
+class pass_timer {
+public:
+   pass_timer(Program* program_, aco_statistic stat_) : program(program_), stat(stat_)
+   {
+      if (program->collect_statistics)
+         start = os_time_get_nano();
+   }
+
+   ~pass_timer()
+   {
+      if (program->collect_statistics)
+         program->statistics[stat] += (os_time_get_nano() - start) / 1000;
+   }
+
+private:
+   Program* program;
+   aco_statistic stat;
+   int64_t start = 0;
+};
+
 static void
 validate(Program* program)
 {
@@ -108,7 +144,8 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
 
       /* Optimization */
       if (!options->optimisations_disabled) {
-         if (!(debug_flags & DEBUG_NO_VN))
+         pass_timer timer(program.get(), aco_statistic_opt_us);
+         if (!options->fast_compile && !(debug_flags & DEBUG_NO_VN))
             value_numbering(program.get());
          if (!(debug_flags & DEBUG_NO_OPT))
             optimize(program.get());
@@ -123,6 +160,7 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
       live_vars = live_var_analysis(program.get());
       if (program->collect_statistics)
          collect_presched_stats(program.get());
+      pass_timer timer(program.get(), aco_statistic_spill_us);
       spill(program.get(), live_vars);
    }
 
@@ -145,12 +183,18 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
       aco_print_program(program.get(), stderr, live_vars, print_live_vars | print_kill);
 
    if (!info->is_trap_handler_shader) {
-      if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED))
+      if (!options->optimisations_disabled && !options->fast_compile &&
+          !(debug_flags & DEBUG_NO_SCHED)) {
+         pass_timer timer(program.get(), aco_statistic_sched_us);
          schedule_program(program.get(), live_vars);
+      }
       validate(program.get());
 
       /* Register Allocation */
-      register_allocation(program.get(), live_vars);
+      {
+         pass_timer timer(program.get(), aco_statistic_ra_us);
+         register_allocation(program.get(), live_vars);
+      }
 
       if (validate_ra(program.get())) {
          aco_print_program(program.get(), stderr);
@@ -162,7 +206,9 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
       validate(program.get());
 
       /* Optimization */
-      if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_OPT)) {
+      if (!options->optimisations_disabled && !options->fast_compile &&
+          !(debug_flags & DEBUG_NO_OPT)) {
+         pass_timer timer(program.get(), aco_statistic_opt_us);
          optimize_postRA(program.get());
          validate(program.get());
       }
@@ -174,16 +220,25 @@ aco_postprocess_shader(const struct aco_compiler_options* options,
    lower_to_hw_instr(program.get());
    validate(program.get());
 
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED_VOPD))
+   if (!options->optimisations_disabled && !options->fast_compile &&
+       !(debug_flags & DEBUG_NO_SCHED_VOPD)) {
+      pass_timer timer(program.get(), aco_statistic_sched_us);
       schedule_vopd(program.get());
+   }
 
    /* Schedule hardware instructions for ILP */
-   if (!options->optimisations_disabled && !(debug_flags & DEBUG_NO_SCHED_ILP))
+   if (!options->optimisations_disabled && !options->fast_compile &&
+       !(debug_flags & DEBUG_NO_SCHED_ILP)) {
+      pass_timer timer(program.get(), aco_statistic_sched_us);
       schedule_ilp(program.get());
+   }
 
    /* Insert Waitcnt */
-   insert_wait_states(program.get());
-   insert_NOPs(program.get());
+   {
+      pass_timer timer(program.get(), aco_statistic_waitcnt_us);
+      insert_wait_states(program.get());
+      insert_NOPs(program.get());
+   }
 
    if (program->gfx_level >= GFX10)
       form_hard_clauses(program.get());
@@ -260,10 +315,13 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
    program->debug.private_data = options->debug.private_data;
 
    /* Instruction Selection */
-   if (info->is_trap_handler_shader)
-      select_trap_handler_shader(program.get(), shaders[0], &config, options, info, args);
-   else
-      select_program(program.get(), shader_count, shaders, &config, options, info, args);
+   {
+      pass_timer timer(program.get(), aco_statistic_isel_us);
+      if (info->is_trap_handler_shader)
+         select_trap_handler_shader(program.get(), shaders[0], &config, options, info, args);
+      else
+         select_program(program.get(), shader_count, shaders, &config, options, info, args);
+   }
 
    std::string llvm_ir = aco_postprocess_shader(options, info, program);
 
@@ -276,8 +334,10 @@ aco_compile_shader(const struct aco_compiler_options* options, const struct aco_
    bool append_endpgm = !(options->is_opengl && info->has_epilog);
    unsigned exec_size = emit_program(program.get(), code, &symbols, append_endpgm);
 
-   if (program->collect_statistics)
+   if (program->collect_statistics) {
       collect_postasm_stats(program.get(), code);
+      program->statistics[aco_statistic_arena_kib] = DIV_ROUND_UP(program->m.get_peak_size(), 1024);
+   }
 
    bool get_disasm = options->dump_shader || options->record_ir;
 
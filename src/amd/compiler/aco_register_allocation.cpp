@@ -32,6 +32,68 @@ get_subdword_definition_info(Program* program, const aco_ptr<Instruction>& instr
 void add_subdword_definition(Program* program, aco_ptr<Instruction>& instr, PhysReg reg,
                              bool allow_16bit_write);
 
+/* Set of physical registers which can be scanned a word at a time. */
+struct PhysRegSet {
+   std::array<uint64_t, 8> words = {};
+
+   bool operator[](unsigned reg) const { return (words[reg / 64] >> (reg % 64)) & 1; }
+
+   void set(unsigned reg) { words[reg / 64] |= BITFIELD64_BIT(reg % 64); }
+
+   void set(unsigned reg, bool value)
+   {
+      if (value)
+         set(reg);
+      else
+         words[reg / 64] &= ~BITFIELD64_BIT(reg % 64);
+   }
+
+   void reset() { words.fill(0); }
+
+   PhysRegSet operator|(const PhysRegSet& other) const
+   {
+      PhysRegSet res;
+      for (unsigned i = 0; i < words.size(); i++)
+         res.words[i] = words[i] | other.words[i];
+      return res;
+   }
+
+   /* Returns the first register in [lo, hi) which is (or isn't) part of the set, or hi. */
+   unsigned find_next(unsigned lo, unsigned hi, bool in_set) const
+   {
+      for (unsigned reg = lo; reg < hi; reg = ROUND_DOWN_TO(reg, 64) + 64) {
+         uint64_t word = in_set ? words[reg / 64] : ~words[reg / 64];
+         word &= ~BITFIELD64_MASK(reg % 64);
+         if (word)
+            return MIN2(ROUND_DOWN_TO(reg, 64) + ffsll(word) - 1, hi);
+      }
+      return hi;
+   }
+
+   /* Number of registers in [lo, lo + size) which are part of the set. */
+   unsigned count(unsigned lo, unsigned size) const
+   {
+      unsigned res = 0;
+      for (unsigned reg = lo, end = lo + size; reg < end;) {
+         unsigned bits = MIN2(64 - reg % 64, end - reg);
+         res += util_bitcount64((words[reg / 64] >> (reg % 64)) & BITFIELD64_MASK(bits));
+         reg += bits;
+      }
+      return res;
+   }
+
+   bool any(unsigned lo, unsigned size) const
+   {
+      for (unsigned reg = lo, end = lo + size; reg < end;) {
+         unsigned bits = MIN2(64 - reg % 64, end - reg);
+         if ((words[reg / 64] >> (reg % 64)) & BITFIELD64_MASK(bits))
+            return true;
+         reg += bits;
+      }
+      return false;
+   }
+};
+
 struct assignment {
    PhysReg reg;
    RegClass rc;
@@ -70,7 +132,7 @@ struct ra_ctx {
    uint16_t max_used_vgpr = 0;
    uint16_t sgpr_limit;
    uint16_t vgpr_limit;
-   std::bitset<512> war_hint;
+   PhysRegSet war_hint;
 
    uint16_t sgpr_bounds;
    uint16_t vgpr_bounds;
@@ -255,22 +317,22 @@ public:
 
    std::array<uint32_t, 512> regs;
    std::map<uint32_t, std::array<uint32_t, 4>> subdword_regs;
+   /* Registers with a non-zero entry in regs */
+   PhysRegSet used;
 
    const uint32_t& operator[](PhysReg index) const { return regs[index]; }
 
-   uint32_t& operator[](PhysReg index) { return regs[index]; }
-
    unsigned count_zero(PhysRegInterval reg_interval) const
    {
-      unsigned res = 0;
-      for (PhysReg reg : reg_interval)
-         res += !regs[reg];
-      return res;
+      return reg_interval.size - used.count(reg_interval.lo(), reg_interval.size);
    }
 
    /* Returns true if any of the bytes in the given range are allocated or blocked */
    bool test(PhysReg start, unsigned num_bytes) const
    {
+      if (!used.any(start.reg(), DIV_ROUND_UP(start.byte() + num_bytes, 4)))
+         return false;
+
       for (PhysReg i = start; i.reg_b < start.reg_b + num_bytes; i = PhysReg(i + 1)) {
          assert(i <= 511);
          if (regs[i] & 0x0FFFFFFF)
@@ -355,10 +417,16 @@ public:
    }
 
 private:
+   void set_reg(PhysReg reg, uint32_t val)
+   {
+      regs[reg] = val;
+      used.set(reg, val != 0);
+   }
+
    void fill(PhysReg start, unsigned size, uint32_t val)
    {
       for (unsigned i = 0; i < size; i++)
-         regs[start + i] = val;
+         set_reg(PhysReg(start + i), val);
    }
 
    void fill_subdword(PhysReg start, unsigned num_bytes, uint32_t val)
@@ -373,7 +441,7 @@ private:
 
          if (sub == std::array<uint32_t, 4>{0, 0, 0, 0}) {
             subdword_regs.erase(i);
-            regs[i] = 0;
+            set_reg(i, 0);
          }
       }
    }
@@ -906,8 +974,8 @@ get_reg_simple(ra_ctx& ctx, const RegisterFile& reg_file, DefInfo info)
          return res;
    }
 
-   auto is_free = [&](PhysReg reg_index)
-   { return reg_file[reg_index] == 0 && !ctx.war_hint[reg_index]; };
+   /* Registers which are neither free nor free of WAR hazards */
+   const PhysRegSet unavailable = reg_file.used | ctx.war_hint;
 
    if (stride == 1) {
       /* best fit algorithm: find the smallest gap to fit in the variable */
@@ -915,23 +983,22 @@ get_reg_simple(ra_ctx& ctx, const RegisterFile& reg_file, DefInfo info)
       const unsigned max_gpr =
          (rc.type() == RegType::vgpr) ? (256 + ctx.max_used_vgpr) : ctx.max_used_sgpr;
 
-      PhysRegIterator reg_it = bounds.begin();
-      const PhysRegIterator end_it =
-         std::min(bounds.end(), std::max(PhysRegIterator{PhysReg{max_gpr + 1}}, reg_it));
-      while (reg_it != bounds.end()) {
+      unsigned reg = bounds.lo();
+      const unsigned end = std::min(bounds.hi().reg(), std::max(max_gpr + 1, reg));
+      while (reg != bounds.hi()) {
          /* Find the next chunk of available register slots */
-         reg_it = std::find_if(reg_it, end_it, is_free);
-         auto next_nonfree_it = std::find_if_not(reg_it, end_it, is_free);
-         if (reg_it == bounds.end()) {
+         reg = unavailable.find_next(reg, end, false);
+         unsigned next_nonfree = unavailable.find_next(reg, end, true);
+         if (reg == bounds.hi()) {
             break;
          }
 
-         if (next_nonfree_it == end_it) {
+         if (next_nonfree == end) {
             /* All registers past max_used_gpr are free */
-            next_nonfree_it = bounds.end();
+            next_nonfree = bounds.hi();
          }
 
-         PhysRegInterval gap = PhysRegInterval::from_until(*reg_it, *next_nonfree_it);
+         PhysRegInterval gap = PhysRegInterval::from_until(PhysReg{reg}, PhysReg{next_nonfree});
 
          /* early return on exact matches */
          if (size == gap.size) {
@@ -945,7 +1012,7 @@ get_reg_simple(ra_ctx& ctx, const RegisterFile& reg_file, DefInfo info)
          }
 
          /* Move past the processed chunk */
-         reg_it = next_nonfree_it;
+         reg = next_nonfree;
       }
 
       if (best_gap.size == UINT_MAX)
@@ -970,8 +1037,7 @@ get_reg_simple(ra_ctx& ctx, const RegisterFile& reg_file, DefInfo info)
          continue;
       }
 
-      bool is_valid = std::all_of(std::next(reg_win.begin()), reg_win.end(), is_free);
-      if (is_valid) {
+      if (!unavailable.any(reg_win.lo() + 1, size - 1)) {
          adjust_max_used_regs(ctx, rc, reg_win.lo());
          return reg_win.lo();
       }
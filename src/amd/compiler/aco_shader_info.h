@@ -151,6 +151,10 @@ struct aco_compiler_options {
    bool has_ls_vgpr_init_bug;
    bool load_grid_size_from_user_sgpr;
    bool optimisations_disabled;
+   /* Skip the passes which are expensive compared to their benefit (value numbering, scheduling and
+    * post-RA optimizations) to reduce compile time.
+    */
+   bool fast_compile;
    uint8_t enable_mrt_output_nan_fixup;
    bool wgp_mode;
    bool is_opengl;
@@ -179,6 +183,13 @@ enum aco_statistic {
    aco_statistic_vmem,
    aco_statistic_smem,
    aco_statistic_vopd,
+   aco_statistic_arena_kib,
+   aco_statistic_isel_us,
+   aco_statistic_opt_us,
+   aco_statistic_spill_us,
+   aco_statistic_sched_us,
+   aco_statistic_ra_us,
+   aco_statistic_waitcnt_us,
    aco_num_statistics
 };
 
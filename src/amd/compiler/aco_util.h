@@ -413,6 +413,78 @@ IDSet::Iterator::operator*() const
    return id;
 }
 
+/*
+ * Per-thread cache of the power-of-two sized blocks used by
+ * monotonic_buffer_resource, so that consecutive compilations on the same
+ * thread don't malloc() and free() the same blocks over and over again.
+ * At most max_retained_size bytes are kept around.
+ */
+class arena_block_cache final {
+public:
+   struct Block {
+      Block* next;
+      uint32_t current_idx;
+      uint32_t data_size;
+      uint8_t data[];
+   };
+
+   ~arena_block_cache()
+   {
+      for (Block* block : free_blocks) {
+         while (block) {
+            Block* next = block->next;
+            free(block);
+            block = next;
+         }
+      }
+   }
+
+   static Block* get(size_t size)
+   {
+      arena_block_cache& cache = thread_cache;
+      Block* block = nullptr;
+      if (util_is_power_of_two_nonzero64(size) && size <= max_retained_size) {
+         Block*& head = cache.free_blocks[util_logbase2_64(size)];
+         if (head) {
+            block = head;
+            head = block->next;
+            cache.retained_size -= size;
+         }
+      }
+
+      if (!block)
+         block = (Block*)malloc(size);
+      block->next = nullptr;
+      block->data_size = size - sizeof(Block);
+      block->current_idx = 0;
+      return block;
+   }
+
+   static void put(Block* block)
+   {
+      arena_block_cache& cache = thread_cache;
+      size_t size = block->data_size + sizeof(Block);
+      if (!util_is_power_of_two_nonzero64(size) || cache.retained_size + size > max_retained_size) {
+         free(block);
+         return;
+      }
+
+      Block*& head = cache.free_blocks[util_logbase2_64(size)];
+      block->next = head;
+      head = block;
+      cache.retained_size += size;
+   }
+
+private:
+   std::array<Block*, 32> free_blocks = {};
+   size_t retained_size = 0;
+
+   static constexpr size_t max_retained_size = 8 * 1024 * 1024;
+   static thread_local arena_block_cache thread_cache;
+};
+
+inline thread_local arena_block_cache arena_block_cache::thread_cache;
+
 /*
  * Light-weight memory resource which allows to sequentially allocate from
  * a buffer. Both, the release() method and the destructor release all managed
@@ -429,16 +501,15 @@ public:
        * The usable data_size is size - sizeof(Buffer).
        */
       size = MAX2(size, minimum_size);
-      buffer = (Buffer*)malloc(size);
-      buffer->next = nullptr;
-      buffer->data_size = size - sizeof(Buffer);
-      buffer->current_idx = 0;
+      buffer = arena_block_cache::get(size);
+      total_size = size;
+      peak_size = size;
    }
 
    ~monotonic_buffer_resource()
    {
       release();
-      free(buffer);
+      arena_block_cache::put(buffer);
    }
 
    /* Delete copy-constructor and -assignment to avoid double free() */
@@ -455,15 +526,15 @@ public:
       }
 
       /* create new larger buffer */
-      uint32_t total_size = buffer->data_size + sizeof(Buffer);
+      uint32_t new_size = buffer->data_size + sizeof(Buffer);
       do {
-         total_size *= 2;
-      } while (total_size - sizeof(Buffer) < size);
+         new_size *= 2;
+      } while (new_size - sizeof(Buffer) < size);
       Buffer* next = buffer;
-      buffer = (Buffer*)malloc(total_size);
+      buffer = arena_block_cache::get(new_size);
       buffer->next = next;
-      buffer->data_size = total_size - sizeof(Buffer);
-      buffer->current_idx = 0;
+      total_size += new_size;
+      peak_size = MAX2(peak_size, total_size);
 
       return allocate(size, alignment);
    }
@@ -472,23 +543,24 @@ public:
    {
       while (buffer->next) {
          Buffer* next = buffer->next;
-         free(buffer);
+         total_size -= buffer->data_size + sizeof(Buffer);
+         arena_block_cache::put(buffer);
          buffer = next;
       }
       buffer->current_idx = 0;
    }
 
+   /* Largest amount of memory held at once, in bytes. */
+   size_t get_peak_size() const { return peak_size; }
+
    bool operator==(const monotonic_buffer_resource& other) { return buffer == other.buffer; }
 
 private:
-   struct Buffer {
-      Buffer* next;
-      uint32_t current_idx;
-      uint32_t data_size;
-      uint8_t data[];
-   };
+   using Buffer = arena_block_cache::Block;
 
    Buffer* buffer;
+   size_t total_size;
+   size_t peak_size;
    static constexpr size_t initial_size = 4096;
    static constexpr size_t minimum_size = 128;
    static_assert(minimum_size > sizeof(Buffer));
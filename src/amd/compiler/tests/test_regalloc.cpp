@@ -659,3 +659,27 @@ BEGIN_TEST(regalloc.linear_vgpr.compact_for_future_phis)
       finish_ra_test(ra_test_policy());
    }
 END_TEST
+
+BEGIN_TEST(regalloc.many_live_temps)
+   /* Compile-time regression test: keeps 192 VGPRs live over a long program. This used to scan
+    * the register file linearly for every definition.
+    */
+   if (!setup_cs("", GFX10))
+      return;
+
+   std::vector<Temp> live;
+   for (unsigned i = 0; i < 192; i++)
+      live.push_back(bld.pseudo(aco_opcode::p_unit_test, bld.def(v1)));
+
+   for (unsigned i = 0; i < 32768; i++) {
+      Temp a = live[i % live.size()];
+      Temp b = live[(i * 7 + 3) % live.size()];
+      live[i % live.size()] = bld.vop2(aco_opcode::v_add_u32, bld.def(v1), a, b);
+   }
+
+   //>> p_unit_test 0xbf, %_:v[#_]
+   for (unsigned i = 0; i < live.size(); i++)
+      writeout(i, live[i]);
+
+   finish_ra_test(ra_test_policy());
+END_TEST
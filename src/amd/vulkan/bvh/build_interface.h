@@ -14,6 +14,7 @@
 #include "bvh.h"
 #define REF(type) uint64_t
 #define VOID_REF  uint64_t
+typedef struct update_args update_args;
 #endif
 
 struct leaf_args {
@@ -111,4 +112,20 @@ struct update_args {
    radv_bvh_geometry_data geom_data;
 };
 
+#define UPDATE_WORKGROUP_SIZE 64
+
+/* One geometry of the acceleration structures updated by a single dispatch. The geometries are sorted by
+ * first_workgroup, which is the first workgroup of the dispatch that updates it.
+ */
+struct update_geometry {
+   update_args args;
+   uint32_t first_workgroup;
+   uint32_t primitive_count;
+};
+
+struct update_batch_args {
+   VOID_REF geometries;
+   uint32_t geometry_count;
+};
+
 #endif /* BUILD_INTERFACE_H */
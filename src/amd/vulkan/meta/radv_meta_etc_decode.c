@@ -92,12 +92,13 @@ decode_etc(struct radv_cmd_buffer *cmd_buffer, struct radv_image_view *src_iview
 
    radv_CmdBindPipeline(radv_cmd_buffer_to_handle(cmd_buffer), VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 
-   unsigned push_constants[5] = {
-      offset->x, offset->y, offset->z, src_iview->image->vk.format, src_iview->image->vk.image_type,
+   unsigned push_constants[8] = {
+      offset->x,     offset->y,      offset->z,     src_iview->image->vk.format, src_iview->image->vk.image_type,
+      extent->width, extent->height, extent->depth,
    };
 
    vk_common_CmdPushConstants(radv_cmd_buffer_to_handle(cmd_buffer), device->meta_state.etc_decode.pipeline_layout,
-                              VK_SHADER_STAGE_COMPUTE_BIT, 0, 20, push_constants);
+                              VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push_constants), push_constants);
    radv_unaligned_dispatch(cmd_buffer, extent->width, extent->height, extent->depth);
 }
 
@@ -590,7 +590,7 @@ radv_device_init_accel_struct_build_state(struct radv_device *device)
    if (result != VK_SUCCESS)
       goto exit;
 
-   result = create_build_pipeline_spv(device, update_spv, sizeof(update_spv), sizeof(struct update_args),
+   result = create_build_pipeline_spv(device, update_spv, sizeof(update_spv), sizeof(struct update_batch_args),
                                       &device->meta_state.accel_struct_build.update_pipeline,
                                       &device->meta_state.accel_struct_build.update_p_layout);
    if (result != VK_SUCCESS)
@@ -1292,11 +1292,26 @@ update(VkCommandBuffer commandBuffer, uint32_t infoCount, const VkAccelerationSt
    VK_FROM_HANDLE(radv_cmd_buffer, cmd_buffer, commandBuffer);
    struct radv_device *device = radv_cmd_buffer_device(cmd_buffer);
 
-   radv_write_user_event_marker(cmd_buffer, UserEventPush, "update");
+   /* Refit the geometries of all acceleration structures with a single dispatch, each workgroup looks up its
+    * geometry in a table uploaded to the command buffer. This avoids a dispatch per geometry when many
+    * acceleration structures are updated at once.
+    */
+   uint32_t geometry_count = 0;
+   for (uint32_t i = 0; i < infoCount; ++i) {
+      if (bvh_states[i].config.internal_type == INTERNAL_BUILD_TYPE_UPDATE)
+         geometry_count += pInfos[i].geometryCount;
+   }
 
-   device->vk.dispatch_table.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                                             device->meta_state.accel_struct_build.update_pipeline);
+   struct update_geometry *geometries;
+   unsigned geometries_offset;
+   if (!radv_cmd_buffer_upload_alloc_aligned(cmd_buffer, geometry_count * sizeof(*geometries), 8,
+                                             &geometries_offset, (void **)&geometries))
+      return;
+
+   radv_write_user_event_marker(cmd_buffer, UserEventPush, "update");
 
+   uint32_t workgroup_count = 0;
+   uint32_t batch_geometry_count = 0;
    for (uint32_t i = 0; i < infoCount; ++i) {
       if (bvh_states[i].config.internal_type != INTERNAL_BUILD_TYPE_UPDATE)
          continue;
@@ -1325,15 +1340,33 @@ update(VkCommandBuffer commandBuffer, uint32_t infoCount, const VkAccelerationSt
 
          update_consts.geom_data = fill_geometry_data(pInfos[i].type, &bvh_states[i], j, geom, build_range_info);
 
-         vk_common_CmdPushConstants(commandBuffer, device->meta_state.accel_struct_build.update_p_layout,
-                                    VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(update_consts), &update_consts);
-         radv_unaligned_dispatch(cmd_buffer, build_range_info->primitiveCount, 1, 1);
+         if (build_range_info->primitiveCount) {
+            geometries[batch_geometry_count++] = (struct update_geometry){
+               .args = update_consts,
+               .first_workgroup = workgroup_count,
+               .primitive_count = build_range_info->primitiveCount,
+            };
+            workgroup_count += DIV_ROUND_UP(build_range_info->primitiveCount, UPDATE_WORKGROUP_SIZE);
+         }
 
          bvh_states[i].leaf_node_count += build_range_info->primitiveCount;
          bvh_states[i].node_count += build_range_info->primitiveCount;
       }
    }
 
+   if (workgroup_count) {
+      const struct update_batch_args batch_consts = {
+         .geometries = radv_buffer_get_va(cmd_buffer->upload.upload_bo) + geometries_offset,
+         .geometry_count = batch_geometry_count,
+      };
+
+      device->vk.dispatch_table.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                                device->meta_state.accel_struct_build.update_pipeline);
+      vk_common_CmdPushConstants(commandBuffer, device->meta_state.accel_struct_build.update_p_layout,
+                                 VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(batch_consts), &batch_consts);
+      radv_unaligned_dispatch(cmd_buffer, workgroup_count * UPDATE_WORKGROUP_SIZE, 1, 1);
+   }
+
    radv_write_user_event_marker(cmd_buffer, UserEventPop, NULL);
 }
 
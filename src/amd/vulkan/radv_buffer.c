@@ -33,11 +33,16 @@ radv_buffer_init(struct radv_buffer *buffer, struct radv_device *device, struct
 
    buffer->bo = bo;
    buffer->offset = offset;
+
+   simple_mtx_init(&buffer->dgc_preprocessed_mtx, mtx_plain);
+   util_dynarray_init(&buffer->dgc_preprocessed, NULL);
 }
 
 void
 radv_buffer_finish(struct radv_buffer *buffer)
 {
+   util_dynarray_fini(&buffer->dgc_preprocessed);
+   simple_mtx_destroy(&buffer->dgc_preprocessed_mtx);
    vk_buffer_finish(&buffer->vk);
 }
 
@@ -84,6 +89,8 @@ radv_create_buffer(struct radv_device *device, const VkBufferCreateInfo *pCreate
    buffer->offset = 0;
    buffer->bo_va = 0;
    buffer->bo_size = 0;
+   simple_mtx_init(&buffer->dgc_preprocessed_mtx, mtx_plain);
+   util_dynarray_init(&buffer->dgc_preprocessed, NULL);
 
    if (pCreateInfo->flags & VK_BUFFER_CREATE_SPARSE_BINDING_BIT) {
       enum radeon_bo_flag flags = RADEON_FLAG_VIRTUAL;
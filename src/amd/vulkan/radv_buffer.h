@@ -13,6 +13,9 @@
 
 #include "radv_radeon_winsys.h"
 
+#include "util/simple_mtx.h"
+#include "util/u_dynarray.h"
+
 #include "vk_buffer.h"
 
 struct radv_device;
@@ -25,6 +28,10 @@ struct radv_buffer {
    VkDeviceSize offset;
    uint64_t bo_va;
    uint64_t bo_size;
+
+   /* Generated commands preprocessed into this buffer, only used with RADV_PERFTEST=dgc_cache. */
+   simple_mtx_t dgc_preprocessed_mtx;
+   struct util_dynarray dgc_preprocessed;
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(radv_buffer, vk.base, VkBuffer, VK_OBJECT_TYPE_BUFFER)
@@ -7074,7 +7074,8 @@ radv_CmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipeline
       break;
    }
    case VK_PIPELINE_BIND_POINT_GRAPHICS: {
-      struct radv_graphics_pipeline *graphics_pipeline = radv_pipeline_to_graphics(pipeline);
+      struct radv_graphics_pipeline *graphics_pipeline =
+         radv_graphics_pipeline_get_bind_variant(device, radv_pipeline_to_graphics(pipeline));
 
       /* Bind the non-dynamic graphics state from the pipeline unconditionally because some PSO
        * might have been overwritten between two binds of the same pipeline.
@@ -79,6 +79,10 @@ enum {
    RADV_PERFTEST_NIR_CACHE = 1u << 14,
    RADV_PERFTEST_RT_WAVE_32 = 1u << 15,
    RADV_PERFTEST_VIDEO_ENCODE = 1u << 16,
+   RADV_PERFTEST_PARALLEL_COMPILE = 1u << 17,
+   RADV_PERFTEST_FAST_COMPILE = 1u << 18,
+   RADV_PERFTEST_BACKGROUND_LTO = 1u << 19,
+   RADV_PERFTEST_DGC_CACHE = 1u << 20,
 };
 
 bool radv_init_trace(struct radv_device *device);
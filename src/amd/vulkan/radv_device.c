@@ -34,6 +34,7 @@
 #include "radv_entrypoints.h"
 #include "radv_formats.h"
 #include "radv_physical_device.h"
+#include "radv_pipeline_cache.h"
 #include "radv_printf.h"
 #include "radv_rmv.h"
 #include "radv_shader.h"
@@ -57,6 +58,7 @@ typedef void *drmDevicePtr;
 #include "util/mesa-sha1.h"
 #include "util/os_time.h"
 #include "util/timespec.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_atomic.h"
 #include "util/u_process.h"
 #include "vulkan/vk_icd.h"
@@ -974,6 +976,25 @@ radv_CreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCr
    if (result != VK_SUCCESS)
       goto fail;
 
+   if (instance->perftest_flags & RADV_PERFTEST_PARALLEL_COMPILE) {
+      /* At most one job per stage of a pipeline is queued by each thread creating pipelines. Not being able to
+       * create the threads isn't fatal, stages are compiled serially then.
+       */
+      const unsigned num_threads = MIN2(util_get_cpu_caps()->nr_cpus, MESA_VULKAN_SHADER_STAGES);
+      util_queue_init(&device->shader_compile_queue, "radv_compile", 32, num_threads,
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL | UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL);
+   }
+
+   if (instance->perftest_flags & RADV_PERFTEST_BACKGROUND_LTO) {
+      /* Optimized pipelines are only swapped in when ready, keep a single low priority thread so that the
+       * application threads aren't slowed down. Fast-linked pipelines are used as-is if this fails.
+       */
+      util_queue_init(&device->lto_queue, "radv_lto", 64, 1,
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL | UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY |
+                         UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY,
+                      NULL);
+   }
+
    device->pbb_allowed = pdev->info.gfx_level >= GFX9 && !(instance->debug_flags & RADV_DEBUG_NOBINNING);
 
    device->disable_trunc_coord = instance->drirc.disable_trunc_coord;
@@ -1222,6 +1243,10 @@ radv_CreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo *pCr
 
    device->cache_disabled = radv_is_cache_disabled(device);
 
+   const char *shared_cache_path = getenv("RADV_SHARED_CACHE");
+   if (shared_cache_path && !device->cache_disabled)
+      radv_shared_cache_init(device, shared_cache_path);
+
    *pDevice = radv_device_to_handle(device);
    return VK_SUCCESS;
 
@@ -1268,6 +1293,12 @@ fail_queue:
          device->ws->ctx_destroy(device->hw_ctx[i]);
    }
 
+   if (util_queue_is_initialized(&device->lto_queue))
+      util_queue_destroy(&device->lto_queue);
+
+   if (util_queue_is_initialized(&device->shader_compile_queue))
+      util_queue_destroy(&device->shader_compile_queue);
+
    radv_destroy_shader_arenas(device);
 
    _mesa_hash_table_destroy(device->rt_handles, NULL);
@@ -1326,8 +1357,16 @@ radv_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
 
    vk_pipeline_cache_destroy(device->mem_cache, NULL);
 
+   radv_shared_cache_finish(device);
+
    radv_destroy_shader_upload_queue(device);
 
+   if (util_queue_is_initialized(&device->lto_queue))
+      util_queue_destroy(&device->lto_queue);
+
+   if (util_queue_is_initialized(&device->shader_compile_queue))
+      util_queue_destroy(&device->shader_compile_queue);
+
    for (unsigned i = 0; i < RADV_NUM_HW_CTX; i++) {
       if (device->hw_ctx[i])
          device->ws->ctx_destroy(device->hw_ctx[i]);
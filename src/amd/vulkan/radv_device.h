@@ -15,6 +15,7 @@
 #include "ac_sqtt.h"
 
 #include "util/mesa-blake3.h"
+#include "util/u_queue.h"
 
 #include "radv_printf.h"
 #include "radv_queue.h"
@@ -415,6 +416,9 @@ struct radv_device {
    /* Backup in-memory cache to be used if the app doesn't provide one */
    struct vk_pipeline_cache *mem_cache;
 
+   /* Read-only pipeline cache shared between processes (RADV_SHARED_CACHE). */
+   struct radv_shared_cache *shared_cache;
+
    /*
     * use different counters so MSAA MRTs get consecutive surface indices,
     * even if MASK is allocated in between.
@@ -431,6 +435,10 @@ struct radv_device {
    struct list_head shader_block_obj_pool;
    mtx_t shader_arena_mutex;
 
+   /* Uploaded shader code, keyed by the BLAKE3 hash of the code. */
+   simple_mtx_t shader_code_mtx;
+   struct hash_table *shader_code_table;
+
    mtx_t shader_upload_hw_ctx_mutex;
    struct radeon_winsys_ctx *shader_upload_hw_ctx;
    VkSemaphore shader_upload_sem;
@@ -551,6 +559,12 @@ struct radv_device {
    uint32_t compute_scratch_waves;
 
    bool cache_disabled;
+
+   /* Compiles the stages of a graphics pipeline concurrently, RADV_PERFTEST=parallel_compile only. */
+   struct util_queue shader_compile_queue;
+
+   /* Link-time optimizes hot fast-linked graphics pipelines, RADV_PERFTEST=background_lto only. */
+   struct util_queue lto_queue;
 };
 
 VK_DEFINE_HANDLE_CASTS(radv_device, vk.base, VkDevice, VK_OBJECT_TYPE_DEVICE)
@@ -6,7 +6,9 @@
 
 #include "radv_device_generated_commands.h"
 #include "meta/radv_meta.h"
+#include "radv_debug.h"
 #include "radv_entrypoints.h"
+#include "radv_instance.h"
 
 #include "ac_rgp.h"
 
@@ -1980,6 +1982,75 @@ radv_CmdPreprocessGeneratedCommandsNV(VkCommandBuffer commandBuffer,
    cmd_buffer->state.predicating = old_predicating;
 }
 
+struct radv_dgc_preprocessed {
+   uint64_t offset;
+   uint64_t size;
+   blake3_hash key;
+};
+
+/* With RADV_PERFTEST=dgc_cache, the input streams and sequence count buffers are assumed to never change once they
+ * have been preprocessed. Preprocessing the same inputs again into the same range of the same preprocess buffer can
+ * then be skipped, which is common for static indirect commands that are re-recorded every frame.
+ */
+static bool
+radv_dgc_preprocess_cached(const VkGeneratedCommandsInfoNV *pGeneratedCommandsInfo,
+                           const struct radv_dgc_params *params, const void *upload_data, unsigned upload_size)
+{
+   VK_FROM_HANDLE(radv_buffer, prep_buffer, pGeneratedCommandsInfo->preprocessBuffer);
+   const uint64_t offset = pGeneratedCommandsInfo->preprocessOffset;
+   const uint64_t size = pGeneratedCommandsInfo->preprocessSize;
+   uint64_t count_addr = 0;
+   struct mesa_blake3 ctx;
+   blake3_hash key;
+   bool found = false;
+
+   if (pGeneratedCommandsInfo->sequencesCountBuffer != VK_NULL_HANDLE) {
+      VK_FROM_HANDLE(radv_buffer, seq_count_buffer, pGeneratedCommandsInfo->sequencesCountBuffer);
+      count_addr = radv_buffer_get_va(seq_count_buffer->bo) + seq_count_buffer->offset +
+                   pGeneratedCommandsInfo->sequencesCountOffset;
+   }
+
+   /* The params and the uploaded data capture everything the prepare shader reads besides the input buffers. */
+   _mesa_blake3_init(&ctx);
+   _mesa_blake3_update(&ctx, params, sizeof(*params));
+   _mesa_blake3_update(&ctx, upload_data, upload_size);
+   _mesa_blake3_update(&ctx, &count_addr, sizeof(count_addr));
+   _mesa_blake3_final(&ctx, key);
+
+   simple_mtx_lock(&prep_buffer->dgc_preprocessed_mtx);
+
+   util_dynarray_foreach (&prep_buffer->dgc_preprocessed, struct radv_dgc_preprocessed, entry) {
+      if (entry->offset == offset && entry->size == size && !memcmp(entry->key, key, sizeof(key))) {
+         found = true;
+         break;
+      }
+   }
+
+   if (!found) {
+      /* Forget about everything this preprocessing overwrites. */
+      for (unsigned i = 0; i < util_dynarray_num_elements(&prep_buffer->dgc_preprocessed, struct radv_dgc_preprocessed);) {
+         struct radv_dgc_preprocessed *entry =
+            util_dynarray_element(&prep_buffer->dgc_preprocessed, struct radv_dgc_preprocessed, i);
+
+         if (entry->offset < offset + size && offset < entry->offset + entry->size)
+            *entry = util_dynarray_pop(&prep_buffer->dgc_preprocessed, struct radv_dgc_preprocessed);
+         else
+            i++;
+      }
+
+      struct radv_dgc_preprocessed entry = {
+         .offset = offset,
+         .size = size,
+      };
+      memcpy(entry.key, key, sizeof(key));
+      util_dynarray_append(&prep_buffer->dgc_preprocessed, struct radv_dgc_preprocessed, entry);
+   }
+
+   simple_mtx_unlock(&prep_buffer->dgc_preprocessed_mtx);
+
+   return found;
+}
+
 /* Always need to call this directly before draw due to dependence on bound state. */
 static void
 radv_prepare_dgc_graphics(struct radv_cmd_buffer *cmd_buffer, const VkGeneratedCommandsInfoNV *pGeneratedCommandsInfo,
@@ -2108,6 +2179,8 @@ radv_prepare_dgc(struct radv_cmd_buffer *cmd_buffer, const VkGeneratedCommandsIn
    VK_FROM_HANDLE(radv_buffer, prep_buffer, pGeneratedCommandsInfo->preprocessBuffer);
    VK_FROM_HANDLE(radv_buffer, stream_buffer, pGeneratedCommandsInfo->pStreams[0].buffer);
    struct radv_device *device = radv_cmd_buffer_device(cmd_buffer);
+   const struct radv_physical_device *pdev = radv_device_physical(device);
+   const struct radv_instance *instance = radv_physical_device_instance(pdev);
    struct radv_meta_saved_state saved_state;
    unsigned upload_offset, upload_size;
    struct radv_buffer token_buffer;
@@ -2150,6 +2223,8 @@ radv_prepare_dgc(struct radv_cmd_buffer *cmd_buffer, const VkGeneratedCommandsIn
                                cond_render_enabled);
    }
 
+   const void *upload_start = upload_data;
+
    if (layout->push_constant_mask) {
       uint32_t *desc = upload_data;
       upload_data = (char *)upload_data + ARRAY_SIZE(pipeline->shaders) * 12;
@@ -2260,6 +2335,13 @@ radv_prepare_dgc(struct radv_cmd_buffer *cmd_buffer, const VkGeneratedCommandsIn
       params.sequence_count |= 1u << 31;
    }
 
+   /* Only explicitly preprocessed commands can be reused, the others depend on state at execution time. */
+   if ((instance->perftest_flags & RADV_PERFTEST_DGC_CACHE) && radv_dgc_can_preprocess(layout, pipeline) &&
+       radv_dgc_preprocess_cached(pGeneratedCommandsInfo, &params, upload_start, upload_size)) {
+      radv_buffer_finish(&token_buffer);
+      return;
+   }
+
    radv_meta_save(&saved_state, cmd_buffer,
                   RADV_META_SAVE_COMPUTE_PIPELINE | RADV_META_SAVE_DESCRIPTORS | RADV_META_SAVE_CONSTANTS);
 
@@ -99,6 +99,10 @@ static const struct debug_control radv_perftest_options[] = {{"localbos", RADV_P
                                                              {"nircache", RADV_PERFTEST_NIR_CACHE},
                                                              {"rtwave32", RADV_PERFTEST_RT_WAVE_32},
                                                              {"video_encode", RADV_PERFTEST_VIDEO_ENCODE},
+                                                             {"parallel_compile", RADV_PERFTEST_PARALLEL_COMPILE},
+                                                             {"fast_compile", RADV_PERFTEST_FAST_COMPILE},
+                                                             {"background_lto", RADV_PERFTEST_BACKGROUND_LTO},
+                                                             {"dgc_cache", RADV_PERFTEST_DGC_CACHE},
                                                              {NULL, 0}};
 
 const char *
@@ -114,6 +114,12 @@ radv_DestroyPipeline(VkDevice _device, VkPipeline _pipeline, const VkAllocationC
    if (!_pipeline)
       return;
 
+   /* Libraries might still be used by the background link-time optimization of pipelines linked with them. */
+   if (pipeline->type == RADV_PIPELINE_GRAPHICS_LIB) {
+      radv_graphics_lib_pipeline_unref(device, radv_pipeline_to_graphics_lib(pipeline));
+      return;
+   }
+
    radv_pipeline_destroy(device, pipeline, pAllocator);
 }
 
@@ -148,6 +154,12 @@ radv_pipeline_get_shader_key(const struct radv_device *device, const VkPipelineS
    if (flags & VK_PIPELINE_CREATE_2_DISABLE_OPTIMIZATION_BIT_KHR)
       key.optimisations_disabled = 1;
 
+   /* Shaders of graphics pipeline libraries are only used by fast-linked pipelines, which applications
+    * replace with link-time optimized ones compiled in the background.
+    */
+   if ((instance->perftest_flags & RADV_PERFTEST_FAST_COMPILE) && (flags & VK_PIPELINE_CREATE_2_LIBRARY_BIT_KHR))
+      key.fast_compile = 1;
+
    if (stage->stage & RADV_GRAPHICS_STAGE_BITS) {
       key.version = instance->drirc.override_graphics_shader_version;
    } else if (stage->stage & RADV_RT_STAGE_BITS) {
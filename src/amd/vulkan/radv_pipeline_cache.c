@@ -4,11 +4,21 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "radv_pipeline_cache.h"
 #include "util/disk_cache.h"
+#include "util/hash_table.h"
 #include "util/macros.h"
 #include "util/mesa-blake3.h"
 #include "util/mesa-sha1.h"
+#include "util/os_mman.h"
 #include "util/u_atomic.h"
 #include "util/u_debug.h"
 #include "nir_serialize.h"
@@ -101,6 +111,170 @@ radv_hash_rt_shaders(const struct radv_device *device, unsigned char *hash, cons
    _mesa_sha1_final(&ctx, hash);
 }
 
+struct radv_shared_cache_entry {
+   const void *key_data;
+   uint32_t key_size;
+   const void *data;
+   uint32_t data_size;
+};
+
+/* Pipeline cache data mapped read-only from RADV_SHARED_CACHE. The pages of the file are shared by all processes
+ * that map it, objects are deserialized from it on lookup and shader code is used in place.
+ */
+struct radv_shared_cache {
+   void *map;
+   size_t size;
+
+   /* radv_shared_cache_entry -> radv_shared_cache_entry, read-only after init */
+   struct hash_table *entries;
+};
+
+static uint32_t
+radv_shared_cache_entry_hash(const void *key)
+{
+   const struct radv_shared_cache_entry *entry = key;
+   return _mesa_hash_data(entry->key_data, entry->key_size);
+}
+
+static bool
+radv_shared_cache_entry_equal(const void *a, const void *b)
+{
+   const struct radv_shared_cache_entry *entry_a = a;
+   const struct radv_shared_cache_entry *entry_b = b;
+   return entry_a->key_size == entry_b->key_size && !memcmp(entry_a->key_data, entry_b->key_data, entry_a->key_size);
+}
+
+static bool
+radv_shared_cache_index(struct radv_device *device, struct radv_shared_cache *shared_cache)
+{
+   struct blob_reader blob;
+   blob_reader_init(&blob, shared_cache->map, shared_cache->size);
+
+   struct vk_pipeline_cache_header header;
+   blob_copy_bytes(&blob, &header, sizeof(header));
+   uint32_t count = blob_read_uint32(&blob);
+   if (blob.overrun || memcmp(&header, &device->mem_cache->header, sizeof(header)))
+      return false;
+
+   for (uint32_t i = 0; i < count; i++) {
+      blob_read_uint32(&blob); /* type */
+      uint32_t key_size = blob_read_uint32(&blob);
+      uint32_t data_size = blob_read_uint32(&blob);
+      const void *key_data = blob_read_bytes(&blob, key_size);
+      blob_reader_align(&blob, VK_PIPELINE_CACHE_BLOB_ALIGN);
+      const void *data = blob_read_bytes(&blob, data_size);
+      if (blob.overrun)
+         return false;
+
+      struct radv_shared_cache_entry *entry = ralloc(shared_cache->entries, struct radv_shared_cache_entry);
+      if (!entry)
+         return false;
+
+      entry->key_data = key_data;
+      entry->key_size = key_size;
+      entry->data = data;
+      entry->data_size = data_size;
+      _mesa_hash_table_insert(shared_cache->entries, entry, entry);
+   }
+
+   return true;
+}
+
+void
+radv_shared_cache_init(struct radv_device *device, const char *path)
+{
+   struct radv_shared_cache *shared_cache;
+   struct stat st;
+
+   int fd = open(path, O_RDONLY);
+   if (fd < 0) {
+      fprintf(stderr, "radv: Failed to open the shared cache %s.\n", path);
+      return;
+   }
+
+   if (fstat(fd, &st) || !st.st_size) {
+      close(fd);
+      return;
+   }
+
+   void *map = os_mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED) {
+      fprintf(stderr, "radv: Failed to map the shared cache %s.\n", path);
+      return;
+   }
+
+   shared_cache = calloc(1, sizeof(*shared_cache));
+   if (!shared_cache) {
+      os_munmap(map, st.st_size);
+      return;
+   }
+
+   shared_cache->map = map;
+   shared_cache->size = st.st_size;
+   shared_cache->entries = _mesa_hash_table_create(NULL, radv_shared_cache_entry_hash, radv_shared_cache_entry_equal);
+
+   if (!shared_cache->entries || !radv_shared_cache_index(device, shared_cache)) {
+      fprintf(stderr, "radv: Ignoring the shared cache %s, it is invalid or from another driver or GPU.\n", path);
+      _mesa_hash_table_destroy(shared_cache->entries, NULL);
+      os_munmap(map, st.st_size);
+      free(shared_cache);
+      return;
+   }
+
+   device->shared_cache = shared_cache;
+}
+
+void
+radv_shared_cache_finish(struct radv_device *device)
+{
+   struct radv_shared_cache *shared_cache = device->shared_cache;
+
+   if (!shared_cache)
+      return;
+
+   _mesa_hash_table_destroy(shared_cache->entries, NULL);
+   os_munmap(shared_cache->map, shared_cache->size);
+   free(shared_cache);
+}
+
+static bool
+radv_shared_cache_contains(const struct radv_shared_cache *shared_cache, const void *ptr)
+{
+   return shared_cache && (const uint8_t *)ptr >= (const uint8_t *)shared_cache->map &&
+          (const uint8_t *)ptr < (const uint8_t *)shared_cache->map + shared_cache->size;
+}
+
+/* Looks up an object in the pipeline cache, then in the shared cache. Objects found in the shared cache are added
+ * to the pipeline cache.
+ */
+static struct vk_pipeline_cache_object *
+radv_pipeline_cache_lookup(struct radv_device *device, struct vk_pipeline_cache *cache, const void *key_data,
+                           size_t key_size, const struct vk_pipeline_cache_object_ops *ops, bool *cache_hit)
+{
+   struct vk_pipeline_cache_object *object = vk_pipeline_cache_lookup_object(cache, key_data, key_size, ops, cache_hit);
+   if (object || !device->shared_cache)
+      return object;
+
+   const struct radv_shared_cache_entry search = {
+      .key_data = key_data,
+      .key_size = key_size,
+   };
+   struct hash_entry *entry = _mesa_hash_table_search(device->shared_cache->entries, &search);
+   if (!entry)
+      return NULL;
+
+   const struct radv_shared_cache_entry *shared_entry = entry->data;
+   struct blob_reader blob;
+   blob_reader_init(&blob, shared_entry->data, shared_entry->data_size);
+
+   object = ops->deserialize(cache, key_data, key_size, &blob);
+   if (!object)
+      return NULL;
+
+   return vk_pipeline_cache_add_object(cache, object);
+}
+
 static void
 radv_shader_destroy(struct vk_device *_device, struct vk_pipeline_cache_object *object)
 {
@@ -112,9 +286,10 @@ radv_shader_destroy(struct vk_device *_device, struct vk_pipeline_cache_object *
       radv_shader_wait_for_upload(device, shader->upload_seq);
    }
 
-   radv_free_shader_memory(device, shader->alloc);
+   radv_shader_free_code_memory(device, shader);
 
-   free(shader->code);
+   if (!radv_shared_cache_contains(device->shared_cache, shader->code))
+      free(shader->code);
    free(shader->spirv);
    free(shader->nir_string);
    free(shader->disasm_string);
@@ -141,6 +316,16 @@ radv_shader_deserialize(struct vk_pipeline_cache *cache, const void *key_data, s
    memcpy(shader->hash, key_data, key_size);
    blob_skip_bytes(blob, binary->total_size - sizeof(struct radv_shader_binary));
 
+   /* Use the code of the shared cache rather than a private copy, this is what makes the memory of identical
+    * shaders shared between processes.
+    */
+   if (binary->type == RADV_BINARY_TYPE_LEGACY && radv_shared_cache_contains(device->shared_cache, binary)) {
+      const struct radv_shader_binary_legacy *bin = (const struct radv_shader_binary_legacy *)binary;
+
+      free(shader->code);
+      shader->code = (void *)(bin->data + bin->stats_size);
+   }
+
    return &shader->base;
 }
 
@@ -270,7 +455,7 @@ radv_pipeline_cache_object_deserialize(struct vk_pipeline_cache *cache, const vo
    for (unsigned i = 0; i < num_shaders; i++) {
       const uint8_t *hash = blob_read_bytes(blob, sizeof(blake3_hash));
       struct vk_pipeline_cache_object *shader =
-         vk_pipeline_cache_lookup_object(cache, hash, sizeof(blake3_hash), &radv_shader_ops, NULL);
+         radv_pipeline_cache_lookup(device, cache, hash, sizeof(blake3_hash), &radv_shader_ops, NULL);
 
       if (!shader) {
          /* If some shader could not be created from cache, better return NULL here than having
@@ -326,7 +511,7 @@ radv_pipeline_cache_search(struct radv_device *device, struct vk_pipeline_cache
    }
 
    struct vk_pipeline_cache_object *object =
-      vk_pipeline_cache_lookup_object(cache, sha1, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, found);
+      radv_pipeline_cache_lookup(device, cache, sha1, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, found);
 
    if (!object)
       return false;
@@ -412,7 +597,7 @@ radv_ray_tracing_pipeline_cache_search(struct radv_device *device, struct vk_pip
    }
 
    struct vk_pipeline_cache_object *object =
-      vk_pipeline_cache_lookup_object(cache, pipeline->sha1, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, found);
+      radv_pipeline_cache_lookup(device, cache, pipeline->sha1, SHA1_DIGEST_LENGTH, &radv_pipeline_ops, found);
 
    if (!object)
       return false;
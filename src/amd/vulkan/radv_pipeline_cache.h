@@ -40,6 +40,10 @@ void radv_hash_rt_shaders(const struct radv_device *device, unsigned char *hash,
                           const VkRayTracingPipelineCreateInfoKHR *pCreateInfo,
                           const struct radv_ray_tracing_group *groups);
 
+void radv_shared_cache_init(struct radv_device *device, const char *path);
+
+void radv_shared_cache_finish(struct radv_device *device);
+
 struct radv_shader *radv_shader_create(struct radv_device *device, struct vk_pipeline_cache *cache,
                                        const struct radv_shader_binary *binary, bool skip_cache);
 
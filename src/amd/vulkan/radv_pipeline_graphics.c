@@ -2169,6 +2169,7 @@ radv_create_gs_copy_shader(struct radv_device *device, struct vk_pipeline_cache
       .key =
          {
             .optimisations_disabled = gs_stage->key.optimisations_disabled,
+            .fast_compile = gs_stage->key.fast_compile,
          },
    };
    radv_nir_shader_info_init(gs_copy_stage.stage, MESA_SHADER_FRAGMENT, &gs_copy_stage.info);
@@ -2202,6 +2203,33 @@ radv_create_gs_copy_shader(struct radv_device *device, struct vk_pipeline_cache
    return copy_shader;
 }
 
+struct radv_shader_compile_job {
+   struct radv_device *device;
+   struct radv_shader_stage *stage;
+   nir_shader *nir_shaders[2];
+   unsigned shader_count;
+   const struct radv_graphics_state_key *gfx_state;
+   bool keep_executable_info;
+   bool keep_statistic_info;
+   bool dump_shader;
+
+   struct radv_shader_binary *binary;
+   int64_t duration;
+   struct util_queue_fence fence;
+};
+
+static void
+radv_shader_compile_job_execute(void *data, UNUSED void *gdata, UNUSED int thread_index)
+{
+   struct radv_shader_compile_job *job = data;
+   int64_t start = os_time_get_nano();
+
+   job->binary = radv_shader_nir_to_asm(job->device, job->stage, job->nir_shaders, job->shader_count, job->gfx_state,
+                                        job->keep_executable_info, job->keep_statistic_info);
+
+   job->duration = os_time_get_nano() - start;
+}
+
 static void
 radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_cache *cache,
                                  struct radv_shader_stage *stages, const struct radv_graphics_state_key *gfx_state,
@@ -2211,13 +2239,24 @@ radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_
                                  struct radv_shader_binary **gs_copy_binary)
 {
    const struct radv_physical_device *pdev = radv_device_physical(device);
+   struct radv_shader_compile_job jobs[MESA_VULKAN_SHADER_STAGES];
+   unsigned num_jobs = 0;
+   bool parallel = util_queue_is_initialized(&device->shader_compile_queue);
 
    for (int s = MESA_VULKAN_SHADER_STAGES - 1; s >= 0; s--) {
       if (!(active_nir_stages & (1 << s)))
          continue;
 
-      nir_shader *nir_shaders[2] = {stages[s].nir, NULL};
-      unsigned shader_count = 1;
+      struct radv_shader_compile_job *job = &jobs[num_jobs++];
+      *job = (struct radv_shader_compile_job){
+         .device = device,
+         .stage = &stages[s],
+         .nir_shaders = {stages[s].nir, NULL},
+         .shader_count = 1,
+         .gfx_state = gfx_state,
+         .keep_executable_info = keep_executable_info,
+         .keep_statistic_info = keep_statistic_info,
+      };
 
       /* On GFX9+, TES is merged with GS and VS is merged with TCS or GS. */
       if (pdev->info.gfx_level >= GFX9 &&
@@ -2232,31 +2271,59 @@ radv_graphics_shaders_nir_to_asm(struct radv_device *device, struct vk_pipeline_
             pre_stage = MESA_SHADER_VERTEX;
          }
 
-         nir_shaders[0] = stages[pre_stage].nir;
-         nir_shaders[1] = stages[s].nir;
-         shader_count = 2;
+         job->nir_shaders[0] = stages[pre_stage].nir;
+         job->nir_shaders[1] = stages[s].nir;
+         job->shader_count = 2;
       }
 
-      int64_t stage_start = os_time_get_nano();
+      job->dump_shader = radv_can_dump_shader(device, job->nir_shaders[0], false);
 
-      bool dump_shader = radv_can_dump_shader(device, nir_shaders[0], false);
+      /* Keep dumps readable, and LLVM isn't used from several threads for the same pipeline. */
+      if (job->dump_shader || radv_use_llvm_for_stage(pdev, s))
+         parallel = false;
 
-      binaries[s] = radv_shader_nir_to_asm(device, &stages[s], nir_shaders, shader_count, gfx_state,
-                                           keep_executable_info, keep_statistic_info);
-      shaders[s] = radv_shader_create(device, cache, binaries[s], keep_executable_info || dump_shader);
-      radv_shader_generate_debug_info(device, dump_shader, keep_executable_info, binaries[s], shaders[s], nir_shaders,
-                                      shader_count, &stages[s].info);
+      active_nir_stages &= ~(1 << job->nir_shaders[0]->info.stage);
+      if (job->nir_shaders[1])
+         active_nir_stages &= ~(1 << job->nir_shaders[1]->info.stage);
+   }
+
+   /* Compile the stages concurrently, the first one on this thread. Shaders are still created in the same order
+    * below, so the result doesn't depend on which thread compiled what.
+    */
+   if (parallel && num_jobs > 1) {
+      for (unsigned i = 1; i < num_jobs; i++) {
+         util_queue_fence_init(&jobs[i].fence);
+         util_queue_add_job(&device->shader_compile_queue, &jobs[i], &jobs[i].fence, radv_shader_compile_job_execute,
+                            NULL, 0);
+      }
+
+      radv_shader_compile_job_execute(&jobs[0], NULL, 0);
+
+      for (unsigned i = 1; i < num_jobs; i++) {
+         util_queue_fence_wait(&jobs[i].fence);
+         util_queue_fence_destroy(&jobs[i].fence);
+      }
+   } else {
+      for (unsigned i = 0; i < num_jobs; i++)
+         radv_shader_compile_job_execute(&jobs[i], NULL, 0);
+   }
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      struct radv_shader_compile_job *job = &jobs[i];
+      gl_shader_stage s = job->nir_shaders[job->shader_count - 1]->info.stage;
+      int64_t stage_start = os_time_get_nano();
+
+      binaries[s] = job->binary;
+      shaders[s] = radv_shader_create(device, cache, binaries[s], keep_executable_info || job->dump_shader);
+      radv_shader_generate_debug_info(device, job->dump_shader, keep_executable_info, binaries[s], shaders[s],
+                                      job->nir_shaders, job->shader_count, &stages[s].info);
 
       if (s == MESA_SHADER_GEOMETRY && !stages[s].info.is_ngg) {
          *gs_copy_shader = radv_create_gs_copy_shader(device, cache, &stages[MESA_SHADER_GEOMETRY], gfx_state,
                                                       keep_executable_info, keep_statistic_info, gs_copy_binary);
       }
 
-      stages[s].feedback.duration += os_time_get_nano() - stage_start;
-
-      active_nir_stages &= ~(1 << nir_shaders[0]->info.stage);
-      if (nir_shaders[1])
-         active_nir_stages &= ~(1 << nir_shaders[1]->info.stage);
+      stages[s].feedback.duration += job->duration + os_time_get_nano() - stage_start;
    }
 }
 
@@ -4113,6 +4180,163 @@ radv_graphics_pipeline_init(struct radv_graphics_pipeline *pipeline, struct radv
    return result;
 }
 
+/* Number of binds after which a fast-linked pipeline is link-time optimized in the background. */
+#define RADV_LTO_BIND_THRESHOLD 64
+
+struct radv_graphics_pipeline_lto {
+   struct radv_device *device;
+   struct util_queue_fence fence;
+
+   uint32_t bind_count;
+
+   /* Referenced until the background compile is done. */
+   uint32_t library_count;
+   struct radv_graphics_lib_pipeline *libraries[4];
+
+   VkPipelineCreateFlags2KHR create_flags;
+
+   /* Set by the background thread, NULL until compiled or if compilation failed. */
+   struct radv_graphics_pipeline *optimized;
+};
+
+static void
+radv_graphics_pipeline_init_lto(struct radv_device *device, struct radv_graphics_pipeline *pipeline,
+                                const VkGraphicsPipelineCreateInfo *pCreateInfo)
+{
+   const VkPipelineLibraryCreateInfoKHR *libs_info =
+      vk_find_struct_const(pCreateInfo->pNext, PIPELINE_LIBRARY_CREATE_INFO_KHR);
+   VkGraphicsPipelineLibraryFlagsEXT lib_flags = 0;
+   struct radv_graphics_pipeline_lto *lto;
+
+   if (!util_queue_is_initialized(&device->lto_queue) || !radv_is_fast_linking_enabled(pipeline, pCreateInfo) ||
+       pipeline->base.is_internal || device->sqtt_enabled)
+      return;
+
+   /* Executable properties must describe the bound shaders. */
+   if (radv_pipeline_capture_shaders(device, pipeline->base.create_flags) ||
+       radv_pipeline_capture_shader_stats(device, pipeline->base.create_flags))
+      return;
+
+   /* The optimized pipeline is linked from the libraries alone, so they must define all the state and
+    * retain their NIR.
+    */
+   if (pCreateInfo->stageCount || (pCreateInfo->pDynamicState && pCreateInfo->pDynamicState->dynamicStateCount) ||
+       libs_info->libraryCount > ARRAY_SIZE(lto->libraries))
+      return;
+
+   for (uint32_t i = 0; i < libs_info->libraryCount; i++) {
+      VK_FROM_HANDLE(radv_pipeline, pipeline_lib, libs_info->pLibraries[i]);
+      struct radv_graphics_lib_pipeline *gfx_pipeline_lib = radv_pipeline_to_graphics_lib(pipeline_lib);
+
+      if (!gfx_pipeline_lib->base.retain_shaders)
+         return;
+
+      lib_flags |= gfx_pipeline_lib->lib_flags;
+   }
+
+   if (lib_flags != ALL_GRAPHICS_LIB_FLAGS)
+      return;
+
+   lto = vk_zalloc(&device->vk.alloc, sizeof(*lto), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   if (!lto)
+      return;
+
+   lto->device = device;
+   util_queue_fence_init(&lto->fence);
+
+   lto->library_count = libs_info->libraryCount;
+   for (uint32_t i = 0; i < libs_info->libraryCount; i++) {
+      VK_FROM_HANDLE(radv_pipeline, pipeline_lib, libs_info->pLibraries[i]);
+
+      lto->libraries[i] = radv_pipeline_to_graphics_lib(pipeline_lib);
+      p_atomic_inc(&lto->libraries[i]->ref_count);
+   }
+
+   lto->create_flags = (pipeline->base.create_flags & ~(VK_PIPELINE_CREATE_2_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_KHR |
+                                                        VK_PIPELINE_CREATE_2_EARLY_RETURN_ON_FAILURE_BIT_KHR)) |
+                       VK_PIPELINE_CREATE_2_LINK_TIME_OPTIMIZATION_BIT_EXT;
+
+   pipeline->lto = lto;
+}
+
+static void
+radv_graphics_pipeline_lto_release_libraries(struct radv_device *device, struct radv_graphics_pipeline_lto *lto)
+{
+   for (uint32_t i = 0; i < lto->library_count; i++)
+      radv_graphics_lib_pipeline_unref(device, lto->libraries[i]);
+   lto->library_count = 0;
+}
+
+static void
+radv_graphics_pipeline_lto_execute(void *data, void *gdata, int thread_index)
+{
+   struct radv_graphics_pipeline_lto *lto = data;
+   struct radv_device *device = lto->device;
+   VkPipeline libraries[ARRAY_SIZE(lto->libraries)];
+   VkPipeline optimized;
+
+   for (uint32_t i = 0; i < lto->library_count; i++)
+      libraries[i] = radv_pipeline_to_handle(&lto->libraries[i]->base.base);
+
+   const VkPipelineLibraryCreateInfoKHR libs_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+      .libraryCount = lto->library_count,
+      .pLibraries = libraries,
+   };
+
+   const VkPipelineCreateFlags2CreateInfoKHR flags_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR,
+      .pNext = &libs_info,
+      .flags = lto->create_flags,
+   };
+
+   const VkGraphicsPipelineCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+      .pNext = &flags_info,
+   };
+
+   VkResult result = radv_graphics_pipeline_create(radv_device_to_handle(device),
+                                                   vk_pipeline_cache_to_handle(device->mem_cache), &create_info, NULL,
+                                                   NULL, &optimized);
+   if (result == VK_SUCCESS)
+      p_atomic_set(&lto->optimized, radv_pipeline_to_graphics(radv_pipeline_from_handle(optimized)));
+
+   radv_graphics_pipeline_lto_release_libraries(device, lto);
+}
+
+static void
+radv_graphics_pipeline_finish_lto(struct radv_device *device, struct radv_graphics_pipeline_lto *lto)
+{
+   util_queue_fence_wait(&lto->fence);
+   util_queue_fence_destroy(&lto->fence);
+
+   radv_graphics_pipeline_lto_release_libraries(device, lto);
+
+   if (lto->optimized)
+      radv_pipeline_destroy(device, &lto->optimized->base, NULL);
+
+   vk_free(&device->vk.alloc, lto);
+}
+
+/* Counts the binds of a fast-linked pipeline and queues its link-time optimized compile once it is hot. The
+ * optimized variant is used instead for all binds after it has been compiled, which is possible because both
+ * have the same state and layout.
+ */
+struct radv_graphics_pipeline *
+radv_graphics_pipeline_get_lto_variant(struct radv_device *device, struct radv_graphics_pipeline *pipeline)
+{
+   struct radv_graphics_pipeline_lto *lto = pipeline->lto;
+   struct radv_graphics_pipeline *optimized = p_atomic_read(&lto->optimized);
+
+   if (optimized)
+      return optimized;
+
+   if (p_atomic_inc_return(&lto->bind_count) == RADV_LTO_BIND_THRESHOLD)
+      util_queue_add_job(&device->lto_queue, lto, &lto->fence, radv_graphics_pipeline_lto_execute, NULL, 0);
+
+   return pipeline;
+}
+
 VkResult
 radv_graphics_pipeline_create(VkDevice _device, VkPipelineCache _cache, const VkGraphicsPipelineCreateInfo *pCreateInfo,
                               const struct radv_graphics_pipeline_create_info *extra,
@@ -4137,6 +4361,8 @@ radv_graphics_pipeline_create(VkDevice _device, VkPipelineCache _cache, const Vk
       return result;
    }
 
+   radv_graphics_pipeline_init_lto(device, pipeline, pCreateInfo);
+
    *pPipeline = radv_pipeline_to_handle(&pipeline->base);
    radv_rmv_log_graphics_pipeline_create(device, &pipeline->base, pipeline->base.is_internal);
    return VK_SUCCESS;
@@ -4145,6 +4371,9 @@ radv_graphics_pipeline_create(VkDevice _device, VkPipelineCache _cache, const Vk
 void
 radv_destroy_graphics_pipeline(struct radv_device *device, struct radv_graphics_pipeline *pipeline)
 {
+   if (pipeline->lto)
+      radv_graphics_pipeline_finish_lto(device, pipeline->lto);
+
    radv_pipeline_layout_finish(device, &pipeline->layout);
 
    for (unsigned i = 0; i < MESA_VULKAN_SHADER_STAGES; ++i) {
@@ -4231,6 +4460,8 @@ radv_graphics_lib_pipeline_create(VkDevice _device, VkPipelineCache _cache,
 
    radv_pipeline_init(device, &pipeline->base.base, RADV_PIPELINE_GRAPHICS_LIB);
    pipeline->base.base.create_flags = vk_graphics_pipeline_create_flags(pCreateInfo);
+   pipeline->ref_count = 1;
+   pipeline->alloc = pAllocator ? *pAllocator : device->vk.alloc;
 
    pipeline->mem_ctx = ralloc_context(NULL);
 
@@ -4245,6 +4476,13 @@ radv_graphics_lib_pipeline_create(VkDevice _device, VkPipelineCache _cache,
    return VK_SUCCESS;
 }
 
+void
+radv_graphics_lib_pipeline_unref(struct radv_device *device, struct radv_graphics_lib_pipeline *pipeline)
+{
+   if (p_atomic_dec_zero(&pipeline->ref_count))
+      radv_pipeline_destroy(device, &pipeline->base.base, &pipeline->alloc);
+}
+
 void
 radv_destroy_graphics_lib_pipeline(struct radv_device *device, struct radv_graphics_lib_pipeline *pipeline)
 {
@@ -125,6 +125,9 @@ struct radv_graphics_pipeline {
 
    /* For relocation of shaders with RGP. */
    struct radv_sqtt_shaders_reloc *sqtt_shaders_reloc;
+
+   /* For background link-time optimization of fast-linked pipelines (RADV_PERFTEST=background_lto). */
+   struct radv_graphics_pipeline_lto *lto;
 };
 
 RADV_DECL_PIPELINE_DOWNCAST(graphics, RADV_PIPELINE_GRAPHICS)
@@ -152,6 +155,12 @@ struct radv_graphics_lib_pipeline {
    unsigned stage_count;
    VkPipelineShaderStageCreateInfo *stages;
    struct radv_shader_stage_key stage_keys[MESA_VULKAN_SHADER_STAGES];
+
+   /* The application and pending background LTO compiles of pipelines linked with this library each hold a
+    * reference, the library is freed with the allocator it was created with.
+    */
+   uint32_t ref_count;
+   VkAllocationCallbacks alloc;
 };
 
 RADV_DECL_PIPELINE_DOWNCAST(graphics_lib, RADV_PIPELINE_GRAPHICS_LIB)
@@ -662,4 +671,21 @@ void radv_destroy_graphics_pipeline(struct radv_device *device, struct radv_grap
 
 void radv_destroy_graphics_lib_pipeline(struct radv_device *device, struct radv_graphics_lib_pipeline *pipeline);
 
+void radv_graphics_lib_pipeline_unref(struct radv_device *device, struct radv_graphics_lib_pipeline *pipeline);
+
+struct radv_graphics_pipeline *radv_graphics_pipeline_get_lto_variant(struct radv_device *device,
+                                                                      struct radv_graphics_pipeline *pipeline);
+
+/* Returns the pipeline to bind for the application pipeline, which is its link-time optimized variant
+ * once that has been compiled in the background.
+ */
+static inline struct radv_graphics_pipeline *
+radv_graphics_pipeline_get_bind_variant(struct radv_device *device, struct radv_graphics_pipeline *pipeline)
+{
+   if (likely(!pipeline->lto))
+      return pipeline;
+
+   return radv_graphics_pipeline_get_lto_variant(device, pipeline);
+}
+
 #endif /* RADV_PIPELINE_GRAPHICS_H */
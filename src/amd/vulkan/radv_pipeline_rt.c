@@ -194,7 +194,7 @@ radv_rt_fill_group_info(struct radv_device *device, const struct radv_ray_tracin
                }
 
                radv_shader_wait_for_upload(device, library_shader->upload_seq);
-               radv_free_shader_memory(device, library_shader->alloc);
+               radv_shader_free_code_memory(device, library_shader);
 
                library_shader->alloc = new_block;
                library_shader->has_replay_alloc = true;
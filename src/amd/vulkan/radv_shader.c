@@ -122,54 +122,55 @@ radv_optimize_nir(struct nir_shader *shader, bool optimize_conservatively)
 {
    bool progress;
 
-   struct set *skip = _mesa_pointer_set_create(NULL);
+   nir_pass_tracker tracker;
+   nir_pass_tracker_init(&tracker);
    do {
       progress = false;
 
-      NIR_LOOP_PASS(progress, skip, shader, nir_split_array_vars, nir_var_function_temp);
-      NIR_LOOP_PASS(progress, skip, shader, nir_shrink_vec_array_vars, nir_var_function_temp);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_split_array_vars, nir_var_function_temp);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_shrink_vec_array_vars, nir_var_function_temp);
 
       if (!shader->info.var_copies_lowered) {
          /* Only run this pass if nir_lower_var_copies was not called
           * yet. That would lower away any copy_deref instructions and we
           * don't want to introduce any more.
           */
-         NIR_LOOP_PASS(progress, skip, shader, nir_opt_find_array_copies);
+         NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_find_array_copies);
       }
 
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_copy_prop_vars);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_dead_write_vars);
-      NIR_LOOP_PASS(_, skip, shader, nir_lower_vars_to_ssa);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_copy_prop_vars);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_dead_write_vars);
+      NIR_TRACKED_PASS(_, &tracker, shader, nir_lower_vars_to_ssa);
 
-      NIR_LOOP_PASS(_, skip, shader, nir_lower_alu_width, vectorize_vec2_16bit, NULL);
-      NIR_LOOP_PASS(_, skip, shader, nir_lower_phis_to_scalar, true);
+      NIR_TRACKED_PASS(_, &tracker, shader, nir_lower_alu_width, vectorize_vec2_16bit, NULL);
+      NIR_TRACKED_PASS(_, &tracker, shader, nir_lower_phis_to_scalar, true);
 
-      NIR_LOOP_PASS(progress, skip, shader, nir_copy_prop);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_remove_phis);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_dce);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_copy_prop);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_remove_phis);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_dce);
       bool opt_loop_progress = false;
-      NIR_LOOP_PASS(opt_loop_progress, skip, shader, nir_opt_loop);
+      NIR_TRACKED_PASS(opt_loop_progress, &tracker, shader, nir_opt_loop);
       if (opt_loop_progress) {
          progress = true;
-         NIR_LOOP_PASS(progress, skip, shader, nir_copy_prop);
-         NIR_LOOP_PASS(progress, skip, shader, nir_opt_remove_phis);
-         NIR_LOOP_PASS(progress, skip, shader, nir_opt_dce);
+         NIR_TRACKED_PASS(progress, &tracker, shader, nir_copy_prop);
+         NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_remove_phis);
+         NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_dce);
       }
-      NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, shader, nir_opt_if, nir_opt_if_optimize_phi_true_false);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_dead_cf);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_cse);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_peephole_select, 8, true, true);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_constant_folding);
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_intrinsics);
-      NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, shader, nir_opt_algebraic);
+      NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, shader, nir_opt_if, nir_opt_if_optimize_phi_true_false);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_dead_cf);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_cse);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_peephole_select, 8, true, true);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_constant_folding);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_intrinsics);
+      NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, shader, nir_opt_algebraic);
 
-      NIR_LOOP_PASS(progress, skip, shader, nir_opt_undef);
+      NIR_TRACKED_PASS(progress, &tracker, shader, nir_opt_undef);
 
       if (shader->options->max_unroll_iterations) {
-         NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, shader, nir_opt_loop_unroll);
+         NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, shader, nir_opt_loop_unroll);
       }
    } while (progress && !optimize_conservatively);
-   _mesa_set_destroy(skip, NULL);
+   nir_pass_tracker_fini(&tracker);
 
    NIR_PASS(progress, shader, nir_opt_shrink_vectors, true);
    NIR_PASS(progress, shader, nir_remove_dead_variables,
@@ -215,16 +216,17 @@ radv_optimize_nir_algebraic(nir_shader *nir, bool opt_offsets, bool opt_mqsad)
     * fneg(fneg(a)).
     */
    bool more_late_algebraic = true;
-   struct set *skip = _mesa_pointer_set_create(NULL);
+   nir_pass_tracker tracker;
+   nir_pass_tracker_init(&tracker);
    while (more_late_algebraic) {
       more_late_algebraic = false;
-      NIR_LOOP_PASS_NOT_IDEMPOTENT(more_late_algebraic, skip, nir, nir_opt_algebraic_late);
-      NIR_LOOP_PASS(_, skip, nir, nir_opt_constant_folding);
-      NIR_LOOP_PASS(_, skip, nir, nir_copy_prop);
-      NIR_LOOP_PASS(_, skip, nir, nir_opt_dce);
-      NIR_LOOP_PASS(_, skip, nir, nir_opt_cse);
+      NIR_TRACKED_PASS_NOT_IDEMPOTENT(more_late_algebraic, &tracker, nir, nir_opt_algebraic_late);
+      NIR_TRACKED_PASS(_, &tracker, nir, nir_opt_constant_folding);
+      NIR_TRACKED_PASS(_, &tracker, nir, nir_copy_prop);
+      NIR_TRACKED_PASS(_, &tracker, nir, nir_opt_dce);
+      NIR_TRACKED_PASS(_, &tracker, nir, nir_opt_cse);
    }
-   _mesa_set_destroy(skip, NULL);
+   nir_pass_tracker_fini(&tracker);
 }
 
 static void
@@ -1229,6 +1231,104 @@ radv_free_shader_memory(struct radv_device *device, union radv_shader_arena_bloc
    mtx_unlock(&device->shader_arena_mutex);
 }
 
+/* Shaders which end up with identical code (e.g. the same shader used by many pipelines with
+ * different state, or trivial shaders) share one allocation in the shader arena instead of
+ * uploading the code again.
+ */
+struct radv_shader_code_entry {
+   blake3_hash hash;
+   uint32_t ref_count;
+   union radv_shader_arena_block *alloc;
+   uint64_t upload_seq;
+};
+
+static uint32_t
+radv_shader_code_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(blake3_hash));
+}
+
+static bool
+radv_shader_code_equal(const void *a, const void *b)
+{
+   return !memcmp(a, b, sizeof(blake3_hash));
+}
+
+static bool
+radv_shader_code_dedup_enabled(const struct radv_device *device)
+{
+   /* radv_find_shader() needs every arena block to point to its shader. */
+   return device->shader_code_table && !device->keep_shader_info;
+}
+
+static struct radv_shader_code_entry *
+radv_shader_code_entry_ref(struct radv_device *device, const blake3_hash hash)
+{
+   struct radv_shader_code_entry *entry = NULL;
+
+   simple_mtx_lock(&device->shader_code_mtx);
+   struct hash_entry *he = _mesa_hash_table_search(device->shader_code_table, hash);
+   if (he) {
+      entry = he->data;
+      entry->ref_count++;
+   }
+   simple_mtx_unlock(&device->shader_code_mtx);
+
+   return entry;
+}
+
+/* Publishes the freshly uploaded code of \p shader. Returns false if another thread uploaded the
+ * same code in the meantime, in which case the shader keeps its own allocation.
+ */
+static bool
+radv_shader_code_entry_add(struct radv_device *device, struct radv_shader *shader, const blake3_hash hash)
+{
+   struct radv_shader_code_entry *entry = calloc(1, sizeof(*entry));
+   if (!entry)
+      return false;
+
+   memcpy(entry->hash, hash, sizeof(blake3_hash));
+   entry->ref_count = 1;
+   entry->alloc = shader->alloc;
+   entry->upload_seq = shader->upload_seq;
+
+   simple_mtx_lock(&device->shader_code_mtx);
+   bool added = !_mesa_hash_table_search(device->shader_code_table, entry->hash);
+   if (added)
+      _mesa_hash_table_insert(device->shader_code_table, entry->hash, entry);
+   simple_mtx_unlock(&device->shader_code_mtx);
+
+   if (!added) {
+      free(entry);
+      return false;
+   }
+
+   shader->code_entry = entry;
+   return true;
+}
+
+void
+radv_shader_free_code_memory(struct radv_device *device, struct radv_shader *shader)
+{
+   struct radv_shader_code_entry *entry = shader->code_entry;
+
+   if (entry) {
+      simple_mtx_lock(&device->shader_code_mtx);
+      const bool last_ref = --entry->ref_count == 0;
+      if (last_ref)
+         _mesa_hash_table_remove_key(device->shader_code_table, entry->hash);
+      simple_mtx_unlock(&device->shader_code_mtx);
+
+      shader->code_entry = NULL;
+      if (!last_ref)
+         return;
+
+      free(entry);
+   }
+
+   radv_free_shader_memory(device, shader->alloc);
+}
+
 struct radv_serialized_shader_arena_block
 radv_serialize_shader_arena_block(union radv_shader_arena_block *block)
 {
@@ -1306,6 +1406,10 @@ radv_init_shader_arenas(struct radv_device *device)
       list_inithead(&device->shader_free_list.free_lists[i]);
       list_inithead(&device->capture_replay_free_list.free_lists[i]);
    }
+
+   /* Deduplication is only an optimization, so it's simply disabled if this fails. */
+   simple_mtx_init(&device->shader_code_mtx, mtx_plain);
+   device->shader_code_table = _mesa_hash_table_create(NULL, radv_shader_code_hash, radv_shader_code_equal);
 }
 
 void
@@ -1319,6 +1423,9 @@ radv_destroy_shader_arenas(struct radv_device *device)
       free(arena);
    }
    mtx_destroy(&device->shader_arena_mutex);
+
+   _mesa_hash_table_destroy(device->shader_code_table, NULL);
+   simple_mtx_destroy(&device->shader_code_mtx);
 }
 
 VkResult
@@ -2160,6 +2267,37 @@ radv_shader_create_uncached(struct radv_device *device, const struct radv_shader
       }
    }
 
+   /* Capture/replay shaders need their own allocation at a fixed address. */
+   const bool dedup =
+      binary->type == RADV_BINARY_TYPE_LEGACY && !replay_block && !replayable && radv_shader_code_dedup_enabled(device);
+   blake3_hash code_hash;
+
+   if (dedup) {
+      const struct radv_shader_binary_legacy *bin = (const struct radv_shader_binary_legacy *)binary;
+      _mesa_blake3_compute(bin->data + bin->stats_size, bin->code_size, code_hash);
+
+      struct radv_shader_code_entry *entry = radv_shader_code_entry_ref(device, code_hash);
+      if (entry) {
+         shader->code_entry = entry;
+         shader->alloc = entry->alloc;
+
+         shader->code = malloc(shader->code_size);
+         if (!shader->code) {
+            radv_shader_free_code_memory(device, shader);
+            result = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+         }
+         memcpy(shader->code, bin->data + bin->stats_size, bin->code_size);
+
+         shader->upload_seq = entry->upload_seq;
+         shader->bo = shader->alloc->arena->bo;
+         shader->va = radv_buffer_get_va(shader->bo) + shader->alloc->offset;
+
+         *out_shader = shader;
+         goto out;
+      }
+   }
+
    if (replay_block) {
       shader->alloc = radv_replay_shader_arena_block(device, replay_block, shader);
       if (!shader->alloc) {
@@ -2169,7 +2307,8 @@ radv_shader_create_uncached(struct radv_device *device, const struct radv_shader
 
       shader->has_replay_alloc = true;
    } else {
-      shader->alloc = radv_alloc_shader_memory(device, shader->code_size, replayable, shader);
+      /* Shared allocations can outlive the shader, so don't point them back to it. */
+      shader->alloc = radv_alloc_shader_memory(device, shader->code_size, replayable, dedup ? NULL : shader);
       if (!shader->alloc) {
          result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
          goto out;
@@ -2184,6 +2323,9 @@ radv_shader_create_uncached(struct radv_device *device, const struct radv_shader
       goto out;
    }
 
+   if (dedup)
+      radv_shader_code_entry_add(device, shader, code_hash);
+
    *out_shader = shader;
 
 out:
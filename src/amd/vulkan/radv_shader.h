@@ -84,6 +84,9 @@ struct radv_shader_stage_key {
 
    /* Whether the mesh shader is used with a task shader. */
    uint8_t has_task_shader : 1;
+
+   /* Use the ACO fast-compile tier, see aco_compiler_options::fast_compile. */
+   uint8_t fast_compile : 1;
 };
 
 struct radv_ps_epilog_key {
@@ -418,6 +421,9 @@ struct radv_shader {
 
    uint64_t upload_seq;
 
+   /* Non-NULL if the GPU code is shared with other shaders with identical code. */
+   struct radv_shader_code_entry *code_entry;
+
    struct ac_shader_config config;
    uint32_t code_size;
    uint32_t exec_size;
@@ -551,6 +557,8 @@ struct radv_serialized_shader_arena_block radv_serialize_shader_arena_block(unio
 
 void radv_free_shader_memory(struct radv_device *device, union radv_shader_arena_block *alloc);
 
+void radv_shader_free_code_memory(struct radv_device *device, struct radv_shader *shader);
+
 struct radv_shader *radv_create_trap_handler_shader(struct radv_device *device);
 
 struct radv_shader *radv_create_rt_prolog(struct radv_device *device);
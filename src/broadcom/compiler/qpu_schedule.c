@@ -1538,12 +1538,6 @@ retry:
                              n->inst->ldtmu_count > 16 / c->threads)) {
                                 continue;
                         }
-
-                        struct v3d_qpu_instr merged_inst;
-                        if (!qpu_merge_inst(c->devinfo, &merged_inst,
-                                            &prev_inst->inst->qpu, inst)) {
-                                continue;
-                        }
                 }
 
                 int prio = get_instruction_priority(c->devinfo, inst);
@@ -1560,28 +1554,30 @@ retry:
                         }
                 }
 
-                /* Found a valid instruction.  If nothing better comes along,
-                 * this one works.
+                /* Skip anything that wouldn't replace our current choice
+                 * before trying to merge it, since qpu_merge_inst() is by far
+                 * the most expensive check here and we call this for every
+                 * ready instruction on every pairing attempt.
                  */
-                if (!chosen) {
-                        chosen = n;
-                        chosen_prio = prio;
+                if (chosen &&
+                    (prio < chosen_prio ||
+                     (prio == chosen_prio && n->delay <= chosen->delay))) {
                         continue;
                 }
 
-                if (prio > chosen_prio) {
-                        chosen = n;
-                        chosen_prio = prio;
-                } else if (prio < chosen_prio) {
-                        continue;
+                if (prev_inst) {
+                        struct v3d_qpu_instr merged_inst;
+                        if (!qpu_merge_inst(c->devinfo, &merged_inst,
+                                            &prev_inst->inst->qpu, inst)) {
+                                continue;
+                        }
                 }
 
-                if (n->delay > chosen->delay) {
-                        chosen = n;
-                        chosen_prio = prio;
-                } else if (n->delay < chosen->delay) {
-                        continue;
-                }
+                /* Found a valid instruction.  If nothing better comes along,
+                 * this one works.
+                 */
+                chosen = n;
+                chosen_prio = prio;
         }
 
         /* If we did not find any instruction to schedule but we discarded
@@ -2273,7 +2273,7 @@ can_skip_compile(struct gl_context *ctx, struct gl_shader *shader,
                                 shader->disk_cache_sha1);
          if (disk_cache_has_key(ctx->Cache, shader->disk_cache_sha1)) {
             /* We've seen this shader before and know it compiles */
-            if (ctx->_Shader->Flags & GLSL_CACHE_INFO) {
+            if (ctx->Shader.Flags & GLSL_CACHE_INFO) {
                _mesa_sha1_format(buf, shader->disk_cache_sha1);
                fprintf(stderr, "deferring compile of shader: %s\n", buf);
             }
@@ -2438,7 +2438,7 @@ _mesa_glsl_compile_shader(struct gl_context *ctx, struct gl_shader *shader,
    if (ctx->Cache && shader->CompileStatus == COMPILE_SUCCESS) {
       char sha1_buf[41];
       disk_cache_put_key(ctx->Cache, shader->disk_cache_sha1);
-      if (ctx->_Shader->Flags & GLSL_CACHE_INFO) {
+      if (ctx->Shader.Flags & GLSL_CACHE_INFO) {
          _mesa_sha1_format(sha1_buf, shader->disk_cache_sha1);
          fprintf(stderr, "marking shader: %s\n", sha1_buf);
       }
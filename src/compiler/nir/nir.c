@@ -31,6 +31,7 @@
 #include <math.h>
 #include "util/half_float.h"
 #include "util/macros.h"
+#include "util/os_time.h"
 #include "util/u_math.h"
 #include "util/u_qsort.h"
 #include "nir_builder.h"
@@ -201,6 +202,7 @@ nir_shader_create(void *mem_ctx,
 #ifndef NDEBUG
    nir_process_debug_variable();
 #endif
+   nir_pass_stats_init();
 
    exec_list_make_empty(&shader->variables);
 
@@ -222,6 +224,52 @@ nir_shader_create(void *mem_ctx,
    return shader;
 }
 
+/** Recounts the instructions charged against the shader's budget
+ *
+ * Passes consulting the budget call this once before making their
+ * decisions, which are then charged with nir_shader_budget_consume().
+ */
+void
+nir_shader_budget_update(nir_shader *shader)
+{
+   if (shader->budget.max_instrs == 0)
+      return;
+
+   unsigned num_instrs = 0;
+   nir_foreach_function_impl(impl, shader) {
+      nir_foreach_block(block, impl) {
+         num_instrs += exec_list_length(&block->instr_list);
+      }
+   }
+
+   shader->budget.num_instrs = num_instrs;
+}
+
+/** Charges num_instrs new instructions against the shader's budget
+ *
+ * Returns false, without charging anything, if the budget doesn't allow for
+ * them or the deadline has passed.  A num_instrs of 0 just checks whether
+ * the budget is already exhausted.
+ */
+bool
+nir_shader_budget_consume(nir_shader *shader, unsigned num_instrs)
+{
+   nir_compile_budget *budget = &shader->budget;
+
+   if (!nir_shader_has_budget(shader))
+      return true;
+
+   if (budget->deadline_ns != 0 && os_time_get_nano() >= budget->deadline_ns)
+      return false;
+
+   if (budget->max_instrs != 0 &&
+       (uint64_t)budget->num_instrs + num_instrs > budget->max_instrs)
+      return false;
+
+   budget->num_instrs += num_instrs;
+   return true;
+}
+
 void
 nir_shader_add_variable(nir_shader *shader, nir_variable *var)
 {
@@ -558,6 +606,13 @@ nir_function_impl_create_bare(nir_shader *shader)
    impl->num_blocks = 0;
    impl->valid_metadata = nir_metadata_none;
    impl->structured = true;
+   impl->change_seq = ++shader->change_seq;
+   impl->instr_change_seq = 0;
+   impl->cfg_change_seq = 1;
+   impl->dominance_cfg_seq = 0;
+   impl->live_defs_cfg_seq = 0;
+   impl->live_defs_ssa_alloc = 0;
+   impl->algebraic_seqs = NULL;
 
    /* create start & end blocks */
    nir_block *start_block = nir_block_create(shader);
@@ -586,22 +641,17 @@ nir_function_impl_create(nir_function *function)
 nir_block *
 nir_block_create(nir_shader *shader)
 {
-   nir_block *block = rzalloc(shader, nir_block);
+   nir_block *block = gc_zalloc(shader->gctx, nir_block, 1);
 
    cf_init(&block->cf_node, nir_cf_node_block);
 
    block->successors[0] = block->successors[1] = NULL;
-   block->predecessors = _mesa_pointer_set_create(block);
+   block->predecessors = _mesa_pointer_set_create(shader);
    block->imm_dom = NULL;
-   /* XXX maybe it would be worth it to defer allocation?  This
-    * way it doesn't get allocated for shader refs that never run
-    * nir_calc_dominance?  For example, state-tracker creates an
-    * initial IR, clones that, runs appropriate lowering pass, passes
-    * to driver which does common lowering/opt, and then stores ref
-    * which is later used to do state specific lowering and futher
-    * opt.  Do any of the references not need dominance metadata?
+   /* The dominance frontier is allocated by nir_calc_dominance_impl() so
+    * that shaders which never require dominance don't pay for it.
     */
-   block->dom_frontier = _mesa_pointer_set_create(block);
+   block->dom_frontier = NULL;
 
    exec_list_make_empty(&block->instr_list);
 
@@ -617,7 +667,7 @@ src_init(nir_src *src)
 nir_if *
 nir_if_create(nir_shader *shader)
 {
-   nir_if *if_stmt = ralloc(shader, nir_if);
+   nir_if *if_stmt = gc_alloc(shader->gctx, nir_if, 1);
 
    if_stmt->control = nir_selection_control_none;
 
@@ -640,7 +690,7 @@ nir_if_create(nir_shader *shader)
 nir_loop *
 nir_loop_create(nir_shader *shader)
 {
-   nir_loop *loop = rzalloc(shader, nir_loop);
+   nir_loop *loop = gc_zalloc(shader->gctx, nir_loop, 1);
 
    cf_init(&loop->cf_node, nir_cf_node_loop);
    /* Assume that loops are divergent until proven otherwise */
@@ -664,6 +714,7 @@ instr_init(nir_instr *instr, nir_instr_type type)
 {
    instr->type = type;
    instr->block = NULL;
+   instr->change_seq = 0;
    exec_node_init(&instr->node);
 }
 
@@ -980,6 +1031,22 @@ nir_cf_node_get_function(nir_cf_node *node)
    return nir_cf_node_as_function(node);
 }
 
+/* Like nir_cf_node_get_function(), but also handles instructions which were
+ * never inserted or are part of an extracted nir_cf_list.
+ */
+static nir_function_impl *
+instr_get_impl_if_inserted(const nir_instr *instr)
+{
+   if (instr->block == NULL)
+      return NULL;
+
+   nir_cf_node *node = &instr->block->cf_node;
+   while (node != NULL && node->type != nir_cf_node_function)
+      node = node->parent;
+
+   return node ? nir_cf_node_as_function(node) : NULL;
+}
+
 /* Reduces a cursor by trying to convert everything to after and trying to
  * go up to block granularity when possible.
  */
@@ -1048,12 +1115,9 @@ add_use_cb(nir_src *src, void *state)
 static bool
 add_ssa_def_cb(nir_def *def, void *state)
 {
-   nir_instr *instr = state;
-
-   if (instr->block && def->index == UINT_MAX) {
-      nir_function_impl *impl =
-         nir_cf_node_get_function(&instr->block->cf_node);
+   nir_function_impl *impl = state;
 
+   if (def->index == UINT_MAX) {
       def->index = impl->ssa_alloc++;
 
       impl->valid_metadata &= ~nir_metadata_live_defs;
@@ -1063,15 +1127,21 @@ add_ssa_def_cb(nir_def *def, void *state)
 }
 
 static void
-add_defs_uses(nir_instr *instr)
+add_defs_uses(nir_instr *instr, nir_function_impl *impl)
 {
    nir_foreach_src(instr, add_use_cb, instr);
-   nir_foreach_def(instr, add_ssa_def_cb, instr);
+   nir_foreach_def(instr, add_ssa_def_cb, impl);
 }
 
 void
 nir_instr_insert(nir_cursor cursor, nir_instr *instr)
 {
+   /* Look the impl up once; walking up the CF tree is the most expensive
+    * part of inserting an instruction into a deeply nested block.
+    */
+   nir_block *block = nir_cursor_current_block(cursor);
+   nir_function_impl *impl = nir_cf_node_get_function(&block->cf_node);
+
    switch (cursor.option) {
    case nir_cursor_before_block:
       /* Only allow inserting jumps into empty blocks. */
@@ -1079,7 +1149,7 @@ nir_instr_insert(nir_cursor cursor, nir_instr *instr)
          assert(exec_list_is_empty(&cursor.block->instr_list));
 
       instr->block = cursor.block;
-      add_defs_uses(instr);
+      add_defs_uses(instr, impl);
       exec_list_push_head(&cursor.block->instr_list, &instr->node);
       break;
    case nir_cursor_after_block: {
@@ -1089,14 +1159,14 @@ nir_instr_insert(nir_cursor cursor, nir_instr *instr)
       (void)last;
 
       instr->block = cursor.block;
-      add_defs_uses(instr);
+      add_defs_uses(instr, impl);
       exec_list_push_tail(&cursor.block->instr_list, &instr->node);
       break;
    }
    case nir_cursor_before_instr:
       assert(instr->type != nir_instr_type_jump);
       instr->block = cursor.instr->block;
-      add_defs_uses(instr);
+      add_defs_uses(instr, impl);
       exec_node_insert_node_before(&cursor.instr->node, &instr->node);
       break;
    case nir_cursor_after_instr:
@@ -1108,7 +1178,7 @@ nir_instr_insert(nir_cursor cursor, nir_instr *instr)
          assert(cursor.instr == nir_block_last_instr(cursor.instr->block));
 
       instr->block = cursor.instr->block;
-      add_defs_uses(instr);
+      add_defs_uses(instr, impl);
       exec_node_insert_after(&cursor.instr->node, &instr->node);
       break;
    }
@@ -1116,8 +1186,8 @@ nir_instr_insert(nir_cursor cursor, nir_instr *instr)
    if (instr->type == nir_instr_type_jump)
       nir_handle_add_jump(instr->block);
 
-   nir_function_impl *impl = nir_cf_node_get_function(&instr->block->cf_node);
    impl->valid_metadata &= ~nir_metadata_instr_index;
+   instr->change_seq = ++impl->instr_change_seq;
 }
 
 bool
@@ -1145,10 +1215,15 @@ src_is_valid(const nir_src *src)
 static bool
 remove_use_cb(nir_src *src, void *state)
 {
-   (void)state;
+   nir_function_impl *impl = state;
+
+   if (src_is_valid(src)) {
+      /* The def losing a use may let passes optimize it further. */
+      if (impl && src->ssa->parent_instr->block)
+         src->ssa->parent_instr->change_seq = ++impl->instr_change_seq;
 
-   if (src_is_valid(src))
       list_del(&src->use_link);
+   }
 
    return true;
 }
@@ -1156,7 +1231,7 @@ remove_use_cb(nir_src *src, void *state)
 static void
 remove_defs_uses(nir_instr *instr)
 {
-   nir_foreach_src(instr, remove_use_cb, instr);
+   nir_foreach_src(instr, remove_use_cb, instr_get_impl_if_inserted(instr));
 }
 
 void
@@ -1480,11 +1555,14 @@ nir_instr_init_src(nir_instr *instr, nir_src *src, nir_def *def)
 {
    *src = nir_src_for_ssa(def);
    src_add_all_uses(src, instr, NULL);
+   nir_instr_mark_changed(instr);
 }
 
 void
 nir_instr_clear_src(nir_instr *instr, nir_src *src)
 {
+   if (src_is_valid(src))
+      nir_src_mark_changed(src);
    src_remove_all_uses(src);
    *src = NIR_SRC_INIT;
 }
@@ -1524,6 +1602,43 @@ nir_def_init(nir_instr *instr, nir_def *def,
    }
 }
 
+/**
+ * Records that the instruction changed by giving it a new change_seq.
+ *
+ * nir_instr_insert() and source rewrites already do this.  Passes which
+ * modify an instruction in place in a way that may enable other optimizations
+ * (changing the opcode, swizzles, flags, ...) should call it too.
+ */
+void
+nir_instr_mark_changed(nir_instr *instr)
+{
+   nir_function_impl *impl = instr_get_impl_if_inserted(instr);
+   if (impl)
+      instr->change_seq = ++impl->instr_change_seq;
+}
+
+/**
+ * Marks the instruction reading the source and the instruction defining it as
+ * changed, for use before the source is rewritten or removed.
+ */
+void
+nir_src_mark_changed(nir_src *src)
+{
+   nir_instr *def_instr = src->ssa->parent_instr;
+   nir_instr *use_instr = nir_src_is_if(src) ? NULL : nir_src_parent_instr(src);
+
+   nir_function_impl *impl = instr_get_impl_if_inserted(def_instr);
+   if (impl == NULL && use_instr)
+      impl = instr_get_impl_if_inserted(use_instr);
+   if (impl == NULL)
+      return;
+
+   if (def_instr->block)
+      def_instr->change_seq = ++impl->instr_change_seq;
+   if (use_instr && use_instr->block)
+      use_instr->change_seq = ++impl->instr_change_seq;
+}
+
 void
 nir_def_rewrite_uses(nir_def *def, nir_def *new_ssa)
 {
@@ -1954,6 +2069,7 @@ nir_index_ssa_defs(nir_function_impl *impl)
    unsigned index = 0;
 
    impl->valid_metadata &= ~nir_metadata_live_defs;
+   impl->live_defs_cfg_seq = 0;
 
    nir_foreach_block_unstructured(block, impl) {
       nir_foreach_instr(instr, block)
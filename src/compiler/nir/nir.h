@@ -971,6 +971,12 @@ typedef struct nir_instr {
     */
    uint8_t pass_flags;
 
+   /** Value of nir_function_impl::instr_change_seq when this instruction was
+    * last inserted, had a source rewritten or had the uses of its def change.
+    * Zero for instructions which never changed since the impl was created.
+    */
+   uint32_t change_seq;
+
    /** generic instruction index. */
    uint32_t index;
 } nir_instr;
@@ -2960,7 +2966,9 @@ typedef struct nir_block {
    unsigned num_dom_children;
    struct nir_block **dom_children;
 
-   /* Set of nir_blocks on the dominance frontier of this block */
+   /* Set of nir_blocks on the dominance frontier of this block.  This is
+    * only allocated the first time dominance is computed for the block.
+    */
    struct set *dom_frontier;
 
    /*
@@ -3350,6 +3358,42 @@ typedef struct {
    bool structured;
 
    nir_metadata valid_metadata;
+
+   /** Value of nir_shader::change_seq when this impl was last changed
+    *
+    * This is bumped by nir_metadata_preserve() whenever a pass drops any
+    * metadata, which is what passes do when they modify an impl.  Together
+    * with nir_pass_tracker it is used to skip passes on impls which did not
+    * change since the pass last ran.
+    */
+   uint64_t change_seq;
+
+   /** Counter for nir_instr::change_seq, only ever incremented */
+   uint32_t instr_change_seq;
+
+   /** nir_algebraic_table -> instr_change_seq when the table was last run
+    * incrementally on this impl, see nir_algebraic_impl().
+    */
+   struct hash_table *algebraic_seqs;
+
+   /** Incremented by nir_control_flow.c whenever the CFG changes */
+   uint32_t cfg_change_seq;
+
+   /** cfg_change_seq when dominance was last computed, or 0
+    *
+    * Dominance only depends on the CFG, so nir_calc_dominance_impl() can
+    * skip the computation if the CFG did not change since, no matter which
+    * passes dropped nir_metadata_dominance in the meantime.
+    */
+   uint32_t dominance_cfg_seq;
+
+   /** cfg_change_seq and ssa_alloc when live_in/live_out were last computed
+    *
+    * live_defs_cfg_seq is 0 if the live sets can't be updated incrementally
+    * by nir_live_defs_update_impl().
+    */
+   uint32_t live_defs_cfg_seq;
+   unsigned live_defs_ssa_alloc;
 } nir_function_impl;
 
 #define nir_foreach_function_temp_variable(var, impl) \
@@ -4189,7 +4233,37 @@ typedef struct nir_shader_compiler_options {
    unsigned (*varying_estimate_instr_cost)(struct nir_instr *instr);
 } nir_shader_compiler_options;
 
+/**
+ * Compile-time budget of a shader
+ *
+ * Drivers which may receive pathological shaders can set a limit before
+ * running their optimization loop.  Passes which can blow up the
+ * instruction count or extend live ranges consult it through
+ * nir_shader_budget_consume() and fall back to cheaper decisions once it is
+ * exhausted:
+ *
+ *  - nir_opt_loop_unroll only unrolls loops it is forced to,
+ *  - nir_inline_functions keeps calls if the driver supports them,
+ *  - nir_opt_gcm only does weak value numbering.
+ *
+ * Such decisions are counted in shader_info::budget_skipped_*.
+ */
+typedef struct nir_compile_budget {
+   /** Soft limit on the number of instructions, 0 for none */
+   unsigned max_instrs;
+
+   /** os_time_get_nano() time at which the budget runs out, 0 for none */
+   int64_t deadline_ns;
+
+   /**
+    * Instruction count at the last nir_shader_budget_update() plus the
+    * growth granted by nir_shader_budget_consume() since then.
+    */
+   unsigned num_instrs;
+} nir_compile_budget;
+
 typedef struct nir_shader {
+   /** Slab allocator for instructions and CF nodes; compacted by nir_sweep */
    gc_ctx *gctx;
 
    /** list of uniforms (nir_variable) */
@@ -4237,6 +4311,22 @@ typedef struct nir_shader {
 
    unsigned printf_info_count;
    u_printf_info *printf_info;
+
+   /** Counter for nir_function_impl::change_seq, only ever incremented */
+   uint64_t change_seq;
+
+   /**
+    * While a pass is run through a nir_pass_tracker, impls with a change_seq
+    * at or below this value have not changed since the pass last ran on them
+    * and are skipped by nir_foreach_dirty_function_impl.  Zero otherwise.
+    */
+   uint64_t pass_clean_seq;
+
+   /** The tracker running the current pass, if any */
+   struct nir_pass_tracker *pass_tracker;
+
+   /** Compile-time budget, unlimited by default */
+   nir_compile_budget budget;
 } nir_shader;
 
 #define nir_foreach_function(func, shader) \
@@ -4292,6 +4382,19 @@ nir_foreach_function_with_impl_next(nir_function **it)
 #define nir_foreach_function_impl(it, shader) \
    nir_foreach_function_with_impl(_func_##it, it, shader)
 
+/* Like nir_foreach_function_impl, but skips the impls that did not change
+ * since the pass currently running through a nir_pass_tracker last ran on
+ * them.  Outside of a tracked pass this visits every impl.
+ *
+ * Only use this in passes whose work on an impl depends on nothing but that
+ * impl (and the pass options).  Skipped impls have all their metadata
+ * preserved.
+ */
+#define nir_foreach_dirty_function_impl(it, shader) \
+   nir_foreach_function_impl(it, shader)            \
+      if (nir_function_impl_skip_clean(it)) {       \
+      } else
+
 static inline nir_function_impl *
 nir_shader_get_entrypoint(const nir_shader *shader)
 {
@@ -4338,6 +4441,15 @@ nir_shader *nir_shader_create(void *mem_ctx,
                               const nir_shader_compiler_options *options,
                               shader_info *si);
 
+static inline bool
+nir_shader_has_budget(const nir_shader *shader)
+{
+   return shader->budget.max_instrs != 0 || shader->budget.deadline_ns != 0;
+}
+
+void nir_shader_budget_update(nir_shader *shader);
+bool nir_shader_budget_consume(nir_shader *shader, unsigned num_instrs);
+
 /** Adds a variable to the appropriate list in nir_shader */
 void nir_shader_add_variable(nir_shader *shader, nir_variable *var);
 
@@ -4423,6 +4535,24 @@ void nir_metadata_require(nir_function_impl *impl, nir_metadata required, ...);
 void nir_metadata_preserve(nir_function_impl *impl, nir_metadata preserved);
 /** Preserves all metadata for the given shader */
 void nir_shader_preserve_all_metadata(nir_shader *shader);
+/** marks the impl as changed for change tracking, see nir_pass_tracker */
+void nir_function_impl_mark_changed(nir_function_impl *impl);
+/** marks all impls in the shader as changed */
+void nir_shader_mark_changed(nir_shader *shader);
+
+/** Returns true, preserving all metadata, if the impl can be skipped by the
+ * currently running pass.  See nir_foreach_dirty_function_impl.
+ */
+static inline bool
+nir_function_impl_skip_clean(nir_function_impl *impl)
+{
+   const nir_shader *shader = impl->function->shader;
+   if (impl->change_seq > shader->pass_clean_seq)
+      return false;
+
+   nir_metadata_preserve(impl, nir_metadata_all);
+   return true;
+}
 
 /** creates an instruction with default swizzle/writemask/etc. with NULL registers */
 nir_alu_instr *nir_alu_instr_create(nir_shader *shader, nir_op op);
@@ -4765,11 +4895,15 @@ bool nir_src_is_always_uniform(nir_src src);
 bool nir_srcs_equal(nir_src src1, nir_src src2);
 bool nir_instrs_equal(const nir_instr *instr1, const nir_instr *instr2);
 
+void nir_instr_mark_changed(nir_instr *instr);
+void nir_src_mark_changed(nir_src *src);
+
 static inline void
 nir_src_rewrite(nir_src *src, nir_def *new_ssa)
 {
    assert(src->ssa);
    assert(nir_src_is_if(src) ? (nir_src_parent_if(src) != NULL) : (nir_src_parent_instr(src) != NULL));
+   nir_src_mark_changed(src);
    list_del(&src->use_link);
    src->ssa = new_ssa;
    list_addtail(&src->use_link, &new_ssa->uses);
@@ -5040,6 +5174,35 @@ should_print_nir(UNUSED nir_shader *shader)
 }
 #endif /* NDEBUG */
 
+/* Per-pass timing, see nir_pass_stats.c.  Only costs a branch per pass
+ * unless NIR_PASS_STATS is set.
+ */
+extern bool nir_pass_stats_enabled;
+
+void nir_pass_stats_init(void);
+int64_t _nir_pass_stats_now(void);
+void _nir_pass_stats_record(const char *name, int64_t start_ns, int progress);
+
+static inline int64_t
+nir_pass_stats_begin(void)
+{
+   return unlikely(nir_pass_stats_enabled) ? _nir_pass_stats_now() : 0;
+}
+
+static inline void
+nir_pass_stats_end(const char *name, int64_t start_ns, int progress)
+{
+   if (unlikely(start_ns))
+      _nir_pass_stats_record(name, start_ns, progress);
+}
+
+#define _PASS_VALIDATE(nir, pass)                                    \
+   do {                                                              \
+      int64_t _validate_start = nir_pass_stats_begin();              \
+      nir_validate_shader(nir, "after " #pass " in " __FILE__);      \
+      nir_pass_stats_end("nir_validate_shader", _validate_start, -1);\
+   } while (0)
+
 #define _PASS(pass, nir, do_pass)                                       \
    do {                                                                 \
       if (should_skip_nir(#pass)) {                                     \
@@ -5060,8 +5223,11 @@ should_print_nir(UNUSED nir_shader *shader)
    nir_metadata_set_validation_flag(nir);                       \
    if (should_print_nir(nir))                                   \
       printf("%s\n", #pass);                                    \
-   if (pass(nir, ##__VA_ARGS__)) {                              \
-      nir_validate_shader(nir, "after " #pass " in " __FILE__); \
+   int64_t _pass_start = nir_pass_stats_begin();                \
+   bool _pass_progress = pass(nir, ##__VA_ARGS__);              \
+   nir_pass_stats_end(#pass, _pass_start, _pass_progress);      \
+   if (_pass_progress) {                                        \
+      _PASS_VALIDATE(nir, pass);                                \
       UNUSED bool _;                                            \
       progress = true;                                          \
       if (should_print_nir(nir))                                \
@@ -5073,8 +5239,10 @@ should_print_nir(UNUSED nir_shader *shader)
 #define NIR_PASS_V(nir, pass, ...) _PASS(pass, nir, {        \
    if (should_print_nir(nir))                                \
       printf("%s\n", #pass);                                 \
+   int64_t _pass_start = nir_pass_stats_begin();             \
    pass(nir, ##__VA_ARGS__);                                 \
-   nir_validate_shader(nir, "after " #pass " in " __FILE__); \
+   nir_pass_stats_end(#pass, _pass_start, -1);               \
+   _PASS_VALIDATE(nir, pass);                                \
    if (should_print_nir(nir))                                \
       nir_print_shader(nir, stdout);                         \
 })
@@ -5124,6 +5292,67 @@ do {                                                                 \
 #define NIR_LOOP_PASS_NOT_IDEMPOTENT(progress, skip, nir, pass, ...) \
    _NIR_LOOP_PASS(progress, false, skip, nir, pass, ##__VA_ARGS__)
 
+/* Tracks which passes of an optimization loop can be skipped or restricted to
+ * the impls that changed since they last ran.
+ *
+ * This is a finer grained NIR_LOOP_PASS: instead of forgetting about every
+ * pass whenever any pass makes progress, it remembers the value of
+ * nir_shader::change_seq after each pass ran.  A pass is skipped entirely if
+ * no impl changed since then, and passes iterating with
+ * nir_foreach_dirty_function_impl only visit the impls which did change.
+ *
+ * Example:
+ * bool progress = true;
+ * nir_pass_tracker tracker;
+ * nir_pass_tracker_init(&tracker);
+ * while (progress) {
+ *    progress = false;
+ *    NIR_TRACKED_PASS(progress, &tracker, nir, pass1);
+ *    NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, nir, nir_opt_algebraic);
+ *    ...
+ * }
+ * nir_pass_tracker_fini(&tracker);
+ *
+ * As with NIR_LOOP_PASS, two passes are considered the same if they have the
+ * same function pointer, so a pass shouldn't be run with different options
+ * through the same tracker.  Changes made to the shader outside of NIR passes
+ * must be followed by nir_shader_mark_changed().
+ */
+typedef struct nir_pass_tracker {
+   /* pass function -> nir_shader::change_seq after the pass last ran */
+   struct hash_table *last_run;
+
+   uint64_t seq_before_pass;
+} nir_pass_tracker;
+
+void nir_pass_tracker_init(nir_pass_tracker *tracker);
+void nir_pass_tracker_fini(nir_pass_tracker *tracker);
+bool nir_pass_tracker_begin(nir_pass_tracker *tracker, nir_shader *shader,
+                            void (*pass)());
+void nir_pass_tracker_end(nir_pass_tracker *tracker, nir_shader *shader,
+                          void (*pass)(), bool idempotent, bool progress);
+
+#define _NIR_TRACKED_PASS(progress, idempotent, tracker, nir, pass, ...)      \
+do {                                                                          \
+   if (nir_pass_tracker_begin(tracker, nir, (void (*)())&pass)) {             \
+      bool nir_tracked_pass_progress = false;                                 \
+      NIR_PASS(nir_tracked_pass_progress, nir, pass, ##__VA_ARGS__);          \
+      nir_pass_tracker_end(tracker, nir, (void (*)())&pass, idempotent,       \
+                           nir_tracked_pass_progress);                        \
+      UNUSED bool _ = false;                                                  \
+      progress |= nir_tracked_pass_progress;                                  \
+   }                                                                          \
+} while (0)
+
+#define NIR_TRACKED_PASS(progress, tracker, nir, pass, ...) \
+   _NIR_TRACKED_PASS(progress, true, tracker, nir, pass, ##__VA_ARGS__)
+
+/* Like NIR_TRACKED_PASS, but use this for passes which may make further
+ * progress when repeated.
+ */
+#define NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, tracker, nir, pass, ...) \
+   _NIR_TRACKED_PASS(progress, false, tracker, nir, pass, ##__VA_ARGS__)
+
 #define NIR_SKIP(name) should_skip_nir(#name)
 
 /** An instruction filtering callback with writemask
@@ -5240,6 +5469,13 @@ void nir_cleanup_functions(nir_shader *shader);
 bool nir_link_shader_functions(nir_shader *shader,
                                const nir_shader *link_shader);
 
+struct util_queue;
+typedef bool (*nir_function_opt_cb)(nir_shader *shader, void *data);
+bool nir_shader_optimize_functions_parallel(nir_shader *shader,
+                                            struct util_queue *queue,
+                                            nir_function_opt_cb opt,
+                                            void *data);
+
 void nir_find_inlinable_uniforms(nir_shader *shader);
 void nir_inline_uniforms(nir_shader *shader, unsigned num_uniforms,
                          const uint32_t *uniform_values,
@@ -5337,6 +5573,8 @@ nir_opt_varyings_progress
 nir_opt_varyings(nir_shader *producer, nir_shader *consumer, bool spirv,
                  unsigned max_uniform_components, unsigned max_ubos_per_stage);
 
+unsigned nir_varying_bytes_per_vertex(nir_shader *producer);
+
 bool nir_slot_is_sysval_output(gl_varying_slot slot,
                                gl_shader_stage next_shader);
 bool nir_slot_is_varying(gl_varying_slot slot);
@@ -6375,6 +6613,8 @@ bool nir_normalize_cubemap_coords(nir_shader *shader);
 bool nir_shader_supports_implicit_lod(nir_shader *shader);
 
 void nir_live_defs_impl(nir_function_impl *impl);
+void nir_live_defs_update_impl(nir_function_impl *impl,
+                               const struct set *changed_blocks);
 
 const BITSET_WORD *nir_get_live_defs(nir_cursor cursor, void *mem_ctx);
 
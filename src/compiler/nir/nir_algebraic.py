@@ -1186,7 +1186,7 @@ ${pass_name}(
    condition_flags[${index}] = ${condition};
    % endfor
 
-   nir_foreach_function_impl(impl, shader) {
+   nir_foreach_dirty_function_impl(impl, shader) {
      progress |= nir_algebraic_impl(impl, condition_flags, &${pass_name}_table);
    }
 
@@ -0,0 +1,271 @@
+/*
+ * Copyright © 2024 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * A simple executable that times the NIR optimization loop over a corpus of
+ * shaders serialized with nir_serialize(), one shader per file.  Arguments
+ * are files or directories, directories are read (non-recursively) in
+ * sorted order.
+ *
+ * For every shader the deserialization and optimization times are printed,
+ * the best of all iterations.  With -p the NIR_PASS_STATS table of all
+ * passes run on the corpus is printed at exit as well.
+ */
+
+#include "nir.h"
+#include "nir_serialize.h"
+#include "util/blob.h"
+#include "util/os_file.h"
+#include "util/os_time.h"
+#include "util/u_dynarray.h"
+
+#include <dirent.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static void
+print_usage(char *exec_name, FILE *f)
+{
+   fprintf(f,
+"Usage: %s [options] file-or-directory...\n"
+"Options:\n"
+"  -h  --help              Print this help.\n"
+"  -n, --iterations <n>    Compile every shader <n> times (default 1).\n"
+"  -p, --pass-stats        Print the time spent in every NIR pass at exit.\n"
+"  -s, --summary           Only print the totals, not every shader.\n",
+   exec_name);
+}
+
+static void
+optimize(nir_shader *nir)
+{
+   bool progress;
+   do {
+      progress = false;
+
+      NIR_PASS(progress, nir, nir_lower_vars_to_ssa);
+      NIR_PASS(progress, nir, nir_copy_prop);
+      NIR_PASS(progress, nir, nir_opt_remove_phis);
+      NIR_PASS(progress, nir, nir_opt_dce);
+      NIR_PASS(progress, nir, nir_opt_dead_cf);
+      NIR_PASS(progress, nir, nir_opt_cse);
+      NIR_PASS(progress, nir, nir_opt_deref);
+      NIR_PASS(progress, nir, nir_opt_copy_prop_vars);
+      NIR_PASS(progress, nir, nir_opt_dead_write_vars);
+      NIR_PASS(progress, nir, nir_opt_peephole_select, 8, true, true);
+      NIR_PASS(progress, nir, nir_opt_algebraic);
+      NIR_PASS(progress, nir, nir_opt_constant_folding);
+      NIR_PASS(progress, nir, nir_opt_if, 0);
+      NIR_PASS(progress, nir, nir_opt_loop_unroll);
+      NIR_PASS(progress, nir, nir_opt_undef);
+   } while (progress);
+
+   NIR_PASS(_, nir, nir_remove_dead_variables, nir_var_function_temp, NULL);
+   NIR_PASS(_, nir, nir_opt_dce);
+}
+
+static unsigned
+count_instrs(nir_shader *nir)
+{
+   unsigned count = 0;
+
+   nir_foreach_function_impl(impl, nir) {
+      nir_foreach_block(block, impl) {
+         nir_foreach_instr(instr, block)
+            count++;
+      }
+   }
+
+   return count;
+}
+
+static int
+compare_paths(const void *_a, const void *_b)
+{
+   return strcmp(*(const char **)_a, *(const char **)_b);
+}
+
+static void
+add_path(void *mem_ctx, struct util_dynarray *paths, const char *path)
+{
+   struct stat st;
+   if (stat(path, &st)) {
+      fprintf(stderr, "Failed to stat %s\n", path);
+      exit(1);
+   }
+
+   if (!S_ISDIR(st.st_mode)) {
+      util_dynarray_append(paths, char *, ralloc_strdup(mem_ctx, path));
+      return;
+   }
+
+   DIR *dir = opendir(path);
+   if (!dir) {
+      fprintf(stderr, "Failed to open directory %s\n", path);
+      exit(1);
+   }
+
+   unsigned first = util_dynarray_num_elements(paths, char *);
+   struct dirent *entry;
+   while ((entry = readdir(dir))) {
+      if (entry->d_name[0] == '.')
+         continue;
+
+      char *file = ralloc_asprintf(mem_ctx, "%s/%s", path, entry->d_name);
+      if (stat(file, &st) || !S_ISREG(st.st_mode))
+         continue;
+
+      util_dynarray_append(paths, char *, file);
+   }
+   closedir(dir);
+
+   char **files = util_dynarray_element(paths, char *, first);
+   qsort(files, util_dynarray_num_elements(paths, char *) - first,
+         sizeof(char *), compare_paths);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned iterations = 1;
+   bool pass_stats = false;
+   bool summary = false;
+   int ch;
+
+   static struct option long_options[] = {
+      {"help",       no_argument,       0, 'h'},
+      {"iterations", required_argument, 0, 'n'},
+      {"pass-stats", no_argument,       0, 'p'},
+      {"summary",    no_argument,       0, 's'},
+      {0, 0, 0, 0}
+   };
+
+   while ((ch = getopt_long(argc, argv, "hn:ps", long_options, NULL)) != -1) {
+      switch (ch) {
+      case 'h':
+         print_usage(argv[0], stdout);
+         return 0;
+      case 'n':
+         iterations = atoi(optarg);
+         if (iterations < 1) {
+            fprintf(stderr, "Invalid iteration count: %s\n", optarg);
+            return 1;
+         }
+         break;
+      case 'p':
+         pass_stats = true;
+         break;
+      case 's':
+         summary = true;
+         break;
+      default:
+         fprintf(stderr, "Unrecognized option \"%s\".\n", optarg);
+         print_usage(argv[0], stderr);
+         return 1;
+      }
+   }
+
+   if (optind >= argc) {
+      print_usage(argv[0], stderr);
+      return 1;
+   }
+
+   /* Must happen before the first nir_shader_create(), which reads it. */
+   if (pass_stats)
+      setenv("NIR_PASS_STATS", "true", 1);
+
+   void *mem_ctx = ralloc_context(NULL);
+
+   struct util_dynarray paths;
+   util_dynarray_init(&paths, mem_ctx);
+   for (int i = optind; i < argc; i++)
+      add_path(mem_ctx, &paths, argv[i]);
+
+   glsl_type_singleton_init_or_ref();
+
+   /* The options aren't part of the serialized shader.  The generic ones
+    * are good enough to exercise the common passes.
+    */
+   const struct nir_shader_compiler_options nir_opts = {0};
+
+   if (!summary) {
+      printf("%-48s %5s %8s %8s %12s %12s\n", "shader", "stage",
+             "instrs", "opt", "deser (us)", "opt (us)");
+   }
+
+   unsigned num_shaders = 0;
+   int64_t total_deser_ns = 0, total_opt_ns = 0;
+
+   util_dynarray_foreach(&paths, char *, path) {
+      size_t size;
+      char *data = os_read_file(*path, &size);
+      if (!data) {
+         fprintf(stderr, "Failed to read %s\n", *path);
+         continue;
+      }
+
+      int64_t best_deser_ns = INT64_MAX, best_opt_ns = INT64_MAX;
+      unsigned instrs = 0, opt_instrs = 0;
+      gl_shader_stage stage = MESA_SHADER_NONE;
+      bool valid = true;
+
+      for (unsigned i = 0; i < iterations; i++) {
+         void *shader_ctx = ralloc_context(NULL);
+         struct blob_reader reader;
+         blob_reader_init(&reader, data, size);
+
+         int64_t start = os_time_get_nano();
+         nir_shader *nir = nir_deserialize(shader_ctx, &nir_opts, &reader);
+         int64_t deser_end = os_time_get_nano();
+
+         if (reader.overrun) {
+            valid = false;
+            ralloc_free(shader_ctx);
+            break;
+         }
+
+         stage = nir->info.stage;
+         instrs = count_instrs(nir);
+
+         int64_t opt_start = os_time_get_nano();
+         optimize(nir);
+         int64_t end = os_time_get_nano();
+
+         opt_instrs = count_instrs(nir);
+         best_deser_ns = MIN2(best_deser_ns, deser_end - start);
+         best_opt_ns = MIN2(best_opt_ns, end - opt_start);
+
+         ralloc_free(shader_ctx);
+      }
+
+      free(data);
+
+      if (!valid) {
+         fprintf(stderr, "%s is not a serialized NIR shader\n", *path);
+         continue;
+      }
+
+      if (!summary) {
+         printf("%-48s %5s %8u %8u %12.1f %12.1f\n", *path,
+                _mesa_shader_stage_to_abbrev(stage), instrs, opt_instrs,
+                best_deser_ns / 1e3, best_opt_ns / 1e3);
+      }
+
+      num_shaders++;
+      total_deser_ns += best_deser_ns;
+      total_opt_ns += best_opt_ns;
+   }
+
+   printf("%u shaders, deserialize %.3f ms, optimize %.3f ms\n",
+          num_shaders, total_deser_ns / 1e6, total_opt_ns / 1e6);
+
+   glsl_type_singleton_decref();
+   ralloc_free(mem_ctx);
+
+   return num_shaders ? 0 : 1;
+}
@@ -752,6 +752,7 @@ nir_shader_clone(void *mem_ctx, const nir_shader *s)
    ns->num_uniforms = s->num_uniforms;
    ns->num_outputs = s->num_outputs;
    ns->scratch_size = s->scratch_size;
+   ns->budget = s->budget;
 
    ns->constant_data_size = s->constant_data_size;
    if (s->constant_data_size > 0) {
@@ -793,8 +794,15 @@ nir_shader_replace(nir_shader *dst, nir_shader *src)
    /* Re-parent all of src's ralloc children to dst */
    ralloc_adopt(dst, src);
 
+   /* Keep dst's change counter so change_seq values remembered by a
+    * nir_pass_tracker stay meaningful.
+    */
+   uint64_t change_seq = dst->change_seq;
+
    memcpy(dst, src, sizeof(*dst));
 
+   dst->change_seq = change_seq;
+
    /* We have to move all the linked lists over separately because we need the
     * pointers in the list elements to point to the lists in dst and not src.
     */
@@ -805,5 +813,7 @@ nir_shader_replace(nir_shader *dst, nir_shader *src)
    nir_foreach_function(function, dst)
       function->shader = dst;
 
+   nir_shader_mark_changed(dst);
+
    ralloc_free(src);
 }
@@ -45,10 +45,35 @@
  */
 /*@{*/
 
+/* CF nodes are allocated from the shader's gc_ctx, which is itself ralloc'd
+ * against the shader.
+ */
+static inline nir_shader *
+cf_node_get_shader(nir_cf_node *node)
+{
+   return ralloc_parent(gc_get_context(node));
+}
+
+/* Bumps the CFG stamp of the impl containing the block, if any.  Blocks in
+ * an extracted nir_cf_list have no impl; their edges get stamped again once
+ * they are reinserted.
+ */
+static void
+block_mark_cfg_changed(nir_block *block)
+{
+   nir_cf_node *node = &block->cf_node;
+   while (node->parent != NULL)
+      node = node->parent;
+
+   if (node->type == nir_cf_node_function)
+      nir_cf_node_as_function(node)->cfg_change_seq++;
+}
+
 static inline void
 block_add_pred(nir_block *block, nir_block *pred)
 {
    _mesa_set_add(block->predecessors, pred);
+   block_mark_cfg_changed(block);
 }
 
 static inline void
@@ -59,6 +84,7 @@ block_remove_pred(nir_block *block, nir_block *pred)
    assert(entry);
 
    _mesa_set_remove(block->predecessors, entry);
+   block_mark_cfg_changed(block);
 }
 
 static void
@@ -184,7 +210,7 @@ replace_successor(nir_block *block, nir_block *old_succ, nir_block *new_succ)
 static nir_block *
 split_block_beginning(nir_block *block)
 {
-   nir_block *new_block = nir_block_create(ralloc_parent(block));
+   nir_block *new_block = nir_block_create(cf_node_get_shader(&block->cf_node));
    new_block->cf_node.parent = block->cf_node.parent;
    exec_node_insert_node_before(&block->cf_node.node, &new_block->cf_node.node);
 
@@ -316,7 +342,7 @@ block_add_normal_succs(nir_block *block)
 static nir_block *
 split_block_end(nir_block *block)
 {
-   nir_block *new_block = nir_block_create(ralloc_parent(block));
+   nir_block *new_block = nir_block_create(cf_node_get_shader(&block->cf_node));
    new_block->cf_node.parent = block->cf_node.parent;
    exec_node_insert_after(&block->cf_node.node, &new_block->cf_node.node);
 
@@ -431,7 +457,7 @@ nir_loop_add_continue_construct(nir_loop *loop)
 {
    assert(!nir_loop_has_continue_construct(loop));
 
-   nir_block *cont = nir_block_create(ralloc_parent(loop));
+   nir_block *cont = nir_block_create(cf_node_get_shader(&loop->cf_node));
    exec_list_push_tail(&loop->continue_list, &cont->cf_node.node);
    cont->cf_node.parent = &loop->cf_node;
 
@@ -945,6 +971,8 @@ nir_sort_unstructured_blocks(nir_function_impl *impl)
 
    ralloc_free(blocks);
 
+   impl->cfg_change_seq++;
+
    /* Dominance is toast but we indexed blocks as part of this pass. */
    impl->valid_metadata &= nir_metadata_dominance;
    impl->valid_metadata |= nir_metadata_block_index;
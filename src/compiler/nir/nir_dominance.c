@@ -46,7 +46,10 @@ init_block(nir_block *block, nir_function_impl *impl)
    block->dom_pre_index = UINT32_MAX;
    block->dom_post_index = 0;
 
-   _mesa_set_clear(block->dom_frontier, NULL);
+   if (block->dom_frontier)
+      _mesa_set_clear(block->dom_frontier, NULL);
+   else
+      block->dom_frontier = _mesa_pointer_set_create(ralloc_parent(impl));
 
    return true;
 }
@@ -169,6 +172,13 @@ nir_calc_dominance_impl(nir_function_impl *impl)
 
    nir_metadata_require(impl, nir_metadata_block_index);
 
+   /* Passes which don't touch control flow commonly drop dominance along
+    * with everything else.  The per-block dominance data is still accurate
+    * in that case, so only recompute it if the CFG actually changed.
+    */
+   if (impl->dominance_cfg_seq == impl->cfg_change_seq)
+      return;
+
    nir_foreach_block_unstructured(block, impl) {
       init_block(block, impl);
    }
@@ -193,6 +203,8 @@ nir_calc_dominance_impl(nir_function_impl *impl)
 
    uint32_t dfs_index = 1;
    calc_dfs_indicies(start_block, &dfs_index);
+
+   impl->dominance_cfg_seq = impl->cfg_change_seq;
 }
 
 void
@@ -25,6 +25,7 @@
 #include "nir_builder.h"
 #include "nir_control_flow.h"
 #include "nir_vla.h"
+#include "util/u_queue.h"
 
 /*
  * TODO: write a proper inliner for GPUs.
@@ -147,6 +148,15 @@ nir_inline_function_impl(struct nir_builder *b,
 
 static bool inline_function_impl(nir_function_impl *impl, struct set *inlined);
 
+static unsigned
+impl_num_instrs(nir_function_impl *impl)
+{
+   unsigned num_instrs = 0;
+   nir_foreach_block(block, impl)
+      num_instrs += exec_list_length(&block->instr_list);
+   return num_instrs;
+}
+
 static bool inline_functions_pass(nir_builder *b,
                                   nir_instr *instr,
                                   void *cb_data)
@@ -158,17 +168,27 @@ static bool inline_functions_pass(nir_builder *b,
    nir_call_instr *call = nir_instr_as_call(instr);
    assert(call->callee->impl);
 
+   /* Calls can only be kept if the driver supports them */
+   bool can_keep_call = false;
    if (b->shader->options->driver_functions &&
        b->shader->info.stage == MESA_SHADER_KERNEL) {
       bool last_instr = (instr == nir_block_last_instr(instr->block));
       if (!nir_function_can_inline(call->callee) && !last_instr) {
          return false;
       }
+      can_keep_call = !last_instr;
    }
 
    /* Make sure that the function we're calling is already inlined */
    inline_function_impl(call->callee->impl, inlined);
 
+   if (can_keep_call &&
+       !nir_shader_budget_consume(b->shader,
+                                  impl_num_instrs(call->callee->impl))) {
+      b->shader->info.budget_skipped_inlines++;
+      return false;
+   }
+
    b->cursor = nir_instr_remove(&call->instr);
 
    /* Rewrite all of the uses of the callee's parameters to use the call
@@ -277,6 +297,8 @@ nir_inline_functions(nir_shader *shader)
    struct set *inlined = _mesa_pointer_set_create(NULL);
    bool progress = false;
 
+   nir_shader_budget_update(shader);
+
    nir_foreach_function_impl(impl, shader) {
       progress = inline_function_impl(impl, inlined) || progress;
    }
@@ -507,3 +529,146 @@ nir_cleanup_functions(nir_shader *nir)
    }
    _mesa_set_destroy(used_funcs, NULL);
 }
+
+/* Points the global variable derefs in impl at the variables in var_remap,
+ * cloning any variable which is not in the map yet into impl's shader.  If
+ * reverse_remap is not NULL, the new clones are also mapped back there.
+ */
+static void
+remap_impl_global_vars(nir_function_impl *impl, struct hash_table *var_remap,
+                       struct hash_table *reverse_remap)
+{
+   nir_shader *shader = impl->function->shader;
+
+   nir_foreach_block(block, impl) {
+      nir_foreach_instr(instr, block) {
+         if (instr->type != nir_instr_type_deref)
+            continue;
+
+         nir_deref_instr *deref = nir_instr_as_deref(instr);
+         if (deref->deref_type != nir_deref_type_var ||
+             deref->var->data.mode == nir_var_function_temp)
+            continue;
+
+         struct hash_entry *entry =
+            _mesa_hash_table_search(var_remap, deref->var);
+         if (entry == NULL) {
+            nir_variable *nvar = nir_variable_clone(deref->var, shader);
+            nir_shader_add_variable(shader, nvar);
+            entry = _mesa_hash_table_insert(var_remap, deref->var, nvar);
+            if (reverse_remap)
+               _mesa_hash_table_insert(reverse_remap, nvar, deref->var);
+         }
+         deref->var = entry->data;
+      }
+   }
+}
+
+struct function_opt_job {
+   struct util_queue_fence fence;
+
+   const nir_shader *shader;
+   nir_function *func;
+   nir_function_opt_cb opt;
+   void *data;
+
+   /* Private shader holding the copy of func which the job optimizes */
+   nir_shader *scratch;
+   nir_function *scratch_func;
+
+   /* Maps the scratch copies of global variables back to the originals */
+   struct hash_table *var_remap;
+
+   bool progress;
+};
+
+static void
+optimize_function_job(void *_job, void *gdata, int thread_index)
+{
+   struct function_opt_job *job = _job;
+   const nir_shader *shader = job->shader;
+
+   /* Everything the passes allocate has to come from memory owned by this
+    * job, so work on a copy of the function in a shader of its own.  The
+    * original shader is only read while the jobs run.
+    */
+   nir_shader *scratch = nir_shader_create(NULL, shader->info.stage,
+                                           shader->options, NULL);
+   scratch->info = shader->info;
+
+   nir_function *func = nir_function_clone(scratch, job->func);
+   nir_function_set_impl(func, nir_function_impl_clone(scratch, job->func->impl));
+
+   struct hash_table *to_scratch = _mesa_pointer_hash_table_create(NULL);
+   job->var_remap = _mesa_pointer_hash_table_create(scratch);
+   remap_impl_global_vars(func->impl, to_scratch, job->var_remap);
+   _mesa_hash_table_destroy(to_scratch, NULL);
+
+   job->scratch = scratch;
+   job->scratch_func = func;
+   job->progress = job->opt(scratch, job->data);
+}
+
+/**
+ * Runs opt on every function impl of the shader in parallel on the given
+ * queue, which is useful for large OpenCL programs before inlining.
+ *
+ * Each invocation of opt gets a private shader containing a copy of a single
+ * function and its global variables, so it must only run passes which are
+ * local to a function impl (nir_opt_dce, nir_opt_cse, nir_copy_prop,
+ * nir_opt_algebraic, ...).  Calls still point to the functions of the
+ * original shader, which opt must not modify.  Functions which made progress
+ * are copied back.
+ *
+ * If queue is NULL or the shader has a single impl, opt is simply run on the
+ * whole shader.
+ */
+bool
+nir_shader_optimize_functions_parallel(nir_shader *shader,
+                                       struct util_queue *queue,
+                                       nir_function_opt_cb opt, void *data)
+{
+   unsigned num_impls = 0;
+   nir_foreach_function_impl(impl, shader)
+      num_impls++;
+
+   if (queue == NULL || num_impls < 2)
+      return opt(shader, data);
+
+   struct function_opt_job *jobs = calloc(num_impls, sizeof(*jobs));
+   unsigned num_jobs = 0;
+
+   nir_foreach_function_with_impl(func, impl, shader) {
+      struct function_opt_job *job = &jobs[num_jobs++];
+      job->shader = shader;
+      job->func = func;
+      job->opt = opt;
+      job->data = data;
+
+      util_queue_fence_init(&job->fence);
+      util_queue_add_job(queue, job, &job->fence, optimize_function_job,
+                         NULL, 0);
+   }
+
+   bool progress = false;
+   for (unsigned i = 0; i < num_jobs; i++) {
+      struct function_opt_job *job = &jobs[i];
+
+      util_queue_fence_wait(&job->fence);
+      util_queue_fence_destroy(&job->fence);
+
+      if (job->progress) {
+         nir_function_impl *impl =
+            nir_function_impl_clone(shader, job->scratch_func->impl);
+         nir_function_set_impl(job->func, impl);
+         remap_impl_global_vars(impl, job->var_remap, NULL);
+         progress = true;
+      }
+
+      ralloc_free(job->scratch);
+   }
+
+   free(jobs);
+
+   return progress;
+}
@@ -739,7 +739,15 @@ cmp_func(const void *data1, const void *data2)
 struct set *
 nir_instr_set_create(void *mem_ctx)
 {
-   return _mesa_set_create(mem_ctx, hash_instr, cmp_func);
+   struct set *instr_set = _mesa_set_create(mem_ctx, hash_instr, cmp_func);
+
+   /* CSE sets get as big as the whole shader and most lookups miss, which
+    * group probing handles without touching the entries.
+    */
+   if (instr_set)
+      _mesa_set_enable_group_probing(instr_set);
+
+   return instr_set;
 }
 
 void
@@ -42,6 +42,9 @@
 struct live_defs_state {
    unsigned bitset_words;
 
+   /* Owner of the per-block live_in and live_out sets */
+   void *mem_ctx;
+
    /* Used in propagate_across_edge() */
    BITSET_WORD *tmp_live;
 
@@ -55,11 +58,11 @@ static void
 init_liveness_block(nir_block *block,
                     struct live_defs_state *state)
 {
-   block->live_in = reralloc(block, block->live_in, BITSET_WORD,
+   block->live_in = reralloc(state->mem_ctx, block->live_in, BITSET_WORD,
                              state->bitset_words);
    memset(block->live_in, 0, state->bitset_words * sizeof(BITSET_WORD));
 
-   block->live_out = reralloc(block, block->live_out, BITSET_WORD,
+   block->live_out = reralloc(state->mem_ctx, block->live_out, BITSET_WORD,
                               state->bitset_words);
    memset(block->live_out, 0, state->bitset_words * sizeof(BITSET_WORD));
 
@@ -131,13 +134,15 @@ nir_live_defs_impl(nir_function_impl *impl)
 {
    struct live_defs_state state = {
       .bitset_words = BITSET_WORDS(impl->ssa_alloc),
+      .mem_ctx = ralloc_parent(impl),
    };
    state.tmp_live = rzalloc_array(impl, BITSET_WORD, state.bitset_words),
 
    /* Number the instructions so we can do cheap interference tests using the
-    * instruction index.
+    * instruction index.  The worklist is indexed by block.
     */
-      nir_metadata_require(impl, nir_metadata_instr_index);
+   nir_metadata_require(impl, nir_metadata_block_index |
+                                 nir_metadata_instr_index);
 
    nir_block_worklist_init(&state.worklist, impl->num_blocks, NULL);
 
@@ -194,6 +199,209 @@ nir_live_defs_impl(nir_function_impl *impl)
 
    ralloc_free(state.tmp_live);
    nir_block_worklist_fini(&state.worklist);
+
+   impl->live_defs_cfg_seq = impl->cfg_change_seq;
+   impl->live_defs_ssa_alloc = impl->ssa_alloc;
+}
+
+static bool
+record_def(nir_def *def, void *void_defs)
+{
+   nir_def **defs = void_defs;
+
+   defs[def->index] = def;
+
+   return true;
+}
+
+static bool
+record_def_changed(nir_def *def, void *void_changed)
+{
+   BITSET_SET((BITSET_WORD *)void_changed, def->index);
+
+   return true;
+}
+
+static bool
+record_src_changed(nir_src *src, void *void_changed)
+{
+   BITSET_SET((BITSET_WORD *)void_changed, src->ssa->index);
+
+   return true;
+}
+
+/* Adds def to the live-in of block and queues the live-out of the block's
+ * predecessors.  The def is never live-in to its own block unless it's a phi
+ * and never live across the edges into it.
+ */
+static void
+mark_def_live_in(nir_def *def, nir_block *block, nir_block_worklist *worklist)
+{
+   if (BITSET_TEST(block->live_in, def->index))
+      return;
+
+   BITSET_SET(block->live_in, def->index);
+
+   if (block == def->parent_instr->block)
+      return;
+
+   set_foreach(block->predecessors, entry) {
+      nir_block *pred = (nir_block *)entry->key;
+      if (!BITSET_TEST(pred->live_out, def->index))
+         nir_block_worklist_push_tail(worklist, pred);
+   }
+}
+
+/* Recomputes the live range of a single def by walking backwards from each
+ * of its uses until we hit the definition.
+ */
+static void
+compute_def_live_range(nir_def *def, nir_block_worklist *worklist)
+{
+   nir_block *def_block = def->parent_instr->block;
+   const bool is_phi = def->parent_instr->type == nir_instr_type_phi;
+
+   nir_foreach_use_including_if(src, def) {
+      nir_block *use_block;
+      if (nir_src_is_if(src)) {
+         nir_if *nif = nir_src_parent_if(src);
+         use_block = nir_cf_node_as_block(nir_cf_node_prev(&nif->cf_node));
+      } else if (nir_src_parent_instr(src)->type == nir_instr_type_phi) {
+         /* Phi sources are live-out of the corresponding predecessor */
+         nir_block *pred = exec_node_data(nir_phi_src, src, src)->pred;
+         nir_block_worklist_push_tail(worklist, pred);
+         continue;
+      } else {
+         use_block = nir_src_parent_instr(src)->block;
+      }
+
+      /* Non-phi defs are always defined before their uses in the same block */
+      if (use_block == def_block && !is_phi)
+         continue;
+
+      mark_def_live_in(def, use_block, worklist);
+   }
+
+   while (!nir_block_worklist_is_empty(worklist)) {
+      nir_block *block = nir_block_worklist_pop_head(worklist);
+
+      if (BITSET_TEST(block->live_out, def->index))
+         continue;
+
+      BITSET_SET(block->live_out, def->index);
+
+      if (block != def_block || is_phi)
+         mark_def_live_in(def, block, worklist);
+   }
+}
+
+/** Update live_in and live_out after local changes to some blocks
+ *
+ * This is meant for passes which only rewrite instructions in a few blocks,
+ * leaving the CFG alone.  Instead of dropping nir_metadata_live_defs and
+ * recomputing liveness from scratch, they can collect the blocks in which
+ * they added, removed or rewrote instructions (including phis and if
+ * conditions, which belong to the block preceding the if) and call this
+ * before preserving nir_metadata_live_defs.  Only the live ranges of defs
+ * defined, used or live in those blocks are recomputed.
+ *
+ * If the CFG changed or the defs were re-indexed since liveness was last
+ * computed, this falls back to a full nir_live_defs_impl().
+ */
+void
+nir_live_defs_update_impl(nir_function_impl *impl,
+                          const struct set *changed_blocks)
+{
+   if (impl->valid_metadata & nir_metadata_live_defs)
+      return;
+
+   if (impl->live_defs_cfg_seq == 0 ||
+       impl->live_defs_cfg_seq != impl->cfg_change_seq ||
+       impl->live_defs_ssa_alloc > impl->ssa_alloc) {
+      nir_metadata_require(impl, nir_metadata_live_defs);
+      return;
+   }
+
+   nir_metadata_require(impl, nir_metadata_block_index |
+                                 nir_metadata_instr_index);
+
+   const unsigned old_words = BITSET_WORDS(impl->live_defs_ssa_alloc);
+   const unsigned bitset_words = BITSET_WORDS(impl->ssa_alloc);
+   void *mem_ctx = ralloc_parent(impl);
+
+   if (bitset_words > old_words) {
+      const size_t tail_size = (bitset_words - old_words) * sizeof(BITSET_WORD);
+      nir_foreach_block(block, impl) {
+         block->live_in = reralloc(mem_ctx, block->live_in, BITSET_WORD,
+                                   bitset_words);
+         memset(block->live_in + old_words, 0, tail_size);
+
+         block->live_out = reralloc(mem_ctx, block->live_out, BITSET_WORD,
+                                    bitset_words);
+         memset(block->live_out + old_words, 0, tail_size);
+      }
+   }
+
+   void *lin_ctx = ralloc_context(NULL);
+   BITSET_WORD *changed = rzalloc_array(lin_ctx, BITSET_WORD, bitset_words);
+   nir_def **defs = rzalloc_array(lin_ctx, nir_def *, impl->ssa_alloc);
+
+   /* Everything which was live in, live out of or referenced by one of the
+    * changed blocks may have a different live range now.  Anything else
+    * never reached a use in those blocks, so it's unaffected.  Sources of
+    * phis which were removed are only live-out of the predecessor, so we
+    * have to look at those too.
+    */
+   set_foreach(changed_blocks, entry) {
+      nir_block *block = (nir_block *)entry->key;
+
+      for (unsigned i = 0; i < old_words; i++)
+         changed[i] |= block->live_in[i] | block->live_out[i];
+
+      set_foreach(block->predecessors, pred_entry) {
+         const nir_block *pred = pred_entry->key;
+         for (unsigned i = 0; i < old_words; i++)
+            changed[i] |= pred->live_out[i];
+      }
+
+      nir_foreach_instr(instr, block) {
+         nir_foreach_def(instr, record_def_changed, changed);
+         nir_foreach_src(instr, record_src_changed, changed);
+      }
+
+      nir_if *following_if = nir_block_get_following_if(block);
+      if (following_if)
+         record_src_changed(&following_if->condition, changed);
+   }
+
+   nir_foreach_block(block, impl) {
+      for (unsigned i = 0; i < bitset_words; i++) {
+         block->live_in[i] &= ~changed[i];
+         block->live_out[i] &= ~changed[i];
+      }
+
+      nir_foreach_instr(instr, block)
+         nir_foreach_def(instr, record_def, defs);
+   }
+
+   nir_block_worklist worklist;
+   nir_block_worklist_init(&worklist, impl->num_blocks, lin_ctx);
+
+   unsigned i;
+   BITSET_FOREACH_SET(i, changed, impl->ssa_alloc) {
+      /* Defs which were removed or are undefined are never live */
+      if (defs[i] == NULL ||
+          defs[i]->parent_instr->type == nir_instr_type_undef)
+         continue;
+
+      compute_def_live_range(defs[i], &worklist);
+   }
+
+   nir_block_worklist_fini(&worklist);
+   ralloc_free(lin_ctx);
+
+   impl->valid_metadata |= nir_metadata_live_defs;
+   impl->live_defs_ssa_alloc = impl->ssa_alloc;
 }
 
 /** Return the live set at a cursor
@@ -1530,7 +1530,7 @@ initialize_loop_info_state(nir_loop *loop, void *mem_ctx,
    if (loop->info)
       ralloc_free(loop->info);
 
-   loop->info = rzalloc(loop, nir_loop_info);
+   loop->info = rzalloc(ralloc_parent(impl), nir_loop_info);
 
    list_inithead(&loop->info->loop_terminator_list);
 
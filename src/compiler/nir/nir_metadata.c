@@ -22,6 +22,7 @@
  */
 
 #include "nir.h"
+#include "util/hash_table.h"
 
 /*
  * Handles management of the metadata.
@@ -62,6 +63,26 @@ void
 nir_metadata_preserve(nir_function_impl *impl, nir_metadata preserved)
 {
    impl->valid_metadata &= preserved;
+
+   /* Passes which made no progress preserve everything. */
+   if ((preserved & nir_metadata_all) != nir_metadata_all)
+      nir_function_impl_mark_changed(impl);
+}
+
+void
+nir_function_impl_mark_changed(nir_function_impl *impl)
+{
+   /* Bare impls get a fresh change_seq once they are given a function. */
+   if (impl->function)
+      impl->change_seq = ++impl->function->shader->change_seq;
+}
+
+void
+nir_shader_mark_changed(nir_shader *shader)
+{
+   nir_foreach_function_impl(impl, shader) {
+      nir_function_impl_mark_changed(impl);
+   }
 }
 
 void
@@ -72,6 +93,70 @@ nir_shader_preserve_all_metadata(nir_shader *shader)
    }
 }
 
+void
+nir_pass_tracker_init(nir_pass_tracker *tracker)
+{
+   tracker->last_run = _mesa_pointer_hash_table_create(NULL);
+   tracker->seq_before_pass = 0;
+}
+
+void
+nir_pass_tracker_fini(nir_pass_tracker *tracker)
+{
+   _mesa_hash_table_destroy(tracker->last_run, NULL);
+}
+
+/**
+ * Called before running a tracked pass.  Returns false if the pass can be
+ * skipped because nothing changed since it last ran.  Otherwise, restricts
+ * nir_foreach_dirty_function_impl to the impls changed since then.
+ */
+bool
+nir_pass_tracker_begin(nir_pass_tracker *tracker, nir_shader *shader,
+                       void (*pass)())
+{
+   struct hash_entry *entry =
+      _mesa_hash_table_search(tracker->last_run, (void *)pass);
+   uint64_t last_seq = entry ? *(uint64_t *)entry->data : 0;
+
+   if (entry && last_seq == shader->change_seq)
+      return false;
+
+   shader->pass_clean_seq = last_seq;
+   shader->pass_tracker = tracker;
+   tracker->seq_before_pass = shader->change_seq;
+   return true;
+}
+
+void
+nir_pass_tracker_end(nir_pass_tracker *tracker, nir_shader *shader,
+                     void (*pass)(), bool idempotent, bool progress)
+{
+   shader->pass_clean_seq = 0;
+   shader->pass_tracker = NULL;
+
+   /* Passes which only change shader-level state (variables, info, ...)
+    * don't touch any impl's metadata.  Conservatively treat every impl as
+    * changed so later passes don't skip them.
+    */
+   if (progress && shader->change_seq == tracker->seq_before_pass)
+      nir_shader_mark_changed(shader);
+
+   /* A non-idempotent pass which made progress may make more on its own
+    * output, keep the state from its last run.
+    */
+   if (progress && !idempotent)
+      return;
+
+   struct hash_entry *entry =
+      _mesa_hash_table_search(tracker->last_run, (void *)pass);
+   if (!entry) {
+      uint64_t *seq = ralloc(tracker->last_run, uint64_t);
+      entry = _mesa_hash_table_insert(tracker->last_run, (void *)pass, seq);
+   }
+   *(uint64_t *)entry->data = shader->change_seq;
+}
+
 #ifndef NDEBUG
 /**
  * Make sure passes properly invalidate metadata (part 1).
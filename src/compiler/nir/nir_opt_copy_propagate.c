@@ -172,7 +172,7 @@ nir_copy_prop(nir_shader *shader)
 {
    bool progress = false;
 
-   nir_foreach_function_impl(impl, shader) {
+   nir_foreach_dirty_function_impl(impl, shader) {
       if (nir_copy_prop_impl(impl))
          progress = true;
    }
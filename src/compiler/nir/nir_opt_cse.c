@@ -64,7 +64,7 @@ nir_opt_cse(nir_shader *shader)
 {
    bool progress = false;
 
-   nir_foreach_function_impl(impl, shader) {
+   nir_foreach_dirty_function_impl(impl, shader) {
       progress |= nir_opt_cse_impl(impl);
    }
 
@@ -251,7 +251,7 @@ bool
 nir_opt_dce(nir_shader *shader)
 {
    bool progress = false;
-   nir_foreach_function_impl(impl, shader) {
+   nir_foreach_dirty_function_impl(impl, shader) {
       if (nir_opt_dce_impl(impl))
          progress = true;
    }
@@ -412,7 +412,7 @@ nir_opt_dead_cf(nir_shader *shader)
 {
    bool progress = false;
 
-   nir_foreach_function_impl(impl, shader)
+   nir_foreach_dirty_function_impl(impl, shader)
       progress |= opt_dead_cf_impl(impl);
 
    return progress;
@@ -871,6 +871,18 @@ nir_opt_gcm(nir_shader *shader, bool value_number)
 {
    bool progress = false;
 
+   /* Full value numbering extends live ranges, which makes register
+    * allocation slower and more likely to spill.  Stick to the weak variant
+    * on shaders which are already over their compile-time budget.
+    */
+   if (value_number) {
+      nir_shader_budget_update(shader);
+      if (!nir_shader_budget_consume(shader, 0)) {
+         shader->info.budget_skipped_gcm++;
+         value_number = false;
+      }
+   }
+
    nir_foreach_function_impl(impl, shader) {
       progress |= opt_gcm_impl(shader, impl, value_number);
    }
@@ -402,7 +402,7 @@ nir_opt_intrinsics(nir_shader *shader)
 {
    bool progress = false;
 
-   nir_foreach_function_impl(impl, shader) {
+   nir_foreach_dirty_function_impl(impl, shader) {
       if (opt_intrinsics_impl(impl, shader->options)) {
          progress = true;
          nir_metadata_preserve(impl, nir_metadata_block_index |
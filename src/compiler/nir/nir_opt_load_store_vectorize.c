@@ -153,6 +153,8 @@ struct vectorize_ctx {
    nir_shader *shader;
    const nir_load_store_vectorize_options *options;
    struct list_head entries[nir_num_variable_modes];
+   /* the stores in "entries", ordered by index */
+   struct util_dynarray stores_by_index[nir_num_variable_modes];
    struct hash_table *loads[nir_num_variable_modes];
    struct hash_table *stores[nir_num_variable_modes];
 };
@@ -971,13 +973,28 @@ check_for_aliasing(struct vectorize_ctx *ctx, struct entry *first, struct entry
             return true;
       }
    } else {
-      /* find previous store that aliases this load */
-      list_for_each_entry_from_rev(struct entry, prev, second, &ctx->entries[mode_index], head) {
-         if (prev == second)
+      /* find a store between the loads that aliases "second". Only stores
+       * matter here, so look them up by index instead of walking all the
+       * entries in between, which is quadratic for blocks with lots of
+       * loads. */
+      struct util_dynarray *stores = &ctx->stores_by_index[mode_index];
+      struct entry **arr = util_dynarray_begin(stores);
+      unsigned num_stores = util_dynarray_num_elements(stores, struct entry *);
+
+      unsigned lo = 0, hi = num_stores;
+      while (lo < hi) {
+         unsigned mid = (lo + hi) / 2;
+         if (arr[mid]->index < first->index)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+
+      for (unsigned i = lo; i < num_stores && arr[i]->index < second->index; i++) {
+         /* skip stores which were combined into later ones */
+         if (!list_is_linked(&arr[i]->head))
             continue;
-         if (prev == first)
-            return false;
-         if (prev->is_store && may_alias(ctx->shader, second, prev))
+         if (may_alias(ctx->shader, second, arr[i]))
             return true;
       }
    }
@@ -1375,6 +1392,7 @@ process_block(nir_function_impl *impl, struct vectorize_ctx *ctx, nir_block *blo
 
    for (unsigned i = 0; i < nir_num_variable_modes; i++) {
       list_inithead(&ctx->entries[i]);
+      util_dynarray_clear(&ctx->stores_by_index[i]);
       if (ctx->loads[i])
          _mesa_hash_table_clear(ctx->loads[i], delete_entry_dynarray);
       if (ctx->stores[i])
@@ -1409,6 +1427,8 @@ process_block(nir_function_impl *impl, struct vectorize_ctx *ctx, nir_block *blo
       entry->index = next_index++;
 
       list_addtail(&entry->head, &ctx->entries[mode_index]);
+      if (entry->is_store)
+         util_dynarray_append(&ctx->stores_by_index[mode_index], struct entry *, entry);
 
       /* add the entry to a hash table */
 
@@ -1453,6 +1473,8 @@ nir_opt_load_store_vectorize(nir_shader *shader, const nir_load_store_vectorize_
    struct vectorize_ctx *ctx = rzalloc(NULL, struct vectorize_ctx);
    ctx->shader = shader;
    ctx->options = options;
+   for (unsigned i = 0; i < nir_num_variable_modes; i++)
+      util_dynarray_init(&ctx->stores_by_index[i], ctx);
 
    nir_shader_index_vars(shader, options->modes);
 
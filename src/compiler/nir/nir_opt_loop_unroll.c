@@ -875,8 +875,18 @@ check_unrolling_restrictions(nir_shader *shader, nir_loop *loop)
    unsigned cost_limit = max_iter * LOOP_UNROLL_LIMIT;
    unsigned cost = li->instr_cost * trip_count;
 
-   if (cost <= cost_limit && trip_count <= max_iter)
+   if (cost <= cost_limit && trip_count <= max_iter) {
+      /* Loops the heuristic picked are optional, so they are the first thing
+       * to go once the shader is over its compile-time budget.  The cost is
+       * close enough to the number of instructions unrolling adds.
+       */
+      if (!nir_shader_budget_consume(shader, cost)) {
+         shader->info.budget_skipped_unrolls++;
+         return false;
+      }
+
       return true;
+   }
 
    return false;
 }
@@ -1147,6 +1157,9 @@ nir_opt_loop_unroll(nir_shader *shader)
 
    bool force_unroll_sampler_indirect = shader->options->force_indirect_unrolling_sampler;
    nir_variable_mode indirect_mask = shader->options->force_indirect_unrolling;
+
+   nir_shader_budget_update(shader);
+
    nir_foreach_function_impl(impl, shader) {
       progress |= nir_opt_loop_unroll_impl(impl, indirect_mask,
                                            force_unroll_sampler_indirect);
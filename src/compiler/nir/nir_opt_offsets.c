@@ -71,6 +71,7 @@ try_extract_const_addition(nir_builder *b, nir_scalar val, opt_offsets_state *st
 
       /* We proved that unsigned wrap won't be possible, so we can set the flag too. */
       alu->no_unsigned_wrap = true;
+      nir_instr_mark_changed(&alu->instr);
    }
 
    for (unsigned i = 0; i < 2; ++i) {
@@ -546,7 +546,7 @@ nir_opt_peephole_select(nir_shader *shader, unsigned limit,
 {
    bool progress = false;
 
-   nir_foreach_function_impl(impl, shader) {
+   nir_foreach_dirty_function_impl(impl, shader) {
       progress |= nir_opt_peephole_select_impl(impl, limit,
                                                indirect_load_ok,
                                                expensive_alu_ok);
@@ -167,7 +167,7 @@ nir_opt_remove_phis(nir_shader *shader)
 {
    bool progress = false;
 
-   nir_foreach_function_impl(impl, shader)
+   nir_foreach_dirty_function_impl(impl, shader)
       progress = nir_opt_remove_phis_impl(impl) || progress;
 
    return progress;
@@ -69,6 +69,8 @@ reswizzle_alu_uses(nir_def *def, uint8_t *reswizzle)
       /* reswizzle ALU sources */
       for (unsigned i = 0; i < NIR_MAX_VEC_COMPONENTS; i++)
          alu_src->swizzle[i] = reswizzle[alu_src->swizzle[i]];
+
+      nir_instr_mark_changed(nir_src_parent_instr(use_src));
    }
 }
 
@@ -301,6 +303,9 @@ opt_shrink_vectors_alu(nir_builder *b, nir_alu_instr *instr)
    /* update dest */
    def->num_components = rounded;
 
+   if (progress)
+      nir_instr_mark_changed(&instr->instr);
+
    return progress;
 }
 
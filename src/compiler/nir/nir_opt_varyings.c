@@ -4192,9 +4192,51 @@ print_shader_linkage(nir_shader *producer, nir_shader *consumer)
    free_linkage(&linkage);
 }
 
+/**
+ * Return the number of bytes of varyings the producer passes to the next
+ * shader for each vertex (or primitive), which is a rough measure of
+ * the memory traffic on tiled GPUs. Each written 32-bit component counts
+ * 4 bytes, and a pair of 16-bit halves packed into the same component counts
+ * only once. Outputs that are not varyings (no_varying) are not counted.
+ *
+ * nir_lower_io_to_scalar is required before this, like for nir_opt_varyings.
+ */
+unsigned
+nir_varying_bytes_per_vertex(nir_shader *producer)
+{
+   BITSET_DECLARE(written, NUM_TOTAL_VARYING_SLOTS * 4) = {0};
+   nir_function_impl *impl = nir_shader_get_entrypoint(producer);
+
+   nir_foreach_block(block, impl) {
+      nir_foreach_instr(instr, block) {
+         if (instr->type != nir_instr_type_intrinsic)
+            continue;
+
+         nir_intrinsic_instr *intr = nir_instr_as_intrinsic(instr);
+         if (intr->intrinsic != nir_intrinsic_store_output &&
+             intr->intrinsic != nir_intrinsic_store_per_vertex_output &&
+             intr->intrinsic != nir_intrinsic_store_per_primitive_output)
+            continue;
+
+         nir_io_semantics sem = nir_intrinsic_io_semantics(intr);
+         if (sem.no_varying)
+            continue;
+
+         unsigned component = nir_intrinsic_component(intr);
+         for (unsigned i = 0; i < sem.num_slots; i++)
+            BITSET_SET(written, (sem.location + i) * 4 + component);
+      }
+   }
+
+   return BITSET_COUNT(written) * 4;
+}
+
 /**
  * Run lots of optimizations on varyings. See the description at the beginning
  * of this file.
+ *
+ * The number of bytes per vertex saved (see nir_varying_bytes_per_vertex) is
+ * accumulated in shader_info::opt_varyings_bytes_saved of the producer.
  */
 nir_opt_varyings_progress
 nir_opt_varyings(nir_shader *producer, nir_shader *consumer, bool spirv,
@@ -4220,6 +4262,8 @@ nir_opt_varyings(nir_shader *producer, nir_shader *consumer, bool spirv,
    init_linkage(producer, consumer, spirv, max_uniform_components,
                 max_ubos_per_stage, &linkage);
 
+   unsigned bytes_before = nir_varying_bytes_per_vertex(producer);
+
    /* Part 1: Run optimizations that only remove varyings. (they can move
     * instructions between shaders)
     */
@@ -4284,6 +4328,13 @@ nir_opt_varyings(nir_shader *producer, nir_shader *consumer, bool spirv,
                             nir_metadata_all);
    free_linkage(&linkage);
 
+   unsigned bytes_after = nir_varying_bytes_per_vertex(producer);
+   if (bytes_after < bytes_before) {
+      producer->info.opt_varyings_bytes_saved =
+         MIN2(producer->info.opt_varyings_bytes_saved +
+              (bytes_before - bytes_after), UINT16_MAX);
+   }
+
    if (progress & nir_progress_producer)
       nir_validate_shader(producer, "nir_opt_varyings");
    if (progress & nir_progress_consumer)
@@ -0,0 +1,151 @@
+/*
+ * Copyright © 2024 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Process-wide accounting of the time spent in each NIR_PASS.
+ *
+ * Enabled with NIR_PASS_STATS=true, which works in release builds too.  The
+ * time of a pass includes the time of any NIR_PASS it runs itself.  The
+ * table is printed to stderr when the process exits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "util/hash_table.h"
+#include "util/os_time.h"
+#include "util/simple_mtx.h"
+#include "util/u_call_once.h"
+#include "util/u_debug.h"
+#include "nir.h"
+
+bool nir_pass_stats_enabled = false;
+
+struct pass_stats {
+   const char *name;
+   uint64_t calls;
+   /* Calls for which the pass reported whether it made progress. */
+   uint64_t progress_calls;
+   uint64_t progress;
+   int64_t time_ns;
+};
+
+static simple_mtx_t stats_lock = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *stats_table;
+
+DEBUG_GET_ONCE_BOOL_OPTION(nir_pass_stats, "NIR_PASS_STATS", false)
+
+static int
+compare_time(const void *_a, const void *_b)
+{
+   const struct pass_stats *a = *(const struct pass_stats **)_a;
+   const struct pass_stats *b = *(const struct pass_stats **)_b;
+
+   if (a->time_ns != b->time_ns)
+      return a->time_ns < b->time_ns ? 1 : -1;
+   return strcmp(a->name, b->name);
+}
+
+static void
+nir_pass_stats_dump(void)
+{
+   simple_mtx_lock(&stats_lock);
+
+   if (!stats_table) {
+      simple_mtx_unlock(&stats_lock);
+      return;
+   }
+
+   unsigned count = _mesa_hash_table_num_entries(stats_table);
+   struct pass_stats **sorted = malloc(count * sizeof(*sorted));
+   int64_t total_ns = 0;
+   unsigned i = 0;
+
+   hash_table_foreach(stats_table, entry) {
+      struct pass_stats *stats = entry->data;
+      sorted[i++] = stats;
+      total_ns += stats->time_ns;
+   }
+   qsort(sorted, count, sizeof(*sorted), compare_time);
+
+   fprintf(stderr, "%-48s %10s %9s %12s %10s %7s\n",
+           "NIR pass", "calls", "progress", "total (ms)", "avg (us)", "time");
+   for (i = 0; i < count; i++) {
+      const struct pass_stats *stats = sorted[i];
+      char progress[16] = "-";
+
+      if (stats->progress_calls) {
+         snprintf(progress, sizeof(progress), "%.1f%%",
+                  100.0 * stats->progress / stats->progress_calls);
+      }
+
+      fprintf(stderr, "%-48s %10" PRIu64 " %9s %12.3f %10.2f %6.2f%%\n",
+              stats->name, stats->calls, progress, stats->time_ns / 1e6,
+              stats->time_ns / 1e3 / stats->calls,
+              total_ns ? 100.0 * stats->time_ns / total_ns : 0.0);
+   }
+
+   free(sorted);
+   _mesa_hash_table_destroy(stats_table, NULL);
+   stats_table = NULL;
+
+   simple_mtx_unlock(&stats_lock);
+}
+
+static void
+nir_pass_stats_init_once(void)
+{
+   nir_pass_stats_enabled = debug_get_option_nir_pass_stats();
+   if (nir_pass_stats_enabled)
+      atexit(nir_pass_stats_dump);
+}
+
+void
+nir_pass_stats_init(void)
+{
+   static util_once_flag flag = UTIL_ONCE_FLAG_INIT;
+   util_call_once(&flag, nir_pass_stats_init_once);
+}
+
+int64_t
+_nir_pass_stats_now(void)
+{
+   return os_time_get_nano();
+}
+
+/**
+ * Accounts one run of the pass \p name which started at \p start_ns.
+ * \p progress is -1 if the pass doesn't report progress.
+ */
+void
+_nir_pass_stats_record(const char *name, int64_t start_ns, int progress)
+{
+   int64_t time_ns = os_time_get_nano() - start_ns;
+
+   simple_mtx_lock(&stats_lock);
+
+   if (!stats_table) {
+      stats_table = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                            _mesa_key_string_equal);
+   }
+
+   struct hash_entry *entry = _mesa_hash_table_search(stats_table, name);
+   struct pass_stats *stats;
+   if (entry) {
+      stats = entry->data;
+   } else {
+      stats = rzalloc(stats_table, struct pass_stats);
+      stats->name = name;
+      _mesa_hash_table_insert(stats_table, name, stats);
+   }
+
+   stats->calls++;
+   stats->time_ns += time_ns;
+   if (progress >= 0) {
+      stats->progress_calls++;
+      stats->progress += progress;
+   }
+
+   simple_mtx_unlock(&stats_lock);
+}
@@ -2506,6 +2506,11 @@ print_shader_info(const struct shader_info *info, FILE *fp)
    print_nz_bool(fp, "io_lowered", info->io_lowered);
    print_nz_bool(fp, "writes_memory", info->writes_memory);
 
+   print_nz_unsigned(fp, "budget_skipped_unrolls", info->budget_skipped_unrolls);
+   print_nz_unsigned(fp, "budget_skipped_inlines", info->budget_skipped_inlines);
+   print_nz_unsigned(fp, "budget_skipped_gcm", info->budget_skipped_gcm);
+   print_nz_unsigned(fp, "opt_varyings_bytes_saved", info->opt_varyings_bytes_saved);
+
    switch (info->stage) {
    case MESA_SHADER_VERTEX:
       print_nz_x64(fp, "double_inputs", info->vs.double_inputs);
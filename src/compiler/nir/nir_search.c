@@ -866,10 +866,30 @@ nir_algebraic_instr(nir_builder *build, nir_instr *instr,
    return false;
 }
 
-bool
-nir_algebraic_impl(nir_function_impl *impl,
-                   const bool *condition_flags,
-                   const nir_algebraic_table *table)
+/* Whether an instruction or one of its sources changed since last_seq. */
+static bool
+alu_changed_since(const nir_alu_instr *alu, uint32_t last_seq)
+{
+   if (alu->instr.change_seq > last_seq)
+      return true;
+
+   for (unsigned i = 0; i < nir_op_infos[alu->op].num_inputs; i++) {
+      if (alu->src[i].src.ssa->parent_instr->change_seq > last_seq)
+         return true;
+   }
+
+   return false;
+}
+
+/* Runs the table over the impl.  If "incremental" is set, only the ALU
+ * instructions which changed since last_seq (or whose sources did) start on
+ * the worklist, the others were already visited by the previous run.
+ */
+static bool
+nir_algebraic_impl_run(nir_function_impl *impl,
+                       const bool *condition_flags,
+                       const nir_algebraic_table *table,
+                       bool incremental, uint32_t last_seq)
 {
    bool progress = false;
 
@@ -904,7 +924,9 @@ nir_algebraic_impl(nir_function_impl *impl,
    nir_foreach_block_reverse(block, impl) {
       nir_foreach_instr_reverse(instr, block) {
          instr->pass_flags = 0;
-         if (instr->type == nir_instr_type_alu)
+         if (instr->type == nir_instr_type_alu &&
+             (!incremental ||
+              alu_changed_since(nir_instr_as_alu(instr), last_seq)))
             nir_instr_worklist_push_tail(worklist, instr);
       }
    }
@@ -932,6 +954,52 @@ nir_algebraic_impl(nir_function_impl *impl,
    ralloc_free(range_ht);
    util_dynarray_fini(&states);
 
+   return progress;
+}
+
+/**
+ * Runs an algebraic table over an impl.
+ *
+ * Inside of optimization loops using a nir_pass_tracker, every run after the
+ * first one only revisits the instructions which changed since the previous
+ * run of the same table, using nir_instr::change_seq.  That misses
+ * optimizations enabled by changes further up an expression tree (range
+ * analysis in particular looks arbitrarily far), so an incremental run which
+ * makes no progress falls back to a full one.  The loop thus still reaches
+ * the same fixed point, but only its last iteration walks everything.
+ */
+bool
+nir_algebraic_impl(nir_function_impl *impl,
+                   const bool *condition_flags,
+                   const nir_algebraic_table *table)
+{
+   const bool tracked = impl->function->shader->pass_tracker != NULL;
+   const uint32_t start_seq = impl->instr_change_seq;
+
+   struct hash_entry *entry = NULL;
+   if (tracked && impl->algebraic_seqs)
+      entry = _mesa_hash_table_search(impl->algebraic_seqs, table);
+
+   /* The counter wrapping around makes it impossible to tell what changed. */
+   const uint32_t last_seq = entry ? (uintptr_t)entry->data : 0;
+   const bool incremental = entry && last_seq <= start_seq;
+
+   bool progress = nir_algebraic_impl_run(impl, condition_flags, table,
+                                          incremental, last_seq);
+   if (incremental && !progress) {
+      progress = nir_algebraic_impl_run(impl, condition_flags, table,
+                                        false, 0);
+   }
+
+   if (tracked) {
+      if (!impl->algebraic_seqs)
+         impl->algebraic_seqs = _mesa_pointer_hash_table_create(impl);
+
+      /* Whatever this run changed gets revisited by the next one. */
+      _mesa_hash_table_insert(impl->algebraic_seqs, table,
+                              (void *)(uintptr_t)start_seq);
+   }
+
    if (progress) {
       nir_metadata_preserve(impl, nir_metadata_block_index |
                                      nir_metadata_dominance);
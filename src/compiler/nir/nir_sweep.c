@@ -45,11 +45,15 @@ static void sweep_cf_node(nir_shader *nir, nir_cf_node *cf_node);
 static void
 sweep_block(nir_shader *nir, nir_block *block)
 {
-   ralloc_steal(nir, block);
+   gc_mark_live(nir->gctx, block);
+   ralloc_steal(nir, block->predecessors);
 
    /* sweep_impl will mark all metadata invalid.  We can safely release all of
     * this here.
     */
+   ralloc_free(block->dom_frontier);
+   block->dom_frontier = NULL;
+
    ralloc_free(block->live_in);
    block->live_in = NULL;
 
@@ -76,7 +80,7 @@ sweep_block(nir_shader *nir, nir_block *block)
 static void
 sweep_if(nir_shader *nir, nir_if *iff)
 {
-   ralloc_steal(nir, iff);
+   gc_mark_live(nir->gctx, iff);
 
    foreach_list_typed(nir_cf_node, cf_node, node, &iff->then_list) {
       sweep_cf_node(nir, cf_node);
@@ -91,7 +95,8 @@ static void
 sweep_loop(nir_shader *nir, nir_loop *loop)
 {
    assert(!nir_loop_has_continue_construct(loop));
-   ralloc_steal(nir, loop);
+   gc_mark_live(nir->gctx, loop);
+   ralloc_steal(nir, loop->info);
 
    foreach_list_typed(nir_cf_node, cf_node, node, &loop->body) {
       sweep_cf_node(nir, cf_node);
@@ -129,8 +134,13 @@ sweep_impl(nir_shader *nir, nir_function_impl *impl)
 
    sweep_block(nir, impl->end_block);
 
-   /* Wipe out all the metadata, if any. */
+   /* Wipe out all the metadata, if any.  The dominance and liveness data
+    * hanging off the blocks was not stolen back either, so it can't be
+    * reused based on the CFG stamp.
+    */
    nir_metadata_preserve(impl, nir_metadata_none);
+   impl->dominance_cfg_seq = 0;
+   impl->live_defs_cfg_seq = 0;
 }
 
 static void
@@ -120,6 +120,26 @@ protected:
    }
 };
 
+class nir_opt_algebraic_tracked_test : public algebraic_test_base {
+protected:
+   nir_opt_algebraic_tracked_test()
+   {
+      nir_pass_tracker_init(&tracker);
+   }
+
+   ~nir_opt_algebraic_tracked_test()
+   {
+      nir_pass_tracker_fini(&tracker);
+   }
+
+   virtual void run_pass() {
+      bool progress = false;
+      NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, b->shader, nir_opt_algebraic);
+   }
+
+   nir_pass_tracker tracker;
+};
+
 TEST_F(nir_opt_algebraic_test, umod_pow2_src2)
 {
    for (int i = 0; i <= 9; i++)
@@ -271,4 +291,35 @@ TEST_F(nir_opt_idiv_const_test, irem)
    }
 }
 
+
+TEST_F(nir_opt_algebraic_tracked_test, incremental)
+{
+   nir_def *res_deref = &nir_build_deref_var(b, res_var)->def;
+   nir_def *index = nir_load_local_invocation_index(b);
+
+   nir_build_store_deref(b, res_deref, nir_iadd(b, index, nir_imm_int(b, 0)), 0x1);
+
+   bool progress = false;
+   NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, b->shader, nir_opt_algebraic);
+   ASSERT_TRUE(progress);
+
+   /* Nothing changed since, this run is incremental and falls back to a full
+    * one after making no progress.
+    */
+   progress = false;
+   NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, b->shader, nir_opt_algebraic);
+   ASSERT_FALSE(progress);
+
+   /* New instructions are picked up by the incremental run. */
+   nir_build_store_deref(b, res_deref, nir_imul(b, index, nir_imm_int(b, 1)), 0x1);
+   nir_shader_mark_changed(b->shader);
+   NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, b->shader, nir_opt_algebraic);
+   ASSERT_TRUE(progress);
+
+   nir_foreach_instr(instr, nir_start_block(b->impl)) {
+      if (instr->type == nir_instr_type_alu)
+         ASSERT_NE(nir_instr_as_alu(instr)->op, nir_op_imul);
+   }
+}
+
 }
@@ -130,3 +130,133 @@ TEST_F(nir_cf_test, delete_break_in_loop)
 
    nir_metadata_require(b->impl, nir_metadata_dominance);
 }
+
+TEST_F(nir_cf_test, dominance_reused_if_cfg_unchanged)
+{
+   nir_def *val = nir_load_global(b, nir_imm_int64(b, 0), 4, 1, 32);
+   nir_push_if(b, nir_ine_imm(b, val, 0));
+   nir_def *then_val = nir_iadd(b, val, val);
+   nir_pop_if(b, NULL);
+   nir_store_global(b, nir_imm_int64(b, 0), 4, then_val, 0x1);
+
+   nir_metadata_require(b->impl, nir_metadata_dominance);
+   nir_block *start = nir_start_block(b->impl);
+   nir_block **dom_children = start->dom_children;
+
+   /* Adding instructions doesn't change the CFG so dominance is kept even
+    * though the metadata was dropped.
+    */
+   b->cursor = nir_after_block(start);
+   nir_iadd(b, val, nir_imm_int(b, 1));
+   nir_metadata_preserve(b->impl, nir_metadata_none);
+   nir_metadata_require(b->impl, nir_metadata_dominance);
+   EXPECT_EQ(dom_children, start->dom_children);
+
+   /* New control flow needs a recompute. */
+   b->cursor = nir_after_cf_list(&b->impl->body);
+   nir_if *nif = nir_push_if(b, nir_ine_imm(b, val, 1));
+   nir_pop_if(b, nif);
+   nir_metadata_preserve(b->impl, nir_metadata_none);
+   nir_metadata_require(b->impl, nir_metadata_dominance);
+
+   nir_block *merge = nir_cf_node_as_block(nir_cf_node_next(&nif->cf_node));
+   nir_block *before = nir_cf_node_as_block(nir_cf_node_prev(&nif->cf_node));
+   EXPECT_EQ(before, merge->imm_dom);
+   EXPECT_EQ(before, nir_if_first_then_block(nif)->imm_dom);
+   EXPECT_TRUE(nir_block_dominates(start, merge));
+}
+
+static void
+expect_live_defs_match_full(nir_function_impl *impl)
+{
+   const unsigned words = BITSET_WORDS(impl->ssa_alloc);
+   void *mem_ctx = ralloc_context(NULL);
+   struct hash_table *saved = _mesa_pointer_hash_table_create(mem_ctx);
+
+   nir_foreach_block(block, impl) {
+      BITSET_WORD *sets = ralloc_array(mem_ctx, BITSET_WORD, 2 * words);
+      memcpy(sets, block->live_in, words * sizeof(BITSET_WORD));
+      memcpy(sets + words, block->live_out, words * sizeof(BITSET_WORD));
+      _mesa_hash_table_insert(saved, block, sets);
+   }
+
+   impl->valid_metadata &= ~nir_metadata_live_defs;
+   nir_live_defs_impl(impl);
+
+   nir_foreach_block(block, impl) {
+      BITSET_WORD *sets = (BITSET_WORD *)
+         _mesa_hash_table_search(saved, block)->data;
+      for (unsigned i = 0; i < words; i++) {
+         EXPECT_EQ(sets[i], block->live_in[i]) << "block " << block->index;
+         EXPECT_EQ(sets[words + i], block->live_out[i])
+            << "block " << block->index;
+      }
+   }
+
+   ralloc_free(mem_ctx);
+}
+
+TEST_F(nir_cf_test, live_defs_update_local_edits)
+{
+   nir_def *addr = nir_imm_int64(b, 0);
+   nir_def *val = nir_load_global(b, addr, 4, 1, 32);
+   nir_def *cond = nir_ine_imm(b, val, 0);
+
+   nir_push_if(b, cond);
+   nir_def *then_val = nir_iadd(b, val, val);
+   nir_push_else(b, NULL);
+   nir_def *else_val = nir_imul(b, val, val);
+   nir_pop_if(b, NULL);
+   nir_def *phi = nir_if_phi(b, then_val, else_val);
+
+   nir_loop *loop = nir_push_loop(b);
+   nir_def *body_val = nir_iadd(b, val, phi);
+   nir_push_if(b, nir_ilt_imm(b, body_val, 10));
+   nir_jump(b, nir_jump_break);
+   nir_pop_if(b, NULL);
+   nir_pop_loop(b, loop);
+
+   nir_store_global(b, addr, 4, phi, 0x1);
+   nir_intrinsic_instr *store =
+      nir_instr_as_intrinsic(nir_block_last_instr(nir_cursor_current_block(b->cursor)));
+
+   nir_metadata_require(b->impl, nir_metadata_live_defs);
+
+   /* Make a new def in the start block live across the loop instead of the
+    * phi.
+    */
+   nir_block *start = nir_start_block(b->impl);
+   nir_block *store_block = store->instr.block;
+   b->cursor = nir_after_instr(cond->parent_instr);
+   nir_def *new_val = nir_iadd_imm(b, val, 7);
+   nir_src_rewrite(&store->src[0], new_val);
+
+   struct set *changed = _mesa_pointer_set_create(NULL);
+   _mesa_set_add(changed, start);
+   _mesa_set_add(changed, store_block);
+   nir_live_defs_update_impl(b->impl, changed);
+   ASSERT_TRUE(b->impl->valid_metadata & nir_metadata_live_defs);
+   EXPECT_TRUE(BITSET_TEST(nir_loop_first_block(loop)->live_in, new_val->index));
+   expect_live_defs_match_full(b->impl);
+
+   /* Drop the loop's only use of the phi. */
+   nir_block *body = nir_loop_first_block(loop);
+   nir_alu_instr *add = nir_instr_as_alu(body_val->parent_instr);
+   nir_src_rewrite(&add->src[1].src, new_val);
+
+   _mesa_set_clear(changed, NULL);
+   _mesa_set_add(changed, body);
+   b->impl->valid_metadata &= ~nir_metadata_live_defs;
+   nir_live_defs_update_impl(b->impl, changed);
+   EXPECT_FALSE(BITSET_TEST(body->live_in, phi->index));
+   expect_live_defs_match_full(b->impl);
+
+   /* A CFG change falls back to a full recompute. */
+   nir_push_if(b, cond);
+   nir_pop_if(b, NULL);
+   nir_live_defs_update_impl(b->impl, changed);
+   ASSERT_TRUE(b->impl->valid_metadata & nir_metadata_live_defs);
+   expect_live_defs_match_full(b->impl);
+
+   _mesa_set_destroy(changed, NULL);
+}
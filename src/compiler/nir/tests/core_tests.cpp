@@ -117,4 +117,74 @@ TEST_F(nir_core_test, nir_instr_free_and_dce_multiple_src_test)
    nir_validate_shader(b->shader, "after remove_and_dce");
 }
 
+TEST_F(nir_core_test, nir_instr_change_seq_test)
+{
+   nir_def *one = nir_imm_int(b, 1);
+   nir_def *two = nir_imm_int(b, 2);
+   nir_def *add = nir_iadd(b, one, one);
+
+   /* Inserting an instruction gives it a new change_seq. */
+   ASSERT_GT(add->parent_instr->change_seq, one->parent_instr->change_seq);
+   ASSERT_GT(add->parent_instr->change_seq, two->parent_instr->change_seq);
+
+   /* Rewriting a source marks the user and the old def, which lost a use. */
+   uint32_t seq = b->impl->instr_change_seq;
+   nir_src_rewrite(&nir_instr_as_alu(add->parent_instr)->src[1].src, two);
+   ASSERT_GT(add->parent_instr->change_seq, seq);
+   ASSERT_GT(one->parent_instr->change_seq, seq);
+   ASSERT_LE(two->parent_instr->change_seq, seq);
+
+   /* Removing an instruction marks the defs it used. */
+   seq = b->impl->instr_change_seq;
+   nir_instr_remove(add->parent_instr);
+   ASSERT_GT(one->parent_instr->change_seq, seq);
+   ASSERT_GT(two->parent_instr->change_seq, seq);
+}
+
+TEST_F(nir_core_test, nir_sweep_cf_nodes_test)
+{
+   nir_def *val = nir_load_global(b, nir_imm_int64(b, 0), 4, 1, 32);
+   nir_def *cond = nir_ine_imm(b, val, 0);
+   nir_loop *loop = nir_push_loop(b);
+   {
+      nir_push_if(b, cond);
+      nir_jump(b, nir_jump_break);
+      nir_pop_if(b, NULL);
+   }
+   nir_pop_loop(b, loop);
+
+   /* Dominance frontiers are only allocated once dominance is computed. */
+   nir_block *after = nir_cf_node_as_block(nir_cf_node_next(&loop->cf_node));
+   ASSERT_EQ(after->dom_frontier, nullptr);
+   nir_metadata_require(b->impl, nir_metadata_dominance);
+   nir_foreach_block(block, b->impl)
+      ASSERT_NE(block->dom_frontier, nullptr);
+
+   nir_loop_analyze_impl(b->impl, nir_var_all, false);
+   ASSERT_NE(loop->info, nullptr);
+
+   /* Extract and drop some control flow so the sweep has dead CF nodes to
+    * reclaim.
+    */
+   nir_if *dead_if = nir_push_if(b, cond);
+   nir_pop_if(b, dead_if);
+   nir_cf_list list;
+   nir_cf_extract(&list, nir_before_cf_node(&dead_if->cf_node),
+                  nir_after_cf_node(&dead_if->cf_node));
+   nir_cf_delete(&list);
+
+   nir_sweep(b->shader);
+
+   nir_foreach_block(block, b->impl) {
+      ASSERT_EQ(block->dom_frontier, nullptr);
+      ASSERT_NE(block->predecessors, nullptr);
+   }
+   ASSERT_NE(loop->info, nullptr);
+
+   nir_validate_shader(b->shader, "after sweep");
+
+   nir_metadata_require(b->impl, nir_metadata_dominance);
+   nir_validate_shader(b->shader, "after dominance");
+}
+
 }
@@ -656,6 +656,33 @@ TEST_F(nir_load_store_vectorize_test, ssbo_load_identical_store_identical)
    ASSERT_EQ(count_intrinsics(nir_intrinsic_load_ssbo), 2);
 }
 
+TEST_F(nir_load_store_vectorize_test, ssbo_load_many_with_stores)
+{
+   /* Lots of loads with unrelated stores to the same binding in between,
+    * which used to be quadratic to check for aliasing.
+    */
+   for (unsigned i = 0; i < 256; i++) {
+      create_load(nir_var_mem_ssbo, 0, i * 4, i + 1);
+      if (i % 16 == 15)
+         create_store(nir_var_mem_ssbo, 0, 0x10000 + i * 4, 0x1000 + i);
+   }
+
+   nir_validate_shader(b->shader, NULL);
+   ASSERT_EQ(count_intrinsics(nir_intrinsic_load_ssbo), 256);
+
+   EXPECT_TRUE(run_vectorizer(nir_var_mem_ssbo));
+
+   ASSERT_EQ(count_intrinsics(nir_intrinsic_load_ssbo), 32);
+   ASSERT_EQ(count_intrinsics(nir_intrinsic_store_ssbo), 16);
+
+   for (unsigned i = 0; i < 32; i++) {
+      nir_intrinsic_instr *load = get_intrinsic(nir_intrinsic_load_ssbo, i);
+      ASSERT_EQ(load->def.bit_size, 64);
+      ASSERT_EQ(load->def.num_components, 4);
+      ASSERT_EQ(nir_src_as_uint(load->src[1]), i * 32);
+   }
+}
+
 TEST_F(nir_load_store_vectorize_test, ssbo_store_identical_load_identical)
 {
    create_store(nir_var_mem_ssbo, 0, 0, 0x1);
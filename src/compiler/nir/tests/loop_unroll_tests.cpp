@@ -175,3 +175,22 @@ UNROLL_TEST_INSERT(lshl_neg,     int,  0xf0f0f0f0, 0,    1,
                    ige,          ishl, false,      TRUE, 4, 0)
 UNROLL_TEST_INSERT(lshl_neg_rev, int,  0xf0f0f0f0, 0,    1,
                    ilt,          ishl, true,       TRUE, 4, 0)
+
+TEST_F(nir_loop_unroll_test, over_budget)
+{
+   nir_def *init = nir_imm_int(&bld, 0);
+   nir_def *limit = nir_imm_int(&bld, 24);
+   nir_def *step = nir_imm_int(&bld, 4);
+   loop_unroll_test_helper(&bld, init, limit, step, &nir_ige, &nir_iadd,
+                           false);
+
+   bld.shader->budget.max_instrs = 1;
+   EXPECT_FALSE(nir_opt_loop_unroll(bld.shader));
+   EXPECT_EQ(1, count_loops());
+   EXPECT_EQ(1, bld.shader->info.budget_skipped_unrolls);
+
+   bld.shader->budget.max_instrs = 1000;
+   EXPECT_TRUE(nir_opt_loop_unroll(bld.shader));
+   EXPECT_EQ(0, count_loops());
+   EXPECT_EQ(1, bld.shader->info.budget_skipped_unrolls);
+}
@@ -351,4 +351,25 @@ TEST_DEAD_OUTPUT_REMOVED(MESH, FRAGMENT, VAR0, 32)
 TEST_DEAD_OUTPUT_REMOVED(MESH, FRAGMENT, VAR0, 16)
 TEST_DEAD_OUTPUT_REMOVED(MESH, FRAGMENT, VAR0_16BIT, 16)
 
+TEST_F(nir_opt_varyings_test_dead_output, bytes_saved_VERTEX_FRAGMENT)
+{
+   create_shaders(MESA_SHADER_VERTEX, MESA_SHADER_FRAGMENT);
+   store_output(b1, VARYING_SLOT_VAR0, 0, nir_type_float32,
+                nir_imm_float(b1, 1), 0);
+   store_output(b1, VARYING_SLOT_VAR0, 1, nir_type_float32,
+                nir_imm_float(b1, 2), 0);
+   store_output(b1, VARYING_SLOT_VAR1, 0, nir_type_float32,
+                nir_imm_float(b1, 3), 0);
+   nir_def *input = load_input(b2, VARYING_SLOT_VAR1, 0, nir_type_float32, 0,
+                               INTERP_PERSP_PIXEL);
+   store_ssbo(b2, input);
+
+   ASSERT_EQ(nir_varying_bytes_per_vertex(b1->shader), 12);
+   ASSERT_TRUE(opt_varyings() & nir_progress_producer);
+
+   /* VAR0 is dead and the constant VAR1 is propagated into the FS. */
+   ASSERT_EQ(nir_varying_bytes_per_vertex(b1->shader), 0);
+   ASSERT_EQ(b1->shader->info.opt_varyings_bytes_saved, 12);
+}
+
 }
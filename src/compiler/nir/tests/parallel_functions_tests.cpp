@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2024 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/u_queue.h"
+#include "nir_test.h"
+
+class nir_parallel_functions_test : public nir_test {
+protected:
+   nir_parallel_functions_test()
+      : nir_test::nir_test("nir_parallel_functions_test")
+   {
+      var = nir_variable_create(b->shader, nir_var_shader_temp,
+                                glsl_int_type(), "var");
+
+      for (unsigned i = 0; i < ARRAY_SIZE(funcs); i++) {
+         funcs[i] = nir_function_create(b->shader, "func");
+         nir_function_impl_create(funcs[i]);
+      }
+
+      util_queue_init(&queue, "nir_test", 8, 2, 0, NULL);
+   }
+
+   ~nir_parallel_functions_test()
+   {
+      util_queue_destroy(&queue);
+   }
+
+   /* Stores var + 0 back to var. */
+   void build_body(nir_function_impl *impl)
+   {
+      nir_builder fb = nir_builder_at(nir_after_impl(impl));
+      nir_deref_instr *deref = nir_build_deref_var(&fb, var);
+      nir_def *val = nir_load_deref(&fb, deref);
+      nir_store_deref(&fb, deref, nir_iadd(&fb, val, nir_imm_int(&fb, 0)), 0x1);
+   }
+
+   unsigned count_iadd()
+   {
+      unsigned count = 0;
+      nir_foreach_function_impl(impl, b->shader) {
+         nir_foreach_block(block, impl) {
+            nir_foreach_instr(instr, block) {
+               if (instr->type == nir_instr_type_alu &&
+                   nir_instr_as_alu(instr)->op == nir_op_iadd)
+                  count++;
+            }
+         }
+      }
+      return count;
+   }
+
+   nir_variable *var;
+   nir_function *funcs[3];
+   struct util_queue queue;
+};
+
+static bool
+opt_function(nir_shader *shader, void *data)
+{
+   unsigned *count = (unsigned *)data;
+   p_atomic_inc(count);
+
+   bool progress = false;
+   NIR_PASS(progress, shader, nir_opt_algebraic);
+   NIR_PASS(progress, shader, nir_opt_dce);
+   return progress;
+}
+
+TEST_F(nir_parallel_functions_test, optimize)
+{
+   build_body(b->impl);
+   nir_call(b, funcs[0]);
+   for (unsigned i = 0; i < ARRAY_SIZE(funcs); i++)
+      build_body(funcs[i]->impl);
+
+   nir_function_impl *old_impl = funcs[1]->impl;
+   unsigned count = 0;
+
+   ASSERT_TRUE(nir_shader_optimize_functions_parallel(b->shader, &queue,
+                                                      opt_function, &count));
+   ASSERT_EQ(count, 4);
+   ASSERT_EQ(count_iadd(), 0);
+   ASSERT_NE(funcs[1]->impl, old_impl);
+
+   /* The derefs point to the original variable again. */
+   ASSERT_EQ(exec_list_length(&b->shader->variables), 1);
+   nir_foreach_function_impl(impl, b->shader) {
+      nir_foreach_block(block, impl) {
+         nir_foreach_instr(instr, block) {
+            if (instr->type == nir_instr_type_deref)
+               ASSERT_EQ(nir_instr_as_deref(instr)->var, var);
+         }
+      }
+   }
+
+   nir_validate_shader(b->shader, "after parallel optimization");
+
+   /* Nothing left to do. */
+   count = 0;
+   ASSERT_FALSE(nir_shader_optimize_functions_parallel(b->shader, &queue,
+                                                       opt_function, &count));
+   ASSERT_EQ(count, 4);
+}
+
+TEST_F(nir_parallel_functions_test, no_queue)
+{
+   for (unsigned i = 0; i < ARRAY_SIZE(funcs); i++)
+      build_body(funcs[i]->impl);
+
+   /* Without a queue the callback just runs on the whole shader. */
+   unsigned count = 0;
+   ASSERT_TRUE(nir_shader_optimize_functions_parallel(b->shader, NULL,
+                                                      opt_function, &count));
+   ASSERT_EQ(count, 1);
+   ASSERT_EQ(count_iadd(), 0);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2024 Valve Corporation
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir_test.h"
+
+class nir_pass_tracker_test : public nir_test {
+protected:
+   nir_pass_tracker_test()
+      : nir_test::nir_test("nir_pass_tracker_test")
+   {
+      nir_pass_tracker_init(&tracker);
+
+      nir_function *func = nir_function_create(b->shader, "other");
+      other = nir_function_impl_create(func);
+   }
+
+   ~nir_pass_tracker_test()
+   {
+      nir_pass_tracker_fini(&tracker);
+   }
+
+   nir_pass_tracker tracker;
+   nir_function_impl *other;
+};
+
+/* Counts the impls it visits and never makes progress. */
+static bool
+count_dirty_impls(nir_shader *shader, unsigned *count)
+{
+   nir_foreach_dirty_function_impl(impl, shader) {
+      (*count)++;
+      nir_metadata_preserve(impl, nir_metadata_all);
+   }
+
+   return false;
+}
+
+/* Pretends to modify one impl. */
+static bool
+touch_impl(nir_shader *shader, nir_function_impl *touched)
+{
+   nir_foreach_function_impl(impl, shader) {
+      if (impl == touched)
+         nir_metadata_preserve(impl, nir_metadata_block_index);
+      else
+         nir_metadata_preserve(impl, nir_metadata_all);
+   }
+
+   return true;
+}
+
+/* Makes progress without touching any impl. */
+static bool
+touch_shader_info(nir_shader *shader)
+{
+   shader->info.num_ssbos++;
+   nir_shader_preserve_all_metadata(shader);
+   return true;
+}
+
+TEST_F(nir_pass_tracker_test, skip_unchanged)
+{
+   unsigned count = 0;
+   bool progress = false;
+
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, count_dirty_impls, &count);
+   ASSERT_EQ(count, 2);
+
+   /* Nothing changed, so the pass isn't run again. */
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, count_dirty_impls, &count);
+   ASSERT_EQ(count, 2);
+   ASSERT_FALSE(progress);
+}
+
+TEST_F(nir_pass_tracker_test, only_dirty_impls)
+{
+   unsigned count = 0;
+   bool progress = false;
+
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, count_dirty_impls, &count);
+   ASSERT_EQ(count, 2);
+
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, touch_impl, other);
+   ASSERT_TRUE(progress);
+
+   /* Only the touched impl is visited again. */
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, count_dirty_impls, &count);
+   ASSERT_EQ(count, 3);
+
+   /* Outside of a tracker, every impl is visited. */
+   NIR_PASS(progress, b->shader, count_dirty_impls, &count);
+   ASSERT_EQ(count, 5);
+}
+
+TEST_F(nir_pass_tracker_test, shader_level_progress)
+{
+   unsigned count = 0;
+   bool progress = false;
+
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, count_dirty_impls, &count);
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, touch_shader_info);
+   ASSERT_TRUE(progress);
+
+   /* Progress which didn't touch any impl marks all of them as changed. */
+   NIR_TRACKED_PASS(progress, &tracker, b->shader, count_dirty_impls, &count);
+   ASSERT_EQ(count, 4);
+}
+
+TEST_F(nir_pass_tracker_test, not_idempotent)
+{
+   bool progress = false;
+   uint64_t seq = b->shader->change_seq;
+
+   NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, b->shader, touch_impl, other);
+   ASSERT_GT(b->shader->change_seq, seq);
+   seq = b->shader->change_seq;
+
+   /* A non-idempotent pass which made progress is run again. */
+   NIR_TRACKED_PASS_NOT_IDEMPOTENT(progress, &tracker, b->shader, touch_impl, other);
+   ASSERT_GT(b->shader->change_seq, seq);
+}
@@ -377,6 +377,20 @@ typedef struct shader_info {
      */
    bool use_legacy_math_rules;
 
+   /**
+    * Number of loop unrolls, function inlines and nir_opt_gcm value
+    * numbering runs skipped because the shader's nir_compile_budget ran out.
+    */
+   uint16_t budget_skipped_unrolls;
+   uint16_t budget_skipped_inlines;
+   uint16_t budget_skipped_gcm;
+
+   /**
+    * Bytes of varyings per vertex that nir_opt_varyings removed from the
+    * output of this shader, see nir_varying_bytes_per_vertex().
+    */
+   uint16_t opt_varyings_bytes_saved;
+
    union {
       struct {
          /* Which inputs are doubles */
@@ -394,10 +394,10 @@ vtn_build_cfg(struct vtn_builder *b, const uint32_t *words, const uint32_t *end)
    vtn_foreach_instruction(b, words, end,
                            vtn_cfg_handle_prepass_instruction);
 
-   if (b->shader->info.stage == MESA_SHADER_KERNEL)
-      return;
-
-   vtn_build_structured_cfg(b, words, end);
+   /* The structured control flow of each function is only analyzed once it
+    * is emitted, so functions which aren't reachable from the entry point
+    * cost no more than the prepass.
+    */
 }
 
 bool
@@ -638,6 +638,7 @@ vtn_function_emit(struct vtn_builder *b, struct vtn_function *func,
       impl->structured = false;
       vtn_emit_cf_func_unstructured(b, func, instruction_handler);
    } else {
+      vtn_build_structured_cfg(b, func);
       vtn_emit_cf_func_structured(b, func, instruction_handler);
    }
 
@@ -374,6 +374,10 @@ struct dri2_egl_surface {
       __DRIimage *dri_image;
       /* for is_different_gpu case. NULL else */
       __DRIimage *linear_copy;
+      /* Bounding box (x0, y0, x1, y1) of what changed in dri_image since
+       * linear_copy was last updated, empty if x0 >= x1.
+       */
+      int linear_damage[4];
       /* for swrast */
       void *data;
       int data_size;
@@ -1463,6 +1463,78 @@ try_damage_buffer(struct dri2_egl_surface *dri2_surf, const EGLint *rects,
    return EGL_TRUE;
 }
 
+/**
+ * Update the linear copy of the current buffer for the is_different_gpu
+ * case.
+ *
+ * The linear copy still holds what was presented the last time the buffer
+ * was used, so only the damage of all the swaps since then has to be copied,
+ * which is why the damage of every swap is added to all the buffers.
+ */
+static void
+update_linear_copy(struct dri2_egl_surface *dri2_surf, const EGLint *rects,
+                   EGLint n_rects, bool new_buffer)
+{
+   struct dri2_egl_display *dri2_dpy =
+      dri2_egl_display(dri2_surf->base.Resource.Display);
+   _EGLContext *ctx = _eglGetCurrentContext();
+   struct dri2_egl_context *dri2_ctx = dri2_egl_context(ctx);
+   int box[4] = {0, 0, INT_MAX, INT_MAX};
+
+   if (n_rects > 0) {
+      box[0] = box[1] = INT_MAX;
+      box[2] = box[3] = INT_MIN;
+
+      for (int i = 0; i < n_rects; i++) {
+         const int *rect = &rects[i * 4];
+         const int y = dri2_surf->base.Height - rect[1] - rect[3];
+
+         box[0] = MIN2(box[0], rect[0]);
+         box[1] = MIN2(box[1], y);
+         box[2] = MAX2(box[2], rect[0] + rect[2]);
+         box[3] = MAX2(box[3], y + rect[3]);
+      }
+   }
+
+   for (int i = 0; i < ARRAY_SIZE(dri2_surf->color_buffers); i++) {
+      int *damage = dri2_surf->color_buffers[i].linear_damage;
+
+      if (!dri2_surf->color_buffers[i].linear_copy)
+         continue;
+
+      if (damage[0] >= damage[2]) {
+         memcpy(damage, box, sizeof(box));
+      } else {
+         damage[0] = MIN2(damage[0], box[0]);
+         damage[1] = MIN2(damage[1], box[1]);
+         damage[2] = MAX2(damage[2], box[2]);
+         damage[3] = MAX2(damage[3], box[3]);
+      }
+   }
+
+   int *damage = dri2_surf->current->linear_damage;
+
+   /* The image content is new, so is the linear copy's */
+   if (new_buffer) {
+      damage[0] = damage[1] = 0;
+      damage[2] = damage[3] = INT_MAX;
+   }
+
+   const int x0 = MAX2(damage[0], 0);
+   const int y0 = MAX2(damage[1], 0);
+   const int x1 = MIN2(damage[2], dri2_surf->base.Width);
+   const int y1 = MIN2(damage[3], dri2_surf->base.Height);
+
+   if (x0 < x1 && y0 < y1) {
+      dri2_dpy->image->blitImage(
+         dri2_ctx->dri_context, dri2_surf->current->linear_copy,
+         dri2_surf->current->dri_image, x0, y0, x1 - x0, y1 - y0,
+         x0, y0, x1 - x0, y1 - y0, 0);
+   }
+
+   damage[0] = damage[2] = 0;
+}
+
 /**
  * Called via eglSwapBuffers(), drv->SwapBuffers().
  */
@@ -1510,6 +1582,8 @@ dri2_wl_swap_buffers_with_damage(_EGLDisplay *disp, _EGLSurface *draw,
                                dri2_surf);
    }
 
+   const bool new_buffer = dri2_surf->back->age == 0;
+
    dri2_surf->back->age = 1;
    dri2_surf->current = dri2_surf->back;
    dri2_surf->back = NULL;
@@ -1552,13 +1626,7 @@ dri2_wl_swap_buffers_with_damage(_EGLDisplay *disp, _EGLSurface *draw,
                         INT32_MAX);
 
    if (dri2_dpy->fd_render_gpu != dri2_dpy->fd_display_gpu) {
-      _EGLContext *ctx = _eglGetCurrentContext();
-      struct dri2_egl_context *dri2_ctx = dri2_egl_context(ctx);
-      dri2_dpy->image->blitImage(
-         dri2_ctx->dri_context, dri2_surf->current->linear_copy,
-         dri2_surf->current->dri_image, 0, 0, dri2_surf->base.Width,
-         dri2_surf->base.Height, 0, 0, dri2_surf->base.Width,
-         dri2_surf->base.Height, 0);
+      update_linear_copy(dri2_surf, rects, n_rects, new_buffer);
 
       if (dri2_dpy->flush) {
          __DRIdrawable *dri_drawable = dri2_dpy->vtbl->get_dri_drawable(draw);
@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2024 Igalia S.L.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "freedreno_autotune_timing.h"
+
+#include "util/u_atomic.h"
+
+/* How many timings of a mode are needed before it is trusted. */
+#define TIMING_MIN_SAMPLES 3
+
+/* The other mode has to be this much faster (in percent) before we switch
+ * over to it, to avoid flip-flopping between two modes of similar cost.
+ */
+#define TIMING_SWITCH_MARGIN 5
+
+/* Every this many uses, the slower mode is run once more to refresh its
+ * timing.  Must be a power of two.
+ */
+#define TIMING_REEXPLORE_PERIOD 256
+
+void
+fd_autotune_timing_init(struct fd_autotune_timing *timing)
+{
+   *timing = (struct fd_autotune_timing) {
+      .explore = -1,
+      .preferred = -1,
+   };
+}
+
+static bool
+faster(uint64_t a, uint64_t b, unsigned margin)
+{
+   return a * 100 < b * (100 - margin);
+}
+
+void
+fd_autotune_timing_add(struct fd_autotune_timing *timing,
+                       enum fd_autotune_mode mode, uint64_t time)
+{
+   /* A zero time means the counters were not written (or wrapped). */
+   if (!time)
+      return;
+
+   if (!timing->samples[mode]) {
+      timing->avg_time[mode] = time;
+   } else {
+      /* Exponential moving average, recent results matter more: */
+      timing->avg_time[mode] = (timing->avg_time[mode] * 3 + time) / 4;
+   }
+
+   if (timing->samples[mode] < TIMING_MIN_SAMPLES)
+      timing->samples[mode]++;
+
+   const bool have_gmem =
+      timing->samples[FD_AUTOTUNE_MODE_GMEM] >= TIMING_MIN_SAMPLES;
+   const bool have_sysmem =
+      timing->samples[FD_AUTOTUNE_MODE_SYSMEM] >= TIMING_MIN_SAMPLES;
+
+   int32_t explore = -1, preferred = p_atomic_read(&timing->preferred);
+
+   if (have_gmem && have_sysmem) {
+      const uint64_t gmem = timing->avg_time[FD_AUTOTUNE_MODE_GMEM];
+      const uint64_t sysmem = timing->avg_time[FD_AUTOTUNE_MODE_SYSMEM];
+
+      if (preferred == FD_AUTOTUNE_MODE_GMEM) {
+         if (faster(sysmem, gmem, TIMING_SWITCH_MARGIN))
+            preferred = FD_AUTOTUNE_MODE_SYSMEM;
+      } else if (preferred == FD_AUTOTUNE_MODE_SYSMEM) {
+         if (faster(gmem, sysmem, TIMING_SWITCH_MARGIN))
+            preferred = FD_AUTOTUNE_MODE_GMEM;
+      } else {
+         preferred = sysmem <= gmem ? FD_AUTOTUNE_MODE_SYSMEM
+                                    : FD_AUTOTUNE_MODE_GMEM;
+      }
+   } else if (have_gmem) {
+      explore = FD_AUTOTUNE_MODE_SYSMEM;
+   } else if (have_sysmem) {
+      explore = FD_AUTOTUNE_MODE_GMEM;
+   }
+
+   p_atomic_set(&timing->explore, explore);
+   p_atomic_set(&timing->preferred, preferred);
+}
+
+/**
+ * Returns the mode to use for the next instance of the render pass, given
+ * the mode the driver's heuristic picked.  This may be called concurrently
+ * with itself and with fd_autotune_timing_add() without locking.
+ */
+enum fd_autotune_mode
+fd_autotune_timing_choose(struct fd_autotune_timing *timing,
+                          enum fd_autotune_mode heuristic)
+{
+   const int32_t explore = p_atomic_read(&timing->explore);
+   if (explore >= 0)
+      return (enum fd_autotune_mode)explore;
+
+   const int32_t preferred = p_atomic_read(&timing->preferred);
+   if (preferred < 0)
+      return heuristic;
+
+   const uint32_t uses = p_atomic_inc_return(&timing->uses);
+   if ((uses & (TIMING_REEXPLORE_PERIOD - 1)) == 0)
+      return preferred == FD_AUTOTUNE_MODE_GMEM ? FD_AUTOTUNE_MODE_SYSMEM
+                                                : FD_AUTOTUNE_MODE_GMEM;
+
+   return (enum fd_autotune_mode)preferred;
+}
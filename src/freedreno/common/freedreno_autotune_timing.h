@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2024 Igalia S.L.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __FREEDRENO_AUTOTUNE_TIMING_H__
+#define __FREEDRENO_AUTOTUNE_TIMING_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Measurement based GMEM vs sysmem selection, usable by both the gallium and
+ * vulkan drivers.
+ *
+ * The driver's own heuristics (sample counts, draw counts, bandwidth
+ * estimates) are a guess.  Once a render target has been seen often enough
+ * we can do better by simply measuring: the driver records the GPU time the
+ * render pass took in the mode it used, and fd_autotune_timing_choose()
+ * makes the heuristic run the pass in the other mode for a few times, then
+ * sticks with whichever mode was faster.  The losing mode is retried every
+ * now and then so that a change in the workload of the pass is noticed.
+ *
+ * Times are in whatever unit the driver likes (ie. always-on counter ticks),
+ * they are only ever compared against each other.
+ */
+
+enum fd_autotune_mode {
+   FD_AUTOTUNE_MODE_GMEM,
+   FD_AUTOTUNE_MODE_SYSMEM,
+   FD_AUTOTUNE_MODE_COUNT,
+};
+
+struct fd_autotune_timing {
+   /* Only accessed by fd_autotune_timing_add(): */
+   uint64_t avg_time[FD_AUTOTUNE_MODE_COUNT];
+   uint32_t samples[FD_AUTOTUNE_MODE_COUNT];
+
+   /* Result of the last fd_autotune_timing_add(), read without locking by
+    * fd_autotune_timing_choose().  -1 or an fd_autotune_mode.
+    */
+   int32_t explore;
+   int32_t preferred;
+
+   uint32_t uses;
+};
+
+void
+fd_autotune_timing_init(struct fd_autotune_timing *timing);
+
+void
+fd_autotune_timing_add(struct fd_autotune_timing *timing,
+                       enum fd_autotune_mode mode, uint64_t time);
+
+enum fd_autotune_mode
+fd_autotune_timing_choose(struct fd_autotune_timing *timing,
+                          enum fd_autotune_mode heuristic);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FREEDRENO_AUTOTUNE_TIMING_H__ */
@@ -17,6 +17,7 @@
 #include "util/log.h"
 #include "util/u_atomic.h"
 #include "util/u_debug.h"
+#include "util/u_dynarray.h"
 
 #ifdef ANDROID
 static const char *fd_rd_output_base_path = "/data/local/tmp";
@@ -29,9 +30,15 @@ static const struct debug_control fd_rd_dump_options[] = {
    { "combine", FD_RD_DUMP_COMBINE },
    { "full", FD_RD_DUMP_FULL },
    { "trigger", FD_RD_DUMP_TRIGGER },
+   { "ring", FD_RD_DUMP_RING },
    { NULL, 0 }
 };
 
+struct fd_rd_ring_entry {
+   /* gzip member of the submit's sections, empty if unused */
+   struct util_dynarray data;
+};
+
 struct fd_rd_dump_env fd_rd_dump_env;
 
 static void
@@ -84,8 +91,30 @@ fd_rd_output_init(struct fd_rd_output *output, char* output_name)
    output->file = NULL;
    output->trigger_fd = -1;
    output->trigger_count = 0;
-
-   if (FD_RD_DUMP(COMBINE)) {
+   output->ring = NULL;
+
+   if (FD_RD_DUMP(RING)) {
+      output->ring_size =
+         MAX2(debug_get_num_option("FD_RD_DUMP_RING_SIZE", 8), 1);
+      output->ring_next = 0;
+      output->ring_dump_count = 0;
+      output->ring = (struct fd_rd_ring_entry *)
+         calloc(output->ring_size, sizeof(*output->ring));
+      for (uint32_t i = 0; i < output->ring_size; i++)
+         util_dynarray_init(&output->ring[i].data, NULL);
+
+      /* windowBits + 16 makes zlib produce gzip members, which concatenated
+       * are a valid gzip file, so the ring can be dumped without
+       * recompressing anything.
+       */
+      memset(&output->ring_stream, 0, sizeof(output->ring_stream));
+      ASSERTED int ret = deflateInit2(&output->ring_stream, Z_BEST_SPEED,
+                                      Z_DEFLATED, 15 + 16, 8,
+                                      Z_DEFAULT_STRATEGY);
+      assert(ret == Z_OK);
+
+      mtx_init(&output->ring_lock, mtx_plain);
+   } else if (FD_RD_DUMP(COMBINE)) {
       output->combine = true;
 
       char file_path[PATH_MAX];
@@ -113,6 +142,14 @@ fd_rd_output_fini(struct fd_rd_output *output)
       gzclose(output->file);
    }
 
+   if (output->ring != NULL) {
+      for (uint32_t i = 0; i < output->ring_size; i++)
+         util_dynarray_fini(&output->ring[i].data);
+      free(output->ring);
+      deflateEnd(&output->ring_stream);
+      mtx_destroy(&output->ring_lock);
+   }
+
    if (output->trigger_fd >= 0) {
       close(output->trigger_fd);
 
@@ -191,9 +228,108 @@ fd_rd_output_update_trigger_count(struct fd_rd_output *output)
    }
 }
 
+static void
+fd_rd_output_dump_ring_locked(struct fd_rd_output *output)
+{
+   char file_path[PATH_MAX];
+   snprintf(file_path, sizeof(file_path), "%s/%s_ring_%.5d.rd",
+            fd_rd_output_base_path, output->name, output->ring_dump_count++);
+
+   FILE *file = fopen(file_path, "wb");
+   if (!file) {
+      mesa_loge("[fd_rd_output] failed to open %s", file_path);
+      return;
+   }
+
+   /* Oldest submit first, ring_next is the next slot to be overwritten. */
+   uint32_t count = 0;
+   for (uint32_t i = 0; i < output->ring_size; i++) {
+      struct fd_rd_ring_entry *entry =
+         &output->ring[(output->ring_next + i) % output->ring_size];
+      if (!entry->data.size)
+         continue;
+
+      if (fwrite(entry->data.data, entry->data.size, 1, file) != 1) {
+         mesa_loge("[fd_rd_output] failed to write to %s", file_path);
+         break;
+      }
+      count++;
+   }
+
+   fclose(file);
+   mesa_logi("[fd_rd_output] dumped last %u submissions to %s", count,
+             file_path);
+}
+
+/**
+ * Write out the submits currently in the ring, ie. when the GPU hung.
+ */
+void
+fd_rd_output_dump_ring(struct fd_rd_output *output)
+{
+   if (!output->ring)
+      return;
+
+   mtx_lock(&output->ring_lock);
+   fd_rd_output_dump_ring_locked(output);
+   mtx_unlock(&output->ring_lock);
+}
+
+static bool
+fd_rd_output_begin_ring(struct fd_rd_output *output)
+{
+   mtx_lock(&output->ring_lock);
+
+   /* With the ring, the trigger requests a dump of what has been recorded
+    * so far instead of enabling dumps of the following submits.
+    */
+   if (FD_RD_DUMP(TRIGGER)) {
+      fd_rd_output_update_trigger_count(output);
+      if (output->trigger_count) {
+         fd_rd_output_dump_ring_locked(output);
+         output->trigger_count = 0;
+      }
+   }
+
+   struct fd_rd_ring_entry *entry = &output->ring[output->ring_next];
+   util_dynarray_clear(&entry->data);
+   deflateReset(&output->ring_stream);
+
+   return true;
+}
+
+static void
+fd_rd_output_deflate_ring(struct fd_rd_output *output, const void *buffer,
+                          int size, int flush)
+{
+   struct fd_rd_ring_entry *entry = &output->ring[output->ring_next];
+   z_stream *stream = &output->ring_stream;
+
+   stream->next_in = (Bytef *) buffer;
+   stream->avail_in = size;
+
+   int ret;
+   do {
+      if (!util_dynarray_ensure_cap(&entry->data, entry->data.size + 64 * 1024)) {
+         mesa_loge("[fd_rd_output] failed to grow ring entry");
+         return;
+      }
+
+      stream->next_out = (Bytef *) entry->data.data + entry->data.size;
+      stream->avail_out = entry->data.capacity - entry->data.size;
+
+      ret = deflate(stream, flush);
+
+      entry->data.size = entry->data.capacity - stream->avail_out;
+   } while (flush == Z_FINISH ? ret == Z_OK : stream->avail_in > 0);
+}
+
 bool
 fd_rd_output_begin(struct fd_rd_output *output, uint32_t submit_idx)
 {
+   if (output->ring)
+      return fd_rd_output_begin_ring(output);
+
    assert(output->combine ^ (output->file == NULL));
 
    if (FD_RD_DUMP(TRIGGER)) {
@@ -219,6 +355,11 @@ fd_rd_output_begin(struct fd_rd_output *output, uint32_t submit_idx)
 static void
 fd_rd_output_write(struct fd_rd_output *output, const void *buffer, int size)
 {
+   if (output->ring) {
+      fd_rd_output_deflate_ring(output, buffer, size, Z_NO_FLUSH);
+      return;
+   }
+
    const uint8_t *pos = (uint8_t *) buffer;
    while (size > 0) {
       int ret = gzwrite(output->file, pos, size);
@@ -244,6 +385,13 @@ fd_rd_output_write_section(struct fd_rd_output *output, enum rd_sect_type type,
 void
 fd_rd_output_end(struct fd_rd_output *output)
 {
+   if (output->ring) {
+      fd_rd_output_deflate_ring(output, NULL, 0, Z_FINISH);
+      output->ring_next = (output->ring_next + 1) % output->ring_size;
+      mtx_unlock(&output->ring_lock);
+      return;
+   }
+
    assert(output->file != NULL);
 
    /* When combining output, flush the gzip stream on each submit. This should
@@ -10,6 +10,8 @@
 #include <stdint.h>
 #include <zlib.h>
 
+#include "c11/threads.h"
+
 #include "redump.h"
 
 #ifdef __cplusplus
@@ -21,6 +23,7 @@ enum fd_rd_dump_flags {
    FD_RD_DUMP_COMBINE = 1 << 1,
    FD_RD_DUMP_FULL = 1 << 2,
    FD_RD_DUMP_TRIGGER = 1 << 3,
+   FD_RD_DUMP_RING = 1 << 4,
 };
 
 struct fd_rd_dump_env {
@@ -34,6 +37,8 @@ extern struct fd_rd_dump_env fd_rd_dump_env;
 void
 fd_rd_dump_env_init(void);
 
+struct fd_rd_ring_entry;
+
 struct fd_rd_output {
    char *name;
    bool combine;
@@ -41,6 +46,17 @@ struct fd_rd_output {
 
    int trigger_fd;
    uint32_t trigger_count;
+
+   /* FD_RD_DUMP(RING): the last ring_size submits are kept in memory, each
+    * compressed into its own gzip member, and only written out by
+    * fd_rd_output_dump_ring().
+    */
+   struct fd_rd_ring_entry *ring;
+   uint32_t ring_size;
+   uint32_t ring_next;
+   uint32_t ring_dump_count;
+   z_stream ring_stream;
+   mtx_t ring_lock;
 };
 
 void
@@ -59,6 +75,9 @@ fd_rd_output_write_section(struct fd_rd_output *output, enum rd_sect_type type,
 void
 fd_rd_output_end(struct fd_rd_output *output);
 
+void
+fd_rd_output_dump_ring(struct fd_rd_output *output);
+
 #ifdef __cplusplus
 }
 #endif
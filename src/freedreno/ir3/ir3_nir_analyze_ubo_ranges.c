@@ -27,6 +27,39 @@
 #include "ir3_compiler.h"
 #include "ir3_nir.h"
 
+/* Largest range we try to push for an indirect UBO load whose range NIR
+ * doesn't know, but which we can bound ourselves.  Anything bigger would
+ * likely crowd out more useful directly accessed ranges.
+ */
+#define MAX_BOUNDED_INDIRECT_RANGE 1024
+
+/* For an indirect load_ubo which NIR couldn't come up with a range for,
+ * try to bound the offset with range analysis (ie. a loop counter or an
+ * index masked to a small value).
+ */
+static bool
+get_bounded_indirect_range(nir_shader *nir, nir_intrinsic_instr *instr,
+                           uint32_t *offset, uint32_t *size)
+{
+   if (instr->intrinsic != nir_intrinsic_load_ubo)
+      return false;
+
+   struct hash_table *range_ht = _mesa_pointer_hash_table_create(NULL);
+   uint32_t ub = nir_unsigned_upper_bound(
+      nir, range_ht, nir_get_scalar(instr->src[1].ssa, 0), NULL);
+   _mesa_hash_table_destroy(range_ht, NULL);
+
+   const uint32_t load_size = nir_intrinsic_dest_components(instr) *
+                              instr->def.bit_size / 8;
+   if (ub >= MAX_BOUNDED_INDIRECT_RANGE ||
+       ub + load_size > MAX_BOUNDED_INDIRECT_RANGE)
+      return false;
+
+   *offset = 0;
+   *size = ub + load_size;
+   return true;
+}
+
 static inline bool
 get_ubo_load_range(nir_shader *nir, nir_intrinsic_instr *instr,
                    uint32_t alignment, struct ir3_ubo_range *r)
@@ -50,7 +83,7 @@ get_ubo_load_range(nir_shader *nir, nir_intrinsic_instr *instr,
    }
 
    /* If we haven't figured out the range accessed in the UBO, bail. */
-   if (size == ~0)
+   if (size == ~0 && !get_bounded_indirect_range(nir, instr, &offset, &size))
       return false;
 
    r->start = ROUND_DOWN_TO(offset, alignment * 16);
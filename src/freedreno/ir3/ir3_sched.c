@@ -25,6 +25,7 @@
  */
 
 #include "util/dag.h"
+#include "util/u_dynarray.h"
 #include "util/u_math.h"
 
 #include "ir3.h"
@@ -1305,23 +1306,23 @@ depends_on(struct ir3_instruction *instr, struct ir3_instruction *prior)
    return false;
 }
 
+/* Add the barrier dependencies of 'instr', which has all the barrier related
+ * instructions of the block before it in prior[0..n_prior) and after it in
+ * later[0..n_later), in program order.  Instructions which neither have a
+ * barrier_class nor conflict with one can not depend on anything, so only
+ * looking at those avoids walking the whole block from every barrier, which
+ * adds up quickly in large compute shaders.
+ */
 static void
-add_barrier_deps(struct ir3_block *block, struct ir3_instruction *instr)
+add_barrier_deps(struct ir3_instruction *instr,
+                 struct ir3_instruction **prior, unsigned n_prior,
+                 struct ir3_instruction **later, unsigned n_later)
 {
-   struct list_head *prev = instr->node.prev;
-   struct list_head *next = instr->node.next;
-
    /* add dependencies on previous instructions that must be scheduled
     * prior to the current instruction
     */
-   while (prev != &block->instr_list) {
-      struct ir3_instruction *pi =
-         list_entry(prev, struct ir3_instruction, node);
-
-      prev = prev->prev;
-
-      if (is_meta(pi))
-         continue;
+   for (unsigned i = n_prior; i-- > 0;) {
+      struct ir3_instruction *pi = prior[i];
 
       if (instr->barrier_class == pi->barrier_class) {
          ir3_instr_add_dep(instr, pi);
@@ -1335,14 +1336,8 @@ add_barrier_deps(struct ir3_block *block, struct ir3_instruction *instr)
    /* add dependencies on this instruction to following instructions
     * that must be scheduled after the current instruction:
     */
-   while (next != &block->instr_list) {
-      struct ir3_instruction *ni =
-         list_entry(next, struct ir3_instruction, node);
-
-      next = next->next;
-
-      if (is_meta(ni))
-         continue;
+   for (unsigned i = 0; i < n_later; i++) {
+      struct ir3_instruction *ni = later[i];
 
       if (instr->barrier_class == ni->barrier_class) {
          ir3_instr_add_dep(ni, instr);
@@ -1367,15 +1362,39 @@ bool
 ir3_sched_add_deps(struct ir3 *ir)
 {
    bool progress = false;
+   struct util_dynarray barriers;
+
+   util_dynarray_init(&barriers, NULL);
 
    foreach_block (block, &ir->block_list) {
+      util_dynarray_clear(&barriers);
+
+      foreach_instr (instr, &block->instr_list) {
+         if (!is_meta(instr) && (instr->barrier_class || instr->barrier_conflict))
+            util_dynarray_append(&barriers, struct ir3_instruction *, instr);
+      }
+
+      struct ir3_instruction **instrs = barriers.data;
+      unsigned count =
+         util_dynarray_num_elements(&barriers, struct ir3_instruction *);
+      unsigned idx = 0;
+
       foreach_instr (instr, &block->instr_list) {
+         /* Index of the next barrier related instruction in the block: */
+         bool listed = idx < count && instrs[idx] == instr;
+
          if (instr->barrier_class) {
-            add_barrier_deps(block, instr);
+            unsigned next = listed ? idx + 1 : idx;
+            add_barrier_deps(instr, instrs, idx, instrs + next, count - next);
             progress = true;
          }
+
+         if (listed)
+            idx++;
       }
    }
 
+   util_dynarray_fini(&barriers);
+
    return progress;
 }
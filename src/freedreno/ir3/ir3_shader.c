@@ -392,6 +392,18 @@ shader_variant(struct ir3_shader *shader, const struct ir3_shader_key *key)
    return NULL;
 }
 
+/* Like ir3_shader_get_variant(), but never compiles a new variant. */
+struct ir3_shader_variant *
+ir3_shader_lookup_variant(struct ir3_shader *shader,
+                          const struct ir3_shader_key *key)
+{
+   mtx_lock(&shader->variants_lock);
+   struct ir3_shader_variant *v = shader_variant(shader, key);
+   mtx_unlock(&shader->variants_lock);
+
+   return v;
+}
+
 struct ir3_shader_variant *
 ir3_shader_get_variant(struct ir3_shader *shader,
                        const struct ir3_shader_key *key, bool binning_pass,
@@ -15,6 +15,10 @@
  *
  * - For each renderpass we calculate the number of samples passed
  *   by storing the number before and after in GPU memory.
+ * - Likewise the always-on counter is stored at the start and end of the
+ *   renderpass, so that once both GMEM and sysmem rendering of a given
+ *   renderpass have been timed, the faster one is picked regardless of
+ *   what the bandwidth estimate says (see freedreno_autotune_timing.h).
  * - To store the values each command buffer holds GPU memory which
  *   expands with more renderpasses being written.
  * - For each renderpass we create tu_renderpass_result entry which
@@ -72,6 +76,8 @@ struct tu_renderpass_history {
    uint32_t num_results;
 
    uint32_t avg_samples;
+
+   struct fd_autotune_timing timing;
 };
 
 /* Holds per-submission cs which writes the fence. */
@@ -223,6 +229,31 @@ get_history(struct tu_autotune *at, uint64_t rp_key, uint32_t *avg_samples)
    return has_history;
 }
 
+/* Let the measured GPU time of earlier instances of the renderpass override
+ * the heuristic once we have timings for both modes.
+ */
+static bool
+timing_use_bypass(struct tu_autotune *at, uint64_t rp_key, bool heuristic)
+{
+   enum fd_autotune_mode mode =
+      heuristic ? FD_AUTOTUNE_MODE_SYSMEM : FD_AUTOTUNE_MODE_GMEM;
+
+   u_rwlock_rdlock(&at->ht_lock);
+   struct hash_entry *entry =
+      _mesa_hash_table_search(at->ht, &rp_key);
+   if (entry) {
+      struct tu_renderpass_history *history =
+         (struct tu_renderpass_history *) entry->data;
+      mode = fd_autotune_timing_choose(&history->timing, mode);
+   }
+   u_rwlock_rdunlock(&at->ht_lock);
+
+   if (TU_AUTOTUNE_DEBUG_LOG && (mode == FD_AUTOTUNE_MODE_SYSMEM) != heuristic)
+      mesa_logi("autotune %016" PRIx64 " timing overrides heuristic", rp_key);
+
+   return mode == FD_AUTOTUNE_MODE_SYSMEM;
+}
+
 static struct tu_renderpass_result *
 create_history_result(struct tu_autotune *at, uint64_t rp_key)
 {
@@ -277,6 +308,12 @@ process_results(struct tu_autotune *at, uint32_t current_fence)
       struct tu_renderpass_history *history = result->history;
       result->samples_passed =
          result->samples->samples_end - result->samples->samples_start;
+      result->time = result->samples->ts_end - result->samples->ts_start;
+
+      fd_autotune_timing_add(&history->timing,
+                             result->sysmem ? FD_AUTOTUNE_MODE_SYSMEM
+                                            : FD_AUTOTUNE_MODE_GMEM,
+                             result->time);
 
       history_add_result(dev, history, result);
    }
@@ -342,6 +379,7 @@ tu_autotune_on_submit(struct tu_device *dev,
                (struct tu_renderpass_history *) calloc(1, sizeof(*history));
             history->key = result->rp_key;
             list_inithead(&history->results);
+            fd_autotune_timing_init(&history->timing);
 
             u_rwlock_wrlock(&at->ht_lock);
             _mesa_hash_table_insert(at->ht, &history->key, history);
@@ -441,8 +479,11 @@ tu_autotune_fini(struct tu_autotune *at, struct tu_device *dev)
          struct tu_renderpass_history *history =
             (struct tu_renderpass_history *) entry->data;
 
-         mesa_logi("%016" PRIx64 " \tavg_passed=%u results=%u",
-                   history->key, history->avg_samples, history->num_results);
+         mesa_logi("%016" PRIx64 " \tavg_passed=%u results=%u "
+                   "gmem_time=%" PRIu64 " sysmem_time=%" PRIu64,
+                   history->key, history->avg_samples, history->num_results,
+                   history->timing.avg_time[FD_AUTOTUNE_MODE_GMEM],
+                   history->timing.avg_time[FD_AUTOTUNE_MODE_SYSMEM]);
       }
    }
 
@@ -589,6 +630,7 @@ tu_autotune_use_bypass(struct tu_autotune *at,
 
    *autotune_result = create_history_result(at, renderpass_key);
 
+   bool use_bypass;
    uint32_t avg_samples = 0;
    if (get_history(at, renderpass_key, &avg_samples)) {
       const uint32_t pass_pixel_count =
@@ -633,17 +675,45 @@ tu_autotune_use_bypass(struct tu_autotune *at,
                sysmem_bandwidth, gmem_bandwidth);
       }
 
-      return select_sysmem;
+      use_bypass = select_sysmem;
+   } else {
+      use_bypass = fallback_use_bypass(pass, framebuffer, cmd_buffer);
    }
 
-   return fallback_use_bypass(pass, framebuffer, cmd_buffer);
+   use_bypass = timing_use_bypass(at, renderpass_key, use_bypass);
+   (*autotune_result)->sysmem = use_bypass;
+
+   return use_bypass;
 }
 
+template <chip CHIP>
+static void
+emit_timestamp(struct tu_cs *cs, uint64_t iova)
+{
+   if (CHIP == A6XX) {
+      tu_cs_emit_pkt7(cs, CP_EVENT_WRITE, 4);
+      tu_cs_emit(cs, CP_EVENT_WRITE_0_EVENT(RB_DONE_TS) |
+                     CP_EVENT_WRITE_0_TIMESTAMP);
+      tu_cs_emit_qw(cs, iova);
+      tu_cs_emit(cs, 0x00000000);
+   } else {
+      tu_cs_emit_pkt7(cs, CP_EVENT_WRITE7, 3);
+      tu_cs_emit(cs, CP_EVENT_WRITE7_0(.event = RB_DONE_TS,
+                                       .write_src = EV_WRITE_ALWAYSON,
+                                       .write_dst = EV_DST_RAM,
+                                       .write_enabled = true).value);
+      tu_cs_emit_qw(cs, iova);
+   }
+}
+
+/* Called before anything else in the renderpass is emitted (ie. before the
+ * binning pass), so that the timing covers the entire cost of a mode.
+ */
 template <chip CHIP>
 void
-tu_autotune_begin_renderpass(struct tu_cmd_buffer *cmd,
-                             struct tu_cs *cs,
-                             struct tu_renderpass_result *autotune_result)
+tu_autotune_begin_timing(struct tu_cmd_buffer *cmd,
+                         struct tu_cs *cs,
+                         struct tu_renderpass_result *autotune_result)
 {
    if (!autotune_result)
       return;
@@ -660,12 +730,46 @@ tu_autotune_begin_renderpass(struct tu_cmd_buffer *cmd,
       return;
    }
 
-   uint64_t result_iova = autotune_result->bo.iova;
-
    autotune_result->samples =
       (struct tu_renderpass_samples *) tu_suballoc_bo_map(
          &autotune_result->bo);
 
+   emit_timestamp<CHIP>(cs, autotune_result->bo.iova +
+                            offsetof(struct tu_renderpass_samples, ts_start));
+}
+TU_GENX(tu_autotune_begin_timing);
+
+template <chip CHIP>
+void
+tu_autotune_end_timing(struct tu_cmd_buffer *cmd,
+                       struct tu_cs *cs,
+                       struct tu_renderpass_result *autotune_result)
+{
+   if (!autotune_result)
+      return;
+
+   if (!autotune_result->bo.iova)
+      return;
+
+   emit_timestamp<CHIP>(cs, autotune_result->bo.iova +
+                            offsetof(struct tu_renderpass_samples, ts_end));
+}
+TU_GENX(tu_autotune_end_timing);
+
+template <chip CHIP>
+void
+tu_autotune_begin_renderpass(struct tu_cmd_buffer *cmd,
+                             struct tu_cs *cs,
+                             struct tu_renderpass_result *autotune_result)
+{
+   if (!autotune_result)
+      return;
+
+   if (!autotune_result->bo.iova)
+      return;
+
+   uint64_t result_iova = autotune_result->bo.iova;
+
    tu_cs_emit_regs(cs, A6XX_RB_SAMPLE_COUNT_CONTROL(.copy = true));
    if (cmd->device->physical_device->info->a7xx.has_event_write_sample_count) {
       tu_cs_emit_pkt7(cs, CP_EVENT_WRITE7, 3);
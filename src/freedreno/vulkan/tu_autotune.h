@@ -13,6 +13,8 @@
 
 #include "tu_suballoc.h"
 
+#include "common/freedreno_autotune_timing.h"
+
 struct tu_renderpass_history;
 
 /**
@@ -96,10 +98,19 @@ struct PACKED tu_renderpass_samples {
    uint64_t __pad0;
    uint64_t samples_end;
    uint64_t __pad1;
+
+   /* Always-on counter at the start and end of the renderpass, used to
+    * compare the cost of GMEM and sysmem rendering.
+    */
+   uint64_t ts_start;
+   uint64_t ts_end;
+   uint64_t __pad2[2];
 };
 
 /* Necessary when writing sample counts using CP_EVENT_WRITE7::ZPASS_DONE. */
 static_assert(offsetof(struct tu_renderpass_samples, samples_end) == 16);
+/* The size is also used as the suballocation alignment, keep it POT. */
+static_assert(sizeof(struct tu_renderpass_samples) == 64);
 
 /**
  * Tracks the results from an individual renderpass. Initially created
@@ -120,6 +131,8 @@ struct tu_renderpass_result {
    struct list_head node;
    uint32_t fence;
    uint64_t samples_passed;
+   uint64_t time;
+   bool sysmem;
 };
 
 VkResult tu_autotune_init(struct tu_autotune *at, struct tu_device *dev);
@@ -144,6 +157,16 @@ struct tu_cs *tu_autotune_on_submit(struct tu_device *dev,
 
 struct tu_autotune_results_buffer;
 
+template <chip CHIP>
+void tu_autotune_begin_timing(struct tu_cmd_buffer *cmd,
+                              struct tu_cs *cs,
+                              struct tu_renderpass_result *autotune_result);
+
+template <chip CHIP>
+void tu_autotune_end_timing(struct tu_cmd_buffer *cmd,
+                            struct tu_cs *cs,
+                            struct tu_renderpass_result *autotune_result);
+
 template <chip CHIP>
 void tu_autotune_begin_renderpass(struct tu_cmd_buffer *cmd,
                                   struct tu_cs *cs,
@@ -108,19 +108,35 @@ tu6_lazy_emit_vsc(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
     * if there hasn't been overflow, there will already be a scratch bo
     * allocated for these sizes
     *
-    * if overflow is detected, the stream size is increased by 2x
+    * if a renderpass used more than half of a stream, or it overflowed,
+    * the stream size is increased by 2x.  Growing at the half-way mark means
+    * that in steady state the stream is already big enough by the time a
+    * renderpass would have overflowed it, unless its binning data more than
+    * doubled from one use to the next.
     */
    mtx_lock(&dev->mutex);
 
    struct tu6_global *global = dev->global_bo_map;
 
    uint32_t vsc_draw_overflow = global->vsc_draw_overflow;
+   uint32_t vsc_draw_high = global->vsc_draw_high;
    uint32_t vsc_prim_overflow = global->vsc_prim_overflow;
+   uint32_t vsc_prim_high = global->vsc_prim_high;
 
-   if (vsc_draw_overflow >= dev->vsc_draw_strm_pitch)
+   if (vsc_draw_overflow >= dev->vsc_draw_strm_pitch ||
+       vsc_prim_overflow >= dev->vsc_prim_strm_pitch) {
+      dev->vsc_overflow_count++;
+      perf_debug(dev, "VSC %s stream overflow (%u so far), binning data lost",
+                 vsc_draw_overflow >= dev->vsc_draw_strm_pitch ? "draw" : "prim",
+                 dev->vsc_overflow_count);
+   }
+
+   if (vsc_draw_overflow >= dev->vsc_draw_strm_pitch ||
+       vsc_draw_high >= dev->vsc_draw_strm_pitch)
       dev->vsc_draw_strm_pitch = (dev->vsc_draw_strm_pitch - VSC_PAD) * 2 + VSC_PAD;
 
-   if (vsc_prim_overflow >= dev->vsc_prim_strm_pitch)
+   if (vsc_prim_overflow >= dev->vsc_prim_strm_pitch ||
+       vsc_prim_high >= dev->vsc_prim_strm_pitch)
       dev->vsc_prim_strm_pitch = (dev->vsc_prim_strm_pitch - VSC_PAD) * 2 + VSC_PAD;
 
    cmd->vsc_prim_strm_pitch = dev->vsc_prim_strm_pitch;
@@ -1419,33 +1435,45 @@ update_vsc_pipe(struct tu_cmd_buffer *cmd,
    tu_cs_emit_regs(cs, A7XX_VSC_UNKNOWN_0D08(0));
 }
 
+/* Write "data" to "iova" if the stream size in "reg" is at least "ref" */
+static void
+emit_vsc_cond_write(struct tu_cs *cs, uint32_t reg, uint32_t ref,
+                    uint64_t iova, uint32_t data)
+{
+   tu_cs_emit_pkt7(cs, CP_COND_WRITE5, 8);
+   tu_cs_emit(cs, CP_COND_WRITE5_0_FUNCTION(WRITE_GE) |
+         CP_COND_WRITE5_0_WRITE_MEMORY);
+   tu_cs_emit(cs, CP_COND_WRITE5_1_POLL_ADDR_LO(reg));
+   tu_cs_emit(cs, CP_COND_WRITE5_2_POLL_ADDR_HI(0));
+   tu_cs_emit(cs, CP_COND_WRITE5_3_REF(ref));
+   tu_cs_emit(cs, CP_COND_WRITE5_4_MASK(~0));
+   tu_cs_emit_qw(cs, iova);
+   tu_cs_emit(cs, CP_COND_WRITE5_7_WRITE_DATA(data));
+}
+
 static void
 emit_vsc_overflow_test(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
 {
    const struct tu_tiling_config *tiling = cmd->state.tiling;
    const uint32_t used_pipe_count =
       tiling->pipe_count.width * tiling->pipe_count.height;
+   const uint32_t draw_limit = cmd->vsc_draw_strm_pitch - VSC_PAD;
+   const uint32_t prim_limit = cmd->vsc_prim_strm_pitch - VSC_PAD;
 
    for (int i = 0; i < used_pipe_count; i++) {
-      tu_cs_emit_pkt7(cs, CP_COND_WRITE5, 8);
-      tu_cs_emit(cs, CP_COND_WRITE5_0_FUNCTION(WRITE_GE) |
-            CP_COND_WRITE5_0_WRITE_MEMORY);
-      tu_cs_emit(cs, CP_COND_WRITE5_1_POLL_ADDR_LO(REG_A6XX_VSC_DRAW_STRM_SIZE_REG(i)));
-      tu_cs_emit(cs, CP_COND_WRITE5_2_POLL_ADDR_HI(0));
-      tu_cs_emit(cs, CP_COND_WRITE5_3_REF(cmd->vsc_draw_strm_pitch - VSC_PAD));
-      tu_cs_emit(cs, CP_COND_WRITE5_4_MASK(~0));
-      tu_cs_emit_qw(cs, global_iova(cmd, vsc_draw_overflow));
-      tu_cs_emit(cs, CP_COND_WRITE5_7_WRITE_DATA(cmd->vsc_draw_strm_pitch));
-
-      tu_cs_emit_pkt7(cs, CP_COND_WRITE5, 8);
-      tu_cs_emit(cs, CP_COND_WRITE5_0_FUNCTION(WRITE_GE) |
-            CP_COND_WRITE5_0_WRITE_MEMORY);
-      tu_cs_emit(cs, CP_COND_WRITE5_1_POLL_ADDR_LO(REG_A6XX_VSC_PRIM_STRM_SIZE_REG(i)));
-      tu_cs_emit(cs, CP_COND_WRITE5_2_POLL_ADDR_HI(0));
-      tu_cs_emit(cs, CP_COND_WRITE5_3_REF(cmd->vsc_prim_strm_pitch - VSC_PAD));
-      tu_cs_emit(cs, CP_COND_WRITE5_4_MASK(~0));
-      tu_cs_emit_qw(cs, global_iova(cmd, vsc_prim_overflow));
-      tu_cs_emit(cs, CP_COND_WRITE5_7_WRITE_DATA(cmd->vsc_prim_strm_pitch));
+      emit_vsc_cond_write(cs, REG_A6XX_VSC_DRAW_STRM_SIZE_REG(i), draw_limit,
+                          global_iova(cmd, vsc_draw_overflow),
+                          cmd->vsc_draw_strm_pitch);
+      emit_vsc_cond_write(cs, REG_A6XX_VSC_DRAW_STRM_SIZE_REG(i), draw_limit / 2,
+                          global_iova(cmd, vsc_draw_high),
+                          cmd->vsc_draw_strm_pitch);
+
+      emit_vsc_cond_write(cs, REG_A6XX_VSC_PRIM_STRM_SIZE_REG(i), prim_limit,
+                          global_iova(cmd, vsc_prim_overflow),
+                          cmd->vsc_prim_strm_pitch);
+      emit_vsc_cond_write(cs, REG_A6XX_VSC_PRIM_STRM_SIZE_REG(i), prim_limit / 2,
+                          global_iova(cmd, vsc_prim_high),
+                          cmd->vsc_prim_strm_pitch);
    }
 
    tu_cs_emit_pkt7(cs, CP_WAIT_MEM_WRITES, 0);
@@ -1741,6 +1769,8 @@ tu6_sysmem_render_begin(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
 {
    const struct tu_framebuffer *fb = cmd->state.framebuffer;
 
+   tu_autotune_begin_timing<CHIP>(cmd, cs, autotune_result);
+
    tu_lrz_sysmem_begin<CHIP>(cmd, cs);
 
    assert(fb->width > 0 && fb->height > 0);
@@ -1798,6 +1828,8 @@ tu6_sysmem_render_end(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
     */
    tu6_emit_sysmem_resolves<CHIP>(cmd, cs, cmd->state.subpass);
 
+   tu_autotune_end_timing<CHIP>(cmd, cs, autotune_result);
+
    tu_cs_emit_call(cs, &cmd->draw_epilogue_cs);
 
    tu_cs_emit_pkt7(cs, CP_SKIP_IB2_ENABLE_GLOBAL, 1);
@@ -1815,6 +1847,9 @@ tu6_tile_render_begin(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
 {
    struct tu_physical_device *phys_dev = cmd->device->physical_device;
    const struct tu_tiling_config *tiling = cmd->state.tiling;
+
+   tu_autotune_begin_timing<CHIP>(cmd, cs, autotune_result);
+
    tu_lrz_tiling_begin<CHIP>(cmd, cs);
 
    tu_cs_emit_pkt7(cs, CP_SKIP_IB2_ENABLE_GLOBAL, 1);
@@ -1946,6 +1981,7 @@ tu6_tile_render_end(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
                     struct tu_renderpass_result *autotune_result)
 {
    tu_autotune_end_renderpass<CHIP>(cmd, cs, autotune_result);
+   tu_autotune_end_timing<CHIP>(cmd, cs, autotune_result);
 
    tu_cs_emit_call(cs, &cmd->draw_epilogue_cs);
 
@@ -3844,6 +3880,9 @@ tu_CmdExecuteCommands(VkCommandBuffer commandBuffer,
       TU_CALLX(cmd->device, tu_emit_cache_flush)(cmd);
    }
 
+   /* Secondaries may write depth images we don't see. */
+   tu_lrz_drop_retained(cmd, NULL);
+
    for (uint32_t i = 0; i < commandBufferCount; i++) {
       TU_FROM_HANDLE(tu_cmd_buffer, secondary, pCmdBuffers[i]);
 
@@ -4313,6 +4352,7 @@ tu_CmdBeginRendering(VkCommandBuffer commandBuffer,
    if ((resuming || suspending) &&
        !cmd->device->physical_device->info->a6xx.has_lrz_dir_tracking) {
       cmd->state.lrz.valid = false;
+      tu_lrz_drop_retained(cmd, NULL);
    } else {
       if (resuming)
          tu_lrz_begin_resumed_renderpass(cmd);
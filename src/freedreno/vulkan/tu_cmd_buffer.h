@@ -522,6 +522,7 @@ struct tu_cmd_state
    bool suspending, resuming;
 
    struct tu_lrz_state lrz;
+   struct tu_lrz_retained lrz_retained;
 
    struct tu_draw_state lrz_and_depth_plane_state;
 
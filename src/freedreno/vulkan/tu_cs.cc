@@ -81,12 +81,24 @@ tu_cs_finish(struct tu_cs *cs)
       tu_bo_finish(cs->device, cs->read_write.bos[i]);
    }
 
+   for (uint32_t i = 0; i < cs->free_read_only.bo_count; ++i) {
+      TU_RMV(resource_destroy, cs->device, cs->free_read_only.bos[i]);
+      tu_bo_finish(cs->device, cs->free_read_only.bos[i]);
+   }
+
+   for (uint32_t i = 0; i < cs->free_read_write.bo_count; ++i) {
+      TU_RMV(resource_destroy, cs->device, cs->free_read_write.bos[i]);
+      tu_bo_finish(cs->device, cs->free_read_write.bos[i]);
+   }
+
    if (cs->refcount_bo)
       tu_bo_finish(cs->device, cs->refcount_bo);
 
    free(cs->entries);
    free(cs->read_only.bos);
    free(cs->read_write.bos);
+   free(cs->free_read_only.bos);
+   free(cs->free_read_write.bos);
 }
 
 static struct tu_bo *
@@ -123,6 +135,64 @@ tu_cs_get_cur_iova(const struct tu_cs *cs)
    return tu_cs_current_bo(cs)->iova + ((char *) cs->cur - (char *) tu_cs_current_bo(cs)->map);
 }
 
+/* Upper bound of BOs kept around by tu_cs_reset() for each of the free
+ * lists, anything above that is returned to the kernel.
+ */
+#define TU_CS_MAX_FREE_BOS 16
+
+static bool
+tu_bo_array_grow(struct tu_bo_array *bos)
+{
+   if (bos->bo_count < bos->bo_capacity)
+      return true;
+
+   uint32_t new_capacity = MAX2(4, 2 * bos->bo_capacity);
+   struct tu_bo **new_bos = (struct tu_bo **)
+      realloc(bos->bos, new_capacity * sizeof(struct tu_bo *));
+   if (!new_bos)
+      return false;
+
+   bos->bo_capacity = new_capacity;
+   bos->bos = new_bos;
+   return true;
+}
+
+/* Take a BO of at least size bytes from the free list, if there is one.
+ * These are still mapped, and since the command buffer was reset nothing on
+ * the GPU refers to them anymore.
+ */
+static struct tu_bo *
+tu_cs_reuse_bo(struct tu_cs *cs, uint64_t size)
+{
+   struct tu_bo_array *free_bos =
+      cs->writeable ? &cs->free_read_write : &cs->free_read_only;
+
+   for (uint32_t i = 0; i < free_bos->bo_count; i++) {
+      struct tu_bo *bo = free_bos->bos[i];
+      if (bo->size >= size) {
+         free_bos->bos[i] = free_bos->bos[--free_bos->bo_count];
+         return bo;
+      }
+   }
+
+   return NULL;
+}
+
+/* Retire a BO from a command stream being reset.  */
+static void
+tu_cs_release_bo(struct tu_cs *cs, struct tu_bo_array *free_bos,
+                 struct tu_bo *bo)
+{
+   if (free_bos->bo_count < TU_CS_MAX_FREE_BOS &&
+       tu_bo_array_grow(free_bos)) {
+      free_bos->bos[free_bos->bo_count++] = bo;
+      return;
+   }
+
+   TU_RMV(resource_destroy, cs->device, bo);
+   tu_bo_finish(cs->device, bo);
+}
+
 /*
  * Allocate and add a BO to a command stream.  Following command packets will
  * be emitted to the new BO.
@@ -141,18 +211,18 @@ tu_cs_add_bo(struct tu_cs *cs, uint32_t size)
    struct tu_bo_array *bos = cs->writeable ? &cs->read_write : &cs->read_only;
 
    /* grow cs->bos if needed */
-   if (bos->bo_count == bos->bo_capacity) {
-      uint32_t new_capacity = MAX2(4, 2 * bos->bo_capacity);
-      struct tu_bo **new_bos = (struct tu_bo **)
-         realloc(bos->bos, new_capacity * sizeof(struct tu_bo *));
-      if (!new_bos)
-         return VK_ERROR_OUT_OF_HOST_MEMORY;
+   if (!tu_bo_array_grow(bos))
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
 
-      bos->bo_capacity = new_capacity;
-      bos->bos = new_bos;
-   }
+   struct tu_bo *new_bo = tu_cs_reuse_bo(cs, size * sizeof(uint32_t));
+   if (new_bo) {
+      bos->bos[bos->bo_count++] = new_bo;
 
-   struct tu_bo *new_bo;
+      cs->start = cs->cur = cs->reserved_end = (uint32_t *) new_bo->map;
+      cs->end = cs->start + new_bo->size / sizeof(uint32_t);
+
+      return VK_SUCCESS;
+   }
 
    VkResult result =
       tu_bo_init_new(cs->device, &new_bo, size * sizeof(uint32_t),
@@ -487,15 +557,11 @@ tu_cs_reset(struct tu_cs *cs)
       return;
    }
 
-   for (uint32_t i = 0; i + 1 < cs->read_only.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_only.bos[i]);
-      tu_bo_finish(cs->device, cs->read_only.bos[i]);
-   }
+   for (uint32_t i = 0; i + 1 < cs->read_only.bo_count; ++i)
+      tu_cs_release_bo(cs, &cs->free_read_only, cs->read_only.bos[i]);
 
-   for (uint32_t i = 0; i + 1 < cs->read_write.bo_count; ++i) {
-      TU_RMV(resource_destroy, cs->device, cs->read_write.bos[i]);
-      tu_bo_finish(cs->device, cs->read_write.bos[i]);
-   }
+   for (uint32_t i = 0; i + 1 < cs->read_write.bo_count; ++i)
+      tu_cs_release_bo(cs, &cs->free_read_write, cs->read_write.bos[i]);
 
    cs->writeable = false;
 
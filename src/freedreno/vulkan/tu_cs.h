@@ -99,6 +99,11 @@ struct tu_cs
 
    struct tu_bo_array read_only, read_write;
 
+   /* BOs dropped by tu_cs_reset(), kept mapped so that re-recording the
+    * command stream doesn't have to go through the kernel again.
+    */
+   struct tu_bo_array free_read_only, free_read_write;
+
    /* Optional BO that this CS is sub-allocated from for TU_CS_MODE_SUB_STREAM */
    struct tu_bo *refcount_bo;
 
@@ -200,9 +200,10 @@ struct tu6_global
    uint32_t seqno_dummy;          /* dummy seqno for CP_EVENT_WRITE */
    uint32_t _pad0;
    volatile uint32_t vsc_draw_overflow;
-   uint32_t _pad1;
+   /* Written when a stream got more than half full, see tu6_lazy_emit_vsc */
+   volatile uint32_t vsc_draw_high;
    volatile uint32_t vsc_prim_overflow;
-   uint32_t _pad2;
+   volatile uint32_t vsc_prim_high;
    uint64_t predicate;
 
    /* scratch space for VPC_SO[i].FLUSH_BASE_LO/HI, start on 32 byte boundary. */
@@ -330,6 +331,10 @@ struct tu_device
 
    uint32_t vsc_draw_strm_pitch;
    uint32_t vsc_prim_strm_pitch;
+   /* Number of times a VSC stream actually overflowed, ie. binning data of
+    * a renderpass was lost, as opposed to being grown ahead of time.
+    */
+   uint32_t vsc_overflow_count;
    BITSET_DECLARE(custom_border_color, TU_BORDER_COLOR_COUNT);
    mtx_t mutex;
 
@@ -200,8 +200,11 @@ msm_device_check_status(struct tu_device *device)
    if (ret != 0)
       return vk_device_set_lost(&device->vk, "error getting GPU fault count: %d", ret);
 
-   if (last_fault_count != device->fault_count)
+   if (last_fault_count != device->fault_count) {
+      if (FD_RD_DUMP(RING))
+         fd_rd_output_dump_ring(&device->rd_output);
       return vk_device_set_lost(&device->vk, "GPU faulted or hung");
+   }
 
    return VK_SUCCESS;
 }
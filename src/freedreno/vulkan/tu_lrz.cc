@@ -21,7 +21,8 @@
  *   - Changing direction of depth test (e.g. from OP_GREATER to OP_LESS);
  *   - Using OP_ALWAYS or OP_NOT_EQUAL;
  * - Clearing depth with vkCmdClearAttachments;
- * - (pre-a650) Not clearing depth attachment with LOAD_OP_CLEAR;
+ * - (pre-a650) Not clearing depth attachment with LOAD_OP_CLEAR, unless the
+ *   previous render pass left LRZ valid (see below);
  * - (pre-a650) Using secondary command buffers;
  * - Sysmem rendering (with small caveat).
  *
@@ -35,6 +36,16 @@
  * - vkCmdCopyBufferToImage*
  * - vkCmdCopyImage*
  *
+ * Pre-A650
+ * ========
+ *
+ * Without GPU direction tracking LRZ has to be cleared at the start of a
+ * render pass, unless the previous render pass of the same command buffer
+ * rendered to the same depth view in GMEM mode, kept LRZ valid and stored
+ * depth. In that case the LRZ buffer and the last direction are still known
+ * to match, see tu_lrz_retained. Any other render pass or transfer touching
+ * the image drops that state.
+ *
  * LRZ Fast-Clear
  * ==============
  *
@@ -130,8 +141,12 @@ tu_lrz_init_state(struct tu_cmd_buffer *cmd,
       (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT);
    bool has_gpu_tracking =
       cmd->device->physical_device->info->a6xx.has_lrz_dir_tracking;
+   const struct tu_lrz_retained *retained = &cmd->state.lrz_retained;
+   bool reuse_retained = !has_gpu_tracking && !clears_depth && att->load &&
+      retained->image == view->image &&
+      retained->depth_view == view->view.GRAS_LRZ_DEPTH_VIEW;
 
-   if (!has_gpu_tracking && !clears_depth)
+   if (!has_gpu_tracking && !clears_depth && !reuse_retained)
       return;
 
    /* We need to always have an LRZ view just to disable it if there is a
@@ -146,7 +161,8 @@ tu_lrz_init_state(struct tu_cmd_buffer *cmd,
       return;
 
    cmd->state.lrz.valid = true;
-   cmd->state.lrz.prev_direction = TU_LRZ_UNKNOWN;
+   cmd->state.lrz.prev_direction =
+      reuse_retained ? retained->direction : TU_LRZ_UNKNOWN;
    /* Be optimistic and unconditionally enable fast-clear in
     * secondary cmdbufs and when reusing previous LRZ state.
     */
@@ -154,6 +170,7 @@ tu_lrz_init_state(struct tu_cmd_buffer *cmd,
 
    cmd->state.lrz.gpu_dir_tracking = has_gpu_tracking;
    cmd->state.lrz.reuse_previous_state = !clears_depth;
+   cmd->state.lrz.retain = !has_gpu_tracking && att->store;
 }
 
 /* Note: if we enable LRZ here, then tu_lrz_init_state() must at least set
@@ -222,6 +239,11 @@ tu_lrz_begin_resumed_renderpass(struct tu_cmd_buffer *cmd)
       }
       cmd->state.dirty |= TU_CMD_DIRTY_LRZ;
    }
+
+   /* Whatever this render pass does to the depth images, the retained state
+    * is only re-established once it ends in tu_lrz_tiling_end().
+    */
+   tu_lrz_drop_retained(cmd, NULL);
 }
 
 template <chip CHIP>
@@ -257,6 +279,7 @@ tu_lrz_begin_renderpass(struct tu_cmd_buffer *cmd)
        * the last one as emitted in tu_disable_lrz().
        */
       memset(&cmd->state.lrz, 0, sizeof(cmd->state.lrz));
+      tu_lrz_drop_retained(cmd, NULL);
       return;
    }
 
@@ -300,10 +323,10 @@ tu_lrz_tiling_begin(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
       /* Reuse previous LRZ state, LRZ cache is assumed to be
        * already invalidated by previous renderpass.
        */
-      assert(lrz->gpu_dir_tracking);
-
-      tu6_write_lrz_reg(cmd, cs,
-         A6XX_GRAS_LRZ_DEPTH_VIEW(.dword = lrz->image_view->view.GRAS_LRZ_DEPTH_VIEW));
+      if (lrz->gpu_dir_tracking) {
+         tu6_write_lrz_reg(cmd, cs,
+            A6XX_GRAS_LRZ_DEPTH_VIEW(.dword = lrz->image_view->view.GRAS_LRZ_DEPTH_VIEW));
+      }
       return;
    }
 
@@ -376,6 +399,14 @@ tu_lrz_tiling_end(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
 
    tu_emit_event_write<A6XX>(cmd, cs, FD_LRZ_FLUSH);
 
+   if (cmd->state.lrz.retain && cmd->state.lrz.valid) {
+      cmd->state.lrz_retained = (struct tu_lrz_retained) {
+         .image = cmd->state.lrz.image_view->image,
+         .depth_view = cmd->state.lrz.image_view->view.GRAS_LRZ_DEPTH_VIEW,
+         .direction = cmd->state.lrz.prev_direction,
+      };
+   }
+
    /* If gpu_dir_tracking is enabled and lrz is not valid blob, at this point,
     * additionally clears direction buffer:
     *  GRAS_LRZ_DEPTH_VIEW(.dword = 0)
@@ -412,6 +443,10 @@ tu_lrz_sysmem_begin(struct tu_cmd_buffer *cmd, struct tu_cs *cs)
       /* Even though we disable LRZ writes in sysmem mode - there is still
        * LRZ test, so LRZ should be cleared.
        */
+      /* A still valid LRZ buffer is just as good as a cleared one. */
+      if (lrz->reuse_previous_state)
+         return;
+
       if (lrz->fast_clear) {
          tu6_write_lrz_reg(cmd, &cmd->cs, A6XX_GRAS_LRZ_CNTL(
             .enable = true,
@@ -438,6 +473,8 @@ void
 tu_disable_lrz(struct tu_cmd_buffer *cmd, struct tu_cs *cs,
                struct tu_image *image)
 {
+   tu_lrz_drop_retained(cmd, image);
+
    if (!cmd->device->physical_device->info->a6xx.has_lrz_dir_tracking)
       return;
 
@@ -458,6 +495,8 @@ tu_lrz_clear_depth_image(struct tu_cmd_buffer *cmd,
                          uint32_t rangeCount,
                          const VkImageSubresourceRange *pRanges)
 {
+   tu_lrz_drop_retained(cmd, image);
+
    if (!rangeCount || !image->lrz_height ||
        !cmd->device->physical_device->info->a6xx.has_lrz_dir_tracking)
       return;
@@ -520,6 +559,16 @@ tu_lrz_disable_during_renderpass(struct tu_cmd_buffer *cmd)
    }
 }
 
+/* Forget the LRZ state retained for image, or for any image if NULL, because
+ * the depth image may be written without LRZ being updated.
+ */
+void
+tu_lrz_drop_retained(struct tu_cmd_buffer *cmd, const struct tu_image *image)
+{
+   if (!image || cmd->state.lrz_retained.image == image)
+      memset(&cmd->state.lrz_retained, 0, sizeof(cmd->state.lrz_retained));
+}
+
 /* update lrz state based on stencil-test func:
  *
  * Conceptually the order of the pipeline is:
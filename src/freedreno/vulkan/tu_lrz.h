@@ -39,9 +39,23 @@ struct tu_lrz_state
    bool gpu_dir_tracking : 1;
    /* Continue using old LRZ state (LOAD_OP_LOAD of depth) */
    bool reuse_previous_state : 1;
+   /* Remember the LRZ state in tu_lrz_tiling_end() (no GPU tracking only) */
+   bool retain : 1;
    enum tu_lrz_direction prev_direction;
 };
 
+/* Without GPU direction tracking only the CPU knows whether an LRZ buffer
+ * still matches its depth image. This is what the last render pass of the
+ * command buffer left behind, so that a following pass loading the same
+ * depth image can keep using LRZ instead of clearing it.
+ */
+struct tu_lrz_retained
+{
+   const struct tu_image *image;
+   uint32_t depth_view;
+   enum tu_lrz_direction direction;
+};
+
 void
 tu6_emit_lrz(struct tu_cmd_buffer *cmd, struct tu_cs *cs);
 
@@ -86,4 +100,7 @@ tu_lrz_sysmem_end(struct tu_cmd_buffer *cmd, struct tu_cs *cs);
 void
 tu_lrz_disable_during_renderpass(struct tu_cmd_buffer *cmd);
 
+void
+tu_lrz_drop_retained(struct tu_cmd_buffer *cmd, const struct tu_image *image);
+
 #endif /* TU_LRZ_H */
@@ -102,6 +102,15 @@ struct cso_context_priv {
    void *blend, *blend_saved;
    void *depth_stencil, *depth_stencil_saved;
    void *rasterizer, *rasterizer_saved;
+
+   /* Cache entries of the bound blend, DSA and rasterizer states if they
+    * were bound through cso_set_*, so that setting the same state again
+    * doesn't need to be hashed.  NULL otherwise.
+    */
+   const struct cso_blend *blend_cso;
+   const struct cso_depth_stencil_alpha *depth_stencil_cso;
+   const struct cso_rasterizer *rasterizer_cso;
+
    void *fragment_shader, *fragment_shader_saved;
    void *vertex_shader, *vertex_shader_saved;
    void *geometry_shader, *geometry_shader_saved;
@@ -521,7 +530,12 @@ cso_set_blend(struct cso_context *cso,
    struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
    unsigned key_size, hash_key;
    struct cso_hash_iter iter;
-   void *handle;
+   struct cso_blend *entry;
+
+   key_size = templ->independent_blend_enable ? CSO_BLEND_KEY_SIZE_ALL_RT :
+                                                CSO_BLEND_KEY_SIZE_RT0;
+   if (ctx->blend_cso && !memcmp(&ctx->blend_cso->state, templ, key_size))
+      return PIPE_OK;
 
    if (templ->independent_blend_enable) {
       /* This is duplicated with the else block below because we want key_size
@@ -531,37 +545,34 @@ cso_set_blend(struct cso_context *cso,
       hash_key = cso_construct_key(templ, CSO_BLEND_KEY_SIZE_ALL_RT);
       iter = cso_find_state_template(&ctx->cache, hash_key, CSO_BLEND,
                                      templ, CSO_BLEND_KEY_SIZE_ALL_RT);
-      key_size = CSO_BLEND_KEY_SIZE_ALL_RT;
    } else {
       hash_key = cso_construct_key(templ, CSO_BLEND_KEY_SIZE_RT0);
       iter = cso_find_state_template(&ctx->cache, hash_key, CSO_BLEND,
                                      templ, CSO_BLEND_KEY_SIZE_RT0);
-      key_size = CSO_BLEND_KEY_SIZE_RT0;
    }
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_blend *cso = MALLOC(sizeof(struct cso_blend));
-      if (!cso)
+      entry = MALLOC(sizeof(struct cso_blend));
+      if (!entry)
          return PIPE_ERROR_OUT_OF_MEMORY;
 
-      memset(&cso->state, 0, sizeof cso->state);
-      memcpy(&cso->state, templ, key_size);
-      cso->data = ctx->base.pipe->create_blend_state(ctx->base.pipe, &cso->state);
+      memset(&entry->state, 0, sizeof entry->state);
+      memcpy(&entry->state, templ, key_size);
+      entry->data = ctx->base.pipe->create_blend_state(ctx->base.pipe, &entry->state);
 
-      iter = cso_insert_state(&ctx->cache, hash_key, CSO_BLEND, cso);
+      iter = cso_insert_state(&ctx->cache, hash_key, CSO_BLEND, entry);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         FREE(entry);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
-
-      handle = cso->data;
    } else {
-      handle = ((struct cso_blend *)cso_hash_iter_data(iter))->data;
+      entry = cso_hash_iter_data(iter);
    }
 
-   if (ctx->blend != handle) {
-      ctx->blend = handle;
-      ctx->base.pipe->bind_blend_state(ctx->base.pipe, handle);
+   ctx->blend_cso = entry;
+   if (ctx->blend != entry->data) {
+      ctx->blend = entry->data;
+      ctx->base.pipe->bind_blend_state(ctx->base.pipe, entry->data);
    }
    return PIPE_OK;
 }
@@ -580,6 +591,7 @@ cso_restore_blend(struct cso_context_priv *ctx)
 {
    if (ctx->blend != ctx->blend_saved) {
       ctx->blend = ctx->blend_saved;
+      ctx->blend_cso = NULL;
       ctx->base.pipe->bind_blend_state(ctx->base.pipe, ctx->blend_saved);
    }
    ctx->blend_saved = NULL;
@@ -592,39 +604,42 @@ cso_set_depth_stencil_alpha(struct cso_context *cso,
 {
    struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
    const unsigned key_size = sizeof(struct pipe_depth_stencil_alpha_state);
+
+   if (ctx->depth_stencil_cso &&
+       !memcmp(&ctx->depth_stencil_cso->state, templ, key_size))
+      return PIPE_OK;
+
    const unsigned hash_key = cso_construct_key(templ, key_size);
    struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
                                                        hash_key,
                                                        CSO_DEPTH_STENCIL_ALPHA,
                                                        templ, key_size);
-   void *handle;
+   struct cso_depth_stencil_alpha *entry;
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_depth_stencil_alpha *cso =
-         MALLOC(sizeof(struct cso_depth_stencil_alpha));
-      if (!cso)
+      entry = MALLOC(sizeof(struct cso_depth_stencil_alpha));
+      if (!entry)
          return PIPE_ERROR_OUT_OF_MEMORY;
 
-      memcpy(&cso->state, templ, sizeof(*templ));
-      cso->data = ctx->base.pipe->create_depth_stencil_alpha_state(ctx->base.pipe,
-                                                              &cso->state);
+      memcpy(&entry->state, templ, sizeof(*templ));
+      entry->data = ctx->base.pipe->create_depth_stencil_alpha_state(ctx->base.pipe,
+                                                              &entry->state);
 
       iter = cso_insert_state(&ctx->cache, hash_key,
-                              CSO_DEPTH_STENCIL_ALPHA, cso);
+                              CSO_DEPTH_STENCIL_ALPHA, entry);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         FREE(entry);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
-
-      handle = cso->data;
    } else {
-      handle = ((struct cso_depth_stencil_alpha *)
-                cso_hash_iter_data(iter))->data;
+      entry = cso_hash_iter_data(iter);
    }
 
-   if (ctx->depth_stencil != handle) {
-      ctx->depth_stencil = handle;
-      ctx->base.pipe->bind_depth_stencil_alpha_state(ctx->base.pipe, handle);
+   ctx->depth_stencil_cso = entry;
+   if (ctx->depth_stencil != entry->data) {
+      ctx->depth_stencil = entry->data;
+      ctx->base.pipe->bind_depth_stencil_alpha_state(ctx->base.pipe,
+                                                     entry->data);
    }
    return PIPE_OK;
 }
@@ -643,6 +658,7 @@ cso_restore_depth_stencil_alpha(struct cso_context_priv *ctx)
 {
    if (ctx->depth_stencil != ctx->depth_stencil_saved) {
       ctx->depth_stencil = ctx->depth_stencil_saved;
+      ctx->depth_stencil_cso = NULL;
       ctx->base.pipe->bind_depth_stencil_alpha_state(ctx->base.pipe,
                                                 ctx->depth_stencil_saved);
    }
@@ -656,43 +672,47 @@ cso_set_rasterizer(struct cso_context *cso,
 {
    struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
    const unsigned key_size = sizeof(struct pipe_rasterizer_state);
-   const unsigned hash_key = cso_construct_key(templ, key_size);
-   struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
-                                                       hash_key,
-                                                       CSO_RASTERIZER,
-                                                       templ, key_size);
-   void *handle = NULL;
 
    /* We can't have both point_quad_rasterization (sprites) and point_smooth
     * (round AA points) enabled at the same time.
     */
    assert(!(templ->point_quad_rasterization && templ->point_smooth));
 
+   if (ctx->rasterizer_cso &&
+       !memcmp(&ctx->rasterizer_cso->state, templ, key_size))
+      return PIPE_OK;
+
+   const unsigned hash_key = cso_construct_key(templ, key_size);
+   struct cso_hash_iter iter = cso_find_state_template(&ctx->cache,
+                                                       hash_key,
+                                                       CSO_RASTERIZER,
+                                                       templ, key_size);
+   struct cso_rasterizer *entry;
+
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_rasterizer *cso = MALLOC(sizeof(struct cso_rasterizer));
-      if (!cso)
+      entry = MALLOC(sizeof(struct cso_rasterizer));
+      if (!entry)
          return PIPE_ERROR_OUT_OF_MEMORY;
 
-      memcpy(&cso->state, templ, sizeof(*templ));
-      cso->data = ctx->base.pipe->create_rasterizer_state(ctx->base.pipe, &cso->state);
+      memcpy(&entry->state, templ, sizeof(*templ));
+      entry->data = ctx->base.pipe->create_rasterizer_state(ctx->base.pipe, &entry->state);
 
-      iter = cso_insert_state(&ctx->cache, hash_key, CSO_RASTERIZER, cso);
+      iter = cso_insert_state(&ctx->cache, hash_key, CSO_RASTERIZER, entry);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         FREE(entry);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
-
-      handle = cso->data;
    } else {
-      handle = ((struct cso_rasterizer *)cso_hash_iter_data(iter))->data;
+      entry = cso_hash_iter_data(iter);
    }
 
-   if (ctx->rasterizer != handle) {
-      ctx->rasterizer = handle;
+   ctx->rasterizer_cso = entry;
+   if (ctx->rasterizer != entry->data) {
+      ctx->rasterizer = entry->data;
       ctx->flatshade_first = templ->flatshade_first;
       if (ctx->vbuf)
          u_vbuf_set_flatshade_first(ctx->vbuf, ctx->flatshade_first);
-      ctx->base.pipe->bind_rasterizer_state(ctx->base.pipe, handle);
+      ctx->base.pipe->bind_rasterizer_state(ctx->base.pipe, entry->data);
    }
    return PIPE_OK;
 }
@@ -712,6 +732,7 @@ cso_restore_rasterizer(struct cso_context_priv *ctx)
 {
    if (ctx->rasterizer != ctx->rasterizer_saved) {
       ctx->rasterizer = ctx->rasterizer_saved;
+      ctx->rasterizer_cso = NULL;
       ctx->flatshade_first = ctx->flatshade_first_saved;
       if (ctx->vbuf)
          u_vbuf_set_flatshade_first(ctx->vbuf, ctx->flatshade_first);
@@ -222,6 +222,8 @@ draw_destroy(struct draw_context *draw)
    draw_pt_destroy(draw);
    draw_vs_destroy(draw);
    draw_gs_destroy(draw);
+   if (draw->num_vs_threads)
+      util_queue_destroy(&draw->vs_queue);
 #if DRAW_LLVM_AVAILABLE
    if (draw->llvm)
       draw_llvm_destroy(draw->llvm);
@@ -1311,3 +1313,28 @@ draw_set_constant_buffer_stride(struct draw_context *draw, unsigned num_bytes)
 {
    draw->constant_buffer_stride = num_bytes;
 }
+
+
+/**
+ * Let the llvm vertex shader of large vertex batches run on up to
+ * num_threads helper threads in addition to the calling thread.
+ * Only the vertex shader stage is split; everything after it still runs
+ * in order on the calling thread.  Can only be called once.
+ */
+void
+draw_set_vs_threads(struct draw_context *draw, unsigned num_threads)
+{
+   assert(!draw->num_vs_threads);
+
+#if DRAW_LLVM_AVAILABLE
+   num_threads = MIN2(num_threads, DRAW_MAX_VS_THREADS - 1);
+   if (!draw->llvm || !num_threads)
+      return;
+
+   if (!util_queue_init(&draw->vs_queue, "drawvs", DRAW_MAX_VS_THREADS,
+                        num_threads, 0, NULL))
+      return;
+
+   draw->num_vs_threads = num_threads;
+#endif
+}
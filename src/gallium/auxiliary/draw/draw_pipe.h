@@ -125,4 +125,49 @@ dup_vert(struct draw_stage *stage,
    return tmp;
 }
 
+
+/**
+ * Compute the front/back face determinant of a triangle in window
+ * coordinates and return whether the triangle survives face culling.
+ * This is the work of the cull stage, which the clipper does itself for
+ * unclipped triangles when the cull stage follows it.
+ */
+static inline bool
+draw_cull_tri(struct prim_header *header, unsigned pos,
+              unsigned cull_face, unsigned front_ccw)
+{
+   const float *v0 = header->v[0]->data[pos];
+   const float *v1 = header->v[1]->data[pos];
+   const float *v2 = header->v[2]->data[pos];
+
+   /* edge vectors: e = v0 - v2, f = v1 - v2 */
+   const float ex = v0[0] - v2[0];
+   const float ey = v0[1] - v2[1];
+   const float fx = v1[0] - v2[0];
+   const float fy = v1[1] - v2[1];
+
+   /* det = cross(e,f).z */
+   header->det = ex * fy - ey * fx;
+
+   if (header->det != 0) {
+      /* if det < 0 then Z points toward the camera and the triangle is
+       * counter-clockwise winding.
+       */
+      unsigned ccw = (header->det < 0);
+      unsigned face = ((ccw == front_ccw) ?
+                       PIPE_FACE_FRONT :
+                       PIPE_FACE_BACK);
+
+      return (face & cull_face) == 0;
+   } else {
+      /*
+       * With zero area, this is back facing (because the spec says
+       * it's front facing if sign is positive?).
+       * Some apis apparently do not allow us to cull zero area tris
+       * here, in case of fill mode line (which is rather lame).
+       */
+      return (PIPE_FACE_BACK & cull_face) == 0;
+   }
+}
+
 #endif
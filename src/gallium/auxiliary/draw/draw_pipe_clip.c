@@ -57,6 +57,10 @@ struct clip_stage {
    bool have_clipdist;
    int cv_attr;
 
+   /* Face culling state, when the cull stage comes right after us. */
+   unsigned cull_face;
+   unsigned front_ccw;
+
    /* List of the attributes to be constant interpolated. */
    unsigned num_const_attribs;
    uint8_t const_attribs[PIPE_MAX_SHADER_OUTPUTS];
@@ -764,6 +768,34 @@ clip_tri(struct draw_stage *stage, struct prim_header *header)
 }
 
 
+/* Same as clip_tri, but the next stage is the cull stage: unclipped
+ * triangles, i.e. nearly all of them, are culled right here and go
+ * straight to the stage after it.  Clipped triangles still go through the
+ * cull stage, for their new vertices.
+ */
+static void
+clip_tri_cull(struct draw_stage *stage, struct prim_header *header)
+{
+   unsigned clipmask = (header->v[0]->clipmask |
+                        header->v[1]->clipmask |
+                        header->v[2]->clipmask);
+
+   if (clipmask == 0) {
+      struct clip_stage *clipper = clip_stage(stage);
+      struct draw_stage *next = stage->next->next;
+
+      if (draw_cull_tri(header, clipper->pos_attr,
+                        clipper->cull_face, clipper->front_ccw))
+         next->tri(next, header);
+   }
+   else if ((header->v[0]->clipmask &
+             header->v[1]->clipmask &
+             header->v[2]->clipmask) == 0) {
+      do_clip_tri(stage, header, clipmask);
+   }
+}
+
+
 static enum tgsi_interpolate_mode
 find_interp(const struct draw_fragment_shader *fs,
             enum tgsi_interpolate_mode *indexed_interp,
@@ -927,7 +959,13 @@ clip_init_state(struct draw_stage *stage)
       }
    }
 
-   stage->tri = clip_tri;
+   if (stage->next == draw->pipeline.cull) {
+      clipper->cull_face = draw->rasterizer->cull_face;
+      clipper->front_ccw = draw->rasterizer->front_ccw;
+      stage->tri = clip_tri_cull;
+   } else {
+      stage->tri = clip_tri;
+   }
 }
 
 
@@ -60,43 +60,11 @@ cull_tri(struct draw_stage *stage,
          struct prim_header *header)
 {
    const unsigned pos = draw_current_shader_position_output(stage->draw);
-   /* Window coords: */
-   const float *v0 = header->v[0]->data[pos];
-   const float *v1 = header->v[1]->data[pos];
-   const float *v2 = header->v[2]->data[pos];
-
-   /* edge vectors: e = v0 - v2, f = v1 - v2 */
-   const float ex = v0[0] - v2[0];
-   const float ey = v0[1] - v2[1];
-   const float fx = v1[0] - v2[0];
-   const float fy = v1[1] - v2[1];
-
-   /* det = cross(e,f).z */
-   header->det = ex * fy - ey * fx;
-
-   if (header->det != 0) {
-      /* if det < 0 then Z points toward the camera and the triangle is
-       * counter-clockwise winding.
-       */
-      unsigned ccw = (header->det < 0);
-      unsigned face = ((ccw == cull_stage(stage)->front_ccw) ?
-                       PIPE_FACE_FRONT :
-                       PIPE_FACE_BACK);
-
-      if ((face & cull_stage(stage)->cull_face) == 0) {
-         /* triangle is not culled, pass to next stage */
-         stage->next->tri(stage->next, header);
-      }
-   } else {
-      /*
-       * With zero area, this is back facing (because the spec says
-       * it's front facing if sign is positive?).
-       * Some apis apparently do not allow us to cull zero area tris
-       * here, in case of fill mode line (which is rather lame).
-       */
-      if ((PIPE_FACE_BACK & cull_stage(stage)->cull_face) == 0) {
-         stage->next->tri(stage->next, header);
-      }
+
+   if (draw_cull_tri(header, pos, cull_stage(stage)->cull_face,
+                     cull_stage(stage)->front_ccw)) {
+      /* triangle is not culled, pass to next stage */
+      stage->next->tri(stage->next, header);
    }
 }
 
@@ -47,10 +47,18 @@
 
 #include "draw_vertex_header.h"
 
+#include "util/u_queue.h"
+
 #if DRAW_LLVM_AVAILABLE
 struct gallivm_state;
 #endif
 
+/**
+ * Max number of threads (including the calling one) the llvm vertex
+ * shader of a single batch is split across.
+ */
+#define DRAW_MAX_VS_THREADS 8
+
 /**
  * The max stage the draw stores resources for.
  * i.e. vs, tcs, tes, gs. no fs/cs/ms/ts.
@@ -400,6 +408,12 @@ struct draw_context
                                     struct lp_cached_code *cache,
                                     unsigned char ir_sha1_cache_key[20]);
 
+   /** Worker threads helping to run the llvm vertex shader of large
+    * batches, see draw_set_vs_threads().
+    */
+   struct util_queue vs_queue;
+   unsigned num_vs_threads;
+
    void *driver_private;
 };
 
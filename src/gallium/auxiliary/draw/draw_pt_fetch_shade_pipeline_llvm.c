@@ -491,6 +491,127 @@ emit(struct pt_emit *emit,
 }
 
 
+/**
+ * Smallest number of vertices handed to one thread when splitting the
+ * vertex shader, below that the queue overhead isn't worth it.
+ */
+#define LLVM_VS_MIN_THREAD_VERTICES 256
+
+struct llvm_vs_job {
+   struct llvm_middle_end *fpme;
+   struct vertex_header *verts;
+   unsigned count;
+   unsigned start;
+   unsigned vertex_id_offset;
+   const unsigned *elts;
+   int clipped;
+   struct util_queue_fence fence;
+};
+
+
+static void
+llvm_vs_run(struct llvm_vs_job *job)
+{
+   struct llvm_middle_end *fpme = job->fpme;
+   struct draw_context *draw = fpme->draw;
+
+   job->clipped = fpme->current_variant->jit_func(&fpme->llvm->vs_jit_context,
+                                                  &fpme->llvm->jit_resources[PIPE_SHADER_VERTEX],
+                                                  job->verts,
+                                                  draw->pt.user.vbuffer,
+                                                  job->count,
+                                                  job->start,
+                                                  fpme->vertex_size,
+                                                  draw->pt.vertex_buffer,
+                                                  draw->instance_id,
+                                                  job->vertex_id_offset,
+                                                  draw->start_instance,
+                                                  job->elts,
+                                                  draw->pt.user.drawid,
+                                                  draw->pt.user.viewid);
+}
+
+
+static void
+llvm_vs_job_execute(void *data, void *gdata, int thread_index)
+{
+   llvm_vs_run(data);
+}
+
+
+/**
+ * Run the vertex fetch shader over the vertices of fetch_info, split
+ * across the helper threads if there are enough of them.
+ *
+ * Each chunk covers a multiple of the native vector width so that the
+ * padding vertices the shader writes past the end of a chunk never overlap
+ * the next one, and the whole output stays ordered exactly like a single
+ * invocation would have written it.  Returns whether any vertex got clipped.
+ */
+static bool
+llvm_vs_run_split(struct llvm_middle_end *fpme,
+                  const struct draw_fetch_info *fetch_info,
+                  struct vertex_header *verts,
+                  unsigned start, unsigned vertex_id_offset,
+                  const unsigned *elts)
+{
+   struct draw_context *draw = fpme->draw;
+   const unsigned vector_length = lp_native_vector_width / 32;
+   const unsigned count = fetch_info->count;
+   struct llvm_vs_job jobs[DRAW_MAX_VS_THREADS];
+   unsigned num_jobs, per_job;
+   bool clipped = false;
+
+   num_jobs = MIN2(draw->num_vs_threads + 1,
+                   count / LLVM_VS_MIN_THREAD_VERTICES);
+   if (num_jobs < 2) {
+      jobs[0].fpme = fpme;
+      jobs[0].verts = verts;
+      jobs[0].count = count;
+      jobs[0].start = start;
+      jobs[0].vertex_id_offset = vertex_id_offset;
+      jobs[0].elts = elts;
+      llvm_vs_run(&jobs[0]);
+      return jobs[0].clipped;
+   }
+
+   per_job = align(DIV_ROUND_UP(count, num_jobs), vector_length);
+   num_jobs = DIV_ROUND_UP(count, per_job);
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      const unsigned first = i * per_job;
+      struct llvm_vs_job *job = &jobs[i];
+
+      job->fpme = fpme;
+      job->verts = (struct vertex_header *)
+         ((uint8_t *)verts + first * fpme->vertex_size);
+      job->count = MIN2(per_job, count - first);
+      /* Linear fetch indexes from start, indexed fetch from the elts. */
+      job->start = elts ? start : start + first;
+      job->elts = elts ? elts + first : NULL;
+      job->vertex_id_offset = vertex_id_offset;
+
+      /* The first chunk runs on the calling thread. */
+      if (i) {
+         util_queue_fence_init(&job->fence);
+         util_queue_add_job(&draw->vs_queue, job, &job->fence,
+                            llvm_vs_job_execute, NULL, 0);
+      }
+   }
+
+   llvm_vs_run(&jobs[0]);
+   clipped = jobs[0].clipped;
+
+   for (unsigned i = 1; i < num_jobs; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+      clipped |= jobs[i].clipped != 0;
+   }
+
+   return clipped;
+}
+
+
 static void
 llvm_pipeline_generic(struct draw_pt_middle_end *middle,
                       const struct draw_fetch_info *fetch_info,
@@ -555,20 +676,8 @@ llvm_pipeline_generic(struct draw_pt_middle_end *middle,
          elts = fetch_info->elts;
       }
       /* Run vertex fetch shader */
-      clipped = fpme->current_variant->jit_func(&fpme->llvm->vs_jit_context,
-                                                &fpme->llvm->jit_resources[PIPE_SHADER_VERTEX],
-                                                llvm_vert_info.verts,
-                                                draw->pt.user.vbuffer,
-                                                fetch_info->count,
-                                                start,
-                                                fpme->vertex_size,
-                                                draw->pt.vertex_buffer,
-                                                draw->instance_id,
-                                                vertex_id_offset,
-                                                draw->start_instance,
-                                                elts,
-                                                draw->pt.user.drawid,
-                                                draw->pt.user.viewid);
+      clipped = llvm_vs_run_split(fpme, fetch_info, llvm_vert_info.verts,
+                                  start, vertex_id_offset, elts);
 
       /* Finished with fetch and vs */
       fetch_info = NULL;
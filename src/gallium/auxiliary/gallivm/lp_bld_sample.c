@@ -127,6 +127,8 @@ lp_sampler_static_texture_state(struct lp_static_texture_state *state,
    state->pot_height = util_is_power_of_two_or_zero(texture->height0);
    state->pot_depth = util_is_power_of_two_or_zero(texture->depth0);
    state->level_zero_only = !view->u.tex.last_level;
+   state->tiled = !view->is_tex2d_from_buf &&
+                  (texture->flags & LP_RESOURCE_FLAG_TILED);
 
    /*
     * the layer / element / level parameters are all either dynamic
@@ -2141,16 +2143,67 @@ lp_build_sample_partial_offset(struct lp_build_context *bld,
 }
 
 
+/**
+ * Compute the 2D offset of a pixel block in a LP_RESOURCE_FLAG_TILED
+ * texture.
+ *
+ * Pixel blocks are grouped into 4x4 tiles of consecutive blocks, and the
+ * tiles into rows of tiles.  y_stride still is the size of one row of
+ * blocks, so that a row of tiles is 4 * y_stride bytes.  This keeps each
+ * coordinate's contribution separate:
+ *
+ *   x part: ((bx & ~3) * 4 + (bx & 3)) * block_size
+ *   y part: (by & ~3) * y_stride + (by & 3) * 4 * block_size
+ */
+static LLVMValueRef
+lp_build_sample_tiled_offset(struct lp_build_context *bld,
+                             const struct util_format_description *format_desc,
+                             LLVMValueRef x,
+                             LLVMValueRef y,
+                             LLVMValueRef y_stride,
+                             LLVMValueRef *out_i,
+                             LLVMValueRef *out_j)
+{
+   struct gallivm_state *gallivm = bld->gallivm;
+   const unsigned block_size = format_desc->block.bits / 8;
+   LLVMValueRef one = lp_build_const_int_vec(gallivm, bld->type, 1);
+   LLVMValueRef bx, by, lo_mask, hi_mask, x_offset, y_offset;
+
+   /* Split into block coordinates and sub-block pixel coordinates. */
+   lp_build_sample_partial_offset(bld, format_desc->block.width,
+                                  x, one, &bx, out_i);
+   lp_build_sample_partial_offset(bld, format_desc->block.height,
+                                  y, one, &by, out_j);
+
+   lo_mask = lp_build_const_int_vec(gallivm, bld->type, 3);
+   hi_mask = lp_build_const_int_vec(gallivm, bld->type, ~3);
+
+   x_offset = lp_build_add(bld,
+                           lp_build_shl_imm(bld, lp_build_and(bld, bx, hi_mask), 2),
+                           lp_build_and(bld, bx, lo_mask));
+   x_offset = lp_build_mul_imm(bld, x_offset, block_size);
+
+   y_offset = lp_build_mul(bld, lp_build_and(bld, by, hi_mask), y_stride);
+   y_offset = lp_build_add(bld, y_offset,
+                           lp_build_mul_imm(bld, lp_build_and(bld, by, lo_mask),
+                                            4 * block_size));
+
+   return lp_build_add(bld, x_offset, y_offset);
+}
+
+
 /**
  * Compute the offset of a pixel block.
  *
  * x, y, z, y_stride, z_stride are vectors, and they refer to pixels.
+ * tiled selects the LP_RESOURCE_FLAG_TILED layout for x and y.
  *
  * Returns the relative offset and i,j sub-block coordinates
  */
 void
 lp_build_sample_offset(struct lp_build_context *bld,
                        const struct util_format_description *format_desc,
+                       bool tiled,
                        LLVMValueRef x,
                        LLVMValueRef y,
                        LLVMValueRef z,
@@ -2163,6 +2216,19 @@ lp_build_sample_offset(struct lp_build_context *bld,
    LLVMValueRef x_stride;
    LLVMValueRef offset;
 
+   if (tiled && y && y_stride) {
+      offset = lp_build_sample_tiled_offset(bld, format_desc, x, y, y_stride,
+                                            out_i, out_j);
+      if (z && z_stride) {
+         LLVMValueRef z_offset;
+         LLVMValueRef k;
+         lp_build_sample_partial_offset(bld, 1, z, z_stride, &z_offset, &k);
+         offset = lp_build_add(bld, offset, z_offset);
+      }
+      *out_offset = offset;
+      return;
+   }
+
    x_stride = lp_build_const_vec(bld->gallivm, bld->type,
                                  format_desc->block.bits/8);
 
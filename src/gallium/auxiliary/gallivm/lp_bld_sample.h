@@ -182,6 +182,13 @@ struct lp_img_params
  * These are the bits of state from pipe_resource/pipe_sampler_view that
  * are embedded in the generated code.
  */
+/**
+ * Resource flag set by the driver on textures whose blocks are stored in
+ * 4x4 block tiles rather than in linear rows, see lp_build_sample_offset().
+ */
+#define LP_RESOURCE_FLAG_TILED PIPE_RESOURCE_FLAG_DRV_PRIV
+
+
 struct lp_static_texture_state
 {
    /* pipe_sampler_view's state */
@@ -198,6 +205,7 @@ struct lp_static_texture_state
    unsigned pot_height:1;
    unsigned pot_depth:1;
    unsigned level_zero_only:1;
+   unsigned tiled:1;         /**< LP_RESOURCE_FLAG_TILED layout */
 };
 
 
@@ -728,6 +736,7 @@ lp_build_sample_partial_offset(struct lp_build_context *bld,
 void
 lp_build_sample_offset(struct lp_build_context *bld,
                        const struct util_format_description *format_desc,
+                       bool tiled,
                        LLVMValueRef x,
                        LLVMValueRef y,
                        LLVMValueRef z,
@@ -1300,6 +1300,9 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
       else if (strcmp(name, "frametime") == 0) {
          hud_frametime_graph_install(pane);
       }
+      else if (strcmp(name, "hitches") == 0) {
+         hud_hitches_graph_install(pane);
+      }
       else if (strcmp(name, "cpu") == 0) {
          hud_cpu_graph_install(pane, ALL_CPUS);
       }
@@ -1324,6 +1327,20 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
       else if (strcmp(name, "main-thread-busy") == 0) {
          hud_thread_busy_install(pane, name, true);
       }
+      else if (strcmp(name, "API-thread-frametime") == 0) {
+         hud_thread_frametime_install(pane, name, false);
+      }
+      else if (strcmp(name, "main-thread-frametime") == 0) {
+         hud_thread_frametime_install(pane, name, true);
+      }
+      else if (sscanf(name, "tc-call-time-%s", s) == 1) {
+         if (!hud_tc_call_install(pane, name, s, false))
+            fprintf(stderr, "gallium_hud: unknown threaded context call '%s'\n", s);
+      }
+      else if (sscanf(name, "tc-call-count-%s", s) == 1) {
+         if (!hud_tc_call_install(pane, name, s, true))
+            fprintf(stderr, "gallium_hud: unknown threaded context call '%s'\n", s);
+      }
 #ifdef HAVE_GALLIUM_EXTRA_HUD
       else if (sscanf(name, "nic-rx-%s", arg_name) == 1) {
          hud_nic_graph_install(pane, arg_name, NIC_DIRECTION_RX);
@@ -1635,11 +1652,19 @@ print_help(struct pipe_screen *screen)
    puts("    csv (prints the counter values to stdout as CSV, use + to separate names)");
    puts("    fps");
    puts("    frametime");
+   puts("    hitches (frames per period taking twice as long as the average)");
+   puts("    main-thread-frametime (CPU time of the app thread per frame)");
+   puts("    API-thread-frametime (CPU time of the driver thread per frame)");
    puts("    cpu");
 
    for (i = 0; i < num_cpus; i++)
       printf("    cpu%i\n", i);
 
+   puts("    tc-call-time-[call] (driver thread time of a threaded context call,");
+   puts("                         e.g. draw_single, requires GALLIUM_TC_PROFILE)");
+   puts("    tc-call-count-[call] (number of threaded context calls executed,");
+   puts("                          requires GALLIUM_TC_PROFILE)");
+
    if (has_occlusion_query(screen))
       puts("    samples-passed");
    if (has_streamout(screen))
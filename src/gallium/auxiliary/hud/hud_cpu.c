@@ -33,6 +33,7 @@
 #include "util/u_thread.h"
 #include "util/u_memory.h"
 #include "util/u_queue.h"
+#include "util/u_threaded_context.h"
 #include <stdio.h>
 #include <inttypes.h>
 #if DETECT_OS_WINDOWS
@@ -322,6 +323,20 @@ struct thread_info {
    int64_t last_thread_time;
 };
 
+static int64_t
+get_thread_time_nano(struct hud_graph *gr, bool main_thread)
+{
+   if (main_thread)
+      return util_current_thread_get_time_nano();
+
+   struct util_queue_monitoring *mon = gr->pane->hud->monitored_queue;
+
+   if (mon && mon->queue)
+      return util_queue_get_thread_time_nano(mon->queue, 0);
+
+   return 0;
+}
+
 static void
 query_api_thread_busy_status(struct hud_graph *gr, struct pipe_context *pipe)
 {
@@ -330,18 +345,7 @@ query_api_thread_busy_status(struct hud_graph *gr, struct pipe_context *pipe)
 
    if (info->last_time) {
       if (info->last_time + gr->pane->period*1000 <= now) {
-         int64_t thread_now;
-
-         if (info->main_thread) {
-            thread_now = util_current_thread_get_time_nano();
-         } else {
-            struct util_queue_monitoring *mon = gr->pane->hud->monitored_queue;
-
-            if (mon && mon->queue)
-               thread_now = util_queue_get_thread_time_nano(mon->queue, 0);
-            else
-               thread_now = 0;
-         }
+         int64_t thread_now = get_thread_time_nano(gr, info->main_thread);
 
          double percent = (thread_now - info->last_thread_time) * 100.0 /
                             (now - info->last_time);
@@ -364,6 +368,56 @@ query_api_thread_busy_status(struct hud_graph *gr, struct pipe_context *pipe)
    }
 }
 
+/**
+ * CPU time the thread spent during the last frame, in milliseconds.  Meant
+ * to be put into the same pane as "frametime" to see which thread a slow
+ * frame was spent in.
+ */
+static void
+query_thread_frametime(struct hud_graph *gr, struct pipe_context *pipe)
+{
+   struct thread_info *info = gr->query_data;
+   int64_t thread_now = get_thread_time_nano(gr, info->main_thread);
+
+   if (info->last_time) {
+      int64_t delta = thread_now - info->last_thread_time;
+
+      /* The monitored thread changed, see above. */
+      if (delta < 0)
+         delta = 0;
+
+      hud_graph_add_value(gr, delta / 1000000.0);
+   }
+
+   info->last_time = os_time_get_nano();
+   info->last_thread_time = thread_now;
+}
+
+void
+hud_thread_frametime_install(struct hud_pane *pane, const char *name,
+                             bool main)
+{
+   struct hud_graph *gr;
+
+   gr = CALLOC_STRUCT(hud_graph);
+   if (!gr)
+      return;
+
+   snprintf(gr->name, sizeof(gr->name), "%s (ms)", name);
+
+   gr->query_data = CALLOC_STRUCT(thread_info);
+   if (!gr->query_data) {
+      FREE(gr);
+      return;
+   }
+
+   ((struct thread_info*)gr->query_data)->main_thread = main;
+   gr->query_new_value = query_thread_frametime;
+   gr->free_query_data = free_query_data;
+
+   hud_pane_add_graph(pane, gr);
+}
+
 void
 hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main)
 {
@@ -474,3 +528,80 @@ void hud_thread_counter_install(struct hud_pane *pane, const char *name,
    hud_pane_add_graph(pane, gr);
    hud_pane_set_max_value(pane, 100);
 }
+
+struct tc_call_info {
+   enum tc_call_id call;
+   bool count; /* the number of calls instead of the time */
+   uint64_t last_value;
+   int64_t last_time;
+};
+
+static void
+query_tc_call(struct hud_graph *gr, struct pipe_context *pipe)
+{
+   struct tc_call_info *info = gr->query_data;
+   struct tc_call_stats stats;
+   int64_t now = os_time_get_nano();
+
+   if (!threaded_context_get_call_stats(pipe, info->call, &stats))
+      return;
+
+   uint64_t value = info->count ? stats.count : stats.time_ns / 1000;
+
+   if (info->last_time) {
+      if (info->last_time + gr->pane->period*1000 <= now) {
+         hud_graph_add_value(gr, value - info->last_value);
+         info->last_value = value;
+         info->last_time = now;
+      }
+   } else {
+      /* initialize */
+      info->last_value = value;
+      info->last_time = now;
+   }
+}
+
+/**
+ * Graph the driver thread time (in microseconds) or the number of calls of
+ * one threaded context call type per period. This requires
+ * GALLIUM_TC_PROFILE.
+ */
+bool
+hud_tc_call_install(struct hud_pane *pane, const char *name,
+                    const char *call_name, bool count)
+{
+   enum tc_call_id call;
+
+   for (call = 0; call < TC_NUM_CALLS; call++) {
+      if (!strcmp(threaded_context_get_call_name(call), call_name))
+         break;
+   }
+   if (call == TC_NUM_CALLS)
+      return false;
+
+   struct hud_graph *gr = CALLOC_STRUCT(hud_graph);
+   if (!gr)
+      return false;
+
+   strcpy(gr->name, name);
+
+   gr->query_data = CALLOC_STRUCT(tc_call_info);
+   if (!gr->query_data) {
+      FREE(gr);
+      return false;
+   }
+
+   ((struct tc_call_info*)gr->query_data)->call = call;
+   ((struct tc_call_info*)gr->query_data)->count = count;
+   gr->query_new_value = query_tc_call;
+
+   /* Don't use free() as our callback as that messes up Gallium's
+    * memory debugger.  Use simple free_query_data() wrapper.
+    */
+   gr->free_query_data = free_query_data;
+
+   hud_pane_add_graph(pane, gr);
+   if (!count)
+      pane->type = PIPE_DRIVER_QUERY_TYPE_MICROSECONDS;
+   return true;
+}
@@ -66,6 +66,55 @@ query_fps(struct hud_graph *gr, struct pipe_context *pipe)
    }
 }
 
+/* A frame taking this many times longer than the average is a hitch. */
+#define HITCH_FACTOR 2
+
+struct hitch_info {
+   uint64_t last_time;
+   uint64_t last_period_time;
+   double avg_frametime;
+   unsigned hitches;
+};
+
+/**
+ * Number of frames per period that took much longer than the frames before
+ * them.  Those are the stutters that an fps or average frametime graph
+ * smooths away.
+ */
+static void
+query_hitches(struct hud_graph *gr, struct pipe_context *pipe)
+{
+   struct hitch_info *info = gr->query_data;
+   uint64_t now = os_time_get();
+
+   if (!info->last_time) {
+      info->last_time = now;
+      info->last_period_time = now;
+      return;
+   }
+
+   double frametime = (double)(now - info->last_time);
+   info->last_time = now;
+
+   if (info->avg_frametime &&
+       frametime > info->avg_frametime * HITCH_FACTOR)
+      info->hitches++;
+
+   /* Exponential moving average, so that the threshold follows the
+    * workload over time while a single hitch hardly moves it.
+    */
+   if (info->avg_frametime)
+      info->avg_frametime = (info->avg_frametime * 15 + frametime) / 16;
+   else
+      info->avg_frametime = frametime;
+
+   if (info->last_period_time + gr->pane->period <= now) {
+      hud_graph_add_value(gr, info->hitches);
+      info->hitches = 0;
+      info->last_period_time = now;
+   }
+}
+
 static void
 free_query_data(void *p, struct pipe_context *pipe)
 {
@@ -122,3 +171,24 @@ hud_frametime_graph_install(struct hud_pane *pane)
 
    hud_pane_add_graph(pane, gr);
 }
+
+void
+hud_hitches_graph_install(struct hud_pane *pane)
+{
+   struct hud_graph *gr = CALLOC_STRUCT(hud_graph);
+
+   if (!gr)
+      return;
+
+   strcpy(gr->name, "hitches");
+   gr->query_data = CALLOC_STRUCT(hitch_info);
+   if (!gr->query_data) {
+      FREE(gr);
+      return;
+   }
+
+   gr->query_new_value = query_hitches;
+   gr->free_query_data = free_query_data;
+
+   hud_pane_add_graph(pane, gr);
+}
@@ -168,10 +168,15 @@ int hud_get_num_cpus(void);
 
 void hud_fps_graph_install(struct hud_pane *pane);
 void hud_frametime_graph_install(struct hud_pane *pane);
+void hud_hitches_graph_install(struct hud_pane *pane);
 void hud_cpu_graph_install(struct hud_pane *pane, unsigned cpu_index);
 void hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main);
+void hud_thread_frametime_install(struct hud_pane *pane, const char *name,
+                                  bool main);
 void hud_thread_counter_install(struct hud_pane *pane, const char *name,
                                 enum hud_counter counter);
+bool hud_tc_call_install(struct hud_pane *pane, const char *name,
+                         const char *call_name, bool count);
 void hud_pipe_query_install(struct hud_batch_query_context **pbq,
                             struct hud_pane *pane,
                             const char *name,
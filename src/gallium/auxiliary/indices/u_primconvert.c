@@ -56,6 +56,19 @@ struct primconvert_context
    struct pipe_context *pipe;
    struct primconvert_config cfg;
    unsigned api_pv;
+
+   /* Generated indices of the last non-indexed quad (strip) draw, starting
+    * at vertex 0.  Later draws of no more vertices reuse them through
+    * index_bias instead of generating and uploading them again.
+    */
+   struct {
+      struct pipe_resource *buffer;
+      unsigned start;
+      unsigned in_count;
+      unsigned index_size;
+      enum mesa_prim in_mode, out_mode;
+      unsigned pv;
+   } quads;
 };
 
 
@@ -81,6 +94,7 @@ util_primconvert_create(struct pipe_context *pipe, uint32_t primtypes_mask)
 void
 util_primconvert_destroy(struct primconvert_context *pc)
 {
+   pipe_resource_reference(&pc->quads.buffer, NULL);
    FREE(pc);
 }
 
@@ -102,6 +116,65 @@ util_primconvert_save_flatshade_first(struct primconvert_context *pc, bool flats
    pc->api_pv = flatshade_first ? PV_FIRST : PV_LAST;
 }
 
+static bool
+primconvert_init_generated_quads(struct primconvert_context *pc,
+                                 const struct pipe_draw_info *info,
+                                 const struct pipe_draw_start_count_bias *draw,
+                                 struct pipe_draw_info *new_info,
+                                 struct pipe_draw_start_count_bias *new_draw)
+{
+   enum mesa_prim mode;
+   unsigned index_size, count;
+   u_generate_func gen_func;
+
+   if (!pc->quads.buffer || pc->quads.in_mode != info->mode ||
+       pc->quads.pv != pc->api_pv || pc->quads.in_count < draw->count) {
+      /* Round up so that slowly growing draws don't regenerate every time,
+       * quads and quad strips both stay valid with a power of two count.
+       */
+      unsigned in_count = util_next_power_of_two(MAX2(draw->count, 1024));
+      void *dst;
+
+      u_index_generator(pc->cfg.primtypes_mask,
+                        info->mode, 0, in_count,
+                        pc->api_pv, pc->api_pv,
+                        &mode, &index_size, &count,
+                        &gen_func);
+
+      pipe_resource_reference(&pc->quads.buffer, NULL);
+      u_upload_alloc(pc->pipe->stream_uploader, 0, index_size * count, 4,
+                     &pc->quads.start, &pc->quads.buffer, &dst);
+      if (!dst)
+         return false;
+
+      gen_func(0, count, dst);
+      u_upload_unmap(pc->pipe->stream_uploader);
+
+      pc->quads.start /= index_size;
+      pc->quads.in_count = in_count;
+      pc->quads.index_size = index_size;
+      pc->quads.in_mode = info->mode;
+      pc->quads.out_mode = mode;
+      pc->quads.pv = pc->api_pv;
+   }
+
+   /* Only needed for the output count of this draw. */
+   u_index_generator(pc->cfg.primtypes_mask,
+                     info->mode, 0, draw->count,
+                     pc->api_pv, pc->api_pv,
+                     &mode, &index_size, &count,
+                     &gen_func);
+   assert(mode == pc->quads.out_mode);
+
+   new_info->mode = pc->quads.out_mode;
+   new_info->index_size = pc->quads.index_size;
+   pipe_resource_reference(&new_info->index.resource, pc->quads.buffer);
+   new_draw->start = pc->quads.start;
+   new_draw->count = count;
+   new_draw->index_bias = draw->start;
+   return true;
+}
+
 static bool
 primconvert_init_draw(struct primconvert_context *pc,
                       const struct pipe_draw_info *info,
@@ -207,6 +280,11 @@ primconvert_init_draw(struct primconvert_context *pc,
       assert(new_info->mode == mode);
       assert(new_info->index_size == index_size);
    }
+   else if (info->mode == MESA_PRIM_QUADS ||
+            info->mode == MESA_PRIM_QUAD_STRIP) {
+      return primconvert_init_generated_quads(pc, info, &draw, new_info,
+                                              new_draw);
+   }
    else {
       enum mesa_prim mode = 0;
       unsigned index_size;
@@ -39,18 +39,32 @@
  */
 struct pb_cache_entry
 {
-   struct list_head head;
+   struct list_head head; /**< In the bucket list of its size class */
+   struct list_head lru; /**< In pb_cache::lru */
    unsigned start_ms; /**< Cached start time */
    unsigned bucket_index;
 };
 
+/* Buffers in a bucket are further sorted by size class, i.e. by
+ * util_logbase2_64(size), so that only buffers of a compatible size are
+ * looked at when reclaiming.
+ */
+#define PB_CACHE_NUM_SIZE_CLASSES 64
+
 struct pb_cache
 {
    /* The cache is divided into buckets for minimizing cache misses.
     * The driver controls which buffer goes into which bucket.
+    *
+    * This is num_heaps * PB_CACHE_NUM_SIZE_CLASSES lists, see get_bucket().
     */
    struct list_head *buckets;
 
+   /* All cached buffers from the oldest to the most recently added one,
+    * for expiring them without looking at every bucket.
+    */
+   struct list_head lru;
+
    simple_mtx_t mutex;
    void *winsys;
    uint64_t cache_size;
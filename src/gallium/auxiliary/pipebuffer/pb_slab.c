@@ -27,6 +27,7 @@
 
 #include "pb_slab.h"
 
+#include "util/u_atomic.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
 
@@ -71,6 +72,30 @@ pb_slab_reclaim(struct pb_slabs *slabs, struct pb_slab_entry *entry)
    }
 }
 
+/* Move the entries freed by pb_slab_free to the tail of the reclaim list. */
+static void
+pb_slabs_collect_freed_locked(struct pb_slabs *slabs)
+{
+   struct pb_slab_entry *entry = p_atomic_read(&slabs->freed);
+
+   if (!entry)
+      return;
+
+   /* Only pb_slab_free adds entries concurrently, so this is ABA-safe. */
+   struct pb_slab_entry *old;
+   while ((old = p_atomic_cmpxchg_ptr(&slabs->freed, entry, NULL)) != entry)
+      entry = old;
+
+   /* Reverse the order, so that the oldest entries are reclaimed first. */
+   struct list_head freed;
+   list_inithead(&freed);
+
+   for (; entry; entry = entry->next_freed)
+      list_add(&entry->head, &freed);
+
+   list_splicetail(&freed, &slabs->reclaim);
+}
+
 #define MAX_FAILED_RECLAIMS 2
 
 static unsigned
@@ -79,6 +104,9 @@ pb_slabs_reclaim_locked(struct pb_slabs *slabs)
    struct pb_slab_entry *entry, *next;
    unsigned num_failed_reclaims = 0;
    unsigned num_reclaims = 0;
+
+   pb_slabs_collect_freed_locked(slabs);
+
    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &slabs->reclaim, head) {
       if (slabs->can_reclaim(slabs->priv, entry)) {
          pb_slab_reclaim(slabs, entry);
@@ -103,6 +131,9 @@ pb_slabs_reclaim_all_locked(struct pb_slabs *slabs)
 {
    struct pb_slab_entry *entry, *next;
    unsigned num_reclaims = 0;
+
+   pb_slabs_collect_freed_locked(slabs);
+
    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &slabs->reclaim, head) {
       if (slabs->can_reclaim(slabs->priv, entry)) {
          pb_slab_reclaim(slabs, entry);
@@ -206,13 +237,21 @@ pb_slab_alloc(struct pb_slabs *slabs, unsigned size, unsigned heap)
  * The entry may still be in use e.g. by in-flight command submissions. The
  * can_reclaim callback function will be called to determine whether the entry
  * can be handed out again by pb_slab_alloc.
+ *
+ * This doesn't take the mutex, the entry is only added to the reclaim list
+ * by the next reclaim.
  */
 void
 pb_slab_free(struct pb_slabs* slabs, struct pb_slab_entry *entry)
 {
-   simple_mtx_lock(&slabs->mutex);
-   list_addtail(&entry->head, &slabs->reclaim);
-   simple_mtx_unlock(&slabs->mutex);
+   struct pb_slab_entry *head = p_atomic_read(&slabs->freed);
+   struct pb_slab_entry *old;
+
+   do {
+      entry->next_freed = head;
+      old = head;
+      head = p_atomic_cmpxchg_ptr(&slabs->freed, old, entry);
+   } while (head != old);
 }
 
 /* Check if any of the entries handed to pb_slab_free are ready to be re-used.
@@ -264,6 +303,7 @@ pb_slabs_init(struct pb_slabs *slabs,
    slabs->slab_free = slab_free;
 
    list_inithead(&slabs->reclaim);
+   slabs->freed = NULL;
 
    num_groups = slabs->num_orders * slabs->num_heaps *
                 (1 + allow_three_fourth_allocations);
@@ -293,6 +333,8 @@ pb_slabs_deinit(struct pb_slabs *slabs)
    /* Reclaim all slab entries (even those that are still in flight). This
     * implicitly calls slab_free for everything.
     */
+   pb_slabs_collect_freed_locked(slabs);
+
    while (!list_is_empty(&slabs->reclaim)) {
       struct pb_slab_entry *entry =
          list_entry(slabs->reclaim.next, struct pb_slab_entry, head);
@@ -62,6 +62,7 @@ struct pb_slab_entry
 {
    struct list_head head;
    struct pb_slab *slab; /* the slab that contains this buffer */
+   struct pb_slab_entry *next_freed; /* link in pb_slabs::freed */
 };
 
 /* Descriptor of a slab from which many entries are carved out.
@@ -128,6 +129,12 @@ struct pb_slabs
     */
    struct list_head reclaim;
 
+   /* Entries passed to pb_slab_free that haven't been moved to the reclaim
+    * list yet, most-recently freed first. This is a lock-free stack, so that
+    * freeing doesn't contend with allocations for the mutex.
+    */
+   struct pb_slab_entry *freed;
+
    void *priv;
    slab_can_reclaim_fn *can_reclaim;
    slab_alloc_fn *slab_alloc;
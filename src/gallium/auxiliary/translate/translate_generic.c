@@ -73,9 +73,19 @@ struct translate_generic {
        */
       int copy_size;
 
+      /* size of one input element in bytes, or 0 if not byte aligned */
+      unsigned input_size;
+
    } attrib[TRANSLATE_MAX_ATTRIBS];
 
    unsigned nr_attrib;
+
+   /* Attributes which need a conversion and whose input elements are
+    * tightly packed (stride == element size, no instancing): for the
+    * linear run these are unpacked for a whole batch of vertices with a
+    * single fetch call instead of one call per vertex.
+    */
+   uint64_t packed_mask;
 };
 
 
@@ -590,7 +600,8 @@ generic_run_one(struct translate_generic *tg,
                 unsigned start_instance,
                 unsigned instance_id,
                 void *vert,
-                unsigned index_size)
+                unsigned index_size,
+                uint64_t skip_mask)
 {
    unsigned nr_attrs = tg->nr_attrib;
    unsigned attr;
@@ -599,6 +610,9 @@ generic_run_one(struct translate_generic *tg,
       float data[4];
       uint8_t *dst = (uint8_t *)vert + tg->attrib[attr].output_offset;
 
+      if (skip_mask & BITFIELD64_BIT(attr))
+         continue;
+
       if (tg->attrib[attr].type == TRANSLATE_ELEMENT_NORMAL) {
          const uint8_t *src;
          unsigned index;
@@ -667,7 +681,7 @@ generic_run_elts(struct translate *translate,
    unsigned i;
 
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 4);
+      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 4, 0);
       vert += tg->translate.key.output_stride;
    }
 }
@@ -685,7 +699,7 @@ generic_run_elts16(struct translate *translate,
    unsigned i;
 
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 2);
+      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 2, 0);
       vert += tg->translate.key.output_stride;
    }
 }
@@ -703,11 +717,14 @@ generic_run_elts8(struct translate *translate,
    unsigned i;
 
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 1);
+      generic_run_one(tg, *elts++, start_instance, instance_id, vert, 1, 0);
       vert += tg->translate.key.output_stride;
    }
 }
 
+/* Number of vertices unpacked at once for packed attributes. */
+#define GENERIC_RUN_BATCH 64
+
 static void UTIL_CDECL
 generic_run(struct translate *translate,
             unsigned start,
@@ -717,12 +734,36 @@ generic_run(struct translate *translate,
             void *output_buffer)
 {
    struct translate_generic *tg = translate_generic(translate);
+   const unsigned output_stride = tg->translate.key.output_stride;
    char *vert = output_buffer;
    unsigned i;
 
+   u_foreach_bit64(attr, tg->packed_mask) {
+      const uint8_t *src = tg->attrib[attr].input_ptr +
+                           (ptrdiff_t)tg->attrib[attr].input_size * start;
+      char *dst = vert + tg->attrib[attr].output_offset;
+      float data[GENERIC_RUN_BATCH][4];
+
+      for (i = 0; i < count; i += GENERIC_RUN_BATCH) {
+         const unsigned n = MIN2(count - i, GENERIC_RUN_BATCH);
+
+         tg->attrib[attr].fetch(data, src, n);
+         src += tg->attrib[attr].input_size * n;
+
+         for (unsigned j = 0; j < n; j++) {
+            tg->attrib[attr].emit(data[j], dst);
+            dst += output_stride;
+         }
+      }
+   }
+
+   if (tg->packed_mask == BITFIELD64_MASK(tg->nr_attrib))
+      return;
+
    for (i = 0; i < count; i++) {
-      generic_run_one(tg, start + i, start_instance, instance_id, vert, 0);
-      vert += tg->translate.key.output_stride;
+      generic_run_one(tg, start + i, start_instance, instance_id, vert, 0,
+                      tg->packed_mask);
+      vert += output_stride;
    }
 }
 
@@ -744,6 +785,15 @@ generic_set_buffer(struct translate *translate,
                                     tg->attrib[i].input_offset);
          tg->attrib[i].input_stride = stride;
          tg->attrib[i].max_index = max_index;
+
+         if (tg->attrib[i].type == TRANSLATE_ELEMENT_NORMAL &&
+             tg->attrib[i].copy_size < 0 &&
+             !tg->attrib[i].instance_divisor &&
+             tg->attrib[i].input_size &&
+             stride == tg->attrib[i].input_size)
+            tg->packed_mask |= BITFIELD64_BIT(i);
+         else
+            tg->packed_mask &= ~BITFIELD64_BIT(i);
       }
    }
 }
@@ -822,6 +872,11 @@ translate_generic_create(const struct translate_key *key)
 
       tg->attrib[i].output_offset = key->element[i].output_offset;
 
+      if (format_desc->block.width == 1 &&
+          format_desc->block.height == 1 &&
+          !(format_desc->block.bits & 7))
+         tg->attrib[i].input_size = format_desc->block.bits >> 3;
+
       tg->attrib[i].copy_size = -1;
       if (tg->attrib[i].type == TRANSLATE_ELEMENT_INSTANCE_ID) {
          if (key->element[i].output_format == PIPE_FORMAT_R32_USCALED
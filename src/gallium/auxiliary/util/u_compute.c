@@ -217,3 +217,159 @@ void util_compute_blit(struct pipe_context *ctx, struct pipe_blit_info *blit_inf
    ctx->delete_sampler_state(ctx, sampler_state_p);
    ctx->bind_compute_state(ctx, NULL);
 }
+
+static void *buffer_compute_shader(struct pipe_context *ctx, bool clear)
+{
+   /*
+      #version 450
+
+      layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+      layout (binding = 0) writeonly buffer dst_buf { uint dst[]; };
+      layout (binding = 1) readonly buffer src_buf { uint src[]; };
+
+      layout (std140, binding = 0) uniform ubo
+      {
+         uvec4 params; // dst offset, src offset, dword count, value dwords
+         uvec4 value;
+      };
+
+      void main()
+      {
+         uint i = gl_GlobalInvocationID.x;
+         if (i < params.z)
+            dst[params.x / 4 + i] = clear ? value[i % params.w]
+                                          : src[params.y / 4 + i];
+      }
+   */
+   const nir_shader_compiler_options *options =
+      ctx->screen->get_compiler_options(ctx->screen, PIPE_SHADER_IR_NIR, PIPE_SHADER_COMPUTE);
+
+   nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, options,
+                                                  clear ? "clear_buffer_cs" : "copy_buffer_cs");
+   b.shader->info.workgroup_size[0] = 64;
+   b.shader->info.workgroup_size[1] = 1;
+   b.shader->info.workgroup_size[2] = 1;
+   b.shader->info.num_ubos = 1;
+   b.shader->info.num_ssbos = clear ? 1 : 2;
+
+   nir_def *zero = nir_imm_int(&b, 0);
+   nir_def *params = nir_load_ubo(&b, 4, 32, zero, zero, .align_mul = 4, .range = ~0);
+   b.shader->num_uniforms = 2;
+
+   nir_def *block_id = nir_channel(&b, nir_load_workgroup_id(&b), 0);
+   nir_def *local_id = nir_channel(&b, nir_load_local_invocation_id(&b), 0);
+   nir_def *id = nir_iadd(&b, nir_imul_imm(&b, block_id, 64), local_id);
+
+   nir_push_if(&b, nir_ult(&b, id, nir_channel(&b, params, 2)));
+
+   nir_def *offset = nir_ishl_imm(&b, id, 2);
+   nir_def *data;
+
+   if (clear) {
+      nir_def *value = nir_load_ubo(&b, 4, 32, zero, nir_imm_int(&b, 16),
+                                    .align_mul = 4, .range = ~0);
+      data = nir_vector_extract(&b, value, nir_umod(&b, id, nir_channel(&b, params, 3)));
+   } else {
+      data = nir_load_ssbo(&b, 1, 32, nir_imm_int(&b, 1),
+                           nir_iadd(&b, nir_channel(&b, params, 1), offset),
+                           .align_mul = 4);
+   }
+
+   nir_store_ssbo(&b, data, zero, nir_iadd(&b, nir_channel(&b, params, 0), offset),
+                  .write_mask = 0x1, .align_mul = 4);
+
+   nir_pop_if(&b, NULL);
+
+   ctx->screen->finalize_nir(ctx->screen, b.shader);
+
+   struct pipe_compute_state state = {0};
+   state.ir_type = PIPE_SHADER_IR_NIR;
+   state.prog = b.shader;
+
+   return ctx->create_compute_state(ctx, &state);
+}
+
+static void
+buffer_compute_dispatch(struct pipe_context *ctx, struct pipe_resource *dst,
+                        struct pipe_resource *src, const uint32_t data[8],
+                        unsigned num_dwords, void **compute_state, bool clear)
+{
+   struct pipe_constant_buffer cb = {0};
+   cb.buffer_size = 8 * sizeof(uint32_t);
+   cb.user_buffer = data;
+   ctx->set_constant_buffer(ctx, PIPE_SHADER_COMPUTE, 0, false, &cb);
+
+   struct pipe_shader_buffer sb[2] = {0};
+   sb[0].buffer = dst;
+   sb[0].buffer_size = dst->width0;
+   sb[1].buffer = src;
+   sb[1].buffer_size = src ? src->width0 : 0;
+   ctx->set_shader_buffers(ctx, PIPE_SHADER_COMPUTE, 0, src ? 2 : 1, sb, 0x1);
+
+   if (!*compute_state)
+      *compute_state = buffer_compute_shader(ctx, clear);
+   ctx->bind_compute_state(ctx, *compute_state);
+
+   struct pipe_grid_info grid_info = {0};
+   grid_info.block[0] = 64;
+   grid_info.block[1] = 1;
+   grid_info.block[2] = 1;
+   grid_info.grid[0] = DIV_ROUND_UP(num_dwords, 64);
+   grid_info.grid[1] = 1;
+   grid_info.grid[2] = 1;
+
+   ctx->launch_grid(ctx, &grid_info);
+
+   ctx->memory_barrier(ctx, PIPE_BARRIER_ALL);
+
+   ctx->set_shader_buffers(ctx, PIPE_SHADER_COMPUTE, 0, src ? 2 : 1, NULL, 0);
+   ctx->set_constant_buffer(ctx, PIPE_SHADER_COMPUTE, 0, false, NULL);
+   ctx->bind_compute_state(ctx, NULL);
+}
+
+/**
+ * Copy a buffer range with a compute shader, which doesn't touch any 3D
+ * state. Offsets and size must be multiples of 4, see
+ * util_compute_can_copy_buffer().
+ *
+ * Like util_compute_blit(), this clobbers the compute shader, constant
+ * buffer 0 and shader buffers 0-1 of the compute stage.
+ */
+void util_compute_copy_buffer(struct pipe_context *ctx,
+                              struct pipe_resource *dst, unsigned dst_offset,
+                              struct pipe_resource *src, unsigned src_offset,
+                              unsigned size, void **compute_state)
+{
+   assert(util_compute_can_copy_buffer(dst_offset, src_offset, size));
+
+   if (!size)
+      return;
+
+   const uint32_t data[8] = { dst_offset, src_offset, size / 4, 0 };
+
+   buffer_compute_dispatch(ctx, dst, src, data, size / 4, compute_state, false);
+}
+
+/**
+ * Fill a buffer range with a repeated 4, 8 or 16 byte value with a compute
+ * shader. Offset and size must be multiples of 4.
+ *
+ * See util_compute_copy_buffer() for the state that is clobbered.
+ */
+void util_compute_clear_buffer(struct pipe_context *ctx,
+                               struct pipe_resource *dst, unsigned offset,
+                               unsigned size, const void *clear_value,
+                               int clear_value_size, void **compute_state)
+{
+   assert(offset % 4 == 0 && size % 4 == 0);
+   assert(clear_value_size == 4 || clear_value_size == 8 ||
+          clear_value_size == 16);
+
+   if (!size)
+      return;
+
+   uint32_t data[8] = { offset, 0, size / 4, clear_value_size / 4 };
+   memcpy(&data[4], clear_value, clear_value_size);
+
+   buffer_compute_dispatch(ctx, dst, NULL, data, size / 4, compute_state, true);
+}
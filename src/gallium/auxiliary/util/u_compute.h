@@ -38,6 +38,23 @@ extern "C" {
 void util_compute_blit(struct pipe_context *ctx, struct pipe_blit_info *blit_info,
                        void **compute_state);
 
+static inline bool
+util_compute_can_copy_buffer(unsigned dst_offset, unsigned src_offset,
+                             unsigned size)
+{
+   return dst_offset % 4 == 0 && src_offset % 4 == 0 && size % 4 == 0;
+}
+
+void util_compute_copy_buffer(struct pipe_context *ctx,
+                              struct pipe_resource *dst, unsigned dst_offset,
+                              struct pipe_resource *src, unsigned src_offset,
+                              unsigned size, void **compute_state);
+
+void util_compute_clear_buffer(struct pipe_context *ctx,
+                               struct pipe_resource *dst, unsigned offset,
+                               unsigned size, const void *clear_value,
+                               int clear_value_size, void **compute_state);
+
 #ifdef __cplusplus
 }
 #endif
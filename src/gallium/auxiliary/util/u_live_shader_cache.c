@@ -32,6 +32,7 @@
 
 #include "util/blob.h"
 #include "util/hash_table.h"
+#include "util/u_atomic.h"
 #include "util/mesa-sha1.h"
 
 static uint32_t key_hash(const void *key)
@@ -52,8 +53,7 @@ util_live_shader_cache_init(struct util_live_shader_cache *cache,
                                                    const struct pipe_shader_state *state),
                             void (*destroy_shader)(struct pipe_context *, void *))
 {
-   simple_mtx_init(&cache->lock, mtx_plain);
-   cache->hashtable = _mesa_hash_table_create(NULL, key_hash, key_equals);
+   util_sharded_hash_table_init(&cache->hashtable, NULL, key_hash, key_equals);
    cache->create_shader = create_shader;
    cache->destroy_shader = destroy_shader;
 }
@@ -61,10 +61,9 @@ util_live_shader_cache_init(struct util_live_shader_cache *cache,
 void
 util_live_shader_cache_deinit(struct util_live_shader_cache *cache)
 {
-   if (cache->hashtable) {
+   if (cache->hashtable.key_hash_function) {
       /* The hash table should be empty at this point. */
-      _mesa_hash_table_destroy(cache->hashtable, NULL);
-      simple_mtx_destroy(&cache->lock);
+      util_sharded_hash_table_fini(&cache->hashtable, NULL);
    }
 }
 
@@ -114,16 +113,17 @@ util_live_shader_cache_get(struct pipe_context *ctx,
       blob_finish(&blob);
 
    /* Find the shader in the live cache. */
-   simple_mtx_lock(&cache->lock);
-   struct hash_entry *entry = _mesa_hash_table_search(cache->hashtable, sha1);
+   uint32_t hash = util_sharded_hash_table_hash(&cache->hashtable, sha1);
+   struct hash_table *ht = util_sharded_hash_table_lock(&cache->hashtable, hash);
+   struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(ht, hash, sha1);
    struct util_live_shader *shader = entry ? entry->data : NULL;
 
    /* Increase the refcount. */
    if (shader) {
       pipe_reference(NULL, &shader->reference);
-      cache->hits++;
+      p_atomic_inc(&cache->hits);
    }
-   simple_mtx_unlock(&cache->lock);
+   util_sharded_hash_table_unlock(&cache->hashtable, hash);
 
    if (cache_hit)
       *cache_hit = (shader != NULL);
@@ -142,11 +142,11 @@ util_live_shader_cache_get(struct pipe_context *ctx,
    pipe_reference_init(&shader->reference, 1);
    memcpy(shader->sha1, sha1, sizeof(sha1));
 
-   simple_mtx_lock(&cache->lock);
+   ht = util_sharded_hash_table_lock(&cache->hashtable, hash);
    /* The same shader might have been created in parallel. This is rare.
     * If so, keep the one already in cache.
     */
-   struct hash_entry *entry2 = _mesa_hash_table_search(cache->hashtable, sha1);
+   struct hash_entry *entry2 = _mesa_hash_table_search_pre_hashed(ht, hash, sha1);
    struct util_live_shader *shader2 = entry2 ? entry2->data : NULL;
 
    if (shader2) {
@@ -155,10 +155,10 @@ util_live_shader_cache_get(struct pipe_context *ctx,
       /* Increase the refcount. */
       pipe_reference(NULL, &shader->reference);
    } else {
-      _mesa_hash_table_insert(cache->hashtable, shader->sha1, shader);
+      _mesa_hash_table_insert_pre_hashed(ht, hash, shader->sha1, shader);
    }
-   cache->misses++;
-   simple_mtx_unlock(&cache->lock);
+   p_atomic_inc(&cache->misses);
+   util_sharded_hash_table_unlock(&cache->hashtable, hash);
 
    return shader;
 }
@@ -174,15 +174,25 @@ util_shader_reference(struct pipe_context *ctx,
    struct util_live_shader *dst_shader = (struct util_live_shader*)*dst;
    struct util_live_shader *src_shader = (struct util_live_shader*)src;
 
-   simple_mtx_lock(&cache->lock);
+   /* Only the shard owning dst needs to be locked: the reference count of
+    * src is only ever increased, which can't race with its removal.
+    */
+   uint32_t hash = 0;
+   if (dst_shader) {
+      hash = util_sharded_hash_table_hash(&cache->hashtable, dst_shader->sha1);
+      util_sharded_hash_table_lock(&cache->hashtable, hash);
+   }
    bool destroy = pipe_reference(&dst_shader->reference, &src_shader->reference);
    if (destroy) {
-      struct hash_entry *entry = _mesa_hash_table_search(cache->hashtable,
-                                                         dst_shader->sha1);
+      struct hash_table *ht =
+         &util_sharded_hash_table_get_shard(&cache->hashtable, hash)->table;
+      struct hash_entry *entry =
+         _mesa_hash_table_search_pre_hashed(ht, hash, dst_shader->sha1);
       assert(entry);
-      _mesa_hash_table_remove(cache->hashtable, entry);
+      _mesa_hash_table_remove(ht, entry);
    }
-   simple_mtx_unlock(&cache->lock);
+   if (dst_shader)
+      util_sharded_hash_table_unlock(&cache->hashtable, hash);
 
    if (destroy)
       cache->destroy_shader(ctx, dst_shader);
@@ -49,7 +49,7 @@
 #ifndef U_LIVE_SHADER_CACHE_H
 #define U_LIVE_SHADER_CACHE_H
 
-#include "util/simple_mtx.h"
+#include "util/u_sharded_hash_table.h"
 #include "pipe/p_state.h"
 
 #ifdef __cplusplus
@@ -57,8 +57,10 @@ extern "C" {
 #endif
 
 struct util_live_shader_cache {
-   simple_mtx_t lock;
-   struct hash_table *hashtable;
+   /* Sharded so that contexts creating different shaders in parallel don't
+    * contend on a single lock.
+    */
+   struct util_sharded_hash_table hashtable;
 
    void *(*create_shader)(struct pipe_context *,
                           const struct pipe_shader_state *state);
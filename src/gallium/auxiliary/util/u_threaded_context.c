@@ -33,6 +33,7 @@
 #include "driver_trace/tr_context.h"
 #include "util/log.h"
 #include "util/perf/cpu_trace.h"
+#include "util/u_qsort.h"
 #include "util/thread_sched.h"
 #include "compiler/shader_info.h"
 
@@ -54,13 +55,14 @@
 
 #define TC_SENTINEL 0x5ca1ab1e
 
-#if TC_DEBUG >= 3 || defined(TC_TRACE)
 static const char *tc_call_names[] = {
 #define CALL(name) #name,
 #include "u_threaded_context_calls.h"
 #undef CALL
 };
-#endif
+
+/* How long the driver thread polls an empty batch ring before going idle. */
+#define TC_BATCH_RING_SPIN_NS 20000
 
 #ifdef TC_TRACE
 #  define TC_TRACE_SCOPE(call_id) MESA_TRACE_SCOPE(tc_call_names[call_id])
@@ -431,7 +433,8 @@ incr_rp_info(struct tc_renderpass_info *tc_info)
 }
 
 ALWAYS_INLINE static void
-batch_execute(struct tc_batch *batch, struct pipe_context *pipe, uint64_t *last, bool parsing)
+batch_execute(struct tc_batch *batch, struct pipe_context *pipe, uint64_t *last, bool parsing,
+              bool profiling)
 {
    /* if the framebuffer state is persisting from a previous batch,
     * begin incrementing renderpass info on the first set_framebuffer_state call
@@ -450,7 +453,18 @@ batch_execute(struct tc_batch *batch, struct pipe_context *pipe, uint64_t *last,
 
       TC_TRACE_SCOPE(call->call_id);
 
-      iter += execute_func[call->call_id](pipe, call);
+      if (profiling) {
+         enum tc_call_id call_id = call->call_id;
+         int64_t start = os_time_get_nano();
+
+         iter += execute_func[call_id](pipe, call);
+
+         struct tc_call_stats *stats = &batch->tc->call_stats[call_id];
+         stats->count++;
+         stats->time_ns += os_time_get_nano() - start;
+      } else {
+         iter += execute_func[call->call_id](pipe, call);
+      }
 
       if (parsing) {
          if (call->call_id == TC_CALL_flush) {
@@ -492,7 +506,10 @@ tc_batch_execute(void *job, UNUSED void *gdata, int thread_index)
    batch->tc->renderpass_info = batch->renderpass_infos.data;
 
    if (batch->tc->options.parse_renderpass_info) {
-      batch_execute(batch, pipe, last, true);
+      if (unlikely(batch->tc->profile_calls))
+         batch_execute(batch, pipe, last, true, true);
+      else
+         batch_execute(batch, pipe, last, true, false);
 
       struct tc_batch_rp_info *info = batch->renderpass_infos.data;
       for (unsigned i = 0; i < batch->max_renderpass_info_idx + 1; i++) {
@@ -501,7 +518,10 @@ tc_batch_execute(void *job, UNUSED void *gdata, int thread_index)
          info[i].next = NULL;
       }
    } else {
-      batch_execute(batch, pipe, last, false);
+      if (unlikely(batch->tc->profile_calls))
+         batch_execute(batch, pipe, last, false, true);
+      else
+         batch_execute(batch, pipe, last, false, false);
    }
 
    /* Add the fence to the list of fences for the driver to signal at the next
@@ -536,6 +556,65 @@ tc_batch_execute(void *job, UNUSED void *gdata, int thread_index)
    batch->tc->last_completed = batch->batch_idx;
 }
 
+/* Read a ring counter with a read-modify-write operation, so that it's
+ * ordered against the preceding atomic update of batch_ring_active or
+ * batch_ring_submitted done by the same thread.
+ */
+#define tc_ring_read_ordered(v) p_atomic_add_return((v), 0)
+
+/* Executes flushed batches in order as long as the application thread keeps
+ * submitting them. This runs as a queue job and returns when the ring has
+ * been empty for TC_BATCH_RING_SPIN_NS.
+ */
+static void
+tc_batch_ring_execute(void *job, UNUSED void *gdata, int thread_index)
+{
+   struct threaded_context *tc = job;
+
+   while (1) {
+      unsigned executed = tc->batch_ring_executed;
+
+      if (p_atomic_read(&tc->batch_ring_submitted) == executed) {
+         int64_t spin_end = os_time_get_nano() + TC_BATCH_RING_SPIN_NS;
+
+         while (p_atomic_read(&tc->batch_ring_submitted) == executed &&
+                os_time_get_nano() < spin_end)
+            ;
+      }
+
+      if (p_atomic_read(&tc->batch_ring_submitted) == executed) {
+         /* Go idle. The application thread checks batch_ring_active after
+          * submitting a batch, so either it sees that we are idle and
+          * restarts us, or we see its batch here and resume.
+          */
+         p_atomic_xchg(&tc->batch_ring_active, 0);
+         if (tc_ring_read_ordered(&tc->batch_ring_submitted) == executed ||
+             p_atomic_cmpxchg(&tc->batch_ring_active, 0, 1) != 0)
+            return;
+         continue;
+      }
+
+      struct tc_batch *batch = tc->batch_ring[executed % TC_MAX_BATCHES];
+
+      tc_batch_execute(batch, NULL, thread_index);
+      p_atomic_set(&tc->batch_ring_executed, executed + 1);
+      util_queue_fence_signal(&batch->fence);
+   }
+}
+
+static void
+tc_batch_ring_submit(struct threaded_context *tc, struct tc_batch *batch)
+{
+   util_queue_fence_reset(&batch->fence);
+   tc->batch_ring[tc->batch_ring_submitted % TC_MAX_BATCHES] = batch;
+   p_atomic_inc(&tc->batch_ring_submitted);
+
+   if (p_atomic_cmpxchg(&tc->batch_ring_active, 0, 1) == 0) {
+      util_queue_add_job(&tc->queue, tc, NULL, tc_batch_ring_execute,
+                         NULL, 0);
+   }
+}
+
 static void
 tc_begin_next_buffer_list(struct threaded_context *tc)
 {
@@ -579,6 +658,7 @@ tc_batch_flush(struct threaded_context *tc, bool full_copy)
    tc_batch_check(next);
    tc_debug_check(tc);
    tc->bytes_mapped_estimate = 0;
+   tc->frame_num_slots += next->num_total_slots;
    p_atomic_add(&tc->num_offloaded_slots, next->num_total_slots);
 
    if (next->token) {
@@ -596,12 +676,20 @@ tc_batch_flush(struct threaded_context *tc, bool full_copy)
       tc_batch_increment_renderpass_info(tc, next_id, full_copy);
    }
 
-   util_queue_add_job(&tc->queue, next, &next->fence, tc_batch_execute,
-                      NULL, 0);
+   tc_batch_ring_submit(tc, next);
    tc->last = tc->next;
    tc->next = next_id;
    if (next_id == 0)
       tc->batch_generation++;
+
+   /* The ring doesn't throttle the application thread, so wait until the
+    * batch that will record the next commands has been executed. This keeps
+    * at most TC_MAX_BATCHES - 1 batches in flight.
+    */
+   if (!util_queue_fence_is_signalled(&tc->batch_slots[next_id].fence)) {
+      tc->frame_num_stalls++;
+      util_queue_fence_wait(&tc->batch_slots[next_id].fence);
+   }
    tc_begin_next_buffer_list(tc);
 
 }
@@ -619,7 +707,8 @@ tc_add_sized_call(struct threaded_context *tc, enum tc_call_id id,
    assert(num_slots <= TC_SLOTS_PER_BATCH - 1);
    tc_debug_check(tc);
 
-   if (unlikely(next->num_total_slots + num_slots > TC_SLOTS_PER_BATCH - 1)) {
+   if (unlikely(next->num_total_slots + num_slots > tc->batch_slot_limit - 1 &&
+                next->num_total_slots)) {
       /* copy existing renderpass info during flush */
       tc_batch_flush(tc, true);
       next = &tc->batch_slots[tc->next];
@@ -685,7 +774,7 @@ tc_enlarge_last_mergeable_call(struct threaded_context *tc, unsigned desired_num
 
    unsigned added_slots = desired_num_slots - call->num_slots;
 
-   if (unlikely(batch->num_total_slots + added_slots > TC_SLOTS_PER_BATCH - 1))
+   if (unlikely(batch->num_total_slots + added_slots > tc->batch_slot_limit - 1))
       return false;
 
    batch->num_total_slots += added_slots;
@@ -754,6 +843,7 @@ _tc_sync(struct threaded_context *tc, UNUSED const char *info, UNUSED const char
    /* .. and execute unflushed calls directly. */
    if (next->num_total_slots) {
       p_atomic_add(&tc->num_direct_slots, next->num_total_slots);
+      tc->frame_num_slots += next->num_total_slots;
       tc->bytes_mapped_estimate = 0;
       tc_add_call_end(next);
       tc_batch_execute(next, NULL, 0);
@@ -3593,6 +3683,30 @@ tc_call_flush(struct pipe_context *pipe, void *call)
    return call_size(tc_flush_call);
 }
 
+/* Choose the batch size for the next frame from the statistics of the frame
+ * that just ended. The goal is to split a frame into about half of the
+ * available batches, so that the driver thread starts working early in light
+ * frames while the application thread can still run ahead without waiting
+ * for free batches in heavy ones.
+ */
+static void
+tc_adapt_batch_size(struct threaded_context *tc)
+{
+   unsigned target = tc->frame_num_slots / (TC_MAX_BATCHES / 2);
+
+   /* Running out of batches means they are too small for this frame. */
+   if (tc->frame_num_stalls)
+      target = MAX2(target, tc->batch_slot_limit * 2);
+
+   target = CLAMP(util_next_power_of_two(MAX2(target, 1)),
+                  TC_MIN_SLOTS_PER_BATCH, TC_SLOTS_PER_BATCH);
+
+   /* Cut the sizes in half at most once per frame to avoid oscillating. */
+   tc->batch_slot_limit = MAX2(target, tc->batch_slot_limit / 2);
+   tc->frame_num_slots = 0;
+   tc->frame_num_stalls = 0;
+}
+
 static void
 tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
          unsigned flags)
@@ -3603,6 +3717,9 @@ tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
    bool async = flags & (PIPE_FLUSH_DEFERRED | PIPE_FLUSH_ASYNC);
    bool deferred = (flags & PIPE_FLUSH_DEFERRED) > 0;
 
+   if (tc->options.adaptive_batch_size && flags & PIPE_FLUSH_END_OF_FRAME)
+      tc_adapt_batch_size(tc);
+
    if (!deferred || !fence)
       tc->in_renderpass = false;
 
@@ -4007,10 +4124,10 @@ tc_draw_multi(struct pipe_context *_pipe, const struct pipe_draw_info *info,
    while (num_draws) {
       struct tc_batch *next = &tc->batch_slots[tc->next];
 
-      int nb_slots_left = TC_SLOTS_PER_BATCH - 1 - next->num_total_slots;
+      int nb_slots_left = tc->batch_slot_limit - 1 - next->num_total_slots;
       /* If there isn't enough place for one draw, try to fill the next one */
       if (nb_slots_left < SLOTS_FOR_ONE_DRAW)
-         nb_slots_left = TC_SLOTS_PER_BATCH - 1;
+         nb_slots_left = tc->batch_slot_limit - 1;
       const int size_left_bytes = nb_slots_left * sizeof(struct tc_call_base);
 
       /* How many draws can we fit in the current batch */
@@ -4076,10 +4193,10 @@ tc_draw_user_indices_multi(struct pipe_context *_pipe,
    while (num_draws) {
       struct tc_batch *next = &tc->batch_slots[tc->next];
 
-      int nb_slots_left = TC_SLOTS_PER_BATCH - 1 - next->num_total_slots;
+      int nb_slots_left = tc->batch_slot_limit - 1 - next->num_total_slots;
       /* If there isn't enough place for one draw, try to fill the next one */
       if (nb_slots_left < SLOTS_FOR_ONE_DRAW)
-         nb_slots_left = TC_SLOTS_PER_BATCH - 1;
+         nb_slots_left = tc->batch_slot_limit - 1;
       const int size_left_bytes = nb_slots_left * sizeof(struct tc_call_base);
 
       /* How many draws can we fit in the current batch */
@@ -4371,10 +4488,10 @@ tc_draw_vertex_state(struct pipe_context *_pipe,
    while (num_draws) {
       struct tc_batch *next = &tc->batch_slots[tc->next];
 
-      int nb_slots_left = TC_SLOTS_PER_BATCH - 1 - next->num_total_slots;
+      int nb_slots_left = tc->batch_slot_limit - 1 - next->num_total_slots;
       /* If there isn't enough place for one draw, try to fill the next one */
       if (nb_slots_left < slots_for_one_draw)
-         nb_slots_left = TC_SLOTS_PER_BATCH - 1;
+         nb_slots_left = tc->batch_slot_limit - 1;
       const int size_left_bytes = nb_slots_left * sizeof(struct tc_call_base);
 
       /* How many draws can we fit in the current batch */
@@ -5078,6 +5195,73 @@ tc_callback(struct pipe_context *_pipe, void (*fn)(void *), void *data,
  * create & destroy
  */
 
+const char *
+threaded_context_get_call_name(enum tc_call_id id)
+{
+   return id < TC_NUM_CALLS ? tc_call_names[id] : NULL;
+}
+
+/**
+ * Return the statistics of one call type if \p pipe is a threaded context
+ * created with GALLIUM_TC_PROFILE. The values are cumulative and may be
+ * slightly out of date since they are updated by the driver thread.
+ */
+bool
+threaded_context_get_call_stats(struct pipe_context *pipe, enum tc_call_id id,
+                                struct tc_call_stats *stats)
+{
+   /* Only threaded contexts have priv set, see threaded_context_unwrap_sync. */
+   if (!pipe || !pipe->priv || id >= TC_NUM_CALLS)
+      return false;
+
+   struct threaded_context *tc = threaded_context(pipe);
+   if (!tc->profile_calls)
+      return false;
+
+   stats->count = p_atomic_read_relaxed(&tc->call_stats[id].count);
+   stats->time_ns = p_atomic_read_relaxed(&tc->call_stats[id].time_ns);
+   return true;
+}
+
+static int
+tc_compare_call_time(const void *a, const void *b, void *data)
+{
+   const struct tc_call_stats *stats = data;
+   uint64_t ta = stats[*(const unsigned *)a].time_ns;
+   uint64_t tb = stats[*(const unsigned *)b].time_ns;
+
+   return ta < tb ? 1 : ta > tb ? -1 : 0;
+}
+
+static void
+tc_print_call_stats(struct threaded_context *tc)
+{
+   unsigned order[TC_NUM_CALLS];
+   uint64_t total_ns = 0;
+
+   for (unsigned i = 0; i < TC_NUM_CALLS; i++) {
+      order[i] = i;
+      total_ns += tc->call_stats[i].time_ns;
+   }
+   util_qsort_r(order, TC_NUM_CALLS, sizeof(order[0]), tc_compare_call_time,
+                tc->call_stats);
+
+   mesa_logi("tc: driver thread time per call (total %.3f ms):",
+             total_ns / 1000000.0);
+   for (unsigned i = 0; i < TC_NUM_CALLS; i++) {
+      const struct tc_call_stats *stats = &tc->call_stats[order[i]];
+
+      if (!stats->count)
+         break;
+
+      mesa_logi("tc: %-32s %10"PRIu64" calls %10.3f ms %5.1f%% %8"PRIu64" ns/call",
+                tc_call_names[order[i]], stats->count,
+                stats->time_ns / 1000000.0,
+                total_ns ? stats->time_ns * 100.0 / total_ns : 0.0,
+                stats->time_ns / stats->count);
+   }
+}
+
 static void
 tc_destroy(struct pipe_context *_pipe)
 {
@@ -5093,6 +5277,9 @@ tc_destroy(struct pipe_context *_pipe)
 
    tc_sync(tc);
 
+   if (tc->profile_calls)
+      tc_print_call_stats(tc);
+
    if (util_queue_is_initialized(&tc->queue)) {
       util_queue_destroy(&tc->queue);
 
@@ -5202,13 +5389,14 @@ threaded_context_create(struct pipe_context *pipe,
 
    tc->use_forced_staging_uploads = true;
 
-   /* The queue size is the number of batches "waiting". Batches are removed
-    * from the queue before being executed, so keep one tc_batch slot for that
-    * execution. Also, keep one unused slot for an unflushed batch.
+   /* Batches are handed to the driver thread through tc->batch_ring. The
+    * queue only ever contains the job that restarts the idle driver thread.
     */
-   if (!util_queue_init(&tc->queue, "gdrv", TC_MAX_BATCHES - 2, 1, 0, NULL))
+   if (!util_queue_init(&tc->queue, "gdrv", 1, 1, 0, NULL))
       goto fail;
 
+   tc->batch_slot_limit = TC_SLOTS_PER_BATCH;
+   tc->profile_calls = debug_get_bool_option("GALLIUM_TC_PROFILE", false);
    tc->last_completed = -1;
    for (unsigned i = 0; i < TC_MAX_BATCHES; i++) {
 #if !defined(NDEBUG) && TC_DEBUG >= 1
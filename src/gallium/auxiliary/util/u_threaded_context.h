@@ -231,10 +231,10 @@ struct tc_unflushed_batch_token;
 /* fence is pre-populated with a fence created by the create_fence callback */
 #define TC_FLUSH_ASYNC        (1u << 31)
 
-/* Size of the queue = number of batch slots in memory.
+/* Number of batch slots in memory.
  * - 1 batch is always idle and records new commands
  * - 1 batch is being executed
- * so the queue size is TC_MAX_BATCHES - 2 = number of waiting batches.
+ * so up to TC_MAX_BATCHES - 2 batches can be waiting for execution.
  *
  * Use a size as small as possible for low CPU L2 cache usage but large enough
  * so that the queue isn't stalled too often for not having enough idle batch
@@ -250,6 +250,11 @@ struct tc_unflushed_batch_token;
  */
 #define TC_SLOTS_PER_BATCH    1536
 
+/* The smallest batch size used by threaded_context_options::adaptive_batch_size.
+ * TC_SLOTS_PER_BATCH is the largest one.
+ */
+#define TC_MIN_SLOTS_PER_BATCH 192
+
 /* The buffer list queue is much deeper than the batch queue because buffer
  * lists need to stay around until the driver internally flushes its command
  * buffer.
@@ -280,6 +285,12 @@ enum tc_call_id {
    TC_NUM_CALLS,
 };
 
+/* Per-call-type statistics recorded with GALLIUM_TC_PROFILE. */
+struct tc_call_stats {
+   uint64_t count;
+   uint64_t time_ns; /* execution time in the driver */
+};
+
 enum tc_binding_type {
    TC_BINDING_VERTEX_BUFFER,
    TC_BINDING_STREAMOUT_BUFFER,
@@ -565,6 +576,11 @@ struct threaded_context_options {
     */
    void (*dsa_parse)(void *state, struct tc_renderpass_info *info);
    void (*fs_parse)(void *state, struct tc_renderpass_info *info);
+   /* if true, adjust the number of slots used per batch at the end of every
+    * frame: smaller batches let the driver thread start earlier in light
+    * frames, larger ones avoid running out of batches in heavy frames
+    */
+   bool adaptive_batch_size;
 };
 
 struct tc_vertex_buffers {
@@ -603,6 +619,18 @@ struct threaded_context {
    struct util_queue queue;
    struct util_queue_fence *fence;
 
+   /* Single-producer/single-consumer handoff of flushed batches to the
+    * driver thread. The application thread appends batches to batch_ring
+    * and increments batch_ring_submitted without taking any lock. While
+    * batch_ring_active is set, the driver thread executes batches from the
+    * ring and spins for a short while when it's empty before going idle.
+    * The queue is only used to restart the driver thread when it's idle.
+    */
+   struct tc_batch *batch_ring[TC_MAX_BATCHES];
+   unsigned batch_ring_submitted; /* written by the application thread */
+   unsigned batch_ring_executed;  /* written by the driver thread */
+   unsigned batch_ring_active;
+
 #ifndef NDEBUG
    /**
     * The driver thread is normally the queue thread, but
@@ -640,6 +668,14 @@ struct threaded_context {
 
    unsigned last, next, next_buf_list, batch_generation;
 
+   /* The number of slots after which a batch is flushed. This is
+    * TC_SLOTS_PER_BATCH unless options.adaptive_batch_size is set.
+    */
+   unsigned batch_slot_limit;
+   /* Per-frame statistics for options.adaptive_batch_size. */
+   unsigned frame_num_slots;
+   unsigned frame_num_stalls;
+
    /* The list fences that the driver should signal after the next flush.
     * If this is empty, all driver command buffers have been flushed.
     */
@@ -670,6 +706,12 @@ struct threaded_context {
 
    /* Callbacks that call pipe_context functions. */
    tc_execute execute_func[TC_NUM_CALLS];
+
+   /* Only updated by the thread executing batches if profile_calls is set
+    * (GALLIUM_TC_PROFILE). Indexed by enum tc_call_id.
+    */
+   bool profile_calls;
+   struct tc_call_stats call_stats[TC_NUM_CALLS];
 };
 
 
@@ -707,6 +749,13 @@ threaded_context_flush(struct pipe_context *_pipe,
                        struct tc_unflushed_batch_token *token,
                        bool prefer_async);
 
+const char *
+threaded_context_get_call_name(enum tc_call_id id);
+
+bool
+threaded_context_get_call_stats(struct pipe_context *pipe, enum tc_call_id id,
+                                struct tc_call_stats *stats);
+
 struct tc_draw_single *
 tc_add_draw_single_call(struct pipe_context *_pipe,
                         struct pipe_resource *index_bo);
@@ -38,10 +38,14 @@
 #include "u_upload_mgr.h"
 
 
+/* How far default_size may grow when the upload buffer keeps filling up. */
+#define UPLOAD_MAX_GROWTH 4
+
 struct u_upload_mgr {
    struct pipe_context *pipe;
 
    unsigned default_size;  /* Minimum size of the upload buffer, in bytes. */
+   unsigned max_default_size; /* Limit for growing default_size. */
    unsigned bind;          /* Bitmask of PIPE_BIND_* flags. */
    enum pipe_resource_usage usage;
    unsigned flags;
@@ -68,6 +72,7 @@ u_upload_create(struct pipe_context *pipe, unsigned default_size,
 
    upload->pipe = pipe;
    upload->default_size = default_size;
+   upload->max_default_size = default_size * UPLOAD_MAX_GROWTH;
    upload->bind = bind;
    upload->usage = usage;
    upload->flags = flags;
@@ -104,7 +109,8 @@ u_upload_create_default(struct pipe_context *pipe)
 struct u_upload_mgr *
 u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload)
 {
-   struct u_upload_mgr *result = u_upload_create(pipe, upload->default_size,
+   struct u_upload_mgr *result = u_upload_create(pipe, upload->max_default_size /
+                                                       UPLOAD_MAX_GROWTH,
                                                  upload->bind, upload->usage,
                                                  upload->flags);
    if (!upload->map_persistent && result->map_persistent)
@@ -181,8 +187,14 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
    struct pipe_resource buffer;
    unsigned size;
 
-   /* Release the old buffer, if present:
+   /* Release the old buffer, if present. If it was filled up, the context
+    * uploads a lot of data, so use bigger buffers from now on to have fewer
+    * buffer allocations and maps.
     */
+   if (upload->buffer && upload->offset >= upload->buffer_size / 2) {
+      upload->default_size = MIN2(upload->default_size * 2,
+                                  upload->max_default_size);
+   }
    u_upload_release_buffer(upload);
 
    /* Allocate a new one:
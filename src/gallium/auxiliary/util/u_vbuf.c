@@ -95,6 +95,7 @@
 #include "util/u_prim_restart.h"
 #include "util/u_screen.h"
 #include "util/u_upload_mgr.h"
+#include "util/xxhash.h"
 #include "indices/u_primconvert.h"
 #include "translate/translate.h"
 #include "translate/translate_cache.h"
@@ -150,6 +151,22 @@ struct u_vbuf_elements {
    void *driver_cso;
 };
 
+/* Number of translated vertex ranges of static buffers that are kept
+ * around for reuse by later draws.
+ */
+#define U_VBUF_TRANSLATE_CACHE_SIZE 8
+
+struct u_vbuf_translate_cache_entry {
+   struct translate_key key;
+   int start_vertex;
+   unsigned num_vertices;
+   /* Hash of the source vertex data the translation was done from. */
+   uint64_t data_hash;
+
+   struct pipe_resource *buffer;
+   unsigned offset;
+};
+
 enum {
    VB_VERTEX = 0,
    VB_INSTANCE = 1,
@@ -201,6 +218,12 @@ struct u_vbuf {
    uint32_t incompatible_vb_mask; /* each bit describes a corresp. buffer */
    /* Which buffers are allowed (supported by hardware). */
    uint32_t allowed_vb_mask;
+
+   /* Translated vertices of non-streaming buffers, so that drawing the
+    * same static data again doesn't translate and upload it again. */
+   struct u_vbuf_translate_cache_entry
+      translated[U_VBUF_TRANSLATE_CACHE_SIZE];
+   unsigned translated_next;
 };
 
 static void *
@@ -450,6 +473,8 @@ void u_vbuf_destroy(struct u_vbuf *mgr)
       pipe_vertex_buffer_unreference(&mgr->vertex_buffer[i]);
    for (i = 0; i < PIPE_MAX_ATTRIBS; i++)
       pipe_vertex_buffer_unreference(&mgr->real_vertex_buffer[i]);
+   for (i = 0; i < U_VBUF_TRANSLATE_CACHE_SIZE; i++)
+      pipe_resource_reference(&mgr->translated[i].buffer, NULL);
 
    if (mgr->pc)
       util_primconvert_destroy(mgr->pc);
@@ -459,6 +484,46 @@ void u_vbuf_destroy(struct u_vbuf *mgr)
    FREE(mgr);
 }
 
+static struct u_vbuf_translate_cache_entry *
+u_vbuf_translate_cache_find(struct u_vbuf *mgr,
+                            const struct translate_key *key,
+                            int start_vertex, unsigned num_vertices,
+                            uint64_t data_hash)
+{
+   for (unsigned i = 0; i < U_VBUF_TRANSLATE_CACHE_SIZE; i++) {
+      struct u_vbuf_translate_cache_entry *entry = &mgr->translated[i];
+
+      if (entry->buffer &&
+          entry->data_hash == data_hash &&
+          entry->start_vertex == start_vertex &&
+          entry->num_vertices == num_vertices &&
+          translate_key_compare(&entry->key, key) == 0)
+         return entry;
+   }
+   return NULL;
+}
+
+static void
+u_vbuf_translate_cache_add(struct u_vbuf *mgr,
+                           const struct translate_key *key,
+                           int start_vertex, unsigned num_vertices,
+                           uint64_t data_hash,
+                           struct pipe_resource *buffer, unsigned offset)
+{
+   struct u_vbuf_translate_cache_entry *entry =
+      &mgr->translated[mgr->translated_next];
+
+   mgr->translated_next =
+      (mgr->translated_next + 1) % U_VBUF_TRANSLATE_CACHE_SIZE;
+
+   memcpy(&entry->key, key, translate_keysize(key));
+   entry->start_vertex = start_vertex;
+   entry->num_vertices = num_vertices;
+   entry->data_hash = data_hash;
+   entry->offset = offset;
+   pipe_resource_reference(&entry->buffer, buffer);
+}
+
 static enum pipe_error
 u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
                          const struct pipe_draw_info *info,
@@ -472,6 +537,13 @@ u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
    struct pipe_resource *out_buffer = NULL;
    uint8_t *out_map;
    unsigned out_offset, mask;
+   /* Only translations of buffers that aren't updated all the time are
+    * worth caching, and those are recognized by the hash of their data.
+    * There is no way to tell whether a buffer has been written to since
+    * it was translated the last time.
+    */
+   bool cacheable = !unroll_indices;
+   uint64_t data_hash = 0;
 
    /* Get a translate object. */
    tr = translate_cache_find(mgr->translate_cache, key);
@@ -490,6 +562,7 @@ u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
 
       if (vb->is_user_buffer) {
          map = (uint8_t*)vb->buffer.user + offset;
+         cacheable = false;
       } else {
          unsigned size = stride ? num_vertices * stride
                                     : sizeof(double)*4;
@@ -497,6 +570,7 @@ u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
          if (!vb->buffer.resource) {
             static uint64_t dummy_buf[4] = { 0 };
             tr->set_buffer(tr, i, dummy_buf, 0, 0);
+            cacheable = false;
             continue;
          }
 
@@ -533,6 +607,17 @@ u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
 
          map = pipe_buffer_map_range(mgr->pipe, vb->buffer.resource, offset, size,
                                      PIPE_MAP_READ, &vb_transfer[i]);
+
+         if (vb->buffer.resource->usage == PIPE_USAGE_STREAM ||
+             vb->buffer.resource->usage == PIPE_USAGE_DYNAMIC)
+            cacheable = false;
+
+         if (cacheable) {
+            const unsigned layout[3] = { i, stride, size };
+
+            data_hash = XXH64(layout, sizeof(layout), data_hash);
+            data_hash = XXH64(map, size, data_hash);
+         }
       }
 
       /* Subtract min_index so that indexing with the index buffer works. */
@@ -581,19 +666,32 @@ u_vbuf_translate_buffers(struct u_vbuf *mgr, struct translate_key *key,
          pipe_buffer_unmap(mgr->pipe, transfer);
       }
    } else {
-      /* Create and map the output buffer. */
-      u_upload_alloc(mgr->pipe->stream_uploader,
-                     mgr->has_signed_vb_offset ?
-                        0 : key->output_stride * start_vertex,
-                     key->output_stride * num_vertices, 4,
-                     &out_offset, &out_buffer,
-                     (void**)&out_map);
-      if (!out_buffer)
-         return PIPE_ERROR_OUT_OF_MEMORY;
+      struct u_vbuf_translate_cache_entry *entry = cacheable ?
+         u_vbuf_translate_cache_find(mgr, key, start_vertex, num_vertices,
+                                     data_hash) : NULL;
 
-      out_offset -= key->output_stride * start_vertex;
+      if (entry) {
+         pipe_resource_reference(&out_buffer, entry->buffer);
+         out_offset = entry->offset;
+      } else {
+         /* Create and map the output buffer. */
+         u_upload_alloc(mgr->pipe->stream_uploader,
+                        mgr->has_signed_vb_offset ?
+                           0 : key->output_stride * start_vertex,
+                        key->output_stride * num_vertices, 4,
+                        &out_offset, &out_buffer,
+                        (void**)&out_map);
+         if (!out_buffer)
+            return PIPE_ERROR_OUT_OF_MEMORY;
 
-      tr->run(tr, 0, num_vertices, 0, 0, out_map);
+         out_offset -= key->output_stride * start_vertex;
+
+         tr->run(tr, 0, num_vertices, 0, 0, out_map);
+
+         if (cacheable)
+            u_vbuf_translate_cache_add(mgr, key, start_vertex, num_vertices,
+                                       data_hash, out_buffer, out_offset);
+      }
    }
 
    /* Unmap all buffers. */
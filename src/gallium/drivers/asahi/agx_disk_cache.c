@@ -204,6 +204,99 @@ agx_disk_cache_retrieve(struct agx_screen *screen,
 #endif
 }
 
+/**
+ * Compute a disk cache key for a prolog or epilog. These are not tied to an
+ * uncompiled shader, so they are identified by a name and their link key.
+ */
+static void
+agx_disk_cache_compute_part_key(struct disk_cache *cache, const char *name,
+                                const void *key, size_t key_size,
+                                cache_key cache_key)
+{
+   struct blob data;
+   blob_init(&data);
+
+   blob_write_string(&data, name);
+   blob_write_bytes(&data, key, key_size);
+
+   disk_cache_compute_key(cache, data.data, data.size, cache_key);
+   blob_finish(&data);
+}
+
+/**
+ * Store a compiled prolog or epilog in the disk cache. Only the part itself is
+ * stored; fast-linking is redone on retrieval, which just copies binaries.
+ */
+void
+agx_disk_cache_store_part(struct disk_cache *cache, const char *name,
+                          const void *key, size_t key_size,
+                          const struct agx_compiled_shader *binary)
+{
+#ifdef ENABLE_SHADER_CACHE
+   if (!cache)
+      return;
+
+   cache_key cache_key;
+   agx_disk_cache_compute_part_key(cache, name, key, key_size, cache_key);
+
+   struct blob blob;
+   blob_init(&blob);
+
+   blob_write_uint32(&blob, binary->b.binary_size);
+   blob_write_bytes(&blob, binary->b.binary, binary->b.binary_size);
+   blob_write_bytes(&blob, &binary->b.info, sizeof(binary->b.info));
+
+   disk_cache_put(cache, cache_key, blob.data, blob.size, NULL);
+   blob_finish(&blob);
+#endif
+}
+
+/**
+ * Search for a compiled prolog or epilog in the disk cache.
+ */
+struct agx_compiled_shader *
+agx_disk_cache_retrieve_part(struct agx_screen *screen, const char *name,
+                             const void *key, size_t key_size)
+{
+#ifdef ENABLE_SHADER_CACHE
+   struct disk_cache *cache = screen->disk_cache;
+   if (!cache)
+      return NULL;
+
+   cache_key cache_key;
+   agx_disk_cache_compute_part_key(cache, name, key, key_size, cache_key);
+
+   size_t size;
+   void *buffer = disk_cache_get(cache, cache_key, &size);
+   if (!buffer)
+      return NULL;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, buffer, size);
+
+   /* Parts are secondary shaders: they are only ever fast-linked into a main
+    * shader, so they need the CPU copy of the binary but no executable BO.
+    */
+   struct agx_compiled_shader *binary = CALLOC_STRUCT(agx_compiled_shader);
+   binary->stage = PIPE_SHADER_COMPUTE;
+   binary->b.binary_size = blob_read_uint32(&blob);
+   binary->b.binary = malloc(binary->b.binary_size);
+   blob_copy_bytes(&blob, binary->b.binary, binary->b.binary_size);
+   blob_copy_bytes(&blob, &binary->b.info, sizeof(binary->b.info));
+
+   if (blob.overrun) {
+      free(binary->b.binary);
+      FREE(binary);
+      binary = NULL;
+   }
+
+   free(buffer);
+   return binary;
+#else
+   return NULL;
+#endif
+}
+
 /**
  * Initialise the on-disk shader cache.
  */
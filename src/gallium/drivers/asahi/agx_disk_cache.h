@@ -20,4 +20,12 @@ agx_disk_cache_retrieve(struct agx_screen *screen,
                         const struct agx_uncompiled_shader *uncompiled,
                         const union asahi_shader_key *key);
 
+void agx_disk_cache_store_part(struct disk_cache *cache, const char *name,
+                               const void *key, size_t key_size,
+                               const struct agx_compiled_shader *binary);
+
+struct agx_compiled_shader *
+agx_disk_cache_retrieve_part(struct agx_screen *screen, const char *name,
+                             const void *key, size_t key_size);
+
 void agx_disk_cache_init(struct agx_screen *screen);
@@ -1704,7 +1704,8 @@ agx_compile_nir(struct agx_device *dev, nir_shader *nir,
 
 static struct agx_compiled_shader *agx_build_meta_shader_internal(
    struct agx_context *ctx, meta_shader_builder_t builder, void *data,
-   size_t data_size, bool prolog, bool epilog, unsigned cf_base);
+   size_t data_size, bool prolog, bool epilog, unsigned cf_base,
+   const char *cache_name);
 
 /* Does not take ownership of key. Clones if necessary. */
 static struct agx_compiled_shader *
@@ -2264,19 +2265,19 @@ asahi_fast_link(struct agx_context *ctx, struct agx_uncompiled_shader *so,
    if (so->type == MESA_SHADER_FRAGMENT) {
       prolog = agx_build_meta_shader_internal(
          ctx, build_fs_prolog, &key->prolog.fs, sizeof(key->prolog.fs), true,
-         false, key->prolog.fs.cf_base);
+         false, key->prolog.fs.cf_base, "fs_prolog");
 
-      epilog =
-         agx_build_meta_shader_internal(ctx, agx_nir_fs_epilog, &key->epilog.fs,
-                                        sizeof(key->epilog.fs), false, true, 0);
+      epilog = agx_build_meta_shader_internal(
+         ctx, agx_nir_fs_epilog, &key->epilog.fs, sizeof(key->epilog.fs), false,
+         true, 0, "fs_epilog");
 
    } else {
       assert(so->type == MESA_SHADER_VERTEX ||
              so->type == MESA_SHADER_TESS_EVAL);
 
-      prolog =
-         agx_build_meta_shader_internal(ctx, agx_nir_vs_prolog, &key->prolog.vs,
-                                        sizeof(key->prolog.vs), true, false, 0);
+      prolog = agx_build_meta_shader_internal(
+         ctx, agx_nir_vs_prolog, &key->prolog.vs, sizeof(key->prolog.vs), true,
+         false, 0, "vs_prolog");
    }
 
    /* Fast-link it all together */
@@ -2652,7 +2653,7 @@ static struct agx_compiled_shader *
 agx_build_meta_shader_internal(struct agx_context *ctx,
                                meta_shader_builder_t builder, void *data,
                                size_t data_size, bool prolog, bool epilog,
-                               unsigned cf_base)
+                               unsigned cf_base, const char *cache_name)
 {
    /* Build the meta shader key */
    size_t total_key_size = sizeof(struct agx_generic_meta_key) + data_size;
@@ -2671,23 +2672,38 @@ agx_build_meta_shader_internal(struct agx_context *ctx,
    if (ent)
       return ent->data;
 
-   /* Otherwise, compile the shader fresh */
-   nir_builder b = nir_builder_init_simple_shader(
-      MESA_SHADER_COMPUTE, &agx_nir_options, "AGX meta shader");
+   /* Prologs and epilogs are keyed by state that is the same across contexts
+    * and runs, so a new context would otherwise recompile every variant the
+    * application already used. Look in the disk cache before compiling.
+    */
+   struct agx_screen *screen = agx_screen(ctx->base.screen);
+   struct agx_compiled_shader *shader = NULL;
+
+   if (cache_name)
+      shader = agx_disk_cache_retrieve_part(screen, cache_name, data, data_size);
 
-   builder(&b, data);
+   if (!shader) {
+      nir_builder b = nir_builder_init_simple_shader(
+         MESA_SHADER_COMPUTE, &agx_nir_options, "AGX meta shader");
 
-   struct agx_device *dev = agx_device(ctx->base.screen);
-   if (!prolog)
-      agx_preprocess_nir(b.shader, dev->libagx);
+      builder(&b, data);
+
+      struct agx_device *dev = &screen->dev;
+      if (!prolog)
+         agx_preprocess_nir(b.shader, dev->libagx);
 
-   struct agx_compiled_shader *shader = agx_compile_nir(
-      dev, b.shader, NULL, PIPE_SHADER_COMPUTE,
-      !prolog && !(b.shader->info.stage == MESA_SHADER_FRAGMENT &&
-                   b.shader->info.fs.uses_sample_shading),
-      prolog || epilog, cf_base, NULL);
+      shader = agx_compile_nir(
+         dev, b.shader, NULL, PIPE_SHADER_COMPUTE,
+         !prolog && !(b.shader->info.stage == MESA_SHADER_FRAGMENT &&
+                      b.shader->info.fs.uses_sample_shading),
+         prolog || epilog, cf_base, NULL);
 
-   ralloc_free(b.shader);
+      ralloc_free(b.shader);
+
+      if (cache_name)
+         agx_disk_cache_store_part(screen->disk_cache, cache_name, data,
+                                   data_size, shader);
+   }
 
    /* ..and cache it before we return. The key is on the stack right now, so
     * clone it before using it as a hash table key. The clone is logically owned
@@ -2705,7 +2721,7 @@ agx_build_meta_shader(struct agx_context *ctx, meta_shader_builder_t builder,
                       void *data, size_t data_size)
 {
    return agx_build_meta_shader_internal(ctx, builder, data, data_size, false,
-                                         false, 0);
+                                         false, 0, NULL);
 }
 
 static unsigned
@@ -4814,6 +4830,31 @@ agx_draw_patches(struct agx_context *ctx, const struct pipe_draw_info *info,
  * the hardware will race itself with exception #1, where we have a disjoint
  * group texels that intersects a compressed tile being written out.
  */
+static bool
+agx_view_overlaps_surface(const struct agx_sampler_view *view,
+                          const struct pipe_surface *surf)
+{
+   const struct pipe_sampler_view *v = &view->base;
+
+   if (v->target == PIPE_BUFFER)
+      return false;
+
+   /* Rendering to one level while sampling the others (e.g. a shader-based
+    * mip chain) touches disjoint tiles and disjoint compression metadata, so
+    * it is not a feedback loop we need to decompress for. Same for layers.
+    */
+   if (surf->u.tex.level < v->u.tex.first_level ||
+       surf->u.tex.level > v->u.tex.last_level)
+      return false;
+
+   if (v->target != PIPE_TEXTURE_3D &&
+       (surf->u.tex.last_layer < v->u.tex.first_layer ||
+        surf->u.tex.first_layer > v->u.tex.last_layer))
+      return false;
+
+   return true;
+}
+
 static void
 agx_legalize_feedback_loops(struct agx_context *ctx)
 {
@@ -4829,11 +4870,14 @@ agx_legalize_feedback_loops(struct agx_context *ctx)
          if (!ctx->stage[stage].textures[i])
             continue;
 
-         struct agx_resource *rsrc = ctx->stage[stage].textures[i]->rsrc;
+         struct agx_sampler_view *view = ctx->stage[stage].textures[i];
+         struct agx_resource *rsrc = view->rsrc;
 
          for (unsigned cb = 0; cb < ctx->framebuffer.nr_cbufs; ++cb) {
-            if (ctx->framebuffer.cbufs[cb] &&
-                agx_resource(ctx->framebuffer.cbufs[cb]->texture) == rsrc) {
+            struct pipe_surface *surf = ctx->framebuffer.cbufs[cb];
+
+            if (surf && agx_resource(surf->texture) == rsrc &&
+                agx_view_overlaps_surface(view, surf)) {
 
                if (rsrc->layout.tiling == AIL_TILING_TWIDDLED_COMPRESSED) {
                   /* Decompress if we can and shadow if we can't. */
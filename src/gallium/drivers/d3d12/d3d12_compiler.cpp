@@ -37,6 +37,7 @@
 #include "nir/tgsi_to_nir.h"
 #include "compiler/nir/nir_builder.h"
 
+#include "util/disk_cache.h"
 #include "util/hash_table.h"
 #include "util/u_memory.h"
 #include "util/u_prim.h"
@@ -82,6 +83,44 @@ can_remove_dead_sampler(nir_variable *var, void *data)
    return glsl_type_is_sampler(base_type) && !glsl_type_is_bare_sampler(base_type);
 }
 
+#ifdef _WIN32
+/* Validation also signs the module and is a large part of the compile time.
+ * The signed module only depends on the unsigned one and the validator, so
+ * we keep the result in a disk cache and skip validation on hits.
+ */
+static void
+validated_dxil_cache_key(struct d3d12_screen *screen, struct dxil_validator *val,
+                         const struct blob *dxil, cache_key key)
+{
+   struct {
+      enum dxil_validator_version version;
+      uint8_t sha1[SHA1_DIGEST_LENGTH];
+   } data = {};
+
+   data.version = dxil_get_validator_version(val);
+   _mesa_sha1_compute(dxil->data, dxil->size, data.sha1);
+   disk_cache_compute_key(screen->validated_dxil_cache, &data, sizeof(data), key);
+}
+
+static bool
+validated_dxil_cache_get(struct d3d12_screen *screen, const cache_key key,
+                         struct blob *dxil)
+{
+   size_t size;
+   void *signed_dxil = disk_cache_get(screen->validated_dxil_cache, key, &size);
+   if (!signed_dxil)
+      return false;
+
+   /* Signing edits the module in place, the size never changes */
+   bool hit = size == dxil->size;
+   if (hit)
+      memcpy(dxil->data, signed_dxil, size);
+
+   free(signed_dxil);
+   return hit;
+}
+#endif
+
 static struct d3d12_shader *
 compile_nir(struct d3d12_context *ctx, struct d3d12_shader_selector *sel,
             struct d3d12_shader_key *key, struct nir_shader *nir)
@@ -183,9 +222,20 @@ compile_nir(struct d3d12_context *ctx, struct d3d12_shader_selector *sel,
 #ifdef _WIN32
    if (ctx->dxil_validator) {
       if (!(d3d12_debug & D3D12_DEBUG_EXPERIMENTAL)) {
-         char *err;
-         if (!dxil_validate_module(ctx->dxil_validator, tmp.data,
-                                   tmp.size, &err) && err) {
+         cache_key key;
+         if (screen->validated_dxil_cache)
+            validated_dxil_cache_key(screen, ctx->dxil_validator, &tmp, key);
+
+         bool validated = screen->validated_dxil_cache &&
+                          validated_dxil_cache_get(screen, key, &tmp);
+
+         char *err = NULL;
+         if (!validated && dxil_validate_module(ctx->dxil_validator, tmp.data,
+                                                tmp.size, &err)) {
+            if (screen->validated_dxil_cache)
+               disk_cache_put(screen->validated_dxil_cache, key, tmp.data,
+                              tmp.size, NULL);
+         } else if (err) {
             debug_printf(
                "== VALIDATION ERROR =============================================\n"
                "%s\n"
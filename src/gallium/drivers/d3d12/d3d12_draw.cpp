@@ -81,6 +81,13 @@ fill_cbv_descriptors(struct d3d12_context *ctx,
    return table_start.gpu_handle;
 }
 
+static void
+delete_srv_table(hash_entry *entry)
+{
+   FREE((void *)entry->key);
+   FREE(entry->data);
+}
+
 static D3D12_GPU_DESCRIPTOR_HANDLE
 fill_srv_descriptors(struct d3d12_context *ctx,
                      struct d3d12_shader *shader,
@@ -88,11 +95,10 @@ fill_srv_descriptors(struct d3d12_context *ctx,
 {
    struct d3d12_batch *batch = d3d12_current_batch(ctx);
    struct d3d12_screen *screen = d3d12_screen(ctx->base.screen);
-   D3D12_CPU_DESCRIPTOR_HANDLE descs[PIPE_MAX_SHADER_SAMPLER_VIEWS];
-   struct d3d12_descriptor_handle table_start;
-
-   d2d12_descriptor_heap_get_next_handle(batch->view_heap, &table_start);
+   struct d3d12_sampler_desc_table_key table;
+   D3D12_CPU_DESCRIPTOR_HANDLE *descs = table.descs;
 
+   table.count = shader->end_srv_binding - shader->begin_srv_binding;
    for (unsigned i = shader->begin_srv_binding; i < shader->end_srv_binding; i++)
    {
       struct d3d12_sampler_view *view;
@@ -113,6 +119,9 @@ fill_srv_descriptors(struct d3d12_context *ctx,
          if (view->texture_generation_id != res->generation_id) {
             d3d12_init_sampler_view_descriptor(view);
             view->texture_generation_id = res->generation_id;
+
+            /* Tables we already copied may hold the old descriptor */
+            _mesa_hash_table_clear(batch->srv_tables, delete_srv_table);
          }
 
          D3D12_RESOURCE_STATES state = (stage == PIPE_SHADER_FRAGMENT) ?
@@ -136,9 +145,25 @@ fill_srv_descriptors(struct d3d12_context *ctx,
       }
    }
 
-   d3d12_descriptor_heap_append_handles(batch->view_heap, descs, shader->end_srv_binding - shader->begin_srv_binding);
+   /* Switching programs dirties all bindings, don't copy the same views into
+    * the heap again if some earlier draw in this batch already did.
+    */
+   hash_entry *entry = _mesa_hash_table_search(batch->srv_tables, &table);
+   if (entry)
+      return ((d3d12_descriptor_handle *)entry->data)->gpu_handle;
 
-   return table_start.gpu_handle;
+   d3d12_sampler_desc_table_key *table_key = MALLOC_STRUCT(d3d12_sampler_desc_table_key);
+   table_key->count = table.count;
+   memcpy(table_key->descs, table.descs, table.count * sizeof(table.descs[0]));
+
+   d3d12_descriptor_handle *table_start = MALLOC_STRUCT(d3d12_descriptor_handle);
+   d2d12_descriptor_heap_get_next_handle(batch->view_heap, table_start);
+
+   d3d12_descriptor_heap_append_handles(batch->view_heap, descs, table.count);
+
+   _mesa_hash_table_insert(batch->srv_tables, table_key, table_start);
+
+   return table_start->gpu_handle;
 }
 
 static D3D12_GPU_DESCRIPTOR_HANDLE
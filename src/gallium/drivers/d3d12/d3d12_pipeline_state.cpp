@@ -37,6 +37,7 @@
 #include <directx/d3dx12_pipeline_state_stream.h>
 #endif
 
+#include "util/disk_cache.h"
 #include "util/hash_table.h"
 #include "util/set.h"
 #include "util/u_memory.h"
@@ -265,6 +266,97 @@ copy_input_attribs(const D3D12_INPUT_ELEMENT_DESC *ves_elements, D3D12_INPUT_ELE
    }
 }
 
+#if defined(_WIN32) && defined(ENABLE_SHADER_CACHE)
+static void
+hash_shader_bytecode(struct mesa_sha1 *ctx, const D3D12_SHADER_BYTECODE &bytecode)
+{
+   _mesa_sha1_update(ctx, &bytecode.BytecodeLength, sizeof(bytecode.BytecodeLength));
+   if (bytecode.BytecodeLength)
+      _mesa_sha1_update(ctx, bytecode.pShaderBytecode, bytecode.BytecodeLength);
+}
+
+/* Hash what the PSO description points to rather than the pointers. The root
+ * signature isn't hashed, it's derived from the shaders, and the runtime
+ * rejects a cached blob that doesn't match the description anyway.
+ */
+static void
+gfx_pso_cache_key(struct d3d12_screen *screen,
+                  CD3DX12_PIPELINE_STATE_STREAM3 &pso_desc, cache_key key)
+{
+   struct mesa_sha1 ctx;
+   _mesa_sha1_init(&ctx);
+
+   hash_shader_bytecode(&ctx, (D3D12_SHADER_BYTECODE &)pso_desc.VS);
+   hash_shader_bytecode(&ctx, (D3D12_SHADER_BYTECODE &)pso_desc.HS);
+   hash_shader_bytecode(&ctx, (D3D12_SHADER_BYTECODE &)pso_desc.DS);
+   hash_shader_bytecode(&ctx, (D3D12_SHADER_BYTECODE &)pso_desc.GS);
+   hash_shader_bytecode(&ctx, (D3D12_SHADER_BYTECODE &)pso_desc.PS);
+
+   const D3D12_STREAM_OUTPUT_DESC &so = (D3D12_STREAM_OUTPUT_DESC &)pso_desc.StreamOutput;
+   for (unsigned i = 0; i < so.NumEntries; ++i) {
+      D3D12_SO_DECLARATION_ENTRY entry = so.pSODeclaration[i];
+      if (entry.SemanticName)
+         _mesa_sha1_update(&ctx, entry.SemanticName, strlen(entry.SemanticName));
+      entry.SemanticName = NULL;
+      _mesa_sha1_update(&ctx, &entry, sizeof(entry));
+   }
+   _mesa_sha1_update(&ctx, so.pBufferStrides, so.NumStrides * sizeof(*so.pBufferStrides));
+   _mesa_sha1_update(&ctx, &so.RasterizedStream, sizeof(so.RasterizedStream));
+
+   const D3D12_INPUT_LAYOUT_DESC &input_layout = (D3D12_INPUT_LAYOUT_DESC &)pso_desc.InputLayout;
+   for (unsigned i = 0; i < input_layout.NumElements; ++i) {
+      D3D12_INPUT_ELEMENT_DESC element = input_layout.pInputElementDescs[i];
+      _mesa_sha1_update(&ctx, element.SemanticName, strlen(element.SemanticName));
+      element.SemanticName = NULL;
+      _mesa_sha1_update(&ctx, &element, sizeof(element));
+   }
+
+   _mesa_sha1_update(&ctx, &(D3D12_BLEND_DESC &)pso_desc.BlendState, sizeof(D3D12_BLEND_DESC));
+   _mesa_sha1_update(&ctx, &(d3d12_depth_stencil_desc_type &)pso_desc.DepthStencilState,
+                     sizeof(d3d12_depth_stencil_desc_type));
+   _mesa_sha1_update(&ctx, &(UINT &)pso_desc.SampleMask, sizeof(UINT));
+   _mesa_sha1_update(&ctx, &(D3D12_RASTERIZER_DESC &)pso_desc.RasterizerState,
+                     sizeof(D3D12_RASTERIZER_DESC));
+   _mesa_sha1_update(&ctx, &(D3D12_INDEX_BUFFER_STRIP_CUT_VALUE &)pso_desc.IBStripCutValue,
+                     sizeof(D3D12_INDEX_BUFFER_STRIP_CUT_VALUE));
+   _mesa_sha1_update(&ctx, &(D3D12_PRIMITIVE_TOPOLOGY_TYPE &)pso_desc.PrimitiveTopologyType,
+                     sizeof(D3D12_PRIMITIVE_TOPOLOGY_TYPE));
+   _mesa_sha1_update(&ctx, &(D3D12_RT_FORMAT_ARRAY &)pso_desc.RTVFormats,
+                     sizeof(D3D12_RT_FORMAT_ARRAY));
+   _mesa_sha1_update(&ctx, &(DXGI_FORMAT &)pso_desc.DSVFormat, sizeof(DXGI_FORMAT));
+   _mesa_sha1_update(&ctx, &(DXGI_SAMPLE_DESC &)pso_desc.SampleDesc, sizeof(DXGI_SAMPLE_DESC));
+
+   uint8_t sha1[SHA1_DIGEST_LENGTH];
+   _mesa_sha1_final(&ctx, sha1);
+   disk_cache_compute_key(screen->pso_cache, sha1, sizeof(sha1), key);
+}
+#endif
+
+static ID3D12PipelineState *
+create_pso(struct d3d12_screen *screen, CD3DX12_PIPELINE_STATE_STREAM3 &pso_desc)
+{
+   ID3D12PipelineState *ret;
+
+   if (screen->opts14.IndependentFrontAndBackStencilRefMaskSupported) {
+      D3D12_PIPELINE_STATE_STREAM_DESC pso_stream_desc{
+          sizeof(pso_desc),
+          &pso_desc
+      };
+
+      if (FAILED(screen->dev->CreatePipelineState(&pso_stream_desc,
+                                                  IID_PPV_ARGS(&ret))))
+         return NULL;
+   } 
+   else {
+      D3D12_GRAPHICS_PIPELINE_STATE_DESC v0desc = pso_desc.GraphicsDescV0();
+      if (FAILED(screen->dev->CreateGraphicsPipelineState(&v0desc,
+                                                       IID_PPV_ARGS(&ret))))
+         return NULL;
+   }
+
+   return ret;
+}
+
 static ID3D12PipelineState *
 create_gfx_pipeline_state(struct d3d12_context *ctx)
 {
@@ -386,28 +478,46 @@ create_gfx_pipeline_state(struct d3d12_context *ctx)
 
    pso_desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-   ID3D12PipelineState *ret;
+   ID3D12PipelineState *ret = NULL;
 
-   if (screen->opts14.IndependentFrontAndBackStencilRefMaskSupported) {
-      D3D12_PIPELINE_STATE_STREAM_DESC pso_stream_desc{
-          sizeof(pso_desc),
-          &pso_desc
-      };
+#if defined(_WIN32) && defined(ENABLE_SHADER_CACHE)
+   cache_key key;
+   if (screen->pso_cache) {
+      gfx_pso_cache_key(screen, pso_desc, key);
 
-      if (FAILED(screen->dev->CreatePipelineState(&pso_stream_desc,
-                                                  IID_PPV_ARGS(&ret)))) {
-         debug_printf("D3D12: CreateGraphicsPipelineState failed!\n");
-         return NULL;
-      }
-   } 
-   else {
-      D3D12_GRAPHICS_PIPELINE_STATE_DESC v0desc = pso_desc.GraphicsDescV0();
-      if (FAILED(screen->dev->CreateGraphicsPipelineState(&v0desc,
-                                                       IID_PPV_ARGS(&ret)))) {
-         debug_printf("D3D12: CreateGraphicsPipelineState failed!\n");
-         return NULL;
+      size_t size;
+      void *blob = disk_cache_get(screen->pso_cache, key, &size);
+      if (blob) {
+         cached_pso.pCachedBlob = blob;
+         cached_pso.CachedBlobSizeInBytes = size;
+
+         /* Fails if the blob is from another driver version or device */
+         ret = create_pso(screen, pso_desc);
+
+         cached_pso.pCachedBlob = NULL;
+         cached_pso.CachedBlobSizeInBytes = 0;
+         free(blob);
+
+         if (ret)
+            return ret;
       }
    }
+#endif
+
+   ret = create_pso(screen, pso_desc);
+   if (!ret) {
+      debug_printf("D3D12: CreateGraphicsPipelineState failed!\n");
+      return NULL;
+   }
+
+#if defined(_WIN32) && defined(ENABLE_SHADER_CACHE)
+   ID3DBlob *cached_blob;
+   if (screen->pso_cache && SUCCEEDED(ret->GetCachedBlob(&cached_blob))) {
+      disk_cache_put(screen->pso_cache, key, cached_blob->GetBufferPointer(),
+                     cached_blob->GetBufferSize(), NULL);
+      cached_blob->Release();
+   }
+#endif
 
    return ret;
 }
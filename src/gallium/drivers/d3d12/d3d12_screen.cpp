@@ -44,6 +44,8 @@
 #include "util/u_screen.h"
 #include "util/u_dl.h"
 #include "util/mesa-sha1.h"
+#include "util/disk_cache.h"
+#include "util/hex.h"
 
 #include "nir.h"
 #include "frontend/sw_winsys.h"
@@ -812,6 +814,9 @@ d3d12_destroy_screen(struct d3d12_screen *screen)
    mtx_destroy(&screen->varying_info_mutex);
 #endif // HAVE_GALLIUM_D3D12_GRAPHICS
 
+   disk_cache_destroy(screen->validated_dxil_cache);
+   disk_cache_destroy(screen->pso_cache);
+
    if (screen->d3d12_mod)
       util_dl_close(screen->d3d12_mod);
    glsl_type_singleton_decref();
@@ -1809,6 +1814,18 @@ d3d12_init_screen(struct d3d12_screen *screen, IUnknown *adapter)
    _mesa_sha1_compute(mesa_version, strlen(mesa_version), sha1);
    memcpy(screen->driver_uuid, sha1, PIPE_UUID_SIZE);
 
+#if defined(_WIN32) && defined(ENABLE_SHADER_CACHE)
+   char timestamp[SHA1_DIGEST_STRING_LENGTH];
+   mesa_bytes_to_hex(timestamp, sha1, SHA1_DIGEST_LENGTH);
+   screen->validated_dxil_cache = disk_cache_create("d3d12_dxil", timestamp, 0);
+   /* Cached PSOs are only usable by the device and driver that created them,
+    * anything else gets rejected by the runtime and we fall back to a full
+    * PSO compile, so the device ID is just there to avoid thrashing.
+    */
+   uint64_t pso_cache_flags = (uint64_t)screen->vendor_id << 32 | screen->device_id;
+   screen->pso_cache = disk_cache_create("d3d12_pso", timestamp, pso_cache_flags);
+#endif
+
    /* The device UUID uniquely identifies the given device within the machine. */
    _mesa_sha1_init(&sha1_ctx);
    _mesa_sha1_update(&sha1_ctx, &screen->vendor_id, sizeof(screen->vendor_id));
@@ -88,6 +88,11 @@ struct d3d12_screen {
    struct set* varying_info_set;
    mtx_t varying_info_mutex;
 
+   /* Signed DXIL modules, keyed by the unsigned module and validator version */
+   struct disk_cache *validated_dxil_cache;
+   /* Cached PSO blobs, keyed by the contents of the PSO description */
+   struct disk_cache *pso_cache;
+
    struct slab_parent_pool transfer_pool;
    struct pb_manager *bufmgr;
    struct pb_manager *cache_bufmgr;
@@ -98,6 +98,11 @@ struct fd6_context {
 
    unsigned vsc_draw_strm_pitch, vsc_prim_strm_pitch;
 
+   /* Number of VSC overflows, which should not happen in steady state since
+    * the stream sizes are estimated up front (see fd6_vsc_update_sizes()).
+    */
+   unsigned vsc_overflow_count;
+
    /* The 'control' mem BO is used for various housekeeping
     * functions.  See 'struct fd6_control'
     */
@@ -119,6 +124,13 @@ struct fd6_context {
    /* cached stateobjs to avoid hashtable lookup when not dirty: */
    const struct fd6_program_state *prog;
 
+   /* Set if prog is a generic stand-in while the real variants compile in
+    * the background, see ir3_cache_lookup_async().  The seqno is the value
+    * of fd_screen::async_variants_seqno at the time of the lookup.
+    */
+   bool prog_fallback;
+   uint32_t prog_fallback_seqno;
+
    /* We expect to see a finite # of unique border-color entry values,
     * which are a function of the color value and (to a limited degree)
     * the border color format.  These unique border-color entry values
@@ -28,6 +28,7 @@
 #define FD_BO_NO_HARDPIN 1
 
 #include "pipe/p_state.h"
+#include "util/u_atomic.h"
 #include "util/u_memory.h"
 #include "util/u_prim.h"
 #include "util/u_string.h"
@@ -267,8 +268,10 @@ get_program_state(struct fd_context *ctx, const struct pipe_draw_info *info)
    ir3_fixup_shader_state(&ctx->base, &key.key);
 
    if (ctx->gen_dirty & BIT(FD6_GROUP_PROG)) {
-      struct ir3_program_state *s = ir3_cache_lookup(
-            ctx->shader_cache, &key, &ctx->debug);
+      fd6_ctx->prog_fallback_seqno =
+         p_atomic_read(&ctx->screen->async_variants_seqno);
+      struct ir3_program_state *s = ir3_cache_lookup_async(
+            ctx->shader_cache, &key, &ctx->debug, &fd6_ctx->prog_fallback);
       fd6_ctx->prog = fd6_program_state(s);
    }
 
@@ -331,6 +334,16 @@ draw_vbos(struct fd_context *ctx, const struct pipe_draw_info *info,
       fd6_vsc_update_sizes(ctx->batch, info, &draws[0]);
    }
 
+   /* If we are drawing with a stand-in program while the real variants
+    * compile, check again whenever a background compile has finished:
+    */
+   if (unlikely(fd6_ctx->prog_fallback) &&
+       fd6_ctx->prog_fallback_seqno !=
+          p_atomic_read(&ctx->screen->async_variants_seqno)) {
+      fd_context_dirty_shader(ctx, PIPE_SHADER_VERTEX, FD_DIRTY_SHADER_PROG);
+      fd_context_dirty_shader(ctx, PIPE_SHADER_FRAGMENT, FD_DIRTY_SHADER_PROG);
+   }
+
    /* If PROG state (which will mark PROG_KEY dirty) or any state that the
     * key depends on, is dirty, then we actually need to construct the shader
     * key, figure out if we need a new variant, and lookup the PROG state.
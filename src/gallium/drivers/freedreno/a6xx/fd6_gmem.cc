@@ -661,6 +661,11 @@ check_vsc_overflow(struct fd_context *ctx)
    unsigned buffer = vsc_overflow & 0x3;
    unsigned size = vsc_overflow & ~0x3;
 
+   fd6_ctx->vsc_overflow_count++;
+   perf_debug_ctx(ctx, "VSC %s stream overflow (%u so far)",
+                  buffer == 0x1 ? "draw" : "prim",
+                  fd6_ctx->vsc_overflow_count);
+
    if (buffer == 0x1) {
       /* VSC_DRAW_STRM overflow: */
 
@@ -2,6 +2,7 @@
 
 DRI_CONF_SECTION_MISCELLANEOUS
    DRI_CONF_DISABLE_CONSERVATIVE_LRZ(false)
+   DRI_CONF_FREEDRENO_ASYNC_VARIANTS(false)
 DRI_CONF_SECTION_END
 
 DRI_CONF_SECTION_DEBUG
@@ -493,17 +493,27 @@ fd_bc_alloc_batch(struct fd_context *ctx, bool nondraw)
    return batch;
 }
 
+static struct fd_batch_key *
+key_dup(const struct fd_batch_key *key)
+{
+   struct fd_batch_key *new_key = key_alloc(key->num_surfs);
+   memcpy(new_key, key, sizeof(*key) + sizeof(key->surf[0]) * key->num_surfs);
+   return new_key;
+}
+
+/* Note that the cache takes ownership of a copy of the key, the passed in
+ * key (ctx->fb_key) stays owned by the context.
+ */
 static struct fd_batch *
-batch_from_key(struct fd_context *ctx, struct fd_batch_key *key) assert_dt
+batch_from_key(struct fd_context *ctx, const struct fd_batch_key *fb_key,
+               uint32_t hash) assert_dt
 {
    struct fd_batch_cache *cache = &ctx->screen->batch_cache;
    struct fd_batch *batch = NULL;
-   uint32_t hash = fd_batch_key_hash(key);
    struct hash_entry *entry =
-      _mesa_hash_table_search_pre_hashed(cache->ht, hash, key);
+      _mesa_hash_table_search_pre_hashed(cache->ht, hash, fb_key);
 
    if (entry) {
-      free(key);
       fd_batch_reference_locked(&batch, (struct fd_batch *)entry->data);
       assert(!batch->flushed);
       return batch;
@@ -511,15 +521,15 @@ batch_from_key(struct fd_context *ctx, struct fd_batch_key *key) assert_dt
 
    batch = alloc_batch_locked(cache, ctx, false);
 #if MESA_DEBUG
-   DBG("%p: hash=0x%08x, %ux%u, %u layers, %u samples", batch, hash, key->width,
-       key->height, key->layers, key->samples);
-   for (unsigned idx = 0; idx < key->num_surfs; idx++) {
+   DBG("%p: hash=0x%08x, %ux%u, %u layers, %u samples", batch, hash, fb_key->width,
+       fb_key->height, fb_key->layers, fb_key->samples);
+   for (unsigned idx = 0; idx < fb_key->num_surfs; idx++) {
       DBG("%p:  surf[%u]: %p (%s) (%u,%u / %u,%u,%u)", batch,
-          key->surf[idx].pos, key->surf[idx].texture,
-          util_format_name(key->surf[idx].format),
-          key->surf[idx].u.buf.first_element, key->surf[idx].u.buf.last_element,
-          key->surf[idx].u.tex.first_layer, key->surf[idx].u.tex.last_layer,
-          key->surf[idx].u.tex.level);
+          fb_key->surf[idx].pos, fb_key->surf[idx].texture,
+          util_format_name(fb_key->surf[idx].format),
+          fb_key->surf[idx].u.buf.first_element, fb_key->surf[idx].u.buf.last_element,
+          fb_key->surf[idx].u.tex.first_layer, fb_key->surf[idx].u.tex.last_layer,
+          fb_key->surf[idx].u.tex.level);
    }
 #endif
    if (!batch)
@@ -533,6 +543,7 @@ batch_from_key(struct fd_context *ctx, struct fd_batch_key *key) assert_dt
    batch->max_scissor.maxx = 0;
    batch->max_scissor.maxy = 0;
 
+   struct fd_batch_key *key = key_dup(fb_key);
    _mesa_hash_table_insert_pre_hashed(cache->ht, hash, key, batch);
    batch->key = key;
    batch->hash = hash;
@@ -556,9 +567,8 @@ key_surf(struct fd_batch_key *key, unsigned idx, unsigned pos,
    key->surf[idx].format = psurf->format;
 }
 
-struct fd_batch *
-fd_batch_from_fb(struct fd_context *ctx,
-                 const struct pipe_framebuffer_state *pfb)
+static struct fd_batch_key *
+fb_key(struct fd_context *ctx, const struct pipe_framebuffer_state *pfb)
 {
    unsigned idx = 0, n = pfb->nr_cbufs + (pfb->zsbuf ? 1 : 0);
    struct fd_batch_key *key = key_alloc(n);
@@ -578,8 +588,26 @@ fd_batch_from_fb(struct fd_context *ctx,
 
    key->num_surfs = idx;
 
+   return key;
+}
+
+struct fd_batch *
+fd_batch_from_fb(struct fd_context *ctx,
+                 const struct pipe_framebuffer_state *pfb)
+{
+   assert(pfb == &ctx->framebuffer);
+
+   /* The key only depends on the framebuffer state, so it is only rebuilt
+    * (and rehashed) after fd_set_framebuffer_state(), and not every time
+    * the batch for the current framebuffer got flushed:
+    */
+   if (!ctx->fb_key) {
+      ctx->fb_key = fb_key(ctx, pfb);
+      ctx->fb_key_hash = fd_batch_key_hash(ctx->fb_key);
+   }
+
    fd_screen_lock(ctx->screen);
-   struct fd_batch *batch = batch_from_key(ctx, key);
+   struct fd_batch *batch = batch_from_key(ctx, ctx->fb_key, ctx->fb_key_hash);
    fd_screen_unlock(ctx->screen);
 
    alloc_query_buf(ctx, batch);
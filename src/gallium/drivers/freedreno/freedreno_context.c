@@ -403,6 +403,7 @@ fd_context_destroy(struct pipe_context *pctx)
    }
 
    util_copy_framebuffer_state(&ctx->framebuffer, NULL);
+   free(ctx->fb_key);
    fd_batch_reference(&ctx->batch, NULL); /* unref current batch */
 
    /* Make sure nothing in the batch cache references our context any more. */
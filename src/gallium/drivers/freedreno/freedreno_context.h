@@ -504,6 +504,10 @@ struct fd_context {
    struct pipe_framebuffer_state framebuffer dt;
    uint32_t all_mrt_channel_mask dt;
 
+   /* batch cache key of framebuffer, built on demand by fd_batch_from_fb(): */
+   struct fd_batch_key *fb_key dt;
+   uint32_t fb_key_hash dt;
+
    struct pipe_poly_stipple stipple dt;
    struct pipe_viewport_state viewport[PIPE_MAX_VIEWPORTS] dt;
    struct pipe_scissor_state viewport_scissor[PIPE_MAX_VIEWPORTS] dt;
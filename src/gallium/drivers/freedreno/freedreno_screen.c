@@ -1177,6 +1177,8 @@ fd_screen_create(int fd,
          !driQueryOptionb(config->options, "disable_throttling");
    screen->driconf.dual_color_blend_by_location =
          driQueryOptionb(config->options, "dual_color_blend_by_location");
+   screen->driconf.async_variants =
+         driQueryOptionb(config->options, "freedreno_async_variants");
 
    struct sysinfo si;
    sysinfo(&si);
@@ -100,6 +100,10 @@ struct fd_screen {
       /* If "dual_color_blend_by_location" workaround is enabled
        */
       bool dual_color_blend_by_location;
+
+      /* Compile draw-time shader variants asynchronously (default false).
+       */
+      bool async_variants;
    } driconf;
 
    struct fd_dev_info dev_info;
@@ -122,6 +126,9 @@ struct fd_screen {
    void *compiler;                  /* currently unused for a2xx */
    struct util_queue compile_queue; /* currently unused for a2xx */
 
+   /* Incremented whenever an async draw-time variant finished compiling: */
+   uint32_t async_variants_seqno;
+
    struct fd_device *dev;
 
    /* NOTE: we still need a pipe associated with the screen in a few
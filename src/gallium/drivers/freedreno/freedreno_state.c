@@ -308,6 +308,9 @@ fd_set_framebuffer_state(struct pipe_context *pctx,
 
    util_copy_framebuffer_state(cso, framebuffer);
 
+   free(ctx->fb_key);
+   ctx->fb_key = NULL;
+
    STATIC_ASSERT((4 * PIPE_MAX_COLOR_BUFS) == (8 * sizeof(ctx->all_mrt_channel_mask)));
    ctx->all_mrt_channel_mask = 0;
 
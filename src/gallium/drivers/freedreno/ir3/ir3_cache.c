@@ -177,6 +177,58 @@ ir3_cache_lookup(struct ir3_cache *cache, const struct ir3_cache_key *key,
    return state;
 }
 
+/* Shader key state that changes how a shader renders, but not the interface
+ * between the shader stages or the program state.  A variant with these
+ * cleared can stand in while the real one compiles, at the price of some
+ * frames with flat/sample shading or user clip planes missing.
+ */
+static void
+generic_key(struct ir3_cache_key *key)
+{
+   key->key.rasterflat = false;
+   key->key.sample_shading = false;
+   key->key.ucp_enables = 0;
+   key->clip_plane_enable = 0;
+}
+
+struct ir3_program_state *
+ir3_cache_lookup_async(struct ir3_cache *cache, const struct ir3_cache_key *key,
+                       struct util_debug_callback *debug, bool *fallback)
+{
+   *fallback = false;
+
+   struct hash_entry *entry =
+      _mesa_hash_table_search_pre_hashed(cache->ht, key_hash(key), key);
+   if (entry)
+      return entry->data;
+
+   struct ir3_cache_key generic = *key;
+   generic_key(&generic);
+   if (key_equals(&generic, key))
+      return ir3_cache_lookup(cache, key, debug);
+
+   /* Only worth it if we have something to draw with in the meantime: */
+   struct hash_entry *generic_entry =
+      _mesa_hash_table_search_pre_hashed(cache->ht, key_hash(&generic),
+                                         &generic);
+   if (!generic_entry)
+      return ir3_cache_lookup(cache, key, debug);
+
+   /* Note: no short-circuit, so that all stages get queued at once: */
+   bool ready = true;
+   ready &= ir3_shader_state_variant_ready(key->vs, &key->key);
+   ready &= ir3_shader_state_variant_ready(key->hs, &key->key);
+   ready &= ir3_shader_state_variant_ready(key->ds, &key->key);
+   ready &= ir3_shader_state_variant_ready(key->gs, &key->key);
+   ready &= ir3_shader_state_variant_ready(key->fs, &key->key);
+
+   if (ready)
+      return ir3_cache_lookup(cache, key, debug);
+
+   *fallback = true;
+   return generic_entry->data;
+}
+
 /* call when an API level state object is destroyed, to invalidate
  * cache entries which reference that state object.
  */
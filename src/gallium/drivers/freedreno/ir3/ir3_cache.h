@@ -82,6 +82,16 @@ struct ir3_program_state *ir3_cache_lookup(struct ir3_cache *cache,
                                            const struct ir3_cache_key *key,
                                            struct util_debug_callback *debug);
 
+/* Like ir3_cache_lookup(), but if the key needs shader variants which are
+ * not compiled yet and the same program state with a generic key is already
+ * cached, the variants get queued for compilation in the background and the
+ * generic program state is returned with *fallback set.  The caller should
+ * look up again once fd_screen::async_variants_seqno changes.
+ */
+struct ir3_program_state *
+ir3_cache_lookup_async(struct ir3_cache *cache, const struct ir3_cache_key *key,
+                       struct util_debug_callback *debug, bool *fallback);
+
 /* call when an API level state object is destroyed, to invalidate
  * cache entries which reference that state object.
  */
@@ -28,6 +28,9 @@
 #include "pipe/p_state.h"
 #include "tgsi/tgsi_dump.h"
 #include "util/format/u_format.h"
+#include "util/list.h"
+#include "util/simple_mtx.h"
+#include "util/u_atomic.h"
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 #include "util/u_string.h"
@@ -56,6 +59,29 @@ struct ir3_shader_state {
 
    /* Fence signalled when async compile is completed: */
    struct util_queue_fence ready;
+
+   /* Draw-time variants compiled in the background, see
+    * ir3_shader_state_variant_ready().  Jobs stay on the list until the
+    * hwcso is destroyed, so that a given key is only queued once.
+    */
+   struct fd_screen *screen;
+   bool async_variants;
+   simple_mtx_t variant_jobs_lock;
+   struct list_head variant_jobs;
+};
+
+struct ir3_variant_job {
+   struct list_head node;
+   struct ir3_shader_state *hwcso;
+   struct ir3_shader_key key;
+
+   struct util_queue_fence ready;
+
+   /* Set when the variant is compiled and uploaded.  This is what tells
+    * the draw the variant can be used, rather than the fence, which only
+    * gets signalled after fd_screen::async_variants_seqno is bumped.
+    */
+   bool done;
 };
 
 /**
@@ -416,6 +442,12 @@ ir3_shader_state_create(struct pipe_context *pctx,
 
    util_queue_fence_init(&hwcso->ready);
 
+   hwcso->screen = ctx->screen;
+   hwcso->async_variants = ctx->screen->driconf.async_variants &&
+                           !initial_variants_synchronous(ctx);
+   simple_mtx_init(&hwcso->variant_jobs_lock, mtx_plain);
+   list_inithead(&hwcso->variant_jobs);
+
    if (initial_variants_synchronous(ctx)) {
       create_initial_variants(hwcso, &ctx->debug);
    } else {
@@ -444,6 +476,17 @@ ir3_shader_state_delete(struct pipe_context *pctx, void *_hwcso)
     */
    util_queue_drop_job(&screen->compile_queue, &hwcso->ready);
 
+   /* Compute hwcso's never get variant jobs, or an initialized list: */
+   if (hwcso->screen) {
+      list_for_each_entry_safe (struct ir3_variant_job, job,
+                                &hwcso->variant_jobs, node) {
+         util_queue_drop_job(&screen->compile_queue, &job->ready);
+         util_queue_fence_destroy(&job->ready);
+         free(job);
+      }
+      simple_mtx_destroy(&hwcso->variant_jobs_lock);
+   }
+
    /* free the uploaded shaders, since this is handled outside of the
     * shared ir3 code (ie. not used by turnip):
     */
@@ -477,11 +520,115 @@ ir3_get_shader(struct ir3_shader_state *hwcso)
               shader->nir->info.label) {
       /* wait for initial variants to compile: */
       util_queue_fence_wait(&hwcso->ready);
+
+      /* and for any background variants, since a variant which is still
+       * being compiled is already in the shader's variant list but not
+       * uploaded yet:
+       */
+      if (hwcso->async_variants) {
+         simple_mtx_lock(&hwcso->variant_jobs_lock);
+         list_for_each_entry (struct ir3_variant_job, job,
+                              &hwcso->variant_jobs, node) {
+            util_queue_fence_wait(&job->ready);
+         }
+         simple_mtx_unlock(&hwcso->variant_jobs_lock);
+      }
    }
 
    return shader;
 }
 
+static void
+create_variant_async(void *_job, void *gdata, int thread_index)
+{
+   struct ir3_variant_job *job = _job;
+   struct ir3_shader *shader = job->hwcso->shader;
+   struct ir3_compiler *compiler = shader->compiler;
+   struct ir3_shader_key key = job->key;
+   struct util_debug_callback debug = {};
+
+   MESA_TRACE_FUNC();
+
+   /* This also compiles the binning pass variant for VS: */
+   struct ir3_shader_variant *v =
+      ir3_shader_variant(shader, key, false, &debug);
+
+   /* Like with the initial variants, the draw will likely want the
+    * safe_constlen variant too if this one turned out big:
+    */
+   if (v && !key.safe_constlen && v->constlen > compiler->max_const_safe) {
+      key.safe_constlen = true;
+      ir3_shader_variant(shader, key, false, &debug);
+   }
+
+   p_atomic_set(&job->done, true);
+   p_atomic_inc(&job->hwcso->screen->async_variants_seqno);
+}
+
+static struct ir3_variant_job *
+find_variant_job(struct ir3_shader_state *hwcso,
+                 const struct ir3_shader_key *key)
+{
+   list_for_each_entry (struct ir3_variant_job, job,
+                        &hwcso->variant_jobs, node) {
+      if (ir3_shader_key_equal(&job->key, key))
+         return job;
+   }
+
+   return NULL;
+}
+
+/**
+ * Returns whether the variant for the given key can be used right away.
+ * If it does not exist yet, and async variants are enabled, it is queued
+ * for compilation in the background and false is returned until it is
+ * ready.  Without async variants this always returns true, leaving the
+ * compile to the draw.
+ */
+bool
+ir3_shader_state_variant_ready(struct ir3_shader_state *hwcso,
+                               const struct ir3_shader_key *key)
+{
+   if (!hwcso || !hwcso->async_variants)
+      return true;
+
+   struct ir3_shader *shader = hwcso->shader;
+
+   /* The initial variants are what we fall back to, so nothing to gain
+    * until they exist:
+    */
+   if (!util_queue_fence_is_signalled(&hwcso->ready))
+      return true;
+
+   struct ir3_shader_key k = *key;
+   ir3_key_clear_unused(&k, shader);
+
+   simple_mtx_lock(&hwcso->variant_jobs_lock);
+
+   struct ir3_variant_job *job = find_variant_job(hwcso, &k);
+   bool ready;
+
+   if (job) {
+      ready = p_atomic_read(&job->done);
+   } else if (ir3_shader_lookup_variant(shader, &k)) {
+      ready = true;
+   } else {
+      job = calloc(1, sizeof(*job));
+      job->hwcso = hwcso;
+      job->key = k;
+      util_queue_fence_init(&job->ready);
+      list_addtail(&job->node, &hwcso->variant_jobs);
+
+      util_queue_add_job(&hwcso->screen->compile_queue, job, &job->ready,
+                         create_variant_async, NULL, 0);
+      ready = false;
+   }
+
+   simple_mtx_unlock(&hwcso->variant_jobs_lock);
+
+   return ready;
+}
+
 struct shader_info *
 ir3_get_shader_info(struct ir3_shader_state *hwcso)
 {
@@ -52,6 +52,8 @@ void *ir3_shader_state_create(struct pipe_context *pctx,
 void ir3_shader_state_delete(struct pipe_context *pctx, void *hwcso);
 
 struct ir3_shader *ir3_get_shader(struct ir3_shader_state *hwcso);
+bool ir3_shader_state_variant_ready(struct ir3_shader_state *hwcso,
+                                    const struct ir3_shader_key *key);
 struct shader_info *ir3_get_shader_info(struct ir3_shader_state *hwcso);
 
 void ir3_fixup_shader_state(struct pipe_context *pctx,
@@ -14,6 +14,7 @@ DRI_CONF_SECTION_PERFORMANCE
    DRI_CONF_OPT_E(bo_reuse, 1, 0, 1, "Buffer object reuse",)
    DRI_CONF_OPT_B(intel_tbimr, true, "Enable TBIMR tiled rendering")
    DRI_CONF_OPT_I(generated_indirect_threshold, 100, 0, INT32_MAX, "Generated indirect draw threshold")
+   DRI_CONF_SHADER_SPILLING_RATE(0)
 DRI_CONF_SECTION_END
 
 DRI_CONF_SECTION_QUALITY
@@ -989,7 +989,6 @@ alloc_bo_from_slabs(struct iris_bufmgr *bufmgr,
 static struct iris_bo *
 alloc_bo_from_cache(struct iris_bufmgr *bufmgr,
                     struct bo_cache_bucket *bucket,
-                    uint32_t alignment,
                     enum iris_memory_zone memzone,
                     enum iris_mmap_mode mmap_mode,
                     unsigned flags,
@@ -1034,52 +1033,65 @@ alloc_bo_from_cache(struct iris_bufmgr *bufmgr,
          continue;
       }
 
-      if (cur->aux_map_address) {
-         /* This buffer was associated with an aux-buffer range. We make sure
-          * that buffers are not reused from the cache while the buffer is (busy)
-          * being used by an executing batch. Since we are here, the buffer is no
-          * longer being used by a batch and the buffer was deleted (in order to
-          * end up in the cache). Therefore its old aux-buffer range can be
-          * removed from the aux-map.
-          */
-         if (cur->bufmgr->aux_map_ctx)
-            intel_aux_map_unmap_range(cur->bufmgr->aux_map_ctx, cur->address,
-                                      cur->size);
-         cur->aux_map_address = 0;
-      }
+      bo = cur;
+      break;
+   }
 
-      /* If the cached BO isn't in the right memory zone, or the alignment
-       * isn't sufficient, free the old memory and assign it a new address.
+   return bo;
+}
+
+/**
+ * Get a BO taken out of the cache ready for reuse.
+ *
+ * The BO is no longer on any list, so this is done without holding
+ * bufmgr->lock, which keeps the unbind ioctl and the zeroing of large
+ * buffers out of the critical section of every other allocation.
+ */
+static bool
+prepare_cached_bo(struct iris_bufmgr *bufmgr,
+                  struct iris_bo *bo,
+                  uint32_t alignment,
+                  enum iris_memory_zone memzone,
+                  unsigned flags)
+{
+   if (bo->aux_map_address) {
+      /* This buffer was associated with an aux-buffer range. We make sure
+       * that buffers are not reused from the cache while the buffer is (busy)
+       * being used by an executing batch. Since we are here, the buffer is no
+       * longer being used by a batch and the buffer was deleted (in order to
+       * end up in the cache). Therefore its old aux-buffer range can be
+       * removed from the aux-map.
        */
-      if (memzone != iris_memzone_for_address(cur->address) ||
-          cur->address % alignment != 0) {
-         if (!bufmgr->kmd_backend->gem_vm_unbind(cur)) {
-            DBG("Unable to unbind vm of buf %u\n", cur->gem_handle);
-            bo_free(cur);
-            continue;
-         }
+      if (bo->bufmgr->aux_map_ctx)
+         intel_aux_map_unmap_range(bo->bufmgr->aux_map_ctx, bo->address,
+                                   bo->size);
+      bo->aux_map_address = 0;
+   }
 
-         vma_free(bufmgr, cur->address, cur->size);
-         cur->address = 0ull;
+   /* If the cached BO isn't in the right memory zone, or the alignment
+    * isn't sufficient, free the old memory and assign it a new address.
+    */
+   if (memzone != iris_memzone_for_address(bo->address) ||
+       bo->address % alignment != 0) {
+      if (!bufmgr->kmd_backend->gem_vm_unbind(bo)) {
+         DBG("Unable to unbind vm of buf %u\n", bo->gem_handle);
+         return false;
       }
 
-      bo = cur;
-      break;
+      simple_mtx_lock(&bufmgr->lock);
+      vma_free(bufmgr, bo->address, bo->size);
+      simple_mtx_unlock(&bufmgr->lock);
+      bo->address = 0ull;
    }
 
-   if (!bo)
-      return NULL;
-
    /* Zero the contents if necessary.  If this fails, fall back to
     * allocating a fresh BO, which will always be zeroed by the kernel.
     */
    assert(bo->zeroed == false);
-   if ((flags & BO_ALLOC_ZEROED) && !zero_bo(bufmgr, flags, bo)) {
-      bo_free(bo);
-      return NULL;
-   }
+   if ((flags & BO_ALLOC_ZEROED) && !zero_bo(bufmgr, flags, bo))
+      return false;
 
-   return bo;
+   return true;
 }
 
 static struct iris_bo *
@@ -1211,17 +1223,23 @@ iris_bo_alloc(struct iris_bufmgr *bufmgr,
    /* Get a buffer out of the cache if available.  First, we try to find
     * one with a matching memory zone so we can avoid reallocating VMA.
     */
-   bo = alloc_bo_from_cache(bufmgr, bucket, alignment, memzone, mmap_mode,
-                            flags, true);
+   bo = alloc_bo_from_cache(bufmgr, bucket, memzone, mmap_mode, flags, true);
 
    /* If that fails, we try for any cached BO, without matching memzone. */
    if (!bo) {
-      bo = alloc_bo_from_cache(bufmgr, bucket, alignment, memzone, mmap_mode,
-                               flags, false);
+      bo = alloc_bo_from_cache(bufmgr, bucket, memzone, mmap_mode, flags,
+                               false);
    }
 
    simple_mtx_unlock(&bufmgr->lock);
 
+   if (bo && !prepare_cached_bo(bufmgr, bo, alignment, memzone, flags)) {
+      simple_mtx_lock(&bufmgr->lock);
+      bo_free(bo);
+      simple_mtx_unlock(&bufmgr->lock);
+      bo = NULL;
+   }
+
    if (!bo) {
       bo = alloc_fresh_bo(bufmgr, bo_size, flags);
       if (!bo)
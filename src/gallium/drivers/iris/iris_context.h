@@ -1365,6 +1365,19 @@ iris_disk_cache_retrieve(struct iris_screen *screen,
                          struct iris_compiled_shader *shader,
                          const void *prog_key,
                          uint32_t prog_key_size);
+void iris_disk_cache_store_blorp(struct iris_screen *screen,
+                                 uint32_t stage,
+                                 const void *key, uint32_t key_size,
+                                 const void *kernel, uint32_t kernel_size,
+                                 const void *prog_data,
+                                 uint32_t prog_data_size);
+bool iris_disk_cache_retrieve_blorp(struct iris_screen *screen,
+                                    void *mem_ctx,
+                                    const void *key, uint32_t key_size,
+                                    uint32_t *stage_out,
+                                    const void **kernel_out,
+                                    void **prog_data_out,
+                                    uint32_t *prog_data_size_out);
 
 /* iris_program_cache.c */
 
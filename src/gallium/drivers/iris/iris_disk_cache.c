@@ -313,6 +313,160 @@ iris_disk_cache_retrieve(struct iris_screen *screen,
 #endif
 }
 
+/**
+ * Store a BLORP shader in the disk cache.
+ *
+ * BLORP keys are plain structs starting with the "blorp" name, so they are
+ * hashed directly.  BLORP shaders have no params, so only the prog data,
+ * the assembly and the shader relocations need to be saved.
+ */
+void
+iris_disk_cache_store_blorp(struct iris_screen *screen,
+                            uint32_t stage,
+                            const void *key, uint32_t key_size,
+                            const void *kernel, uint32_t kernel_size,
+                            const void *prog_data, uint32_t prog_data_size)
+{
+#ifdef ENABLE_SHADER_CACHE
+   struct disk_cache *cache = screen->disk_cache;
+
+   if (!cache)
+      return;
+
+   cache_key cache_key;
+   disk_cache_compute_key(cache, key, key_size, cache_key);
+
+   if (debug) {
+      char sha1[41];
+      _mesa_sha1_format(sha1, cache_key);
+      fprintf(stderr, "[mesa disk cache] storing blorp %s\n", sha1);
+   }
+
+   const void *relocs;
+   uint32_t relocs_size;
+   union {
+      union brw_any_prog_data brw;
+      union elk_any_prog_data elk;
+   } serializable;
+   if (prog_data_size > sizeof(serializable))
+      return;
+   memcpy(&serializable, prog_data, prog_data_size);
+
+   if (screen->brw) {
+      const struct brw_stage_prog_data *brw = prog_data;
+      relocs = brw->relocs;
+      relocs_size = brw->num_relocs * sizeof(struct brw_shader_reloc);
+      serializable.brw.base.param = NULL;
+      serializable.brw.base.relocs = NULL;
+   } else {
+      const struct elk_stage_prog_data *elk = prog_data;
+      relocs = elk->relocs;
+      relocs_size = elk->num_relocs * sizeof(struct elk_shader_reloc);
+      serializable.elk.base.param = NULL;
+      serializable.elk.base.relocs = NULL;
+   }
+
+   struct blob blob;
+   blob_init(&blob);
+
+   blob_write_uint32(&blob, stage);
+   blob_write_uint32(&blob, prog_data_size);
+   blob_write_bytes(&blob, &serializable, prog_data_size);
+   blob_write_uint32(&blob, kernel_size);
+   blob_write_bytes(&blob, kernel, kernel_size);
+   blob_write_bytes(&blob, relocs, relocs_size);
+
+   if (!blob.out_of_memory)
+      disk_cache_put(cache, cache_key, blob.data, blob.size, NULL);
+   blob_finish(&blob);
+#endif
+}
+
+/**
+ * Search for a BLORP shader in the disk cache.
+ *
+ * On success, the prog data and kernel are allocated out of \p mem_ctx and
+ * ready to be handed to the in-memory program cache.
+ */
+bool
+iris_disk_cache_retrieve_blorp(struct iris_screen *screen,
+                               void *mem_ctx,
+                               const void *key, uint32_t key_size,
+                               uint32_t *stage_out,
+                               const void **kernel_out,
+                               void **prog_data_out,
+                               uint32_t *prog_data_size_out)
+{
+#ifdef ENABLE_SHADER_CACHE
+   struct disk_cache *cache = screen->disk_cache;
+
+   if (!cache)
+      return false;
+
+   cache_key cache_key;
+   disk_cache_compute_key(cache, key, key_size, cache_key);
+
+   size_t size;
+   void *buffer = disk_cache_get(cache, cache_key, &size);
+
+   if (debug) {
+      char sha1[41];
+      _mesa_sha1_format(sha1, cache_key);
+      fprintf(stderr, "[mesa disk cache] retrieving blorp %s: %s\n", sha1,
+              buffer ? "found" : "missing");
+   }
+
+   if (!buffer)
+      return false;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, buffer, size);
+
+   const uint32_t stage = blob_read_uint32(&blob);
+   const uint32_t prog_data_size = blob_read_uint32(&blob);
+   void *prog_data = ralloc_size(mem_ctx, prog_data_size);
+   blob_copy_bytes(&blob, prog_data, prog_data_size);
+   const uint32_t kernel_size = blob_read_uint32(&blob);
+   void *kernel = ralloc_size(mem_ctx, kernel_size);
+   blob_copy_bytes(&blob, kernel, kernel_size);
+
+   if (screen->brw) {
+      struct brw_stage_prog_data *brw = prog_data;
+      if (brw->num_relocs) {
+         struct brw_shader_reloc *relocs =
+            ralloc_array(mem_ctx, struct brw_shader_reloc, brw->num_relocs);
+         blob_copy_bytes(&blob, relocs,
+                         brw->num_relocs * sizeof(struct brw_shader_reloc));
+         brw->relocs = relocs;
+      }
+   } else {
+      struct elk_stage_prog_data *elk = prog_data;
+      if (elk->num_relocs) {
+         struct elk_shader_reloc *relocs =
+            ralloc_array(mem_ctx, struct elk_shader_reloc, elk->num_relocs);
+         blob_copy_bytes(&blob, relocs,
+                         elk->num_relocs * sizeof(struct elk_shader_reloc));
+         elk->relocs = relocs;
+      }
+   }
+
+   const bool ok = !blob.overrun;
+   free(buffer);
+
+   if (!ok)
+      return false;
+
+   *stage_out = stage;
+   *kernel_out = kernel;
+   *prog_data_out = prog_data;
+   *prog_data_size_out = prog_data_size;
+
+   return true;
+#else
+   return false;
+#endif
+}
+
 /**
  * Initialize the on-disk shader cache.
  */
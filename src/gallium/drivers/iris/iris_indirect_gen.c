@@ -550,6 +550,7 @@ emit_indirect_generate_draw(struct iris_batch *batch,
 
    ice->state.dirty |= ~skip_bits;
    ice->state.stage_dirty |= ~skip_stage_bits;
+   genX(invalidate_packet_cache)(ice);
 
    for (int i = 0; i < ARRAY_SIZE(ice->shaders.urb.cfg.size); i++)
       ice->shaders.urb.cfg.size[i] = 0;
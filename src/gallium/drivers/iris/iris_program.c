@@ -3932,11 +3932,13 @@ iris_compiler_init(struct iris_screen *screen)
       screen->brw->shader_debug_log = iris_shader_debug_log;
       screen->brw->shader_perf_log = iris_shader_perf_log;
       screen->brw->indirect_ubos_use_sampler = iris_indirect_ubos_use_sampler(screen);
+      screen->brw->spilling_rate = screen->driconf.shader_spilling_rate;
    } else {
       screen->elk = elk_compiler_create(screen, screen->devinfo);
       screen->elk->shader_debug_log = iris_shader_debug_log;
       screen->elk->shader_perf_log = iris_shader_perf_log;
       screen->elk->supports_shader_constants = true;
       screen->elk->indirect_ubos_use_sampler = iris_indirect_ubos_use_sampler(screen);
+      screen->elk->spilling_rate = screen->driconf.shader_spilling_rate;
    }
 }
@@ -213,39 +213,13 @@ iris_upload_shader(struct iris_screen *screen,
    }
 }
 
-bool
-iris_blorp_lookup_shader(struct blorp_batch *blorp_batch,
-                         const void *key, uint32_t key_size,
-                         uint32_t *kernel_out, void *prog_data_out)
-{
-   struct blorp_context *blorp = blorp_batch->blorp;
-   struct iris_context *ice = blorp->driver_ctx;
-   struct iris_batch *batch = blorp_batch->driver_batch;
-   struct iris_screen *screen = batch->screen;
-   struct iris_compiled_shader *shader =
-      iris_find_cached_shader(ice, IRIS_CACHE_BLORP, key_size, key);
-
-   if (!shader)
-      return false;
-
-   struct iris_bo *bo = iris_resource_bo(shader->assembly.res);
-   *kernel_out =
-      iris_bo_offset_from_base_address(bo) + shader->assembly.offset;
-   *((void **) prog_data_out) = screen->brw ? (void *)shader->brw_prog_data
-                                            : (void *)shader->elk_prog_data;
-
-   iris_use_pinned_bo(batch, bo, false, IRIS_DOMAIN_NONE);
-
-   return true;
-}
-
-bool
-iris_blorp_upload_shader(struct blorp_batch *blorp_batch, uint32_t stage,
-                         const void *key, uint32_t key_size,
-                         const void *kernel, UNUSED uint32_t kernel_size,
-                         const void *prog_data_templ,
-                         UNUSED uint32_t prog_data_size,
-                         uint32_t *kernel_out, void *prog_data_out)
+static void
+iris_blorp_add_shader(struct blorp_batch *blorp_batch, uint32_t stage,
+                      const void *key, uint32_t key_size,
+                      const void *kernel,
+                      const void *prog_data_templ,
+                      uint32_t prog_data_size,
+                      uint32_t *kernel_out, void *prog_data_out)
 {
    struct blorp_context *blorp = blorp_batch->blorp;
    struct iris_context *ice = blorp->driver_ctx;
@@ -282,6 +256,71 @@ iris_blorp_upload_shader(struct blorp_batch *blorp_batch, uint32_t stage,
                                             : (void *)shader->elk_prog_data;
 
    iris_use_pinned_bo(batch, bo, false, IRIS_DOMAIN_NONE);
+}
+
+bool
+iris_blorp_lookup_shader(struct blorp_batch *blorp_batch,
+                         const void *key, uint32_t key_size,
+                         uint32_t *kernel_out, void *prog_data_out)
+{
+   struct blorp_context *blorp = blorp_batch->blorp;
+   struct iris_context *ice = blorp->driver_ctx;
+   struct iris_batch *batch = blorp_batch->driver_batch;
+   struct iris_screen *screen = batch->screen;
+   struct iris_compiled_shader *shader =
+      iris_find_cached_shader(ice, IRIS_CACHE_BLORP, key_size, key);
+
+   if (!shader) {
+      /* BLORP compiles on first use, on the thread doing the blit or clear.
+       * Try the disk cache before letting it do so.
+       */
+      void *mem_ctx = ralloc_context(NULL);
+      uint32_t stage, prog_data_size;
+      const void *kernel;
+      void *prog_data;
+
+      bool found =
+         iris_disk_cache_retrieve_blorp(screen, mem_ctx, key, key_size,
+                                        &stage, &kernel, &prog_data,
+                                        &prog_data_size);
+      if (found) {
+         iris_blorp_add_shader(blorp_batch, stage, key, key_size, kernel,
+                               prog_data, prog_data_size,
+                               kernel_out, prog_data_out);
+      }
+
+      ralloc_free(mem_ctx);
+      return found;
+   }
+
+   struct iris_bo *bo = iris_resource_bo(shader->assembly.res);
+   *kernel_out =
+      iris_bo_offset_from_base_address(bo) + shader->assembly.offset;
+   *((void **) prog_data_out) = screen->brw ? (void *)shader->brw_prog_data
+                                            : (void *)shader->elk_prog_data;
+
+   iris_use_pinned_bo(batch, bo, false, IRIS_DOMAIN_NONE);
+
+   return true;
+}
+
+bool
+iris_blorp_upload_shader(struct blorp_batch *blorp_batch, uint32_t stage,
+                         const void *key, uint32_t key_size,
+                         const void *kernel, uint32_t kernel_size,
+                         const void *prog_data_templ,
+                         uint32_t prog_data_size,
+                         uint32_t *kernel_out, void *prog_data_out)
+{
+   struct iris_batch *batch = blorp_batch->driver_batch;
+
+   iris_disk_cache_store_blorp(batch->screen, stage, key, key_size,
+                               kernel, kernel_size,
+                               prog_data_templ, prog_data_size);
+
+   iris_blorp_add_shader(blorp_batch, stage, key, key_size, kernel,
+                         prog_data_templ, prog_data_size,
+                         kernel_out, prog_data_out);
 
    return true;
 }
@@ -843,6 +843,8 @@ iris_screen_create(int fd, const struct pipe_screen_config *config)
       driQueryOptionb(config->options, "intel_tbimr");
    screen->driconf.generated_indirect_threshold =
       driQueryOptioni(config->options, "generated_indirect_threshold");
+   screen->driconf.shader_spilling_rate =
+      driQueryOptioni(config->options, "shader_spilling_rate");
 
    screen->precompile = debug_get_bool_option("shader_precompile", true);
 
@@ -206,6 +206,7 @@ struct iris_screen {
       bool intel_enable_wa_14018912822;
       bool enable_tbimr;
       unsigned generated_indirect_threshold;
+      int shader_spilling_rate;
    } driconf;
 
    /** Does the kernel support various features (KERNEL_HAS_* bitfield)? */
@@ -1532,6 +1532,12 @@ struct iris_genx_state {
    struct iris_vertex_buffer_state vertex_buffers[33];
    uint32_t last_index_buffer[GENX(3DSTATE_INDEX_BUFFER_length)];
 
+   /* Shadow copies of the last packets emitted, see iris_emit_if_changed() */
+   uint32_t last_sbe[GENX(3DSTATE_SBE_length)];
+   uint32_t last_sbe_swiz[GENX(3DSTATE_SBE_SWIZ_length)];
+   uint32_t last_vertex_elements[1 + 33 * GENX(VERTEX_ELEMENT_STATE_length)];
+   uint32_t last_vf_instancing[33 * GENX(3DSTATE_VF_INSTANCING_length)];
+
    struct iris_depth_buffer_state depth_buffer;
 
    uint32_t so_buffers[4 * GENX(3DSTATE_SO_BUFFER_length)];
@@ -4652,6 +4658,27 @@ iris_compute_sbe_urb_read_interval(uint64_t fs_input_slots,
    *out_length = DIV_ROUND_UP(last_read_slot - first_slot + 1, 2);
 }
 
+/**
+ * Emit already packed dwords, unless they match the shadow copy of what was
+ * last emitted in their place.
+ *
+ * Dirty bits are coarse: a new rasterizer or program often results in the
+ * exact same SBE or vertex element packets, and re-emitting them is not free.
+ * A zeroed shadow copy never matches a real packet header, so clearing it is
+ * enough to force the next emit.  Anything else that programs the same state
+ * must clear the shadow copies, see genX(invalidate_packet_cache)().
+ */
+static void
+iris_emit_if_changed(struct iris_batch *batch, uint32_t *last,
+                     const uint32_t *dw, unsigned dwords)
+{
+   if (memcmp(last, dw, dwords * sizeof(uint32_t)) == 0)
+      return;
+
+   memcpy(last, dw, dwords * sizeof(uint32_t));
+   iris_batch_emit(batch, dw, dwords * sizeof(uint32_t));
+}
+
 static void
 iris_emit_sbe_swiz(struct iris_batch *batch,
                    const struct iris_context *ice,
@@ -4737,10 +4764,13 @@ iris_emit_sbe_swiz(struct iris_batch *batch,
          attr->SwizzleSelect = INPUTATTR_FACING;
    }
 
-   iris_emit_cmd(batch, GENX(3DSTATE_SBE_SWIZ), sbes) {
+   uint32_t sbe_swiz[GENX(3DSTATE_SBE_SWIZ_length)];
+   iris_pack_command(GENX(3DSTATE_SBE_SWIZ), sbe_swiz, sbes) {
       for (int i = 0; i < 16; i++)
          sbes.Attribute[i] = attr_overrides[i];
    }
+   iris_emit_if_changed(batch, ice->state.genx->last_sbe_swiz, sbe_swiz,
+                        GENX(3DSTATE_SBE_SWIZ_length));
 }
 
 static bool
@@ -4802,7 +4832,8 @@ iris_emit_sbe(struct iris_batch *batch, const struct iris_context *ice)
       iris_is_drawing_points(ice) ?
       iris_calculate_point_sprite_overrides(fs_data, cso_rast) : 0;
 
-   iris_emit_cmd(batch, GENX(3DSTATE_SBE), sbe) {
+   uint32_t sbe_dw[GENX(3DSTATE_SBE_length)];
+   iris_pack_command(GENX(3DSTATE_SBE), sbe_dw, sbe) {
       sbe.AttributeSwizzleEnable = true;
       sbe.NumberofSFOutputAttributes = fs_data->num_varying_inputs;
       sbe.PointSpriteTextureCoordinateOrigin = cso_rast->sprite_coord_mode;
@@ -4831,6 +4862,8 @@ iris_emit_sbe(struct iris_batch *batch, const struct iris_context *ice)
          sbe.PrimitiveIDOverrideComponentW = true;
       }
    }
+   iris_emit_if_changed(batch, ice->state.genx->last_sbe, sbe_dw,
+                        GENX(3DSTATE_SBE_length));
 
    iris_emit_sbe_swiz(batch, ice, last_vue_map, urb_read_offset,
                       sprite_coord_overrides);
@@ -6787,6 +6820,8 @@ iris_upload_dirty_render_state(struct iris_context *ice,
                   IRIS_DIRTY_STREAMOUT |
                   IRIS_DIRTY_VERTEX_ELEMENTS |
                   IRIS_DIRTY_VF_TOPOLOGY;
+         memset(genx->last_vertex_elements, 0,
+                sizeof(genx->last_vertex_elements));
 
          for (int stage = 0; stage < MESA_SHADER_FRAGMENT; stage++) {
             if (ice->shaders.prog[stage])
@@ -7934,8 +7969,9 @@ iris_upload_dirty_render_state(struct iris_context *ice,
       if (!(ice->state.vs_needs_sgvs_element ||
             ice->state.vs_uses_derived_draw_params ||
             ice->state.vs_needs_edge_flag)) {
-         iris_batch_emit(batch, cso->vertex_elements, sizeof(uint32_t) *
-                         (1 + entries * GENX(VERTEX_ELEMENT_STATE_length)));
+         iris_emit_if_changed(batch, genx->last_vertex_elements,
+                              cso->vertex_elements,
+                              1 + entries * GENX(VERTEX_ELEMENT_STATE_length));
       } else {
          uint32_t dynamic_ves[1 + 33 * GENX(VERTEX_ELEMENT_STATE_length)];
          const unsigned dyn_count = cso->count +
@@ -7988,13 +8024,15 @@ iris_upload_dirty_render_state(struct iris_context *ice,
                ve_pack_dest[i] = cso->edgeflag_ve[i];
          }
 
-         iris_batch_emit(batch, &dynamic_ves, sizeof(uint32_t) *
-                         (1 + dyn_count * GENX(VERTEX_ELEMENT_STATE_length)));
+         iris_emit_if_changed(batch, genx->last_vertex_elements, dynamic_ves,
+                              1 + dyn_count *
+                              GENX(VERTEX_ELEMENT_STATE_length));
       }
 
       if (!ice->state.vs_needs_edge_flag) {
-         iris_batch_emit(batch, cso->vf_instancing, sizeof(uint32_t) *
-                         entries * GENX(3DSTATE_VF_INSTANCING_length));
+         iris_emit_if_changed(batch, genx->last_vf_instancing,
+                              cso->vf_instancing,
+                              entries * GENX(3DSTATE_VF_INSTANCING_length));
       } else {
          assert(cso->count > 0);
          const unsigned edgeflag_index = cso->count - 1;
@@ -8012,8 +8050,8 @@ iris_upload_dirty_render_state(struct iris_context *ice,
          for (int i = 0; i < GENX(3DSTATE_VF_INSTANCING_length);  i++)
             vfi_pack_dest[i] |= cso->edgeflag_vfi[i];
 
-         iris_batch_emit(batch, &dynamic_vfi[0], sizeof(uint32_t) *
-                         entries * GENX(3DSTATE_VF_INSTANCING_length));
+         iris_emit_if_changed(batch, genx->last_vf_instancing, dynamic_vfi,
+                              entries * GENX(3DSTATE_VF_INSTANCING_length));
       }
    }
 
@@ -10075,6 +10113,25 @@ iris_lost_genx_state(struct iris_context *ice, struct iris_batch *batch)
 #endif
 
    memset(genx->last_index_buffer, 0, sizeof(genx->last_index_buffer));
+   genX(invalidate_packet_cache)(ice);
+}
+
+/**
+ * Forget the packets remembered by iris_emit_if_changed().
+ *
+ * Called by BLORP and the indirect draw generation, which program the same
+ * 3D state with their own values.
+ */
+void
+genX(invalidate_packet_cache)(struct iris_context *ice)
+{
+   struct iris_genx_state *genx = ice->state.genx;
+
+   memset(genx->last_sbe, 0, sizeof(genx->last_sbe));
+   memset(genx->last_sbe_swiz, 0, sizeof(genx->last_sbe_swiz));
+   memset(genx->last_vertex_elements, 0,
+          sizeof(genx->last_vertex_elements));
+   memset(genx->last_vf_instancing, 0, sizeof(genx->last_vf_instancing));
 }
 
 static void
@@ -40,6 +40,7 @@
 #include "util/u_upload_mgr.h"
 #include "lp_clear.h"
 #include "lp_context.h"
+#include "lp_debug.h"
 #include "lp_flush.h"
 #include "lp_perf.h"
 #include "lp_state.h"
@@ -61,6 +62,11 @@ llvmpipe_destroy(struct pipe_context *pipe)
    mtx_unlock(&lp_screen->ctx_mutex);
    lp_print_counters();
 
+   if (llvmpipe->has_fs_compile_queue)
+      util_queue_destroy(&llvmpipe->fs_compile_queue);
+
+   llvmpipe_destroy_cs_variants(llvmpipe);
+
    if (llvmpipe->csctx) {
       lp_csctx_destroy(llvmpipe->csctx);
    }
@@ -269,6 +275,16 @@ llvmpipe_create_context(struct pipe_screen *screen, void *priv,
    LLVMContextSetOpaquePointers(llvmpipe->context, false);
 #endif
 
+#ifndef USE_GLOBAL_LLVM_CONTEXT
+   /* Background fs variant compiles use their own LLVMContext each. */
+   if (lp_screen->num_threads && !(LP_PERF & PERF_NO_PRECOMPILE)) {
+      llvmpipe->has_fs_compile_queue =
+         util_queue_init(&llvmpipe->fs_compile_queue, "lpfs", 32, 1,
+                         UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                         UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY, NULL);
+   }
+#endif
+
    /*
     * Create drawing context and plug our rendering stage into it.
     */
@@ -285,6 +301,9 @@ llvmpipe_create_context(struct pipe_screen *screen, void *priv,
    draw_set_constant_buffer_stride(llvmpipe->draw,
                                    lp_get_constant_buffer_stride(screen));
 
+   /* With LP_NUM_THREADS=0 everything stays on the calling thread. */
+   draw_set_vs_threads(llvmpipe->draw, lp_screen->num_threads);
+
    /* FIXME: devise alternative to draw_texture_samplers */
 
    llvmpipe->setup = lp_setup_create(&llvmpipe->pipe, llvmpipe->draw);
@@ -192,6 +192,10 @@ struct llvmpipe_context {
    /** The LLVMContext to use for LLVM related work */
    LLVMContextRef context;
 
+   /** Background thread compiling fs variants ahead of their first draw */
+   struct util_queue fs_compile_queue;
+   bool has_fs_compile_queue;
+
    int max_global_buffers;
    struct pipe_resource **global_buffers;
 
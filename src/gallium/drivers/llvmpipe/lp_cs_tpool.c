@@ -28,25 +28,87 @@
  * based on threadpool.c but modified heavily to be compute shader tuned.
  */
 
+#include "util/os_time.h"
+#include "util/u_atomic.h"
 #include "util/u_thread.h"
 #include "util/u_memory.h"
 #include "lp_cs_tpool.h"
 
+/* How long an idle worker keeps polling for new work before it goes to
+ * sleep.  Small back-to-back dispatches then find the pool still running
+ * instead of paying for a wakeup of every thread each time.
+ */
+#define LP_CS_TPOOL_SPIN_NS 50000
+
+/* Hand out the next chunk of iterations of a task, called with the pool
+ * mutex held.  Returns the number of iterations to run from *iter.
+ */
+static unsigned
+lp_cs_tpool_take_iters(struct lp_cs_tpool_task *task, unsigned *iter)
+{
+   unsigned iter_per_thread = task->iter_per_thread;
+
+   *iter = task->iter_start;
+
+   if (task->iter_remainder &&
+       task->iter_start + task->iter_remainder == task->iter_total) {
+      task->iter_remainder--;
+      iter_per_thread = 1;
+   }
+
+   task->iter_start += iter_per_thread;
+
+   if (task->iter_start == task->iter_total)
+      list_del(&task->list);
+
+   return iter_per_thread;
+}
+
+static void
+lp_cs_tpool_run_iters(struct lp_cs_tpool *pool,
+                      struct lp_cs_tpool_task *task,
+                      unsigned this_iter, unsigned num_iters,
+                      struct lp_cs_local_mem *lmem)
+{
+   mtx_unlock(&pool->m);
+   for (unsigned i = 0; i < num_iters; i++)
+      task->work(task->data, this_iter + i, lmem);
+
+   mtx_lock(&pool->m);
+   task->iter_finished += num_iters;
+   if (task->iter_finished == task->iter_total)
+      cnd_broadcast(&task->finish);
+}
+
 static int
 lp_cs_tpool_worker(void *data)
 {
    struct lp_cs_tpool *pool = data;
    struct lp_cs_local_mem lmem;
+   bool spin = false;
 
    memset(&lmem, 0, sizeof(lmem));
    mtx_lock(&pool->m);
 
    while (!pool->shutdown) {
       struct lp_cs_tpool_task *task;
-      unsigned iter_per_thread;
-
-      while (list_is_empty(&pool->workqueue) && !pool->shutdown)
+      unsigned this_iter, num_iters;
+
+      while (list_is_empty(&pool->workqueue) && !pool->shutdown) {
+         if (spin) {
+            const unsigned seq = pool->num_queued;
+            const int64_t end = os_time_get_nano() + LP_CS_TPOOL_SPIN_NS;
+
+            mtx_unlock(&pool->m);
+            while (p_atomic_read(&pool->num_queued) == seq &&
+                   os_time_get_nano() < end)
+               thrd_yield();
+            mtx_lock(&pool->m);
+            spin = false;
+            continue;
+         }
          cnd_wait(&pool->new_work, &pool->m);
+      }
 
       if (pool->shutdown)
          break;
@@ -54,29 +116,9 @@ lp_cs_tpool_worker(void *data)
       task = list_first_entry(&pool->workqueue, struct lp_cs_tpool_task,
                               list);
 
-      unsigned this_iter = task->iter_start;
-
-      iter_per_thread = task->iter_per_thread;
-
-      if (task->iter_remainder &&
-          task->iter_start + task->iter_remainder == task->iter_total) {
-         task->iter_remainder--;
-         iter_per_thread = 1;
-      }
-
-      task->iter_start += iter_per_thread;
-
-      if (task->iter_start == task->iter_total)
-         list_del(&task->list);
-
-      mtx_unlock(&pool->m);
-      for (unsigned i = 0; i < iter_per_thread; i++)
-         task->work(task->data, this_iter + i, &lmem);
-
-      mtx_lock(&pool->m);
-      task->iter_finished += iter_per_thread;
-      if (task->iter_finished == task->iter_total)
-         cnd_broadcast(&task->finish);
+      num_iters = lp_cs_tpool_take_iters(task, &this_iter);
+      lp_cs_tpool_run_iters(pool, task, this_iter, num_iters, &lmem);
+      spin = true;
    }
    mtx_unlock(&pool->m);
    FREE(lmem.local_mem_ptr);
@@ -151,14 +193,16 @@ lp_cs_tpool_queue_task(struct lp_cs_tpool *pool,
    task->data = data;
    task->iter_total = num_iters;
 
-   task->iter_per_thread = num_iters / pool->num_threads;
-   task->iter_remainder = num_iters % pool->num_threads;
+   /* The thread waiting for the task works on it too. */
+   task->iter_per_thread = num_iters / (pool->num_threads + 1);
+   task->iter_remainder = num_iters % (pool->num_threads + 1);
 
    cnd_init(&task->finish);
 
    mtx_lock(&pool->m);
 
    list_addtail(&task->list, &pool->workqueue);
+   p_atomic_inc(&pool->num_queued);
 
    cnd_broadcast(&pool->new_work);
    mtx_unlock(&pool->m);
@@ -174,10 +218,23 @@ lp_cs_tpool_wait_for_task(struct lp_cs_tpool *pool,
    if (!pool || !task)
       return;
 
+   struct lp_cs_local_mem lmem;
+   memset(&lmem, 0, sizeof(lmem));
+
+   /* Rather than sleeping until the workers are done, pick up what they
+    * haven't started yet.  The task is still queued as long as not all
+    * iterations have been handed out.
+    */
    mtx_lock(&pool->m);
+   while (task->iter_start < task->iter_total) {
+      unsigned this_iter;
+      unsigned num_iters = lp_cs_tpool_take_iters(task, &this_iter);
+      lp_cs_tpool_run_iters(pool, task, this_iter, num_iters, &lmem);
+   }
    while (task->iter_finished < task->iter_total)
       cnd_wait(&task->finish, &pool->m);
    mtx_unlock(&pool->m);
+   FREE(lmem.local_mem_ptr);
 
    cnd_destroy(&task->finish);
    FREE(task);
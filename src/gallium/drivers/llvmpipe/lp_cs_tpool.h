@@ -30,6 +30,9 @@
  * structs with just unique indexes in them.
  * It also supports a local memory support struct to be passed from
  * outside the thread exec function.
+ * The thread waiting for a task executes iterations of it as well, and
+ * idle workers poll for a short while before sleeping, so that short
+ * back-to-back tasks don't wait for threads to wake up.
  */
 #ifndef LP_CS_QUEUE
 #define LP_CS_QUEUE
@@ -48,6 +51,7 @@ struct lp_cs_tpool {
    thrd_t threads[LP_MAX_THREADS];
    unsigned num_threads;
    struct list_head workqueue;
+   unsigned num_queued;   /**< tasks queued so far, for spinning workers */
    bool shutdown;
 };
 
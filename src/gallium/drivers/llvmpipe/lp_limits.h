@@ -66,7 +66,13 @@
 
 #define LP_MAX_SAMPLES 4
 
-#define LP_MAX_THREADS 32
+#define LP_MAX_THREADS 256
+
+/**
+ * Max number of groups of bins that are handed out to the rasterizer
+ * threads of one L3 cache domain, see lp_scene_bin_iter_next().
+ */
+#define LP_MAX_BIN_GROUPS 16
 
 
 /**
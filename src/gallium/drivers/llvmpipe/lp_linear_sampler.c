@@ -893,6 +893,10 @@ lp_linear_check_sampler(const struct lp_sampler_static_state *sampler,
    if (tex->target != TGSI_TEXTURE_2D)
       return false;
 
+   /* The linear samplers walk texture rows directly */
+   if (sampler->texture_state.tiled)
+      return false;
+
    if (tex->coord[0].file != TGSI_FILE_INPUT ||
        tex->coord[1].file != TGSI_FILE_INPUT)
       return false;
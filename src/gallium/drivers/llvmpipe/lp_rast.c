@@ -32,6 +32,7 @@
 #include "util/u_surface.h"
 #include "util/u_pack_color.h"
 #include "util/u_string.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_thread.h"
 #include "util/u_memset.h"
 #include "util/os_time.h"
@@ -78,7 +79,7 @@ lp_rast_begin(struct lp_rasterizer *rast,
    LP_DBG(DEBUG_RAST, "%s\n", __func__);
 
    lp_scene_begin_rasterization(scene);
-   lp_scene_bin_iter_begin(scene);
+   lp_scene_bin_iter_begin(scene, rast->num_bin_groups, rast->num_threads > 1);
 }
 
 
@@ -1062,7 +1063,7 @@ rasterize_scene(struct lp_rasterizer_task *task,
       int i, j;
 
       assert(scene);
-      while ((bin = lp_scene_bin_iter_next(scene, &i, &j))) {
+      while ((bin = lp_scene_bin_iter_next(scene, task->bin_group, &i, &j))) {
          if (!is_empty_bin(bin))
             rasterize_bin(task, bin, i, j);
       }
@@ -1167,6 +1168,15 @@ thread_function(void *init_data)
    snprintf(thread_name, sizeof thread_name, "llvmpipe-%u", task->thread_index);
    u_thread_setname(thread_name);
 
+   /* Keep the thread on its L3 cache, so that the bins of its group stay
+    * in the caches (and memory node) of the cores that rasterize them.
+    */
+   if (rast->pin_threads) {
+      const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+      util_set_current_thread_affinity(caps->L3_affinity_mask[task->L3], NULL,
+                                       caps->num_cpu_mask_bits);
+   }
+
    /* Make sure that denorms are treated like zeros. This is
     * the behavior required by D3D10. OpenGL doesn't care.
     */
@@ -1265,10 +1275,22 @@ lp_rast_create(unsigned num_threads)
       goto no_full_scenes;
    }
 
+   /* With several L3 caches, spread the threads over them and give the
+    * threads of each L3 cache their own group of bins.
+    */
+   const struct util_cpu_caps_t *caps = util_get_cpu_caps();
+   unsigned num_L3_caches = MAX2(caps->num_L3_caches, 1);
+
+   rast->num_bin_groups = num_threads > 1 ? MIN2(num_L3_caches, LP_MAX_BIN_GROUPS) : 1;
+   rast->pin_threads = num_threads > 1 && num_L3_caches > 1 && caps->L3_affinity_mask &&
+                       debug_get_bool_option("LP_PIN_THREADS", true);
+
    for (unsigned i = 0; i < MAX2(1, num_threads); i++) {
       struct lp_rasterizer_task *task = &rast->tasks[i];
       task->rast = rast;
       task->thread_index = i;
+      task->L3 = i % num_L3_caches;
+      task->bin_group = task->L3 * rast->num_bin_groups / num_L3_caches;
       task->thread_data.cache =
          align_malloc(sizeof(struct lp_build_format_cache), 16);
       if (!task->thread_data.cache) {
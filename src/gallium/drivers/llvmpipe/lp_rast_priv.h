@@ -97,6 +97,10 @@ struct lp_rasterizer_task
    /** "my" index */
    unsigned thread_index;
 
+   /** The L3 cache this thread runs on and the group of bins it rasterizes first */
+   unsigned L3;
+   unsigned bin_group;
+
    /** Non-interpolated passthru state and occlude counter for visible pixels */
    struct lp_jit_thread_data thread_data;
 
@@ -130,6 +134,10 @@ struct lp_rasterizer
    unsigned num_threads;
    thrd_t threads[LP_MAX_THREADS];
 
+   /** Number of groups the bins of a scene are split into, one per L3 cache */
+   unsigned num_bin_groups;
+   bool pin_threads;
+
    /** For synchronizing the rasterization threads */
    util_barrier barrier;
 
@@ -357,6 +365,12 @@ void
 lp_rast_triangle_32_3_16(struct lp_rasterizer_task *,
                          const union lp_rast_cmd_arg);
 
+#ifdef LP_RAST_AVX512
+void
+lp_rast_triangle_32_3_16_avx512(struct lp_rasterizer_task *,
+                                const union lp_rast_cmd_arg);
+#endif
+
 void
 lp_rast_triangle_32_4_16(struct lp_rasterizer_task *,
                          const union lp_rast_cmd_arg);
@@ -31,6 +31,8 @@
 
 #include <limits.h>
 #include "util/u_math.h"
+#include "util/u_cpu_detect.h"
+#include "gallivm/lp_bld_type.h"
 #include "lp_debug.h"
 #include "lp_perf.h"
 #include "lp_rast_priv.h"
@@ -297,6 +299,17 @@ lp_rast_triangle_32_3_16(struct lp_rasterizer_task *task,
    const int x = (arg.triangle.plane_mask & 0xff) + task->x;
    const int y = (arg.triangle.plane_mask >> 8) + task->y;
 
+#ifdef LP_RAST_AVX512
+   /* 512-bit code is only used when the vector width isn't capped below
+    * it, so LP_NATIVE_VECTOR_WIDTH keeps it off CPUs where the frequency
+    * drop isn't worth it.
+    */
+   if (lp_native_vector_width >= 512 && util_get_cpu_caps()->has_avx512f) {
+      lp_rast_triangle_32_3_16_avx512(task, arg);
+      return;
+   }
+#endif
+
    struct { unsigned mask:16; unsigned i:8; unsigned j:8; } out[16];
    unsigned nr = 0;
 
@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * AVX-512 rasterization of 16x16 blocks of 3-plane triangles.
+ *
+ * A 4x4 stamp is exactly one 512-bit vector of 32-bit edge values, so
+ * the coverage mask of a stamp comes straight out of one compare instead
+ * of the pack/movemask dance of the SSE version.  The trivial reject of
+ * all 16 stamps of the block is done with a single compare per plane too.
+ *
+ * This file is built with -mavx512f and must only be called when the CPU
+ * supports it, see lp_rast_triangle_32_3_16().
+ */
+
+#include <immintrin.h>
+
+#include "util/u_math.h"
+#include "lp_rast_priv.h"
+
+
+void
+lp_rast_triangle_32_3_16_avx512(struct lp_rasterizer_task *task,
+                                const union lp_rast_cmd_arg arg)
+{
+   const struct lp_rast_triangle *tri = arg.triangle.tri;
+   const struct lp_rast_plane *plane = GET_PLANES(tri);
+   const int x = (arg.triangle.plane_mask & 0xff) + task->x;
+   const int y = (arg.triangle.plane_mask >> 8) + task->y;
+
+   /* Lane k is pixel (k & 3, k >> 2) of a stamp, or stamp (k & 3, k >> 2)
+    * of the block.
+    */
+   const __m512i lane_x = _mm512_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3,
+                                            0, 1, 2, 3, 0, 1, 2, 3);
+   const __m512i lane_y = _mm512_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 3, 3, 3, 3);
+   const __m512i zero = _mm512_setzero_si512();
+
+   alignas(64) int32_t stamp_c[3][16];
+   __m512i pixel_c[3];
+   __mmask16 reject = 0;
+
+   for (unsigned p = 0; p < 3; p++) {
+      /* Same setup as the SSE version, in wrapping 32-bit arithmetic. */
+      const uint32_t dcdx = -(uint32_t)plane[p].dcdx;
+      const uint32_t dcdy = plane[p].dcdy;
+      const uint32_t rej = (plane[p].dcdy > 0 ? dcdy : 0) -
+                           (plane[p].dcdx < 0 ? (uint32_t)plane[p].dcdx : 0);
+      const uint32_t rej4 = (rej << 2) + 1;
+      const uint32_t c = (uint32_t)plane[p].c + dcdx * x + dcdy * y - 1;
+
+      const __m512i vdcdx = _mm512_set1_epi32(dcdx);
+      const __m512i vdcdy = _mm512_set1_epi32(dcdy);
+
+      pixel_c[p] = _mm512_add_epi32(_mm512_mullo_epi32(lane_x, vdcdx),
+                                    _mm512_mullo_epi32(lane_y, vdcdy));
+
+      const __m512i sc =
+         _mm512_add_epi32(_mm512_set1_epi32(c),
+                          _mm512_slli_epi32(pixel_c[p], 2));
+      _mm512_store_si512(stamp_c[p], sc);
+
+      reject |= _mm512_cmplt_epi32_mask(
+         _mm512_add_epi32(sc, _mm512_set1_epi32(rej4)), zero);
+   }
+
+   unsigned todo = ~reject & 0xffff;
+   while (todo) {
+      const unsigned k = u_bit_scan(&todo);
+
+      const __m512i c0 = _mm512_add_epi32(_mm512_set1_epi32(stamp_c[0][k]),
+                                          pixel_c[0]);
+      const __m512i c1 = _mm512_add_epi32(_mm512_set1_epi32(stamp_c[1][k]),
+                                          pixel_c[1]);
+      const __m512i c2 = _mm512_add_epi32(_mm512_set1_epi32(stamp_c[2][k]),
+                                          pixel_c[2]);
+
+      /* A pixel is outside if any of its edge values is negative. */
+      const __m512i c012 = _mm512_or_si512(_mm512_or_si512(c0, c1), c2);
+      const unsigned outside = _mm512_cmplt_epi32_mask(c012, zero);
+
+      if (outside != 0xffff)
+         lp_rast_shade_quads_mask(task,
+                                  &tri->inputs,
+                                  x + 4 * (k & 3),
+                                  y + 4 * (k >> 2),
+                                  0xffff & ~outside);
+   }
+}
@@ -25,6 +25,7 @@
  *
  **************************************************************************/
 
+#include "util/u_atomic.h"
 #include "util/u_framebuffer.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
@@ -103,6 +104,7 @@ lp_scene_destroy(struct lp_scene *scene)
    lp_scene_end_rasterization(scene);
    mtx_destroy(&scene->mutex);
    free(scene->tiles);
+   free(scene->bin_order);
    assert(scene->data.head == &scene->data.first);
    slab_free_st(&scene->setup->scene_slab, scene);
 }
@@ -547,60 +549,114 @@ lp_scene_is_resource_referenced(const struct lp_scene *scene,
 }
 
 
-/** advance curr_x,y to the next bin */
-static bool
-next_bin(struct lp_scene *scene)
+static int
+compare_bin_cost(const void *a, const void *b)
 {
-   scene->curr_x++;
-   if (scene->curr_x >= scene->tiles_x) {
-      scene->curr_x = 0;
-      scene->curr_y++;
+   const struct lp_bin_cost *ca = a, *cb = b;
+
+   /* Descending cost */
+   return ca->cost < cb->cost ? 1 : ca->cost > cb->cost ? -1 : 0;
+}
+
+
+static unsigned
+bin_cost(const struct cmd_bin *bin)
+{
+   unsigned cost = 0;
+
+   for (struct cmd_block *block = bin->head; block; block = block->next)
+      cost += block->count;
+
+   return cost;
+}
+
+
+/**
+ * Put the bins in [start, end) that are much more expensive than the
+ * average first, most expensive first, followed by the other bins in
+ * their original order. Rasterizing the heavy bins first keeps threads
+ * from idling at the end of the scene while one thread is still busy
+ * with a heavy bin it got last.
+ */
+static void
+order_bins(struct lp_scene *scene, unsigned start, unsigned end)
+{
+   struct lp_bin_cost *order = scene->bin_order;
+   unsigned total = 0, num_nonempty = 0;
+
+   for (unsigned i = start; i < end; i++) {
+      unsigned cost = bin_cost(&scene->tiles[i]);
+      total += cost;
+      num_nonempty += cost != 0;
    }
-   if (scene->curr_y >= scene->tiles_y) {
-      /* no more bins */
-      return false;
+
+   unsigned threshold = num_nonempty ? 2 * total / num_nonempty : UINT_MAX;
+   unsigned num_heavy = 0, num_light = 0;
+
+   for (unsigned i = start; i < end; i++) {
+      unsigned cost = bin_cost(&scene->tiles[i]);
+      if (cost > threshold)
+         order[start + num_heavy++] = (struct lp_bin_cost){i, cost};
    }
-   return true;
+
+   for (unsigned i = start; i < end; i++) {
+      unsigned cost = bin_cost(&scene->tiles[i]);
+      if (cost <= threshold)
+         order[start + num_heavy + num_light++] = (struct lp_bin_cost){i, cost};
+   }
+
+   qsort(&order[start], num_heavy, sizeof(*order), compare_bin_cost);
 }
 
 
 void
-lp_scene_bin_iter_begin(struct lp_scene *scene)
+lp_scene_bin_iter_begin(struct lp_scene *scene, unsigned num_groups,
+                        bool heavy_bins_first)
 {
-   scene->curr_x = scene->curr_y = -1;
+   num_groups = CLAMP(num_groups, 1, MIN2(LP_MAX_BIN_GROUPS, MAX2(scene->tiles_y, 1)));
+   scene->num_bin_groups = num_groups;
+   scene->use_bin_order = heavy_bins_first && scene->bin_order;
+
+   for (unsigned i = 0; i < num_groups; i++) {
+      scene->bin_group[i].next = scene->tiles_y * i / num_groups * scene->tiles_x;
+      scene->bin_group[i].end = scene->tiles_y * (i + 1) / num_groups * scene->tiles_x;
+
+      if (scene->use_bin_order)
+         order_bins(scene, scene->bin_group[i].next, scene->bin_group[i].end);
+   }
 }
 
 
 /**
  * Return pointer to next bin to be rendered.
- * The lp_scene::curr_x and ::curr_y fields will be advanced.
  * Multiple rendering threads will call this function to get a chunk
- * of work (a bin) to work on.
+ * of work (a bin) to work on. Bins of the given group are returned
+ * first, then bins left in the other groups.
  */
 struct cmd_bin *
-lp_scene_bin_iter_next(struct lp_scene *scene , int *x, int *y)
+lp_scene_bin_iter_next(struct lp_scene *scene, unsigned group, int *x, int *y)
 {
-   struct cmd_bin *bin = NULL;
+   unsigned num_groups = scene->num_bin_groups;
 
-   mtx_lock(&scene->mutex);
+   for (unsigned i = 0; i < num_groups; i++) {
+      unsigned g = (group + i) % num_groups;
 
-   if (scene->curr_x < 0) {
-      /* first bin */
-      scene->curr_x = 0;
-      scene->curr_y = 0;
-   } else if (!next_bin(scene)) {
-      /* no more bins left */
-      goto end;
-   }
+      /* Skip groups that are done without advancing their counter further. */
+      if (p_atomic_read(&scene->bin_group[g].next) >= scene->bin_group[g].end)
+         continue;
 
-   bin = lp_scene_get_bin(scene, scene->curr_x, scene->curr_y);
-   *x = scene->curr_x;
-   *y = scene->curr_y;
+      int bin = p_atomic_inc_return(&scene->bin_group[g].next) - 1;
+      if (bin < scene->bin_group[g].end) {
+         if (scene->use_bin_order)
+            bin = scene->bin_order[bin].index;
 
-end:
-   /*printf("return bin %p at %d, %d\n", (void *) bin, *bin_x, *bin_y);*/
-   mtx_unlock(&scene->mutex);
-   return bin;
+         *x = bin % scene->tiles_x;
+         *y = bin / scene->tiles_x;
+         return lp_scene_get_bin(scene, *x, *y);
+      }
+   }
+
+   return NULL;
 }
 
 
@@ -625,6 +681,9 @@ lp_scene_begin_binning(struct lp_scene *scene,
          return;
       memset(scene->tiles, 0, sizeof(struct cmd_bin) * num_required_tiles);
       scene->num_alloced_tiles = num_required_tiles;
+
+      free(scene->bin_order);
+      scene->bin_order = malloc(num_required_tiles * sizeof(*scene->bin_order));
    }
 
    /*
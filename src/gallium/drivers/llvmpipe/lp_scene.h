@@ -38,6 +38,7 @@
 #include "util/u_thread.h"
 #include "lp_rast.h"
 #include "lp_debug.h"
+#include "lp_limits.h"
 
 struct lp_scene_queue;
 struct lp_rast_state;
@@ -101,6 +102,15 @@ struct cmd_bin {
 };
 
 
+/**
+ * The estimated cost of rasterizing a bin, used to schedule bins.
+ */
+struct lp_bin_cost {
+   unsigned index;  /**< tiles_x * y + x */
+   unsigned cost;   /**< number of commands */
+};
+
+
 /**
  * This stores bulk data which is used for all memory allocations
  * within a scene.
@@ -195,7 +205,20 @@ struct lp_scene {
     */
    unsigned tiles_x, tiles_y;
 
-   int curr_x, curr_y;  /**< for iterating over bins */
+   /**
+    * For iterating over bins. The bins are split into groups of consecutive
+    * tile rows and each rasterizer thread takes bins from its own group first,
+    * see lp_scene_bin_iter_next().
+    */
+   unsigned num_bin_groups;
+   struct {
+      int next;  /**< next bin index, advanced atomically */
+      int end;
+   } bin_group[LP_MAX_BIN_GROUPS];
+
+   /** The order in which bins are handed out, heavy bins first (may be NULL) */
+   struct lp_bin_cost *bin_order;
+   bool use_bin_order;
    mtx_t mutex;
 
    unsigned num_alloced_tiles;
@@ -396,10 +419,11 @@ lp_scene_get_num_bins(const struct lp_scene *scene)
 
 
 void
-lp_scene_bin_iter_begin(struct lp_scene *scene);
+lp_scene_bin_iter_begin(struct lp_scene *scene, unsigned num_groups,
+                        bool heavy_bins_first);
 
 struct cmd_bin *
-lp_scene_bin_iter_next(struct lp_scene *scene, int *x, int *y);
+lp_scene_bin_iter_next(struct lp_scene *scene, unsigned group, int *x, int *y);
 
 
 
@@ -100,6 +100,7 @@ static const struct debug_named_value lp_perf_flags[] = {
    { "no_alphatest",   PERF_NO_ALPHATEST, NULL },
    { "no_rast_linear", PERF_NO_RAST_LINEAR, NULL },
    { "no_shade",       PERF_NO_SHADE, NULL },
+   { "no_precompile",  PERF_NO_PRECOMPILE, NULL },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -923,6 +924,7 @@ llvmpipe_destroy_screen(struct pipe_screen *_screen)
 
    mtx_destroy(&screen->rast_mutex);
    mtx_destroy(&screen->cs_mutex);
+   mtx_destroy(&screen->cs_variant_mutex);
    FREE(screen);
 }
 
@@ -1152,6 +1154,7 @@ llvmpipe_create_screen(struct sw_winsys *winsys)
    llvmpipe_init_screen_resource_funcs(&screen->base);
 
    screen->allow_cl = !!getenv("LP_CL");
+   screen->tiled_textures = debug_get_bool_option("LP_TILED_TEXTURES", false);
    screen->num_threads = util_get_cpu_caps()->nr_cpus > 1
       ? util_get_cpu_caps()->nr_cpus : 0;
    screen->num_threads = debug_get_num_option("LP_NUM_THREADS",
@@ -1169,6 +1172,7 @@ llvmpipe_create_screen(struct sw_winsys *winsys)
    list_inithead(&screen->ctx_list);
    (void) mtx_init(&screen->ctx_mutex, mtx_plain);
    (void) mtx_init(&screen->cs_mutex, mtx_plain);
+   (void) mtx_init(&screen->cs_variant_mutex, mtx_plain);
    (void) mtx_init(&screen->rast_mutex, mtx_plain);
 
    (void) mtx_init(&screen->late_mutex, mtx_plain);
@@ -61,8 +61,10 @@ struct llvmpipe_screen
 
    struct lp_cs_tpool *cs_tpool;
    mtx_t cs_mutex;
+   mtx_t cs_variant_mutex;   /**< compute shader variant lists */
 
    bool allow_cl;
+   bool tiled_textures;   /**< LP_TILED_TEXTURES */
 
    mtx_t late_mutex;
    bool late_init_done;
@@ -68,12 +68,20 @@ try_update_scene_state(struct lp_setup_context *setup);
 static unsigned
 lp_setup_wait_empty_scene(struct lp_setup_context *setup)
 {
-   /* just use the first scene if we run out */
-   if (setup->scenes[0]->fence) {
-      lp_fence_wait(setup->scenes[0]->fence);
-      lp_scene_end_rasterization(setup->scenes[0]);
+   /* All the scenes are in use. They are rasterized in the order they were
+    * queued, so wait for the oldest one (the one with the oldest fence).
+    * Waiting for any other scene would also wait for all the scenes queued
+    * before it and drain the pipeline.
+    */
+   unsigned oldest = 0;
+   for (unsigned i = 1; i < setup->num_active_scenes; i++) {
+      if ((int)(setup->scenes[i]->fence->id - setup->scenes[oldest]->fence->id) < 0)
+         oldest = i;
    }
-   return 0;
+
+   lp_fence_wait(setup->scenes[oldest]->fence);
+   lp_scene_end_rasterization(setup->scenes[oldest]);
+   return oldest;
 }
 
 
@@ -95,9 +103,11 @@ lp_setup_get_empty_scene(struct lp_setup_context *setup)
       }
    }
 
-   if (setup->num_active_scenes + 1 > MAX_SCENES) {
+   if (i < setup->num_active_scenes) {
+      /* reuse the idle scene */
+   } else if (setup->num_active_scenes + 1 > MAX_SCENES) {
       i = lp_setup_wait_empty_scene(setup);
-   } else if (i == setup->num_active_scenes) {
+   } else {
       /* allocate a new scene */
       struct lp_scene *scene = lp_scene_create(setup);
       if (!scene) {
@@ -987,12 +987,15 @@ llvmpipe_get_compute_state_info(struct pipe_context *pipe, void *cs,
 
 /**
  * Remove shader variant from two lists: the shader's variant list
- * and the context's variant list.
+ * and the owning context's variant list.
+ * Called with the screen's cs_variant_mutex held, as shaders may have
+ * variants of several contexts.
  */
 static void
-llvmpipe_remove_cs_shader_variant(struct llvmpipe_context *lp,
-                                  struct lp_compute_shader_variant *variant)
+llvmpipe_remove_cs_shader_variant(struct lp_compute_shader_variant *variant)
 {
+   struct llvmpipe_context *lp = variant->owner;
+
    if ((LP_DEBUG & DEBUG_CS) || (gallivm_debug & GALLIVM_DEBUG_IR)) {
       debug_printf("llvmpipe: del cs #%u var %u v created %u v cached %u "
                    "v total cached %u inst %u total inst %u\n",
@@ -1022,6 +1025,7 @@ llvmpipe_delete_compute_state(struct pipe_context *pipe,
                               void *cs)
 {
    struct llvmpipe_context *llvmpipe = llvmpipe_context(pipe);
+   struct llvmpipe_screen *screen = llvmpipe_screen(pipe->screen);
    struct lp_compute_shader *shader = cs;
    struct lp_cs_variant_list_item *li, *next;
 
@@ -1032,9 +1036,11 @@ llvmpipe_delete_compute_state(struct pipe_context *pipe,
    FREE(shader->global_buffers);
 
    /* Delete all the variants */
+   mtx_lock(&screen->cs_variant_mutex);
    LIST_FOR_EACH_ENTRY_SAFE(li, next, &shader->variants.list, list) {
-      llvmpipe_remove_cs_shader_variant(llvmpipe, li->base);
+      llvmpipe_remove_cs_shader_variant(li->base);
    }
+   mtx_unlock(&screen->cs_variant_mutex);
    ralloc_free(shader->base.ir.nir);
    FREE(shader);
 }
@@ -1229,6 +1235,7 @@ generate_variant(struct llvmpipe_context *lp,
             shname, shader->no, shader->variants_created);
 
    variant->shader = shader;
+   variant->owner = lp;
    memcpy(&variant->key, key, shader->variant_key_size);
 
    unsigned char ir_sha1_cache_key[20];
@@ -1300,12 +1307,19 @@ llvmpipe_update_cs_variant(struct llvmpipe_context *lp,
    char store[LP_CS_MAX_VARIANT_KEY_SIZE];
    struct lp_compute_shader_variant_key *key =
       make_variant_key(lp, shader, sh_type, store);
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
    struct lp_compute_shader_variant *variant = NULL;
    struct lp_cs_variant_list_item *li;
 
-   /* Search the variants for one which matches the key */
+   mtx_lock(&screen->cs_variant_mutex);
+
+   /* Search the variants for one which matches the key.  Each context
+    * only uses the variants it compiled itself, so that evictions and
+    * context destruction never pull code from under another context.
+    */
    LIST_FOR_EACH_ENTRY(li, &shader->variants.list, list) {
-      if (memcmp(&li->base->key, key, shader->variant_key_size) == 0) {
+      if (li->base->owner == lp &&
+          memcmp(&li->base->key, key, shader->variant_key_size) == 0) {
          variant = li->base;
          break;
       }
@@ -1360,10 +1374,12 @@ llvmpipe_update_cs_variant(struct llvmpipe_context *lp,
                                    struct lp_cs_variant_list_item, list);
             assert(item);
             assert(item->base);
-            llvmpipe_remove_cs_shader_variant(lp, item->base);
+            llvmpipe_remove_cs_shader_variant(item->base);
          }
       }
 
+      mtx_unlock(&screen->cs_variant_mutex);
+
       /*
        * Generate the new variant.
        */
@@ -1375,6 +1391,8 @@ llvmpipe_update_cs_variant(struct llvmpipe_context *lp,
       LP_COUNT_ADD(llvm_compile_time, dt);
       LP_COUNT_ADD(nr_llvm_compiles, 2);  /* emit vs. omit in/out test */
 
+      mtx_lock(&screen->cs_variant_mutex);
+
       /* Put the new variant into the list */
       if (variant) {
          list_add(&variant->list_item_local.list, &shader->variants.list);
@@ -1384,9 +1402,30 @@ llvmpipe_update_cs_variant(struct llvmpipe_context *lp,
          shader->variants_cached++;
       }
    }
+
+   mtx_unlock(&screen->cs_variant_mutex);
    return variant;
 }
 
+
+/**
+ * Free all the compute, task and mesh shader variants of a context which
+ * is being destroyed.  The shaders themselves may be deleted later through
+ * another context.
+ */
+void
+llvmpipe_destroy_cs_variants(struct llvmpipe_context *lp)
+{
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   struct lp_cs_variant_list_item *li, *next;
+
+   mtx_lock(&screen->cs_variant_mutex);
+   LIST_FOR_EACH_ENTRY_SAFE(li, next, &lp->cs_variants_list.list, list) {
+      llvmpipe_remove_cs_shader_variant(li->base);
+   }
+   mtx_unlock(&screen->cs_variant_mutex);
+}
+
 static void
 llvmpipe_update_cs(struct llvmpipe_context *lp)
 {
@@ -1895,14 +1934,16 @@ llvmpipe_bind_ts_state(struct pipe_context *pipe, void *_task)
 static void
 llvmpipe_delete_ts_state(struct pipe_context *pipe, void *_task)
 {
-   struct llvmpipe_context *llvmpipe = llvmpipe_context(pipe);
+   struct llvmpipe_screen *screen = llvmpipe_screen(pipe->screen);
    struct lp_compute_shader *shader = _task;
    struct lp_cs_variant_list_item *li, *next;
 
    /* Delete all the variants */
+   mtx_lock(&screen->cs_variant_mutex);
    LIST_FOR_EACH_ENTRY_SAFE(li, next, &shader->variants.list, list) {
-      llvmpipe_remove_cs_shader_variant(llvmpipe, li->base);
+      llvmpipe_remove_cs_shader_variant(li->base);
    }
+   mtx_unlock(&screen->cs_variant_mutex);
    ralloc_free(shader->base.ir.nir);
    FREE(shader);
 }
@@ -1976,13 +2017,16 @@ static void
 llvmpipe_delete_ms_state(struct pipe_context *pipe, void *_mesh)
 {
    struct llvmpipe_context *llvmpipe = llvmpipe_context(pipe);
+   struct llvmpipe_screen *screen = llvmpipe_screen(pipe->screen);
    struct lp_compute_shader *shader = _mesh;
    struct lp_cs_variant_list_item *li, *next;
 
    /* Delete all the variants */
+   mtx_lock(&screen->cs_variant_mutex);
    LIST_FOR_EACH_ENTRY_SAFE(li, next, &shader->variants.list, list) {
-      llvmpipe_remove_cs_shader_variant(llvmpipe, li->base);
+      llvmpipe_remove_cs_shader_variant(li->base);
    }
+   mtx_unlock(&screen->cs_variant_mutex);
 
    draw_delete_mesh_shader(llvmpipe->draw, shader->draw_mesh_data);
    ralloc_free(shader->base.ir.nir);
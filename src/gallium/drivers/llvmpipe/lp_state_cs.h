@@ -34,6 +34,7 @@
 #include "lp_jit.h"
 #include "lp_state_fs.h"
 
+struct llvmpipe_context;
 struct lp_compute_shader_variant;
 
 struct lp_compute_shader_variant_key
@@ -99,6 +100,7 @@ struct lp_compute_shader_variant
    struct lp_cs_variant_list_item list_item_global, list_item_local;
 
    struct lp_compute_shader *shader;
+   struct llvmpipe_context *owner;  /**< context which compiled it */
 
    /* For debugging/profiling purposes */
    unsigned no;
@@ -163,4 +165,6 @@ struct lp_cs_context {
 struct lp_cs_context *lp_csctx_create(struct pipe_context *pipe);
 void lp_csctx_destroy(struct lp_cs_context *csctx);
 
+void llvmpipe_destroy_cs_variants(struct llvmpipe_context *lp);
+
 #endif
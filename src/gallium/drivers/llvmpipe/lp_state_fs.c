@@ -3721,7 +3721,8 @@ lp_fs_get_ir_cache_key(struct lp_fragment_shader_variant *variant,
 static struct lp_fragment_shader_variant *
 generate_variant(struct llvmpipe_context *lp,
                  struct lp_fragment_shader *shader,
-                 const struct lp_fragment_shader_variant_key *key)
+                 const struct lp_fragment_shader_variant_key *key,
+                 LLVMContextRef context)
 {
    struct nir_shader *nir = shader->base.ir.nir;
    struct lp_fragment_shader_variant *variant =
@@ -3751,7 +3752,7 @@ generate_variant(struct llvmpipe_context *lp,
    char module_name[64];
    snprintf(module_name, sizeof(module_name), "fs%u_variant%u",
             shader->no, shader->variants_created);
-   variant->gallivm = gallivm_create(module_name, lp->context, &cached);
+   variant->gallivm = gallivm_create(module_name, context, &cached);
    if (!variant->gallivm) {
       FREE(variant);
       return NULL;
@@ -3831,6 +3832,7 @@ generate_variant(struct llvmpipe_context *lp,
       }
 
       if (target == PIPE_TEXTURE_2D &&
+          !samp0->texture_state.tiled &&
           min_img_filter == PIPE_TEX_FILTER_NEAREST &&
           mag_img_filter == PIPE_TEX_FILTER_NEAREST &&
           min_mip_filter == PIPE_TEX_MIPFILTER_NONE &&
@@ -3955,6 +3957,15 @@ generate_variant(struct llvmpipe_context *lp,
 }
 
 
+static void
+lp_fs_precompile(struct llvmpipe_context *lp,
+                 struct lp_fragment_shader *shader);
+
+static void
+lp_fs_finish_precompile(struct llvmpipe_context *lp,
+                        struct lp_fragment_shader *shader);
+
+
 static void *
 llvmpipe_create_fs_state(struct pipe_context *pipe,
                          const struct pipe_shader_state *templ)
@@ -4054,6 +4065,8 @@ llvmpipe_create_fs_state(struct pipe_context *pipe,
 
    llvmpipe_fs_analyse_nir(shader);
 
+   lp_fs_precompile(llvmpipe, shader);
+
    return shader;
 }
 
@@ -4110,6 +4123,8 @@ llvmpipe_destroy_shader_variant(struct llvmpipe_context *lp,
                                 struct lp_fragment_shader_variant *variant)
 {
    gallivm_destroy(variant->gallivm);
+   if (variant->context)
+      LLVMContextDispose(variant->context);
    lp_fs_reference(lp, &variant->shader, NULL);
    FREE(variant);
 }
@@ -4135,6 +4150,8 @@ llvmpipe_delete_fs_state(struct pipe_context *pipe, void *fs)
    struct lp_fragment_shader *shader = fs;
    struct lp_fs_variant_list_item *li, *next;
 
+   lp_fs_finish_precompile(llvmpipe, shader);
+
    /* Delete all the variants */
    LIST_FOR_EACH_ENTRY_SAFE(li, next, &shader->variants.list, list) {
       struct lp_fragment_shader_variant *variant;
@@ -4615,6 +4632,112 @@ make_variant_key(struct llvmpipe_context *lp,
 }
 
 
+static void
+lp_fs_add_variant(struct llvmpipe_context *lp,
+                  struct lp_fragment_shader *shader,
+                  struct lp_fragment_shader_variant *variant)
+{
+   list_add(&variant->list_item_local.list, &shader->variants.list);
+   list_add(&variant->list_item_global.list, &lp->fs_variants_list.list);
+   lp->nr_fs_variants++;
+   lp->nr_fs_instrs += variant->nr_instrs;
+   shader->variants_cached++;
+}
+
+
+/**
+ * A fragment shader variant compiled on the context's compile queue.
+ */
+struct lp_fs_precompile {
+   struct llvmpipe_context *lp;
+   struct lp_fragment_shader *shader;
+   struct lp_fragment_shader_variant *variant;
+   struct util_queue_fence fence;
+   char key[LP_FS_MAX_VARIANT_KEY_SIZE];
+};
+
+
+static void
+lp_fs_precompile_execute(void *data, void *gdata, int thread_index)
+{
+   struct lp_fs_precompile *job = data;
+
+   /* LLVMContexts aren't thread safe, so the variant gets its own. */
+   LLVMContextRef context = LLVMContextCreate();
+   if (!context)
+      return;
+
+#if LLVM_VERSION_MAJOR == 15
+   LLVMContextSetOpaquePointers(context, false);
+#endif
+
+   job->variant = generate_variant(job->lp, job->shader,
+                                   (const struct lp_fragment_shader_variant_key *)job->key,
+                                   context);
+   if (job->variant)
+      job->variant->context = context;
+   else
+      LLVMContextDispose(context);
+}
+
+
+/**
+ * Start compiling the variant a freshly created shader would get with the
+ * currently bound state, so that with luck its first draw finds it ready.
+ *
+ * Until the job is finished the compile thread owns the shader's variant
+ * list and NIR (variant generation lowers it in place), so anything
+ * touching those must go through lp_fs_finish_precompile() first.
+ */
+static void
+lp_fs_precompile(struct llvmpipe_context *lp,
+                 struct lp_fragment_shader *shader)
+{
+   if (!lp->has_fs_compile_queue ||
+       !lp->rasterizer || !lp->depth_stencil || !lp->blend)
+      return;
+
+   struct lp_fs_precompile *job = CALLOC_STRUCT(lp_fs_precompile);
+   if (!job)
+      return;
+
+   job->lp = lp;
+   job->shader = shader;
+   make_variant_key(lp, shader, job->key);
+
+   util_queue_fence_init(&job->fence);
+   shader->precompile = job;
+   util_queue_add_job(&lp->fs_compile_queue, job, &job->fence,
+                      lp_fs_precompile_execute, NULL, 0);
+}
+
+
+/**
+ * Wait for the shader's background compile, if any, and take the variant
+ * it produced.  Whether it matches the state of the next draw or not, it
+ * stays in the variant list like any other.
+ */
+static void
+lp_fs_finish_precompile(struct llvmpipe_context *lp,
+                        struct lp_fragment_shader *shader)
+{
+   struct lp_fs_precompile *job = shader->precompile;
+   if (!job)
+      return;
+
+   util_queue_fence_wait(&job->fence);
+   util_queue_fence_destroy(&job->fence);
+   shader->precompile = NULL;
+
+   if (job->variant) {
+      LP_COUNT_ADD(nr_llvm_compiles, 2);
+      lp_fs_add_variant(lp, shader, job->variant);
+   }
+
+   FREE(job);
+}
+
+
 /**
  * Update fragment shader state.  This is called just prior to drawing
  * something when some fragment-related state has changed.
@@ -4624,6 +4747,8 @@ llvmpipe_update_fs(struct llvmpipe_context *lp)
 {
    struct lp_fragment_shader *shader = lp->fs;
 
+   lp_fs_finish_precompile(lp, shader);
+
    char store[LP_FS_MAX_VARIANT_KEY_SIZE];
    const struct lp_fragment_shader_variant_key *key =
       make_variant_key(lp, shader, store);
@@ -4698,20 +4823,15 @@ llvmpipe_update_fs(struct llvmpipe_context *lp)
        * Generate the new variant.
        */
       int64_t t0 = os_time_get();
-      variant = generate_variant(lp, shader, key);
+      variant = generate_variant(lp, shader, key, lp->context);
       int64_t t1 = os_time_get();
       int64_t dt = t1 - t0;
       LP_COUNT_ADD(llvm_compile_time, dt);
       LP_COUNT_ADD(nr_llvm_compiles, 2);  /* emit vs. omit in/out test */
 
       /* Put the new variant into the list */
-      if (variant) {
-         list_add(&variant->list_item_local.list, &shader->variants.list);
-         list_add(&variant->list_item_global.list, &lp->fs_variants_list.list);
-         lp->nr_fs_variants++;
-         lp->nr_fs_instrs += variant->nr_instrs;
-         shader->variants_cached++;
-      }
+      if (variant)
+         lp_fs_add_variant(lp, shader, variant);
    }
 
    /* Bind this variant */
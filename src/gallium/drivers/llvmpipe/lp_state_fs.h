@@ -38,6 +38,7 @@
 #include "gallivm/lp_bld_tgsi.h" /* for lp_tgsi_info */
 #include "lp_bld_interp.h" /* for struct lp_shader_input */
 #include "util/u_inlines.h"
+#include "util/u_queue.h"
 #include "lp_jit.h"
 
 struct lp_fragment_shader;
@@ -155,6 +156,11 @@ struct lp_fragment_shader_variant
 
    struct gallivm_state *gallivm;
 
+   /* LLVMContext owned by variants compiled off the rendering thread,
+    * NULL if compiled in the llvmpipe context's one.
+    */
+   LLVMContextRef context;
+
    LLVMTypeRef jit_context_type;
    LLVMTypeRef jit_context_ptr_type;
    LLVMTypeRef jit_thread_data_type;
@@ -211,6 +217,9 @@ struct lp_fragment_shader
 
    struct draw_fragment_shader *draw_data;
 
+   /* Variant being compiled in the background, see lp_fs_precompile() */
+   struct lp_fs_precompile *precompile;
+
    /* For debugging/profiling purposes */
    unsigned variant_key_size;
    unsigned no;
@@ -29,6 +29,7 @@
 #include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/os_time.h"
+#include "util/mesa-sha1.h"
 #include "gallivm/lp_bld_arit.h"
 #include "gallivm/lp_bld_bitarit.h"
 #include "gallivm/lp_bld_const.h"
@@ -628,6 +629,21 @@ init_args(struct gallivm_state *gallivm,
 }
 
 
+static void
+lp_setup_get_cache_key(const struct lp_setup_variant_key *key,
+                       unsigned char sha1_cache_key[20])
+{
+   static const char tag[] = "llvmpipe setup";
+   struct mesa_sha1 ctx;
+
+   /* The generated code only depends on the key. */
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, tag, sizeof(tag));
+   _mesa_sha1_update(&ctx, key, key->size);
+   _mesa_sha1_final(&ctx, sha1_cache_key);
+}
+
+
 /**
  * Generate the runtime callable function for the coefficient calculation.
  *
@@ -647,12 +663,25 @@ generate_setup_variant(struct lp_setup_variant_key *key,
 
    variant->no = setup_no++;
 
-   char func_name[64];
-   snprintf(func_name, sizeof(func_name), "setup_variant_%u",
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char sha1_cache_key[20];
+   lp_setup_get_cache_key(key, sha1_cache_key);
+   lp_disk_cache_find_shader(screen, &cached, sha1_cache_key);
+   bool needs_caching = !cached.data_size;
+
+   char module_name[64];
+   snprintf(module_name, sizeof(module_name), "setup_variant_%u",
             variant->no);
 
+   /* The function name must not depend on the variant number, or a cached
+    * object from a previous run wouldn't resolve.
+    */
+   const char *func_name = "setup_variant";
+
    struct gallivm_state *gallivm;
-   variant->gallivm = gallivm = gallivm_create(func_name, lp->context, NULL);
+   variant->gallivm = gallivm = gallivm_create(module_name, lp->context,
+                                               &cached);
    if (!variant->gallivm) {
       goto fail;
    }
@@ -736,6 +765,9 @@ generate_setup_variant(struct lp_setup_variant_key *key,
    if (!variant->jit_function)
       goto fail;
 
+   if (needs_caching)
+      lp_disk_cache_insert_shader(screen, &cached, sha1_cache_key);
+
    gallivm_free_ir(variant->gallivm);
 
    /*
@@ -79,6 +79,37 @@ static const char *driver_id = "llvmpipe" MESA_GIT_SHA1;
 
 #endif
 
+/**
+ * Decide whether a texture gets the LP_RESOURCE_FLAG_TILED layout.
+ *
+ * Only textures which are never rendered to, shared or bound to images
+ * qualify, as everything except the texture sampling code and transfers
+ * assumes linear rows.
+ */
+static bool
+llvmpipe_resource_want_tiled(const struct llvmpipe_screen *screen,
+                             const struct pipe_resource *templat)
+{
+   if (!screen->tiled_textures)
+      return false;
+
+   if (templat->bind != PIPE_BIND_SAMPLER_VIEW ||
+       llvmpipe_resource_is_1d(templat) ||
+       templat->nr_samples > 1 ||
+       (templat->flags & (PIPE_RESOURCE_FLAG_SPARSE |
+                          PIPE_RESOURCE_FLAG_MAP_PERSISTENT |
+                          PIPE_RESOURCE_FLAG_MAP_COHERENT)))
+      return false;
+
+   const struct util_format_description *desc =
+      util_format_description(templat->format);
+   return desc->layout != UTIL_FORMAT_LAYOUT_SUBSAMPLED &&
+          desc->layout != UTIL_FORMAT_LAYOUT_PLANAR2 &&
+          desc->layout != UTIL_FORMAT_LAYOUT_PLANAR3 &&
+          util_format_get_blocksize(templat->format) <= 16;
+}
+
+
 /**
  * Conventional allocation path for non-display textures:
  * Compute strides and allocate data (unless asked not to).
@@ -147,6 +178,12 @@ llvmpipe_texture_layout(struct llvmpipe_screen *screen,
                                           align(height, align_y));
       block_size = util_format_get_blocksize(pt->format);
 
+      /* Tiled textures are made of whole 4x4 block tiles. */
+      if (llvmpipe_resource_is_tiled(pt)) {
+         nblocksx = align(nblocksx, 4);
+         nblocksy = align(nblocksy, 4);
+      }
+
       if (util_format_is_compressed(pt->format))
          lpr->row_stride[level] = nblocksx * block_size;
       else
@@ -215,6 +252,9 @@ llvmpipe_can_create_resource(struct pipe_screen *screen,
    struct llvmpipe_resource lpr;
    memset(&lpr, 0, sizeof(lpr));
    lpr.base = *res;
+   lpr.base.flags &= ~LP_RESOURCE_FLAG_TILED;
+   if (llvmpipe_resource_want_tiled(llvmpipe_screen(screen), res))
+      lpr.base.flags |= LP_RESOURCE_FLAG_TILED;
    if (!llvmpipe_texture_layout(llvmpipe_screen(screen), &lpr, false))
       return false;
 
@@ -259,6 +299,7 @@ llvmpipe_resource_create_all(struct pipe_screen *_screen,
       return NULL;
 
    lpr->base = *templat;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
    lpr->screen = screen;
    pipe_reference_init(&lpr->base.reference, 1);
    lpr->base.screen = &screen->base;
@@ -278,6 +319,8 @@ llvmpipe_resource_create_all(struct pipe_screen *_screen,
             goto fail;
       } else {
          /* texture map */
+         if (alloc_backing && llvmpipe_resource_want_tiled(screen, templat))
+            lpr->base.flags |= LP_RESOURCE_FLAG_TILED;
          if (!llvmpipe_texture_layout(screen, lpr, alloc_backing))
             goto fail;
       }
@@ -427,6 +470,7 @@ llvmpipe_resource_from_memobj(struct pipe_screen *pscreen,
    struct llvmpipe_memory_object *lpmo = llvmpipe_memory_object(memobj);
    struct llvmpipe_resource *lpr = CALLOC_STRUCT(llvmpipe_resource);
    lpr->base = *templat;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
 
    lpr->screen = screen;
    pipe_reference_init(&lpr->base.reference, 1);
@@ -637,6 +681,7 @@ llvmpipe_resource_from_handle(struct pipe_screen *_screen,
    }
 
    lpr->base = *template;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
    lpr->screen = screen;
    lpr->dt_format = whandle->format;
    pipe_reference_init(&lpr->base.reference, 1);
@@ -787,6 +832,7 @@ llvmpipe_resource_from_user_memory(struct pipe_screen *_screen,
    }
 
    lpr->base = *resource;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
    lpr->screen = screen;
    pipe_reference_init(&lpr->base.reference, 1);
    lpr->base.screen = _screen;
@@ -811,6 +857,49 @@ fail:
 }
 
 
+/**
+ * Copy the box of a transfer between a LP_RESOURCE_FLAG_TILED texture
+ * mapping and the linear staging copy of the transfer.
+ * Within a tile row up to 4 blocks are contiguous, so copy those at once.
+ */
+static void
+llvmpipe_transfer_copy_tiled(struct llvmpipe_transfer *lpt, bool to_staging)
+{
+   const struct pipe_transfer *pt = &lpt->base;
+   const struct llvmpipe_resource *lpr = llvmpipe_resource(pt->resource);
+   const enum pipe_format format = pt->resource->format;
+   const unsigned block_size = util_format_get_blocksize(format);
+   const unsigned row_stride = lpr->row_stride[pt->level];
+   const uint64_t img_stride = lpr->img_stride[pt->level];
+   const unsigned x0 = pt->box.x / util_format_get_blockwidth(format);
+   const unsigned y0 = pt->box.y / util_format_get_blockheight(format);
+   const unsigned nblocksx = util_format_get_nblocksx(format, pt->box.width);
+   const unsigned nblocksy = util_format_get_nblocksy(format, pt->box.height);
+
+   for (unsigned z = 0; z < pt->box.depth; z++) {
+      uint8_t *tex = lpt->tex_map + z * img_stride;
+      uint8_t *lin = lpt->staging + z * pt->layer_stride;
+
+      for (unsigned y = 0; y < nblocksy; y++) {
+         unsigned x = 0;
+         while (x < nblocksx) {
+            const unsigned xb = x0 + x;
+            const unsigned run = MIN2(4 - (xb & 3), nblocksx - x);
+            uint8_t *t = tex + llvmpipe_tiled_offset(row_stride, block_size,
+                                                     xb, y0 + y);
+            uint8_t *l = lin + y * pt->stride + x * block_size;
+
+            if (to_staging)
+               memcpy(l, t, run * block_size);
+            else
+               memcpy(t, l, run * block_size);
+            x += run;
+         }
+      }
+   }
+}
+
+
 void *
 llvmpipe_transfer_map_ms(struct pipe_context *pipe,
                          struct pipe_resource *resource,
@@ -915,6 +1004,31 @@ llvmpipe_transfer_map_ms(struct pipe_context *pipe,
       screen->timestamp++;
    }
 
+   /* Tiled textures are mapped through a linear copy of the box. */
+   if (llvmpipe_resource_is_tiled(resource)) {
+      assert(sample == 0);
+
+      pt->stride = util_format_get_nblocksx(format, box->width) *
+                   util_format_get_blocksize(format);
+      pt->layer_stride = (uint64_t)pt->stride *
+                         util_format_get_nblocksy(format, box->height);
+
+      lpt->tex_map = map;
+      lpt->staging = MALLOC(pt->layer_stride * box->depth);
+      if (!lpt->staging) {
+         pipe_resource_reference(&pt->resource, NULL);
+         FREE(lpt);
+         *transfer = NULL;
+         return NULL;
+      }
+
+      if (!(usage & (PIPE_MAP_DISCARD_RANGE |
+                     PIPE_MAP_DISCARD_WHOLE_RESOURCE)))
+         llvmpipe_transfer_copy_tiled(lpt, true);
+
+      return lpt->staging;
+   }
+
    map +=
       box->y / util_format_get_blockheight(format) * pt->stride +
       box->x / util_format_get_blockwidth(format) * util_format_get_blocksize(format);
@@ -941,8 +1055,16 @@ static void
 llvmpipe_transfer_unmap(struct pipe_context *pipe,
                         struct pipe_transfer *transfer)
 {
+   struct llvmpipe_transfer *lpt = llvmpipe_transfer(transfer);
+
    assert(transfer->resource);
 
+   if (lpt->staging) {
+      if (transfer->usage & PIPE_MAP_WRITE)
+         llvmpipe_transfer_copy_tiled(lpt, false);
+      FREE(lpt->staging);
+   }
+
    llvmpipe_resource_unmap(transfer->resource,
                            transfer->level,
                            transfer->box.z);
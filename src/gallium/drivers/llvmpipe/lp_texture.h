@@ -31,6 +31,7 @@
 
 #include "pipe/p_state.h"
 #include "util/u_debug.h"
+#include "gallivm/lp_bld_sample.h"
 #include "lp_limits.h"
 #if MESA_DEBUG
 #include "util/list.h"
@@ -130,6 +131,10 @@ struct llvmpipe_resource
 struct llvmpipe_transfer
 {
    struct pipe_transfer base;
+
+   /** Linear copy of the box for LP_RESOURCE_FLAG_TILED textures */
+   uint8_t *staging;
+   uint8_t *tex_map;
 };
 
 
@@ -218,6 +223,26 @@ llvmpipe_resource_is_1d(const struct pipe_resource *resource)
 }
 
 
+static inline bool
+llvmpipe_resource_is_tiled(const struct pipe_resource *resource)
+{
+   return !!(resource->flags & LP_RESOURCE_FLAG_TILED);
+}
+
+
+/**
+ * Byte offset of pixel block (xb, yb) inside an image of a
+ * LP_RESOURCE_FLAG_TILED texture.  Must match lp_build_sample_offset().
+ */
+static inline uint64_t
+llvmpipe_tiled_offset(unsigned row_stride, unsigned block_size,
+                      unsigned xb, unsigned yb)
+{
+   return (uint64_t)(yb & ~3u) * row_stride +
+          ((yb & 3) * 4 + (xb & ~3u) * 4 + (xb & 3)) * block_size;
+}
+
+
 static inline unsigned
 llvmpipe_layer_stride(struct pipe_resource *resource,
                       unsigned level)
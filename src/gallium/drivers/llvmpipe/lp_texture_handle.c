@@ -55,6 +55,8 @@ llvmpipe_create_texture_handle(struct pipe_context *pctx, struct pipe_sampler_vi
 
    struct lp_texture_handle *handle = calloc(1, sizeof(struct lp_texture_handle));
 
+   simple_mtx_lock(&matrix->lock);
+
    if (view) {
       struct lp_static_texture_state state;
       lp_sampler_static_texture_state(&state, view);
@@ -94,6 +96,8 @@ llvmpipe_create_texture_handle(struct pipe_context *pctx, struct pipe_sampler_vi
       assert(found);
    }
 
+   simple_mtx_unlock(&matrix->lock);
+
    return (uint64_t)(uintptr_t)handle;
 }
 
@@ -128,6 +132,8 @@ llvmpipe_create_image_handle(struct pipe_context *pctx, const struct pipe_image_
          state.target = PIPE_TEXTURE_CUBE;
    }
 
+   simple_mtx_lock(&matrix->lock);
+
    llvmpipe_register_texture(ctx, &state, false);
 
    bool found = false;
@@ -140,6 +146,8 @@ llvmpipe_create_image_handle(struct pipe_context *pctx, const struct pipe_image_
    }
    assert(found);
 
+   simple_mtx_unlock(&matrix->lock);
+
    return (uint64_t)(uintptr_t)handle;
 }
 
@@ -167,6 +175,19 @@ llvmpipe_init_sampler_matrix(struct llvmpipe_context *ctx)
    ctx->sampler_matrix.compile_function = get_sample_function;
    ctx->sampler_matrix.cache = _mesa_pointer_hash_table_create(NULL);
    simple_mtx_init(&ctx->sampler_matrix.lock, mtx_plain);
+
+   /* Sample functions get compiled on demand from whatever thread runs the
+    * shader, and handles may be used by other contexts of the screen, so
+    * the matrix doesn't share the context's LLVMContext.
+    */
+#ifdef USE_GLOBAL_LLVM_CONTEXT
+   ctx->sampler_matrix.context = LLVMGetGlobalContext();
+#else
+   ctx->sampler_matrix.context = LLVMContextCreate();
+#endif
+#if LLVM_VERSION_MAJOR == 15
+   LLVMContextSetOpaquePointers(ctx->sampler_matrix.context, false);
+#endif
 }
 
 void
@@ -200,6 +221,11 @@ llvmpipe_sampler_matrix_destroy(struct llvmpipe_context *ctx)
       gallivm_destroy(*gallivm);
 
    util_dynarray_fini(&ctx->sampler_matrix.gallivms);
+
+#ifndef USE_GLOBAL_LLVM_CONTEXT
+   LLVMContextDispose(matrix->context);
+#endif
+   matrix->context = NULL;
 }
 
 static void *
@@ -261,7 +287,7 @@ compile_image_function(struct llvmpipe_context *ctx, struct lp_static_texture_st
    lp_disk_cache_find_shader(llvmpipe_screen(ctx->pipe.screen), &cached, cache_key);
    bool needs_caching = !cached.data_size;
 
-   struct gallivm_state *gallivm = gallivm_create("sample_function", ctx->context, &cached);
+   struct gallivm_state *gallivm = gallivm_create("sample_function", ctx->sampler_matrix.context, &cached);
 
    struct lp_image_static_state state = {
       .image_state = *texture,
@@ -414,7 +440,7 @@ compile_sample_function(struct llvmpipe_context *ctx, struct lp_static_texture_s
    lp_disk_cache_find_shader(llvmpipe_screen(ctx->pipe.screen), &cached, cache_key);
    bool needs_caching = !cached.data_size;
 
-   struct gallivm_state *gallivm = gallivm_create("sample_function", ctx->context, &cached);
+   struct gallivm_state *gallivm = gallivm_create("sample_function", ctx->sampler_matrix.context, &cached);
 
    struct lp_sampler_static_state state = {
       .texture_state = *texture,
@@ -543,7 +569,7 @@ compile_jit_sample_function(struct llvmpipe_context *ctx, uint32_t sample_key)
    lp_disk_cache_find_shader(llvmpipe_screen(ctx->pipe.screen), &cached, cache_key);
    bool needs_caching = !cached.data_size;
 
-   struct gallivm_state *gallivm = gallivm_create("jit_sample_function", ctx->context, &cached);
+   struct gallivm_state *gallivm = gallivm_create("jit_sample_function", ctx->sampler_matrix.context, &cached);
 
    struct lp_type type;
    memset(&type, 0, sizeof type);
@@ -650,7 +676,7 @@ compile_size_function(struct llvmpipe_context *ctx, struct lp_static_texture_sta
    lp_disk_cache_find_shader(llvmpipe_screen(ctx->pipe.screen), &cached, cache_key);
    bool needs_caching = !cached.data_size;
 
-   struct gallivm_state *gallivm = gallivm_create("sample_function", ctx->context, &cached);
+   struct gallivm_state *gallivm = gallivm_create("sample_function", ctx->sampler_matrix.context, &cached);
 
    struct lp_sampler_static_state state = {
       .texture_state = *texture,
@@ -958,8 +984,13 @@ register_instr(nir_builder *b, nir_instr *instr, void *data)
 void
 llvmpipe_register_shader(struct pipe_context *ctx, const struct pipe_shader_state *shader)
 {
-   if (shader->type == PIPE_SHADER_IR_NIR)
+   struct lp_sampler_matrix *matrix = &llvmpipe_context(ctx)->sampler_matrix;
+
+   if (shader->type == PIPE_SHADER_IR_NIR) {
+      simple_mtx_lock(&matrix->lock);
       nir_shader_instructions_pass(shader->ir.nir, register_instr, nir_metadata_all, ctx);
+      simple_mtx_unlock(&matrix->lock);
+   }
 }
 
 void
@@ -982,7 +1013,10 @@ llvmpipe_clear_sample_functions_cache(struct llvmpipe_context *ctx, struct pipe_
 
    /* All work is finished, it's safe to move cache entries into the table.
     * The key is the intended address of the sample function.
+    * Shaders of other contexts may still add entries though.
     */
+   simple_mtx_lock(&matrix->lock);
    hash_table_foreach_remove(matrix->cache, entry)
       *(void **)entry->key = entry->data;
+   simple_mtx_unlock(&matrix->lock);
 }
@@ -50,6 +50,7 @@ struct lp_sampler_matrix {
    simple_mtx_t lock;
 
    struct llvmpipe_context *ctx;
+   LLVMContextRef context;   /**< for all sample/image function compiles */
 
    struct util_dynarray gallivms;
 };
@@ -1094,6 +1094,39 @@ panfrost_can_discard(struct pipe_resource *resource, const struct pipe_box *box,
            !(rsrc->bo->flags & PAN_BO_SHARED));
 }
 
+/* Every CPU access to an AFBC resource costs a staging resource and a GPU
+ * blit in each direction, plus a flush and a wait for reads. That is fine
+ * for the odd upload, but resources the CPU keeps poking at (ie. partially
+ * updated overlays, which panfrost_should_linear_convert() doesn't catch)
+ * are better off uncompressed, where maps are a plain CPU (de)tiling copy.
+ */
+static bool
+panfrost_should_afbc_decompress(struct panfrost_device *dev,
+                                struct panfrost_resource *prsrc,
+                                struct pipe_transfer *transfer)
+{
+   if (prsrc->modifier_constant)
+      return false;
+
+   /* Whole overwrites are dealt with by panfrost_should_linear_convert() on
+    * unmap, which avoids the staging blit altogether.
+    */
+   bool entire_overwrite = !(transfer->usage & PIPE_MAP_READ) &&
+                           panfrost_is_2d(prsrc) &&
+                           prsrc->base.last_level == 0 &&
+                           transfer->box.width == prsrc->base.width0 &&
+                           transfer->box.height == prsrc->base.height0 &&
+                           transfer->box.x == 0 && transfer->box.y == 0;
+   if (entire_overwrite)
+      return false;
+
+   if (++prsrc->afbc_staging_maps < LAYOUT_CONVERT_THRESHOLD)
+      return false;
+
+   perf_debug(dev, "Transitioning from AFBC due to frequent CPU access");
+   return true;
+}
+
 static void *
 panfrost_ptr_map(struct pipe_context *pctx, struct pipe_resource *resource,
                  unsigned level,
@@ -1124,6 +1157,15 @@ panfrost_ptr_map(struct pipe_context *pctx, struct pipe_resource *resource,
    if (usage & PIPE_MAP_WRITE)
       rsrc->constant_stencil = false;
 
+   if (drm_is_afbc(rsrc->image.layout.modifier) &&
+       panfrost_should_afbc_decompress(dev, rsrc, &transfer->base)) {
+      pan_resource_modifier_convert(
+         ctx, rsrc, DRM_FORMAT_MOD_ARM_16X16_BLOCK_U_INTERLEAVED,
+         !(usage & PIPE_MAP_DISCARD_WHOLE_RESOURCE),
+         "Decompressing AFBC due to frequent CPU access");
+      bo = rsrc->bo;
+   }
+
    /* We don't have s/w routines for AFBC, so use a staging texture */
    if (drm_is_afbc(rsrc->image.layout.modifier)) {
       struct panfrost_resource *staging =
@@ -74,6 +74,7 @@ struct panfrost_resource {
 
    /* Used to decide when to convert to another modifier */
    uint16_t modifier_updates;
+   uint16_t afbc_staging_maps;
 
    /* Do all pixels have the same stencil value? */
    bool constant_stencil;
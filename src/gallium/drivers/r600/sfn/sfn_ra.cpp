@@ -9,6 +9,7 @@
 #include "sfn_alu_defines.h"
 #include "sfn_debug.h"
 
+#include <algorithm>
 #include <cassert>
 #include <queue>
 
@@ -43,17 +44,78 @@ Interference::initialize()
    }
 }
 
+static inline bool
+ranges_interfere(const LiveRangeEntry& a, const LiveRangeEntry& b)
+{
+   return a.m_end >= b.m_start && a.m_start <= b.m_end;
+}
+
+static inline void
+add_interference(ComponentInterference& comp_interference, size_t a, size_t b)
+{
+   if (a > b)
+      comp_interference.add(a, b);
+   else
+      comp_interference.add(b, a);
+}
+
 void
 Interference::initialize(ComponentInterference& comp_interference,
                          LiveRangeMap::ChannelLiveRange& clr)
 {
-   for (size_t row = 0; row < clr.size(); ++row) {
-      auto& row_entry = clr[row];
-      comp_interference.prepare_row(row);
-      for (size_t col = 0; col < row; ++col) {
-         auto& col_entry = clr[col];
-         if (row_entry.m_end >= col_entry.m_start && row_entry.m_start <= col_entry.m_end)
-            comp_interference.add(row, col);
+   if (clr.empty())
+      return;
+
+   comp_interference.prepare_row(clr.size() - 1);
+
+   /* Sweep over the live ranges ordered by their start and only compare
+    * each range with the ranges that are still live at that point, instead
+    * of comparing all pairs. Large shaders have thousands of registers per
+    * channel, but only a few of them are live at the same time. */
+   std::vector<int> by_start;
+   std::vector<int> odd;
+   by_start.reserve(clr.size());
+   for (size_t i = 0; i < clr.size(); ++i) {
+      if (clr[i].m_start <= clr[i].m_end)
+         by_start.push_back(i);
+      else
+         odd.push_back(i);
+   }
+
+   std::stable_sort(by_start.begin(), by_start.end(), [&clr](int lhs, int rhs) {
+      return clr[lhs].m_start < clr[rhs].m_start;
+   });
+
+   std::vector<int> active;
+   for (auto idx : by_start) {
+      auto& entry = clr[idx];
+
+      /* Ranges that ended before this one starts can't interfere with it
+       * or any of the following ones. */
+      size_t live = 0;
+      for (auto a : active) {
+         if (clr[a].m_end >= entry.m_start)
+            active[live++] = a;
+      }
+      active.resize(live);
+
+      for (auto a : active)
+         add_interference(comp_interference, idx, a);
+
+      active.push_back(idx);
+   }
+
+   /* Ranges with the end before the start don't fit the sweep, compare
+    * these with all others like before. */
+   for (size_t i = 0; i < odd.size(); ++i) {
+      auto& entry = clr[odd[i]];
+      for (auto idx : by_start) {
+         if (ranges_interfere(entry, clr[idx]))
+            add_interference(comp_interference, odd[i], idx);
+      }
+      for (size_t j = 0; j < i; ++j) {
+         if (ranges_interfere(entry, clr[odd[j]]))
+            add_interference(comp_interference, odd[i], odd[j]);
       }
    }
 }
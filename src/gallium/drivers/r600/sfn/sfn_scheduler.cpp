@@ -24,6 +24,10 @@
 
 namespace r600 {
 
+/* The ready lists see a lot of insertions and removals, use the
+ * shader memory pool like the instruction lists do. */
+template <typename T> using SchedList = std::list<T *, Allocator<T *>>;
+
 class CollectInstructions : public InstrVisitor {
 
 public:
@@ -101,17 +105,17 @@ public:
 
    void visit(RatInstr *instr) override { rat_instr.push_back(instr); }
 
-   std::list<AluInstr *> alu_trans;
-   std::list<AluInstr *> alu_vec;
-   std::list<TexInstr *> tex;
-   std::list<AluGroup *> alu_groups;
-   std::list<ExportInstr *> exports;
-   std::list<FetchInstr *> fetches;
-   std::list<WriteOutInstr *> mem_write_instr;
-   std::list<MemRingOutInstr *> mem_ring_writes;
-   std::list<GDSInstr *> gds_op;
-   std::list<WriteTFInstr *> write_tf;
-   std::list<RatInstr *> rat_instr;
+   SchedList<AluInstr> alu_trans;
+   SchedList<AluInstr> alu_vec;
+   SchedList<TexInstr> tex;
+   SchedList<AluGroup> alu_groups;
+   SchedList<ExportInstr> exports;
+   SchedList<FetchInstr> fetches;
+   SchedList<WriteOutInstr> mem_write_instr;
+   SchedList<MemRingOutInstr> mem_ring_writes;
+   SchedList<GDSInstr> gds_op;
+   SchedList<WriteTFInstr> write_tf;
+   SchedList<RatInstr> rat_instr;
 
    Instr *m_cf_instr{nullptr};
    ValueFactory& m_value_factory;
@@ -145,50 +149,50 @@ private:
    bool collect_ready(CollectInstructions& available);
 
    template <typename T>
-   bool collect_ready_type(std::list<T *>& ready, std::list<T *>& orig);
+   bool collect_ready_type(SchedList<T>& ready, SchedList<T>& orig);
 
-   bool collect_ready_alu_vec(std::list<AluInstr *>& ready,
-                              std::list<AluInstr *>& available);
+   bool collect_ready_alu_vec(SchedList<AluInstr>& ready,
+                              SchedList<AluInstr>& available);
 
    bool schedule_tex(Shader::ShaderBlocks& out_blocks);
    bool schedule_vtx(Shader::ShaderBlocks& out_blocks);
 
    template <typename I>
-   bool schedule_gds(Shader::ShaderBlocks& out_blocks, std::list<I *>& ready_list);
+   bool schedule_gds(Shader::ShaderBlocks& out_blocks, SchedList<I>& ready_list);
 
    template <typename I>
-   bool schedule_cf(Shader::ShaderBlocks& out_blocks, std::list<I *>& ready_list);
+   bool schedule_cf(Shader::ShaderBlocks& out_blocks, SchedList<I>& ready_list);
 
    bool schedule_alu(Shader::ShaderBlocks& out_blocks);
    void start_new_block(Shader::ShaderBlocks& out_blocks, Block::Type type);
 
    bool schedule_alu_to_group_vec(AluGroup *group);
-   bool schedule_alu_to_group_trans(AluGroup *group, std::list<AluInstr *>& readylist);
+   bool schedule_alu_to_group_trans(AluGroup *group, SchedList<AluInstr>& readylist);
 
    bool schedule_exports(Shader::ShaderBlocks& out_blocks,
-                         std::list<ExportInstr *>& ready_list);
+                         SchedList<ExportInstr>& ready_list);
 
    void maybe_split_alu_block(Shader::ShaderBlocks& out_blocks);
 
-   template <typename I> bool schedule(std::list<I *>& ready_list);
+   template <typename I> bool schedule(SchedList<I>& ready_list);
 
-   template <typename I> bool schedule_block(std::list<I *>& ready_list);
+   template <typename I> bool schedule_block(SchedList<I>& ready_list);
 
    void update_array_writes(const AluGroup& group);
    bool check_array_reads(const AluInstr& instr);
    bool check_array_reads(const AluGroup& group);
 
-   std::list<AluInstr *> alu_vec_ready;
-   std::list<AluInstr *> alu_trans_ready;
-   std::list<AluGroup *> alu_groups_ready;
-   std::list<TexInstr *> tex_ready;
-   std::list<ExportInstr *> exports_ready;
-   std::list<FetchInstr *> fetches_ready;
-   std::list<WriteOutInstr *> memops_ready;
-   std::list<MemRingOutInstr *> mem_ring_writes_ready;
-   std::list<GDSInstr *> gds_ready;
-   std::list<WriteTFInstr *> write_tf_ready;
-   std::list<RatInstr *> rat_instr_ready;
+   SchedList<AluInstr> alu_vec_ready;
+   SchedList<AluInstr> alu_trans_ready;
+   SchedList<AluGroup> alu_groups_ready;
+   SchedList<TexInstr> tex_ready;
+   SchedList<ExportInstr> exports_ready;
+   SchedList<FetchInstr> fetches_ready;
+   SchedList<WriteOutInstr> memops_ready;
+   SchedList<MemRingOutInstr> mem_ring_writes_ready;
+   SchedList<GDSInstr> gds_ready;
+   SchedList<WriteTFInstr> write_tf_ready;
+   SchedList<RatInstr> rat_instr_ready;
 
    enum {
       sched_alu,
@@ -733,7 +737,7 @@ BlockScheduler::schedule_vtx(Shader::ShaderBlocks& out_blocks)
 
 template <typename I>
 bool
-BlockScheduler::schedule_gds(Shader::ShaderBlocks& out_blocks, std::list<I *>& ready_list)
+BlockScheduler::schedule_gds(Shader::ShaderBlocks& out_blocks, SchedList<I>& ready_list)
 {
    bool was_full = m_current_block->remaining_slots() == 0;
    if (m_current_block->type() != Block::gds || was_full) {
@@ -827,7 +831,7 @@ void BlockScheduler::maybe_split_alu_block(Shader::ShaderBlocks& out_blocks)
 
 template <typename I>
 bool
-BlockScheduler::schedule_cf(Shader::ShaderBlocks& out_blocks, std::list<I *>& ready_list)
+BlockScheduler::schedule_cf(Shader::ShaderBlocks& out_blocks, SchedList<I>& ready_list)
 {
    if (ready_list.empty())
       return false;
@@ -914,7 +918,7 @@ BlockScheduler::schedule_alu_to_group_vec(AluGroup *group)
 
 bool
 BlockScheduler::schedule_alu_to_group_trans(AluGroup *group,
-                                           std::list<AluInstr *>& readylist)
+                                           SchedList<AluInstr>& readylist)
 {
    assert(group);
 
@@ -956,7 +960,7 @@ BlockScheduler::schedule_alu_to_group_trans(AluGroup *group,
 
 template <typename I>
 bool
-BlockScheduler::schedule(std::list<I *>& ready_list)
+BlockScheduler::schedule(SchedList<I>& ready_list)
 {
    if (!ready_list.empty() && m_current_block->remaining_slots() > 0) {
       auto ii = ready_list.begin();
@@ -971,7 +975,7 @@ BlockScheduler::schedule(std::list<I *>& ready_list)
 
 template <typename I>
 bool
-BlockScheduler::schedule_block(std::list<I *>& ready_list)
+BlockScheduler::schedule_block(SchedList<I>& ready_list)
 {
    bool success = false;
    while (!ready_list.empty() && m_current_block->remaining_slots() > 0) {
@@ -988,7 +992,7 @@ BlockScheduler::schedule_block(std::list<I *>& ready_list)
 
 bool
 BlockScheduler::schedule_exports(Shader::ShaderBlocks& out_blocks,
-                                std::list<ExportInstr *>& ready_list)
+                                SchedList<ExportInstr>& ready_list)
 {
    if (m_current_block->type() != Block::cf)
       start_new_block(out_blocks, Block::cf);
@@ -1037,8 +1041,8 @@ BlockScheduler::collect_ready(CollectInstructions& available)
 }
 
 bool
-BlockScheduler::collect_ready_alu_vec(std::list<AluInstr *>& ready,
-                                     std::list<AluInstr *>& available)
+BlockScheduler::collect_ready_alu_vec(SchedList<AluInstr>& ready,
+                                     SchedList<AluInstr>& available)
 {
    auto i = available.begin();
    auto e = available.end();
@@ -1158,7 +1162,7 @@ template <> struct type_char<RatInstr> {
 
 template <typename T>
 bool
-BlockScheduler::collect_ready_type(std::list<T *>& ready, std::list<T *>& available)
+BlockScheduler::collect_ready_type(SchedList<T>& ready, SchedList<T>& available)
 {
    auto i = available.begin();
    auto e = available.end();
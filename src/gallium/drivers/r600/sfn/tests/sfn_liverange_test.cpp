@@ -1,8 +1,10 @@
 #include "../sfn_liverangeevaluator.h"
+#include "../sfn_ra.h"
 #include "../sfn_shader.h"
 #include "sfn_test_shaders.h"
 
 #include "gtest/gtest.h"
+#include <set>
 #include <sstream>
 
 namespace r600 {
@@ -56,6 +58,37 @@ TEST_F(SimpleTest, SimpleLiveRangeMapTest)
    EXPECT_NE(a, b);
 }
 
+TEST_F(SimpleTest, InterferenceFromLiveRanges)
+{
+   static const int ranges[][2] = {
+      {0, 3}, {1, 1}, {-1, -1}, {4, 6}, {3, 4}, {2, 9}, {7, 7}, {5, 2}, {8, 9},
+   };
+   const int n = ARRAY_SIZE(ranges);
+
+   LiveRangeMap lrm;
+   std::vector<std::unique_ptr<Register>> regs;
+   for (int i = 0; i < n; ++i) {
+      regs.push_back(std::make_unique<Register>(i + 1, 0, pin_none));
+      regs[i]->set_index(i);
+      lrm.append_register(regs[i].get());
+      lrm.set_life_range(*regs[i], ranges[i][0], ranges[i][1]);
+   }
+
+   Interference interference(lrm);
+
+   for (int i = 0; i < n; ++i) {
+      std::set<int> expect;
+      for (int j = 0; j < n; ++j) {
+         if (i != j && ranges[i][1] >= ranges[j][0] && ranges[i][0] <= ranges[j][1])
+            expect.insert(j);
+      }
+
+      auto& row = interference.row(0, i);
+      EXPECT_EQ(std::set<int>(row.begin(), row.end()), expect) << "register " << i;
+      EXPECT_EQ(row.size(), expect.size()) << "register " << i;
+   }
+}
+
 TEST_F(LiveRangeTests, SimpleAssignments)
 {
    RegisterVec4::Swizzle dummy;
@@ -752,7 +752,6 @@ void si_init_buffer_functions(struct si_context *sctx)
    sctx->b.buffer_map = si_buffer_transfer_map;
    sctx->b.transfer_flush_region = si_buffer_flush_region;
    sctx->b.buffer_unmap = si_buffer_transfer_unmap;
-   sctx->b.texture_subdata = u_default_texture_subdata;
    sctx->b.buffer_subdata = si_buffer_subdata;
    sctx->b.resource_commit = si_resource_commit;
 }
@@ -8,6 +8,8 @@
 #include "util/format/u_format.h"
 #include "util/format_srgb.h"
 #include "util/u_helpers.h"
+#include "util/u_surface.h"
+#include "util/u_upload_mgr.h"
 #include "util/hash_table.h"
 
 static bool si_can_use_compute_blit(struct si_context *sctx, enum pipe_format format,
@@ -564,6 +566,81 @@ void si_compute_shorten_ubyte_buffer(struct si_context *sctx, struct pipe_resour
                                  2, sb, 0x1);
 }
 
+/* Remove draws with vertex_count == 0 or instance_count == 0 from an indirect multi-draw,
+ * so that the CP doesn't have to process them. The order of the remaining draws is preserved,
+ * but DrawID isn't, so this must not be used if the vertex shader reads DrawID.
+ *
+ * Return "compacted", which should be used instead of "indirect" for the draw.
+ */
+bool si_compute_compact_draws(struct si_context *sctx, const struct pipe_draw_indirect_info *indirect,
+                              bool indexed, struct pipe_draw_indirect_info *compacted)
+{
+   unsigned dst_stride = indexed ? 20 : 16;
+   unsigned size = 16 + indirect->draw_count * dst_stride;
+
+   if (!sctx->compact_draws_buffer || sctx->compact_draws_buffer->b.b.width0 < size) {
+      si_resource_reference(&sctx->compact_draws_buffer, NULL);
+      sctx->compact_draws_buffer =
+         si_aligned_buffer_create(&sctx->screen->b,
+                                  PIPE_RESOURCE_FLAG_UNMAPPABLE | SI_RESOURCE_FLAG_DRIVER_INTERNAL,
+                                  PIPE_USAGE_DEFAULT, util_next_power_of_two(size), 256);
+      if (!sctx->compact_draws_buffer)
+         return false;
+   }
+
+   if (!sctx->cs_compact_draws)
+      sctx->cs_compact_draws = si_create_compact_draws_cs(sctx);
+
+   struct pipe_resource *dst = &sctx->compact_draws_buffer->b.b;
+
+   struct pipe_grid_info info = {};
+   info.block[0] = si_determine_wave_size(sctx->screen, NULL);
+   info.block[1] = 1;
+   info.block[2] = 1;
+   info.grid[0] = 1;
+   info.grid[1] = 1;
+   info.grid[2] = 1;
+
+   struct pipe_shader_buffer sb[3] = {};
+   sb[0].buffer = dst;
+   sb[0].buffer_size = size;
+
+   sb[1].buffer = indirect->buffer;
+   sb[1].buffer_offset = indirect->offset;
+   sb[1].buffer_size = indirect->buffer->width0 - indirect->offset;
+
+   if (indirect->indirect_draw_count) {
+      sb[2].buffer = indirect->indirect_draw_count;
+      sb[2].buffer_offset = indirect->indirect_draw_count_offset;
+      sb[2].buffer_size = 4;
+   }
+
+   /* The draws were written before the draw call, so only wait for previous shaders
+    * if they could have written them.
+    */
+   unsigned flags = SI_OP_SYNC_CS_BEFORE | SI_OP_SYNC_PS_BEFORE | SI_OP_SYNC_AFTER;
+   si_improve_sync_flags(sctx, indirect->buffer, indirect->indirect_draw_count, &flags);
+
+   sctx->cs_user_data[0] = indirect->stride;
+   sctx->cs_user_data[1] = indirect->draw_count;
+   sctx->cs_user_data[2] = (indexed ? 0x1 : 0) | (indirect->indirect_draw_count ? 0x2 : 0);
+
+   si_launch_grid_internal_ssbos(sctx, &info, sctx->cs_compact_draws, flags, SI_COHERENCY_SHADER,
+                                 indirect->indirect_draw_count ? 3 : 2, sb, 0x1);
+
+   /* The CP reads the compacted draws. */
+   sctx->flags |= SI_CONTEXT_PFP_SYNC_ME;
+   si_mark_atom_dirty(sctx, &sctx->atoms.s.cache_flush);
+
+   *compacted = *indirect;
+   compacted->buffer = dst;
+   compacted->offset = 16;
+   compacted->stride = dst_stride;
+   compacted->indirect_draw_count = dst;
+   compacted->indirect_draw_count_offset = 0;
+   return true;
+}
+
 static unsigned
 set_work_size(struct pipe_grid_info *info, unsigned block_x, unsigned block_y, unsigned block_z,
               unsigned work_x, unsigned work_y, unsigned work_z)
@@ -825,6 +902,117 @@ bool si_compute_copy_image(struct si_context *sctx, struct pipe_resource *dst, u
    return true;
 }
 
+/* Upload texels into a texture through the stream uploader and a compute shader that writes
+ * them with image stores. This avoids creating a staging texture for every upload and lets
+ * the image store do the tiling.
+ *
+ * Return false if the upload isn't possible this way.
+ */
+bool si_compute_texture_upload(struct si_context *sctx, struct pipe_resource *dst, unsigned level,
+                               const struct pipe_box *box, const void *data, unsigned stride,
+                               uintptr_t layer_stride)
+{
+   struct si_texture *tex = (struct si_texture *)dst;
+   enum pipe_format format = util_format_linear(dst->format);
+   unsigned blocksize = util_format_get_blocksize(format);
+   unsigned access = 0;
+
+   if (tex->is_depth || dst->nr_samples > 1 || dst->flags & PIPE_RESOURCE_FLAG_SPARSE ||
+       tex->buffer.flags & RADEON_FLAG_ENCRYPTED ||
+       !util_is_power_of_two_nonzero(blocksize) || blocksize > 16 ||
+       util_format_is_subsampled_422(format) || util_format_get_num_planes(format) > 1 ||
+       !si_can_use_compute_blit(sctx, format, dst->nr_samples, true,
+                                vi_dcc_enabled(tex, level)))
+      return false;
+
+   static const enum pipe_format uint_formats[] = {
+      PIPE_FORMAT_R8_UINT,
+      PIPE_FORMAT_R16_UINT,
+      PIPE_FORMAT_R32_UINT,
+      PIPE_FORMAT_R32G32_UINT,
+      PIPE_FORMAT_R32G32B32A32_UINT,
+   };
+   unsigned log2_blocksize = util_logbase2(blocksize);
+   enum pipe_format uint_format = uint_formats[log2_blocksize];
+
+   /* The texels are stored as UINT, which must not change how DCC compresses them. */
+   if (vi_dcc_enabled(tex, level) &&
+       !vi_dcc_formats_compatible(sctx->screen, format, uint_format))
+      return false;
+
+   if (util_format_is_compressed(format))
+      access |= SI_IMAGE_ACCESS_BLOCK_FORMAT_AS_UINT;
+
+   unsigned x = util_format_get_nblocksx(format, box->x);
+   unsigned y = util_format_get_nblocksy(format, box->y);
+   unsigned width = util_format_get_nblocksx(format, box->width);
+   unsigned height = util_format_get_nblocksy(format, box->height);
+   unsigned size = width * height * box->depth * blocksize;
+
+   if (!size)
+      return true; /* success - nothing to do */
+
+   /* All coordinates are packed as 16 bits. */
+   if (x + width > UINT16_MAX || y + height > UINT16_MAX || box->z + box->depth > UINT16_MAX)
+      return false;
+
+   /* Copy the texels into the stream uploader, which is persistently mapped, tightly packed. */
+   struct pipe_resource *upload_buf = NULL;
+   unsigned upload_offset;
+   uint8_t *ptr;
+
+   u_upload_alloc(sctx->b.stream_uploader, 0, size, si_optimal_tcc_alignment(sctx, size),
+                  &upload_offset, &upload_buf, (void **)&ptr);
+   if (!upload_buf)
+      return false;
+
+   util_copy_box(ptr, format, width * blocksize, width * height * blocksize, 0, 0, 0,
+                 box->width, box->height, box->depth, data, stride, layer_stride, 0, 0, 0);
+   u_upload_unmap(sctx->b.stream_uploader);
+
+   bool dst_is_1d = dst->target == PIPE_TEXTURE_1D || dst->target == PIPE_TEXTURE_1D_ARRAY;
+   struct pipe_grid_info info = {0};
+
+   if (height <= 4 || tex->surface.is_linear)
+      set_work_size(&info, 64, 1, 1, width, height, box->depth);
+   else
+      set_work_size(&info, 8, 8, 1, width, height, box->depth);
+
+   sctx->cs_user_data[0] = x | (y << 16);
+   sctx->cs_user_data[1] = box->z | (width << 16);
+   sctx->cs_user_data[2] = height;
+
+   void **shader = &sctx->cs_texture_upload[log2_blocksize][dst_is_1d];
+   if (!*shader)
+      *shader = si_create_texture_upload_cs(sctx, log2_blocksize, dst_is_1d);
+
+   struct pipe_image_view image = {0};
+   image.resource = dst;
+   image.shader_access = image.access = PIPE_IMAGE_ACCESS_WRITE | access;
+   image.format = uint_format;
+   image.u.tex.level = level;
+   image.u.tex.first_layer = 0;
+   image.u.tex.last_layer = util_max_layer(dst, level);
+
+   /* Bind the source buffer. It's only read, so it doesn't need any cache flushes. */
+   struct pipe_shader_buffer sb = {0}, saved_sb = {0};
+   sb.buffer = upload_buf;
+   sb.buffer_offset = upload_offset;
+   sb.buffer_size = size;
+
+   si_get_shader_buffers(sctx, PIPE_SHADER_COMPUTE, 0, 1, &saved_sb);
+   bool saved_writable = sctx->const_and_shader_buffers[PIPE_SHADER_COMPUTE].writable_mask &
+                         (1u << si_get_shaderbuf_slot(0));
+
+   si_set_shader_buffers(&sctx->b, PIPE_SHADER_COMPUTE, 0, 1, &sb, 0, true);
+   si_launch_grid_internal_images(sctx, &image, 1, &info, *shader, SI_OP_SYNC_BEFORE_AFTER);
+   sctx->b.set_shader_buffers(&sctx->b, PIPE_SHADER_COMPUTE, 0, 1, &saved_sb, saved_writable);
+
+   pipe_resource_reference(&saved_sb.buffer, NULL);
+   pipe_resource_reference(&upload_buf, NULL);
+   return true;
+}
+
 void si_retile_dcc(struct si_context *sctx, struct si_texture *tex)
 {
    /* Set the DCC buffer. */
@@ -104,6 +104,7 @@ static void si_release_descriptors(struct si_descriptors *desc)
 {
    si_resource_reference(&desc->buffer, NULL);
    FREE(desc->list);
+   FREE(desc->uploaded_list);
 }
 
 static void si_upload_descriptors(struct si_context *sctx, struct si_descriptors *desc)
@@ -127,10 +128,23 @@ static void si_upload_descriptors(struct si_context *sctx, struct si_descriptors
       /* The buffer is already in the buffer list. */
       si_resource_reference(&desc->buffer, NULL);
       desc->gpu_list = NULL;
+      desc->uploaded_num_slots = 0;
       desc->gpu_address = si_desc_extract_buffer_address(descriptor);
       return;
    }
 
+   /* Rebinding the same resources is common. If the active slots haven't changed since
+    * the last upload, keep using the uploaded copy. The shaders can still be reading it,
+    * so it's never modified, only replaced.
+    */
+   if (desc->buffer && desc->uploaded_first_slot == desc->first_active_slot &&
+       desc->uploaded_num_slots == desc->num_active_slots &&
+       !memcmp(desc->uploaded_list, (char *)desc->list + first_slot_offset, upload_size)) {
+      radeon_add_to_buffer_list(sctx, &sctx->gfx_cs, desc->buffer,
+                                RADEON_USAGE_READ | RADEON_PRIO_DESCRIPTORS);
+      return;
+   }
+
    uint32_t *ptr;
    unsigned buffer_offset;
    u_upload_alloc(sctx->b.const_uploader, first_slot_offset, upload_size,
@@ -145,6 +159,19 @@ static void si_upload_descriptors(struct si_context *sctx, struct si_descriptors
    util_memcpy_cpu_to_le32(ptr, (char *)desc->list + first_slot_offset, upload_size);
    desc->gpu_list = ptr - first_slot_offset / 4;
 
+   if (desc->uploaded_list_num_slots < desc->num_active_slots) {
+      FREE(desc->uploaded_list);
+      desc->uploaded_list = MALLOC(upload_size);
+      desc->uploaded_list_num_slots = desc->uploaded_list ? desc->num_active_slots : 0;
+   }
+   if (desc->uploaded_list) {
+      memcpy(desc->uploaded_list, (char *)desc->list + first_slot_offset, upload_size);
+      desc->uploaded_first_slot = desc->first_active_slot;
+      desc->uploaded_num_slots = desc->num_active_slots;
+   } else {
+      desc->uploaded_num_slots = 0;
+   }
+
    radeon_add_to_buffer_list(sctx, &sctx->gfx_cs, desc->buffer,
                              RADEON_USAGE_READ | RADEON_PRIO_DESCRIPTORS);
 
@@ -1967,6 +1994,9 @@ static void si_upload_bindless_descriptor(struct si_context *sctx, unsigned desc
 
    si_cp_write_data(sctx, desc->buffer, va - desc->buffer->gpu_address, num_dwords * 4, V_370_TC_L2,
                     V_370_ME, data);
+
+   /* The uploaded copy has been modified in place and no longer matches uploaded_list. */
+   desc->uploaded_num_slots = 0;
 }
 
 static void si_upload_bindless_descriptors(struct si_context *sctx)
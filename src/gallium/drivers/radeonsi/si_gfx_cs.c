@@ -182,6 +182,9 @@ void si_flush_gfx_cs(struct si_context *ctx, unsigned flags, struct pipe_fence_h
    if (sscreen->context_roll_log_filename)
       si_gather_context_rolls(ctx);
 
+   if (sscreen->ib_stats_log_filename)
+      si_gather_ib_stats(ctx);
+
    if (ctx->is_noop)
       flags |= RADEON_FLUSH_NOOP;
 
@@ -109,6 +109,7 @@ static const struct debug_named_value radeonsi_debug_options[] = {
    {"nodccmsaa", DBG(NO_DCC_MSAA), "Disable DCC for MSAA"},
    {"nofmask", DBG(NO_FMASK), "Disable MSAA compression"},
    {"nodma", DBG(NO_DMA), "Disable SDMA-copy for DRI_PRIME"},
+   {"compactdraws", DBG(COMPACT_DRAWS), "Remove empty draws from indirect multi-draws with a compute shader."},
 
    {"extra_md", DBG(EXTRA_METADATA), "Set UMD metadata for all textures and with additional fields for umr"},
 
@@ -229,6 +230,7 @@ static void si_destroy_context(struct pipe_context *context)
    free(sctx->border_color_table);
    si_resource_reference(&sctx->scratch_buffer, NULL);
    si_resource_reference(&sctx->compute_scratch_buffer, NULL);
+   si_resource_reference(&sctx->compact_draws_buffer, NULL);
    si_resource_reference(&sctx->wait_mem_scratch, NULL);
    si_resource_reference(&sctx->wait_mem_scratch_tmz, NULL);
    si_resource_reference(&sctx->small_prim_cull_info_buf, NULL);
@@ -275,6 +277,14 @@ static void si_destroy_context(struct pipe_context *context)
       sctx->b.delete_compute_state(&sctx->b, sctx->cs_copy_buffer);
    if (sctx->cs_ubyte_to_ushort)
       sctx->b.delete_compute_state(&sctx->b, sctx->cs_ubyte_to_ushort);
+   if (sctx->cs_compact_draws)
+      sctx->b.delete_compute_state(&sctx->b, sctx->cs_compact_draws);
+   for (unsigned i = 0; i < ARRAY_SIZE(sctx->cs_texture_upload); i++) {
+      for (unsigned j = 0; j < ARRAY_SIZE(sctx->cs_texture_upload[i]); j++) {
+         if (sctx->cs_texture_upload[i][j])
+            sctx->b.delete_compute_state(&sctx->b, sctx->cs_texture_upload[i][j]);
+      }
+   }
    for (unsigned i = 0; i < ARRAY_SIZE(sctx->cs_copy_image); i++) {
       for (unsigned j = 0; j < ARRAY_SIZE(sctx->cs_copy_image[i]); j++) {
          for (unsigned k = 0; k < ARRAY_SIZE(sctx->cs_copy_image[i][j]); k++) {
@@ -942,6 +952,7 @@ static struct pipe_context *si_pipe_create_context(struct pipe_screen *screen, v
                                  .is_resource_busy = si_is_resource_busy,
                                  .driver_calls_flush_notify = true,
                                  .unsynchronized_create_fence_fd = true,
+                                 .adaptive_batch_size = sscreen->tc_adaptive_batches,
                               },
                               &((struct si_context *)ctx)->tc);
 
@@ -1179,6 +1190,7 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    sscreen->options.name = driQueryOptioni(config->options, "radeonsi_" #name);
 #include "si_debug_options.h"
    }
+   sscreen->tc_adaptive_batches = driQueryOptionb(config->options, "mesa_tc_adaptive_batches");
 
    sscreen->ws = ws;
    ws->query_info(ws, &sscreen->info);
@@ -1191,6 +1203,7 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    }
 
    sscreen->context_roll_log_filename = debug_get_option("AMD_ROLLS", NULL);
+   sscreen->ib_stats_log_filename = debug_get_option("AMD_IB_STATS", NULL);
    sscreen->debug_flags = debug_get_flags_option("R600_DEBUG", radeonsi_debug_options, 0);
    sscreen->debug_flags |= debug_get_flags_option("AMD_DEBUG", radeonsi_debug_options, 0);
    test_flags = debug_get_flags_option("AMD_TEST", test_options, 0);
@@ -1337,6 +1350,7 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    if (!util_queue_init(&sscreen->shader_compiler_queue, "sh", num_slots,
                         num_comp_hi_threads,
                         UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                        UTIL_QUEUE_INIT_WORK_STEALING |
                         UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL)) {
       si_destroy_shader_cache(sscreen);
       FREE(sscreen->nir_options);
@@ -1348,6 +1362,7 @@ static struct pipe_screen *radeonsi_screen_create_impl(struct radeon_winsys *ws,
    if (!util_queue_init(&sscreen->shader_compiler_queue_opt_variants, "sh_opt", num_slots,
                         num_comp_lo_threads,
                         UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                        UTIL_QUEUE_INIT_WORK_STEALING |
                         UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL)) {
       si_destroy_shader_cache(sscreen);
       FREE(sscreen->nir_options);
@@ -51,6 +51,8 @@ struct ac_llvm_compiler;
 #define SI_COMPUTE_COPY_DW_PER_THREAD  4
 /* L2 LRU is recommended because the compute shader can finish sooner due to fewer L2 evictions. */
 #define SI_COMPUTE_DST_CACHE_POLICY    L2_LRU
+/* The minimum draw count of indirect multi-draws compacted by AMD_DEBUG=compactdraws. */
+#define SI_COMPACT_DRAWS_MIN_COUNT     64
 
 /* Pipeline & streamout query controls. */
 #define SI_CONTEXT_START_PIPELINE_STATS  (1 << 0)
@@ -250,6 +252,7 @@ enum
    DBG_NO_DCC_MSAA,
    DBG_NO_FMASK,
    DBG_NO_DMA,
+   DBG_COMPACT_DRAWS,
 
    DBG_EXTRA_METADATA,
 
@@ -590,10 +593,14 @@ struct si_screen {
 #include "si_debug_options.h"
    } options;
 
+   /* driconf mesa_tc_adaptive_batches */
+   bool tc_adaptive_batches;
+
    /* Whether shaders are monolithic (1-part) or separate (3-part). */
    bool use_monolithic_shaders;
    bool record_llvm_ir;
    const char *context_roll_log_filename;
+   const char *ib_stats_log_filename;
 
    struct slab_parent_pool pool_transfers;
 
@@ -1024,7 +1031,9 @@ struct si_context {
    void *cs_clear_buffer_rmw;
    void *cs_copy_buffer;
    void *cs_ubyte_to_ushort;
+   void *cs_compact_draws;
    void *cs_copy_image[3][2][2]; /* [wg_dim-1][src_is_1d][dst_is_1d] */
+   void *cs_texture_upload[5][2]; /* [log2_blocksize][dst_is_1d] */
    void *cs_clear_render_target;
    void *cs_clear_render_target_1d_array;
    void *cs_clear_12bytes_buffer;
@@ -1223,6 +1232,7 @@ struct si_context {
    unsigned max_seen_compute_scratch_bytes_per_wave;
 
    struct si_resource *compute_scratch_buffer;
+   struct si_resource *compact_draws_buffer;
 
    /* Emitted derived tessellation state. */
    /* Local shader (VS), or HS if LS-HS are merged. */
@@ -1377,6 +1387,7 @@ struct si_context {
    struct ac_sqtt *sqtt;
    struct ac_spm spm;
    struct pipe_fence_handle *last_sqtt_fence;
+   struct si_sqtt_stream *sqtt_stream; /* AMD_THREAD_TRACE_SEGMENT_FRAMES */
    enum rgp_sqtt_marker_event_type sqtt_next_event;
    bool sqtt_enabled;
 
@@ -1512,10 +1523,15 @@ void si_copy_buffer(struct si_context *sctx, struct pipe_resource *dst, struct p
                     uint64_t dst_offset, uint64_t src_offset, unsigned size, unsigned flags);
 void si_compute_shorten_ubyte_buffer(struct si_context *sctx, struct pipe_resource *dst, struct pipe_resource *src,
                                      uint64_t dst_offset, uint64_t src_offset, unsigned size, unsigned flags);
+bool si_compute_compact_draws(struct si_context *sctx, const struct pipe_draw_indirect_info *indirect,
+                              bool indexed, struct pipe_draw_indirect_info *compacted);
 bool si_compute_copy_image(struct si_context *sctx, struct pipe_resource *dst, unsigned dst_level,
                            struct pipe_resource *src, unsigned src_level, unsigned dstx,
                            unsigned dsty, unsigned dstz, const struct pipe_box *src_box,
                            unsigned flags);
+bool si_compute_texture_upload(struct si_context *sctx, struct pipe_resource *dst, unsigned level,
+                               const struct pipe_box *box, const void *data, unsigned stride,
+                               uintptr_t layer_stride);
 void si_compute_clear_render_target(struct pipe_context *ctx, struct pipe_surface *dstsurf,
                                     const union pipe_color_union *color, unsigned dstx,
                                     unsigned dsty, unsigned width, unsigned height,
@@ -1549,6 +1565,7 @@ void si_init_cp_reg_shadowing(struct si_context *sctx);
 
 /* si_debug.c */
 void si_gather_context_rolls(struct si_context *sctx);
+void si_gather_ib_stats(struct si_context *sctx);
 void si_save_cs(struct radeon_winsys *ws, struct radeon_cmdbuf *cs, struct radeon_saved_cs *saved,
                 bool get_buffer_list);
 void si_clear_saved_cs(struct radeon_saved_cs *saved);
@@ -1637,6 +1654,8 @@ void si_resume_queries(struct si_context *sctx);
 /* si_shaderlib_nir.c */
 void *si_create_copy_image_cs(struct si_context *sctx, unsigned wg_dim,
                               bool src_is_1d_array, bool dst_is_1d_array);
+void *si_create_texture_upload_cs(struct si_context *sctx, unsigned log2_blocksize,
+                                  bool dst_is_1d_array);
 void *si_create_dcc_retile_cs(struct si_context *sctx, struct radeon_surf *surf);
 void *gfx9_create_clear_dcc_msaa_cs(struct si_context *sctx, struct si_texture *tex);
 void *si_create_passthrough_tcs(struct si_context *sctx);
@@ -1677,6 +1696,7 @@ void *si_get_blitter_vs(struct si_context *sctx, enum blitter_attrib_type type,
 void *si_create_dma_compute_shader(struct si_context *sctx, unsigned num_dwords_per_thread,
                                    bool dst_stream_cache_policy, bool is_copy);
 void *si_create_ubyte_to_ushort_compute_shader(struct si_context *sctx);
+void *si_create_compact_draws_cs(struct si_context *sctx);
 void *si_create_clear_buffer_rmw_cs(struct si_context *sctx);
 void *si_clear_render_target_shader(struct si_context *sctx, enum pipe_texture_target type);
 void *si_clear_12bytes_buffer_shader(struct si_context *sctx);
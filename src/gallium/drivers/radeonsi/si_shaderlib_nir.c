@@ -658,6 +658,171 @@ void *si_create_ubyte_to_ushort_compute_shader(struct si_context *sctx)
    return create_shader_state(sctx, b.shader);
 }
 
+/* Create a compute shader that removes draws with vertex_count == 0 or instance_count == 0
+ * from an indirect multi-draw buffer while preserving the order of the remaining draws.
+ *
+ * It's executed by a single wave.
+ *    SSBO 0: dst: the number of remaining draws at offset 0, the draws at offset 16
+ *    SSBO 1: src draws
+ *    SSBO 2: src draw count (only used if flags & 0x2)
+ *
+ *    user_data[0]: src stride in bytes
+ *    user_data[1]: max draw count
+ *    user_data[2]: flags: 0x1 = indexed draws (5 dwords per draw), 0x2 = src draw count is present
+ */
+void *si_create_compact_draws_cs(struct si_context *sctx)
+{
+   const nir_shader_compiler_options *options =
+      sctx->b.screen->get_compiler_options(sctx->b.screen, PIPE_SHADER_IR_NIR, PIPE_SHADER_COMPUTE);
+
+   nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, options, "compact_draws");
+   unsigned wave_size = si_determine_wave_size(sctx->screen, NULL);
+
+   b.shader->info.workgroup_size[0] = wave_size;
+   b.shader->info.workgroup_size[1] = 1;
+   b.shader->info.workgroup_size[2] = 1;
+   b.shader->info.cs.user_data_components_amd = 3;
+   b.shader->info.num_ssbos = 3;
+
+   nir_def *zero = nir_imm_int(&b, 0);
+   nir_def *user_sgprs = nir_load_user_data_amd(&b);
+   nir_def *src_stride = nir_channel(&b, user_sgprs, 0);
+   nir_def *flags = nir_channel(&b, user_sgprs, 2);
+   nir_def *is_indexed = nir_test_mask(&b, flags, 0x1);
+   nir_def *dst_stride = nir_bcsel(&b, is_indexed, nir_imm_int(&b, 20), nir_imm_int(&b, 16));
+   nir_def *lane = nir_channel(&b, nir_load_local_invocation_id(&b), 0);
+
+   /* count = flags & 0x2 ? min(src_count, max_count) : max_count; */
+   nir_def *count = nir_channel(&b, user_sgprs, 1);
+   nir_push_if(&b, nir_test_mask(&b, flags, 0x2));
+   nir_def *src_count = nir_umin(&b, nir_load_ssbo(&b, 1, 32, nir_imm_int(&b, 2), zero), count);
+   nir_pop_if(&b, NULL);
+   count = nir_if_phi(&b, src_count, count);
+
+   nir_function_impl *e = nir_shader_get_entrypoint(b.shader);
+   nir_variable *base = nir_local_variable_create(e, glsl_uint_type(), "base");
+   nir_store_var(&b, base, zero, 0x1);
+   nir_variable *num_written = nir_local_variable_create(e, glsl_uint_type(), "num_written");
+   nir_store_var(&b, num_written, zero, 0x1);
+
+   /* Process one draw per lane, wave_size draws per iteration. */
+   nir_push_loop(&b);
+   {
+      nir_def *first = nir_load_var(&b, base);
+      nir_push_if(&b, nir_uge(&b, first, count));
+      nir_jump(&b, nir_jump_break);
+      nir_pop_if(&b, NULL);
+
+      nir_def *index = nir_iadd(&b, first, lane);
+      nir_def *src_offset = nir_imul(&b, index, src_stride);
+      nir_def *is_valid = nir_ult(&b, index, count);
+
+      nir_def *no_draw = nir_imm_zero(&b, 4, 32);
+      nir_push_if(&b, is_valid);
+      nir_def *draw = nir_load_ssbo(&b, 4, 32, nir_imm_int(&b, 1), src_offset, .align_mul = 4);
+      nir_pop_if(&b, NULL);
+      draw = nir_if_phi(&b, draw, no_draw);
+
+      /* The first 2 dwords are vertex_count and instance_count for both draw types. */
+      nir_def *keep = nir_iand(&b, nir_ine_imm(&b, nir_channel(&b, draw, 0), 0),
+                               nir_ine_imm(&b, nir_channel(&b, draw, 1), 0));
+
+      nir_def *keep_int = nir_b2i32(&b, keep);
+      nir_def *dst_index = nir_iadd(&b, nir_load_var(&b, num_written),
+                                    nir_exclusive_scan(&b, keep_int, .reduction_op = nir_op_iadd));
+      nir_def *dst_offset = nir_iadd_imm(&b, nir_imul(&b, dst_index, dst_stride), 16);
+
+      nir_push_if(&b, keep);
+      {
+         nir_store_ssbo(&b, draw, zero, dst_offset, .align_mul = 4);
+
+         nir_push_if(&b, is_indexed);
+         nir_def *base_instance = nir_load_ssbo(&b, 1, 32, nir_imm_int(&b, 1),
+                                                nir_iadd_imm(&b, src_offset, 16));
+         nir_store_ssbo(&b, base_instance, zero, nir_iadd_imm(&b, dst_offset, 16));
+         nir_pop_if(&b, NULL);
+      }
+      nir_pop_if(&b, NULL);
+
+      nir_store_var(&b, num_written,
+                    nir_iadd(&b, nir_load_var(&b, num_written),
+                             nir_reduce(&b, keep_int, .reduction_op = nir_op_iadd)), 0x1);
+      nir_store_var(&b, base, nir_iadd_imm(&b, first, wave_size), 0x1);
+   }
+   nir_pop_loop(&b, NULL);
+
+   nir_push_if(&b, nir_ieq_imm(&b, lane, 0));
+   nir_store_ssbo(&b, nir_load_var(&b, num_written), zero, zero);
+   nir_pop_if(&b, NULL);
+
+   return create_shader_state(sctx, b.shader);
+}
+
+/* Create a compute shader that uploads tightly packed texels from a buffer into an image.
+ *
+ *    SSBO 0: src texels, one row after another and one layer after another
+ *    image 0: dst, the format is UINT with the same block size as the texels
+ *
+ *    user_data[0]: dst x | dst y << 16
+ *    user_data[1]: dst z | width << 16
+ *    user_data[2]: height
+ */
+void *si_create_texture_upload_cs(struct si_context *sctx, unsigned log2_blocksize,
+                                  bool dst_is_1d_array)
+{
+   const nir_shader_compiler_options *options =
+      sctx->b.screen->get_compiler_options(sctx->b.screen, PIPE_SHADER_IR_NIR, PIPE_SHADER_COMPUTE);
+
+   nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, options, "texture_upload_cs");
+   b.shader->info.workgroup_size_variable = true;
+   b.shader->info.num_ssbos = 1;
+   b.shader->info.num_images = 1;
+   b.shader->info.cs.user_data_components_amd = 3;
+
+   nir_def *ids = get_global_ids(&b, 3);
+   nir_def *user_data = nir_load_user_data_amd(&b);
+
+   nir_def *dst_x, *dst_y, *dst_z, *width;
+   unpack_2x16(&b, nir_channel(&b, user_data, 0), &dst_x, &dst_y);
+   unpack_2x16(&b, nir_channel(&b, user_data, 1), &dst_z, &width);
+   nir_def *height = nir_channel(&b, user_data, 2);
+
+   /* offset = ((z * height + y) * width + x) * blocksize */
+   nir_def *index = nir_iadd(&b, nir_imul(&b, nir_channel(&b, ids, 2), height),
+                             nir_channel(&b, ids, 1));
+   index = nir_iadd(&b, nir_imul(&b, index, width), nir_channel(&b, ids, 0));
+   nir_def *offset = nir_ishl_imm(&b, index, log2_blocksize);
+   nir_def *zero = nir_imm_int(&b, 0);
+   nir_def *data;
+
+   if (log2_blocksize < 2) {
+      data = nir_u2u32(&b, nir_load_ssbo(&b, 1, 8 << log2_blocksize, zero, offset,
+                                         .align_mul = 1 << log2_blocksize));
+   } else {
+      data = nir_load_ssbo(&b, 1 << (log2_blocksize - 2), 32, zero, offset, .align_mul = 4);
+   }
+   data = nir_pad_vector_imm_int(&b, data, 0, 4);
+
+   /* Coordinates must have 4 channels in NIR. */
+   nir_def *coord = nir_iadd(&b, nir_vec3(&b, dst_x, dst_y, dst_z), ids);
+   coord = nir_pad_vector(&b, coord, 4);
+
+   static unsigned swizzle_xz[] = {0, 2, 0, 0};
+
+   if (dst_is_1d_array)
+      coord = nir_swizzle(&b, coord, swizzle_xz, 4);
+
+   const struct glsl_type *img_type = glsl_image_type(dst_is_1d_array ? GLSL_SAMPLER_DIM_1D
+                                                                      : GLSL_SAMPLER_DIM_2D,
+                                                      /*is_array*/ true, GLSL_TYPE_UINT);
+   nir_variable *img = nir_variable_create(b.shader, nir_var_image, img_type, "img_dst");
+   img->data.binding = 0;
+
+   nir_image_deref_store(&b, deref_ssa(&b, img), coord, nir_undef(&b, 1, 32), data, zero);
+
+   return create_shader_state(sctx, b.shader);
+}
+
 /* Create a compute shader implementing clear_buffer or copy_buffer. */
 void *si_create_dma_compute_shader(struct si_context *sctx, unsigned num_dwords_per_thread,
                                    bool dst_stream_cache_policy, bool is_copy)
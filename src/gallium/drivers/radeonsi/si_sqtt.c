@@ -12,6 +12,8 @@
 #include "util/hash_table.h"
 #include "util/u_debug.h"
 #include "util/u_memory.h"
+#include "util/u_process.h"
+#include "util/u_queue.h"
 #include "ac_rgp.h"
 #include "ac_sqtt.h"
 
@@ -19,29 +21,57 @@ static void
 si_emit_spi_config_cntl(struct si_context *sctx,
                         struct radeon_cmdbuf *cs, bool enable);
 
-static bool si_sqtt_init_bo(struct si_context *sctx)
+/* Double-buffered capture that writes one RGP file per segment of frames. While one buffer
+ * is being recorded, the other one is read back and written to disk by a separate thread.
+ */
+struct si_sqtt_segment {
+   struct si_context *sctx;
+   struct pb_buffer_lean *bo;
+   struct radeon_cmdbuf *start_cs[2];
+   struct radeon_cmdbuf *stop_cs[2];
+   struct pipe_fence_handle *fence;
+   struct util_queue_fence drained;
+   unsigned index;
+};
+
+struct si_sqtt_stream {
+   struct util_queue queue;
+   struct si_sqtt_segment segments[2];
+   unsigned current;            /* the segment being recorded */
+   unsigned frames_per_segment;
+   unsigned num_frames;         /* frames recorded into the current segment */
+   unsigned num_segments;       /* segments recorded so far */
+   unsigned max_segments;       /* 0 = unlimited */
+   char filename_prefix[1024];
+};
+
+static struct pb_buffer_lean *si_sqtt_create_bo(struct si_context *sctx)
 {
    unsigned max_se = sctx->screen->info.max_se;
    struct radeon_winsys *ws = sctx->ws;
    uint64_t size;
 
+   /* Compute total size of the thread trace BO for all SEs. */
+   size = align64(sizeof(struct ac_sqtt_data_info) * max_se,
+                  1 << SQTT_BUFFER_ALIGN_SHIFT);
+   size += sctx->sqtt->buffer_size * (uint64_t)max_se;
+
+   return ws->buffer_create(ws, size, 4096, RADEON_DOMAIN_VRAM,
+                            RADEON_FLAG_NO_INTERPROCESS_SHARING |
+                               RADEON_FLAG_GTT_WC | RADEON_FLAG_NO_SUBALLOC);
+}
+
+static bool si_sqtt_init_bo(struct si_context *sctx)
+{
    /* The buffer size and address need to be aligned in HW regs. Align the
     * size as early as possible so that we do all the allocation & addressing
     * correctly. */
    sctx->sqtt->buffer_size =
       align64(sctx->sqtt->buffer_size, 1u << SQTT_BUFFER_ALIGN_SHIFT);
 
-   /* Compute total size of the thread trace BO for all SEs. */
-   size = align64(sizeof(struct ac_sqtt_data_info) * max_se,
-                  1 << SQTT_BUFFER_ALIGN_SHIFT);
-   size += sctx->sqtt->buffer_size * (uint64_t)max_se;
-
    sctx->sqtt->pipeline_bos = _mesa_hash_table_u64_create(NULL);
 
-   sctx->sqtt->bo =
-      ws->buffer_create(ws, size, 4096, RADEON_DOMAIN_VRAM,
-                        RADEON_FLAG_NO_INTERPROCESS_SHARING |
-                           RADEON_FLAG_GTT_WC | RADEON_FLAG_NO_SUBALLOC);
+   sctx->sqtt->bo = si_sqtt_create_bo(sctx);
    if (!sctx->sqtt->bo)
       return false;
 
@@ -607,6 +637,198 @@ static bool si_get_sqtt_trace(struct si_context *sctx,
    return true;
 }
 
+static void si_sqtt_use_segment(struct si_context *sctx, struct si_sqtt_segment *seg)
+{
+   sctx->sqtt->bo = seg->bo;
+   memcpy(sctx->sqtt->start_cs, seg->start_cs, sizeof(seg->start_cs));
+   memcpy(sctx->sqtt->stop_cs, seg->stop_cs, sizeof(seg->stop_cs));
+}
+
+/* Read back a finished segment and write it to disk. This is executed by the stream thread. */
+static void si_sqtt_drain_segment(void *job, void *gdata, int thread_index)
+{
+   struct si_sqtt_segment *seg = (struct si_sqtt_segment *)job;
+   struct si_context *sctx = seg->sctx;
+   struct radeon_winsys *ws = sctx->ws;
+   struct ac_sqtt *sqtt = sctx->sqtt;
+   struct ac_sqtt_trace sqtt_trace;
+   char filename[2048];
+
+   if (!ws->fence_wait(ws, seg->fence, OS_TIMEOUT_INFINITE)) {
+      fprintf(stderr, "radeonsi: failed to wait for thread trace segment %u\n", seg->index);
+      return;
+   }
+
+   /* ac_sqtt_get_trace only needs the mapping and the buffer size of the segment.
+    * Everything else is shared with the context.
+    */
+   struct ac_sqtt data = {0};
+   data.ptr = ws->buffer_map(ws, seg->bo, NULL, PIPE_MAP_READ | RADEON_MAP_TEMPORARY);
+   data.buffer_size = sqtt->buffer_size;
+   if (!data.ptr) {
+      fprintf(stderr, "radeonsi: failed to map thread trace segment %u\n", seg->index);
+      return;
+   }
+
+   if (ac_sqtt_get_trace(&data, &sctx->screen->info, &sqtt_trace)) {
+      sqtt_trace.rgp_code_object = &sqtt->rgp_code_object;
+      sqtt_trace.rgp_loader_events = &sqtt->rgp_loader_events;
+      sqtt_trace.rgp_pso_correlation = &sqtt->rgp_pso_correlation;
+      sqtt_trace.rgp_queue_info = &sqtt->rgp_queue_info;
+      sqtt_trace.rgp_queue_event = &sqtt->rgp_queue_event;
+      sqtt_trace.rgp_clock_calibration = &sqtt->rgp_clock_calibration;
+
+      snprintf(filename, sizeof(filename), "%s_%04u.rgp",
+               sctx->sqtt_stream->filename_prefix, seg->index);
+
+      /* The context can register new pipelines while the file is written. */
+      simple_mtx_lock(&sqtt->rgp_code_object.lock);
+      simple_mtx_lock(&sqtt->rgp_loader_events.lock);
+      simple_mtx_lock(&sqtt->rgp_pso_correlation.lock);
+      ac_dump_rgp_capture_to_file(&sctx->screen->info, &sqtt_trace, NULL, filename);
+      simple_mtx_unlock(&sqtt->rgp_pso_correlation.lock);
+      simple_mtx_unlock(&sqtt->rgp_loader_events.lock);
+      simple_mtx_unlock(&sqtt->rgp_code_object.lock);
+   } else {
+      fprintf(stderr, "radeonsi: thread trace segment %u is incomplete because the buffer "
+                      "is too small. Please update the buffer size with "
+                      "AMD_THREAD_TRACE_BUFFER_SIZE=<size_in_kbytes>\n", seg->index);
+   }
+
+   ws->buffer_unmap(ws, seg->bo);
+}
+
+static bool si_sqtt_init_stream(struct si_context *sctx, unsigned frames_per_segment)
+{
+   struct si_sqtt_stream *stream = CALLOC_STRUCT(si_sqtt_stream);
+   if (!stream)
+      return false;
+
+   if (!util_queue_init(&stream->queue, "sqtt", 4, 1, UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL)) {
+      FREE(stream);
+      return false;
+   }
+
+   stream->frames_per_segment = frames_per_segment;
+   stream->max_segments = debug_get_num_option("AMD_THREAD_TRACE_MAX_SEGMENTS", 0);
+   sctx->sqtt_stream = stream;
+
+   /* The first segment uses the buffer and the command buffers that have already been
+    * created. The second one gets its own.
+    */
+   for (unsigned i = 0; i < ARRAY_SIZE(stream->segments); i++) {
+      struct si_sqtt_segment *seg = &stream->segments[i];
+
+      seg->sctx = sctx;
+      util_queue_fence_init(&seg->drained);
+
+      if (i) {
+         sctx->sqtt->bo = si_sqtt_create_bo(sctx);
+         if (!sctx->sqtt->bo)
+            return false;
+         si_sqtt_init_cs(sctx);
+      }
+
+      seg->bo = sctx->sqtt->bo;
+      memcpy(seg->start_cs, sctx->sqtt->start_cs, sizeof(seg->start_cs));
+      memcpy(seg->stop_cs, sctx->sqtt->stop_cs, sizeof(seg->stop_cs));
+   }
+
+   si_sqtt_use_segment(sctx, &stream->segments[0]);
+   return true;
+}
+
+static void si_sqtt_destroy_stream(struct si_context *sctx)
+{
+   struct si_sqtt_stream *stream = sctx->sqtt_stream;
+   struct si_sqtt_segment *cur = &stream->segments[stream->current];
+
+   /* Write the segment that is being recorded. */
+   if (sctx->sqtt_enabled) {
+      si_end_sqtt(sctx, &sctx->gfx_cs);
+      sctx->ws->fence_reference(sctx->ws, &cur->fence, sctx->last_sqtt_fence);
+      cur->index = stream->num_segments++;
+      util_queue_add_job(&stream->queue, cur, &cur->drained, si_sqtt_drain_segment, NULL, 0);
+      sctx->sqtt_enabled = false;
+   }
+
+   util_queue_finish(&stream->queue);
+   util_queue_destroy(&stream->queue);
+
+   for (unsigned i = 0; i < ARRAY_SIZE(stream->segments); i++) {
+      struct si_sqtt_segment *seg = &stream->segments[i];
+
+      util_queue_fence_destroy(&seg->drained);
+      sctx->ws->fence_reference(sctx->ws, &seg->fence, NULL);
+
+      /* The current segment is released with the rest of the trace. */
+      if (i == stream->current)
+         continue;
+
+      radeon_bo_reference(sctx->ws, &seg->bo, NULL);
+      for (unsigned j = 0; j < ARRAY_SIZE(seg->start_cs); j++) {
+         sctx->ws->cs_destroy(seg->start_cs[j]);
+         sctx->ws->cs_destroy(seg->stop_cs[j]);
+      }
+   }
+
+   FREE(stream);
+   sctx->sqtt_stream = NULL;
+}
+
+/* Called at the end of every frame while a stream is recorded. When the current segment is
+ * complete, stop it, hand it over to the stream thread and continue with the other buffer.
+ */
+static void si_sqtt_stream_end_frame(struct si_context *sctx, struct radeon_cmdbuf *rcs)
+{
+   struct si_sqtt_stream *stream = sctx->sqtt_stream;
+   struct si_sqtt_segment *seg = &stream->segments[stream->current];
+
+   if (++stream->num_frames < stream->frames_per_segment)
+      return;
+
+   si_end_sqtt(sctx, rcs);
+   sctx->ws->fence_reference(sctx->ws, &seg->fence, sctx->last_sqtt_fence);
+   seg->index = stream->num_segments++;
+   util_queue_add_job(&stream->queue, seg, &seg->drained, si_sqtt_drain_segment, NULL, 0);
+
+   if (stream->max_segments && stream->num_segments == stream->max_segments) {
+      sctx->sqtt_enabled = false;
+      return;
+   }
+
+   /* Continue with the other buffer after it has been written to disk. */
+   stream->current ^= 1;
+   seg = &stream->segments[stream->current];
+   util_queue_fence_wait(&seg->drained);
+   si_sqtt_use_segment(sctx, seg);
+
+   stream->num_frames = 0;
+   si_begin_sqtt(sctx, rcs);
+}
+
+static void si_sqtt_stream_begin(struct si_context *sctx)
+{
+   struct si_sqtt_stream *stream = sctx->sqtt_stream;
+   struct tm now;
+   time_t t;
+
+   /* A new stream can be triggered while the previous one is still being written. */
+   for (unsigned i = 0; i < ARRAY_SIZE(stream->segments); i++)
+      util_queue_fence_wait(&stream->segments[i].drained);
+
+   t = time(NULL);
+   now = *localtime(&t);
+
+   snprintf(stream->filename_prefix, sizeof(stream->filename_prefix),
+            "/tmp/%s_%04d.%02d.%02d_%02d.%02d.%02d", util_get_process_name(),
+            1900 + now.tm_year, now.tm_mon + 1, now.tm_mday, now.tm_hour, now.tm_min,
+            now.tm_sec);
+
+   stream->num_frames = 0;
+   stream->num_segments = 0;
+}
+
 bool si_init_sqtt(struct si_context *sctx)
 {
    static bool warn_once = true;
@@ -637,6 +859,9 @@ bool si_init_sqtt(struct si_context *sctx)
       debug_get_num_option("AMD_THREAD_TRACE_BUFFER_SIZE", 32 * 1024) * 1024;
    sctx->sqtt->start_frame = 10;
 
+   /* Record segments of this many frames continuously, instead of a single frame. */
+   unsigned frames_per_segment = debug_get_num_option("AMD_THREAD_TRACE_SEGMENT_FRAMES", 0);
+
    const char *trigger = getenv("AMD_THREAD_TRACE_TRIGGER");
    if (trigger) {
       sctx->sqtt->start_frame = atoi(trigger);
@@ -652,7 +877,8 @@ bool si_init_sqtt(struct si_context *sctx)
 
    ac_sqtt_init(sctx->sqtt);
 
-   if (sctx->gfx_level >= GFX10 &&
+   /* SPM isn't supported by continuous capture because both buffers would share its ring. */
+   if (sctx->gfx_level >= GFX10 && !frames_per_segment &&
        debug_get_bool_option("AMD_THREAD_TRACE_SPM", sctx->gfx_level < GFX11)) {
       /* Limit SPM counters to GFX10 and GFX10_3 for now */
       ASSERTED bool r = si_spm_init(sctx);
@@ -661,6 +887,9 @@ bool si_init_sqtt(struct si_context *sctx)
 
    si_sqtt_init_cs(sctx);
 
+   if (frames_per_segment && !si_sqtt_init_stream(sctx, frames_per_segment))
+      return false;
+
    sctx->sqtt_next_event = EventInvalid;
 
    return true;
@@ -669,6 +898,10 @@ bool si_init_sqtt(struct si_context *sctx)
 void si_destroy_sqtt(struct si_context *sctx)
 {
    struct si_screen *sscreen = sctx->screen;
+
+   if (sctx->sqtt_stream)
+      si_sqtt_destroy_stream(sctx);
+
    struct pb_buffer_lean *bo = sctx->sqtt->bo;
    radeon_bo_reference(sctx->screen->ws, &bo, NULL);
 
@@ -755,6 +988,9 @@ void si_handle_sqtt(struct si_context *sctx, struct radeon_cmdbuf *rcs)
          sctx->ws->fence_wait(sctx->ws, sctx->last_gfx_fence,
                               OS_TIMEOUT_INFINITE);
 
+         if (sctx->sqtt_stream)
+            si_sqtt_stream_begin(sctx);
+
          /* Start SQTT */
          si_begin_sqtt(sctx, rcs);
 
@@ -766,6 +1002,8 @@ void si_handle_sqtt(struct si_context *sctx, struct radeon_cmdbuf *rcs)
           */
          sctx->do_update_shaders = true;
       }
+   } else if (sctx->sqtt_stream) {
+      si_sqtt_stream_end_frame(sctx, rcs);
    } else {
       struct ac_sqtt_trace sqtt_trace = {0};
 
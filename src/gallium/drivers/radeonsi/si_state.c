@@ -754,6 +754,15 @@ static void si_bind_blend_state(struct pipe_context *ctx, void *state)
    if (!blend)
       blend = (struct si_state_blend *)sctx->noop_blend;
 
+   /* Blend registers aren't tracked, so binding a different blend state with the same packets
+    * (not all frontends deduplicate CSOs) would emit them again and roll the context. Treat its
+    * packets as emitted instead.
+    */
+   struct si_state_blend *emitted_blend = sctx->emitted.named.blend;
+   if (emitted_blend && emitted_blend != blend && emitted_blend->pm4.ndw == blend->pm4.ndw &&
+       !memcmp(emitted_blend->pm4.pm4, blend->pm4.pm4, blend->pm4.ndw * 4))
+      sctx->emitted.named.blend = blend;
+
    si_pm4_bind_state(sctx, blend, blend);
 
    if (old_blend->cb_target_mask != blend->cb_target_mask ||
@@ -518,6 +518,13 @@ struct si_descriptors {
    struct si_resource *buffer;
    uint64_t gpu_address;
 
+   /* A CPU copy of the last uploaded slots, used to skip uploads that wouldn't
+    * change anything. */
+   uint32_t *uploaded_list;
+   uint32_t uploaded_first_slot;
+   uint32_t uploaded_num_slots;
+   uint32_t uploaded_list_num_slots; /* the allocated size of uploaded_list */
+
    /* The maximum number of descriptors. */
    uint32_t num_elements;
 
@@ -2078,8 +2078,15 @@ static void si_draw(struct pipe_context *ctx,
 
    unsigned min_direct_count = 0;
    unsigned total_direct_count = 0;
+   struct pipe_draw_indirect_info compacted_indirect;
 
    if (!IS_DRAW_VERTEX_STATE && indirect) {
+      /* Remove empty draws from large multi-draws. DrawID would change, so it can't be used. */
+      if (unlikely(sctx->screen->debug_flags & DBG(COMPACT_DRAWS)) && indirect->buffer &&
+          indirect->draw_count >= SI_COMPACT_DRAWS_MIN_COUNT && !vs->info.uses_drawid &&
+          si_compute_compact_draws(sctx, indirect, index_size != 0, &compacted_indirect))
+         indirect = &compacted_indirect;
+
       /* Indirect buffers use TC L2 on GFX9, but not older hw. */
       if (GFX_VERSION <= GFX8) {
          if (indirect->buffer && si_resource(indirect->buffer)->TC_L2_dirty) {
@@ -2979,13 +2979,22 @@ current_not_ready:
     */
    si_shader_selector_reference(NULL, &shader->previous_stage_sel, previous_stage_sel);
 
-   /* Monolithic-only shaders don't make a distinction between optimized
-    * and unoptimized. */
    shader->is_monolithic =
       is_pure_monolithic || memcmp(&key->opt, &zeroed_key->opt, key_opt_size) != 0;
 
-   shader->is_optimized = !is_pure_monolithic &&
-                          memcmp(&key->opt, &zeroed_key->opt, key_opt_size) != 0;
+   /* Pure monolithic shaders are optimized variants too if they have "opt" flags, because
+    * the same monolithic variant without them is always a valid fallback. This prevents
+    * stalls when only the "opt" part of the key of a monolithic shader changes, such as
+    * inlined uniform values.
+    */
+   if (is_pure_monolithic) {
+      /* prefer_mono has no effect on monolithic shaders, don't compile them twice because of it. */
+      auto opt = key->opt;
+      opt.prefer_mono = 0;
+      shader->is_optimized = memcmp(&opt, &zeroed_key->opt, key_opt_size) != 0;
+   } else {
+      shader->is_optimized = shader->is_monolithic;
+   }
 
    /* If it's an optimized shader, compile it asynchronously. */
    if (shader->is_optimized) {
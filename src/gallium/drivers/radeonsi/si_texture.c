@@ -2442,9 +2442,27 @@ void si_init_screen_texture_functions(struct si_screen *sscreen)
    }
 }
 
+static void si_texture_subdata(struct pipe_context *ctx, struct pipe_resource *resource,
+                               unsigned level, unsigned usage, const struct pipe_box *box,
+                               const void *data, unsigned stride, uintptr_t layer_stride)
+{
+   struct si_context *sctx = (struct si_context *)ctx;
+   struct si_texture *tex = (struct si_texture *)resource;
+
+   /* Tiled textures would need a staging texture and a copy. Write them with a compute shader
+    * reading from the stream uploader instead. Linear textures are mapped directly.
+    */
+   if (!tex->surface.is_linear &&
+       si_compute_texture_upload(sctx, resource, level, box, data, stride, layer_stride))
+      return;
+
+   u_default_texture_subdata(ctx, resource, level, usage, box, data, stride, layer_stride);
+}
+
 void si_init_context_texture_functions(struct si_context *sctx)
 {
    sctx->b.texture_map = si_texture_transfer_map;
+   sctx->b.texture_subdata = si_texture_subdata;
    sctx->b.texture_unmap = si_texture_transfer_unmap;
    sctx->b.create_surface = si_create_surface;
    sctx->b.surface_destroy = si_surface_destroy;
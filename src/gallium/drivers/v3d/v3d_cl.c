@@ -60,13 +60,26 @@ v3d_cl_ensure_space(struct v3d_cl *cl, uint32_t space, uint32_t alignment)
         return 0;
 }
 
+/* Largest BO we grow a chained CL to, see v3d_cl_ensure_space_with_branch(). */
+#define V3D_CL_MAX_CHAINED_BO_SIZE (64 * 1024)
+
 void
 v3d_cl_ensure_space_with_branch(struct v3d_cl *cl, uint32_t space)
 {
         if (cl_offset(cl) + space + cl_packet_length(BRANCH) <= cl->size)
                 return;
 
-        struct v3d_bo *new_bo = v3d_bo_alloc(cl->job->v3d->screen, space, "CL");
+        /* Jobs that have already filled a BO (large scenes, redrawn every
+         * frame) will most likely keep going, so double the size of each
+         * new BO in the chain instead of allocating, mapping and branching
+         * to a new page every few dozen draws.
+         */
+        uint32_t size = space;
+        if (cl->bo)
+                size = MAX2(size, MIN2(cl->bo->size * 2,
+                                       V3D_CL_MAX_CHAINED_BO_SIZE));
+
+        struct v3d_bo *new_bo = v3d_bo_alloc(cl->job->v3d->screen, size, "CL");
         assert(space <= new_bo->size);
 
         /* Chain to the new BO from the old one. */
@@ -53,6 +53,7 @@ const struct debug_named_value virgl_debug_options[] = {
    { "nocoherent",      VIRGL_DEBUG_NO_COHERENT,             "Disable coherent memory" },
    { "video",           VIRGL_DEBUG_VIDEO,                   "Video codec" },
    { "shader_sync",     VIRGL_DEBUG_SHADER_SYNC,             "Sync after every shader link" },
+   { "blobstaging",     VIRGL_DEBUG_BLOB_STAGING,            "Use host-visible blob resources for upload staging" },
    DEBUG_NAMED_VALUE_END
 };
 DEBUG_GET_ONCE_FLAGS_OPTION(virgl_debug, "VIRGL_DEBUG", virgl_debug_options, 0)
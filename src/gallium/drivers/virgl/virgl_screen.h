@@ -41,6 +41,7 @@ enum virgl_debug_flags {
    VIRGL_DEBUG_L8_SRGB_ENABLE_READBACK = 1 << 8,
    VIRGL_DEBUG_VIDEO                = 1 << 9,
    VIRGL_DEBUG_SHADER_SYNC          = 1 << 10,
+   VIRGL_DEBUG_BLOB_STAGING         = 1 << 11,
 };
 
 extern const struct debug_named_value virgl_debug_options[];
@@ -56,8 +56,17 @@ virgl_staging_alloc_buffer(struct virgl_staging_mgr *staging, unsigned min_size)
                                           1,     /* array_size */
                                           0,     /* last_level */
                                           0,     /* nr_samples */
-                                          0,     /* flags */
+                                          staging->flags,
                                           size); /* size */
+
+   /* If the host can't give us a mappable blob, stop asking and go back to
+    * guest memory backed staging.
+    */
+   if (staging->hw_res == NULL && staging->flags) {
+      staging->flags = 0;
+      return virgl_staging_alloc_buffer(staging, min_size);
+   }
+
    if (staging->hw_res == NULL)
       return false;
 
@@ -81,6 +90,15 @@ virgl_staging_init(struct virgl_staging_mgr *staging, struct pipe_context *pipe,
 
    staging->vws = virgl_screen(pipe->screen)->vws;
    staging->default_size = default_size;
+
+   /* With a host-visible coherent blob as the staging buffer, uploads are
+    * written straight into host memory and the copy transfer reads them from
+    * there, instead of the host first pulling the data out of guest pages.
+    */
+   if ((virgl_debug & VIRGL_DEBUG_BLOB_STAGING) &&
+       pipe->screen->get_param(pipe->screen,
+                               PIPE_CAP_BUFFER_MAP_PERSISTENT_COHERENT))
+      staging->flags = VIRGL_RESOURCE_FLAG_MAP_COHERENT;
 }
 
 void
@@ -38,6 +38,7 @@ extern "C" {
 struct virgl_staging_mgr {
    struct virgl_winsys *vws;
    unsigned default_size;  /* Minimum size of the staging buffer, in bytes. */
+   uint32_t flags;  /* VIRGL_RESOURCE_FLAG_* for new staging buffers. */
    struct virgl_hw_res *hw_res;   /* Staging buffer hw_res. */
    unsigned size;   /* Current staging buffer size. */
    uint8_t *map;    /* Pointer to the mapped staging buffer. */
@@ -4856,6 +4856,8 @@ nir_to_spirv(struct nir_shader *s, const struct zink_shader_info *sinfo, uint32_
          goto fail;
    }
    ctx.num_defs = entry->ssa_alloc;
+   /* most ssa defs are a single instruction of ~4 words */
+   spirv_builder_reserve_instructions(&ctx.builder, entry->ssa_alloc * 4);
 
    SpvId *block_ids = ralloc_array_size(ctx.mem_ctx,
                                         sizeof(SpvId), entry->num_blocks);
@@ -57,7 +57,7 @@ static inline bool
 spirv_buffer_prepare(struct spirv_buffer *b, void *mem_ctx, size_t needed)
 {
    needed += b->num_words;
-   if (b->room >= b->num_words + needed)
+   if (b->room >= needed)
       return true;
 
    return spirv_buffer_grow(b, mem_ctx, needed);
@@ -77,16 +77,15 @@ spirv_buffer_emit_string(struct spirv_buffer *b, void *mem_ctx,
 {
    int pos = 0;
    uint32_t word = 0;
+   spirv_buffer_prepare(b, mem_ctx, 1 + strlen(str) / 4);
    while (str[pos] != '\0') {
       word |= str[pos] << (8 * (pos % 4));
       if (++pos % 4 == 0) {
-         spirv_buffer_prepare(b, mem_ctx, 1);
          spirv_buffer_emit_word(b, word);
          word = 0;
       }
    }
 
-   spirv_buffer_prepare(b, mem_ctx, 1);
    spirv_buffer_emit_word(b, word);
 
    return 1 + pos / 4;
@@ -1794,3 +1793,10 @@ spirv_builder_begin_local_vars(struct spirv_builder *b)
 {
    b->local_vars_begin = b->instructions.num_words;
 }
+
+/* grow the instruction stream once up front instead of repeatedly while emitting */
+void
+spirv_builder_reserve_instructions(struct spirv_builder *b, size_t num_words)
+{
+   spirv_buffer_prepare(&b->instructions, b->mem_ctx, num_words);
+}
@@ -492,4 +492,6 @@ void
 spirv_builder_end_primitive(struct spirv_builder *b, uint32_t stream, bool multistream);
 void
 spirv_builder_begin_local_vars(struct spirv_builder *b);
+void
+spirv_builder_reserve_instructions(struct spirv_builder *b, size_t num_words);
 #endif
@@ -1306,7 +1306,10 @@ zink_bo_init(struct zink_screen *screen)
                  (void*)bo_destroy, (void*)bo_can_reclaim);
 
    unsigned min_slab_order = MIN_SLAB_ORDER;  /* 256 bytes */
-   unsigned max_slab_order = 20; /* 1 MB (slab size = 2 MB) */
+   /* medium-sized resources (e.g. streamed textures) would otherwise each get
+    * their own VkDeviceMemory and quickly hit maxMemoryAllocationCount
+    */
+   unsigned max_slab_order = 22; /* 4 MB (slab size = 8 MB) */
    unsigned num_slab_orders_per_allocator = (max_slab_order - min_slab_order) /
                                             NUM_SLAB_ALLOCATORS;
 
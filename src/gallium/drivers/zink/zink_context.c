@@ -135,13 +135,15 @@ zink_context_destroy(struct pipe_context *pctx)
    }
 
    for (unsigned i = 0; i < ARRAY_SIZE(ctx->program_cache); i++) {
-      simple_mtx_lock((&ctx->program_lock[i]));
-      hash_table_foreach(&ctx->program_cache[i], entry) {
-         struct zink_program *pg = entry->data;
-         util_queue_fence_wait(&pg->cache_fence);
-         pg->removed = true;
+      util_sharded_hash_table_foreach_shard(&ctx->program_cache[i], shard) {
+         simple_mtx_lock(&shard->lock);
+         hash_table_foreach(&shard->table, entry) {
+            struct zink_program *pg = entry->data;
+            util_queue_fence_wait(&pg->cache_fence);
+            pg->removed = true;
+         }
+         simple_mtx_unlock(&shard->lock);
       }
-      simple_mtx_unlock((&ctx->program_lock[i]));
    }
 
    if (ctx->blitter)
@@ -248,9 +250,7 @@ zink_context_destroy(struct pipe_context *pctx)
    u_upload_destroy(pctx->const_uploader);
    slab_destroy_child(&ctx->transfer_pool);
    for (unsigned i = 0; i < ARRAY_SIZE(ctx->program_cache); i++)
-      _mesa_hash_table_clear(&ctx->program_cache[i], NULL);
-   for (unsigned i = 0; i < ARRAY_SIZE(ctx->program_lock); i++)
-      simple_mtx_destroy(&ctx->program_lock[i]);
+      util_sharded_hash_table_fini(&ctx->program_cache[i], NULL);
    _mesa_hash_table_destroy(ctx->render_pass_cache, NULL);
    slab_destroy_child(&ctx->transfer_pool_unsync);
 
@@ -2792,8 +2792,13 @@ begin_rendering(struct zink_context *ctx)
             ctx->dynamic_fb.attachments[PIPE_MAX_COLOR_BUFS].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 
          if (use_tc_info) {
-            if (ctx->dynamic_fb.tc_info.zsbuf_invalidate)
+            const struct tc_renderpass_info *info = &ctx->dynamic_fb.tc_info;
+            if (info->zsbuf_invalidate)
                ctx->dynamic_fb.attachments[PIPE_MAX_COLOR_BUFS].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            /* read-only zsbuf: nothing to write back, which saves bandwidth on tilers */
+            else if (zink_screen(ctx->base.screen)->info.have_vulkan13 && !zink_fb_clear_enabled(ctx, PIPE_MAX_COLOR_BUFS) &&
+                     !(info->zsbuf_clear | info->zsbuf_clear_partial | info->zsbuf_write_fs | info->zsbuf_write_dsa))
+               ctx->dynamic_fb.attachments[PIPE_MAX_COLOR_BUFS].storeOp = VK_ATTACHMENT_STORE_OP_NONE;
             else
                ctx->dynamic_fb.attachments[PIPE_MAX_COLOR_BUFS].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
          }
@@ -5647,6 +5652,7 @@ zink_context_create(struct pipe_screen *pscreen, void *priv, unsigned flags)
                                                         .parse_renderpass_info = screen->driver_workarounds.track_renderpasses,
                                                         .dsa_parse = zink_tc_parse_dsa,
                                                         .fs_parse = zink_tc_parse_fs,
+                                                        .adaptive_batch_size = screen->driconf.tc_adaptive_batches,
                                                      },
                                                      &ctx->tc);
 
@@ -5735,6 +5741,7 @@ zink_update_barriers(struct zink_context *ctx, bool is_compute,
    ctx->barrier_set_idx[is_compute] = !ctx->barrier_set_idx[is_compute];
    ctx->need_barriers[is_compute] = &ctx->update_barriers[is_compute][ctx->barrier_set_idx[is_compute]];
    ASSERTED bool check_rp = ctx->batch.in_rp && ctx->dynamic_fb.tc_info.zsbuf_invalidate;
+   zink_barrier_batch_begin(ctx);
    set_foreach(need_barriers, he) {
       struct zink_resource *res = (struct zink_resource *)he->key;
       if (res->bind_count[is_compute]) {
@@ -5766,6 +5773,7 @@ zink_update_barriers(struct zink_context *ctx, bool is_compute,
       if (!need_barriers->entries)
          break;
    }
+   zink_barrier_batch_end(ctx);
 }
 
 /**
@@ -105,6 +105,10 @@ bool
 zink_check_batch_completion(struct zink_context *ctx, uint64_t batch_id);
 VkCommandBuffer
 zink_get_cmdbuf(struct zink_context *ctx, struct zink_resource *src, struct zink_resource *dst);
+void
+zink_barrier_batch_begin(struct zink_context *ctx);
+void
+zink_barrier_batch_end(struct zink_context *ctx);
 unsigned
 zink_update_rendering_info(struct zink_context *ctx);
 void
@@ -315,6 +315,8 @@ init_db_template_entry(struct zink_screen *screen, struct zink_shader *shader, e
     int index = shader->bindings[type][idx].index;
     gl_shader_stage stage = clamp_stage(&shader->info);
     entry->count = shader->bindings[type][idx].size;
+    entry->stage = stage;
+    entry->index = index;
 
     switch (shader->bindings[type][idx].type) {
     case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
@@ -1142,6 +1144,35 @@ update_separable(struct zink_context *ctx, struct zink_program *pg)
    }
 }
 
+/* slots past the mask width share the last bit */
+static inline uint32_t
+db_slot_mask(unsigned start, unsigned count)
+{
+   start = MIN2(start, 31);
+   return u_bit_consecutive(start, MIN2(MAX2(count, 1), 32 - start));
+}
+
+/* returns the host copy of the set's descriptor data:
+ * if the shadowed data was written for a different layout, everything is dirty
+ */
+static uint8_t *
+get_db_shadow(struct zink_context *ctx, struct zink_program *pg, enum zink_descriptor_type type, bool *full)
+{
+   bool is_compute = pg->is_compute;
+   uint32_t size = pg->dd.db_size[type];
+   *full = ctx->dd.db_shadow_dsl[is_compute][type] != pg->dsl[type + 1];
+   if (ctx->dd.db_shadow_size[is_compute][type] < size) {
+      uint8_t *shadow = realloc(ctx->dd.db_shadow[is_compute][type], size);
+      if (!shadow)
+         return NULL;
+      ctx->dd.db_shadow[is_compute][type] = shadow;
+      ctx->dd.db_shadow_size[is_compute][type] = size;
+      *full = true;
+   }
+   ctx->dd.db_shadow_dsl[is_compute][type] = pg->dsl[type + 1];
+   return ctx->dd.db_shadow[is_compute][type];
+}
+
 /* updates the mask of changed_sets and binds the mask of bind_sets */
 static void
 zink_descriptors_update_masked_buffer(struct zink_context *ctx, bool is_compute, uint8_t changed_sets, uint8_t bind_sets)
@@ -1168,21 +1199,31 @@ zink_descriptors_update_masked_buffer(struct zink_context *ctx, bool is_compute,
          info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
          info.pNext = NULL;
          assert(bs->dd.db->base.b.width0 > bs->dd.db_offset + pg->dd.db_size[type]);
+         /* descriptors are written to the host copy and only for the slots which changed,
+          * then the whole set is copied to the ring in one go
+          */
+         bool full;
+         uint8_t *shadow = get_db_shadow(ctx, pg, type, &full);
+         uint8_t *base = shadow ? shadow : bs->dd.db_map + offset;
+         full |= !shadow;
          for (unsigned i = 0; i < key->num_bindings; i++) {
+            const struct zink_descriptor_template *t = &pg->dd.db_template[type][i];
+            if (!full && !(ctx->dd.db_dirty[type][t->stage] & db_slot_mask(t->index, t->count)))
+               continue;
             info.type = key->bindings[i].descriptorType;
-            uint64_t desc_offset = offset + pg->dd.db_offset[type][i];
+            uint64_t desc_offset = pg->dd.db_offset[type][i];
             if (screen->info.db_props.combinedImageSamplerDescriptorSingleArray ||
                 key->bindings[i].descriptorType != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
                 key->bindings[i].descriptorCount == 1) {
                for (unsigned j = 0; j < key->bindings[i].descriptorCount; j++) {
                   /* VkDescriptorDataEXT is a union of pointers; the member doesn't matter */
-                  info.data.pSampler = (void*)(((uint8_t*)ctx) + pg->dd.db_template[type][i].offset + j * pg->dd.db_template[type][i].stride);
-                  VKSCR(GetDescriptorEXT)(screen->dev, &info, pg->dd.db_template[type][i].db_size, bs->dd.db_map + desc_offset + j * pg->dd.db_template[type][i].db_size);
+                  info.data.pSampler = (void*)(((uint8_t*)ctx) + t->offset + j * t->stride);
+                  VKSCR(GetDescriptorEXT)(screen->dev, &info, t->db_size, base + desc_offset + j * t->db_size);
                }
             } else {
                assert(key->bindings[i].descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
                char buf[1024];
-               uint8_t *db = bs->dd.db_map + desc_offset;
+               uint8_t *db = base + desc_offset;
                uint8_t *samplers = db + key->bindings[i].descriptorCount * screen->info.db_props.sampledImageDescriptorSize;
                for (unsigned j = 0; j < key->bindings[i].descriptorCount; j++) {
                   /* VkDescriptorDataEXT is a union of pointers; the member doesn't matter */
@@ -1202,6 +1243,12 @@ zink_descriptors_update_masked_buffer(struct zink_context *ctx, bool is_compute,
                }
             }
          }
+         if (shadow)
+            memcpy(bs->dd.db_map + offset, shadow, pg->dd.db_size[type]);
+         if (is_compute)
+            ctx->dd.db_dirty[type][MESA_SHADER_COMPUTE] = 0;
+         else
+            memset(ctx->dd.db_dirty[type], 0, ZINK_GFX_SHADER_COUNT * sizeof(uint32_t));
          bs->dd.cur_db_offset[type] = bs->dd.db_offset;
          bs->dd.db_offset += pg->dd.db_size[type];
       }
@@ -1306,6 +1353,8 @@ zink_descriptors_update(struct zink_context *ctx, bool is_compute)
       /* update all sets and bind null sets */
       ctx->dd.state_changed[is_compute] = pg->dd.binding_usage & BITFIELD_MASK(ZINK_DESCRIPTOR_TYPE_UNIFORMS);
       ctx->dd.push_state_changed[is_compute] = !!pg->dd.push_usage || ctx->dd.has_fbfetch != bs->dd.has_fbfetch;
+      /* fully rewrite the first set of each batch */
+      memset(ctx->dd.db_shadow_dsl[is_compute], 0, sizeof(ctx->dd.db_shadow_dsl[is_compute]));
    }
 
    if (!is_compute) {
@@ -1462,8 +1511,10 @@ zink_context_invalidate_descriptor_state(struct zink_context *ctx, gl_shader_sta
 {
    if (type == ZINK_DESCRIPTOR_TYPE_UBO && !start)
       ctx->dd.push_state_changed[shader == MESA_SHADER_COMPUTE] = true;
-   else
+   else {
       ctx->dd.state_changed[shader == MESA_SHADER_COMPUTE] |= BITFIELD_BIT(type);
+      ctx->dd.db_dirty[type][shader] |= db_slot_mask(start, count);
+   }
 }
 void
 zink_context_invalidate_descriptor_state_compact(struct zink_context *ctx, gl_shader_stage shader, enum zink_descriptor_type type, unsigned start, unsigned count)
@@ -1474,6 +1525,8 @@ zink_context_invalidate_descriptor_state_compact(struct zink_context *ctx, gl_sh
       if (type > ZINK_DESCRIPTOR_TYPE_SAMPLER_VIEW)
          type -= ZINK_DESCRIPTOR_COMPACT;
       ctx->dd.state_changed[shader == MESA_SHADER_COMPUTE] |= BITFIELD_BIT(type);
+      /* merged types share the slot mask: this only costs spurious rewrites */
+      ctx->dd.db_dirty[type][shader] |= db_slot_mask(start, count);
    }
 }
 
@@ -1665,6 +1718,10 @@ zink_descriptors_deinit(struct zink_context *ctx)
       VKSCR(DestroyDescriptorSetLayout)(screen->dev, ctx->dd.push_dsl[0]->layout, NULL);
    if (ctx->dd.push_dsl[1])
       VKSCR(DestroyDescriptorSetLayout)(screen->dev, ctx->dd.push_dsl[1]->layout, NULL);
+   for (unsigned i = 0; i < 2; i++) {
+      for (unsigned j = 0; j < ZINK_DESCRIPTOR_BASE_TYPES; j++)
+         free(ctx->dd.db_shadow[i][j]);
+   }
 }
 
 /* called on screen creation */
@@ -95,6 +95,14 @@ EXTENSIONS = [
     Extension("VK_EXT_queue_family_foreign"),
     Extension("VK_KHR_swapchain_mutable_format"),
     Extension("VK_KHR_incremental_present"),
+    Extension("VK_KHR_present_id",
+              alias="present_id",
+              features=True,
+              conditions=["$feats.presentId"]),
+    Extension("VK_KHR_present_wait",
+              alias="present_wait",
+              features=True,
+              conditions=["$feats.presentWait"]),
     Extension("VK_EXT_provoking_vertex",
               alias="pv",
               features=True,
@@ -18,6 +18,21 @@
 #include "util/u_inlines.h"
 #include "util/u_prim.h"
 #include "util/u_prim_restart.h"
+#include "util/os_time.h"
+
+/* ZINK_DEBUG=drawtime: accumulate the CPU time of draw sections for the HUD */
+ALWAYS_INLINE static int64_t
+draw_timer_begin(void)
+{
+   return unlikely(zink_debug & ZINK_DEBUG_DRAWTIME) ? os_time_get_nano() : 0;
+}
+
+ALWAYS_INLINE static void
+draw_timer_end(struct zink_context *ctx, enum zink_draw_timer timer, int64_t start)
+{
+   if (unlikely(zink_debug & ZINK_DEBUG_DRAWTIME))
+      ctx->hud.draw_time[timer] += os_time_get_nano() - start;
+}
 
 static void
 zink_emit_xfb_counter_barrier(struct zink_context *ctx)
@@ -568,10 +583,12 @@ zink_draw(struct pipe_context *pctx,
       }
    }
 
+   int64_t timer_start = draw_timer_begin();
    barrier_draw_buffers(ctx, dinfo, dindirect, index_buffer);
    /* this may re-emit draw buffer barriers, but such synchronization is harmless */
    if (!ctx->blitting)
       zink_update_barriers(ctx, false, index_buffer, dindirect ? dindirect->buffer : NULL, dindirect ? dindirect->indirect_draw_count : NULL);
+   draw_timer_end(ctx, ZINK_DRAW_TIMER_BARRIERS, timer_start);
 
    bool can_dgc = false;
    if (unlikely(zink_debug & ZINK_DEBUG_DGC))
@@ -682,7 +699,9 @@ zink_draw(struct pipe_context *pctx,
    if (have_streamout && ctx->dirty_so_targets)
       zink_emit_stream_output_targets(pctx);
 
+   timer_start = draw_timer_begin();
    bool pipeline_changed = update_gfx_pipeline<DYNAMIC_STATE, BATCH_CHANGED>(ctx, batch->state, mode, can_dgc);
+   draw_timer_end(ctx, ZINK_DRAW_TIMER_PIPELINE, timer_start);
 
    if (BATCH_CHANGED || ctx->vp_state_changed || (DYNAMIC_STATE == ZINK_NO_DYNAMIC_STATE && pipeline_changed)) {
       VkViewport viewports[PIPE_MAX_VIEWPORTS];
@@ -912,6 +931,7 @@ zink_draw(struct pipe_context *pctx,
       ctx->rasterizer_discard_changed = false;
    }
 
+   timer_start = draw_timer_begin();
    if (zink_program_has_descriptors(&ctx->curr_program->base))
       zink_descriptors_update(ctx, false);
 
@@ -920,6 +940,7 @@ zink_draw(struct pipe_context *pctx,
        zink_program_has_descriptors(&ctx->curr_program->base) &&
        ctx->curr_program->base.dd.bindless)
       zink_descriptors_update_bindless(ctx);
+   draw_timer_end(ctx, ZINK_DRAW_TIMER_DESCRIPTORS, timer_start);
 
    if (reads_basevertex) {
       unsigned draw_mode_is_indexed = index_size > 0;
@@ -1037,6 +1058,7 @@ zink_draw(struct pipe_context *pctx,
       }
    }
 
+   timer_start = draw_timer_begin();
    bool needs_drawid = reads_drawid && zink_get_last_vertex_key(ctx)->push_drawid;
    work_count += num_draws;
    if (index_size > 0) {
@@ -1102,6 +1124,7 @@ zink_draw(struct pipe_context *pctx,
             draw<HAS_MULTIDRAW>(ctx, dinfo, draws, num_draws, drawid_offset, needs_drawid);
       }
    }
+   draw_timer_end(ctx, ZINK_DRAW_TIMER_CMDS, timer_start);
 
    if (unlikely(zink_tracing))
       zink_cmd_debug_marker_end(ctx, batch->state->cmdbuf, marker);
@@ -1493,16 +1516,14 @@ zink_init_draw_functions(struct zink_context *ctx, struct zink_screen *screen)
    ctx->base.draw_vbo = zink_invalid_draw_vbo;
    ctx->base.draw_vertex_state = zink_invalid_draw_vertex_state;
 
-   _mesa_hash_table_init(&ctx->program_cache[0], ctx, hash_gfx_program<0>, equals_gfx_program<0>);
-   _mesa_hash_table_init(&ctx->program_cache[1], ctx, hash_gfx_program<1>, equals_gfx_program<1>);
-   _mesa_hash_table_init(&ctx->program_cache[2], ctx, hash_gfx_program<2>, equals_gfx_program<2>);
-   _mesa_hash_table_init(&ctx->program_cache[3], ctx, hash_gfx_program<3>, equals_gfx_program<3>);
-   _mesa_hash_table_init(&ctx->program_cache[4], ctx, hash_gfx_program<4>, equals_gfx_program<4>);
-   _mesa_hash_table_init(&ctx->program_cache[5], ctx, hash_gfx_program<5>, equals_gfx_program<5>);
-   _mesa_hash_table_init(&ctx->program_cache[6], ctx, hash_gfx_program<6>, equals_gfx_program<6>);
-   _mesa_hash_table_init(&ctx->program_cache[7], ctx, hash_gfx_program<7>, equals_gfx_program<7>);
-   for (unsigned i = 0; i < ARRAY_SIZE(ctx->program_lock); i++)
-      simple_mtx_init(&ctx->program_lock[i], mtx_plain);
+   util_sharded_hash_table_init(&ctx->program_cache[0], ctx, hash_gfx_program<0>, equals_gfx_program<0>);
+   util_sharded_hash_table_init(&ctx->program_cache[1], ctx, hash_gfx_program<1>, equals_gfx_program<1>);
+   util_sharded_hash_table_init(&ctx->program_cache[2], ctx, hash_gfx_program<2>, equals_gfx_program<2>);
+   util_sharded_hash_table_init(&ctx->program_cache[3], ctx, hash_gfx_program<3>, equals_gfx_program<3>);
+   util_sharded_hash_table_init(&ctx->program_cache[4], ctx, hash_gfx_program<4>, equals_gfx_program<4>);
+   util_sharded_hash_table_init(&ctx->program_cache[5], ctx, hash_gfx_program<5>, equals_gfx_program<5>);
+   util_sharded_hash_table_init(&ctx->program_cache[6], ctx, hash_gfx_program<6>, equals_gfx_program<6>);
+   util_sharded_hash_table_init(&ctx->program_cache[7], ctx, hash_gfx_program<7>, equals_gfx_program<7>);
 }
 
 void
@@ -31,19 +31,36 @@
 #include "zink_resource.h"
 #include "zink_kopper.h"
 
+/* upper bound for waiting on a present, so that occluded windows still make progress */
+#define KOPPER_PACE_TIMEOUT (100 * 1000 * 1000)
+
+static bool
+can_pace_presents(const struct zink_screen *screen)
+{
+   return screen->info.have_KHR_present_id && screen->info.have_KHR_present_wait &&
+          !(zink_debug & ZINK_DEBUG_NOPACE);
+}
+
 static void
-zink_kopper_set_present_mode_for_interval(struct kopper_displaytarget *cdt, int interval)
+zink_kopper_set_present_mode_for_interval(struct zink_screen *screen, struct kopper_displaytarget *cdt, int interval)
 {
 #if DETECT_OS_WINDOWS
     // not hooked up yet so let's not sabotage benchmarks
     cdt->present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
 #else
    assert(interval >= 0); /* TODO: VK_PRESENT_MODE_FIFO_RELAXED_KHR */
+   cdt->pace_presents = interval > 0 && can_pace_presents(screen);
    if (interval == 0) {
       if (cdt->present_modes & BITFIELD_BIT(VK_PRESENT_MODE_IMMEDIATE_KHR))
          cdt->present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
       else
          cdt->present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+   } else if (interval == 1 && cdt->pace_presents &&
+              (cdt->present_modes & BITFIELD_BIT(VK_PRESENT_MODE_MAILBOX_KHR))) {
+      /* mailbox doesn't tear either, and with kopper_pace() throttling to
+       * the display there is one frame less of latency than with FIFO
+       */
+      cdt->present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
    } else if (interval > 0) {
       cdt->present_mode = VK_PRESENT_MODE_FIFO_KHR;
    }
@@ -157,7 +174,7 @@ kopper_CreateSurface(struct zink_screen *screen, struct kopper_displaytarget *cd
          cdt->present_modes |= BITFIELD_BIT(modes[i]);
    }
 
-   zink_kopper_set_present_mode_for_interval(cdt, cdt->info.initial_swap_interval);
+   zink_kopper_set_present_mode_for_interval(screen, cdt, cdt->info.initial_swap_interval);
 
    return surface;
 fail:
@@ -558,6 +575,29 @@ zink_kopper_displaytarget_destroy(struct zink_screen *screen, struct kopper_disp
    FREE(cdt);
 }
 
+/* Limits how far ahead of the display the application can get, using the
+ * ids of VK_KHR_present_id.  FIFO already blocks once all images are queued,
+ * so only keep it from queueing more than one frame.  Mailbox never blocks,
+ * so wait for the last frame to be displayed before starting the next one.
+ */
+static void
+kopper_pace(struct zink_screen *screen, struct kopper_swapchain *cswap)
+{
+   const uint64_t queued = cswap->scci.presentMode == VK_PRESENT_MODE_MAILBOX_KHR ? 0 : 1;
+   if (cswap->present_id <= queued)
+      return;
+
+   /* the present has to be submitted before it can be waited on, and this
+    * also keeps the present thread off the swapchain during the wait
+    */
+   if (util_queue_is_initialized(&screen->flush_queue))
+      util_queue_fence_wait(&cswap->present_fence);
+
+   /* timeouts and errors are left for the acquire to deal with */
+   VKSCR(WaitForPresentKHR)(screen->dev, cswap->swapchain, cswap->present_id - queued,
+                            KOPPER_PACE_TIMEOUT);
+}
+
 static VkResult
 kopper_acquire(struct zink_screen *screen, struct zink_resource *res, uint64_t timeout)
 {
@@ -575,6 +615,9 @@ kopper_acquire(struct zink_screen *screen, struct zink_resource *res, uint64_t t
       return VK_SUCCESS;
    VkSemaphore acquire = VK_NULL_HANDLE;
 
+   if (timeout == UINT64_MAX && cdt->pace_presents && !res->obj->new_dt)
+      kopper_pace(screen, cdt->swapchain);
+
    while (true) {
       if (res->obj->new_dt) {
          VkResult error = update_swapchain(screen, cdt, res->base.b.width0, res->base.b.height0);
@@ -895,6 +938,14 @@ zink_kopper_present_queue(struct zink_screen *screen, struct zink_resource *res,
       }
       cpi->info.pNext = &cpi->rinfo;
    }
+   if (screen->info.have_KHR_present_id) {
+      cpi->present_id = ++cdt->swapchain->present_id;
+      cpi->pid.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+      cpi->pid.pNext = cpi->info.pNext;
+      cpi->pid.swapchainCount = 1;
+      cpi->pid.pPresentIds = &cpi->present_id;
+      cpi->info.pNext = &cpi->pid;
+   }
    /* Ex GLX_EXT_buffer_age:
     *
     *  Buffers' ages are initialized to 0 at buffer creation time.
@@ -1167,7 +1218,7 @@ zink_kopper_set_swap_interval(struct pipe_screen *pscreen, struct pipe_resource
    struct kopper_displaytarget *cdt = res->obj->dt;
    VkPresentModeKHR old_present_mode = cdt->present_mode;
 
-   zink_kopper_set_present_mode_for_interval(cdt, interval);
+   zink_kopper_set_present_mode_for_interval(screen, cdt, interval);
 
    if (old_present_mode != cdt->present_mode)
       update_swapchain(screen, cdt, cdt->caps.currentExtent.width, cdt->caps.currentExtent.height);
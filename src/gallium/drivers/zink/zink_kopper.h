@@ -63,6 +63,8 @@ struct kopper_swapchain {
    unsigned num_acquires;
    unsigned max_acquires;
    unsigned async_presents;
+   /* VK_KHR_present_id of the last queued present */
+   uint64_t present_id;
    struct util_queue_fence present_fence;
    struct zink_batch_usage *batch_uses;
    struct kopper_swapchain_image *images;
@@ -97,6 +99,7 @@ struct kopper_displaytarget
    enum kopper_type type;
    bool is_kill;
    VkPresentModeKHR present_mode;
+   bool pace_presents; //wait for VK_KHR_present_wait before acquiring
    unsigned readback_counter;
 
    bool age_locked; //disables buffer age during readback
@@ -107,6 +110,8 @@ struct zink_kopper_present_info {
    VkPresentRegionsKHR rinfo;
    VkPresentRegionKHR region;
    VkRectLayerKHR regions[64];
+   VkPresentIdKHR pid;
+   uint64_t present_id;
    uint32_t image;
    struct kopper_swapchain *swapchain;
    struct zink_resource *res;
@@ -237,10 +237,10 @@ get_shader_module_for_stage(struct zink_context *ctx, struct zink_screen *screen
 }
 
 ALWAYS_INLINE static struct zink_shader_module *
-create_shader_module_for_stage_optimal(struct zink_context *ctx, struct zink_screen *screen,
-                                       struct zink_shader *zs, struct zink_gfx_program *prog,
-                                       gl_shader_stage stage,
-                                       struct zink_gfx_pipeline_state *state)
+compile_shader_module_for_stage_optimal(struct zink_context *ctx, struct zink_screen *screen,
+                                        struct zink_shader *zs, struct zink_gfx_program *prog,
+                                        gl_shader_stage stage,
+                                        struct zink_gfx_pipeline_state *state)
 {
    struct zink_shader_module *zm;
    uint16_t *key;
@@ -288,8 +288,25 @@ create_shader_module_for_stage_optimal(struct zink_context *ctx, struct zink_scr
       if (unlikely(shadow_needs_shader_swizzle))
          memcpy(&data[1], &ctx->di.zs_swizzle[stage], sizeof(struct zink_zs_swizzle_key));
    }
+   return zm;
+}
+
+static void
+add_shader_module_for_stage_optimal(struct zink_gfx_program *prog, gl_shader_stage stage, struct zink_shader_module *zm)
+{
    zm->default_variant = !util_dynarray_contains(&prog->shader_cache[stage][0][0], void*);
    util_dynarray_append(&prog->shader_cache[stage][0][0], void*, zm);
+}
+
+static struct zink_shader_module *
+create_shader_module_for_stage_optimal(struct zink_context *ctx, struct zink_screen *screen,
+                                       struct zink_shader *zs, struct zink_gfx_program *prog,
+                                       gl_shader_stage stage,
+                                       struct zink_gfx_pipeline_state *state)
+{
+   struct zink_shader_module *zm = compile_shader_module_for_stage_optimal(ctx, screen, zs, prog, stage, state);
+   if (zm)
+      add_shader_module_for_stage_optimal(prog, stage, zm);
    return zm;
 }
 
@@ -609,9 +626,8 @@ zink_gfx_program_update(struct zink_context *ctx)
    if (ctx->gfx_dirty) {
       struct zink_gfx_program *prog = NULL;
 
-      simple_mtx_lock(&ctx->program_lock[zink_program_cache_stages(ctx->shader_stages)]);
-      struct hash_table *ht = &ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)];
       const uint32_t hash = ctx->gfx_hash;
+      struct hash_table *ht = util_sharded_hash_table_lock(&ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)], hash);
       struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(ht, hash, ctx->gfx_stages);
       /* this must be done before prog is updated */
       if (ctx->curr_program)
@@ -633,7 +649,7 @@ zink_gfx_program_update(struct zink_context *ctx)
          prog->base.removed = false;
          generate_gfx_program_modules(ctx, zink_screen(ctx->base.screen), prog, &ctx->gfx_pipeline_state);
       }
-      simple_mtx_unlock(&ctx->program_lock[zink_program_cache_stages(ctx->shader_stages)]);
+      util_sharded_hash_table_unlock(&ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)], hash);
       if (prog && prog != ctx->curr_program)
          zink_batch_reference_program(&ctx->batch, &prog->base);
       ctx->curr_program = prog;
@@ -721,9 +737,8 @@ zink_gfx_program_update_optimal(struct zink_context *ctx)
    if (ctx->gfx_dirty) {
       struct zink_gfx_program *prog = NULL;
       ctx->gfx_pipeline_state.optimal_key = zink_sanitize_optimal_key(ctx->gfx_stages, ctx->gfx_pipeline_state.shader_keys_optimal.key.val);
-      struct hash_table *ht = &ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)];
       const uint32_t hash = ctx->gfx_hash;
-      simple_mtx_lock(&ctx->program_lock[zink_program_cache_stages(ctx->shader_stages)]);
+      struct hash_table *ht = util_sharded_hash_table_lock(&ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)], hash);
       struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(ht, hash, ctx->gfx_stages);
 
       if (ctx->curr_program)
@@ -754,7 +769,7 @@ zink_gfx_program_update_optimal(struct zink_context *ctx)
             generate_gfx_program_modules_optimal(ctx, screen, prog, &ctx->gfx_pipeline_state);
          }
       }
-      simple_mtx_unlock(&ctx->program_lock[zink_program_cache_stages(ctx->shader_stages)]);
+      util_sharded_hash_table_unlock(&ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)], hash);
       if (prog && prog != ctx->curr_program)
          zink_batch_reference_program(&ctx->batch, &prog->base);
       ctx->curr_program = prog;
@@ -771,12 +786,11 @@ zink_gfx_program_update_optimal(struct zink_context *ctx)
          util_queue_fence_wait(&prog->base.cache_fence);
          /* shader variants can't be handled by separable programs: sync and compile */
          perf_debug(ctx, "zink[gfx_compile]: non-default shader variant required with separate shader object program\n");
-         struct hash_table *ht = &ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)];
          const uint32_t hash = ctx->gfx_hash;
-         simple_mtx_lock(&ctx->program_lock[zink_program_cache_stages(ctx->shader_stages)]);
+         struct hash_table *ht = util_sharded_hash_table_lock(&ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)], hash);
          struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(ht, hash, ctx->gfx_stages);
          ctx->curr_program = replace_separable_prog(ctx, entry, prog);
-         simple_mtx_unlock(&ctx->program_lock[zink_program_cache_stages(ctx->shader_stages)]);
+         util_sharded_hash_table_unlock(&ctx->program_cache[zink_program_cache_stages(ctx->shader_stages)], hash);
       }
       update_gfx_program_optimal(ctx, ctx->curr_program);
       /* apply new hash */
@@ -2099,22 +2113,130 @@ print_pipeline_stats(struct zink_screen *screen, VkPipeline pipeline, struct uti
    }
 }
 
+/* precompile the pipeline library variants which were needed on previous runs;
+ * caller must have generated the default modules
+ */
+static void
+warm_gfx_program(struct zink_screen *screen, struct zink_gfx_program *prog)
+{
+   uint32_t keys[ZINK_MAX_WARM_KEYS];
+   unsigned count = zink_screen_get_pipeline_warm_keys(screen, prog, keys);
+   if (!count)
+      return;
+
+   simple_mtx_lock(&prog->libs->lock);
+   /* keep the stored list intact when new variants are recorded later */
+   memcpy(prog->warm_keys, keys, count * sizeof(uint32_t));
+   prog->num_warm_keys = prog->num_warm_keys_stored = count;
+   simple_mtx_unlock(&prog->libs->lock);
+
+   /* generated tcs variants need the context's patch vertices */
+   if (prog->shaders[MESA_SHADER_TESS_CTRL] && prog->shaders[MESA_SHADER_TESS_CTRL]->non_fs.is_generated)
+      return;
+
+   struct zink_shader_object default_objs[ZINK_GFX_SHADER_COUNT];
+   memcpy(default_objs, prog->objs, sizeof(prog->objs));
+   for (unsigned i = 0; i < count; i++) {
+      struct zink_gfx_pipeline_state state = {0};
+      state.shader_keys_optimal.key.val = keys[i];
+      state.optimal_key = keys[i];
+      /* shadow swizzles need context data, and stale keys are useless */
+      if (state.shader_keys_optimal.key.fs.shadow_needs_shader_swizzle ||
+          keys[i] != zink_sanitize_optimal_key(prog->shaders, keys[i]))
+         continue;
+
+      simple_mtx_lock(&prog->libs->lock);
+      bool found = _mesa_set_search(&prog->libs->libs, &state.optimal_key) != NULL;
+      simple_mtx_unlock(&prog->libs->lock);
+      if (found)
+         continue;
+
+      bool valid = true;
+      for (unsigned j = 0; j < MESA_SHADER_COMPUTE && valid; j++) {
+         if (!(prog->stages_present & BITFIELD_BIT(j)))
+            continue;
+         uint16_t bits;
+         if (prog->shaders[j] == prog->last_vertex_stage)
+            bits = state.shader_keys_optimal.key.vs_bits;
+         else if (j == MESA_SHADER_FRAGMENT)
+            bits = state.shader_keys_optimal.key.fs_bits;
+         else
+            continue;
+         struct zink_shader_module *zm = NULL;
+         util_dynarray_foreach(&prog->shader_cache[j][0][0], struct zink_shader_module *, pzm) {
+            if ((*pzm)->key_size && !memcmp((*pzm)->key, &bits, sizeof(uint16_t))) {
+               zm = *pzm;
+               break;
+            }
+         }
+         if (!zm)
+            zm = create_shader_module_for_stage_optimal(NULL, screen, prog->shaders[j], prog, j, &state);
+         if (zm)
+            prog->objs[j] = zm->obj;
+         else
+            valid = false;
+      }
+      if (valid) {
+         simple_mtx_lock(&prog->libs->lock);
+         zink_create_pipeline_lib(screen, prog, &state);
+         simple_mtx_unlock(&prog->libs->lock);
+      }
+      memcpy(prog->objs, default_objs, sizeof(prog->objs));
+   }
+}
+
+static void
+init_precompile_state(struct zink_gfx_pipeline_state *state)
+{
+   memset(state, 0, sizeof(*state));
+   state->shader_keys_optimal.key.vs_base.last_vertex_stage = true;
+   state->shader_keys_optimal.key.tcs.patch_vertices = 3; //random guess, generated tcs precompile is hard
+   state->optimal_key = state->shader_keys_optimal.key.val;
+}
+
+/* compiles the default variant of a single stage for precompile_job() */
+static void
+precompile_stage_job(void *data, void *gdata, int thread_index)
+{
+   struct zink_screen *screen = gdata;
+   struct zink_gfx_stage_precompile *sp = data;
+   struct zink_gfx_program *prog = sp->prog;
+
+   struct zink_gfx_pipeline_state state;
+   init_precompile_state(&state);
+   sp->zm = compile_shader_module_for_stage_optimal(NULL, screen, prog->shaders[sp->stage], prog, sp->stage, &state);
+}
+
 static void
 precompile_job(void *data, void *gdata, int thread_index)
 {
    struct zink_screen *screen = gdata;
    struct zink_gfx_program *prog = data;
 
-   struct zink_gfx_pipeline_state state = {0};
-   state.shader_keys_optimal.key.vs_base.last_vertex_stage = true;
-   state.shader_keys_optimal.key.tcs.patch_vertices = 3; //random guess, generated tcs precompile is hard
-   state.optimal_key = state.shader_keys_optimal.key.val;
-   generate_gfx_program_modules_optimal(NULL, screen, prog, &state);
+   struct zink_gfx_pipeline_state state;
+   init_precompile_state(&state);
+   if (prog->precompile_stages) {
+      /* stage jobs were queued ahead of this one, so they are already running or done */
+      u_foreach_bit(i, prog->precompile_stages) {
+         struct zink_gfx_stage_precompile *sp = &prog->stage_precompile[i];
+         util_queue_fence_wait(&sp->fence);
+         util_queue_fence_destroy(&sp->fence);
+         add_shader_module_for_stage_optimal(prog, i, sp->zm);
+         prog->objs[i] = sp->zm->obj;
+         prog->objects[i] = sp->zm->obj.obj;
+      }
+      prog->precompile_stages = 0;
+      state.modules_changed = true;
+      prog->last_variant_hash = state.optimal_key;
+   } else {
+      generate_gfx_program_modules_optimal(NULL, screen, prog, &state);
+   }
    zink_screen_get_pipeline_cache(screen, &prog->base, true);
    if (!screen->info.have_EXT_shader_object) {
       simple_mtx_lock(&prog->libs->lock);
       zink_create_pipeline_lib(screen, prog, &state);
       simple_mtx_unlock(&prog->libs->lock);
+      warm_gfx_program(screen, prog);
    }
    zink_screen_update_pipeline_cache(screen, &prog->base, true);
 }
@@ -2161,11 +2283,10 @@ zink_link_gfx_shader(struct pipe_context *pctx, void **shaders)
    /* can't do fixedfunc tes either */
    if (tess && !shaders[MESA_SHADER_TESS_EVAL])
       return;
-   struct hash_table *ht = &ctx->program_cache[zink_program_cache_stages(shader_stages)];
-   simple_mtx_lock(&ctx->program_lock[zink_program_cache_stages(shader_stages)]);
+   struct hash_table *ht = util_sharded_hash_table_lock(&ctx->program_cache[zink_program_cache_stages(shader_stages)], hash);
    /* link can be called repeatedly with the same shaders: ignore */
    if (_mesa_hash_table_search_pre_hashed(ht, hash, shaders)) {
-      simple_mtx_unlock(&ctx->program_lock[zink_program_cache_stages(shader_stages)]);
+      util_sharded_hash_table_unlock(&ctx->program_cache[zink_program_cache_stages(shader_stages)], hash);
       return;
    }
    struct zink_gfx_program *prog = zink_create_gfx_program(ctx, zshaders, 3, hash);
@@ -2173,7 +2294,7 @@ zink_link_gfx_shader(struct pipe_context *pctx, void **shaders)
       assert(prog->shaders[i]);
    _mesa_hash_table_insert_pre_hashed(ht, hash, prog->shaders, prog);
    prog->base.removed = false;
-   simple_mtx_unlock(&ctx->program_lock[zink_program_cache_stages(shader_stages)]);
+   util_sharded_hash_table_unlock(&ctx->program_cache[zink_program_cache_stages(shader_stages)], hash);
    if (zink_debug & ZINK_DEBUG_SHADERDB) {
       struct zink_screen *screen = zink_screen(pctx->screen);
       if (screen->optimal_keys)
@@ -2187,10 +2308,21 @@ zink_link_gfx_shader(struct pipe_context *pctx, void **shaders)
    } else {
       if (zink_screen(pctx->screen)->info.have_EXT_shader_object)
          prog->base.uses_shobj = !BITSET_TEST(zshaders[MESA_SHADER_FRAGMENT]->info.system_values_read, SYSTEM_VALUE_SAMPLE_MASK_IN);
-      if (zink_debug & ZINK_DEBUG_NOBGC)
+      if (zink_debug & ZINK_DEBUG_NOBGC) {
          precompile_job(prog, pctx->screen, 0);
-      else
-         util_queue_add_job(&zink_screen(pctx->screen)->cache_get_thread, prog, &prog->base.cache_fence, precompile_job, NULL, 0);
+      } else {
+         struct zink_screen *screen = zink_screen(pctx->screen);
+         /* compile the stages in parallel so link latency is that of the slowest stage */
+         u_foreach_bit(i, prog->stages_present) {
+            struct zink_gfx_stage_precompile *sp = &prog->stage_precompile[i];
+            sp->prog = prog;
+            sp->stage = i;
+            util_queue_fence_init(&sp->fence);
+            util_queue_add_job(&screen->cache_get_thread, sp, &sp->fence, precompile_stage_job, NULL, 0);
+         }
+         prog->precompile_stages = prog->stages_present;
+         util_queue_add_job(&screen->cache_get_thread, prog, &prog->base.cache_fence, precompile_job, NULL, 0);
+      }
    }
 }
 
@@ -202,6 +202,10 @@ zink_get_gfx_pipeline(struct zink_context *ctx,
          } else {
             assert(!prog->is_separable);
             gkey = zink_create_pipeline_lib(screen, prog, &ctx->gfx_pipeline_state);
+            /* remember this variant so the next run can precompile it at link time */
+            if (screen->disk_cache && prog->num_warm_keys < ZINK_MAX_WARM_KEYS &&
+                !ZINK_SHADER_KEY_OPTIMAL_IS_DEFAULT(gkey->optimal_key))
+               prog->warm_keys[prog->num_warm_keys++] = gkey->optimal_key;
          }
          simple_mtx_unlock(&prog->libs->lock);
          struct zink_gfx_input_key *ikey = DYNAMIC_STATE == ZINK_DYNAMIC_VERTEX_INPUT ?
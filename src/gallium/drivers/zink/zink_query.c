@@ -13,6 +13,10 @@
 #define NUM_QUERIES 500
 
 #define ZINK_QUERY_RENDER_PASSES (PIPE_QUERY_DRIVER_SPECIFIC + 0)
+#define ZINK_QUERY_PIPELINE_BARRIERS (PIPE_QUERY_DRIVER_SPECIFIC + 1)
+#define ZINK_QUERY_PIPELINE_BARRIER_CMDS (PIPE_QUERY_DRIVER_SPECIFIC + 2)
+/* ZINK_QUERY_DRAW_TIME + enum zink_draw_timer */
+#define ZINK_QUERY_DRAW_TIME (PIPE_QUERY_DRIVER_SPECIFIC + 3)
 
 struct zink_query_pool {
    struct list_head list;
@@ -90,6 +94,12 @@ struct zink_query {
 
 static const struct pipe_driver_query_info zink_specific_queries[] = {
    {"render-passes", ZINK_QUERY_RENDER_PASSES, { 0 }},
+   {"pipeline-barriers", ZINK_QUERY_PIPELINE_BARRIERS, { 0 }},
+   {"pipeline-barrier-cmds", ZINK_QUERY_PIPELINE_BARRIER_CMDS, { 0 }},
+   {"draw-cpu-barriers", ZINK_QUERY_DRAW_TIME + ZINK_DRAW_TIMER_BARRIERS, { 0 }, PIPE_DRIVER_QUERY_TYPE_MICROSECONDS},
+   {"draw-cpu-pipeline", ZINK_QUERY_DRAW_TIME + ZINK_DRAW_TIMER_PIPELINE, { 0 }, PIPE_DRIVER_QUERY_TYPE_MICROSECONDS},
+   {"draw-cpu-descriptors", ZINK_QUERY_DRAW_TIME + ZINK_DRAW_TIMER_DESCRIPTORS, { 0 }, PIPE_DRIVER_QUERY_TYPE_MICROSECONDS},
+   {"draw-cpu-cmds", ZINK_QUERY_DRAW_TIME + ZINK_DRAW_TIMER_CMDS, { 0 }, PIPE_DRIVER_QUERY_TYPE_MICROSECONDS},
 };
 
 static inline int
@@ -1140,6 +1150,24 @@ zink_get_query_result(struct pipe_context *pctx,
       return true;
    }
 
+   if (query->type == ZINK_QUERY_PIPELINE_BARRIERS) {
+      result->u64 = ctx->hud.pipeline_barriers;
+      ctx->hud.pipeline_barriers = 0;
+      return true;
+   }
+
+   if (query->type == ZINK_QUERY_PIPELINE_BARRIER_CMDS) {
+      result->u64 = ctx->hud.pipeline_barrier_cmds;
+      ctx->hud.pipeline_barrier_cmds = 0;
+      return true;
+   }
+
+   if (query->type >= ZINK_QUERY_DRAW_TIME && query->type < ZINK_QUERY_DRAW_TIME + ZINK_DRAW_TIMER_COUNT) {
+      result->u64 = ctx->hud.draw_time[query->type - ZINK_QUERY_DRAW_TIME] / 1000;
+      ctx->hud.draw_time[query->type - ZINK_QUERY_DRAW_TIME] = 0;
+      return true;
+   }
+
    if (query->needs_update) {
       assert(!ctx->tc || !threaded_query(q)->flushed);
       update_qbo(ctx, query);
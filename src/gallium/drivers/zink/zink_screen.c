@@ -118,6 +118,8 @@ zink_debug_options[] = {
    { "mem", ZINK_DEBUG_MEM, "Debug memory allocations" },
    { "quiet", ZINK_DEBUG_QUIET, "Suppress warnings" },
    { "ioopt", ZINK_DEBUG_IOOPT, "Optimize IO" },
+   { "drawtime", ZINK_DEBUG_DRAWTIME, "Time the CPU cost of draw sections for the HUD" },
+   { "nopace", ZINK_DEBUG_NOPACE, "Don't pace presents with VK_KHR_present_wait" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -335,12 +337,41 @@ disk_cache_init(struct zink_screen *screen)
 }
 
 
+static void
+compute_warm_key(struct zink_screen *screen, struct zink_program *pg, cache_key key)
+{
+   /* the warm keys live next to the pipeline cache data with a distinct key */
+   uint8_t data[sizeof(pg->sha1) + 4];
+   memcpy(data, pg->sha1, sizeof(pg->sha1));
+   memcpy(data + sizeof(pg->sha1), "warm", 4);
+   disk_cache_compute_key(screen->disk_cache, data, sizeof(data), key);
+}
+
+static void
+cache_put_warm_keys(struct zink_screen *screen, struct zink_gfx_program *prog)
+{
+   uint32_t keys[ZINK_MAX_WARM_KEYS];
+   simple_mtx_lock(&prog->libs->lock);
+   unsigned count = prog->num_warm_keys;
+   memcpy(keys, prog->warm_keys, count * sizeof(uint32_t));
+   simple_mtx_unlock(&prog->libs->lock);
+   if (count == prog->num_warm_keys_stored)
+      return;
+
+   cache_key key;
+   compute_warm_key(screen, &prog->base, key);
+   disk_cache_put(screen->disk_cache, key, keys, count * sizeof(uint32_t), NULL);
+   prog->num_warm_keys_stored = count;
+}
+
 static void
 cache_put_job(void *data, void *gdata, int thread_index)
 {
    struct zink_program *pg = data;
    struct zink_screen *screen = gdata;
    size_t size = 0;
+   if (!pg->is_compute && ((struct zink_gfx_program*)pg)->libs)
+      cache_put_warm_keys(screen, (struct zink_gfx_program*)pg);
    u_rwlock_rdlock(&pg->pipeline_cache_lock);
    VkResult result = VKSCR(GetPipelineCacheData)(screen->dev, pg->pipeline_cache, &size, NULL);
    if (result != VK_SUCCESS) {
@@ -419,6 +450,24 @@ zink_screen_get_pipeline_cache(struct zink_screen *screen, struct zink_program *
       util_queue_add_job(&screen->cache_get_thread, pg, &pg->cache_fence, cache_get_job, NULL, 0);
 }
 
+unsigned
+zink_screen_get_pipeline_warm_keys(struct zink_screen *screen, struct zink_gfx_program *prog, uint32_t *keys)
+{
+   if (!screen->disk_cache)
+      return 0;
+
+   cache_key key;
+   size_t size = 0;
+   compute_warm_key(screen, &prog->base, key);
+   uint32_t *data = disk_cache_get(screen->disk_cache, key, &size);
+   if (!data)
+      return 0;
+   unsigned count = MIN2(size / sizeof(uint32_t), ZINK_MAX_WARM_KEYS);
+   memcpy(keys, data, count * sizeof(uint32_t));
+   free(data);
+   return count;
+}
+
 static int
 zink_get_compute_param(struct pipe_screen *pscreen, enum pipe_shader_ir ir_type,
                        enum pipe_compute_cap param, void *ret)
@@ -3306,6 +3355,7 @@ zink_internal_create_screen(const struct pipe_screen_config *config, int64_t dev
       //screen->driconf.inline_uniforms = driQueryOptionb(config->options, "radeonsi_inline_uniforms");
       screen->driconf.emulate_point_smooth = driQueryOptionb(config->options, "zink_emulate_point_smooth");
       screen->driconf.zink_shader_object_enable = driQueryOptionb(config->options, "zink_shader_object_enable");
+      screen->driconf.tc_adaptive_batches = driQueryOptionb(config->options, "mesa_tc_adaptive_batches");
    }
 
    if (!zink_create_instance(screen, dev_major > 0 && dev_major < 255))
@@ -3539,7 +3589,8 @@ zink_internal_create_screen(const struct pipe_screen_config *config, int64_t dev
       goto fail;
    }
    if (!util_queue_init(&screen->cache_get_thread, "zcfq", 8, 4,
-                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, screen))
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                        UTIL_QUEUE_INIT_WORK_STEALING, screen))
       goto fail;
    populate_format_props(screen);
 
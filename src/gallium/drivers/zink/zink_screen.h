@@ -164,6 +164,9 @@ zink_screen_update_pipeline_cache(struct zink_screen *screen, struct zink_progra
 void
 zink_screen_get_pipeline_cache(struct zink_screen *screen, struct zink_program *pg, bool in_thread);
 
+unsigned
+zink_screen_get_pipeline_warm_keys(struct zink_screen *screen, struct zink_gfx_program *prog, uint32_t *keys);
+
 void
 zink_stub_function_not_loaded(void);
 
@@ -328,6 +328,98 @@ enum barrier_type {
    barrier_KHR_synchronzation2
 };
 
+/* returns the pending barrier batch for cmdbuf, or NULL if barriers are emitted immediately */
+static struct zink_barrier_batch *
+get_barrier_batch(struct zink_context *ctx, VkCommandBuffer cmdbuf)
+{
+   if (!ctx->barriers.depth)
+      return NULL;
+   struct zink_batch_state *bs = ctx->batch.state;
+   unsigned idx = cmdbuf == bs->cmdbuf ? 0 : cmdbuf == bs->reordered_cmdbuf ? 1 : 2;
+   struct zink_barrier_batch *b = &ctx->barriers.batch[idx];
+   assert(b->cmdbuf == cmdbuf || (!b->num_images && !b->has_memory));
+   b->cmdbuf = cmdbuf;
+   ctx->hud.pipeline_barriers++;
+   return b;
+}
+
+template <barrier_type BARRIER_API>
+static void
+flush_barrier_batch(struct zink_context *ctx, struct zink_barrier_batch *b);
+
+template <>
+void
+flush_barrier_batch<barrier_default>(struct zink_context *ctx, struct zink_barrier_batch *b)
+{
+   if (!b->num_images && !b->has_memory)
+      return;
+   VkMemoryBarrier mb = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      NULL,
+      b->src_access,
+      b->dst_access
+   };
+   VKCTX(CmdPipelineBarrier)(
+       b->cmdbuf,
+       b->src_stages,
+       b->dst_stages,
+       0,
+       b->has_memory, &mb,
+       0, NULL,
+       b->num_images, b->images
+       );
+   ctx->hud.pipeline_barrier_cmds++;
+   b->num_images = 0;
+   b->has_memory = false;
+   b->src_access = b->dst_access = 0;
+   b->src_stages = b->dst_stages = 0;
+}
+
+template <>
+void
+flush_barrier_batch<barrier_KHR_synchronzation2>(struct zink_context *ctx, struct zink_barrier_batch *b)
+{
+   if (!b->num_images && !b->has_memory)
+      return;
+   VkMemoryBarrier2 mb = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+      NULL,
+      b->src_stages,
+      b->src_access,
+      b->dst_stages,
+      b->dst_access
+   };
+   VkDependencyInfo dep = {
+      VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+      NULL,
+      0,
+      b->has_memory,
+      &mb,
+      0,
+      NULL,
+      b->num_images,
+      b->images2
+   };
+   VKCTX(CmdPipelineBarrier2)(b->cmdbuf, &dep);
+   ctx->hud.pipeline_barrier_cmds++;
+   b->num_images = 0;
+   b->has_memory = false;
+   b->src_access = b->dst_access = 0;
+   b->src_stages = b->dst_stages = 0;
+}
+
+/* an image can only have one layout transition per dependency */
+template <typename T>
+static bool
+barrier_batch_has_image(const T *barriers, unsigned count, VkImage image)
+{
+   for (unsigned i = 0; i < count; i++) {
+      if (barriers[i].image == image)
+         return true;
+   }
+   return false;
+}
+
 template <barrier_type BARRIER_API>
 struct emit_memory_barrier {
    static void for_image(struct zink_context *ctx, struct zink_resource *res, VkImageLayout new_layout,
@@ -347,15 +439,28 @@ struct emit_memory_barrier {
          res->queue = VK_QUEUE_FAMILY_IGNORED;
          *queue_import = true;
       }
+      VkPipelineStageFlags src_stage = res->obj->access_stage ? res->obj->access_stage : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+      struct zink_barrier_batch *b = get_barrier_batch(ctx, cmdbuf);
+      if (b) {
+         if (b->num_images == ZINK_MAX_BATCHED_IMAGE_BARRIERS ||
+             barrier_batch_has_image(b->images, b->num_images, imb.image))
+            flush_barrier_batch<barrier_default>(ctx, b);
+         b->images[b->num_images++] = imb;
+         b->src_stages |= src_stage;
+         b->dst_stages |= pipeline;
+         return;
+      }
       VKCTX(CmdPipelineBarrier)(
           cmdbuf,
-          res->obj->access_stage ? res->obj->access_stage : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+          src_stage,
           pipeline,
           0,
           0, NULL,
           0, NULL,
           1, &imb
           );
+      ctx->hud.pipeline_barriers++;
+      ctx->hud.pipeline_barrier_cmds++;
    }
 
    static void for_buffer(struct zink_context *ctx, struct zink_resource *res,
@@ -376,6 +481,15 @@ struct emit_memory_barrier {
          bmb.srcAccessMask = res->obj->access;
       }
       bmb.dstAccessMask = flags;
+      struct zink_barrier_batch *b = get_barrier_batch(ctx, cmdbuf);
+      if (b) {
+         b->has_memory = true;
+         b->src_access |= bmb.srcAccessMask;
+         b->dst_access |= bmb.dstAccessMask;
+         b->src_stages |= stages;
+         b->dst_stages |= pipeline;
+         return;
+      }
       VKCTX(CmdPipelineBarrier)(
           cmdbuf,
           stages,
@@ -384,6 +498,8 @@ struct emit_memory_barrier {
           1, &bmb,
           0, NULL,
           0, NULL);
+      ctx->hud.pipeline_barriers++;
+      ctx->hud.pipeline_barrier_cmds++;
    }
 };
 
@@ -418,7 +534,17 @@ struct emit_memory_barrier<barrier_KHR_synchronzation2> {
          1,
          &imb
          };
+      struct zink_barrier_batch *b = get_barrier_batch(ctx, cmdbuf);
+      if (b) {
+         if (b->num_images == ZINK_MAX_BATCHED_IMAGE_BARRIERS ||
+             barrier_batch_has_image(b->images2, b->num_images, imb.image))
+            flush_barrier_batch<barrier_KHR_synchronzation2>(ctx, b);
+         b->images2[b->num_images++] = imb;
+         return;
+      }
       VKCTX(CmdPipelineBarrier2)(cmdbuf, &dep);
+      ctx->hud.pipeline_barriers++;
+      ctx->hud.pipeline_barrier_cmds++;
    }
 
    static void for_buffer(struct zink_context *ctx, struct zink_resource *res,
@@ -452,7 +578,18 @@ struct emit_memory_barrier<barrier_KHR_synchronzation2> {
           0,
           NULL
       };
+      struct zink_barrier_batch *b = get_barrier_batch(ctx, cmdbuf);
+      if (b) {
+         b->has_memory = true;
+         b->src_access |= bmb.srcAccessMask;
+         b->dst_access |= bmb.dstAccessMask;
+         b->src_stages |= bmb.srcStageMask;
+         b->dst_stages |= bmb.dstStageMask;
+         return;
+      }
       VKCTX(CmdPipelineBarrier2)(cmdbuf, &dep);
+      ctx->hud.pipeline_barriers++;
+      ctx->hud.pipeline_barrier_cmds++;
    }
 };
 
@@ -779,6 +916,29 @@ zink_resource_buffer_barrier(struct zink_context *ctx, struct zink_resource *res
       zink_resource_copies_reset(res);
 }
 
+/* queue resource barriers until the matching zink_barrier_batch_end() */
+void
+zink_barrier_batch_begin(struct zink_context *ctx)
+{
+   ctx->barriers.depth++;
+}
+
+/* emit all queued barriers as one dependency per cmdbuf */
+void
+zink_barrier_batch_end(struct zink_context *ctx)
+{
+   assert(ctx->barriers.depth);
+   if (--ctx->barriers.depth)
+      return;
+   struct zink_screen *screen = zink_screen(ctx->base.screen);
+   for (unsigned i = 0; i < ARRAY_SIZE(ctx->barriers.batch); i++) {
+      if (screen->info.have_vulkan13 || screen->info.have_KHR_synchronization2)
+         flush_barrier_batch<barrier_KHR_synchronzation2>(ctx, &ctx->barriers.batch[i]);
+      else
+         flush_barrier_batch<barrier_default>(ctx, &ctx->barriers.batch[i]);
+   }
+}
+
 void
 zink_synchronization_init(struct zink_screen *screen)
 {
@@ -45,12 +45,14 @@
 #include "util/rwlock.h"
 #include "util/set.h"
 #include "util/simple_mtx.h"
+#include "util/u_sharded_hash_table.h"
 #include "util/slab.h"
 #include "util/u_dynarray.h"
 #include "util/u_idalloc.h"
 #include "util/u_live_shader_cache.h"
 #include "util/u_queue.h"
 #include "util/u_range.h"
+#include "util/u_sharded_hash_table.h"
 #include "util/u_threaded_context.h"
 #include "util/u_transfer.h"
 #include "util/u_vertex_state_cache.h"
@@ -79,12 +81,14 @@
 
 /* enum zink_descriptor_type */
 #define ZINK_MAX_DESCRIPTOR_SETS 6
+/* number of pipeline library variants per program that are recorded for warmup */
+#define ZINK_MAX_WARM_KEYS 16
 #define ZINK_MAX_DESCRIPTORS_PER_TYPE (32 * ZINK_GFX_SHADER_COUNT)
 /* Descriptor size reported by lavapipe. */
 #define ZINK_FBFETCH_DESCRIPTOR_SIZE 280
 
 /* suballocator defines */
-#define NUM_SLAB_ALLOCATORS 3
+#define NUM_SLAB_ALLOCATORS 4
 #define MIN_SLAB_ORDER 8
 
 
@@ -242,6 +246,8 @@ enum zink_debug {
    ZINK_DEBUG_MEM = (1<<18),
    ZINK_DEBUG_QUIET = (1<<19),
    ZINK_DEBUG_IOOPT = (1<<20),
+   ZINK_DEBUG_DRAWTIME = (1<<21),
+   ZINK_DEBUG_NOPACE = (1<<22),
 };
 
 enum zink_pv_emulation_primitive {
@@ -422,6 +428,8 @@ struct zink_descriptor_pool_key {
 struct zink_descriptor_template {
    uint16_t stride; //the stride between mem pointers
    uint16_t db_size; //the size of the entry in the buffer
+   uint8_t stage; //the (clamped) shader stage of the binding
+   uint8_t index; //the first gallium slot of the binding
    unsigned count; //the number of descriptors
    size_t offset; //the offset of the base host pointer to update from
 };
@@ -463,6 +471,14 @@ struct zink_descriptor_data {
    uint32_t db_size[2]; //gfx, compute
    uint32_t db_offset[ZINK_GFX_SHADER_COUNT + 1]; //gfx + fbfetch
    /* compute offset is always 0 */
+
+   /* db mode: host copies of the last descriptor data written for each set,
+    * so that only the dirty bindings need vkGetDescriptorEXT calls
+    */
+   uint8_t *db_shadow[2][ZINK_DESCRIPTOR_BASE_TYPES]; //gfx, compute
+   uint32_t db_shadow_size[2][ZINK_DESCRIPTOR_BASE_TYPES];
+   VkDescriptorSetLayout db_shadow_dsl[2][ZINK_DESCRIPTOR_BASE_TYPES]; //the layout of the shadowed data
+   uint32_t db_dirty[ZINK_DESCRIPTOR_BASE_TYPES][MESA_SHADER_STAGES]; //mask of changed slots per set and stage
 };
 
 /* pg->dd; created at program creation */
@@ -1108,6 +1124,14 @@ struct zink_gfx_lib_cache {
    struct set libs; //zink_gfx_library_key -> VkPipeline
 };
 
+/* per-stage compile job queued at link time */
+struct zink_gfx_stage_precompile {
+   struct zink_gfx_program *prog;
+   gl_shader_stage stage;
+   struct util_queue_fence fence;
+   struct zink_shader_module *zm;
+};
+
 struct zink_gfx_program {
    struct zink_program base;
 
@@ -1143,6 +1167,18 @@ struct zink_gfx_program {
    struct zink_gfx_pipeline_cache_entry *last_pipeline[2][4]; //[dynamic, renderpass][primtype idx]
 
    struct zink_gfx_lib_cache *libs;
+
+   /* optimal keys which needed a new pipeline library: these are stored
+    * to the disk cache and precompiled at link time on the next run
+    * (guarded by libs->lock)
+    */
+   uint32_t warm_keys[ZINK_MAX_WARM_KEYS];
+   unsigned num_warm_keys;
+   unsigned num_warm_keys_stored; //only accessed from cache jobs
+
+   /* stages with a pending precompile_stage_job */
+   uint32_t precompile_stages;
+   struct zink_gfx_stage_precompile stage_precompile[ZINK_GFX_SHADER_COUNT];
 };
 
 struct zink_compute_program {
@@ -1539,6 +1575,7 @@ struct zink_screen {
       bool inline_uniforms;
       bool emulate_point_smooth;
       bool zink_shader_object_enable;
+      bool tc_adaptive_batches;
    } driconf;
 
    struct zink_format_props format_props[PIPE_FORMAT_COUNT];
@@ -1788,6 +1825,34 @@ enum zink_ds3_state {
    ZINK_DS3_BLEND_LOGIC,
 };
 
+/* sections of zink_draw timed with ZINK_DEBUG=drawtime */
+enum zink_draw_timer {
+   ZINK_DRAW_TIMER_BARRIERS,
+   ZINK_DRAW_TIMER_PIPELINE,
+   ZINK_DRAW_TIMER_DESCRIPTORS,
+   ZINK_DRAW_TIMER_CMDS,
+   ZINK_DRAW_TIMER_COUNT,
+};
+
+#define ZINK_MAX_BATCHED_IMAGE_BARRIERS 32
+
+/* pending barriers for one cmdbuf */
+struct zink_barrier_batch {
+   VkCommandBuffer cmdbuf;
+   unsigned num_images;
+   union {
+      VkImageMemoryBarrier images[ZINK_MAX_BATCHED_IMAGE_BARRIERS];
+      VkImageMemoryBarrier2 images2[ZINK_MAX_BATCHED_IMAGE_BARRIERS];
+   };
+   /* all buffer barriers are merged into a single memory barrier */
+   bool has_memory;
+   VkAccessFlags src_access;
+   VkAccessFlags dst_access;
+   /* merged stage masks: used for every barrier without sync2, only for the memory barrier with sync2 */
+   VkPipelineStageFlags src_stages;
+   VkPipelineStageFlags dst_stages;
+};
+
 struct zink_context {
    struct pipe_context base;
    struct threaded_context *tc;
@@ -1844,8 +1909,7 @@ struct zink_context {
    /* there are 5 gfx stages, but VS and FS are assumed to be always present,
     * thus only 3 stages need to be considered, giving 2^3 = 8 program caches.
     */
-   struct hash_table program_cache[8];
-   simple_mtx_t program_lock[8];
+   struct util_sharded_hash_table program_cache[8];
    uint32_t gfx_hash;
    struct zink_gfx_program *curr_program;
    struct set gfx_inputs;
@@ -1939,6 +2003,9 @@ struct zink_context {
    } render_condition;
    struct {
       uint64_t render_passes;
+      uint64_t pipeline_barriers;
+      uint64_t pipeline_barrier_cmds;
+      uint64_t draw_time[ZINK_DRAW_TIMER_COUNT]; //ns
    } hud;
 
    struct {
@@ -2030,6 +2097,11 @@ struct zink_context {
    struct set update_barriers[2][2]; //[gfx, compute][current, next]
    uint8_t barrier_set_idx[2];
    unsigned memory_barrier;
+   /* resource barriers queued while batching, flushed as one dependency per cmdbuf */
+   struct {
+      unsigned depth; //nesting level of zink_barrier_batch_begin
+      struct zink_barrier_batch batch[3]; //main, reordered, unsynchronized
+   } barriers;
 
    uint32_t ds3_states;
 
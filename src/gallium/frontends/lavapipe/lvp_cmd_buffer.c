@@ -108,9 +108,7 @@ VKAPI_ATTR void VKAPI_CALL lvp_CmdPushDescriptorSetWithTemplate2KHR(
    LVP_FROM_HANDLE(lvp_cmd_buffer, cmd_buffer, commandBuffer);
    LVP_FROM_HANDLE(lvp_descriptor_update_template, templ, pPushDescriptorSetWithTemplateInfo->descriptorUpdateTemplate);
    size_t info_size = 0;
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc,
-                                              vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE2_KHR], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+   struct vk_cmd_queue_entry *cmd = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE2_KHR]);
    if (!cmd)
       return;
 
@@ -120,7 +118,7 @@ VKAPI_ATTR void VKAPI_CALL lvp_CmdPushDescriptorSetWithTemplate2KHR(
    cmd->driver_free_cb = lvp_free_CmdPushDescriptorSetWithTemplate2KHR;
    cmd->driver_data = cmd_buffer->device;
    lvp_descriptor_template_templ_ref(templ);
-   cmd->u.push_descriptor_set_with_template2_khr.push_descriptor_set_with_template_info = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, sizeof(VkPushDescriptorSetWithTemplateInfoKHR), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   cmd->u.push_descriptor_set_with_template2_khr.push_descriptor_set_with_template_info = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, sizeof(VkPushDescriptorSetWithTemplateInfoKHR));
    memcpy(cmd->u.push_descriptor_set_with_template2_khr.push_descriptor_set_with_template_info, pPushDescriptorSetWithTemplateInfo, sizeof(VkPushDescriptorSetWithTemplateInfoKHR));
 
    for (unsigned i = 0; i < templ->entry_count; i++) {
@@ -151,7 +149,7 @@ VKAPI_ATTR void VKAPI_CALL lvp_CmdPushDescriptorSetWithTemplate2KHR(
       }
    }
 
-   cmd->u.push_descriptor_set_with_template2_khr.push_descriptor_set_with_template_info->pData = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, info_size, 8, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+   cmd->u.push_descriptor_set_with_template2_khr.push_descriptor_set_with_template_info->pData = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, info_size);
 
    uint64_t offset = 0;
    for (unsigned i = 0; i < templ->entry_count; i++) {
@@ -167,31 +165,21 @@ VKAPI_ATTR void VKAPI_CALL lvp_CmdPushDescriptorSetWithTemplate2KHR(
 }
 
 
-static void
-vk_free_cmd_push_constants2_khr(struct vk_cmd_queue *queue,
-                                struct vk_cmd_queue_entry *cmd)
-{
-   vk_free(queue->alloc, (void*)cmd->u.push_constants2_khr.push_constants_info->pValues);
-   vk_free(queue->alloc, (VkPushConstantsInfoKHR*)cmd->u.push_constants2_khr.push_constants_info);
-   vk_free(queue->alloc, cmd);
-}
-
 VKAPI_ATTR void VKAPI_CALL lvp_CmdPushConstants2KHR(
    VkCommandBuffer                             commandBuffer,
    const VkPushConstantsInfoKHR* pPushConstantsInfo)
 {
    LVP_FROM_HANDLE(lvp_cmd_buffer, cmd_buffer, commandBuffer);
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, vk_cmd_queue_type_sizes[VK_CMD_PUSH_CONSTANTS2_KHR], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue_entry *cmd = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, vk_cmd_queue_type_sizes[VK_CMD_PUSH_CONSTANTS2_KHR]);
    if (!cmd)
       return;
 
    cmd->type = VK_CMD_PUSH_CONSTANTS2_KHR;
       
-   cmd->u.push_constants2_khr.push_constants_info = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, sizeof(VkPushConstantsInfoKHR), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   cmd->u.push_constants2_khr.push_constants_info = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, sizeof(VkPushConstantsInfoKHR));
    memcpy((void*)cmd->u.push_constants2_khr.push_constants_info, pPushConstantsInfo, sizeof(VkPushConstantsInfoKHR));
 
-   cmd->u.push_constants2_khr.push_constants_info->pValues = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, pPushConstantsInfo->size, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   cmd->u.push_constants2_khr.push_constants_info->pValues = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, pPushConstantsInfo->size);
    memcpy((void*)cmd->u.push_constants2_khr.push_constants_info->pValues, pPushConstantsInfo->pValues, pPushConstantsInfo->size);
 
    list_addtail(&cmd->cmd_link, &cmd_buffer->vk.cmd_queue.cmds);
@@ -210,16 +198,14 @@ VKAPI_ATTR void VKAPI_CALL lvp_CmdPushDescriptorSet2KHR(
     const VkPushDescriptorSetInfoKHR*           pPushDescriptorSetInfo)
 {
    LVP_FROM_HANDLE(lvp_cmd_buffer, cmd_buffer, commandBuffer);
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET2_KHR], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue_entry *cmd = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET2_KHR]);
 
    cmd->type = VK_CMD_PUSH_DESCRIPTOR_SET2_KHR;
    cmd->driver_free_cb = lvp_free_cmd_push_descriptor_set2_khr;
 
    void *ctx = cmd->driver_data = ralloc_context(NULL);
    if (pPushDescriptorSetInfo) {
-      cmd->u.push_descriptor_set2_khr.push_descriptor_set_info = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, sizeof(VkPushDescriptorSetInfoKHR), 8,
-                                                                           VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      cmd->u.push_descriptor_set2_khr.push_descriptor_set_info = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, sizeof(VkPushDescriptorSetInfoKHR));
 
       memcpy((void*)cmd->u.push_descriptor_set2_khr.push_descriptor_set_info, pPushDescriptorSetInfo, sizeof(VkPushDescriptorSetInfoKHR));
       VkPushDescriptorSetInfoKHR *tmp_dst1 = (void *) cmd->u.push_descriptor_set2_khr.push_descriptor_set_info; (void) tmp_dst1;
@@ -253,8 +239,7 @@ VKAPI_ATTR void VKAPI_CALL lvp_CmdPushDescriptorSet2KHR(
          }
       }
       if (tmp_src1->pDescriptorWrites) {
-         tmp_dst1->pDescriptorWrites = vk_zalloc(cmd_buffer->vk.cmd_queue.alloc, sizeof(*tmp_dst1->pDescriptorWrites) * tmp_dst1->descriptorWriteCount, 8,
-                                                 VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         tmp_dst1->pDescriptorWrites = vk_cmd_queue_zalloc(&cmd_buffer->vk.cmd_queue, sizeof(*tmp_dst1->pDescriptorWrites) * tmp_dst1->descriptorWriteCount);
 
          memcpy((void*)tmp_dst1->pDescriptorWrites, tmp_src1->pDescriptorWrites, sizeof(*tmp_dst1->pDescriptorWrites) * tmp_dst1->descriptorWriteCount);
          for (unsigned i = 0; i < tmp_src1->descriptorWriteCount; i++) {
@@ -1410,6 +1410,19 @@ VKAPI_ATTR void VKAPI_CALL lvp_GetPhysicalDeviceQueueFamilyProperties2(
          .minImageTransferGranularity = (VkExtent3D) { 1, 1, 1 },
       };
    }
+
+   /* Async compute: work submitted here runs concurrently with the
+    * graphics queue, sharing the llvmpipe thread pools.
+    */
+   vk_outarray_append_typed(VkQueueFamilyProperties2, &out, p) {
+      p->queueFamilyProperties = (VkQueueFamilyProperties) {
+         .queueFlags = VK_QUEUE_COMPUTE_BIT |
+         VK_QUEUE_TRANSFER_BIT,
+         .queueCount = 1,
+         .timestampValidBits = 64,
+         .minImageTransferGranularity = (VkExtent3D) { 1, 1, 1 },
+      };
+   }
 }
 
 VKAPI_ATTR void VKAPI_CALL lvp_GetPhysicalDeviceMemoryProperties(
@@ -1538,7 +1551,8 @@ lvp_queue_submit(struct vk_queue *vk_queue,
          vk_sync_as_lvp_pipe_sync(submit->signals[i].sync);
       lvp_pipe_sync_signal_with_fence(queue->device, sync, queue->last_fence);
    }
-   destroy_pipelines(queue);
+   /* Pipeline destruction is deferred to the device's main queue. */
+   destroy_pipelines(&queue->device->queue);
 
    return VK_SUCCESS;
 }
@@ -1601,12 +1615,13 @@ VKAPI_ATTR VkResult VKAPI_CALL lvp_CreateDevice(
 
    size_t state_size = lvp_get_rendering_state_size();
    device = vk_zalloc2(&physical_device->vk.instance->alloc, pAllocator,
-                       sizeof(*device) + state_size, 8,
+                       sizeof(*device) + state_size * LVP_QUEUE_FAMILY_COUNT, 8,
                        VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
    if (!device)
       return vk_error(instance, VK_ERROR_OUT_OF_HOST_MEMORY);
 
    device->queue.state = device + 1;
+   device->compute_queue.state = (uint8_t *)(device + 1) + state_size;
    device->poison_mem = debug_get_bool_option("LVP_POISON_MEMORY", false);
    device->print_cmds = debug_get_bool_option("LVP_CMD_DEBUG", false);
 
@@ -1633,15 +1648,40 @@ VKAPI_ATTR VkResult VKAPI_CALL lvp_CreateDevice(
 
    device->pscreen = physical_device->pscreen;
 
-   assert(pCreateInfo->queueCreateInfoCount == 1);
-   assert(pCreateInfo->pQueueCreateInfos[0].queueFamilyIndex == 0);
-   assert(pCreateInfo->pQueueCreateInfos[0].queueCount == 1);
-   result = lvp_queue_init(device, &device->queue, pCreateInfo->pQueueCreateInfos, 0);
+   /* The graphics queue is needed for device-level objects even when the
+    * application only asked for the compute one.
+    */
+   const VkDeviceQueueCreateInfo *gfx_info = NULL, *compute_info = NULL;
+   for (uint32_t i = 0; i < pCreateInfo->queueCreateInfoCount; i++) {
+      const VkDeviceQueueCreateInfo *info = &pCreateInfo->pQueueCreateInfos[i];
+      assert(info->queueCount == 1);
+      if (info->queueFamilyIndex == LVP_QUEUE_FAMILY_COMPUTE)
+         compute_info = info;
+      else
+         gfx_info = info;
+   }
+   const VkDeviceQueueCreateInfo default_gfx_info = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+      .queueFamilyIndex = LVP_QUEUE_FAMILY_GRAPHICS,
+      .queueCount = 1,
+   };
+   result = lvp_queue_init(device, &device->queue,
+                           gfx_info ? gfx_info : &default_gfx_info, 0);
    if (result != VK_SUCCESS) {
       vk_free(&device->vk.alloc, device);
       return result;
    }
 
+   if (compute_info) {
+      result = lvp_queue_init(device, &device->compute_queue, compute_info, 0);
+      if (result != VK_SUCCESS) {
+         lvp_queue_finish(&device->queue);
+         vk_free(&device->vk.alloc, device);
+         return result;
+      }
+      device->has_compute_queue = true;
+   }
+
    nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_FRAGMENT, NULL, "dummy_frag");
    struct pipe_shader_state shstate = {0};
    shstate.type = PIPE_SHADER_IR_NIR;
@@ -1696,6 +1736,11 @@ VKAPI_ATTR void VKAPI_CALL lvp_DestroyDevice(
    simple_mtx_destroy(&device->bda_lock);
    pipe_resource_reference(&device->zero_buffer, NULL);
 
+   if (device->has_compute_queue) {
+      if (device->compute_queue.last_fence)
+         device->pscreen->fence_reference(device->pscreen, &device->compute_queue.last_fence, NULL);
+      lvp_queue_finish(&device->compute_queue);
+   }
    lvp_queue_finish(&device->queue);
    vk_device_finish(&device->vk);
    vk_free(&device->vk.alloc, device);
@@ -177,6 +177,13 @@ void lvp_finish_wsi(struct lvp_physical_device *physical_device);
 bool lvp_physical_device_extension_supported(struct lvp_physical_device *dev,
                                               const char *name);
 
+/* Queue families: everything on the first one, and a compute/transfer
+ * family whose queue executes on a thread and pipe_context of its own.
+ */
+#define LVP_QUEUE_FAMILY_GRAPHICS 0
+#define LVP_QUEUE_FAMILY_COMPUTE  1
+#define LVP_QUEUE_FAMILY_COUNT    2
+
 struct lvp_queue {
    struct vk_queue vk;
    struct lvp_device *                         device;
@@ -198,7 +205,10 @@ struct lvp_pipeline_cache {
 struct lvp_device {
    struct vk_device vk;
 
+   /* Always created, also owns the device-level gallium objects. */
    struct lvp_queue queue;
+   struct lvp_queue compute_queue;
+   bool has_compute_queue;
    struct lvp_instance *                       instance;
    struct lvp_physical_device *physical_device;
    struct pipe_screen *pscreen;
@@ -126,18 +126,29 @@ impl Context {
             let enable_bind_as_image =
                 (dev.formats[format][&desc.image_type] as u32 & CL_MEM_WRITE_ONLY) != 0;
 
-            // we can't specify custom pitches/slices, so this won't work for non 1D images
-            if !user_ptr.is_null() && !copy && desc.image_type == CL_MEM_OBJECT_IMAGE1D {
-                resource = dev.screen().resource_create_texture_from_user(
-                    width,
-                    height,
-                    depth,
-                    array_size,
-                    target,
-                    pipe_format,
-                    user_ptr,
-                    enable_bind_as_image,
-                )
+            // we can't specify custom pitches/slices, so this won't work for 3D or array images.
+            // For 2D images we let the driver pick the pitch and only keep the resource if it
+            // matches the layout of the host memory.
+            if !user_ptr.is_null()
+                && !copy
+                && [CL_MEM_OBJECT_IMAGE1D, CL_MEM_OBJECT_IMAGE2D].contains(&desc.image_type)
+            {
+                resource = dev
+                    .screen()
+                    .resource_create_texture_from_user(
+                        width,
+                        height,
+                        depth,
+                        array_size,
+                        target,
+                        pipe_format,
+                        user_ptr,
+                        enable_bind_as_image,
+                    )
+                    .filter(|r| {
+                        desc.image_type == CL_MEM_OBJECT_IMAGE1D
+                            || dev.screen().resource_stride(r) == Some(desc.image_row_pitch as u64)
+                    });
             }
 
             if resource.is_none() {
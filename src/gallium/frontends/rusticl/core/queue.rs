@@ -137,13 +137,21 @@ impl Queue {
                         break;
                     }
 
-                    let new_events = r.unwrap();
+                    let mut new_events = r.unwrap();
                     let mut flushed = Vec::new();
 
+                    // Pick up everything else that got flushed in the meantime as well, so we
+                    // only have to submit and wait once for all of it.
+                    while let Ok(mut more) = rx_t.try_recv() {
+                        new_events.append(&mut more);
+                    }
+
                     for e in new_events {
-                        // If we hit any deps from another queue, flush so we don't risk a dead
-                        // lock.
-                        if e.deps.iter().any(|ev| ev.queue != e.queue) {
+                        // If we hit any unfinished deps from another queue, flush so we don't
+                        // risk a dead lock.
+                        if e.deps.iter().any(|ev| {
+                            ev.queue != e.queue && ev.status() > CL_COMPLETE as cl_int
+                        }) {
                             flush_events(&mut flushed, &ctx);
                         }
 
@@ -240,6 +240,26 @@ impl PipeScreen {
         self.resource_create_from_user(&tmpl, mem)
     }
 
+    /// Returns the row pitch of the first level, if the driver is able to report it.
+    pub fn resource_stride(&self, res: &PipeResource) -> Option<u64> {
+        let mut stride = 0;
+        let ok = unsafe {
+            self.screen().resource_get_param?(
+                self.screen.as_ptr(),
+                ptr::null_mut(),
+                res.pipe(),
+                0,
+                0,
+                0,
+                pipe_resource_param::PIPE_RESOURCE_PARAM_STRIDE,
+                0,
+                &mut stride,
+            )
+        };
+
+        ok.then_some(stride)
+    }
+
     pub fn resource_import_dmabuf(
         &self,
         handle: u32,
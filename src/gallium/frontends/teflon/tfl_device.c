@@ -54,10 +54,16 @@ struct teflon_subgraph
 
    unsigned *output_tensors;
    unsigned output_count;
+
+   /* Reused across invocations to upload the input tensor. */
+   struct pipe_resource *input_resource;
+
+   /* Destination of each output tensor, refreshed on every invocation. */
+   void **output_buffers;
 };
 
-static struct pipe_resource *
-create_resource(struct pipe_context *context, TfLiteTensor tensor)
+static unsigned
+tensor_size(TfLiteTensor tensor)
 {
    unsigned bytes;
    unsigned size = 1;
@@ -90,7 +96,13 @@ create_resource(struct pipe_context *context, TfLiteTensor tensor)
          unreachable("Unsupported TF type");
    }
 
-   return pipe_buffer_create_with_data(context, 0, PIPE_USAGE_DEFAULT, size * bytes, tensor.data.data);
+   return size * bytes;
+}
+
+static struct pipe_resource *
+create_resource(struct pipe_context *context, TfLiteTensor tensor)
+{
+   return pipe_buffer_create_with_data(context, 0, PIPE_USAGE_DEFAULT, tensor_size(tensor), tensor.data.data);
 }
 
 static void
@@ -127,7 +139,7 @@ fill_operation(struct teflon_delegate *delegate, TfLiteContext *tf_context, TfLi
 }
 
 static void
-fill_tensor(struct teflon_delegate *delegate, TfLiteContext *tf_context, struct pipe_tensor *tensor, unsigned index)
+fill_tensor(struct teflon_delegate *delegate, TfLiteContext *tf_context, struct pipe_tensor *tensor, unsigned index, bool upload)
 {
    struct pipe_context *context = delegate->context;
    TfLiteTensor tf_tensor = tf_context->tensors[index];
@@ -136,7 +148,7 @@ fill_tensor(struct teflon_delegate *delegate, TfLiteContext *tf_context, struct
    if (tf_tensor.type == kTfLiteNoType)
       return; /* Placeholder tensor */
 
-   if (tf_tensor.data.data)
+   if (upload && tf_tensor.data.data)
       tensor->resource = create_resource(context, tf_tensor);
 
    tensor->index = index;
@@ -236,7 +248,7 @@ partition_init(TfLiteContext *tf_context, const char *buffer, size_t length)
    }
 
    for (int i = 0; i < tf_context->tensors_size; i++)
-      fill_tensor(delegate, tf_context, &tensors[i], i);
+      fill_tensor(delegate, tf_context, &tensors[i], i, true);
 
    for (int i = 0; i < params->nodes_to_replace->size; i++)
    {
@@ -277,6 +289,7 @@ partition_init(TfLiteContext *tf_context, const char *buffer, size_t length)
    tsubgraph->output_tensors = malloc(params->output_tensors->size * sizeof(*tsubgraph->output_tensors));
    memcpy(tsubgraph->output_tensors, params->output_tensors->data,
           params->output_tensors->size * sizeof(*tsubgraph->output_tensors));
+   tsubgraph->output_buffers = malloc(tsubgraph->output_count * sizeof(*tsubgraph->output_buffers));
 
    if (unlikely(debug_get_option_debug_teflon() & TEFLON_DEBUG_VERBOSE)) {
       struct timespec time;
@@ -305,8 +318,10 @@ partition_free(TfLiteContext *tf_context, void *buffer)
    struct pipe_context *context = subgraph->context;
 
    context->ml_subgraph_destroy(context, subgraph);
+   pipe_resource_reference(&tsubgraph->input_resource, NULL);
    free(tsubgraph->input_tensors);
    free(tsubgraph->output_tensors);
+   free(tsubgraph->output_buffers);
    free(tsubgraph);
 }
 
@@ -327,14 +342,25 @@ partition_invoke(TfLiteContext *tf_context, TfLiteNode *node)
 
    struct pipe_tensor input = {0};
    /* FIXME: Support mutiple inputs */
-   fill_tensor(delegate, tf_context, &input, tsubgraph->input_tensors[0]);
+   fill_tensor(delegate, tf_context, &input, tsubgraph->input_tensors[0], false);
+
+   /* Don't create and destroy a buffer for the input on every inference.
+    * pipe_buffer_write() synchronizes with any pending use of it by the
+    * previous invocation.
+    */
+   TfLiteTensor tf_input = tf_context->tensors[tsubgraph->input_tensors[0]];
+   unsigned input_size = tensor_size(tf_input);
+   if (!tsubgraph->input_resource)
+      tsubgraph->input_resource = pipe_buffer_create(context->screen, 0, PIPE_USAGE_DEFAULT, input_size);
+   pipe_buffer_write(context, tsubgraph->input_resource, 0, input_size, tf_input.data.data);
+   pipe_resource_reference(&input.resource, tsubgraph->input_resource);
    context->ml_subgraph_invoke(context, subgraph, &input);
 
-   void **buffers = malloc(tsubgraph->output_count * sizeof(*buffers));
+   /* TFLite may move tensor data between invocations, so look it up again. */
+   void **buffers = tsubgraph->output_buffers;
    for (unsigned i = 0; i < tsubgraph->output_count; i++)
       buffers[i] = tf_context->tensors[tsubgraph->output_tensors[i]].data.data;
    context->ml_subgraph_read_output(context, subgraph, tsubgraph->output_count, tsubgraph->output_tensors, buffers);
-   free(buffers);
 
    pipe_resource_reference(&input.resource, NULL);
 
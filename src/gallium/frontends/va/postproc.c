@@ -334,6 +334,23 @@ static VAStatus vlVaVidEngineBlit(vlVaDriver *drv, vlVaContext *context,
    return VA_STATUS_SUCCESS;
 }
 
+static bool vlVaBoxInside(const struct pipe_box *box,
+                          const struct pipe_resource *res)
+{
+   return box->x >= 0 && box->y >= 0 &&
+          box->x + box->width <= res->width0 &&
+          box->y + box->height <= res->height0;
+}
+
+static bool vlVaBlitIsCopy(const struct pipe_blit_info *blit)
+{
+   return blit->src.format == blit->dst.format &&
+          blit->src.box.width == blit->dst.box.width &&
+          blit->src.box.height == blit->dst.box.height &&
+          vlVaBoxInside(&blit->src.box, blit->src.resource) &&
+          vlVaBoxInside(&blit->dst.box, blit->dst.resource);
+}
+
 static VAStatus vlVaPostProcBlit(vlVaDriver *drv, vlVaContext *context,
                                  const VARectangle *src_region,
                                  const VARectangle *dst_region,
@@ -457,6 +474,17 @@ static VAStatus vlVaPostProcBlit(vlVaDriver *drv, vlVaContext *context,
       blit.dst.box.depth = 1;
       vlVaGetBox(dst, i, &blit.dst.box, dst_region);
 
+      /* Without scaling or format conversion a plain copy does the job and
+       * spares the driver the blit shader and sampler setup.
+       */
+      if (vlVaBlitIsCopy(&blit)) {
+         drv->pipe->resource_copy_region(drv->pipe, blit.dst.resource, 0,
+                                         blit.dst.box.x, blit.dst.box.y,
+                                         blit.dst.box.z, blit.src.resource, 0,
+                                         &blit.src.box);
+         continue;
+      }
+
       blit.mask = PIPE_MASK_RGBA;
       blit.filter = PIPE_TEX_MIPFILTER_LINEAR;
 
@@ -193,6 +193,7 @@ void amdgpu_bo_destroy(struct amdgpu_winsys *aws, struct pb_buffer_lean *_buf)
    }
    assert(bo->is_user_ptr || bo->map_count == 0);
 
+   p_atomic_inc(&aws->bo_handle_generation);
    amdgpu_bo_free(bo->bo_handle);
 
 #if MESA_DEBUG
@@ -1229,6 +1229,66 @@ static void amdgpu_cs_add_syncobj_signal(struct radeon_cmdbuf *rws,
    add_fence_to_list(&cs->syncobj_to_signal, (struct amdgpu_fence*)fence);
 }
 
+/* Submissions with fewer buffers always pass the BO list inline. */
+#define AMDGPU_MIN_KERNEL_BO_LIST_SIZE 1024
+
+static void amdgpu_cs_destroy_kernel_bo_list(struct amdgpu_cs *acs)
+{
+   if (acs->kernel_bo_list) {
+      amdgpu_bo_list_destroy_raw(acs->aws->dev, acs->kernel_bo_list);
+      acs->kernel_bo_list = 0;
+   }
+}
+
+/* Return a kernel BO list handle matching the BO list, or 0 if it should be passed inline.
+ *
+ * Passing the BO list inline makes the kernel look up every BO handle in every submission. When
+ * a large BO list is submitted twice without changes, a kernel BO list is created for it and
+ * reused until the BO list changes, so that the cost scales with changes instead.
+ */
+static uint32_t amdgpu_cs_get_kernel_bo_list(struct amdgpu_cs *acs,
+                                             const struct drm_amdgpu_bo_list_entry *bo_list,
+                                             unsigned num_buffers)
+{
+   struct amdgpu_winsys *aws = acs->aws;
+   /* The KMS handle of a closed BO can be reused by a new BO, which the kernel list doesn't contain. */
+   uint32_t generation = p_atomic_read(&aws->bo_handle_generation);
+
+   if (acs->last_bo_list && acs->last_bo_list_size == num_buffers &&
+       acs->last_bo_list_generation == generation &&
+       !memcmp(acs->last_bo_list, bo_list, num_buffers * sizeof(*bo_list))) {
+      if (!acs->kernel_bo_list &&
+          amdgpu_bo_list_create_raw(aws->dev, num_buffers,
+                                    (struct drm_amdgpu_bo_list_entry *)bo_list,
+                                    &acs->kernel_bo_list))
+         acs->kernel_bo_list = 0;
+
+      return acs->kernel_bo_list;
+   }
+
+   /* The kernel BO list holds references to its BOs, so don't keep it around when unused. */
+   amdgpu_cs_destroy_kernel_bo_list(acs);
+
+   if (num_buffers < AMDGPU_MIN_KERNEL_BO_LIST_SIZE) {
+      FREE(acs->last_bo_list);
+      acs->last_bo_list = NULL;
+      acs->last_bo_list_size = 0;
+      return 0;
+   }
+
+   if (acs->last_bo_list_size != num_buffers) {
+      FREE(acs->last_bo_list);
+      acs->last_bo_list = (struct drm_amdgpu_bo_list_entry *)MALLOC(num_buffers * sizeof(*bo_list));
+      acs->last_bo_list_size = acs->last_bo_list ? num_buffers : 0;
+   }
+
+   if (acs->last_bo_list) {
+      memcpy(acs->last_bo_list, bo_list, num_buffers * sizeof(*bo_list));
+      acs->last_bo_list_generation = generation;
+   }
+   return 0;
+}
+
 /* The template parameter determines whether the queue should skip code used by the default queue
  * system that's based on sequence numbers, and instead use and update amdgpu_winsys_bo::alt_fence
  * for all BOs.
@@ -1505,17 +1565,21 @@ static void amdgpu_cs_submit_ib(void *job, void *gdata, int thread_index)
    unsigned num_chunks = 0;
 
    /* BO list */
+   uint32_t kernel_bo_list = amdgpu_cs_get_kernel_bo_list(acs, bo_list, num_real_buffers);
    struct drm_amdgpu_bo_list_in bo_list_in;
-   bo_list_in.operation = ~0;
-   bo_list_in.list_handle = ~0;
-   bo_list_in.bo_number = num_real_buffers;
-   bo_list_in.bo_info_size = sizeof(struct drm_amdgpu_bo_list_entry);
-   bo_list_in.bo_info_ptr = (uint64_t)(uintptr_t)bo_list;
 
-   chunks[num_chunks].chunk_id = AMDGPU_CHUNK_ID_BO_HANDLES;
-   chunks[num_chunks].length_dw = sizeof(struct drm_amdgpu_bo_list_in) / 4;
-   chunks[num_chunks].chunk_data = (uintptr_t)&bo_list_in;
-   num_chunks++;
+   if (!kernel_bo_list) {
+      bo_list_in.operation = ~0;
+      bo_list_in.list_handle = ~0;
+      bo_list_in.bo_number = num_real_buffers;
+      bo_list_in.bo_info_size = sizeof(struct drm_amdgpu_bo_list_entry);
+      bo_list_in.bo_info_ptr = (uint64_t)(uintptr_t)bo_list;
+
+      chunks[num_chunks].chunk_id = AMDGPU_CHUNK_ID_BO_HANDLES;
+      chunks[num_chunks].length_dw = sizeof(struct drm_amdgpu_bo_list_in) / 4;
+      chunks[num_chunks].chunk_data = (uintptr_t)&bo_list_in;
+      num_chunks++;
+   }
 
    /* Syncobj dependencies. */
    unsigned num_syncobj_dependencies = cs->syncobj_dependencies.num;
@@ -1629,7 +1693,8 @@ static void amdgpu_cs_submit_ib(void *job, void *gdata, int thread_index)
          if (r == -ENOMEM)
             os_time_sleep(1000);
 
-         r = amdgpu_cs_submit_raw2(aws->dev, acs->ctx->ctx, 0, num_chunks, chunks, &seq_no);
+         r = amdgpu_cs_submit_raw2(aws->dev, acs->ctx->ctx, kernel_bo_list, num_chunks, chunks,
+                                   &seq_no);
       } while (r == -ENOMEM);
 
       if (!r) {
@@ -1855,6 +1920,8 @@ static void amdgpu_cs_destroy(struct radeon_cmdbuf *rcs)
       return;
 
    amdgpu_cs_sync_flush(rcs);
+   amdgpu_cs_destroy_kernel_bo_list(cs);
+   FREE(cs->last_bo_list);
    util_queue_fence_destroy(&cs->flush_completed);
    p_atomic_dec(&cs->aws->num_cs);
    radeon_bo_reference(&cs->aws->dummy_sws.base, &cs->preamble_ib_bo, NULL);
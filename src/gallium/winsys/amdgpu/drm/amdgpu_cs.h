@@ -158,6 +158,14 @@ struct amdgpu_cs {
    struct pb_buffer_lean *preamble_ib_bo;
 
    struct drm_amdgpu_cs_chunk_cp_gfx_shadow mcbp_fw_shadow_chunk;
+
+   /* The BO list of the last large submission and the kernel BO list created for it when it was
+    * submitted again unchanged. Only accessed by the submission thread.
+    */
+   struct drm_amdgpu_bo_list_entry *last_bo_list;
+   unsigned last_bo_list_size;
+   uint32_t last_bo_list_generation;
+   uint32_t kernel_bo_list;
 };
 
 struct amdgpu_fence {
@@ -205,6 +205,8 @@ struct amdgpu_winsys {
    uint32_t surf_index_color;
    uint32_t surf_index_fmask;
    uint32_t next_bo_unique_id;
+   /* Incremented before a KMS handle is closed, which invalidates persistent kernel BO lists. */
+   uint32_t bo_handle_generation;
    uint64_t allocated_vram;
    uint64_t allocated_gtt;
    uint64_t mapped_vram;
@@ -227,6 +227,13 @@ brw_get_compiler_config_value(const struct brw_compiler *compiler)
    u_foreach_bit64(bit, mask)
       insert_u64_bit(&config, (compiler->mesh.mue_header_packing & (1ULL << bit)) != 0);
 
+   /* spilling_rate is in [0, 100] */
+   mask = 0x7f;
+   bits += util_bitcount64(mask);
+
+   u_foreach_bit64(bit, mask)
+      insert_u64_bit(&config, (compiler->spilling_rate & (1ULL << bit)) != 0);
+
    assert(bits <= util_bitcount64(UINT64_MAX));
 
    return config;
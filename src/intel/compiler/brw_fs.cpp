@@ -2876,13 +2876,15 @@ fs_visitor::allocate_registers(bool allow_spilling)
       /* We should only spill registers on the last scheduling. */
       assert(!spilled_any_registers);
 
-      allocated = assign_regs(false, spill_all);
-      if (allocated)
-         break;
-
       /* Save the maximum register pressure */
       uint32_t this_pressure = compute_max_register_pressure();
 
+      allocated = assign_regs(false, spill_all);
+      if (allocated) {
+         allocated_register_pressure = this_pressure;
+         break;
+      }
+
       if (0) {
          fprintf(stderr, "Scheduler mode \"%s\" spilled, max pressure = %u\n",
                  scheduler_mode_name[sched_mode], this_pressure);
@@ -2909,6 +2911,7 @@ fs_visitor::allocate_registers(bool allow_spilling)
       }
       restore_instruction_order(cfg, best_pressure_order);
       shader_stats.scheduler_mode = scheduler_mode_name[best_sched];
+      allocated_register_pressure = best_register_pressure;
 
       allocated = assign_regs(allow_spilling, spill_all);
    }
@@ -3778,6 +3781,37 @@ brw_nir_populate_wm_prog_data(nir_shader *shader,
    brw_compute_flat_inputs(prog_data, shader);
 }
 
+/**
+ * Guess whether compiling the shader at \p width would run out of registers,
+ * going by the register pressure \p narrower was allocated with.  Nearly
+ * every non-uniform value grows with the dispatch width, so the scaled
+ * pressure is a fair estimate; the slack covers uniform values and what the
+ * schedulers may win back at the wider width.
+ */
+static bool
+brw_simd_predict_spill(const fs_visitor *narrower, unsigned width)
+{
+   const unsigned capacity = BRW_MAX_GRF * reg_unit(narrower->devinfo);
+   const unsigned estimate = narrower->allocated_register_pressure *
+                             (width / narrower->dispatch_width);
+
+   return estimate > capacity + capacity / 4;
+}
+
+/**
+ * With INTEL_DEBUG=simd-predict, widths predicted to spill are compiled
+ * anyway and the outcome is compared with the prediction here.
+ */
+static void
+brw_simd_report_prediction(const fs_visitor *narrower, unsigned width,
+                           bool predicted_spill, bool compiled)
+{
+   fprintf(stderr, "SIMD%u predicted to %s from SIMD%u pressure %u: %s\n",
+           width, predicted_spill ? "spill" : "fit",
+           narrower->dispatch_width, narrower->allocated_register_pressure,
+           predicted_spill != compiled ? "correct" : "wrong");
+}
+
 const unsigned *
 brw_compile_fs(const struct brw_compiler *compiler,
                struct brw_compile_fs_params *params)
@@ -3888,11 +3922,29 @@ brw_compile_fs(const struct brw_compiler *compiler,
    const bool simd16_failed = v16 && !simd16_cfg;
 
    /* Currently, the compiler only supports SIMD32 on SNB+ */
-   if (!has_spilled &&
-       (!v8 || v8->max_dispatch_width >= 32) &&
-       (!v16 || v16->max_dispatch_width >= 32) && !params->use_rep_send &&
-       !simd16_failed &&
-       INTEL_SIMD(FS, 32)) {
+   bool try_simd32 = !has_spilled &&
+                     (!v8 || v8->max_dispatch_width >= 32) &&
+                     (!v16 || v16->max_dispatch_width >= 32) &&
+                     !params->use_rep_send &&
+                     !simd16_failed &&
+                     INTEL_SIMD(FS, 32);
+
+   /* Once a narrower variant exists SIMD32 isn't allowed to spill, so don't
+    * bother compiling it when it's clearly not going to fit.
+    */
+   const fs_visitor *simd32_ref = simd16_cfg ? v16.get() :
+                                  simd8_cfg ? v8.get() : NULL;
+   const bool simd32_predict_spill =
+      simd32_ref && brw_simd_predict_spill(simd32_ref, 32);
+
+   if (try_simd32 && simd32_predict_spill &&
+       !INTEL_DEBUG(DEBUG_SIMD_PREDICT)) {
+      brw_shader_perf_log(compiler, params->base.log_data,
+                          "SIMD32 shader skipped, predicted to spill\n");
+      try_simd32 = false;
+   }
+
+   if (try_simd32) {
       /* Try a SIMD32 compile */
       v32 = std::make_unique<fs_visitor>(compiler, &params->base, key,
                                          prog_data, nir, 32, 1,
@@ -3903,7 +3955,14 @@ brw_compile_fs(const struct brw_compiler *compiler,
       else if (v16)
          v32->import_uniforms(v16.get());
 
-      if (!v32->run_fs(allow_spilling, false)) {
+      const bool simd32_compiled = v32->run_fs(allow_spilling, false);
+
+      if (simd32_ref && INTEL_DEBUG(DEBUG_SIMD_PREDICT)) {
+         brw_simd_report_prediction(simd32_ref, 32, simd32_predict_spill,
+                                    simd32_compiled);
+      }
+
+      if (!simd32_compiled) {
          brw_shader_perf_log(compiler, params->base.log_data,
                              "SIMD32 shader failed to compile: %s\n",
                              v32->fail_msg);
@@ -4192,6 +4251,26 @@ brw_compile_cs(const struct brw_compiler *compiler,
 
       const unsigned dispatch_width = 8u << simd;
 
+      const int first = brw_simd_first_compiled(simd_state);
+      const bool allow_spilling = first < 0 || nir->info.workgroup_size_variable;
+
+      /* Without spilling, skip widths that are predicted not to fit. */
+      const fs_visitor *narrower = NULL;
+      if (!allow_spilling) {
+         narrower = simd_state.compiled[simd - 1] ? v[simd - 1].get() :
+                                                    v[first].get();
+      }
+      const bool predict_spill =
+         narrower && brw_simd_predict_spill(narrower, dispatch_width);
+
+      if (predict_spill && !INTEL_DEBUG(DEBUG_SIMD_PREDICT)) {
+         simd_state.error[simd] = "Predicted to spill";
+         brw_shader_perf_log(compiler, params->base.log_data,
+                             "SIMD%u shader skipped, predicted to spill\n",
+                             dispatch_width);
+         continue;
+      }
+
       nir_shader *shader = nir_shader_clone(params->base.mem_ctx, nir);
       brw_nir_apply_key(shader, compiler, &key->base,
                         dispatch_width);
@@ -4212,13 +4291,17 @@ brw_compile_cs(const struct brw_compiler *compiler,
                                              params->base.stats != NULL,
                                              debug_enabled);
 
-      const int first = brw_simd_first_compiled(simd_state);
       if (first >= 0)
          v[simd]->import_uniforms(v[first].get());
 
-      const bool allow_spilling = first < 0 || nir->info.workgroup_size_variable;
+      const bool compiled = v[simd]->run_cs(allow_spilling);
+
+      if (narrower && INTEL_DEBUG(DEBUG_SIMD_PREDICT)) {
+         brw_simd_report_prediction(narrower, dispatch_width, predict_spill,
+                                    compiled);
+      }
 
-      if (v[simd]->run_cs(allow_spilling)) {
+      if (compiled) {
          cs_fill_push_const_info(compiler->devinfo, prog_data);
 
          brw_simd_mark_compiled(simd_state, simd, v[simd]->spilled_any_registers);
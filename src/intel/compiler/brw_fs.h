@@ -440,6 +440,13 @@ public:
    bool spilled_any_registers;
    bool needs_register_pressure;
 
+   /**
+    * Maximum register pressure of the instruction order that was register
+    * allocated, in REG_SIZE units.  Used to guess whether a wider variant
+    * of the same shader would fit.
+    */
+   unsigned allocated_register_pressure;
+
    const unsigned dispatch_width; /**< 8, 16 or 32 */
    const unsigned max_polygons;
    unsigned max_dispatch_width;
@@ -1119,6 +1119,7 @@ fs_visitor::init()
 
    this->grf_used = 0;
    this->spilled_any_registers = false;
+   this->allocated_register_pressure = 0;
 }
 
 fs_visitor::~fs_visitor()
@@ -165,6 +165,13 @@ elk_get_compiler_config_value(const struct elk_compiler *compiler)
    mask = 3;
    bits += util_bitcount64(mask);
 
+   /* spilling_rate is in [0, 100] */
+   mask = 0x7f;
+   bits += util_bitcount64(mask);
+
+   u_foreach_bit64(bit, mask)
+      insert_u64_bit(&config, (compiler->spilling_rate & (1ULL << bit)) != 0);
+
    assert(bits <= util_bitcount64(UINT64_MAX));
 
    return config;
@@ -96,6 +96,7 @@ extern uint64_t intel_debug;
 #define DEBUG_SPARSE              (1ull << 48)
 #define DEBUG_DRAW_BKP            (1ull << 49)
 #define DEBUG_BATCH_STATS         (1ull << 50)
+#define DEBUG_SIMD_PREDICT        (1ull << 51)
 
 #define DEBUG_ANY                 (~0ull)
 
@@ -105,7 +106,8 @@ extern uint64_t intel_debug;
 /* These flags may affect program generation */
 #define DEBUG_DISK_CACHE_MASK \
    (DEBUG_NO_DUAL_OBJECT_GS | DEBUG_SPILL_FS | \
-   DEBUG_SPILL_VEC4 | DEBUG_NO_COMPACTION | DEBUG_DO32 | DEBUG_SOFT64)
+   DEBUG_SPILL_VEC4 | DEBUG_NO_COMPACTION | DEBUG_DO32 | DEBUG_SOFT64 | \
+   DEBUG_SIMD_PREDICT)
 
 extern uint64_t intel_simd;
 extern uint32_t intel_debug_bkp_before_draw_count;
@@ -8,6 +8,8 @@
 
 #include "intel_pps_driver.h"
 
+#include <iterator>
+
 #include <dirent.h>
 #include <fcntl.h>
 #include <math.h>
@@ -192,9 +194,6 @@ std::vector<PerfRecord> IntelDriver::parse_perf_records(const std::vector<uint8_
    std::vector<PerfRecord> records;
    records.reserve(128);
 
-   PerfRecord record;
-   record.data.reserve(512);
-
    const uint8_t *iter = data.data();
    const uint8_t *end = iter + byte_count;
 
@@ -234,10 +233,8 @@ std::vector<PerfRecord> IntelDriver::parse_perf_records(const std::vector<uint8_
             prev_gpu_timestamp = gpu_timestamp;
 
             // Add the new record to the list
-            record.timestamp = gpu_timestamp;
-            record.data.resize(header->size); // Possibly 264?
-            memcpy(record.data.data(), iter, header->size);
-            records.emplace_back(record);
+            records.push_back({gpu_timestamp,
+                               std::vector<uint8_t>(iter, iter + header->size)});
          }
       }
 
@@ -286,7 +283,9 @@ bool IntelDriver::dump_perfcnt()
       total_bytes_read = 0;
    }
 
-   APPEND(records, new_records);
+   records.insert(std::end(records),
+                  std::make_move_iterator(std::begin(new_records)),
+                  std::make_move_iterator(std::end(new_records)));
 
    if (records.size() < 2) {
       // Not enough records to accumulate
@@ -317,7 +316,7 @@ uint64_t IntelDriver::gpu_next()
    auto gpu_timestamp = records[1].timestamp;
 
    // Consume first record
-   records.erase(std::begin(records), std::begin(records) + 1);
+   records.pop_front();
 
    return intel_device_info_timebase_scale(&perf->devinfo, gpu_timestamp);
 }
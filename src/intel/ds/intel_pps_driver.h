@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include <pps/pps_driver.h>
 
 extern "C" {
@@ -82,7 +84,7 @@ class IntelDriver : public Driver
    size_t total_bytes_read = 0;
 
    /// List of OA perf records read so far
-   std::vector<PerfRecord> records;
+   std::deque<PerfRecord> records;
 
    std::unique_ptr<IntelPerf> perf;
 
@@ -425,6 +425,9 @@ get_device_extensions(const struct anv_physical_device *device,
       .ANDROID_native_buffer                 = true,
 #endif
       .GOOGLE_decorate_string                = true,
+#ifdef ANV_USE_WSI_PLATFORM
+      .GOOGLE_display_timing                 = true,
+#endif
       .GOOGLE_hlsl_functionality1            = true,
       .GOOGLE_user_type                      = true,
       .INTEL_performance_query               = device->perf &&
@@ -3400,6 +3403,12 @@ VkResult anv_CreateDevice(
                       device->physical->va.high_heap.addr,
                       device->physical->va.high_heap.size);
 
+   /* BOs get created and destroyed a lot, mostly with the same few sizes.
+    * Caching their VA ranges keeps the time spent under vma_mutex short.
+    */
+   util_vma_heap_enable_cache(&device->vma_lo, 16 * 1024 * 1024);
+   util_vma_heap_enable_cache(&device->vma_hi, 16 * 1024 * 1024);
+
    if (device->physical->indirect_descriptors) {
       util_vma_heap_init(&device->vma_desc,
                          device->physical->va.indirect_descriptor_pool.addr,
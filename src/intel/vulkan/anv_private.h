@@ -1327,6 +1327,9 @@ struct anv_queue {
    /** Context/Engine id which executes companion RCS command buffer */
    uint32_t                                  companion_rcs_id;
 
+   /** Number of BOs in the last execbuf, used to size the next one (i915) */
+   uint32_t                                  last_exec_bo_count;
+
    /** Synchronization object for debug purposes (DEBUG_SYNC) */
    struct vk_sync                           *sync;
 
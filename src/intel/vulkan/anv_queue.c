@@ -79,6 +79,10 @@ anv_queue_init(struct anv_device *device, struct anv_queue *queue,
       return result;
 
    queue->vk.driver_submit = anv_queue_submit;
+   /* anv_queue_submit() splits any list of command buffers into chainable
+    * runs, so back-to-back submits from the submit thread can be merged.
+    */
+   queue->vk.submit.merge = true;
    queue->device = device;
    queue->family = queue_family;
    queue->decoder = &device->decoder[queue->vk.queue_family_index];
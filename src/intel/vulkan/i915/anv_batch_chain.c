@@ -40,6 +40,9 @@ struct anv_execbuf {
    uint32_t                                  bo_array_length;
    struct anv_bo **                          bos;
 
+   /* Initial size of the BO arrays, to avoid growing them on every submit */
+   uint32_t                                  bo_count_hint;
+
    uint32_t                                  syncobj_count;
    uint32_t                                  syncobj_array_length;
    struct drm_i915_gem_exec_fence *          syncobjs;
@@ -106,7 +109,8 @@ anv_execbuf_add_bo(struct anv_device *device,
        * an id that we can use later.
        */
       if (exec->bo_count >= exec->bo_array_length) {
-         uint32_t new_len = exec->objects ? exec->bo_array_length * 2 : 64;
+         uint32_t new_len = exec->objects ? exec->bo_array_length * 2 :
+            MAX2(64, util_next_power_of_two(exec->bo_count_hint));
 
          struct drm_i915_gem_exec_object2 *new_objects =
             vk_realloc(exec->alloc, exec->objects,
@@ -797,6 +801,7 @@ i915_queue_exec_locked(struct anv_queue *queue,
       .alloc = &queue->device->vk.alloc,
       .alloc_scope = VK_SYSTEM_ALLOCATION_SCOPE_DEVICE,
       .perf_query_pass = perf_query_pass,
+      .bo_count_hint = queue->last_exec_bo_count,
    };
    VkResult result;
 
@@ -919,6 +924,8 @@ i915_queue_exec_locked(struct anv_queue *queue,
 
    ANV_RMV(bos_gtt_map, device, execbuf.bos, execbuf.bo_count);
 
+   queue->last_exec_bo_count = execbuf.bo_count;
+
    int ret = queue->device->info->no_hw ? 0 :
       anv_gem_execbuffer(queue->device, &execbuf.execbuf);
    if (ret) {
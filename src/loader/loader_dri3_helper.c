@@ -22,6 +22,7 @@
  */
 
 #include <fcntl.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
@@ -236,6 +237,82 @@ loader_dri3_blit_image(struct loader_dri3_drawable *draw,
    return dri_context != NULL;
 }
 
+static void
+dri3_linear_damage_add(struct loader_dri3_buffer *buffer, const int box[4])
+{
+   int *damage = buffer->linear_damage;
+
+   if (damage[0] >= damage[2]) {
+      memcpy(damage, box, sizeof(buffer->linear_damage));
+   } else {
+      damage[0] = MIN2(damage[0], box[0]);
+      damage[1] = MIN2(damage[1], box[1]);
+      damage[2] = MAX2(damage[2], box[2]);
+      damage[3] = MAX2(damage[3], box[3]);
+   }
+}
+
+static void
+dri3_linear_damage_set_full(struct loader_dri3_buffer *buffer)
+{
+   const int box[4] = { 0, 0, INT_MAX, INT_MAX };
+
+   memcpy(buffer->linear_damage, box, sizeof(buffer->linear_damage));
+}
+
+/**
+ * Update the linear buffer of the back buffer from its image, for the
+ * render gpu != display gpu case.
+ *
+ * The linear buffer of a back buffer still holds what was presented the
+ * last time the buffer was used, so only what changed since then has to be
+ * copied. That is the damage of all the swaps since, which is why the
+ * damage of every swap is added to all the buffers.
+ *
+ * \param rects[in]  Damage rectangles of this swap, in GL coordinates.
+ * \param n_rects[in]  Number of damage rectangles, 0 means everything.
+ */
+static void
+dri3_update_linear_buffer(struct loader_dri3_drawable *draw,
+                          struct loader_dri3_buffer *back,
+                          const int *rects, int n_rects)
+{
+   int box[4] = { 0, 0, INT_MAX, INT_MAX };
+
+   if (n_rects > 0) {
+      box[0] = box[1] = INT_MAX;
+      box[2] = box[3] = INT_MIN;
+
+      for (int i = 0; i < n_rects; i++) {
+         const int *rect = &rects[i * 4];
+         const int y = draw->height - rect[1] - rect[3];
+
+         box[0] = MIN2(box[0], rect[0]);
+         box[1] = MIN2(box[1], y);
+         box[2] = MAX2(box[2], rect[0] + rect[2]);
+         box[3] = MAX2(box[3], y + rect[3]);
+      }
+   }
+
+   for (int i = 0; i < LOADER_DRI3_NUM_BUFFERS; i++) {
+      if (draw->buffers[i])
+         dri3_linear_damage_add(draw->buffers[i], box);
+   }
+
+   const int x0 = MAX2(back->linear_damage[0], 0);
+   const int y0 = MAX2(back->linear_damage[1], 0);
+   const int x1 = MIN2(back->linear_damage[2], (int)back->width);
+   const int y1 = MIN2(back->linear_damage[3], (int)back->height);
+
+   if (x0 < x1 && y0 < y1) {
+      (void) loader_dri3_blit_image(draw, back->linear_buffer, back->image,
+                                    x0, y0, x1 - x0, y1 - y0, x0, y0,
+                                    __BLIT_FLAG_FLUSH);
+   }
+
+   back->linear_damage[0] = back->linear_damage[2] = 0;
+}
+
 static inline void
 dri3_fence_reset(xcb_connection_t *c, struct loader_dri3_buffer *buffer)
 {
@@ -861,6 +938,7 @@ loader_dri3_copy_sub_buffer(struct loader_dri3_drawable *draw,
                                     back->image,
                                     0, 0, back->width, back->height,
                                     0, 0, __BLIT_FLAG_FLUSH);
+      back->linear_damage[0] = back->linear_damage[2] = 0;
    }
 
    loader_dri3_swapbuffer_barrier(draw);
@@ -1052,11 +1130,7 @@ loader_dri3_swap_buffers_msc(struct loader_dri3_drawable *draw,
 
    if (draw->dri_screen_render_gpu != draw->dri_screen_display_gpu) {
       /* Update the linear buffer before presenting the pixmap */
-      (void) loader_dri3_blit_image(draw,
-                                    back->linear_buffer,
-                                    back->image,
-                                    0, 0, back->width, back->height,
-                                    0, 0, __BLIT_FLAG_FLUSH);
+      dri3_update_linear_buffer(draw, back, rects, n_rects);
    }
 
    /* If we need to preload the new back buffer, remember the source.
@@ -1455,6 +1529,8 @@ dri3_alloc_render_buffer(struct loader_dri3_drawable *draw, unsigned int format,
    if (!buffer)
       goto no_buffer;
 
+   dri3_linear_damage_set_full(buffer);
+
    buffer->cpp = dri3_cpp_for_format(format);
    if (!buffer->cpp)
       goto no_image;
@@ -1949,6 +2025,8 @@ dri3_get_pixmap_buffer(__DRIdrawable *driDrawable, unsigned int format,
    if (!buffer)
       goto no_buffer;
 
+   dri3_linear_damage_set_full(buffer);
+
    fence_fd = xshmfence_alloc_shm();
    if (fence_fd < 0)
       goto no_fence;
@@ -51,6 +51,11 @@ struct loader_dri3_buffer {
     */
    __DRIimage   *linear_buffer;
 
+   /* Bounding box (x0, y0, x1, y1) of what changed in the image since the
+    * linear buffer was last updated from it, empty if x0 >= x1.
+    */
+   int          linear_damage[4];
+
    /* Synchronization between the client and X server is done using an
     * xshmfence that is mapped into an X server SyncFence. This lets the
     * client check whether the X server is done using a buffer with a simple
@@ -1677,6 +1677,38 @@ invalidate_saved_current_state(struct gl_context *ctx)
 }
 
 
+/**
+ * Bit in gl_dlist_state::Current::KnownEnabled/KnownDisabled for the
+ * capabilities legacy applications commonly toggle inside display lists,
+ * or 0 if the capability isn't tracked.
+ */
+static uint32_t
+dlist_cap_bit(GLenum cap)
+{
+   switch (cap) {
+   case GL_LIGHTING:             return 1u << 0;
+   case GL_DEPTH_TEST:           return 1u << 1;
+   case GL_BLEND:                return 1u << 2;
+   case GL_CULL_FACE:            return 1u << 3;
+   case GL_COLOR_MATERIAL:       return 1u << 4;
+   case GL_NORMALIZE:            return 1u << 5;
+   case GL_RESCALE_NORMAL:       return 1u << 6;
+   case GL_POLYGON_OFFSET_FILL:  return 1u << 7;
+   case GL_POLYGON_OFFSET_LINE:  return 1u << 8;
+   case GL_LINE_STIPPLE:         return 1u << 9;
+   case GL_POLYGON_STIPPLE:      return 1u << 10;
+   case GL_LINE_SMOOTH:          return 1u << 11;
+   case GL_ALPHA_TEST:           return 1u << 12;
+   case GL_FOG:                  return 1u << 13;
+   case GL_STENCIL_TEST:         return 1u << 14;
+   default:
+      if (cap >= GL_LIGHT0 && cap < GL_LIGHT0 + 8)
+         return 1u << (16 + cap - GL_LIGHT0);
+      return 0;
+   }
+}
+
+
 static void GLAPIENTRY
 save_CallList(GLuint list)
 {
@@ -2264,11 +2296,22 @@ save_Disable(GLenum cap)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
-   n = alloc_instruction(ctx, OPCODE_DISABLE, 1);
-   if (n) {
-      n[1].e = cap;
+   const uint32_t bit = dlist_cap_bit(cap);
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   /* Don't compile no-op state changes, see save_ShadeModel. */
+   if (!bit || !(ctx->ListState.Current.KnownDisabled & bit)) {
+      SAVE_FLUSH_VERTICES(ctx);
+
+      ctx->ListState.Current.KnownEnabled &= ~bit;
+      ctx->ListState.Current.KnownDisabled |= bit;
+
+      n = alloc_instruction(ctx, OPCODE_DISABLE, 1);
+      if (n) {
+         n[1].e = cap;
+      }
    }
+
    if (ctx->ExecuteFlag) {
       CALL_Disable(ctx->Dispatch.Exec, (cap));
    }
@@ -2281,6 +2324,12 @@ save_Disablei(GLuint index, GLenum cap)
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
    ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+
+   /* Forget what save_Enable/save_Disable know about this cap. */
+   const uint32_t bit = dlist_cap_bit(cap);
+   ctx->ListState.Current.KnownEnabled &= ~bit;
+   ctx->ListState.Current.KnownDisabled &= ~bit;
+
    n = alloc_instruction(ctx, OPCODE_DISABLE_INDEXED, 2);
    if (n) {
       n[1].ui = index;
@@ -2339,11 +2388,22 @@ save_Enable(GLenum cap)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
-   n = alloc_instruction(ctx, OPCODE_ENABLE, 1);
-   if (n) {
-      n[1].e = cap;
+   const uint32_t bit = dlist_cap_bit(cap);
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   /* Don't compile no-op state changes, see save_ShadeModel. */
+   if (!bit || !(ctx->ListState.Current.KnownEnabled & bit)) {
+      SAVE_FLUSH_VERTICES(ctx);
+
+      ctx->ListState.Current.KnownEnabled |= bit;
+      ctx->ListState.Current.KnownDisabled &= ~bit;
+
+      n = alloc_instruction(ctx, OPCODE_ENABLE, 1);
+      if (n) {
+         n[1].e = cap;
+      }
    }
+
    if (ctx->ExecuteFlag) {
       CALL_Enable(ctx->Dispatch.Exec, (cap));
    }
@@ -2357,6 +2417,12 @@ save_Enablei(GLuint index, GLenum cap)
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
    ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
+
+   /* Forget what save_Enable/save_Disable know about this cap. */
+   const uint32_t bit = dlist_cap_bit(cap);
+   ctx->ListState.Current.KnownEnabled &= ~bit;
+   ctx->ListState.Current.KnownDisabled &= ~bit;
+
    n = alloc_instruction(ctx, OPCODE_ENABLE_INDEXED, 2);
    if (n) {
       n[1].ui = index;
@@ -2765,11 +2831,23 @@ save_LineWidth(GLfloat width)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
-   n = alloc_instruction(ctx, OPCODE_LINE_WIDTH, 1);
-   if (n) {
-      n[1].f = width;
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   /* Don't compile no-op state changes, see save_ShadeModel.  0 means
+    * unknown, and invalid widths are always compiled so that they raise
+    * their error at execution time.
+    */
+   if (width <= 0.0f || ctx->ListState.Current.LineWidth != width) {
+      SAVE_FLUSH_VERTICES(ctx);
+
+      ctx->ListState.Current.LineWidth = width > 0.0f ? width : 0.0f;
+
+      n = alloc_instruction(ctx, OPCODE_LINE_WIDTH, 1);
+      if (n) {
+         n[1].f = width;
+      }
    }
+
    if (ctx->ExecuteFlag) {
       CALL_LineWidth(ctx->Dispatch.Exec, (width));
    }
@@ -3039,11 +3117,20 @@ save_MatrixMode(GLenum mode)
 {
    GET_CURRENT_CONTEXT(ctx);
    Node *n;
-   ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
-   n = alloc_instruction(ctx, OPCODE_MATRIX_MODE, 1);
-   if (n) {
-      n[1].e = mode;
+   ASSERT_OUTSIDE_SAVE_BEGIN_END(ctx);
+
+   /* Don't compile no-op state changes, see save_ShadeModel. */
+   if (ctx->ListState.Current.MatrixMode != mode) {
+      SAVE_FLUSH_VERTICES(ctx);
+
+      ctx->ListState.Current.MatrixMode = mode;
+
+      n = alloc_instruction(ctx, OPCODE_MATRIX_MODE, 1);
+      if (n) {
+         n[1].e = mode;
+      }
    }
+
    if (ctx->ExecuteFlag) {
       CALL_MatrixMode(ctx->Dispatch.Exec, (mode));
    }
@@ -3400,6 +3487,12 @@ save_PopAttrib(void)
    GET_CURRENT_CONTEXT(ctx);
    ASSERT_OUTSIDE_SAVE_BEGIN_END_AND_FLUSH(ctx);
    (void) alloc_instruction(ctx, OPCODE_POP_ATTRIB, 0);
+
+   /* The popped state is whatever was pushed, not what this list set. */
+   bool use_loopback = ctx->ListState.Current.UseLoopback;
+   memset(&ctx->ListState.Current, 0, sizeof ctx->ListState.Current);
+   ctx->ListState.Current.UseLoopback = use_loopback;
+
    if (ctx->ExecuteFlag) {
       CALL_PopAttrib(ctx->Dispatch.Exec, ());
    }
@@ -13992,6 +14085,12 @@ _mesa_glthread_execute_list(struct gl_context *ctx, GLuint list)
          case OPCODE_ACTIVE_TEXTURE:   /* GL_ARB_multitexture */
             _mesa_glthread_ActiveTexture(ctx, n[1].e);
             break;
+         case OPCODE_BIND_TEXTURE:
+            _mesa_glthread_BindTexture(ctx, n[1].e, n[2].ui);
+            break;
+         case OPCODE_BIND_MULTITEXTURE:
+            _mesa_glthread_BindMultiTextureEXT(ctx, n[1].e, n[2].e, n[3].ui);
+            break;
          case OPCODE_MATRIX_PUSH:
             _mesa_glthread_MatrixPushEXT(ctx, n[1].e);
             break;
@@ -14036,6 +14135,8 @@ _mesa_glthread_should_execute_list(struct gl_context *ctx,
       case OPCODE_PUSH_ATTRIB:
       case OPCODE_PUSH_MATRIX:
       case OPCODE_ACTIVE_TEXTURE:   /* GL_ARB_multitexture */
+      case OPCODE_BIND_TEXTURE:
+      case OPCODE_BIND_MULTITEXTURE:
       case OPCODE_MATRIX_PUSH:
       case OPCODE_MATRIX_POP:
          return true;
@@ -29,6 +29,8 @@
 #include "glformats.h"
 #include "format_pack.h"
 #include "format_unpack.h"
+#include "sse_swizzle.h"
+#include "util/u_cpu_detect.h"
 
 const mesa_array_format RGBA32_FLOAT =
    MESA_ARRAY_FORMAT(MESA_ARRAY_FORMAT_BASE_FORMAT_RGBA_VARIANTS,
@@ -1544,6 +1546,24 @@ _mesa_swizzle_and_convert(void *void_dst, enum mesa_array_format_datatype dst_ty
                                   swizzle, normalized, count))
       return;
 
+#if defined(USE_SSE41)
+   if (dst_type == MESA_ARRAY_FORMAT_TYPE_UBYTE &&
+       src_type == MESA_ARRAY_FORMAT_TYPE_UBYTE &&
+       num_dst_channels == 4 &&
+       (num_src_channels == 3 || num_src_channels == 4) &&
+       util_get_cpu_caps()->has_sse4_1) {
+      const int done =
+         _mesa_ubyte_swizzle_to_4_sse41(void_dst, void_src, num_src_channels,
+                                        swizzle, normalized ? UINT8_MAX : 1,
+                                        count);
+      void_dst = (uint8_t *)void_dst + done * 4;
+      void_src = (const uint8_t *)void_src + done * num_src_channels;
+      count -= done;
+      if (count == 0)
+         return;
+   }
+#endif
+
    switch (dst_type) {
    case MESA_ARRAY_FORMAT_TYPE_FLOAT:
       convert_float(void_dst, num_dst_channels, void_src, src_type,
@@ -37,7 +37,10 @@
 #include "main/glthread_marshal.h"
 #include "main/hash.h"
 #include "main/pixelstore.h"
+#include "main/texobj.h"
+#include "util/hash_table.h"
 #include "util/u_atomic.h"
+#include "util/u_debug.h"
 #include "util/u_thread.h"
 #include "util/u_cpu_detect.h"
 #include "util/thread_sched.h"
@@ -245,6 +248,11 @@ _mesa_glthread_init(struct gl_context *ctx)
    glthread->used = 0;
    glthread->stats.queue = &glthread->queue;
 
+   if (debug_get_bool_option("MESA_GLTHREAD_REPORT_SYNCS", false)) {
+      glthread->sync_counts = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                                      _mesa_key_string_equal);
+   }
+
    _mesa_glthread_init_call_fence(&glthread->LastProgramChangeBatch);
    _mesa_glthread_init_call_fence(&glthread->LastDListChangeBatchIndex);
 
@@ -286,6 +294,15 @@ _mesa_glthread_destroy(struct gl_context *ctx)
       _mesa_DeinitHashTable(&glthread->VAOs, free_vao, NULL);
       _mesa_glthread_release_upload_buffer(ctx);
    }
+
+   if (glthread->sync_counts) {
+      hash_table_foreach(glthread->sync_counts, entry) {
+         fprintf(stderr, "glthread: %s synced %u times\n",
+                 (const char *)entry->key, (unsigned)(uintptr_t)entry->data);
+      }
+      _mesa_hash_table_destroy(glthread->sync_counts, NULL);
+      glthread->sync_counts = NULL;
+   }
 }
 
 void _mesa_glthread_enable(struct gl_context *ctx)
@@ -317,6 +334,10 @@ void _mesa_glthread_disable(struct gl_context *ctx)
    ctx->GLThread.enabled = false;
    ctx->GLApi = ctx->Dispatch.Current;
 
+   /* Texture bindings can change without glthread seeing them. */
+   memset(ctx->GLThread.UnknownTextureUnits, 0xff,
+          sizeof(ctx->GLThread.UnknownTextureUnits));
+
    /* Re-enable thread scheduling in st/mesa when glthread is disabled. */
    if (ctx->pipe->set_context_param && util_thread_scheduler_enabled())
       ctx->st->pin_thread_counter = 0;
@@ -437,8 +458,15 @@ _mesa_glthread_finish_before(struct gl_context *ctx, const char *func)
 {
    _mesa_glthread_finish(ctx);
 
-   /* Uncomment this if you want to know where glthread syncs. */
-   /*printf("fallback to sync: %s\n", func);*/
+   /* MESA_GLTHREAD_REPORT_SYNCS=1 prints where glthread synced at exit. */
+   struct hash_table *counts = ctx->GLThread.sync_counts;
+   if (unlikely(counts) && ctx->GLThread.enabled) {
+      struct hash_entry *entry = _mesa_hash_table_search(counts, func);
+      if (entry)
+         entry->data = (void *)((uintptr_t)entry->data + 1);
+      else
+         _mesa_hash_table_insert(counts, func, (void *)(uintptr_t)1);
+   }
 }
 
 void
@@ -524,3 +552,100 @@ _mesa_glthread_PixelStorei(struct gl_context *ctx, GLenum pname, GLint param)
       break;
    }
 }
+
+static void
+set_texture_binding(struct gl_context *ctx, unsigned unit, GLenum target,
+                    GLuint texture)
+{
+   struct glthread_state *glthread = &ctx->GLThread;
+   int index = _mesa_tex_target_to_index(ctx, target);
+
+   /* Invalid binds generate errors and don't change the state. */
+   if (unit >= MAX_COMBINED_TEXTURE_IMAGE_UNITS || index < 0)
+      return;
+
+   glthread->TextureBindings[unit][index] = texture;
+   glthread->NumTextureUnitsBound = MAX2(glthread->NumTextureUnitsBound,
+                                         unit + 1);
+}
+
+void
+_mesa_glthread_BindTexture(struct gl_context *ctx, GLenum target,
+                           GLuint texture)
+{
+   if (ctx->GLThread.ListMode == GL_COMPILE)
+      return;
+
+   set_texture_binding(ctx, ctx->GLThread.ActiveTexture, target, texture);
+}
+
+void
+_mesa_glthread_BindMultiTextureEXT(struct gl_context *ctx, GLenum texunit,
+                                   GLenum target, GLuint texture)
+{
+   if (ctx->GLThread.ListMode == GL_COMPILE)
+      return;
+
+   set_texture_binding(ctx, texunit - GL_TEXTURE0, target, texture);
+}
+
+void
+_mesa_glthread_BindTextures(struct gl_context *ctx, GLuint first,
+                            GLsizei count, const GLuint *textures)
+{
+   struct glthread_state *glthread = &ctx->GLThread;
+
+   if (count < 0 || first >= MAX_COMBINED_TEXTURE_IMAGE_UNITS)
+      return;
+
+   unsigned last = MIN2(first + count, MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+   for (unsigned unit = first; unit < last; unit++) {
+      /* Unbinding resets all targets, but binding a texture only changes
+       * the target of the texture, which glthread doesn't know.
+       */
+      if (textures && textures[unit - first]) {
+         BITSET_SET(glthread->UnknownTextureUnits, unit);
+      } else {
+         memset(glthread->TextureBindings[unit], 0,
+                sizeof(glthread->TextureBindings[unit]));
+         BITSET_CLEAR(glthread->UnknownTextureUnits, unit);
+      }
+   }
+   glthread->NumTextureUnitsBound = MAX2(glthread->NumTextureUnitsBound, last);
+}
+
+void
+_mesa_glthread_DeleteTextures(struct gl_context *ctx, GLsizei n,
+                              const GLuint *textures)
+{
+   struct glthread_state *glthread = &ctx->GLThread;
+
+   if (n < 0 || !textures)
+      return;
+
+   /* Deleted textures are unbound from all units of this context. */
+   for (unsigned unit = 0; unit < glthread->NumTextureUnitsBound; unit++) {
+      for (unsigned index = 0; index < NUM_TEXTURE_TARGETS; index++) {
+         GLuint bound = glthread->TextureBindings[unit][index];
+         if (!bound)
+            continue;
+
+         for (int i = 0; i < n; i++) {
+            if (textures[i] == bound) {
+               glthread->TextureBindings[unit][index] = 0;
+               break;
+            }
+         }
+      }
+   }
+}
+
+/* glPopAttrib(GL_TEXTURE_BIT) restores bindings that glthread doesn't save. */
+void
+_mesa_glthread_invalidate_texture_bindings(struct gl_context *ctx)
+{
+   struct glthread_state *glthread = &ctx->GLThread;
+
+   for (unsigned unit = 0; unit < glthread->NumTextureUnitsBound; unit++)
+      BITSET_SET(glthread->UnknownTextureUnits, unit);
+}
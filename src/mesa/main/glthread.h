@@ -57,6 +57,8 @@
 #include "compiler/shader_enums.h"
 #include "main/config.h"
 #include "main/hash.h"
+#include "main/menums.h"
+#include "util/bitset.h"
 #include "util/glheader.h"
 
 #ifdef __cplusplus
@@ -217,6 +219,9 @@ struct glthread_state
    unsigned pin_thread_counter;
    unsigned thread_sched_state;
 
+   /** Number of syncs per entrypoint, only with MESA_GLTHREAD_REPORT_SYNCS. */
+   struct hash_table *sync_counts;
+
    /** The ring of batches in memory. */
    struct glthread_batch batches[MARSHAL_MAX_BATCHES];
 
@@ -293,6 +298,13 @@ struct glthread_state
    GLuint CurrentReadFramebuffer;
    GLuint CurrentProgram;
 
+   /** Texture bindings for glGet, indexed by [unit][gl_texture_index]. */
+   GLuint TextureBindings[MAX_COMBINED_TEXTURE_IMAGE_UNITS][NUM_TEXTURE_TARGETS];
+   /** Units bound by calls that don't specify the target or by glPopAttrib. */
+   BITSET_DECLARE(UnknownTextureUnits, MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+   /** All units >= this have default bindings. */
+   unsigned NumTextureUnitsBound;
+
    /** The last added call of the given function. */
    struct marshal_cmd_CallList *LastCallList;
    struct marshal_cmd_BindBuffer *LastBindBuffer1;
@@ -404,6 +416,15 @@ void _mesa_glthread_UnrollDrawElements(struct gl_context *ctx,
 void _mesa_glthread_unbind_uploaded_vbos(struct gl_context *ctx);
 void _mesa_glthread_PixelStorei(struct gl_context *ctx, GLenum pname,
                                 GLint param);
+void _mesa_glthread_BindTexture(struct gl_context *ctx, GLenum target,
+                                GLuint texture);
+void _mesa_glthread_BindMultiTextureEXT(struct gl_context *ctx, GLenum texunit,
+                                        GLenum target, GLuint texture);
+void _mesa_glthread_BindTextures(struct gl_context *ctx, GLuint first,
+                                 GLsizei count, const GLuint *textures);
+void _mesa_glthread_DeleteTextures(struct gl_context *ctx, GLsizei n,
+                                   const GLuint *textures);
+void _mesa_glthread_invalidate_texture_bindings(struct gl_context *ctx);
 
 #ifdef __cplusplus
 }
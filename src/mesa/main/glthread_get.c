@@ -23,6 +23,40 @@
 
 #include "main/glthread_marshal.h"
 #include "main/dispatch.h"
+#include "main/texobj.h"
+
+static GLenum
+texture_binding_to_target(GLenum pname)
+{
+   switch (pname) {
+   case GL_TEXTURE_BINDING_1D:
+      return GL_TEXTURE_1D;
+   case GL_TEXTURE_BINDING_2D:
+      return GL_TEXTURE_2D;
+   case GL_TEXTURE_BINDING_3D:
+      return GL_TEXTURE_3D;
+   case GL_TEXTURE_BINDING_CUBE_MAP:
+      return GL_TEXTURE_CUBE_MAP;
+   case GL_TEXTURE_BINDING_RECTANGLE:
+      return GL_TEXTURE_RECTANGLE;
+   case GL_TEXTURE_BINDING_1D_ARRAY:
+      return GL_TEXTURE_1D_ARRAY;
+   case GL_TEXTURE_BINDING_2D_ARRAY:
+      return GL_TEXTURE_2D_ARRAY;
+   case GL_TEXTURE_BINDING_BUFFER:
+      return GL_TEXTURE_BUFFER;
+   case GL_TEXTURE_BINDING_EXTERNAL_OES:
+      return GL_TEXTURE_EXTERNAL_OES;
+   case GL_TEXTURE_BINDING_CUBE_MAP_ARRAY:
+      return GL_TEXTURE_CUBE_MAP_ARRAY;
+   case GL_TEXTURE_BINDING_2D_MULTISAMPLE:
+      return GL_TEXTURE_2D_MULTISAMPLE;
+   case GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY:
+      return GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+   default:
+      return GL_NONE;
+   }
+}
 
 uint32_t
 _mesa_unmarshal_GetIntegerv(struct gl_context *ctx,
@@ -46,6 +80,20 @@ _mesa_marshal_GetIntegerv(GLenum pname, GLint *p)
     * - CONTEXT_[A-Z]*(Const
     */
 
+   GLenum target = texture_binding_to_target(pname);
+   if (target != GL_NONE) {
+      unsigned unit = ctx->GLThread.ActiveTexture;
+      int index = _mesa_tex_target_to_index(ctx, target);
+
+      /* Unsupported targets and unknown units are handled by the driver. */
+      if (index < 0 || unit >= MAX_COMBINED_TEXTURE_IMAGE_UNITS ||
+          BITSET_TEST(ctx->GLThread.UnknownTextureUnits, unit))
+         goto sync;
+
+      *p = ctx->GLThread.TextureBindings[unit][index];
+      return;
+   }
+
    switch (pname) {
    case GL_ACTIVE_TEXTURE:
       *p = GL_TEXTURE0 + ctx->GLThread.ActiveTexture;
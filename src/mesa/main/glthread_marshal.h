@@ -638,8 +638,10 @@ _mesa_glthread_PopAttrib(struct gl_context *ctx)
    if (mask & (GL_LIGHTING_BIT | GL_ENABLE_BIT))
       ctx->GLThread.Lighting = attr->Lighting;
 
-   if (mask & GL_TEXTURE_BIT)
+   if (mask & GL_TEXTURE_BIT) {
       ctx->GLThread.ActiveTexture = attr->ActiveTexture;
+      _mesa_glthread_invalidate_texture_bindings(ctx);
+   }
 
    if (mask & GL_TRANSFORM_BIT) {
       ctx->GLThread.MatrixMode = attr->MatrixMode;
@@ -139,6 +139,9 @@ _mesa_MaxShaderCompilerThreadsKHR(GLuint count)
 
    ctx->Hint.MaxShaderCompilerThreads = count;
 
+   if (count && util_queue_is_initialized(&ctx->ShaderCompileQueue))
+      util_queue_adjust_num_threads(&ctx->ShaderCompileQueue, count, false);
+
    struct pipe_screen *screen = ctx->screen;
    if (screen->set_max_shader_compiler_threads)
       screen->set_max_shader_compiler_threads(screen, count);
@@ -2847,6 +2847,10 @@ struct gl_dlist_state
        * list.  Used to eliminate some redundant state changes.
        */
       GLenum16 ShadeModel;
+      GLenum16 MatrixMode;
+      GLfloat LineWidth;
+      uint32_t KnownEnabled;  /**< dlist_cap_bit() bits */
+      uint32_t KnownDisabled; /**< dlist_cap_bit() bits */
       bool UseLoopback;
    } Current;
 };
@@ -3614,6 +3618,11 @@ struct gl_context
 
    bool shader_builtin_ref;
 
+   /** Runs glCompileShader off the application thread, see
+    * GL_KHR_parallel_shader_compile.
+    */
+   struct util_queue ShaderCompileQueue;
+
    struct pipe_draw_start_count_bias *tmp_draws;
    unsigned num_tmp_draws;
 };
@@ -40,6 +40,7 @@
 #include "compiler/glsl/ir_uniform.h"
 
 #include "pipe/p_state.h"
+#include "util/u_queue.h"
 
 /**
  * Shader information needed by both gl_shader and gl_linked shader.
@@ -154,6 +155,9 @@ struct gl_shader
 
    enum gl_compile_status CompileStatus;
 
+   /** Signalled when a compile queued by glCompileShader has finished. */
+   struct util_queue_fence CompileFence;
+
    /** SHA1 of the pre-processed source used by the disk cache. */
    uint8_t disk_cache_sha1[SHA1_DIGEST_LENGTH];
    /** SHA1 of the original source before replacement, set by glShaderSource. */
@@ -38,6 +38,7 @@
 
 #include "util/glheader.h"
 #include "main/context.h"
+#include "main/debug_output.h"
 #include "draw_validate.h"
 #include "main/enums.h"
 #include "main/glspirv.h"
@@ -64,6 +65,7 @@
 #include "util/os_file.h"
 #include "util/list.h"
 #include "util/perf/cpu_trace.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_process.h"
 #include "util/u_string.h"
 #include "api_exec_decl.h"
@@ -247,6 +249,9 @@ _mesa_free_shader_state(struct gl_context *ctx)
    _mesa_reference_pipeline_object(ctx, &ctx->_Shader, NULL);
 
    assert(ctx->Shader.RefCount == 1);
+
+   if (util_queue_is_initialized(&ctx->ShaderCompileQueue))
+      util_queue_destroy(&ctx->ShaderCompileQueue);
 }
 
 
@@ -1035,6 +1040,17 @@ get_programiv(struct gl_context *ctx, GLuint program, GLenum pname,
 static void
 get_shaderiv(struct gl_context *ctx, GLuint name, GLenum pname, GLint *params)
 {
+   if (pname == GL_COMPLETION_STATUS_ARB && name) {
+      /* Don't wait for the compile job like the shader lookup does. */
+      struct gl_shader *shader = (struct gl_shader *)
+         _mesa_HashLookup(&ctx->Shared->ShaderObjects, name);
+
+      if (shader && shader->Type != GL_SHADER_PROGRAM_MESA) {
+         *params = util_queue_fence_is_signalled(&shader->CompileFence);
+         return;
+      }
+   }
+
    struct gl_shader *shader =
       _mesa_lookup_shader_err(ctx, name, "glGetShaderiv");
 
@@ -1049,10 +1065,6 @@ get_shaderiv(struct gl_context *ctx, GLuint name, GLenum pname, GLint *params)
    case GL_DELETE_STATUS:
       *params = shader->DeletePending;
       break;
-   case GL_COMPLETION_STATUS_ARB:
-      /* _mesa_glsl_compile_shader is not offloaded to other threads. */
-      *params = GL_TRUE;
-      return;
    case GL_COMPILE_STATUS:
       *params = shader->CompileStatus ? GL_TRUE : GL_FALSE;
       break;
@@ -1193,6 +1205,69 @@ ensure_builtin_types(struct gl_context *ctx)
    }
 }
 
+/**
+ * Compile the source of a shader and dump it as requested by MESA_GLSL.
+ * This may run on ctx->ShaderCompileQueue, so it must not touch mutable
+ * context state.
+ */
+static void
+compile_shader_source(struct gl_context *ctx, struct gl_shader *sh,
+                      GLbitfield flags)
+{
+   if (flags & (GLSL_DUMP | GLSL_SOURCE)) {
+      _mesa_log("GLSL source for %s shader %d:\n",
+              _mesa_shader_stage_to_string(sh->Stage), sh->Name);
+      _mesa_log_direct(sh->Source);
+   }
+
+   /* this call will set the shader->CompileStatus field to indicate if
+    * compilation was successful.
+    */
+   _mesa_glsl_compile_shader(ctx, sh, false, false, false);
+
+   if (flags & GLSL_LOG) {
+      _mesa_write_shader_to_file(sh);
+   }
+
+   if (flags & GLSL_DUMP) {
+      if (sh->CompileStatus) {
+         if (sh->ir) {
+            _mesa_log("GLSL IR for shader %d:\n", sh->Name);
+            _mesa_print_ir(_mesa_get_log_file(), sh->ir, NULL);
+         } else {
+            _mesa_log("No GLSL IR for shader %d (shader may be from "
+                      "cache)\n", sh->Name);
+         }
+         _mesa_log("\n\n");
+      } else {
+         _mesa_log("GLSL shader %d failed to compile.\n", sh->Name);
+      }
+      if (sh->InfoLog && sh->InfoLog[0] != 0) {
+         _mesa_log("GLSL shader %d info log:\n", sh->Name);
+         _mesa_log("%s\n", sh->InfoLog);
+      }
+   }
+}
+
+static void
+report_compile_errors(struct gl_context *ctx, struct gl_shader *sh,
+                      GLbitfield flags)
+{
+   if (!sh->CompileStatus) {
+      if (flags & GLSL_DUMP_ON_ERROR) {
+         _mesa_log("GLSL source for %s shader %d:\n",
+                 _mesa_shader_stage_to_string(sh->Stage), sh->Name);
+         _mesa_log("%s\n", sh->Source);
+         _mesa_log("Info Log:\n%s\n", sh->InfoLog);
+      }
+
+      if (flags & GLSL_REPORT_ERRORS) {
+         _mesa_debug(ctx, "Error compiling shader %u:\n%s\n",
+                     sh->Name, sh->InfoLog);
+      }
+   }
+}
+
 /**
  * Compile a shader.
  */
@@ -1220,56 +1295,74 @@ _mesa_compile_shader(struct gl_context *ctx, struct gl_shader *sh)
        */
       sh->CompileStatus = COMPILE_FAILURE;
    } else {
-      if (ctx->_Shader->Flags & (GLSL_DUMP | GLSL_SOURCE)) {
-         _mesa_log("GLSL source for %s shader %d:\n",
-                 _mesa_shader_stage_to_string(sh->Stage), sh->Name);
-         _mesa_log_direct(sh->Source);
-      }
-
       ensure_builtin_types(ctx);
+      compile_shader_source(ctx, sh, ctx->_Shader->Flags);
+   }
 
-      /* this call will set the shader->CompileStatus field to indicate if
-       * compilation was successful.
-       */
-      _mesa_glsl_compile_shader(ctx, sh, false, false, false);
+   report_compile_errors(ctx, sh, ctx->_Shader->Flags);
+}
 
-      if (ctx->_Shader->Flags & GLSL_LOG) {
-         _mesa_write_shader_to_file(sh);
-      }
+static void
+compile_shader_job(void *job, void *gdata, int thread_index)
+{
+   struct gl_shader *sh = (struct gl_shader *)job;
+   struct gl_context *ctx = (struct gl_context *)gdata;
 
-      if (ctx->_Shader->Flags & GLSL_DUMP) {
-         if (sh->CompileStatus) {
-            if (sh->ir) {
-               _mesa_log("GLSL IR for shader %d:\n", sh->Name);
-               _mesa_print_ir(_mesa_get_log_file(), sh->ir, NULL);
-            } else {
-               _mesa_log("No GLSL IR for shader %d (shader may be from "
-                         "cache)\n", sh->Name);
-            }
-            _mesa_log("\n\n");
-         } else {
-            _mesa_log("GLSL shader %d failed to compile.\n", sh->Name);
-         }
-         if (sh->InfoLog && sh->InfoLog[0] != 0) {
-            _mesa_log("GLSL shader %d info log:\n", sh->Name);
-            _mesa_log("%s\n", sh->InfoLog);
-         }
-      }
-   }
+   /* ctx->_Shader can be rebound meanwhile, but all pipeline objects get
+    * the same flags.
+    */
+   compile_shader_source(ctx, sh, ctx->Shader.Flags);
+   report_compile_errors(ctx, sh, ctx->Shader.Flags);
+}
 
-   if (!sh->CompileStatus) {
-      if (ctx->_Shader->Flags & GLSL_DUMP_ON_ERROR) {
-         _mesa_log("GLSL source for %s shader %d:\n",
-                 _mesa_shader_stage_to_string(sh->Stage), sh->Name);
-         _mesa_log("%s\n", sh->Source);
-         _mesa_log("Info Log:\n%s\n", sh->InfoLog);
-      }
+/**
+ * Whether glCompileShader can return before the shader is compiled.
+ */
+static bool
+can_compile_shader_async(struct gl_context *ctx, struct gl_shader *sh)
+{
+   if (!ctx->Hint.MaxShaderCompilerThreads || !sh->Source || sh->spirv_data)
+      return false;
 
-      if (ctx->_Shader->Flags & GLSL_REPORT_ERRORS) {
-         _mesa_debug(ctx, "Error compiling shader %u:\n%s\n",
-                     sh->Name, sh->InfoLog);
-      }
+   /* The preprocessor reads the shared shader include tree, which the
+    * application can change at any time.
+    */
+   if (strstr(sh->Source, "#include"))
+      return false;
+
+   /* Compiler messages must be delivered before glCompileShader returns. */
+   if (ctx->Debug &&
+       _mesa_get_debug_state_int(ctx, GL_DEBUG_OUTPUT_SYNCHRONOUS))
+      return false;
+
+   if (!util_queue_is_initialized(&ctx->ShaderCompileQueue)) {
+      unsigned num_threads = MIN2(ctx->Hint.MaxShaderCompilerThreads,
+                                  util_get_cpu_caps()->nr_cpus);
+
+      if (!util_queue_init(&ctx->ShaderCompileQueue, "glsl", 64,
+                           MAX2(num_threads, 1),
+                           UTIL_QUEUE_INIT_RESIZE_IF_FULL, ctx))
+         return false;
    }
+   return true;
+}
+
+/**
+ * glCompileShader: like _mesa_compile_shader, but the front-end compile
+ * runs on ctx->ShaderCompileQueue when possible. Everything that looks up
+ * the shader afterwards waits for it, see _mesa_lookup_shader.
+ */
+static void
+compile_shader_maybe_async(struct gl_context *ctx, struct gl_shader *sh)
+{
+   if (!sh || !can_compile_shader_async(ctx, sh)) {
+      _mesa_compile_shader(ctx, sh);
+      return;
+   }
+
+   ensure_builtin_types(ctx);
+   util_queue_add_job(&ctx->ShaderCompileQueue, sh, &sh->CompileFence,
+                      compile_shader_job, NULL, 0);
 }
 
 
@@ -1332,6 +1425,10 @@ link_program(struct gl_context *ctx, struct gl_shader_program *shProg,
 
    ensure_builtin_types(ctx);
 
+   /* Attached shaders may still be compiling on ctx->ShaderCompileQueue. */
+   for (unsigned i = 0; i < shProg->NumShaders; i++)
+      util_queue_fence_wait(&shProg->Shaders[i]->CompileFence);
+
    FLUSH_VERTICES(ctx, 0, 0);
    st_link_shader(ctx, shProg);
 
@@ -1631,8 +1728,8 @@ _mesa_CompileShader(GLuint shaderObj)
    GET_CURRENT_CONTEXT(ctx);
    if (MESA_VERBOSE & VERBOSE_API)
       _mesa_debug(ctx, "glCompileShader %u\n", shaderObj);
-   _mesa_compile_shader(ctx, _mesa_lookup_shader_err(ctx, shaderObj,
-                                                     "glCompileShader"));
+   compile_shader_maybe_async(ctx, _mesa_lookup_shader_err(ctx, shaderObj,
+                                                           "glCompileShader"));
 }
 
 
@@ -2344,6 +2441,10 @@ _mesa_ReleaseShaderCompiler(void)
 {
    GET_CURRENT_CONTEXT(ctx);
 
+   /* Queued compiles still need the built-in functions. */
+   if (util_queue_is_initialized(&ctx->ShaderCompileQueue))
+      util_queue_finish(&ctx->ShaderCompileQueue);
+
    if (ctx->shader_builtin_ref) {
       _mesa_glsl_builtin_functions_decref();
       ctx->shader_builtin_ref = false;
@@ -105,6 +105,7 @@ _mesa_init_shader(struct gl_shader *shader)
    shader->info.Geom.VerticesOut = -1;
    shader->info.Geom.InputType = MESA_PRIM_TRIANGLES;
    shader->info.Geom.OutputType = MESA_PRIM_TRIANGLE_STRIP;
+   util_queue_fence_init(&shader->CompileFence);
 }
 
 /**
@@ -130,6 +131,8 @@ _mesa_new_shader(GLuint name, gl_shader_stage stage)
 void
 _mesa_delete_shader(struct gl_context *ctx, struct gl_shader *sh)
 {
+   util_queue_fence_wait(&sh->CompileFence);
+   util_queue_fence_destroy(&sh->CompileFence);
    _mesa_shader_spirv_data_reference(&sh->spirv_data, NULL);
    free((void *)sh->Source);
    free((void *)sh->FallbackSource);
@@ -153,6 +156,9 @@ _mesa_delete_linked_shader(struct gl_context *ctx,
 
 /**
  * Lookup a GLSL shader object.
+ *
+ * This waits for any compilation of the shader queued by glCompileShader,
+ * so callers always see the final compile status and info log.
  */
 struct gl_shader *
 _mesa_lookup_shader(struct gl_context *ctx, GLuint name)
@@ -167,6 +173,8 @@ _mesa_lookup_shader(struct gl_context *ctx, GLuint name)
       if (sh && sh->Type == GL_SHADER_PROGRAM_MESA) {
          return NULL;
       }
+      if (sh)
+         util_queue_fence_wait(&sh->CompileFence);
       return sh;
    }
    return NULL;
@@ -194,6 +202,7 @@ _mesa_lookup_shader_err(struct gl_context *ctx, GLuint name, const char *caller)
          _mesa_error(ctx, GL_INVALID_OPERATION, "%s", caller);
          return NULL;
       }
+      util_queue_fence_wait(&sh->CompileFence);
       return sh;
    }
 }
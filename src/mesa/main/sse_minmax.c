@@ -30,9 +30,14 @@
 #include <smmintrin.h>
 #include <stdint.h>
 
+/* Primitive restart indices are replaced by the identity of each
+ * operation (0 for max, all ones for min) so they drop out of the result
+ * without any branching.
+ */
 void
 _mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
-                         unsigned *max_index, const unsigned count)
+                         unsigned *max_index, const unsigned count,
+                         bool restart, unsigned restart_index)
 {
    unsigned max_ui = 0;
    unsigned min_ui = ~0U;
@@ -41,10 +46,12 @@ _mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
 
    /* handle the first few values without SSE until the pointer is aligned */
    while (((uintptr_t)ui_indices & 15) && aligned_count) {
-      if (*ui_indices > max_ui)
-         max_ui = *ui_indices;
-      if (*ui_indices < min_ui)
-         min_ui = *ui_indices;
+      if (!restart || *ui_indices != restart_index) {
+         if (*ui_indices > max_ui)
+            max_ui = *ui_indices;
+         if (*ui_indices < min_ui)
+            min_ui = *ui_indices;
+      }
 
       aligned_count--;
       ui_indices++;
@@ -60,15 +67,27 @@ _mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
       unsigned vec_count;
       __m128i max_ui4 = _mm_setzero_si128();
       __m128i min_ui4 = _mm_set1_epi32(~0U);
+      __m128i restart4 = _mm_set1_epi32(restart_index);
       __m128i ui_indices4;
       __m128i *ui_indices_ptr;
 
       vec_count = aligned_count & ~0x3;
       ui_indices_ptr = (__m128i *)ui_indices;
-      for (i = 0; i < vec_count / 4; i++) {
-         ui_indices4 = _mm_load_si128(&ui_indices_ptr[i]);
-         max_ui4 = _mm_max_epu32(ui_indices4, max_ui4);
-         min_ui4 = _mm_min_epu32(ui_indices4, min_ui4);
+      if (restart) {
+         for (i = 0; i < vec_count / 4; i++) {
+            ui_indices4 = _mm_load_si128(&ui_indices_ptr[i]);
+            __m128i is_restart = _mm_cmpeq_epi32(ui_indices4, restart4);
+            max_ui4 = _mm_max_epu32(_mm_andnot_si128(is_restart, ui_indices4),
+                                    max_ui4);
+            min_ui4 = _mm_min_epu32(_mm_or_si128(is_restart, ui_indices4),
+                                    min_ui4);
+         }
+      } else {
+         for (i = 0; i < vec_count / 4; i++) {
+            ui_indices4 = _mm_load_si128(&ui_indices_ptr[i]);
+            max_ui4 = _mm_max_epu32(ui_indices4, max_ui4);
+            min_ui4 = _mm_min_epu32(ui_indices4, min_ui4);
+         }
       }
 
       _mm_store_si128((__m128i *)max_arr, max_ui4);
@@ -84,6 +103,8 @@ _mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
    }
 
    for (; i < aligned_count; i++) {
+      if (restart && ui_indices[i] == restart_index)
+         continue;
       if (ui_indices[i] > max_ui)
          max_ui = ui_indices[i];
       if (ui_indices[i] < min_ui)
@@ -93,3 +114,179 @@ _mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
    *min_index = min_ui;
    *max_index = max_ui;
 }
+
+void
+_mesa_ushort_array_min_max(const uint16_t *us_indices, unsigned *min_index,
+                           unsigned *max_index, const unsigned count,
+                           bool restart, unsigned restart_index)
+{
+   unsigned max_us = 0;
+   unsigned min_us = ~0U;
+   unsigned i = 0;
+   unsigned aligned_count = count;
+
+   /* A restart index that doesn't fit can never match. */
+   if (restart_index > UINT16_MAX)
+      restart = false;
+
+   while (((uintptr_t)us_indices & 15) && aligned_count) {
+      if (!restart || *us_indices != restart_index) {
+         if (*us_indices > max_us)
+            max_us = *us_indices;
+         if (*us_indices < min_us)
+            min_us = *us_indices;
+      }
+
+      aligned_count--;
+      us_indices++;
+   }
+
+   if (aligned_count >= 16) {
+      alignas(16) uint16_t max_arr[8];
+      alignas(16) uint16_t min_arr[8];
+      unsigned vec_count;
+      bool any_valid = !restart;
+      __m128i max_us8 = _mm_setzero_si128();
+      __m128i min_us8 = _mm_set1_epi16(-1);
+      __m128i restart8 = _mm_set1_epi16(restart_index);
+      __m128i us_indices8;
+      __m128i *us_indices_ptr;
+
+      vec_count = aligned_count & ~0x7;
+      us_indices_ptr = (__m128i *)us_indices;
+      if (restart) {
+         __m128i all_restart = _mm_set1_epi16(-1);
+
+         for (i = 0; i < vec_count / 8; i++) {
+            us_indices8 = _mm_load_si128(&us_indices_ptr[i]);
+            __m128i is_restart = _mm_cmpeq_epi16(us_indices8, restart8);
+            all_restart = _mm_and_si128(all_restart, is_restart);
+            max_us8 = _mm_max_epu16(_mm_andnot_si128(is_restart, us_indices8),
+                                    max_us8);
+            min_us8 = _mm_min_epu16(_mm_or_si128(is_restart, us_indices8),
+                                    min_us8);
+         }
+         any_valid = _mm_movemask_epi8(all_restart) != 0xffff;
+      } else {
+         for (i = 0; i < vec_count / 8; i++) {
+            us_indices8 = _mm_load_si128(&us_indices_ptr[i]);
+            max_us8 = _mm_max_epu16(us_indices8, max_us8);
+            min_us8 = _mm_min_epu16(us_indices8, min_us8);
+         }
+      }
+
+      /* 0xffff in the min lanes is also where restart indices went, so only
+       * pick it up if there was at least one real index.
+       */
+      if (any_valid) {
+         _mm_store_si128((__m128i *)max_arr, max_us8);
+         _mm_store_si128((__m128i *)min_arr, min_us8);
+
+         for (i = 0; i < 8; i++) {
+            if (max_arr[i] > max_us)
+               max_us = max_arr[i];
+            if (min_arr[i] < min_us)
+               min_us = min_arr[i];
+         }
+      }
+      i = vec_count;
+   }
+
+   for (; i < aligned_count; i++) {
+      if (restart && us_indices[i] == restart_index)
+         continue;
+      if (us_indices[i] > max_us)
+         max_us = us_indices[i];
+      if (us_indices[i] < min_us)
+         min_us = us_indices[i];
+   }
+
+   *min_index = min_us;
+   *max_index = max_us;
+}
+
+void
+_mesa_ubyte_array_min_max(const uint8_t *ub_indices, unsigned *min_index,
+                          unsigned *max_index, const unsigned count,
+                          bool restart, unsigned restart_index)
+{
+   unsigned max_ub = 0;
+   unsigned min_ub = ~0U;
+   unsigned i = 0;
+   unsigned aligned_count = count;
+
+   if (restart_index > UINT8_MAX)
+      restart = false;
+
+   while (((uintptr_t)ub_indices & 15) && aligned_count) {
+      if (!restart || *ub_indices != restart_index) {
+         if (*ub_indices > max_ub)
+            max_ub = *ub_indices;
+         if (*ub_indices < min_ub)
+            min_ub = *ub_indices;
+      }
+
+      aligned_count--;
+      ub_indices++;
+   }
+
+   if (aligned_count >= 32) {
+      alignas(16) uint8_t max_arr[16];
+      alignas(16) uint8_t min_arr[16];
+      unsigned vec_count;
+      bool any_valid = !restart;
+      __m128i max_ub16 = _mm_setzero_si128();
+      __m128i min_ub16 = _mm_set1_epi8(-1);
+      __m128i restart16 = _mm_set1_epi8(restart_index);
+      __m128i ub_indices16;
+      __m128i *ub_indices_ptr;
+
+      vec_count = aligned_count & ~0xf;
+      ub_indices_ptr = (__m128i *)ub_indices;
+      if (restart) {
+         __m128i all_restart = _mm_set1_epi8(-1);
+
+         for (i = 0; i < vec_count / 16; i++) {
+            ub_indices16 = _mm_load_si128(&ub_indices_ptr[i]);
+            __m128i is_restart = _mm_cmpeq_epi8(ub_indices16, restart16);
+            all_restart = _mm_and_si128(all_restart, is_restart);
+            max_ub16 = _mm_max_epu8(_mm_andnot_si128(is_restart, ub_indices16),
+                                    max_ub16);
+            min_ub16 = _mm_min_epu8(_mm_or_si128(is_restart, ub_indices16),
+                                    min_ub16);
+         }
+         any_valid = _mm_movemask_epi8(all_restart) != 0xffff;
+      } else {
+         for (i = 0; i < vec_count / 16; i++) {
+            ub_indices16 = _mm_load_si128(&ub_indices_ptr[i]);
+            max_ub16 = _mm_max_epu8(ub_indices16, max_ub16);
+            min_ub16 = _mm_min_epu8(ub_indices16, min_ub16);
+         }
+      }
+
+      if (any_valid) {
+         _mm_store_si128((__m128i *)max_arr, max_ub16);
+         _mm_store_si128((__m128i *)min_arr, min_ub16);
+
+         for (i = 0; i < 16; i++) {
+            if (max_arr[i] > max_ub)
+               max_ub = max_arr[i];
+            if (min_arr[i] < min_ub)
+               min_ub = min_arr[i];
+         }
+      }
+      i = vec_count;
+   }
+
+   for (; i < aligned_count; i++) {
+      if (restart && ub_indices[i] == restart_index)
+         continue;
+      if (ub_indices[i] > max_ub)
+         max_ub = ub_indices[i];
+      if (ub_indices[i] < min_ub)
+         min_ub = ub_indices[i];
+   }
+
+   *min_index = min_ub;
+   *max_index = max_ub;
+}
@@ -0,0 +1,70 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "main/sse_swizzle.h"
+#include "main/formats.h"
+#include <smmintrin.h>
+
+/**
+ * Swizzle 3 or 4 channel ubyte pixels into 4 channel ubyte pixels, four
+ * pixels per pshufb.  This covers the RGBA <-> BGRA reorderings and the
+ * RGB -> RGBA expansion done by glTexSubImage.
+ *
+ * \return  the number of pixels converted; the caller handles the rest.
+ */
+int
+_mesa_ubyte_swizzle_to_4_sse41(uint8_t *dst, const uint8_t *src,
+                               int num_src_channels,
+                               const uint8_t swizzle[4], uint8_t one,
+                               int count)
+{
+   int8_t shuf[16], fill[16];
+   int i, c;
+
+   for (i = 0; i < 4; ++i) {
+      for (c = 0; c < 4; ++c) {
+         const uint8_t s = swizzle[c];
+
+         /* pshufb zeroes every lane whose index has the top bit set. */
+         shuf[i * 4 + c] = s < 4 ? i * num_src_channels + s : -128;
+         fill[i * 4 + c] = s == MESA_FORMAT_SWIZZLE_ONE ? one : 0;
+      }
+   }
+
+   const __m128i vshuf = _mm_loadu_si128((const __m128i *)shuf);
+   const __m128i vfill = _mm_loadu_si128((const __m128i *)fill);
+
+   /* Each load reads 16 bytes, which for 3 channel sources is more than the
+    * 12 bytes of the four pixels being converted, so stop while a full
+    * vector is still inside the source row.
+    */
+   const int stop = num_src_channels == 4 ? count : count - 2;
+
+   for (i = 0; i + 4 <= stop; i += 4) {
+      const __m128i px = _mm_loadu_si128((const __m128i *)src);
+      _mm_storeu_si128((__m128i *)dst,
+                       _mm_or_si128(_mm_shuffle_epi8(px, vshuf), vfill));
+      src += 4 * num_src_channels;
+      dst += 16;
+   }
+
+   return i;
+}
@@ -93,7 +93,9 @@ needs_integer_signed_unsigned_conversion(const struct gl_context *ctx,
 }
 
 static bool
-try_pbo_readpixels(struct st_context *st, struct gl_renderbuffer *rb,
+try_pbo_readpixels(struct st_context *st, struct pipe_resource *texture,
+                   unsigned level, unsigned layer,
+                   unsigned surf_width, unsigned surf_height,
                    bool invert_y,
                    GLint x, GLint y, GLsizei width, GLsizei height,
                    GLenum gl_format,
@@ -103,8 +105,6 @@ try_pbo_readpixels(struct st_context *st, struct gl_renderbuffer *rb,
    struct pipe_context *pipe = st->pipe;
    struct pipe_screen *screen = st->screen;
    struct cso_context *cso = st->cso_context;
-   struct pipe_surface *surface = rb->surface;
-   struct pipe_resource *texture = rb->texture;
    const struct util_format_description *desc;
    struct st_pbo_addresses addr;
    struct pipe_framebuffer_state fb;
@@ -174,14 +174,14 @@ try_pbo_readpixels(struct st_context *st, struct gl_renderbuffer *rb,
       }
 
       templ.target = view_target;
-      templ.u.tex.first_level = surface->u.tex.level;
+      templ.u.tex.first_level = level;
       templ.u.tex.last_level = templ.u.tex.first_level;
 
       if (view_target != PIPE_TEXTURE_3D) {
-         templ.u.tex.first_layer = surface->u.tex.first_layer;
+         templ.u.tex.first_layer = layer;
          templ.u.tex.last_layer = templ.u.tex.first_layer;
       } else {
-         addr.constants.layer_offset = surface->u.tex.first_layer;
+         addr.constants.layer_offset = layer;
       }
 
       sampler_view = pipe->create_sampler_view(pipe, texture, &templ);
@@ -216,8 +216,8 @@ try_pbo_readpixels(struct st_context *st, struct gl_renderbuffer *rb,
 
    /* Set up no-attachment framebuffer */
    memset(&fb, 0, sizeof(fb));
-   fb.width = surface->width;
-   fb.height = surface->height;
+   fb.width = surf_width;
+   fb.height = surf_height;
    fb.samples = 1;
    fb.layers = addr.depth;
    cso_set_framebuffer(cso, &fb);
@@ -268,6 +268,85 @@ fail:
    return success;
 }
 
+/**
+ * Read back a multisampled renderbuffer into a PBO without touching the CPU:
+ * resolve the requested region into a temporary single-sampled texture and
+ * run the regular PBO download on that.
+ */
+static bool
+try_pbo_readpixels_msaa(struct st_context *st, struct gl_renderbuffer *rb,
+                        bool invert_y,
+                        GLint x, GLint y, GLsizei width, GLsizei height,
+                        GLenum gl_format,
+                        enum pipe_format src_format,
+                        enum pipe_format dst_format,
+                        const struct gl_pixelstore_attrib *pack,
+                        void *pixels)
+{
+   struct pipe_screen *screen = st->screen;
+   struct pipe_resource templ;
+   struct pipe_resource *resolved;
+   struct pipe_blit_info blit;
+   bool success;
+
+   if (util_format_is_depth_or_stencil(src_format))
+      return false;
+
+   if (!screen->get_param(screen, PIPE_CAP_NPOT_TEXTURES) &&
+       (!util_is_power_of_two_or_zero(width) ||
+        !util_is_power_of_two_or_zero(height)))
+      return false;
+
+   if (!screen->is_format_supported(screen, src_format, PIPE_TEXTURE_2D,
+                                    0, 0, PIPE_BIND_SAMPLER_VIEW |
+                                          PIPE_BIND_RENDER_TARGET))
+      return false;
+
+   memset(&templ, 0, sizeof(templ));
+   templ.target = PIPE_TEXTURE_2D;
+   templ.format = src_format;
+   templ.bind = PIPE_BIND_SAMPLER_VIEW | PIPE_BIND_RENDER_TARGET;
+   templ.usage = PIPE_USAGE_DEFAULT;
+   templ.width0 = width;
+   templ.height0 = height;
+   templ.depth0 = 1;
+   templ.array_size = 1;
+
+   resolved = screen->resource_create(screen, &templ);
+   if (!resolved)
+      return false;
+
+   memset(&blit, 0, sizeof(blit));
+   blit.src.resource = rb->texture;
+   blit.src.level = rb->surface->u.tex.level;
+   blit.src.format = src_format;
+   blit.src.box.x = x;
+   blit.src.box.y = invert_y ? rb->Height - y - height : y;
+   blit.src.box.z = rb->surface->u.tex.first_layer;
+   blit.src.box.width = width;
+   blit.src.box.height = height;
+   blit.src.box.depth = 1;
+   blit.dst.resource = resolved;
+   blit.dst.format = src_format;
+   blit.dst.box.width = width;
+   blit.dst.box.height = height;
+   blit.dst.box.depth = 1;
+   blit.mask = PIPE_MASK_RGBA;
+   blit.filter = PIPE_TEX_FILTER_NEAREST;
+
+   st->pipe->blit(st->pipe, &blit);
+
+   /* The resolved texture keeps the orientation of the renderbuffer, so the
+    * region is now the whole texture and any y flip happens within it.
+    */
+   success = try_pbo_readpixels(st, resolved, 0, 0, width, height, invert_y,
+                                0, 0, width, height, gl_format,
+                                src_format, dst_format, pack, pixels);
+
+   pipe_resource_reference(&resolved, NULL);
+   return success;
+}
+
 /**
  * Create a staging texture and blit the requested region to it.
  */
@@ -486,12 +565,22 @@ st_ReadPixels(struct gl_context *ctx, GLint x, GLint y,
    }
 
    if (st->pbo.download_enabled && pack->BufferObj) {
-      if (try_pbo_readpixels(st, rb,
-                             _mesa_fb_orientation(ctx->ReadBuffer) == Y_0_TOP,
-                             x, y, width, height,
-                             format, src_format, dst_format,
-                             pack, pixels))
+      const bool invert_y = _mesa_fb_orientation(ctx->ReadBuffer) == Y_0_TOP;
+
+      if (src->nr_samples > 1) {
+         if (try_pbo_readpixels_msaa(st, rb, invert_y,
+                                     x, y, width, height,
+                                     format, src_format, dst_format,
+                                     pack, pixels))
+            return;
+      } else if (try_pbo_readpixels(st, src, rb->surface->u.tex.level,
+                                    rb->surface->u.tex.first_layer,
+                                    rb->surface->width, rb->surface->height,
+                                    invert_y, x, y, width, height,
+                                    format, src_format, dst_format,
+                                    pack, pixels)) {
          return;
+      }
    }
 
    if (needs_integer_signed_unsigned_conversion(ctx, format, type)) {
@@ -80,6 +80,8 @@
 #include "util/u_surface.h"
 #include "util/u_sampler.h"
 #include "util/u_math.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_queue.h"
 #include "util/u_box.h"
 #include "util/u_memory.h"
 #include "util/u_simple_shaders.h"
@@ -621,6 +623,134 @@ upload_astc_slice_with_flushed_void_extents(uint8_t *dst,
    }
 }
 
+/**
+ * Decompress a rectangle of a compressed image into RGBA8 (or BGRA8 for
+ * ETC2 when \p bgra is set).  \p src_stride is the stride of a row of
+ * blocks.
+ */
+static void
+decompress_rows(uint8_t *dst, unsigned dst_stride,
+                const uint8_t *src, unsigned src_stride,
+                unsigned width, unsigned height,
+                mesa_format format, bool bgra)
+{
+   if (format == MESA_FORMAT_ETC1_RGB8) {
+      _mesa_etc1_unpack_rgba8888(dst, dst_stride, src, src_stride,
+                                 width, height);
+   } else if (_mesa_is_format_etc2(format)) {
+      _mesa_unpack_etc2_format(dst, dst_stride, src, src_stride,
+                               width, height, format, bgra);
+   } else if (_mesa_is_format_astc_2d(format)) {
+      _mesa_unpack_astc_2d_ldr(dst, dst_stride, src, src_stride,
+                               width, height, format);
+   } else if (_mesa_is_format_s3tc(format)) {
+      _mesa_unpack_s3tc(dst, dst_stride, src, src_stride,
+                        width, height, format);
+   } else if (_mesa_is_format_rgtc(format) ||
+              _mesa_is_format_latc(format)) {
+      _mesa_unpack_rgtc(dst, dst_stride, src, src_stride,
+                        width, height, format);
+   } else if (_mesa_is_format_bptc(format)) {
+      _mesa_unpack_bptc(dst, dst_stride, src, src_stride,
+                        width, height, format);
+   } else {
+      unreachable("unexpected format for a compressed format fallback");
+   }
+}
+
+struct decompress_job {
+   struct util_queue_fence fence;
+   uint8_t *dst;
+   unsigned dst_stride;
+   const uint8_t *src;
+   unsigned src_stride;
+   unsigned width, height;
+   mesa_format format;
+   bool bgra;
+};
+
+static void
+decompress_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct decompress_job *job = data;
+
+   decompress_rows(job->dst, job->dst_stride, job->src, job->src_stride,
+                   job->width, job->height, job->format, job->bgra);
+}
+
+/* Images smaller than this many texels are decompressed on the calling
+ * thread; below that the queue overhead isn't worth it.
+ */
+#define DECOMPRESS_MT_MIN_TEXELS (256 * 256)
+#define DECOMPRESS_MT_MAX_JOBS 16
+
+/**
+ * Decompress a slice for the compressed format fallback, splitting it into
+ * bands of block rows that are decoded in parallel on st->decompress_queue.
+ * The calling thread decodes the last band itself.
+ */
+static void
+decompress_slice(struct st_context *st,
+                 uint8_t *dst, unsigned dst_stride,
+                 const uint8_t *src, unsigned src_stride,
+                 unsigned width, unsigned height,
+                 mesa_format format, bool bgra)
+{
+   unsigned blk_w, blk_h;
+   _mesa_get_format_block_size(format, &blk_w, &blk_h);
+
+   const unsigned block_rows = DIV_ROUND_UP(height, blk_h);
+   unsigned num_jobs = 1;
+
+   if ((uint64_t)width * height >= DECOMPRESS_MT_MIN_TEXELS) {
+      num_jobs = MIN3(util_get_cpu_caps()->nr_cpus, DECOMPRESS_MT_MAX_JOBS,
+                      block_rows);
+   }
+
+   if (num_jobs > 1 && !util_queue_is_initialized(&st->decompress_queue) &&
+       !util_queue_init(&st->decompress_queue, "st_decomp",
+                        DECOMPRESS_MT_MAX_JOBS, num_jobs - 1,
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL, NULL))
+      num_jobs = 1;
+
+   if (num_jobs <= 1) {
+      decompress_rows(dst, dst_stride, src, src_stride, width, height,
+                      format, bgra);
+      return;
+   }
+
+   struct decompress_job jobs[DECOMPRESS_MT_MAX_JOBS];
+   const unsigned rows_per_job = DIV_ROUND_UP(block_rows, num_jobs);
+   unsigned n = 0;
+
+   for (unsigned row = 0; row < block_rows; row += rows_per_job, n++) {
+      const unsigned y = row * blk_h;
+      struct decompress_job *job = &jobs[n];
+
+      job->dst = dst + (size_t)y * dst_stride;
+      job->dst_stride = dst_stride;
+      job->src = src + (size_t)row * src_stride;
+      job->src_stride = src_stride;
+      job->width = width;
+      job->height = MIN2(rows_per_job * blk_h, height - y);
+      job->format = format;
+      job->bgra = bgra;
+   }
+
+   for (unsigned i = 0; i < n - 1; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      util_queue_add_job(&st->decompress_queue, &jobs[i], &jobs[i].fence,
+                         decompress_job_execute, NULL, 0);
+   }
+
+   decompress_job_execute(&jobs[n - 1], NULL, -1);
+
+   for (unsigned i = 0; i < n - 1; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+}
+
 void
 st_UnmapTextureImage(struct gl_context *ctx,
                      struct gl_texture_image *texImage,
@@ -710,32 +840,10 @@ st_UnmapTextureImage(struct gl_context *ctx,
             void *tmp = malloc(size);
 
             /* Decompress to tmp. */
-            if (texImage->TexFormat == MESA_FORMAT_ETC1_RGB8) {
-               _mesa_etc1_unpack_rgba8888(tmp, transfer->box.width * 4,
-                                          itransfer->temp_data,
-                                          itransfer->temp_stride,
-                                          transfer->box.width,
-                                          transfer->box.height);
-            } else if (_mesa_is_format_etc2(texImage->TexFormat)) {
-               bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
-
-               _mesa_unpack_etc2_format(tmp, transfer->box.width * 4,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width,
-                                        transfer->box.height,
-                                        texImage->TexFormat,
-                                        bgra);
-            } else if (_mesa_is_format_astc_2d(texImage->TexFormat)) {
-               _mesa_unpack_astc_2d_ldr(tmp, transfer->box.width * 4,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width,
-                                        transfer->box.height,
-                                        texImage->TexFormat);
-            } else {
-               unreachable("unexpected format for a compressed format fallback");
-            }
+            decompress_slice(st, tmp, transfer->box.width * 4,
+                             itransfer->temp_data, itransfer->temp_stride,
+                             transfer->box.width, transfer->box.height,
+                             texImage->TexFormat, false);
 
             /* Compress it to the target format. */
             struct gl_pixelstore_attrib pack = {0};
@@ -749,49 +857,12 @@ st_UnmapTextureImage(struct gl_context *ctx,
             free(tmp);
          } else {
             /* Decompress into an uncompressed format. */
-            if (texImage->TexFormat == MESA_FORMAT_ETC1_RGB8) {
-               _mesa_etc1_unpack_rgba8888(map, transfer->stride,
-                                          itransfer->temp_data,
-                                          itransfer->temp_stride,
-                                          transfer->box.width,
-                                          transfer->box.height);
-            } else if (_mesa_is_format_etc2(texImage->TexFormat)) {
-               bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
-
-               _mesa_unpack_etc2_format(map, transfer->stride,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width, transfer->box.height,
-                                        texImage->TexFormat,
-                                        bgra);
-            } else if (_mesa_is_format_astc_2d(texImage->TexFormat)) {
-               _mesa_unpack_astc_2d_ldr(map, transfer->stride,
-                                        itransfer->temp_data,
-                                        itransfer->temp_stride,
-                                        transfer->box.width, transfer->box.height,
-                                        texImage->TexFormat);
-            } else if (_mesa_is_format_s3tc(texImage->TexFormat)) {
-               _mesa_unpack_s3tc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else if (_mesa_is_format_rgtc(texImage->TexFormat) ||
-                       _mesa_is_format_latc(texImage->TexFormat)) {
-               _mesa_unpack_rgtc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else if (_mesa_is_format_bptc(texImage->TexFormat)) {
-               _mesa_unpack_bptc(map, transfer->stride,
-                                 itransfer->temp_data,
-                                 itransfer->temp_stride,
-                                 transfer->box.width, transfer->box.height,
-                                 texImage->TexFormat);
-            } else {
-               unreachable("unexpected format for a compressed format fallback");
-            }
+            bool bgra = texImage->pt->format == PIPE_FORMAT_B8G8R8A8_SRGB;
+
+            decompress_slice(st, map, transfer->stride,
+                             itransfer->temp_data, itransfer->temp_stride,
+                             transfer->box.width, transfer->box.height,
+                             texImage->TexFormat, bgra);
          }
 
          st_texture_image_unmap(st, texImage, slice);
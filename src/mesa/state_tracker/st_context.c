@@ -344,6 +344,9 @@ st_destroy_context_priv(struct st_context *st, bool destroy_pipe)
    if (_mesa_has_compute_shaders(st->ctx) && st->transcode_astc)
       st_destroy_texcompress_compute(st);
 
+   if (util_queue_is_initialized(&st->decompress_queue))
+      util_queue_destroy(&st->decompress_queue);
+
    st_destroy_bound_texture_handles(st);
    st_destroy_bound_image_handles(st);
 
@@ -431,7 +434,8 @@ st_have_perfquery(struct st_context *ctx)
 
 static struct st_context *
 st_create_context_priv(struct gl_context *ctx, struct pipe_context *pipe,
-                       const struct st_config_options *options)
+                       const struct st_config_options *options,
+                       const struct st_format_caps *format_caps)
 {
    struct pipe_screen *screen = pipe->screen;
    struct st_context *st = CALLOC_STRUCT( st_context);
@@ -646,7 +650,7 @@ st_create_context_priv(struct gl_context *ctx, struct pipe_context *pipe,
    /* GL limits and extensions */
    st_init_limits(screen, &ctx->Const, &ctx->Extensions, ctx->API);
    st_init_extensions(screen, &ctx->Const,
-                      &ctx->Extensions, &st->options, ctx->API);
+                      &ctx->Extensions, &st->options, format_caps, ctx->API);
 
    if (st_have_perfquery(st)) {
       ctx->Extensions.INTEL_performance_query = GL_TRUE;
@@ -825,6 +829,7 @@ st_create_context(gl_api api, struct pipe_context *pipe,
                   const struct gl_config *visual,
                   struct st_context *share,
                   const struct st_config_options *options,
+                  const struct st_format_caps *format_caps,
                   bool no_error, bool has_egl_image_validate)
 {
    struct gl_context *ctx;
@@ -866,7 +871,7 @@ st_create_context(gl_api api, struct pipe_context *pipe,
    if (pipe->screen->get_param(pipe->screen, PIPE_CAP_STRING_MARKER))
       ctx->has_string_marker = true;
 
-   st = st_create_context_priv(ctx, pipe, options);
+   st = st_create_context_priv(ctx, pipe, options, format_caps);
    if (!st) {
       _mesa_free_context_data(ctx, true);
       align_free(ctx);
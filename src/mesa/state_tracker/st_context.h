@@ -36,6 +36,7 @@
 #include "util/u_helpers.h"
 #include "util/u_inlines.h"
 #include "util/list.h"
+#include "util/u_queue.h"
 #include "vbo/vbo.h"
 #include "util/list.h"
 #include "cso_cache/cso_context.h"
@@ -50,6 +51,7 @@ struct draw_context;
 struct draw_stage;
 struct gen_mipmap_state;
 struct st_context;
+struct st_format_caps;
 struct st_program;
 struct u_upload_mgr;
 
@@ -352,6 +354,9 @@ struct st_context
       struct hash_table *astc_partition_tables;
    } texcompress_compute;
 
+   /** worker threads for the CPU compressed format fallback */
+   struct util_queue decompress_queue;
+
    /** for drawing with st_util_vertex */
    struct cso_velems_state util_velems;
 
@@ -448,6 +453,7 @@ st_create_context(gl_api api, struct pipe_context *pipe,
                   const struct gl_config *visual,
                   struct st_context *share,
                   const struct st_config_options *options,
+                  const struct st_format_caps *format_caps,
                   bool no_error, bool has_egl_image_validate);
 
 extern void
@@ -739,6 +739,336 @@ get_max_samples_for_formats_advanced(struct pipe_screen *screen,
    return 0;
 }
 
+/* Required: render target and sampler support */
+static const struct st_extension_format_mapping rendertarget_mapping[] = {
+   { { o(ARB_texture_rgb10_a2ui) },
+     { PIPE_FORMAT_R10G10B10A2_UINT,
+       PIPE_FORMAT_B10G10R10A2_UINT },
+      GL_TRUE }, /* at least one format must be supported */
+
+   { { o(EXT_sRGB) },
+     { PIPE_FORMAT_A8B8G8R8_SRGB,
+       PIPE_FORMAT_B8G8R8A8_SRGB,
+       PIPE_FORMAT_R8G8B8A8_SRGB },
+      GL_TRUE }, /* at least one format must be supported */
+
+   { { o(EXT_packed_float) },
+     { PIPE_FORMAT_R11G11B10_FLOAT } },
+
+   { { o(EXT_texture_integer) },
+     { PIPE_FORMAT_R32G32B32A32_UINT,
+       PIPE_FORMAT_R32G32B32A32_SINT } },
+
+   { { o(ARB_texture_rg) },
+     { PIPE_FORMAT_R8_UNORM,
+       PIPE_FORMAT_R8G8_UNORM } },
+
+   { { o(EXT_texture_norm16) },
+     { PIPE_FORMAT_R16_UNORM,
+       PIPE_FORMAT_R16G16_UNORM,
+       PIPE_FORMAT_R16G16B16A16_UNORM } },
+
+   { { o(EXT_render_snorm) },
+     { PIPE_FORMAT_R8_SNORM,
+       PIPE_FORMAT_R8G8_SNORM,
+       PIPE_FORMAT_R8G8B8A8_SNORM,
+       PIPE_FORMAT_R16_SNORM,
+       PIPE_FORMAT_R16G16_SNORM,
+       PIPE_FORMAT_R16G16B16A16_SNORM } },
+
+   { { o(EXT_color_buffer_half_float) },
+     { PIPE_FORMAT_R16_FLOAT,
+       PIPE_FORMAT_R16G16_FLOAT,
+       PIPE_FORMAT_R16G16B16A16_FLOAT } },
+
+   { { o(EXT_color_buffer_float) },
+     { PIPE_FORMAT_R16_FLOAT,
+       PIPE_FORMAT_R16G16_FLOAT,
+       PIPE_FORMAT_R16G16B16A16_FLOAT,
+       PIPE_FORMAT_R32_FLOAT,
+       PIPE_FORMAT_R32G32_FLOAT,
+       PIPE_FORMAT_R32G32B32A32_FLOAT } },
+};
+
+/* Required: render target, sampler, and blending */
+static const struct st_extension_format_mapping rt_blendable[] = {
+   { { o(EXT_float_blend) },
+     { PIPE_FORMAT_R32G32B32A32_FLOAT } },
+};
+
+/* Required: depth stencil and sampler support */
+static const struct st_extension_format_mapping depthstencil_mapping[] = {
+   { { o(ARB_depth_buffer_float) },
+     { PIPE_FORMAT_Z32_FLOAT,
+       PIPE_FORMAT_Z32_FLOAT_S8X24_UINT } },
+};
+
+/* Required: sampler support */
+static const struct st_extension_format_mapping texture_mapping[] = {
+   { { o(OES_texture_float) },
+     { PIPE_FORMAT_R32G32B32A32_FLOAT } },
+
+   { { o(OES_texture_half_float) },
+     { PIPE_FORMAT_R16G16B16A16_FLOAT } },
+
+   { { o(ARB_texture_compression_rgtc) },
+     { PIPE_FORMAT_RGTC1_UNORM,
+       PIPE_FORMAT_RGTC1_SNORM,
+       PIPE_FORMAT_RGTC2_UNORM,
+       PIPE_FORMAT_RGTC2_SNORM } },
+
+   /* RGTC software fallback support. */
+   { { o(ARB_texture_compression_rgtc) },
+     { PIPE_FORMAT_R8_UNORM,
+       PIPE_FORMAT_R8_SNORM,
+       PIPE_FORMAT_R8G8_UNORM,
+       PIPE_FORMAT_R8G8_SNORM } },
+
+   { { o(EXT_texture_compression_latc) },
+     { PIPE_FORMAT_LATC1_UNORM,
+       PIPE_FORMAT_LATC1_SNORM,
+       PIPE_FORMAT_LATC2_UNORM,
+       PIPE_FORMAT_LATC2_SNORM } },
+
+   /* LATC software fallback support. */
+   { { o(EXT_texture_compression_latc) },
+     { PIPE_FORMAT_L8_UNORM,
+       PIPE_FORMAT_L8_SNORM,
+       PIPE_FORMAT_L8A8_UNORM,
+       PIPE_FORMAT_L8A8_SNORM } },
+
+   { { o(EXT_texture_compression_s3tc),
+       o(ANGLE_texture_compression_dxt) },
+     { PIPE_FORMAT_DXT1_RGB,
+       PIPE_FORMAT_DXT1_RGBA,
+       PIPE_FORMAT_DXT3_RGBA,
+       PIPE_FORMAT_DXT5_RGBA } },
+
+   /* S3TC software fallback support. */
+   { { o(EXT_texture_compression_s3tc),
+       o(ANGLE_texture_compression_dxt) },
+     { PIPE_FORMAT_R8G8B8A8_UNORM } },
+
+   { { o(EXT_texture_compression_s3tc_srgb) },
+     { PIPE_FORMAT_DXT1_SRGB,
+       PIPE_FORMAT_DXT1_SRGBA,
+       PIPE_FORMAT_DXT3_SRGBA,
+       PIPE_FORMAT_DXT5_SRGBA } },
+
+   /* S3TC SRGB software fallback support. */
+   { { o(EXT_texture_compression_s3tc_srgb) },
+     { PIPE_FORMAT_R8G8B8A8_SRGB } },
+
+   { { o(ARB_texture_compression_bptc) },
+     { PIPE_FORMAT_BPTC_RGBA_UNORM,
+       PIPE_FORMAT_BPTC_SRGBA,
+       PIPE_FORMAT_BPTC_RGB_FLOAT,
+       PIPE_FORMAT_BPTC_RGB_UFLOAT } },
+
+   /* BPTC software fallback support. */
+   { { o(ARB_texture_compression_bptc) },
+     { PIPE_FORMAT_R8G8B8A8_UNORM,
+       PIPE_FORMAT_R8G8B8A8_SRGB,
+       PIPE_FORMAT_R16G16B16X16_FLOAT } },
+
+   { { o(TDFX_texture_compression_FXT1) },
+     { PIPE_FORMAT_FXT1_RGB,
+       PIPE_FORMAT_FXT1_RGBA } },
+
+   { { o(KHR_texture_compression_astc_ldr),
+       o(KHR_texture_compression_astc_sliced_3d) },
+     { PIPE_FORMAT_ASTC_4x4,
+       PIPE_FORMAT_ASTC_5x4,
+       PIPE_FORMAT_ASTC_5x5,
+       PIPE_FORMAT_ASTC_6x5,
+       PIPE_FORMAT_ASTC_6x6,
+       PIPE_FORMAT_ASTC_8x5,
+       PIPE_FORMAT_ASTC_8x6,
+       PIPE_FORMAT_ASTC_8x8,
+       PIPE_FORMAT_ASTC_10x5,
+       PIPE_FORMAT_ASTC_10x6,
+       PIPE_FORMAT_ASTC_10x8,
+       PIPE_FORMAT_ASTC_10x10,
+       PIPE_FORMAT_ASTC_12x10,
+       PIPE_FORMAT_ASTC_12x12,
+       PIPE_FORMAT_ASTC_4x4_SRGB,
+       PIPE_FORMAT_ASTC_5x4_SRGB,
+       PIPE_FORMAT_ASTC_5x5_SRGB,
+       PIPE_FORMAT_ASTC_6x5_SRGB,
+       PIPE_FORMAT_ASTC_6x6_SRGB,
+       PIPE_FORMAT_ASTC_8x5_SRGB,
+       PIPE_FORMAT_ASTC_8x6_SRGB,
+       PIPE_FORMAT_ASTC_8x8_SRGB,
+       PIPE_FORMAT_ASTC_10x5_SRGB,
+       PIPE_FORMAT_ASTC_10x6_SRGB,
+       PIPE_FORMAT_ASTC_10x8_SRGB,
+       PIPE_FORMAT_ASTC_10x10_SRGB,
+       PIPE_FORMAT_ASTC_12x10_SRGB,
+       PIPE_FORMAT_ASTC_12x12_SRGB } },
+
+   /* ASTC software fallback support. */
+   { { o(KHR_texture_compression_astc_ldr),
+       o(KHR_texture_compression_astc_sliced_3d) },
+     { PIPE_FORMAT_R8G8B8A8_UNORM,
+       PIPE_FORMAT_R8G8B8A8_SRGB } },
+
+   { { o(EXT_texture_shared_exponent) },
+     { PIPE_FORMAT_R9G9B9E5_FLOAT } },
+
+   { { o(EXT_texture_snorm) },
+     { PIPE_FORMAT_R8G8B8A8_SNORM } },
+
+   { { o(EXT_texture_sRGB),
+       o(EXT_texture_sRGB_decode) },
+     { PIPE_FORMAT_A8B8G8R8_SRGB,
+       PIPE_FORMAT_B8G8R8A8_SRGB,
+       PIPE_FORMAT_A8R8G8B8_SRGB,
+       PIPE_FORMAT_R8G8B8A8_SRGB},
+     GL_TRUE }, /* at least one format must be supported */
+
+   { { o(EXT_texture_sRGB_R8) },
+     { PIPE_FORMAT_R8_SRGB }, },
+
+   { { o(EXT_texture_sRGB_RG8) },
+     { PIPE_FORMAT_R8G8_SRGB }, },
+
+   { { o(EXT_texture_type_2_10_10_10_REV) },
+     { PIPE_FORMAT_R10G10B10A2_UNORM,
+       PIPE_FORMAT_B10G10R10A2_UNORM },
+      GL_TRUE }, /* at least one format must be supported */
+
+   { { o(ATI_texture_compression_3dc) },
+     { PIPE_FORMAT_LATC2_UNORM } },
+
+   { { o(ATI_texture_compression_3dc) },
+     { PIPE_FORMAT_L8A8_UNORM } },
+
+   { { o(MESA_ycbcr_texture) },
+     { PIPE_FORMAT_UYVY,
+       PIPE_FORMAT_YUYV },
+     GL_TRUE }, /* at least one format must be supported */
+
+   { { o(OES_compressed_ETC1_RGB8_texture) },
+     { PIPE_FORMAT_ETC1_RGB8,
+       PIPE_FORMAT_R8G8B8A8_UNORM },
+     GL_TRUE }, /* at least one format must be supported */
+
+   { { o(ARB_stencil_texturing),
+       o(ARB_texture_stencil8) },
+     { PIPE_FORMAT_X24S8_UINT,
+       PIPE_FORMAT_S8X24_UINT },
+     GL_TRUE }, /* at least one format must be supported */
+
+   { { o(AMD_compressed_ATC_texture) },
+     { PIPE_FORMAT_ATC_RGB,
+       PIPE_FORMAT_ATC_RGBA_EXPLICIT,
+       PIPE_FORMAT_ATC_RGBA_INTERPOLATED } },
+};
+
+/* Required: vertex fetch support. */
+static const struct st_extension_format_mapping vertex_mapping[] = {
+   { { o(EXT_vertex_array_bgra) },
+     { PIPE_FORMAT_B8G8R8A8_UNORM } },
+   { { o(ARB_vertex_type_2_10_10_10_rev) },
+     { PIPE_FORMAT_R10G10B10A2_UNORM,
+       PIPE_FORMAT_B10G10R10A2_UNORM,
+       PIPE_FORMAT_R10G10B10A2_SNORM,
+       PIPE_FORMAT_B10G10R10A2_SNORM,
+       PIPE_FORMAT_R10G10B10A2_USCALED,
+       PIPE_FORMAT_B10G10R10A2_USCALED,
+       PIPE_FORMAT_R10G10B10A2_SSCALED,
+       PIPE_FORMAT_B10G10R10A2_SSCALED } },
+   { { o(ARB_vertex_type_10f_11f_11f_rev) },
+     { PIPE_FORMAT_R11G11B10_FLOAT } },
+};
+
+/* Formats probed for the maximum sample counts. */
+static const enum pipe_format color_formats[] = {
+   PIPE_FORMAT_R8G8B8A8_UNORM,
+   PIPE_FORMAT_B8G8R8A8_UNORM,
+   PIPE_FORMAT_A8R8G8B8_UNORM,
+   PIPE_FORMAT_A8B8G8R8_UNORM,
+};
+static const enum pipe_format depth_formats[] = {
+   PIPE_FORMAT_Z16_UNORM,
+   PIPE_FORMAT_Z24X8_UNORM,
+   PIPE_FORMAT_X8Z24_UNORM,
+   PIPE_FORMAT_Z32_UNORM,
+   PIPE_FORMAT_Z32_FLOAT
+};
+static const enum pipe_format int_formats[] = {
+   PIPE_FORMAT_R8G8B8A8_SINT
+};
+static const enum pipe_format void_formats[] = {
+   PIPE_FORMAT_NONE
+};
+
+/**
+ * Query the format dependent part of st_init_extensions(), ie. the
+ * extensions enabled by the format tables above and the maximum sample
+ * counts.
+ *
+ * These only depend on the screen but take hundreds of
+ * is_format_supported() calls, so the caller computes them once and passes
+ * them to every st_init_extensions() call (st_api_query_versions() alone
+ * goes through it once per API).
+ */
+void
+st_init_format_caps(struct pipe_screen *screen, struct st_format_caps *caps)
+{
+   struct gl_extensions *extensions = &caps->extensions;
+
+   memset(caps, 0, sizeof(*caps));
+
+   init_format_extensions(screen, extensions, rendertarget_mapping,
+                          ARRAY_SIZE(rendertarget_mapping), PIPE_TEXTURE_2D,
+                          PIPE_BIND_RENDER_TARGET | PIPE_BIND_SAMPLER_VIEW);
+   init_format_extensions(screen, extensions, rt_blendable,
+                          ARRAY_SIZE(rt_blendable), PIPE_TEXTURE_2D,
+                          PIPE_BIND_RENDER_TARGET | PIPE_BIND_SAMPLER_VIEW |
+                          PIPE_BIND_BLENDABLE);
+   init_format_extensions(screen, extensions, depthstencil_mapping,
+                          ARRAY_SIZE(depthstencil_mapping), PIPE_TEXTURE_2D,
+                          PIPE_BIND_DEPTH_STENCIL | PIPE_BIND_SAMPLER_VIEW);
+   init_format_extensions(screen, extensions, texture_mapping,
+                          ARRAY_SIZE(texture_mapping), PIPE_TEXTURE_2D,
+                          PIPE_BIND_SAMPLER_VIEW);
+   init_format_extensions(screen, extensions, vertex_mapping,
+                          ARRAY_SIZE(vertex_mapping), PIPE_BUFFER,
+                          PIPE_BIND_VERTEX_BUFFER);
+
+   caps->MaxSamples =
+      get_max_samples_for_formats(screen, ARRAY_SIZE(color_formats),
+                                  color_formats, 16,
+                                  PIPE_BIND_RENDER_TARGET);
+
+   caps->MaxImageSamples =
+      get_max_samples_for_formats(screen, ARRAY_SIZE(color_formats),
+                                  color_formats, 16,
+                                  PIPE_BIND_SHADER_IMAGE);
+
+   caps->MaxColorTextureSamples =
+      get_max_samples_for_formats(screen, ARRAY_SIZE(color_formats),
+                                  color_formats, caps->MaxSamples,
+                                  PIPE_BIND_SAMPLER_VIEW);
+
+   caps->MaxDepthTextureSamples =
+      get_max_samples_for_formats(screen, ARRAY_SIZE(depth_formats),
+                                  depth_formats, caps->MaxSamples,
+                                  PIPE_BIND_SAMPLER_VIEW);
+
+   caps->MaxIntegerSamples =
+      get_max_samples_for_formats(screen, ARRAY_SIZE(int_formats),
+                                  int_formats, caps->MaxSamples,
+                                  PIPE_BIND_SAMPLER_VIEW);
+
+   /* ARB_framebuffer_no_attachments, assume max no. of samples 32 */
+   caps->MaxFramebufferSamples =
+      get_max_samples_for_formats(screen, ARRAY_SIZE(void_formats),
+                                  void_formats, 32,
+                                  PIPE_BIND_RENDER_TARGET);
+}
+
 /**
  * Use pipe_screen::get_param() to query PIPE_CAP_ values to determine
  * which GL extensions are supported.
@@ -750,10 +1080,13 @@ void st_init_extensions(struct pipe_screen *screen,
                         struct gl_constants *consts,
                         struct gl_extensions *extensions,
                         struct st_config_options *options,
+                        const struct st_format_caps *format_caps,
                         gl_api api)
 {
    unsigned i;
    GLboolean *extension_table = (GLboolean *) extensions;
+   const GLboolean *format_table =
+      (const GLboolean *) &format_caps->extensions;
 
    static const struct st_extension_cap_mapping cap_mapping[] = {
       { o(ARB_base_instance),                PIPE_CAP_START_INSTANCE                   },
@@ -876,249 +1209,6 @@ void st_init_extensions(struct pipe_screen *screen,
       { o(MESA_texture_const_bandwidth),     PIPE_CAP_HAS_CONST_BW                     },
    };
 
-   /* Required: render target and sampler support */
-   static const struct st_extension_format_mapping rendertarget_mapping[] = {
-      { { o(ARB_texture_rgb10_a2ui) },
-        { PIPE_FORMAT_R10G10B10A2_UINT,
-          PIPE_FORMAT_B10G10R10A2_UINT },
-         GL_TRUE }, /* at least one format must be supported */
-
-      { { o(EXT_sRGB) },
-        { PIPE_FORMAT_A8B8G8R8_SRGB,
-          PIPE_FORMAT_B8G8R8A8_SRGB,
-          PIPE_FORMAT_R8G8B8A8_SRGB },
-         GL_TRUE }, /* at least one format must be supported */
-
-      { { o(EXT_packed_float) },
-        { PIPE_FORMAT_R11G11B10_FLOAT } },
-
-      { { o(EXT_texture_integer) },
-        { PIPE_FORMAT_R32G32B32A32_UINT,
-          PIPE_FORMAT_R32G32B32A32_SINT } },
-
-      { { o(ARB_texture_rg) },
-        { PIPE_FORMAT_R8_UNORM,
-          PIPE_FORMAT_R8G8_UNORM } },
-
-      { { o(EXT_texture_norm16) },
-        { PIPE_FORMAT_R16_UNORM,
-          PIPE_FORMAT_R16G16_UNORM,
-          PIPE_FORMAT_R16G16B16A16_UNORM } },
-
-      { { o(EXT_render_snorm) },
-        { PIPE_FORMAT_R8_SNORM,
-          PIPE_FORMAT_R8G8_SNORM,
-          PIPE_FORMAT_R8G8B8A8_SNORM,
-          PIPE_FORMAT_R16_SNORM,
-          PIPE_FORMAT_R16G16_SNORM,
-          PIPE_FORMAT_R16G16B16A16_SNORM } },
-
-      { { o(EXT_color_buffer_half_float) },
-        { PIPE_FORMAT_R16_FLOAT,
-          PIPE_FORMAT_R16G16_FLOAT,
-          PIPE_FORMAT_R16G16B16A16_FLOAT } },
-
-      { { o(EXT_color_buffer_float) },
-        { PIPE_FORMAT_R16_FLOAT,
-          PIPE_FORMAT_R16G16_FLOAT,
-          PIPE_FORMAT_R16G16B16A16_FLOAT,
-          PIPE_FORMAT_R32_FLOAT,
-          PIPE_FORMAT_R32G32_FLOAT,
-          PIPE_FORMAT_R32G32B32A32_FLOAT } },
-   };
-
-   /* Required: render target, sampler, and blending */
-   static const struct st_extension_format_mapping rt_blendable[] = {
-      { { o(EXT_float_blend) },
-        { PIPE_FORMAT_R32G32B32A32_FLOAT } },
-   };
-
-   /* Required: depth stencil and sampler support */
-   static const struct st_extension_format_mapping depthstencil_mapping[] = {
-      { { o(ARB_depth_buffer_float) },
-        { PIPE_FORMAT_Z32_FLOAT,
-          PIPE_FORMAT_Z32_FLOAT_S8X24_UINT } },
-   };
-
-   /* Required: sampler support */
-   static const struct st_extension_format_mapping texture_mapping[] = {
-      { { o(OES_texture_float) },
-        { PIPE_FORMAT_R32G32B32A32_FLOAT } },
-
-      { { o(OES_texture_half_float) },
-        { PIPE_FORMAT_R16G16B16A16_FLOAT } },
-
-      { { o(ARB_texture_compression_rgtc) },
-        { PIPE_FORMAT_RGTC1_UNORM,
-          PIPE_FORMAT_RGTC1_SNORM,
-          PIPE_FORMAT_RGTC2_UNORM,
-          PIPE_FORMAT_RGTC2_SNORM } },
-
-      /* RGTC software fallback support. */
-      { { o(ARB_texture_compression_rgtc) },
-        { PIPE_FORMAT_R8_UNORM,
-          PIPE_FORMAT_R8_SNORM,
-          PIPE_FORMAT_R8G8_UNORM,
-          PIPE_FORMAT_R8G8_SNORM } },
-
-      { { o(EXT_texture_compression_latc) },
-        { PIPE_FORMAT_LATC1_UNORM,
-          PIPE_FORMAT_LATC1_SNORM,
-          PIPE_FORMAT_LATC2_UNORM,
-          PIPE_FORMAT_LATC2_SNORM } },
-
-      /* LATC software fallback support. */
-      { { o(EXT_texture_compression_latc) },
-        { PIPE_FORMAT_L8_UNORM,
-          PIPE_FORMAT_L8_SNORM,
-          PIPE_FORMAT_L8A8_UNORM,
-          PIPE_FORMAT_L8A8_SNORM } },
-
-      { { o(EXT_texture_compression_s3tc),
-          o(ANGLE_texture_compression_dxt) },
-        { PIPE_FORMAT_DXT1_RGB,
-          PIPE_FORMAT_DXT1_RGBA,
-          PIPE_FORMAT_DXT3_RGBA,
-          PIPE_FORMAT_DXT5_RGBA } },
-
-      /* S3TC software fallback support. */
-      { { o(EXT_texture_compression_s3tc),
-          o(ANGLE_texture_compression_dxt) },
-        { PIPE_FORMAT_R8G8B8A8_UNORM } },
-
-      { { o(EXT_texture_compression_s3tc_srgb) },
-        { PIPE_FORMAT_DXT1_SRGB,
-          PIPE_FORMAT_DXT1_SRGBA,
-          PIPE_FORMAT_DXT3_SRGBA,
-          PIPE_FORMAT_DXT5_SRGBA } },
-
-      /* S3TC SRGB software fallback support. */
-      { { o(EXT_texture_compression_s3tc_srgb) },
-        { PIPE_FORMAT_R8G8B8A8_SRGB } },
-
-      { { o(ARB_texture_compression_bptc) },
-        { PIPE_FORMAT_BPTC_RGBA_UNORM,
-          PIPE_FORMAT_BPTC_SRGBA,
-          PIPE_FORMAT_BPTC_RGB_FLOAT,
-          PIPE_FORMAT_BPTC_RGB_UFLOAT } },
-
-      /* BPTC software fallback support. */
-      { { o(ARB_texture_compression_bptc) },
-        { PIPE_FORMAT_R8G8B8A8_UNORM,
-          PIPE_FORMAT_R8G8B8A8_SRGB,
-          PIPE_FORMAT_R16G16B16X16_FLOAT } },
-
-      { { o(TDFX_texture_compression_FXT1) },
-        { PIPE_FORMAT_FXT1_RGB,
-          PIPE_FORMAT_FXT1_RGBA } },
-
-      { { o(KHR_texture_compression_astc_ldr),
-          o(KHR_texture_compression_astc_sliced_3d) },
-        { PIPE_FORMAT_ASTC_4x4,
-          PIPE_FORMAT_ASTC_5x4,
-          PIPE_FORMAT_ASTC_5x5,
-          PIPE_FORMAT_ASTC_6x5,
-          PIPE_FORMAT_ASTC_6x6,
-          PIPE_FORMAT_ASTC_8x5,
-          PIPE_FORMAT_ASTC_8x6,
-          PIPE_FORMAT_ASTC_8x8,
-          PIPE_FORMAT_ASTC_10x5,
-          PIPE_FORMAT_ASTC_10x6,
-          PIPE_FORMAT_ASTC_10x8,
-          PIPE_FORMAT_ASTC_10x10,
-          PIPE_FORMAT_ASTC_12x10,
-          PIPE_FORMAT_ASTC_12x12,
-          PIPE_FORMAT_ASTC_4x4_SRGB,
-          PIPE_FORMAT_ASTC_5x4_SRGB,
-          PIPE_FORMAT_ASTC_5x5_SRGB,
-          PIPE_FORMAT_ASTC_6x5_SRGB,
-          PIPE_FORMAT_ASTC_6x6_SRGB,
-          PIPE_FORMAT_ASTC_8x5_SRGB,
-          PIPE_FORMAT_ASTC_8x6_SRGB,
-          PIPE_FORMAT_ASTC_8x8_SRGB,
-          PIPE_FORMAT_ASTC_10x5_SRGB,
-          PIPE_FORMAT_ASTC_10x6_SRGB,
-          PIPE_FORMAT_ASTC_10x8_SRGB,
-          PIPE_FORMAT_ASTC_10x10_SRGB,
-          PIPE_FORMAT_ASTC_12x10_SRGB,
-          PIPE_FORMAT_ASTC_12x12_SRGB } },
-
-      /* ASTC software fallback support. */
-      { { o(KHR_texture_compression_astc_ldr),
-          o(KHR_texture_compression_astc_sliced_3d) },
-        { PIPE_FORMAT_R8G8B8A8_UNORM,
-          PIPE_FORMAT_R8G8B8A8_SRGB } },
-
-      { { o(EXT_texture_shared_exponent) },
-        { PIPE_FORMAT_R9G9B9E5_FLOAT } },
-
-      { { o(EXT_texture_snorm) },
-        { PIPE_FORMAT_R8G8B8A8_SNORM } },
-
-      { { o(EXT_texture_sRGB),
-          o(EXT_texture_sRGB_decode) },
-        { PIPE_FORMAT_A8B8G8R8_SRGB,
-	  PIPE_FORMAT_B8G8R8A8_SRGB,
-	  PIPE_FORMAT_A8R8G8B8_SRGB,
-	  PIPE_FORMAT_R8G8B8A8_SRGB},
-        GL_TRUE }, /* at least one format must be supported */
-
-      { { o(EXT_texture_sRGB_R8) },
-        { PIPE_FORMAT_R8_SRGB }, },
-
-      { { o(EXT_texture_sRGB_RG8) },
-        { PIPE_FORMAT_R8G8_SRGB }, },
-
-      { { o(EXT_texture_type_2_10_10_10_REV) },
-        { PIPE_FORMAT_R10G10B10A2_UNORM,
-          PIPE_FORMAT_B10G10R10A2_UNORM },
-         GL_TRUE }, /* at least one format must be supported */
-
-      { { o(ATI_texture_compression_3dc) },
-        { PIPE_FORMAT_LATC2_UNORM } },
-
-      { { o(ATI_texture_compression_3dc) },
-        { PIPE_FORMAT_L8A8_UNORM } },
-
-      { { o(MESA_ycbcr_texture) },
-        { PIPE_FORMAT_UYVY,
-          PIPE_FORMAT_YUYV },
-        GL_TRUE }, /* at least one format must be supported */
-
-      { { o(OES_compressed_ETC1_RGB8_texture) },
-        { PIPE_FORMAT_ETC1_RGB8,
-          PIPE_FORMAT_R8G8B8A8_UNORM },
-        GL_TRUE }, /* at least one format must be supported */
-
-      { { o(ARB_stencil_texturing),
-          o(ARB_texture_stencil8) },
-        { PIPE_FORMAT_X24S8_UINT,
-          PIPE_FORMAT_S8X24_UINT },
-        GL_TRUE }, /* at least one format must be supported */
-
-      { { o(AMD_compressed_ATC_texture) },
-        { PIPE_FORMAT_ATC_RGB,
-          PIPE_FORMAT_ATC_RGBA_EXPLICIT,
-          PIPE_FORMAT_ATC_RGBA_INTERPOLATED } },
-   };
-
-   /* Required: vertex fetch support. */
-   static const struct st_extension_format_mapping vertex_mapping[] = {
-      { { o(EXT_vertex_array_bgra) },
-        { PIPE_FORMAT_B8G8R8A8_UNORM } },
-      { { o(ARB_vertex_type_2_10_10_10_rev) },
-        { PIPE_FORMAT_R10G10B10A2_UNORM,
-          PIPE_FORMAT_B10G10R10A2_UNORM,
-          PIPE_FORMAT_R10G10B10A2_SNORM,
-          PIPE_FORMAT_B10G10R10A2_SNORM,
-          PIPE_FORMAT_R10G10B10A2_USCALED,
-          PIPE_FORMAT_B10G10R10A2_USCALED,
-          PIPE_FORMAT_R10G10B10A2_SSCALED,
-          PIPE_FORMAT_B10G10R10A2_SSCALED } },
-      { { o(ARB_vertex_type_10f_11f_11f_rev) },
-        { PIPE_FORMAT_R11G11B10_FLOAT } },
-   };
-
    static const struct st_extension_format_mapping tbo_rgb32[] = {
       { {o(ARB_texture_buffer_object_rgb32) },
         { PIPE_FORMAT_R32G32B32_FLOAT,
@@ -1139,22 +1229,8 @@ void st_init_extensions(struct pipe_screen *screen,
       extensions->ARB_texture_filter_minmax = GL_TRUE;
 
    /* Expose the extensions which directly correspond to gallium formats. */
-   init_format_extensions(screen, extensions, rendertarget_mapping,
-                          ARRAY_SIZE(rendertarget_mapping), PIPE_TEXTURE_2D,
-                          PIPE_BIND_RENDER_TARGET | PIPE_BIND_SAMPLER_VIEW);
-   init_format_extensions(screen, extensions, rt_blendable,
-                          ARRAY_SIZE(rt_blendable), PIPE_TEXTURE_2D,
-                          PIPE_BIND_RENDER_TARGET | PIPE_BIND_SAMPLER_VIEW |
-                          PIPE_BIND_BLENDABLE);
-   init_format_extensions(screen, extensions, depthstencil_mapping,
-                          ARRAY_SIZE(depthstencil_mapping), PIPE_TEXTURE_2D,
-                          PIPE_BIND_DEPTH_STENCIL | PIPE_BIND_SAMPLER_VIEW);
-   init_format_extensions(screen, extensions, texture_mapping,
-                          ARRAY_SIZE(texture_mapping), PIPE_TEXTURE_2D,
-                          PIPE_BIND_SAMPLER_VIEW);
-   init_format_extensions(screen, extensions, vertex_mapping,
-                          ARRAY_SIZE(vertex_mapping), PIPE_BUFFER,
-                          PIPE_BIND_VERTEX_BUFFER);
+   for (i = 0; i < offsetof(struct gl_extensions, extension_sentinel); i++)
+      extension_table[i] |= format_table[i];
 
    /* Figure out GLSL support and set GLSLVersion to it. */
    consts->GLSLVersion = screen->get_param(screen, PIPE_CAP_GLSL_FEATURE_LEVEL);
@@ -1322,56 +1398,12 @@ void st_init_extensions(struct pipe_screen *screen,
 
    /* Maximum sample count. */
    {
-      static const enum pipe_format color_formats[] = {
-         PIPE_FORMAT_R8G8B8A8_UNORM,
-         PIPE_FORMAT_B8G8R8A8_UNORM,
-         PIPE_FORMAT_A8R8G8B8_UNORM,
-         PIPE_FORMAT_A8B8G8R8_UNORM,
-      };
-      static const enum pipe_format depth_formats[] = {
-         PIPE_FORMAT_Z16_UNORM,
-         PIPE_FORMAT_Z24X8_UNORM,
-         PIPE_FORMAT_X8Z24_UNORM,
-         PIPE_FORMAT_Z32_UNORM,
-         PIPE_FORMAT_Z32_FLOAT
-      };
-      static const enum pipe_format int_formats[] = {
-         PIPE_FORMAT_R8G8B8A8_SINT
-      };
-      static const enum pipe_format void_formats[] = {
-         PIPE_FORMAT_NONE
-      };
-
-      consts->MaxSamples =
-         get_max_samples_for_formats(screen, ARRAY_SIZE(color_formats),
-                                     color_formats, 16,
-                                     PIPE_BIND_RENDER_TARGET);
-
-      consts->MaxImageSamples =
-         get_max_samples_for_formats(screen, ARRAY_SIZE(color_formats),
-                                     color_formats, 16,
-                                     PIPE_BIND_SHADER_IMAGE);
-
-      consts->MaxColorTextureSamples =
-         get_max_samples_for_formats(screen, ARRAY_SIZE(color_formats),
-                                     color_formats, consts->MaxSamples,
-                                     PIPE_BIND_SAMPLER_VIEW);
-
-      consts->MaxDepthTextureSamples =
-         get_max_samples_for_formats(screen, ARRAY_SIZE(depth_formats),
-                                     depth_formats, consts->MaxSamples,
-                                     PIPE_BIND_SAMPLER_VIEW);
-
-      consts->MaxIntegerSamples =
-         get_max_samples_for_formats(screen, ARRAY_SIZE(int_formats),
-                                     int_formats, consts->MaxSamples,
-                                     PIPE_BIND_SAMPLER_VIEW);
-
-      /* ARB_framebuffer_no_attachments, assume max no. of samples 32 */
-      consts->MaxFramebufferSamples =
-         get_max_samples_for_formats(screen, ARRAY_SIZE(void_formats),
-                                     void_formats, 32,
-                                     PIPE_BIND_RENDER_TARGET);
+      consts->MaxSamples = format_caps->MaxSamples;
+      consts->MaxImageSamples = format_caps->MaxImageSamples;
+      consts->MaxColorTextureSamples = format_caps->MaxColorTextureSamples;
+      consts->MaxDepthTextureSamples = format_caps->MaxDepthTextureSamples;
+      consts->MaxIntegerSamples = format_caps->MaxIntegerSamples;
+      consts->MaxFramebufferSamples = format_caps->MaxFramebufferSamples;
 
       if (extensions->AMD_framebuffer_multisample_advanced) {
          /* AMD_framebuffer_multisample_advanced */
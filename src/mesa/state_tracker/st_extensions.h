@@ -29,10 +29,25 @@
 #ifndef ST_EXTENSIONS_H
 #define ST_EXTENSIONS_H
 
+#include "main/consts_exts.h"
 
 struct st_context;
 struct pipe_screen;
 
+/**
+ * The results of the is_format_supported() probing done by
+ * st_init_extensions(), which only depend on the screen.
+ */
+struct st_format_caps {
+   struct gl_extensions extensions;
+   GLuint MaxSamples;
+   GLuint MaxImageSamples;
+   GLuint MaxColorTextureSamples;
+   GLuint MaxDepthTextureSamples;
+   GLuint MaxIntegerSamples;
+   GLuint MaxFramebufferSamples;
+};
+
 extern void st_init_limits(struct pipe_screen *screen,
                            struct gl_constants *c,
                            struct gl_extensions *extensions,
@@ -42,7 +57,11 @@ extern void st_init_extensions(struct pipe_screen *screen,
                                struct gl_constants *consts,
                                struct gl_extensions *extensions,
                                struct st_config_options *options,
+                               const struct st_format_caps *format_caps,
                                gl_api api);
 
+extern void st_init_format_caps(struct pipe_screen *screen,
+                                struct st_format_caps *caps);
+
 
 #endif /* ST_EXTENSIONS_H */
@@ -70,6 +70,10 @@ struct st_screen
 {
    struct hash_table *drawable_ht; /* pipe_frontend_drawable objects hash table */
    simple_mtx_t st_mutex;
+
+   /* st_init_format_caps() results, computed on first use */
+   struct st_format_caps format_caps;
+   bool format_caps_valid;
 };
 
 /**
@@ -935,7 +939,7 @@ st_screen_destroy(struct pipe_frontend_screen *fscreen)
 {
    struct st_screen *screen = fscreen->st_screen;
 
-   if (screen && screen->drawable_ht) {
+   if (screen) {
       _mesa_hash_table_destroy(screen->drawable_ht, NULL);
       simple_mtx_destroy(&screen->st_mutex);
       FREE(screen);
@@ -944,6 +948,53 @@ st_screen_destroy(struct pipe_frontend_screen *fscreen)
 }
 
 
+/**
+ * Return the st_screen of the frontend screen, creating it if needed.
+ */
+static struct st_screen *
+st_screen_get(struct pipe_frontend_screen *fscreen)
+{
+   if (fscreen->st_screen == NULL) {
+      struct st_screen *screen;
+
+      screen = CALLOC_STRUCT(st_screen);
+      if (!screen)
+         return NULL;
+
+      simple_mtx_init(&screen->st_mutex, mtx_plain);
+      screen->drawable_ht = _mesa_hash_table_create(NULL,
+                                                 drawable_hash,
+                                                 drawable_equal);
+      fscreen->st_screen = screen;
+   }
+
+   return fscreen->st_screen;
+}
+
+
+/**
+ * Return the format dependent extensions and limits of the screen, which
+ * are only queried from the driver once.
+ */
+static const struct st_format_caps *
+st_screen_get_format_caps(struct pipe_frontend_screen *fscreen)
+{
+   struct st_screen *screen = st_screen_get(fscreen);
+
+   if (!screen)
+      return NULL;
+
+   simple_mtx_lock(&screen->st_mutex);
+   if (!screen->format_caps_valid) {
+      st_init_format_caps(fscreen->screen, &screen->format_caps);
+      screen->format_caps_valid = true;
+   }
+   simple_mtx_unlock(&screen->st_mutex);
+
+   return &screen->format_caps;
+}
+
+
 /**
  * Create a rendering context.
  */
@@ -956,22 +1007,18 @@ st_api_create_context(struct pipe_frontend_screen *fscreen,
    struct st_context *st;
    struct pipe_context *pipe;
    struct gl_config mode, *mode_ptr = &mode;
+   const struct st_format_caps *format_caps;
    bool no_error = false;
 
    _mesa_initialize(attribs->options.mesa_extension_override);
 
-   /* Create a hash table for the framebuffer interface objects
-    * if it has not been created for this st manager.
+   /* This also creates the hash table for the framebuffer interface
+    * objects if it has not been created for this st manager.
     */
-   if (fscreen->st_screen == NULL) {
-      struct st_screen *screen;
-
-      screen = CALLOC_STRUCT(st_screen);
-      simple_mtx_init(&screen->st_mutex, mtx_plain);
-      screen->drawable_ht = _mesa_hash_table_create(NULL,
-                                                 drawable_hash,
-                                                 drawable_equal);
-      fscreen->st_screen = screen;
+   format_caps = st_screen_get_format_caps(fscreen);
+   if (!format_caps) {
+      *error = ST_CONTEXT_ERROR_NO_MEMORY;
+      return NULL;
    }
 
    if (attribs->flags & ST_CONTEXT_FLAG_NO_ERROR)
@@ -996,7 +1043,7 @@ st_api_create_context(struct pipe_frontend_screen *fscreen,
    if (attribs->visual.color_format == PIPE_FORMAT_NONE)
       mode_ptr = NULL;
    st = st_create_context(attribs->profile, pipe, mode_ptr, shared_ctx,
-                          &attribs->options, no_error,
+                          &attribs->options, format_caps, no_error,
                           !!fscreen->validate_egl_image);
    if (!st) {
       *error = ST_CONTEXT_ERROR_NO_MEMORY;
@@ -1323,7 +1370,8 @@ st_manager_add_color_renderbuffer(struct gl_context *ctx,
 
 static unsigned
 get_version(struct pipe_screen *screen,
-            struct st_config_options *options, gl_api api)
+            struct st_config_options *options,
+            const struct st_format_caps *format_caps, gl_api api)
 {
    struct gl_constants consts = {0};
    struct gl_extensions extensions = {0};
@@ -1337,7 +1385,8 @@ get_version(struct pipe_screen *screen,
    _mesa_init_extensions(&extensions);
 
    st_init_limits(screen, &consts, &extensions, api);
-   st_init_extensions(screen, &consts, &extensions, options, api);
+   st_init_extensions(screen, &consts, &extensions, options, format_caps,
+                      api);
    version = _mesa_get_version(&extensions, &consts, api);
    free(consts.SpirVExtensions);
    return version;
@@ -1356,10 +1405,23 @@ st_api_query_versions(struct pipe_frontend_screen *fscreen,
                       int *gl_es1_version,
                       int *gl_es2_version)
 {
-   *gl_core_version = get_version(fscreen->screen, options, API_OPENGL_CORE);
-   *gl_compat_version = get_version(fscreen->screen, options, API_OPENGL_COMPAT);
-   *gl_es1_version = get_version(fscreen->screen, options, API_OPENGLES);
-   *gl_es2_version = get_version(fscreen->screen, options, API_OPENGLES2);
+   const struct st_format_caps *format_caps =
+      st_screen_get_format_caps(fscreen);
+
+   if (!format_caps) {
+      *gl_core_version = *gl_compat_version = 0;
+      *gl_es1_version = *gl_es2_version = 0;
+      return;
+   }
+
+   *gl_core_version = get_version(fscreen->screen, options, format_caps,
+                                  API_OPENGL_CORE);
+   *gl_compat_version = get_version(fscreen->screen, options, format_caps,
+                                    API_OPENGL_COMPAT);
+   *gl_es1_version = get_version(fscreen->screen, options, format_caps,
+                                 API_OPENGLES);
+   *gl_es2_version = get_version(fscreen->screen, options, format_caps,
+                                 API_OPENGLES2);
 }
 
 
@@ -28,10 +28,41 @@
 #include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/rb_tree.h"
+#include "util/set.h"
 
 #include <assert.h>
 #include <stdio.h>
 
+/* Scalar constants are compared bitwise, so 0.0 and -0.0 stay distinct
+ * while identical NaNs are shared.
+ */
+static uint64_t
+scalar_const_bits(const struct dxil_const *c)
+{
+   if (c->value.type->type == TYPE_FLOAT && c->value.type->float_bits != 16) {
+      uint64_t bits;
+      memcpy(&bits, &c->float_value, sizeof(bits));
+      return bits;
+   }
+   return (uint64_t)c->int_value;
+}
+
+static uint32_t
+scalar_const_hash(const void *key)
+{
+   const struct dxil_const *c = key;
+   uint64_t data[2] = { (uintptr_t)c->value.type, scalar_const_bits(c) };
+   return _mesa_hash_data(data, sizeof(data));
+}
+
+static bool
+scalar_const_equal(const void *a, const void *b)
+{
+   const struct dxil_const *ca = a, *cb = b;
+   return ca->value.type == cb->value.type &&
+          scalar_const_bits(ca) == scalar_const_bits(cb);
+}
+
 void
 dxil_module_init(struct dxil_module *m, void *ralloc_ctx)
 {
@@ -54,6 +85,9 @@ dxil_module_init(struct dxil_module *m, void *ralloc_ctx)
 
    m->functions = rzalloc(ralloc_ctx, struct rb_tree);
    rb_tree_init(m->functions);
+
+   m->scalar_consts = _mesa_set_create(ralloc_ctx, scalar_const_hash,
+                                       scalar_const_equal);
 }
 
 void
@@ -341,7 +375,7 @@ create_type(struct dxil_module *m, enum type_type type)
                                         sizeof(struct dxil_type));
    if (ret) {
       ret->type = type;
-      ret->id = list_length(&m->type_list);
+      ret->id = m->num_types++;
       list_addtail(&ret->head, &m->type_list);
    }
    return ret;
@@ -1578,7 +1612,7 @@ emit_type_table(struct dxil_module *m)
 {
    if (!enter_subblock(m, DXIL_TYPE_BLOCK, 4) ||
        !emit_type_table_abbrevs(m) ||
-       !emit_record_int(m, 1, 1 + list_length(&m->type_list)))
+       !emit_record_int(m, 1, 1 + m->num_types))
       return false;
 
    list_for_each_entry(struct dxil_type, type, &m->type_list, head) {
@@ -1608,22 +1642,40 @@ static const struct dxil_value *
 get_int_const(struct dxil_module *m, const struct dxil_type *type,
               intmax_t value)
 {
-   assert(type && type->type == TYPE_INTEGER);
-
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
+   assert(type && (type->type == TYPE_INTEGER ||
+                   (type->type == TYPE_FLOAT && type->float_bits == 16)));
 
-      if (c->int_value == value)
-         return &c->value;
-   }
+   struct dxil_const key = { .value.type = type, .int_value = value };
+   struct set_entry *entry = _mesa_set_search(m->scalar_consts, &key);
+   if (entry)
+      return &((struct dxil_const *)entry->key)->value;
 
-   c = create_const(m, type, false);
+   struct dxil_const *c = create_const(m, type, false);
    if (!c)
       return NULL;
 
    c->int_value = value;
+   _mesa_set_add(m->scalar_consts, c);
+   return &c->value;
+}
+
+static const struct dxil_value *
+get_float_const(struct dxil_module *m, const struct dxil_type *type,
+                double value)
+{
+   assert(type && type->type == TYPE_FLOAT && type->float_bits != 16);
+
+   struct dxil_const key = { .value.type = type, .float_value = value };
+   struct set_entry *entry = _mesa_set_search(m->scalar_consts, &key);
+   if (entry)
+      return &((struct dxil_const *)entry->key)->value;
+
+   struct dxil_const *c = create_const(m, type, false);
+   if (!c)
+      return NULL;
+
+   c->float_value = value;
+   _mesa_set_add(m->scalar_consts, c);
    return &c->value;
 }
 
@@ -1722,21 +1774,7 @@ dxil_module_get_float16_const(struct dxil_module *m, uint16_t value)
    if (!type)
       return NULL;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (c->int_value == (uintmax_t)value)
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-
-   c->int_value = (uintmax_t)value;
-   return &c->value;
+   return get_int_const(m, type, value);
 }
 
 const struct dxil_value *
@@ -1746,21 +1784,7 @@ dxil_module_get_float_const(struct dxil_module *m, float value)
    if (!type)
       return NULL;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (c->float_value == value)
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-
-   c->float_value = value;
-   return &c->value;
+   return get_float_const(m, type, value);
 }
 
 const struct dxil_value *
@@ -1770,21 +1794,7 @@ dxil_module_get_double_const(struct dxil_module *m, double value)
    if (!type)
       return NULL;
 
-   struct dxil_const *c;
-   LIST_FOR_EACH_ENTRY(c, &m->const_list, head) {
-      if (c->value.type != type || c->undef)
-         continue;
-
-      if (c->float_value == value)
-         return &c->value;
-   }
-
-   c = create_const(m, type, false);
-   if (!c)
-      return NULL;
-
-   c->float_value = value;
-   return &c->value;
+   return get_float_const(m, type, value);
 }
 
 const struct dxil_value *
@@ -2812,7 +2822,7 @@ create_mdnode(struct dxil_module *m, enum mdnode_type type)
                                           sizeof(struct dxil_mdnode));
    if (ret) {
       ret->type = type;
-      ret->id = list_length(&m->mdnode_list) + 1; /* zero is reserved for NULL nodes */
+      ret->id = ++m->num_mdnodes; /* zero is reserved for NULL nodes */
       list_addtail(&ret->head, &m->mdnode_list);
    }
    return ret;
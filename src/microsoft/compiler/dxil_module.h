@@ -258,6 +258,11 @@ struct dxil_module {
    struct list_head const_list;
    struct list_head mdnode_list;
    struct list_head md_named_node_list;
+   unsigned num_types, num_mdnodes;
+
+   /* Non-undef integer and float constants, for fast deduplication */
+   struct set *scalar_consts;
+
    const struct dxil_type *void_type;
    const struct dxil_type *int1_type, *int8_type, *int16_type,
                           *int32_type, *int64_type;
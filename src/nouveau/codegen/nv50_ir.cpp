@@ -24,6 +24,10 @@
 #include "nv50_ir_target.h"
 #include "nv50_ir_driver.h"
 
+#include <inttypes.h>
+
+#include "util/os_time.h"
+
 namespace nv50_ir {
 
 Modifier::Modifier(operation op)
@@ -1266,6 +1270,18 @@ nv50_ir_init_prog_info(struct nv50_ir_prog_info *info,
    info_out->io.sampleMask = 0xff;
 }
 
+static void
+nv50_ir_report_phase_time(const nv50_ir::Program *prog, const char *phase,
+                          int64_t &last)
+{
+   if (!(prog->dbgFlags & NV50_IR_DEBUG_TIMING))
+      return;
+
+   int64_t now = os_time_get_nano();
+   INFO("nv50_ir: %-12s %8" PRId64 " us\n", phase, (now - last) / 1000);
+   last = now;
+}
+
 int
 nv50_ir_generate_code(struct nv50_ir_prog_info *info,
                       struct nv50_ir_prog_info_out *info_out)
@@ -1306,9 +1322,13 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
    prog->dbgFlags = info->dbgFlags;
    prog->optLevel = info->optLevel;
 
+   int64_t phase_start =
+      (prog->dbgFlags & NV50_IR_DEBUG_TIMING) ? os_time_get_nano() : 0;
+
    ret = prog->makeFromNIR(info, info_out) ? 0 : -2;
    if (ret < 0)
       goto out;
+   nv50_ir_report_phase_time(prog, "from_nir", phase_start);
    if (prog->dbgFlags & NV50_IR_DEBUG_VERBOSE)
       prog->print();
 
@@ -1316,12 +1336,14 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
    prog->getTarget()->runLegalizePass(prog, nv50_ir::CG_STAGE_PRE_SSA);
 
    prog->convertToSSA();
+   nv50_ir_report_phase_time(prog, "to_ssa", phase_start);
 
    if (prog->dbgFlags & NV50_IR_DEBUG_VERBOSE)
       prog->print();
 
    prog->optimizeSSA(info->optLevel);
    prog->getTarget()->runLegalizePass(prog, nv50_ir::CG_STAGE_SSA);
+   nv50_ir_report_phase_time(prog, "opt_ssa", phase_start);
 
    if (prog->dbgFlags & NV50_IR_DEBUG_BASIC)
       prog->print();
@@ -1330,14 +1352,17 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info,
       ret = -4;
       goto out;
    }
+   nv50_ir_report_phase_time(prog, "ra", phase_start);
    prog->getTarget()->runLegalizePass(prog, nv50_ir::CG_STAGE_POST_RA);
 
    prog->optimizePostRA(info->optLevel);
+   nv50_ir_report_phase_time(prog, "opt_post_ra", phase_start);
 
    if (!prog->emitBinary(info_out)) {
       ret = -5;
       goto out;
    }
+   nv50_ir_report_phase_time(prog, "emit", phase_start);
 
 out:
    INFO_DBG(prog->dbgFlags, VERBOSE, "nv50_ir_generate_code: ret = %i\n", ret);
@@ -71,6 +71,8 @@ struct nv50_ir_sysval
 # define NV50_IR_DEBUG_VERBOSE   0
 # define NV50_IR_DEBUG_REG_ALLOC 0
 #endif
+/* Print the time spent in each compilation phase, also in release builds. */
+#define NV50_IR_DEBUG_TIMING    (1 << 3)
 
 struct nv50_ir_prog_symbol
 {
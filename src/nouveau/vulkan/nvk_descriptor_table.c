@@ -10,47 +10,60 @@
 #include <sys/mman.h>
 
 static VkResult
-nvk_descriptor_table_grow_locked(struct nvk_device *dev,
-                                 struct nvk_descriptor_table *table,
-                                 uint32_t new_alloc)
+nvk_descriptor_table_alloc_bo(struct nvk_device *dev,
+                              struct nvk_descriptor_table *table,
+                              uint32_t new_alloc,
+                              struct nouveau_ws_bo **bo_out,
+                              void **map_out)
 {
-   struct nouveau_ws_bo *new_bo;
-   void *new_map;
-   uint32_t *new_free_table;
-
-   assert(new_alloc > table->alloc && new_alloc <= table->max_alloc);
-
    const uint32_t new_bo_size = new_alloc * table->desc_size;
-   new_bo = nouveau_ws_bo_new_mapped(dev->ws_dev, new_bo_size, 256,
-                                     NOUVEAU_WS_BO_LOCAL |
-                                     NOUVEAU_WS_BO_NO_SHARE,
-                                     NOUVEAU_WS_BO_WR,
-                                     &new_map);
-   if (new_bo == NULL) {
+   *bo_out = nouveau_ws_bo_new_mapped(dev->ws_dev, new_bo_size, 256,
+                                      NOUVEAU_WS_BO_LOCAL |
+                                      NOUVEAU_WS_BO_NO_SHARE,
+                                      NOUVEAU_WS_BO_WR,
+                                      map_out);
+   if (*bo_out == NULL) {
       return vk_errorf(dev, VK_ERROR_OUT_OF_DEVICE_MEMORY,
                        "Failed to allocate the image descriptor table");
    }
 
-   if (table->bo) {
-      assert(new_bo_size >= table->bo->size);
-      memcpy(new_map, table->map, table->bo->size);
+   return VK_SUCCESS;
+}
 
-      nouveau_ws_bo_unmap(table->bo, table->map);
-      nouveau_ws_bo_destroy(table->bo);
-   }
-   table->bo = new_bo;
-   table->map = new_map;
+/* Takes ownership of new_bo, even on failure */
+static VkResult
+nvk_descriptor_table_install_bo_locked(struct nvk_device *dev,
+                                       struct nvk_descriptor_table *table,
+                                       uint32_t new_alloc,
+                                       struct nouveau_ws_bo *new_bo,
+                                       void *new_map)
+{
+   uint32_t *new_free_table;
+
+   assert(new_alloc > table->alloc && new_alloc <= table->max_alloc);
 
    const size_t new_free_table_size = new_alloc * sizeof(uint32_t);
    new_free_table = vk_realloc(&dev->vk.alloc, table->free_table,
                                new_free_table_size, 4,
                                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
    if (new_free_table == NULL) {
+      nouveau_ws_bo_unmap(new_bo, new_map);
+      nouveau_ws_bo_destroy(new_bo);
       return vk_errorf(dev, VK_ERROR_OUT_OF_HOST_MEMORY,
                        "Failed to allocate image descriptor free table");
    }
    table->free_table = new_free_table;
 
+   if (table->bo) {
+      assert(new_bo->size >= table->bo->size);
+      memcpy(new_map, table->map, table->bo->size);
+
+      nouveau_ws_bo_unmap(table->bo, table->map);
+      nouveau_ws_bo_destroy(table->bo);
+   }
+   table->bo = new_bo;
+   table->map = new_map;
+
    table->alloc = new_alloc;
 
    return VK_SUCCESS;
@@ -77,7 +90,15 @@ nvk_descriptor_table_init(struct nvk_device *dev,
    table->next_desc = 0;
    table->free_count = 0;
 
-   result = nvk_descriptor_table_grow_locked(dev, table, min_descriptor_count);
+   struct nouveau_ws_bo *bo;
+   void *map;
+   result = nvk_descriptor_table_alloc_bo(dev, table, min_descriptor_count,
+                                          &bo, &map);
+   if (result == VK_SUCCESS) {
+      result = nvk_descriptor_table_install_bo_locked(dev, table,
+                                                      min_descriptor_count,
+                                                      bo, map);
+   }
    if (result != VK_SUCCESS) {
       nvk_descriptor_table_finish(dev, table);
       return result;
@@ -107,29 +128,51 @@ nvk_descriptor_table_alloc_locked(struct nvk_device *dev,
 {
    VkResult result;
 
-   if (table->free_count > 0) {
-      *index_out = table->free_table[--table->free_count];
-      return VK_SUCCESS;
-   }
-
-   if (table->next_desc < table->alloc) {
-      *index_out = table->next_desc++;
-      return VK_SUCCESS;
+   while (true) {
+      if (table->free_count > 0) {
+         *index_out = table->free_table[--table->free_count];
+         return VK_SUCCESS;
+      }
+
+      if (table->next_desc < table->alloc) {
+         *index_out = table->next_desc++;
+         return VK_SUCCESS;
+      }
+
+      if (table->next_desc >= table->max_alloc) {
+         return vk_errorf(dev, VK_ERROR_OUT_OF_HOST_MEMORY,
+                          "Descriptor table not large enough");
+      }
+
+      /* Creating the new BO is a kernel round-trip and potentially a large
+       * allocation.  Do it without the lock so that other threads can keep
+       * adding and removing descriptors in the meantime.  Only the copy of
+       * the old contents has to happen under the lock.
+       */
+      const uint32_t old_alloc = table->alloc;
+      struct nouveau_ws_bo *new_bo;
+      void *new_map;
+
+      simple_mtx_unlock(&table->mutex);
+      result = nvk_descriptor_table_alloc_bo(dev, table, old_alloc * 2,
+                                             &new_bo, &new_map);
+      simple_mtx_lock(&table->mutex);
+      if (result != VK_SUCCESS)
+         return result;
+
+      if (table->alloc != old_alloc) {
+         /* Someone else grew the table while we were unlocked */
+         nouveau_ws_bo_unmap(new_bo, new_map);
+         nouveau_ws_bo_destroy(new_bo);
+         continue;
+      }
+
+      result = nvk_descriptor_table_install_bo_locked(dev, table,
+                                                      old_alloc * 2,
+                                                      new_bo, new_map);
+      if (result != VK_SUCCESS)
+         return result;
    }
-
-   if (table->next_desc >= table->max_alloc) {
-      return vk_errorf(dev, VK_ERROR_OUT_OF_HOST_MEMORY,
-                       "Descriptor table not large enough");
-   }
-
-   result = nvk_descriptor_table_grow_locked(dev, table, table->alloc * 2);
-   if (result != VK_SUCCESS)
-      return result;
-
-   assert(table->next_desc < table->alloc);
-   *index_out = table->next_desc++;
-
-   return VK_SUCCESS;
 }
 
 static VkResult
@@ -13,6 +13,8 @@
 #include "vk_pipeline_cache.h"
 #include "vulkan/wsi/wsi_common.h"
 
+#include "util/u_cpu_detect.h"
+
 #include "nouveau_context.h"
 
 #include <fcntl.h>
@@ -255,15 +257,30 @@ nvk_CreateDevice(VkPhysicalDevice physicalDevice,
       goto fail_queue;
    }
 
+   if (!(dev->ws_dev->debug_flags & NVK_DEBUG_SERIAL_COMPILE) &&
+       util_get_cpu_caps()->nr_cpus > 1) {
+      /* Each thread creating pipelines queues at most one job per stage.
+       * Not being able to create the threads isn't fatal, the stages are
+       * compiled serially then.
+       */
+      const unsigned num_threads = MIN2(util_get_cpu_caps()->nr_cpus,
+                                        MESA_VULKAN_SHADER_STAGES);
+      util_queue_init(&dev->compile_queue, "nvk_compile", 32, num_threads,
+                      UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                      UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY, NULL);
+   }
+
    result = nvk_device_init_meta(dev);
    if (result != VK_SUCCESS)
-      goto fail_mem_cache;
+      goto fail_compile_queue;
 
    *pDevice = nvk_device_to_handle(dev);
 
    return VK_SUCCESS;
 
-fail_mem_cache:
+fail_compile_queue:
+   if (util_queue_is_initialized(&dev->compile_queue))
+      util_queue_destroy(&dev->compile_queue);
    vk_pipeline_cache_destroy(dev->mem_cache, NULL);
 fail_queue:
    nvk_queue_finish(dev, &dev->queue);
@@ -302,6 +319,9 @@ nvk_DestroyDevice(VkDevice _device, const VkAllocationCallbacks *pAllocator)
 
    nvk_device_finish_meta(dev);
 
+   if (util_queue_is_initialized(&dev->compile_queue))
+      util_queue_destroy(&dev->compile_queue);
+
    vk_pipeline_cache_destroy(dev->mem_cache, NULL);
    nvk_queue_finish(dev, &dev->queue);
    if (dev->vab_memory)
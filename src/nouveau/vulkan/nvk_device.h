@@ -15,6 +15,8 @@
 #include "vk_meta.h"
 #include "vk_queue.h"
 
+#include "util/u_queue.h"
+
 struct nvk_physical_device;
 struct vk_pipeline_cache;
 
@@ -49,6 +51,9 @@ struct nvk_device {
 
    struct vk_pipeline_cache *mem_cache;
 
+   /* Compiles the stages of a pipeline in parallel, if initialized */
+   struct util_queue compile_queue;
+
    struct vk_meta_device meta;
 };
 
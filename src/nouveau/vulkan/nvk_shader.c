@@ -26,6 +26,7 @@
 
 #include "util/mesa-sha1.h"
 #include "util/u_debug.h"
+#include "util/u_queue.h"
 
 #include "cla097.h"
 #include "clb097.h"
@@ -660,26 +661,32 @@ nvk_shader_destroy(struct vk_device *vk_dev,
    vk_shader_free(&dev->vk, pAllocator, &shader->vk);
 }
 
-static VkResult
-nvk_compile_shader(struct nvk_device *dev,
-                   struct vk_shader_compile_info *info,
-                   const struct vk_graphics_pipeline_state *state,
-                   const VkAllocationCallbacks* pAllocator,
-                   struct vk_shader **shader_out)
-{
+struct nvk_compile_job {
+   struct nvk_device *dev;
+   struct vk_shader_compile_info *info;
+   const struct vk_graphics_pipeline_state *state;
    struct nvk_shader *shader;
+
    VkResult result;
+   struct util_queue_fence fence;
+};
+
+/* Lowers and compiles the NIR of one stage.  This only touches the NIR and
+ * the shader of the job, so jobs of different stages may run concurrently.
+ */
+static void
+nvk_compile_job_execute(void *data, UNUSED void *gdata,
+                        UNUSED int thread_index)
+{
+   struct nvk_compile_job *job = data;
+   struct nvk_device *dev = job->dev;
+   struct vk_shader_compile_info *info = job->info;
+   const struct vk_graphics_pipeline_state *state = job->state;
+   struct nvk_shader *shader = job->shader;
 
    /* We consume the NIR, regardless of success or failure */
    nir_shader *nir = info->nir;
 
-   shader = vk_shader_zalloc(&dev->vk, &nvk_shader_ops, info->stage,
-                             pAllocator, sizeof(*shader));
-   if (shader == NULL) {
-      ralloc_free(nir);
-      return vk_error(dev, VK_ERROR_OUT_OF_HOST_MEMORY);
-   }
-
    /* TODO: Multiview with ESO */
    const bool is_multiview = state && state->rp->view_mask != 0;
 
@@ -693,19 +700,20 @@ nvk_compile_shader(struct nvk_device *dev,
       fs_key = &fs_key_tmp;
    }
 
-   result = nvk_compile_nir(dev, nir, info->flags, info->robustness,
-                            fs_key, shader);
+   job->result = nvk_compile_nir(dev, nir, info->flags, info->robustness,
+                                 fs_key, shader);
    ralloc_free(nir);
-   if (result != VK_SUCCESS) {
-      nvk_shader_destroy(&dev->vk, &shader->vk, pAllocator);
-      return result;
-   }
+}
 
-   result = nvk_shader_upload(dev, shader);
-   if (result != VK_SUCCESS) {
-      nvk_shader_destroy(&dev->vk, &shader->vk, pAllocator);
+static VkResult
+nvk_finish_shader(struct nvk_device *dev,
+                  struct vk_shader_compile_info *info,
+                  const struct vk_graphics_pipeline_state *state,
+                  struct nvk_shader *shader)
+{
+   VkResult result = nvk_shader_upload(dev, shader);
+   if (result != VK_SUCCESS)
       return result;
-   }
 
    if (info->stage == MESA_SHADER_FRAGMENT) {
       if (shader->info.fs.reads_sample_mask ||
@@ -720,11 +728,31 @@ nvk_compile_shader(struct nvk_device *dev,
       }
    }
 
-   *shader_out = &shader->vk;
-
    return VK_SUCCESS;
 }
 
+static bool
+nvk_can_compile_in_parallel(struct nvk_device *dev, uint32_t shader_count,
+                            const struct vk_shader_compile_info *infos)
+{
+   struct nvk_physical_device *pdev = nvk_device_physical(dev);
+
+   if (shader_count < 2 || !util_queue_is_initialized(&dev->compile_queue))
+      return false;
+
+   /* Keep NAK debug output readable */
+   if (nak_debug_flags(pdev->nak) != 0)
+      return false;
+
+   /* Only NAK is known to be fine with compiling several shaders at once */
+   for (uint32_t i = 0; i < shader_count; i++) {
+      if (!use_nak(pdev, infos[i].stage))
+         return false;
+   }
+
+   return true;
+}
+
 static VkResult
 nvk_compile_shaders(struct vk_device *vk_dev,
                     uint32_t shader_count,
@@ -734,26 +762,82 @@ nvk_compile_shaders(struct vk_device *vk_dev,
                     struct vk_shader **shaders_out)
 {
    struct nvk_device *dev = container_of(vk_dev, struct nvk_device, vk);
+   struct nvk_compile_job jobs[MESA_VULKAN_SHADER_STAGES];
+   VkResult result = VK_SUCCESS;
 
+   assert(shader_count <= ARRAY_SIZE(jobs));
+
+   /* Allocate all the shaders up-front on this thread, so that the
+    * application's allocator only ever gets called from here.
+    */
    for (uint32_t i = 0; i < shader_count; i++) {
-      VkResult result = nvk_compile_shader(dev, &infos[i], state,
-                                           pAllocator, &shaders_out[i]);
-      if (result != VK_SUCCESS) {
-         /* Clean up all the shaders before this point */
+      struct nvk_shader *shader =
+         vk_shader_zalloc(&dev->vk, &nvk_shader_ops, infos[i].stage,
+                          pAllocator, sizeof(*shader));
+      if (shader == NULL) {
          for (uint32_t j = 0; j < i; j++)
-            nvk_shader_destroy(&dev->vk, shaders_out[j], pAllocator);
+            nvk_shader_destroy(&dev->vk, &jobs[j].shader->vk, pAllocator);
 
-         /* Clean up all the NIR after this point */
-         for (uint32_t j = i + 1; j < shader_count; j++)
+         /* We consume the NIR, regardless of success or failure */
+         for (uint32_t j = 0; j < shader_count; j++)
             ralloc_free(infos[j].nir);
 
-         /* Memset the output array */
          memset(shaders_out, 0, shader_count * sizeof(*shaders_out));
 
-         return result;
+         return vk_error(dev, VK_ERROR_OUT_OF_HOST_MEMORY);
       }
+
+      jobs[i] = (struct nvk_compile_job) {
+         .dev = dev,
+         .info = &infos[i],
+         .state = state,
+         .shader = shader,
+      };
    }
 
+   /* Compile the stages concurrently, the first one on this thread.  The
+    * shaders are still uploaded in order below, so the result doesn't
+    * depend on which thread compiled what.
+    */
+   if (nvk_can_compile_in_parallel(dev, shader_count, infos)) {
+      for (uint32_t i = 1; i < shader_count; i++) {
+         util_queue_fence_init(&jobs[i].fence);
+         util_queue_add_job(&dev->compile_queue, &jobs[i], &jobs[i].fence,
+                            nvk_compile_job_execute, NULL, 0);
+      }
+
+      nvk_compile_job_execute(&jobs[0], NULL, 0);
+
+      for (uint32_t i = 1; i < shader_count; i++) {
+         util_queue_fence_wait(&jobs[i].fence);
+         util_queue_fence_destroy(&jobs[i].fence);
+      }
+   } else {
+      for (uint32_t i = 0; i < shader_count; i++)
+         nvk_compile_job_execute(&jobs[i], NULL, 0);
+   }
+
+   for (uint32_t i = 0; i < shader_count; i++) {
+      result = jobs[i].result;
+      if (result == VK_SUCCESS)
+         result = nvk_finish_shader(dev, &infos[i], state, jobs[i].shader);
+      if (result != VK_SUCCESS)
+         break;
+   }
+
+   if (result != VK_SUCCESS) {
+      for (uint32_t i = 0; i < shader_count; i++)
+         nvk_shader_destroy(&dev->vk, &jobs[i].shader->vk, pAllocator);
+
+      /* Memset the output array */
+      memset(shaders_out, 0, shader_count * sizeof(*shaders_out));
+
+      return result;
+   }
+
+   for (uint32_t i = 0; i < shader_count; i++)
+      shaders_out[i] = &jobs[i].shader->vk;
+
    return VK_SUCCESS;
 }
 
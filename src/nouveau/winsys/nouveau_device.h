@@ -40,6 +40,10 @@ enum nvk_debug {
     * Root descriptors still end up in a cbuf
     */
    NVK_DEBUG_NO_CBUF = 1ull << 5,
+
+   /* Compile the shaders of a pipeline one after the other
+    */
+   NVK_DEBUG_SERIAL_COMPILE = 1ull << 6,
 };
 
 struct nouveau_ws_device {
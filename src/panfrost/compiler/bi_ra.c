@@ -24,6 +24,7 @@
  *      Alyssa Rosenzweig <alyssa.rosenzweig@collabora.com>
  */
 
+#include "util/bitset.h"
 #include "util/u_memory.h"
 #include "bi_builder.h"
 #include "compiler.h"
@@ -346,6 +347,16 @@ bi_mark_interference(bi_block *block, struct lcra_state *l, uint8_t *live,
                      uint64_t preload_live, unsigned node_count, bool is_blend,
                      bool split_file, bool aligned_sr)
 {
+   /* Set of nodes with nonzero live, so that marking the interference of
+    * each write only visits the nodes which are actually live instead of
+    * every node in the shader, which is quadratic on big shaders.
+    */
+   BITSET_WORD *live_set = calloc(BITSET_WORDS(node_count), sizeof(BITSET_WORD));
+   for (unsigned i = 0; i < node_count; ++i) {
+      if (live[i])
+         BITSET_SET(live_set, i);
+   }
+
    bi_foreach_instr_in_block_rev(block, ins) {
       /* Mark all registers live after the instruction as
        * interfering with the destination */
@@ -369,7 +380,8 @@ bi_mark_interference(bi_block *block, struct lcra_state *l, uint8_t *live,
 
          l->affinity[node] &= affinity;
 
-         for (unsigned i = 0; i < node_count; ++i) {
+         unsigned i;
+         BITSET_FOREACH_SET(i, live_set, node_count) {
             uint8_t r = live[i];
 
             /* Nodes only interfere if they occupy
@@ -409,17 +421,27 @@ bi_mark_interference(bi_block *block, struct lcra_state *l, uint8_t *live,
          /* Blend shaders might clobber r0-r15, r48. */
          uint64_t clobber = BITFIELD64_MASK(16) | BITFIELD64_BIT(48);
 
-         for (unsigned i = 0; i < node_count; ++i) {
-            if (live[i])
-               l->affinity[i] &= ~clobber;
-         }
+         unsigned i;
+         BITSET_FOREACH_SET(i, live_set, node_count)
+            l->affinity[i] &= ~clobber;
       }
 
       /* Update live_in */
       preload_live = bi_postra_liveness_ins(preload_live, ins);
       bi_liveness_ins_update_ra(live, ins);
+
+      bi_foreach_dest(ins, d) {
+         if (!live[ins->dest[d].value])
+            BITSET_CLEAR(live_set, ins->dest[d].value);
+      }
+
+      bi_foreach_ssa_src(ins, s) {
+         if (live[ins->src[s].value])
+            BITSET_SET(live_set, ins->src[s].value);
+      }
    }
 
+   free(live_set);
    block->reg_live_in = preload_live;
 }
 
@@ -181,6 +181,12 @@ struct panvk_cmd_buffer {
 
    struct panvk_cmd_state state;
 
+   /* Dynamic fragment RSDs already emitted to desc_pool, keyed by the
+    * pipeline and the dynamic state baked into them. Allocated on first
+    * use, freed (with its entries) on reset.
+    */
+   struct hash_table *fs_rsd_cache;
+
    uint8_t push_constants[MAX_PUSH_CONSTANTS_SIZE];
 
    struct panvk_cmd_bind_point_state bind_points[MAX_BIND_POINTS];
@@ -48,6 +48,8 @@
 #include "pan_props.h"
 #include "pan_samples.h"
 
+#include "util/hash_table.h"
+#include "util/ralloc.h"
 #include "util/rounding.h"
 #include "util/u_pack_color.h"
 #include "vk_format.h"
@@ -501,6 +503,81 @@ panvk_cmd_prepare_samplers(struct panvk_cmd_buffer *cmdbuf,
    desc_state->samplers = samplers.gpu;
 }
 
+/* Everything that goes into a dynamic fragment RSD besides the pipeline's
+ * template. Zero-initialized so it can be hashed and compared as bytes.
+ */
+struct panvk_fs_rsd_key {
+   const struct panvk_pipeline *pipeline;
+   struct {
+      float constant_factor;
+      float clamp;
+      float slope_factor;
+   } depth_bias;
+   struct {
+      uint8_t compare_mask;
+      uint8_t write_mask;
+      uint8_t ref;
+   } s_front, s_back;
+   float blend_constants[4];
+};
+
+struct panvk_fs_rsd_entry {
+   struct panvk_fs_rsd_key key;
+   mali_ptr rsd;
+};
+
+static uint32_t
+panvk_fs_rsd_key_hash(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct panvk_fs_rsd_key));
+}
+
+static bool
+panvk_fs_rsd_key_equal(const void *a, const void *b)
+{
+   return !memcmp(a, b, sizeof(struct panvk_fs_rsd_key));
+}
+
+static void
+panvk_fs_rsd_key_init(const struct panvk_cmd_buffer *cmdbuf,
+                      const struct panvk_pipeline *pipeline,
+                      struct panvk_fs_rsd_key *key)
+{
+   const struct panvk_cmd_state *state = &cmdbuf->state;
+
+   memset(key, 0, sizeof(*key));
+   key->pipeline = pipeline;
+
+   if (pipeline->dynamic_state_mask & (1 << VK_DYNAMIC_STATE_DEPTH_BIAS)) {
+      key->depth_bias.constant_factor = state->rast.depth_bias.constant_factor;
+      key->depth_bias.clamp = state->rast.depth_bias.clamp;
+      key->depth_bias.slope_factor = state->rast.depth_bias.slope_factor;
+   }
+
+   if (pipeline->dynamic_state_mask &
+       (1 << VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK)) {
+      key->s_front.compare_mask = state->zs.s_front.compare_mask;
+      key->s_back.compare_mask = state->zs.s_back.compare_mask;
+   }
+
+   if (pipeline->dynamic_state_mask &
+       (1 << VK_DYNAMIC_STATE_STENCIL_WRITE_MASK)) {
+      key->s_front.write_mask = state->zs.s_front.write_mask;
+      key->s_back.write_mask = state->zs.s_back.write_mask;
+   }
+
+   if (pipeline->dynamic_state_mask &
+       (1 << VK_DYNAMIC_STATE_STENCIL_REFERENCE)) {
+      key->s_front.ref = state->zs.s_front.ref;
+      key->s_back.ref = state->zs.s_back.ref;
+   }
+
+   if (pipeline->dynamic_state_mask &
+       (1 << VK_DYNAMIC_STATE_BLEND_CONSTANTS))
+      memcpy(key->blend_constants, state->blend.constants,
+             sizeof(key->blend_constants));
+}
+
 static void
 panvk_draw_prepare_fs_rsd(struct panvk_cmd_buffer *cmdbuf,
                           struct panvk_draw_info *draw)
@@ -513,6 +590,25 @@ panvk_draw_prepare_fs_rsd(struct panvk_cmd_buffer *cmdbuf,
       return;
    }
 
+   /* Apps toggling between a few dynamic states (ie. stencil references)
+    * would otherwise emit a new RSD on each toggle, so look for a matching
+    * one emitted earlier in this command buffer first.
+    */
+   struct panvk_fs_rsd_key key;
+   if (!cmdbuf->state.fs_rsd) {
+      panvk_fs_rsd_key_init(cmdbuf, pipeline, &key);
+
+      if (!cmdbuf->fs_rsd_cache) {
+         cmdbuf->fs_rsd_cache = _mesa_hash_table_create(
+            NULL, panvk_fs_rsd_key_hash, panvk_fs_rsd_key_equal);
+      }
+
+      struct hash_entry *he =
+         _mesa_hash_table_search(cmdbuf->fs_rsd_cache, &key);
+      if (he)
+         cmdbuf->state.fs_rsd = ((struct panvk_fs_rsd_entry *)he->data)->rsd;
+   }
+
    if (!cmdbuf->state.fs_rsd) {
       const struct panvk_cmd_state *state = &cmdbuf->state;
       struct panfrost_ptr rsd = pan_pool_alloc_desc_aggregate(
@@ -580,6 +676,14 @@ panvk_draw_prepare_fs_rsd(struct panvk_cmd_buffer *cmdbuf,
       }
 
       cmdbuf->state.fs_rsd = rsd.gpu;
+
+      struct panvk_fs_rsd_entry *entry =
+         ralloc(cmdbuf->fs_rsd_cache, struct panvk_fs_rsd_entry);
+      if (entry) {
+         entry->key = key;
+         entry->rsd = rsd.gpu;
+         _mesa_hash_table_insert(cmdbuf->fs_rsd_cache, &entry->key, entry);
+      }
    }
 
    draw->fs_rsd = cmdbuf->state.fs_rsd;
@@ -1569,6 +1673,10 @@ panvk_reset_cmdbuf(struct vk_command_buffer *vk_cmdbuf,
    panvk_pool_reset(&cmdbuf->tls_pool);
    panvk_pool_reset(&cmdbuf->varying_pool);
 
+   /* The cached RSDs lived in desc_pool. */
+   _mesa_hash_table_destroy(cmdbuf->fs_rsd_cache, NULL);
+   cmdbuf->fs_rsd_cache = NULL;
+
    for (unsigned i = 0; i < MAX_BIND_POINTS; i++)
       memset(&cmdbuf->bind_points[i].desc_state.sets, 0,
              sizeof(cmdbuf->bind_points[0].desc_state.sets));
@@ -1592,6 +1700,7 @@ panvk_destroy_cmdbuf(struct vk_command_buffer *vk_cmdbuf)
    panvk_pool_cleanup(&cmdbuf->desc_pool);
    panvk_pool_cleanup(&cmdbuf->tls_pool);
    panvk_pool_cleanup(&cmdbuf->varying_pool);
+   _mesa_hash_table_destroy(cmdbuf->fs_rsd_cache, NULL);
    vk_command_buffer_finish(&cmdbuf->vk);
    vk_free(&dev->vk.alloc, cmdbuf);
 }
@@ -37,4 +37,40 @@ size_t
 util_compress_deflate(const uint8_t *in_data, size_t in_data_size,
                       uint8_t *out_data, size_t out_buff_size);
 
+/* Compression dictionary, only supported with zstd. Data compressed with a
+ * dictionary can only be decompressed with the same dictionary.
+ */
+struct util_compress_dict;
+
+/**
+ * Train a dictionary from a set of samples concatenated in samples. Returns
+ * the size of the dictionary written to dict_data, or 0 on failure or when
+ * dictionaries aren't supported.
+ */
+size_t
+util_compress_dict_train(void *dict_data, size_t dict_capacity,
+                         const void *samples, const size_t *sample_sizes,
+                         unsigned num_samples);
+
+struct util_compress_dict *
+util_compress_dict_create(const void *dict_data, size_t dict_size);
+
+void
+util_compress_dict_destroy(struct util_compress_dict *dict);
+
+/* Same as util_compress_deflate(), using dict if it isn't NULL. */
+size_t
+util_compress_deflate_with_dict(const struct util_compress_dict *dict,
+                                const uint8_t *in_data, size_t in_data_size,
+                                uint8_t *out_data, size_t out_buff_size);
+
+/* Same as util_compress_inflate(). Data compressed with a dictionary fails
+ * to decompress unless dict is the same dictionary, data compressed without
+ * one decompresses regardless of dict.
+ */
+bool
+util_compress_inflate_with_dict(const struct util_compress_dict *dict,
+                                const uint8_t *in_data, size_t in_data_size,
+                                uint8_t *out_data, size_t out_data_size);
+
 #endif
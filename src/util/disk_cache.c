@@ -247,6 +247,10 @@ disk_cache_type_create(const char *gpu_name,
    DRV_KEY_CPY(drv_key_blob, &ptr_size, ptr_size_size)
    DRV_KEY_CPY(drv_key_blob, &driver_flags, driver_flags_size)
 
+   if (!cache->path_init_failed && !cache->compression_disabled &&
+       debug_get_bool_option("MESA_SHADER_CACHE_COMPRESSION_DICT", false))
+      disk_cache_compress_dict_init(cache);
+
    /* Seed our rand function */
    s_rand_xorshift128plus(cache->seed_xorshift128plus, true);
 
@@ -324,6 +328,7 @@ disk_cache_destroy(struct disk_cache *cache)
       if (cache->type == DISK_CACHE_DATABASE)
          mesa_cache_db_multipart_close(&cache->cache_db);
 
+      disk_cache_compress_dict_finish(cache);
       disk_cache_destroy_mmap(cache);
    }
 
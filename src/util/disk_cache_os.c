@@ -100,10 +100,22 @@ disk_cache_get_function_identifier(void *ptr, struct mesa_sha1 *ctx)
 
 #include "util/blob.h"
 #include "util/crc32.h"
+#include "util/u_atomic.h"
 #include "util/u_debug.h"
 #include "util/ralloc.h"
 #include "util/rand_xor.h"
 
+/* Maximum size of the compression dictionary */
+#define DICT_SIZE (64 * 1024)
+
+/* The dictionary is trained once this much data has been put into the
+ * cache, but not before DICT_MIN_SAMPLES items. Bigger items only
+ * contribute their first DICT_MAX_SAMPLE_SIZE bytes.
+ */
+#define DICT_TRAINING_SIZE (4 * 1024 * 1024)
+#define DICT_MIN_SAMPLES 128
+#define DICT_MAX_SAMPLE_SIZE (128 * 1024)
+
 /* Create a directory named 'path' if it does not already exist.
  *
  * Returns: 0 if path already exists as a directory or if created.
@@ -478,6 +490,165 @@ write_all(int fd, const void *buf, size_t count)
    return done;
 }
 
+static struct util_compress_dict *
+load_compress_dict(const char *path)
+{
+   struct util_compress_dict *dict = NULL;
+   void *data = NULL;
+   struct stat sb;
+
+   int fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd == -1)
+      return NULL;
+
+   if (fstat(fd, &sb) == -1 || sb.st_size == 0 || sb.st_size > DICT_SIZE)
+      goto out;
+
+   data = malloc(sb.st_size);
+   if (data && read_all(fd, data, sb.st_size) == sb.st_size)
+      dict = util_compress_dict_create(data, sb.st_size);
+
+ out:
+   free(data);
+   close(fd);
+
+   return dict;
+}
+
+/* Publish a newly trained dictionary in the cache directory and return the
+ * dictionary found there. If another process published its dictionary
+ * first, that one wins, so that all users of the cache directory agree on
+ * the dictionary.
+ */
+static struct util_compress_dict *
+store_compress_dict(const char *path, const void *data, size_t size)
+{
+   char *filename_tmp;
+
+   if (asprintf(&filename_tmp, "%s.%u.tmp", path, (unsigned)getpid()) == -1)
+      return NULL;
+
+   int fd = open(filename_tmp, O_WRONLY | O_CLOEXEC | O_CREAT | O_EXCL, 0644);
+   if (fd != -1) {
+      bool written = write_all(fd, data, size) == size;
+      close(fd);
+
+      /* Unlike rename, link doesn't replace an existing dictionary */
+      if (written)
+         link(filename_tmp, path);
+
+      unlink(filename_tmp);
+   }
+   free(filename_tmp);
+
+   return load_compress_dict(path);
+}
+
+void
+disk_cache_compress_dict_init(struct disk_cache *cache)
+{
+   unsigned char sha1[20];
+   char buf[41];
+
+   /* The dictionary only suits the driver that trained it */
+   _mesa_sha1_compute(cache->driver_keys_blob, cache->driver_keys_blob_size,
+                      sha1);
+   _mesa_sha1_format(buf, sha1);
+
+   cache->compress_dict.path =
+      ralloc_asprintf(cache, "%s/zstd_dict_%s", cache->path, buf);
+   if (!cache->compress_dict.path)
+      return;
+
+   simple_mtx_init(&cache->compress_dict.mtx, mtx_plain);
+   util_dynarray_init(&cache->compress_dict.samples, NULL);
+   util_dynarray_init(&cache->compress_dict.sample_sizes, NULL);
+
+   cache->compress_dict.dict = load_compress_dict(cache->compress_dict.path);
+}
+
+void
+disk_cache_compress_dict_finish(struct disk_cache *cache)
+{
+   if (!cache->compress_dict.path)
+      return;
+
+   util_compress_dict_destroy(cache->compress_dict.dict);
+   util_dynarray_fini(&cache->compress_dict.sample_sizes);
+   util_dynarray_fini(&cache->compress_dict.samples);
+   simple_mtx_destroy(&cache->compress_dict.mtx);
+}
+
+/* Return the dictionary to compress an item with, or NULL to compress it
+ * without one. Until there is a dictionary, items are collected as training
+ * samples and the dictionary is trained by the put that completes the
+ * training set, which runs on a cache queue thread.
+ */
+static struct util_compress_dict *
+get_compress_dict(struct disk_cache *cache, const void *data, size_t size)
+{
+   struct util_compress_dict *dict = p_atomic_read(&cache->compress_dict.dict);
+   struct util_dynarray samples, sample_sizes;
+
+   if (dict || !cache->compress_dict.path)
+      return dict;
+
+   simple_mtx_lock(&cache->compress_dict.mtx);
+
+   if (cache->compress_dict.trained) {
+      simple_mtx_unlock(&cache->compress_dict.mtx);
+      return NULL;
+   }
+
+   size = MIN2(size, DICT_MAX_SAMPLE_SIZE);
+   void *sample = util_dynarray_grow_bytes(&cache->compress_dict.samples,
+                                           size, 1);
+   if (sample) {
+      memcpy(sample, data, size);
+      util_dynarray_append(&cache->compress_dict.sample_sizes, size_t, size);
+   }
+
+   if (cache->compress_dict.samples.size < DICT_TRAINING_SIZE ||
+       util_dynarray_num_elements(&cache->compress_dict.sample_sizes,
+                                  size_t) < DICT_MIN_SAMPLES) {
+      simple_mtx_unlock(&cache->compress_dict.mtx);
+      return NULL;
+   }
+
+   /* Train outside of the lock, concurrent puts skip sampling meanwhile */
+   cache->compress_dict.trained = true;
+   samples = cache->compress_dict.samples;
+   sample_sizes = cache->compress_dict.sample_sizes;
+   util_dynarray_init(&cache->compress_dict.samples, NULL);
+   util_dynarray_init(&cache->compress_dict.sample_sizes, NULL);
+
+   simple_mtx_unlock(&cache->compress_dict.mtx);
+
+   void *dict_data = malloc(DICT_SIZE);
+   if (dict_data) {
+      size_t dict_size =
+         util_compress_dict_train(dict_data, DICT_SIZE, samples.data,
+                                  sample_sizes.data,
+                                  util_dynarray_num_elements(&sample_sizes,
+                                                             size_t));
+
+      /* Only use a dictionary that other processes can find, otherwise the
+       * items would be lost to them.
+       */
+      if (dict_size)
+         dict = store_compress_dict(cache->compress_dict.path, dict_data,
+                                    dict_size);
+      free(dict_data);
+   }
+
+   util_dynarray_fini(&sample_sizes);
+   util_dynarray_fini(&samples);
+
+   p_atomic_set(&cache->compress_dict.dict, dict);
+
+   return dict;
+}
+
 /* Evict least recently used cache item */
 void
 disk_cache_evict_lru_item(struct disk_cache *cache)
@@ -545,7 +716,7 @@ disk_cache_evict_item(struct disk_cache *cache, char *filename)
 }
 
 static void *
-parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
+parse_and_validate_cache_item(struct disk_cache *cache, const void *cache_item,
                               size_t cache_item_size, size_t *size)
 {
    uint8_t *uncompressed_data = NULL;
@@ -610,8 +781,10 @@ parse_and_validate_cache_item(struct disk_cache *cache, void *cache_item,
 
       memcpy(uncompressed_data, data, cache_data_size);
    } else {
-      if (!util_compress_inflate(data, cache_data_size, uncompressed_data,
-                                 cf_data->uncompressed_size))
+      if (!util_compress_inflate_with_dict(p_atomic_read(&cache->compress_dict.dict),
+                                           data, cache_data_size,
+                                           uncompressed_data,
+                                           cf_data->uncompressed_size))
          goto fail;
    }
 
@@ -709,9 +882,12 @@ create_cache_item_header_and_blob(struct disk_cache_put_job *dc_job,
       compressed_data = malloc(max_buf);
       if (compressed_data == NULL)
          return false;
+      struct util_compress_dict *dict =
+         get_compress_dict(dc_job->cache, dc_job->data, dc_job->size);
+
       compressed_size =
-         util_compress_deflate(dc_job->data, dc_job->size,
-                              compressed_data, max_buf);
+         util_compress_deflate_with_dict(dict, dc_job->data, dc_job->size,
+                                         compressed_data, max_buf);
       if (compressed_size == 0)
          goto fail;
    }
@@ -1144,10 +1320,42 @@ disk_cache_destroy_mmap(struct disk_cache *cache)
    munmap(cache->index_mmap, cache->index_mmap_size);
 }
 
+struct disk_cache_db_load_ctx {
+   struct disk_cache *cache;
+   size_t *size;
+};
+
+static void *
+disk_cache_db_parse_mapped_item(const void *cache_item, size_t cache_item_size,
+                                void *user_data)
+{
+   struct disk_cache_db_load_ctx *ctx = user_data;
+
+   return parse_and_validate_cache_item(ctx->cache, cache_item,
+                                        cache_item_size, ctx->size);
+}
+
 void *
 disk_cache_db_load_item(struct disk_cache *cache, const cache_key key,
                         size_t *size)
 {
+   /* Uncompressed items are validated and copied out straight from the
+    * mapping of the DB file, which saves reading the item into a temporary
+    * buffer. Inflating is much slower than copying though, so compressed
+    * items are read out first in order to not hold the DB lock while
+    * inflating them.
+    */
+   if (cache->compression_disabled) {
+      struct disk_cache_db_load_ctx ctx = {
+         .cache = cache,
+         .size = size,
+      };
+
+      return mesa_cache_db_multipart_read_entry_mapped(&cache->cache_db, key,
+                                                       disk_cache_db_parse_mapped_item,
+                                                       &ctx);
+   }
+
    size_t cache_tem_size = 0;
    void *cache_item = mesa_cache_db_multipart_read_entry(&cache->cache_db,
                                                          key, &cache_tem_size);
@@ -35,6 +35,8 @@
 #include "util/fossilize_db.h"
 #include "util/mesa_cache_db.h"
 #include "util/mesa_cache_db_multipart.h"
+#include "util/simple_mtx.h"
+#include "util/u_dynarray.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -96,6 +98,21 @@ struct disk_cache {
    /* Don't compress cached data. This is for testing purposes only. */
    bool compression_disabled;
 
+   /* zstd dictionary shared by the items of the driver, enabled with
+    * MESA_SHADER_CACHE_COMPRESSION_DICT. It is read from the cache directory,
+    * or trained from the first items put into the cache and then stored
+    * there. Path is NULL when dictionaries are disabled.
+    */
+   struct {
+      struct util_compress_dict *dict;
+      char *path;
+
+      simple_mtx_t mtx;
+      struct util_dynarray samples;
+      struct util_dynarray sample_sizes;
+      bool trained;
+   } compress_dict;
+
    struct {
       bool enabled;
       unsigned hits;
@@ -158,6 +175,12 @@ disk_cache_write_item_to_disk(struct disk_cache_put_job *dc_job,
 bool
 disk_cache_enabled(void);
 
+void
+disk_cache_compress_dict_init(struct disk_cache *cache);
+
+void
+disk_cache_compress_dict_finish(struct disk_cache *cache);
+
 bool
 disk_cache_load_cache_index_foz(void *mem_ctx, struct disk_cache *cache);
 
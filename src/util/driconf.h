@@ -438,6 +438,10 @@
    DRI_CONF_OPT_B(mesa_glthread_driver, def, \
                   "Enable offloading GL driver work to a separate thread")
 
+#define DRI_CONF_MESA_TC_ADAPTIVE_BATCHES(def) \
+   DRI_CONF_OPT_B(mesa_tc_adaptive_batches, def, \
+                  "Adapt the size of threaded context batches to the workload")
+
 #define DRI_CONF_MESA_NO_ERROR(def) \
    DRI_CONF_OPT_B(mesa_no_error, def, \
                   "Disable GL driver error checking")
@@ -586,6 +590,10 @@
    DRI_CONF_OPT_B(disable_conservative_lrz, def, \
                   "Disable conservative LRZ")
 
+#define DRI_CONF_FREEDRENO_ASYNC_VARIANTS(def) \
+   DRI_CONF_OPT_B(freedreno_async_variants, def, \
+                  "Compile new shader variants in the background, drawing with a close generic variant until they are ready")
+
 /**
  * \brief Turnip specific configuration options
  */
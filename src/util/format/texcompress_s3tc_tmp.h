@@ -173,6 +173,89 @@ static void fetch_2d_texel_rgba_dxt5(GLint srcRowStride, const GLubyte *pixdata,
 }
 
 
+/* Decode all 16 texels of a block at once, computing the palette only once
+ * instead of for every texel like dxt135_decode_imageblock() does.  The
+ * results are the same.
+ */
+static inline void dxt135_decode_block(const GLubyte *img_block_src, GLuint dxt_type,
+                                GLubyte texels[16][4])
+{
+   const GLushort color0 = img_block_src[0] | (img_block_src[1] << 8);
+   const GLushort color1 = img_block_src[2] | (img_block_src[3] << 8);
+   const GLuint bits = img_block_src[4] | (img_block_src[5] << 8) |
+      (img_block_src[6] << 16) | ((GLuint)img_block_src[7] << 24);
+   const GLubyte r0 = EXP5TO8R(color0), g0 = EXP6TO8G(color0), b0 = EXP5TO8B(color0);
+   const GLubyte r1 = EXP5TO8R(color1), g1 = EXP6TO8G(color1), b1 = EXP5TO8B(color1);
+   GLubyte palette[4][4] = {
+      { r0, g0, b0, CHAN_MAX },
+      { r1, g1, b1, CHAN_MAX },
+   };
+
+   if ((dxt_type > 1) || (color0 > color1)) {
+      palette[2][RCOMP] = (r0 * 2 + r1) / 3;
+      palette[2][GCOMP] = (g0 * 2 + g1) / 3;
+      palette[2][BCOMP] = (b0 * 2 + b1) / 3;
+      palette[3][RCOMP] = (r0 + r1 * 2) / 3;
+      palette[3][GCOMP] = (g0 + g1 * 2) / 3;
+      palette[3][BCOMP] = (b0 + b1 * 2) / 3;
+      palette[3][ACOMP] = CHAN_MAX;
+   } else {
+      palette[2][RCOMP] = (r0 + r1) / 2;
+      palette[2][GCOMP] = (g0 + g1) / 2;
+      palette[2][BCOMP] = (b0 + b1) / 2;
+      palette[3][ACOMP] = dxt_type == 1 ? 0 : CHAN_MAX;
+   }
+   palette[2][ACOMP] = CHAN_MAX;
+
+   for (unsigned k = 0; k < 16; k++)
+      memcpy(texels[k], palette[(bits >> (2 * k)) & 3], 4);
+}
+
+static inline void decode_block_rgb_dxt1(const GLubyte *blksrc, GLubyte texels[16][4])
+{
+   dxt135_decode_block(blksrc, 0, texels);
+}
+
+static inline void decode_block_rgba_dxt1(const GLubyte *blksrc, GLubyte texels[16][4])
+{
+   dxt135_decode_block(blksrc, 1, texels);
+}
+
+static inline void decode_block_rgba_dxt3(const GLubyte *blksrc, GLubyte texels[16][4])
+{
+   dxt135_decode_block(blksrc + 8, 2, texels);
+   for (unsigned k = 0; k < 16; k++) {
+      const GLubyte anibble = (blksrc[k / 2] >> (4 * (k & 1))) & 0xf;
+      texels[k][ACOMP] = EXP4TO8(anibble);
+   }
+}
+
+static inline void decode_block_rgba_dxt5(const GLubyte *blksrc, GLubyte texels[16][4])
+{
+   const GLubyte alpha0 = blksrc[0];
+   const GLubyte alpha1 = blksrc[1];
+   GLubyte alphas[8] = { alpha0, alpha1 };
+
+   if (alpha0 > alpha1) {
+      for (unsigned code = 2; code < 8; code++)
+         alphas[code] = (alpha0 * (8 - code) + (alpha1 * (code - 1))) / 7;
+   } else {
+      for (unsigned code = 2; code < 6; code++)
+         alphas[code] = (alpha0 * (6 - code) + (alpha1 * (code - 1))) / 5;
+      alphas[6] = 0;
+      alphas[7] = CHAN_MAX;
+   }
+
+   const uint64_t codes = (uint64_t)blksrc[2] | ((uint64_t)blksrc[3] << 8) |
+      ((uint64_t)blksrc[4] << 16) | ((uint64_t)blksrc[5] << 24) |
+      ((uint64_t)blksrc[6] << 32) | ((uint64_t)blksrc[7] << 40);
+
+   dxt135_decode_block(blksrc + 8, 2, texels);
+   for (unsigned k = 0; k < 16; k++)
+      texels[k][ACOMP] = alphas[(codes >> (3 * k)) & 0x7];
+}
+
+
 /* weights used for error function, basically weights (unsquared 2/4/1) according to rgb->luminance conversion
    not sure if this really reflects visual perception */
 #define REDWEIGHT 4
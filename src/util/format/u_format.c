@@ -1228,6 +1228,13 @@ util_format_unpack_table_init(void)
          continue;
       }
 #endif
+#if defined(__SSE2__) && !defined(NO_FORMAT_ASM)
+      const struct util_format_unpack_description *unpack = util_format_unpack_description_sse2(format);
+      if (unpack) {
+         util_format_unpack_table[format] = unpack;
+         continue;
+      }
+#endif
 
       util_format_unpack_table[format] = util_format_unpack_description_generic(format);
    }
@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/detect_arch.h"
+#include "util/format/u_format.h"
+
+#if defined(__SSE2__) && !defined(NO_FORMAT_ASM)
+
+#include <emmintrin.h>
+#include "u_format_pack.h"
+
+/* 8-bit per channel RGBA formats, 4 pixels per 128-bit vector. */
+static ALWAYS_INLINE __m128i
+rgba8_to_rgba8unorm(__m128i px, bool swap_rb, bool force_alpha)
+{
+   if (swap_rb) {
+      /* Swap the R and B bytes, which are the two low bytes of the two
+       * 16-bit halves of each pixel.
+       */
+      const __m128i rb_mask = _mm_set1_epi32(0x00ff00ff);
+      __m128i rb = _mm_and_si128(px, rb_mask);
+      __m128i ga = _mm_andnot_si128(rb_mask, px);
+      rb = _mm_shufflelo_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1));
+      rb = _mm_shufflehi_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1));
+      px = _mm_or_si128(rb, ga);
+   }
+
+   if (force_alpha)
+      px = _mm_or_si128(px, _mm_set1_epi32(0xff000000));
+
+   return px;
+}
+
+static ALWAYS_INLINE void
+unpack_rgba8_8unorm(uint8_t *restrict dst, const uint8_t *restrict src,
+                    unsigned width, bool swap_rb, bool force_alpha)
+{
+   for (unsigned i = 0; i < width / 4; i++) {
+      __m128i px = _mm_loadu_si128((const __m128i *)src);
+      _mm_storeu_si128((__m128i *)dst,
+                       rgba8_to_rgba8unorm(px, swap_rb, force_alpha));
+      src += 16;
+      dst += 16;
+   }
+}
+
+static ALWAYS_INLINE void
+unpack_rgba8_float(float *restrict dst, const uint8_t *restrict src,
+                   unsigned width, bool swap_rb, bool force_alpha)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128 scale = _mm_set1_ps(1.0f / 0xff);
+
+   for (unsigned i = 0; i < width / 4; i++) {
+      __m128i px = _mm_loadu_si128((const __m128i *)src);
+      px = rgba8_to_rgba8unorm(px, swap_rb, force_alpha);
+
+      const __m128i lo = _mm_unpacklo_epi8(px, zero);
+      const __m128i hi = _mm_unpackhi_epi8(px, zero);
+
+      /* Same as the generic code: x * (1.0f / 0xff). */
+      _mm_storeu_ps(dst + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+      _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+      _mm_storeu_ps(dst + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+      _mm_storeu_ps(dst + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+
+      src += 16;
+      dst += 16;
+   }
+}
+
+#define UNPACK_RGBA8(format, swap_rb, force_alpha)                            \
+static void                                                                   \
+util_format_##format##_unpack_rgba_8unorm_sse2(uint8_t *restrict dst,         \
+                                               const uint8_t *restrict src,   \
+                                               unsigned width)                \
+{                                                                             \
+   unpack_rgba8_8unorm(dst, src, width, swap_rb, force_alpha);                \
+   if (width % 4) {                                                           \
+      unsigned done = width & ~3;                                             \
+      util_format_##format##_unpack_rgba_8unorm(dst + done * 4,               \
+                                                src + done * 4, width % 4);   \
+   }                                                                          \
+}                                                                             \
+                                                                              \
+static void                                                                   \
+util_format_##format##_unpack_rgba_float_sse2(void *restrict dst,             \
+                                              const uint8_t *restrict src,    \
+                                              unsigned width)                 \
+{                                                                             \
+   unpack_rgba8_float(dst, src, width, swap_rb, force_alpha);                 \
+   if (width % 4) {                                                           \
+      unsigned done = width & ~3;                                             \
+      util_format_##format##_unpack_rgba_float((float *)dst + done * 4,       \
+                                               src + done * 4, width % 4);    \
+   }                                                                          \
+}
+
+UNPACK_RGBA8(b8g8r8a8_unorm, true, false)
+UNPACK_RGBA8(b8g8r8x8_unorm, true, true)
+UNPACK_RGBA8(r8g8b8x8_unorm, false, true)
+
+/* R8G8B8A8_UNORM to 8unorm is a plain copy, which the generic code does
+ * well enough.
+ */
+static void
+util_format_r8g8b8a8_unorm_unpack_rgba_float_sse2(void *restrict dst,
+                                                  const uint8_t *restrict src,
+                                                  unsigned width)
+{
+   unpack_rgba8_float(dst, src, width, false, false);
+   if (width % 4) {
+      unsigned done = width & ~3;
+      util_format_r8g8b8a8_unorm_unpack_rgba_float((float *)dst + done * 4,
+                                                   src + done * 4, width % 4);
+   }
+}
+
+static const struct util_format_unpack_description util_format_unpack_descriptions_sse2[] = {
+   [PIPE_FORMAT_B8G8R8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse2,
+      .unpack_rgba = &util_format_b8g8r8a8_unorm_unpack_rgba_float_sse2,
+   },
+   [PIPE_FORMAT_B8G8R8X8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_b8g8r8x8_unorm_unpack_rgba_8unorm_sse2,
+      .unpack_rgba = &util_format_b8g8r8x8_unorm_unpack_rgba_float_sse2,
+   },
+   [PIPE_FORMAT_R8G8B8X8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r8g8b8x8_unorm_unpack_rgba_8unorm_sse2,
+      .unpack_rgba = &util_format_r8g8b8x8_unorm_unpack_rgba_float_sse2,
+   },
+   [PIPE_FORMAT_R8G8B8A8_UNORM] = {
+      .unpack_rgba_8unorm = &util_format_r8g8b8a8_unorm_unpack_rgba_8unorm,
+      .unpack_rgba = &util_format_r8g8b8a8_unorm_unpack_rgba_float_sse2,
+   },
+};
+
+const struct util_format_unpack_description *
+util_format_unpack_description_sse2(enum pipe_format format)
+{
+   /* SSE2 is part of the baseline wherever __SSE2__ is defined, so no CPU
+    * detection is needed.
+    */
+   if (format >= ARRAY_SIZE(util_format_unpack_descriptions_sse2))
+      return NULL;
+
+   if (!util_format_unpack_descriptions_sse2[format].unpack_rgba)
+      return NULL;
+
+   return &util_format_unpack_descriptions_sse2[format];
+}
+
+#endif /* __SSE2__ */
@@ -33,6 +33,7 @@
 #ifdef FOZ_DB_UTIL
 
 #include <assert.h>
+#include <fcntl.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -114,6 +115,9 @@ create_foz_db_filenames(const char *cache_path,
 }
 
 
+/* Number of index entries read from the index file at once. */
+#define FOZ_INDEX_READ_BATCH 1024
+
 /* This looks at stuff that was added to the index since the last time we looked at it. This is safe
  * to do without locking the file as we assume the file is append only */
 static void
@@ -127,61 +131,81 @@ update_foz_index(struct foz_db *foz_db, FILE *db_idx, unsigned file_idx)
    if (offset == len)
       return;
 
+   /* Every index entry is the NAME, a header and the 64bit offset of the
+    * cache item in the db file.
+    */
+   const size_t entry_size = FOSSILIZE_BLOB_HASH_LENGTH +
+                             sizeof(struct foz_payload_header) +
+                             sizeof(uint64_t);
+
+   char *buf = malloc(entry_size * FOZ_INDEX_READ_BATCH);
+   if (!buf)
+      return;
+
    fseek(db_idx, offset, SEEK_SET);
    while (offset < len) {
-      char bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH + sizeof(struct foz_payload_header)];
-      struct foz_payload_header *header;
-
-      /* Corrupt entry. Our process might have been killed before we
-       * could write all data.
+      /* A partial entry at the end is corrupt. Our process might have been
+       * killed before we could write all data.
        */
-      if (offset + sizeof(bytes_to_read) > len)
+      uint64_t num_entries = MIN2((len - offset) / entry_size,
+                                  FOZ_INDEX_READ_BATCH);
+      if (num_entries == 0)
          break;
 
-      /* NAME + HEADER in one read */
-      if (fread(bytes_to_read, 1, sizeof(bytes_to_read), db_idx) !=
-          sizeof(bytes_to_read))
+      /* Read a whole batch of entries at once and parse them from memory. */
+      num_entries = fread(buf, entry_size, num_entries, db_idx);
+      if (num_entries == 0)
          break;
 
-      offset += sizeof(bytes_to_read);
-      header = (struct foz_payload_header*)&bytes_to_read[FOSSILIZE_BLOB_HASH_LENGTH];
-
-      /* Corrupt entry. Our process might have been killed before we
-       * could write all data.
-       */
-      if (offset + header->payload_size > len ||
-          header->payload_size != sizeof(uint64_t))
-         break;
-
-      char hash_str[FOSSILIZE_BLOB_HASH_LENGTH + 1] = {0};
-      memcpy(hash_str, bytes_to_read, FOSSILIZE_BLOB_HASH_LENGTH);
+      /* Allocate the entries of the batch together instead of one by one. */
+      struct foz_db_entry *entries =
+         ralloc_array(foz_db->mem_ctx, struct foz_db_entry, num_entries);
+
+      bool corrupt = false;
+      for (unsigned i = 0; i < num_entries; i++) {
+         const char *bytes = buf + i * entry_size;
+         struct foz_payload_header header;
+         memcpy(&header, bytes + FOSSILIZE_BLOB_HASH_LENGTH, sizeof(header));
+
+         /* Corrupt entry. Our process might have been killed before we
+          * could write all data.
+          */
+         if (header.payload_size != sizeof(uint64_t)) {
+            corrupt = true;
+            break;
+         }
+
+         char hash_str[FOSSILIZE_BLOB_HASH_LENGTH + 1] = {0};
+         memcpy(hash_str, bytes, FOSSILIZE_BLOB_HASH_LENGTH);
+
+         /* cache item offset from index file */
+         uint64_t cache_offset;
+         memcpy(&cache_offset,
+                bytes + FOSSILIZE_BLOB_HASH_LENGTH + sizeof(header),
+                sizeof(cache_offset));
+
+         offset += entry_size;
+         parsed_offset = offset;
+
+         struct foz_db_entry *entry = &entries[i];
+         entry->header = header;
+         entry->file_idx = file_idx;
+         _mesa_sha1_hex_to_sha1(entry->key, hash_str);
+         entry->offset = cache_offset;
+
+         /* Truncate the entry's hash to a 64bit hash for use with a 64bit
+          * hash table for looking up file offsets.
+          */
+         uint64_t key = truncate_hash_to_64bits(entry->key);
+
+         _mesa_hash_table_u64_insert(foz_db->index_db, key, entry);
+      }
 
-      /* read cache item offset from index file */
-      uint64_t cache_offset;
-      if (fread(&cache_offset, 1, sizeof(cache_offset), db_idx) !=
-          sizeof(cache_offset))
+      if (corrupt)
          break;
-
-      offset += header->payload_size;
-      parsed_offset = offset;
-
-      struct foz_db_entry *entry = ralloc(foz_db->mem_ctx,
-                                          struct foz_db_entry);
-      entry->header = *header;
-      entry->file_idx = file_idx;
-      _mesa_sha1_hex_to_sha1(entry->key, hash_str);
-
-      /* Truncate the entry's hash string to a 64bit hash for use with a
-       * 64bit hash table for looking up file offsets.
-       */
-      hash_str[16] = '\0';
-      uint64_t key = strtoull(hash_str, NULL, 16);
-
-      entry->offset = cache_offset;
-
-      _mesa_hash_table_u64_insert(foz_db->index_db, key, entry);
    }
 
+   free(buf);
 
    fseek(db_idx, parsed_offset, SEEK_SET);
 }
@@ -259,6 +283,11 @@ load_foz_dbs(struct foz_db *foz_db, FILE *db_idx, uint8_t file_idx,
 
    flock(fileno(foz_db->file[file_idx]), LOCK_UN);
 
+#ifdef HAVE_POSIX_FADVISE
+   /* The index is read once from start to end. */
+   posix_fadvise(fileno(db_idx), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
    if (foz_db->updater.thrd) {
    /* If MESA_DISK_CACHE_READ_ONLY_FOZ_DBS_DYNAMIC_LIST is enabled, access to
     * the foz_db hash table requires locking to prevent racing between this
@@ -604,13 +633,14 @@ foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
       return NULL;
    }
 
-   uint8_t file_idx = entry->file_idx;
-   if (fseek(foz_db->file[file_idx], entry->offset, SEEK_SET) < 0)
-      goto fail;
+   /* Read with pread() rather than going through the FILE, which avoids a
+    * seek and copying the payload through the stdio buffer.  Writes are
+    * always flushed, so the file contents are up to date.
+    */
+   int fd = fileno(foz_db->file[entry->file_idx]);
 
    uint32_t header_size = sizeof(struct foz_payload_header);
-   if (fread(&entry->header, 1, header_size, foz_db->file[file_idx]) !=
-       header_size)
+   if (pread(fd, &entry->header, header_size, entry->offset) != header_size)
       goto fail;
 
    /* Check for collision using full 160bit hash for increased assurance
@@ -623,7 +653,8 @@ foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
 
    uint32_t data_sz = entry->header.payload_size;
    data = malloc(data_sz);
-   if (fread(data, 1, data_sz, foz_db->file[file_idx]) != data_sz)
+   if (!data ||
+       pread(fd, data, data_sz, entry->offset + header_size) != data_sz)
       goto fail;
 
    /* verify checksum */
@@ -642,7 +673,7 @@ foz_read_entry(struct foz_db *foz_db, const uint8_t *cache_key_160bit,
 fail:
    free(data);
 
-   /* reading db entry failed. reset the file offset */
+   /* reading db entry failed */
    simple_mtx_unlock(&foz_db->mtx);
 
    return NULL;
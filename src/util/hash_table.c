@@ -45,6 +45,7 @@
 #include <assert.h>
 
 #include "hash_table.h"
+#include "hash_table_group.h"
 #include "ralloc.h"
 #include "macros.h"
 #include "u_memory.h"
@@ -164,6 +165,7 @@ _mesa_hash_table_init(struct hash_table *ht,
    ht->entries = 0;
    ht->deleted_entries = 0;
    ht->deleted_key = &deleted_key_value;
+   ht->ctrl = NULL;
 
    return ht->table != NULL;
 }
@@ -230,6 +232,15 @@ _mesa_hash_table_clone(struct hash_table *src, void *dst_mem_ctx)
 
    memcpy(ht->table, src->table, ht->size * sizeof(struct hash_entry));
 
+   if (src->ctrl) {
+      ht->ctrl = ralloc_array(ht->table, uint8_t, group_ctrl_size(ht->size));
+      if (ht->ctrl == NULL) {
+         ralloc_free(ht);
+         return NULL;
+      }
+      memcpy(ht->ctrl, src->ctrl, group_ctrl_size(ht->size));
+   }
+
    return ht;
 }
 
@@ -258,6 +269,8 @@ static void
 hash_table_clear_fast(struct hash_table *ht)
 {
    memset(ht->table, 0, sizeof(struct hash_entry) * hash_sizes[ht->size_index].size);
+   if (ht->ctrl)
+      memset(ht->ctrl, CTRL_EMPTY, group_ctrl_size(ht->size));
    ht->entries = ht->deleted_entries = 0;
 }
 
@@ -283,6 +296,8 @@ _mesa_hash_table_clear(struct hash_table *ht,
 
          entry->key = NULL;
       }
+      if (ht->ctrl)
+         memset(ht->ctrl, CTRL_EMPTY, group_ctrl_size(ht->size));
       ht->entries = 0;
       ht->deleted_entries = 0;
    } else
@@ -305,11 +320,68 @@ _mesa_hash_table_set_deleted_key(struct hash_table *ht, const void *deleted_key)
    ht->deleted_key = deleted_key;
 }
 
+/**
+ * Switches the table to probing through groups of control bytes.
+ *
+ * Searches then compare a 7-bit tag of the hash against a whole group of
+ * entries at once with SIMD, and only look at entries whose tag matches.
+ * This costs one extra byte per entry and makes lookups in large tables,
+ * especially unsuccessful ones, touch much less memory.
+ *
+ * This must be called before any entries are added to the table.
+ */
+bool
+_mesa_hash_table_enable_group_probing(struct hash_table *ht)
+{
+   assert(ht->entries == 0 && ht->deleted_entries == 0);
+
+   if (ht->ctrl)
+      return true;
+
+   ht->ctrl = ralloc_array(ht->table, uint8_t, group_ctrl_size(ht->size));
+   if (ht->ctrl == NULL)
+      return false;
+
+   memset(ht->ctrl, CTRL_EMPTY, group_ctrl_size(ht->size));
+   return true;
+}
+
+static struct hash_entry *
+hash_table_search_group(struct hash_table *ht, uint32_t hash, const void *key)
+{
+   uint32_t size = ht->size;
+   uint32_t start_hash_address = util_fast_urem32(hash, size, ht->size_magic);
+   uint8_t tag = group_tag(hash);
+
+   group_foreach_probe(hash_address, start_hash_address, size) {
+      const uint8_t *ctrl = ht->ctrl + hash_address;
+      group_mask match = group_match(ctrl, tag);
+
+      while (match) {
+         uint32_t index = group_wrap_index(hash_address +
+                                           group_mask_next(&match), size);
+         struct hash_entry *entry = ht->table + index;
+
+         if (entry->hash == hash && entry_is_present(ht, entry) &&
+             ht->key_equals_function(key, entry->key))
+            return entry;
+      }
+
+      if (group_match_empty(ctrl))
+         return NULL;
+   }
+
+   return NULL;
+}
+
 static struct hash_entry *
 hash_table_search(struct hash_table *ht, uint32_t hash, const void *key)
 {
    assert(!key_pointer_is_reserved(ht, key));
 
+   if (ht->ctrl)
+      return hash_table_search_group(ht, hash, key);
+
    uint32_t size = ht->size;
    uint32_t start_hash_address = util_fast_urem32(hash, size, ht->size_magic);
    uint32_t double_hash = 1 + util_fast_urem32(hash, ht->rehash,
@@ -360,10 +432,39 @@ static struct hash_entry *
 hash_table_insert(struct hash_table *ht, uint32_t hash,
                   const void *key, void *data);
 
+static void
+hash_table_insert_rehash_group(struct hash_table *ht, uint32_t hash,
+                               const void *key, void *data)
+{
+   uint32_t size = ht->size;
+   uint32_t start_hash_address = util_fast_urem32(hash, size, ht->size_magic);
+
+   group_foreach_probe(hash_address, start_hash_address, size) {
+      group_mask empty = group_match_empty(ht->ctrl + hash_address);
+
+      if (likely(empty)) {
+         uint32_t index = group_wrap_index(hash_address +
+                                           group_mask_next(&empty), size);
+         struct hash_entry *entry = ht->table + index;
+
+         entry->hash = hash;
+         entry->key = key;
+         entry->data = data;
+         group_set_ctrl(ht->ctrl, size, index, group_tag(hash));
+         return;
+      }
+   }
+}
+
 static void
 hash_table_insert_rehash(struct hash_table *ht, uint32_t hash,
                          const void *key, void *data)
 {
+   if (ht->ctrl) {
+      hash_table_insert_rehash_group(ht, hash, key, data);
+      return;
+   }
+
    uint32_t size = ht->size;
    uint32_t start_hash_address = util_fast_urem32(hash, size, ht->size_magic);
    uint32_t double_hash = 1 + util_fast_urem32(hash, ht->rehash,
@@ -405,9 +506,22 @@ _mesa_hash_table_rehash(struct hash_table *ht, unsigned new_size_index)
    if (table == NULL)
       return;
 
+   uint8_t *ctrl = NULL;
+   if (ht->ctrl) {
+      uint32_t ctrl_size = group_ctrl_size(hash_sizes[new_size_index].size);
+
+      ctrl = ralloc_array(table, uint8_t, ctrl_size);
+      if (ctrl == NULL) {
+         ralloc_free(table);
+         return;
+      }
+      memset(ctrl, CTRL_EMPTY, ctrl_size);
+   }
+
    old_ht = *ht;
 
    ht->table = table;
+   ht->ctrl = ctrl;
    ht->size_index = new_size_index;
    ht->size = hash_sizes[ht->size_index].size;
    ht->rehash = hash_sizes[ht->size_index].rehash;
@@ -426,6 +540,57 @@ _mesa_hash_table_rehash(struct hash_table *ht, unsigned new_size_index)
    ralloc_free(old_ht.table);
 }
 
+static struct hash_entry *
+hash_table_get_entry_group(struct hash_table *ht, uint32_t hash,
+                           const void *key)
+{
+   struct hash_entry *available_entry = NULL;
+   uint32_t size = ht->size;
+   uint32_t start_hash_address = util_fast_urem32(hash, size, ht->size_magic);
+   uint8_t tag = group_tag(hash);
+
+   group_foreach_probe(hash_address, start_hash_address, size) {
+      const uint8_t *ctrl = ht->ctrl + hash_address;
+      group_mask match = group_match(ctrl, tag);
+
+      /* See hash_table_get_entry() for the replacement semantics. */
+      while (match) {
+         uint32_t index = group_wrap_index(hash_address +
+                                           group_mask_next(&match), size);
+         struct hash_entry *entry = ht->table + index;
+
+         if (entry->hash == hash && entry_is_present(ht, entry) &&
+             ht->key_equals_function(key, entry->key))
+            return entry;
+      }
+
+      /* Stash the first available entry we find */
+      if (available_entry == NULL) {
+         group_mask available = group_match_empty_or_deleted(ctrl);
+         if (available) {
+            uint32_t index = group_wrap_index(hash_address +
+                                              group_mask_next(&available),
+                                              size);
+            available_entry = ht->table + index;
+         }
+      }
+
+      if (group_match_empty(ctrl))
+         break;
+   }
+
+   if (available_entry) {
+      if (entry_is_deleted(ht, available_entry))
+         ht->deleted_entries--;
+      available_entry->hash = hash;
+      group_set_ctrl(ht->ctrl, size, available_entry - ht->table, tag);
+      ht->entries++;
+      return available_entry;
+   }
+
+   return NULL;
+}
+
 static struct hash_entry *
 hash_table_get_entry(struct hash_table *ht, uint32_t hash, const void *key)
 {
@@ -439,6 +604,20 @@ hash_table_get_entry(struct hash_table *ht, uint32_t hash, const void *key)
       _mesa_hash_table_rehash(ht, ht->size_index);
    }
 
+   if (ht->ctrl) {
+      struct hash_entry *entry = hash_table_get_entry_group(ht, hash, key);
+
+      /* Entries cleared behind our back by an interrupted
+       * hash_table_foreach_remove() still look used in the control bytes.
+       * Rebuilding them from the entries fixes that.
+       */
+      if (unlikely(!entry)) {
+         _mesa_hash_table_rehash(ht, ht->size_index);
+         entry = hash_table_get_entry_group(ht, hash, key);
+      }
+      return entry;
+   }
+
    uint32_t size = ht->size;
    uint32_t start_hash_address = util_fast_urem32(hash, size, ht->size_magic);
    uint32_t double_hash = 1 + util_fast_urem32(hash, ht->rehash,
@@ -539,6 +718,8 @@ _mesa_hash_table_remove(struct hash_table *ht,
       return;
 
    entry->key = ht->deleted_key;
+   if (ht->ctrl)
+      group_set_ctrl(ht->ctrl, ht->size, entry - ht->table, CTRL_DELETED);
    ht->entries--;
    ht->deleted_entries++;
 }
@@ -561,8 +742,12 @@ struct hash_entry *
 _mesa_hash_table_next_entry_unsafe(const struct hash_table *ht, struct hash_entry *entry)
 {
    assert(!ht->deleted_entries);
-   if (!ht->entries)
+   if (!ht->entries) {
+      /* hash_table_foreach_remove() has emptied the table. */
+      if (ht->ctrl)
+         memset(ht->ctrl, CTRL_EMPTY, group_ctrl_size(ht->size));
       return NULL;
+   }
    if (entry == NULL)
       entry = ht->table;
    else
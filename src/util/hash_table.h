@@ -56,6 +56,8 @@ struct hash_table {
    uint32_t size_index;
    uint32_t entries;
    uint32_t deleted_entries;
+   /* Control bytes for group probing, NULL unless enabled. */
+   uint8_t *ctrl;
 };
 
 struct hash_table *
@@ -82,6 +84,7 @@ void _mesa_hash_table_clear(struct hash_table *ht,
                             void (*delete_function)(struct hash_entry *entry));
 void _mesa_hash_table_set_deleted_key(struct hash_table *ht,
                                       const void *deleted_key);
+bool _mesa_hash_table_enable_group_probing(struct hash_table *ht);
 
 static inline uint32_t _mesa_hash_table_num_entries(struct hash_table *ht)
 {
@@ -0,0 +1,199 @@
+/*
+ * Copyright © 2024 Advanced Micro Devices, Inc.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Control-byte group probing shared by hash_table.c and set.c.
+ *
+ * Tables that opt into group probing keep one control byte per entry next
+ * to the entry array. A control byte is either CTRL_EMPTY, CTRL_DELETED or
+ * the low 7 bits of a secondary hash of the key stored in the entry. A
+ * lookup loads GROUP_WIDTH consecutive control bytes at once and compares
+ * them against the secondary hash of the key with SIMD (SSE2 or NEON, or
+ * SWAR on 64-bit words elsewhere), so only entries whose tag matches are
+ * ever touched. That keeps the scalar entry array out of the cache for
+ * unsuccessful probes, which is where big tables spend most of their time.
+ *
+ * The control array is GROUP_WIDTH - 1 bytes longer than the table and the
+ * trailing bytes mirror the first ones, so a group can be loaded at any
+ * position without wrapping.
+ */
+
+#ifndef HASH_TABLE_GROUP_H
+#define HASH_TABLE_GROUP_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "util/bitscan.h"
+#include "util/macros.h"
+#include "util/u_math.h"
+
+#if defined(__SSE2__) || (defined(_M_X64) && !defined(_M_ARM64EC))
+#include <emmintrin.h>
+#define HASH_GROUP_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define HASH_GROUP_NEON 1
+#endif
+
+#define CTRL_EMPTY   ((uint8_t)0x80)
+#define CTRL_DELETED ((uint8_t)0xfe)
+
+#if defined(HASH_GROUP_SSE2) || defined(HASH_GROUP_NEON)
+#define GROUP_WIDTH 16
+#else
+#define GROUP_WIDTH 8
+#endif
+
+/* Group match masks have one set bit per matching lane.
+ * GROUP_LANE_SHIFT converts a bit index into a lane index.
+ */
+typedef uint64_t group_mask;
+
+#if defined(HASH_GROUP_SSE2)
+#define GROUP_LANE_SHIFT 0
+
+static inline group_mask
+group_match(const uint8_t *ctrl, uint8_t tag)
+{
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+   return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag)));
+}
+
+static inline group_mask
+group_match_empty(const uint8_t *ctrl)
+{
+   return group_match(ctrl, CTRL_EMPTY);
+}
+
+static inline group_mask
+group_match_empty_or_deleted(const uint8_t *ctrl)
+{
+   /* Both special values have the top bit set, tags don't. */
+   __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+   return (unsigned)_mm_movemask_epi8(group);
+}
+
+#elif defined(HASH_GROUP_NEON)
+#define GROUP_LANE_SHIFT 2
+
+/* NEON has no movemask. Narrowing the 16 compare results to 4 bits each
+ * gives a 64-bit mask, of which one bit per lane is kept.
+ */
+static inline group_mask
+group_neon_mask(uint8x16_t cmp)
+{
+   uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+   return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) &
+          0x8888888888888888ull;
+}
+
+static inline group_mask
+group_match(const uint8_t *ctrl, uint8_t tag)
+{
+   return group_neon_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(tag)));
+}
+
+static inline group_mask
+group_match_empty(const uint8_t *ctrl)
+{
+   return group_match(ctrl, CTRL_EMPTY);
+}
+
+static inline group_mask
+group_match_empty_or_deleted(const uint8_t *ctrl)
+{
+   return group_neon_mask(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl))));
+}
+
+#else
+#define GROUP_LANE_SHIFT 3
+
+#define GROUP_LSBS 0x0101010101010101ull
+#define GROUP_MSBS 0x8080808080808080ull
+
+static inline uint64_t
+group_load(const uint8_t *ctrl)
+{
+   uint64_t group;
+   memcpy(&group, ctrl, sizeof(group));
+   return util_le64_to_cpu(group);
+}
+
+/* This can report false positives for bytes right above a real match,
+ * which is fine because every match is checked against the entry.
+ */
+static inline group_mask
+group_match(const uint8_t *ctrl, uint8_t tag)
+{
+   uint64_t x = group_load(ctrl) ^ (GROUP_LSBS * tag);
+   return (x - GROUP_LSBS) & ~x & GROUP_MSBS;
+}
+
+static inline group_mask
+group_match_empty(const uint8_t *ctrl)
+{
+   /* CTRL_EMPTY is the only control value with the top bit set and bit 1
+    * clear.
+    */
+   uint64_t group = group_load(ctrl);
+   return group & ~(group << 6) & GROUP_MSBS;
+}
+
+static inline group_mask
+group_match_empty_or_deleted(const uint8_t *ctrl)
+{
+   return group_load(ctrl) & GROUP_MSBS;
+}
+#endif
+
+static inline unsigned
+group_mask_next(group_mask *mask)
+{
+   return u_bit_scan64(mask) >> GROUP_LANE_SHIFT;
+}
+
+/* 7-bit tag stored in the control byte. The low bits of the hash select
+ * the slot, so take the tag from a multiplicative mix of the high bits.
+ */
+static inline uint8_t
+group_tag(uint32_t hash)
+{
+   return (hash * 0x9e3779b1u) >> 25;
+}
+
+static inline uint32_t
+group_ctrl_size(uint32_t size)
+{
+   return size + GROUP_WIDTH - 1;
+}
+
+/* Set the control byte of a slot and of all its mirrors past the end. */
+static inline void
+group_set_ctrl(uint8_t *ctrl, uint32_t size, uint32_t index, uint8_t value)
+{
+   for (uint32_t i = index; i < group_ctrl_size(size); i += size)
+      ctrl[i] = value;
+}
+
+/* Turn a slot index from a group search, which can point into the mirrored
+ * bytes, back into an index into the entry array.
+ */
+static inline uint32_t
+group_wrap_index(uint32_t index, uint32_t size)
+{
+   while (index >= size)
+      index -= size;
+   return index;
+}
+
+/* Iterate over the groups of a probe sequence starting at "start". Every
+ * slot has been visited once the loop runs out.
+ */
+#define group_foreach_probe(pos, start, size)                            \
+   for (uint32_t pos = (start), __probes = DIV_ROUND_UP(size, GROUP_WIDTH); \
+        __probes; __probes--,                                           \
+        pos = group_wrap_index(pos + GROUP_WIDTH, size))
+
+#endif /* HASH_TABLE_GROUP_H */
@@ -16,6 +16,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "crc32.h"
@@ -90,16 +92,118 @@ static inline bool mesa_db_truncate(FILE *file, long pos)
    return !ftruncate(fileno(file), pos);
 }
 
+static void
+mesa_db_unmap_file(struct mesa_cache_db_file *db_file)
+{
+   if (db_file->map)
+      munmap(db_file->map, db_file->map_size);
+
+   db_file->map = NULL;
+   db_file->map_size = 0;
+}
+
+/* Return a pointer to the [offset, offset + size) range of the file in the
+ * read-only mapping of the file, extending the mapping if the file has grown
+ * since it was mapped. Returns NULL if the range can't be mapped, in which
+ * case callers fall back to reading the file.
+ *
+ * The mapping has to be dropped whenever the file may get truncated, since
+ * touching pages past the end of file raises SIGBUS. Files are only
+ * truncated under the DB lock by compaction or zapping, and both reload or
+ * zap the DB afterwards, which unmaps the files.
+ */
+static const uint8_t *
+mesa_db_map_range(struct mesa_cache_db_file *db_file, uint64_t offset,
+                  uint64_t size)
+{
+   struct stat st;
+   void *map;
+
+   if (offset + size > db_file->map_size) {
+      if (fstat(fileno(db_file->file), &st) == -1 ||
+          offset + size > (uint64_t)st.st_size ||
+          (uint64_t)st.st_size > SIZE_MAX)
+         return NULL;
+
+      map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED,
+                 fileno(db_file->file), 0);
+      if (map == MAP_FAILED)
+         return NULL;
+
+      mesa_db_unmap_file(db_file);
+      db_file->map = map;
+      db_file->map_size = st.st_size;
+   }
+
+   return (const uint8_t *)db_file->map + offset;
+}
+
+/* Whether the file at the path of the DB file isn't the opened file anymore */
 static bool
-mesa_db_lock(struct mesa_cache_db *db)
+mesa_db_file_replaced(struct mesa_cache_db_file *db_file)
+{
+   struct stat path_stat, file_stat;
+
+   /* A missing file hasn't been replaced, it was removed by wiping */
+   if (stat(db_file->path, &path_stat) == -1 ||
+       fstat(fileno(db_file->file), &file_stat) == -1)
+      return false;
+
+   return path_stat.st_dev != file_stat.st_dev ||
+          path_stat.st_ino != file_stat.st_ino;
+}
+
+static bool
+mesa_db_reopen_file(struct mesa_cache_db_file *db_file)
+{
+   FILE *file = fopen(db_file->path, "r+b");
+   if (!file)
+      return false;
+
+   mesa_db_unmap_file(db_file);
+   fclose(db_file->file);
+   db_file->file = file;
+
+   return true;
+}
+
+static bool
+mesa_db_lock_flags(struct mesa_cache_db *db, bool nonblock, bool *busy)
 {
+   const int op = LOCK_EX | (nonblock ? LOCK_NB : 0);
+
    simple_mtx_lock(&db->flock_mtx);
 
-   if (flock(fileno(db->cache.file), LOCK_EX) == -1)
+retry:
+   if (flock(fileno(db->cache.file), op) == -1) {
+      if (busy)
+         *busy = errno == EWOULDBLOCK;
       goto unlock_mtx;
+   }
 
-   if (flock(fileno(db->index.file), LOCK_EX) == -1)
+   if (flock(fileno(db->index.file), op) == -1) {
+      if (busy)
+         *busy = errno == EWOULDBLOCK;
       goto unlock_cache;
+   }
+
+   /* Compaction replaces the DB files with new ones, see
+    * mesa_db_compact_swap(). Switch over to the new files, whose new UUID
+    * then makes the caller reload the index.
+    */
+   if (mesa_db_file_replaced(&db->cache) ||
+       mesa_db_file_replaced(&db->index)) {
+      flock(fileno(db->index.file), LOCK_UN);
+      flock(fileno(db->cache.file), LOCK_UN);
+
+      if ((mesa_db_file_replaced(&db->cache) &&
+           !mesa_db_reopen_file(&db->cache)) ||
+          (mesa_db_file_replaced(&db->index) &&
+           !mesa_db_reopen_file(&db->index)))
+         goto unlock_mtx;
+
+      goto retry;
+   }
 
    return true;
 
@@ -111,6 +215,12 @@ unlock_mtx:
    return false;
 }
 
+static bool
+mesa_db_lock(struct mesa_cache_db *db)
+{
+   return mesa_db_lock_flags(db, false, NULL);
+}
+
 static void
 mesa_db_unlock(struct mesa_cache_db *db)
 {
@@ -222,6 +332,9 @@ mesa_db_zap(struct mesa_cache_db *db)
    /* Disable cache to prevent the recurring faults */
    db->alive = false;
 
+   mesa_db_unmap_file(&db->cache);
+   mesa_db_unmap_file(&db->index);
+
    /* Zap corrupted database files to start over from a clean slate */
    if (!mesa_db_truncate(db->cache.file, 0) ||
        !mesa_db_truncate(db->index.file, 0))
@@ -251,19 +364,36 @@ mesa_db_update_index(struct mesa_cache_db *db)
 {
    struct mesa_index_db_hash_entry *hash_entry;
    struct mesa_index_db_file_entry index_entry;
+   const uint8_t *map = NULL;
    size_t file_length;
+   off_t map_offset;
 
    if (!mesa_db_seek_end(db->index.file))
       return false;
 
    file_length = ftell(db->index.file);
 
-   if (!mesa_db_seek(db->index.file, db->index.offset))
+   /* Parse the new index entries straight from the mapping of the index
+    * file, which avoids a read call per entry when a big index is loaded.
+    */
+   map_offset = db->index.offset;
+   if (db->index.offset < file_length)
+      map = mesa_db_map_range(&db->index, map_offset,
+                              file_length - map_offset);
+
+   if (!map && !mesa_db_seek(db->index.file, db->index.offset))
       return false;
 
    while (db->index.offset < file_length) {
-      if (!mesa_db_read(db->index.file, &index_entry))
+      if (map) {
+         if (file_length - db->index.offset < sizeof(index_entry))
+            break;
+
+         memcpy(&index_entry, map + (db->index.offset - map_offset),
+                sizeof(index_entry));
+      } else if (!mesa_db_read(db->index.file, &index_entry)) {
          break;
+      }
 
       /* Check whether the index entry looks valid or we have a corrupted DB */
       if (!mesa_db_index_entry_valid(&index_entry))
@@ -318,6 +448,10 @@ mesa_db_load(struct mesa_cache_db *db, bool reload)
          return false;
    }
 
+   /* The files may have been truncated and rewritten */
+   mesa_db_unmap_file(&db->cache);
+   mesa_db_unmap_file(&db->index);
+
    /* If file headers are invalid, then zap database files and start over */
    if (!mesa_db_load_header(&db->cache) ||
        !mesa_db_load_header(&db->index) ||
@@ -389,12 +523,16 @@ mesa_db_open_file(struct mesa_cache_db_file *db_file,
       return false;
    }
 
+   db_file->map = NULL;
+   db_file->map_size = 0;
+
    return true;
 }
 
 static void
 mesa_db_close_file(struct mesa_cache_db_file *db_file)
 {
+   mesa_db_unmap_file(db_file);
    fclose(db_file->file);
    free(db_file->path);
 }
@@ -601,6 +739,368 @@ cleanup:
    return success;
 }
 
+/* Size of the reads used to copy the cache entries during compaction */
+#define MESA_DB_COMPACTION_CHUNK_SIZE (1024 * 1024)
+
+struct mesa_db_compaction_entry {
+   uint64_t hash;
+   uint64_t cache_db_file_offset;
+   uint64_t new_cache_db_file_offset;
+   uint32_t size;
+};
+
+struct mesa_db_compaction {
+   /* Surviving entries, sorted by offset */
+   struct mesa_db_compaction_entry *entries;
+   unsigned int num_entries;
+
+   /* The DB files are read through a duplicate of the cache file descriptor,
+    * which keeps referring to the compacted file even if the DB reopens its
+    * files meanwhile.
+    */
+   int cache_fd;
+   uint64_t cache_file_length;
+
+   struct mesa_cache_db_file new_cache;
+   struct mesa_cache_db_file new_index;
+
+   void *buffer;
+   size_t buffer_size;
+};
+
+static int
+compaction_entry_sort_offset(const void *_a, const void *_b, void *arg)
+{
+   const struct mesa_db_compaction_entry *a = _a;
+   const struct mesa_db_compaction_entry *b = _b;
+
+   if (a->cache_db_file_offset == b->cache_db_file_offset)
+      return 0;
+
+   return a->cache_db_file_offset > b->cache_db_file_offset ? 1 : -1;
+}
+
+/* Select the entries surviving the eviction of at least evict_size bytes of
+ * the least recently used entries. Called with the DB locked.
+ */
+static bool
+mesa_db_compaction_select(struct mesa_cache_db *db,
+                          struct mesa_db_compaction *c,
+                          int64_t evict_size)
+{
+   struct mesa_index_db_hash_entry **entries;
+   unsigned int num_entries, i = 0;
+   bool success = false;
+
+   num_entries = _mesa_hash_table_num_entries(db->index_db->table);
+   entries = calloc(num_entries, sizeof(*entries));
+   if (!entries)
+      return false;
+
+   hash_table_foreach(db->index_db->table, entry) {
+      entries[i] = entry->data;
+      entries[i]->evicted = false;
+      i++;
+   }
+
+   util_qsort_r(entries, num_entries, sizeof(*entries),
+                entry_sort_lru, db);
+
+   for (i = 0; evict_size > 0 && i < num_entries; i++) {
+      evict_size -= blob_file_size(entries[i]->size);
+      entries[i]->evicted = true;
+   }
+
+   c->entries = calloc(num_entries, sizeof(*c->entries));
+   if (num_entries && !c->entries)
+      goto cleanup;
+
+   hash_table_u64_foreach(db->index_db, entry) {
+      struct mesa_index_db_hash_entry *hash_entry = entry.data;
+
+      if (hash_entry->evicted)
+         continue;
+
+      c->entries[c->num_entries++] = (struct mesa_db_compaction_entry) {
+         .hash = entry.key,
+         .cache_db_file_offset = hash_entry->cache_db_file_offset,
+         .size = hash_entry->size,
+      };
+   }
+
+   util_qsort_r(c->entries, c->num_entries, sizeof(*c->entries),
+                compaction_entry_sort_offset, NULL);
+
+   success = true;
+
+cleanup:
+   free(entries);
+
+   return success;
+}
+
+/* Append entries [first, last) to the new cache file. Adjacent entries are
+ * copied with a single read of up to MESA_DB_COMPACTION_CHUNK_SIZE bytes.
+ */
+static bool
+mesa_db_compaction_copy(struct mesa_db_compaction *c,
+                        unsigned int first, unsigned int last)
+{
+   struct mesa_cache_db_file_entry cache_entry;
+   unsigned int i = first, j, k;
+   uint64_t offset, size;
+   long new_offset;
+
+   while (i < last) {
+      offset = c->entries[i].cache_db_file_offset;
+      size = 0;
+      j = i;
+
+      do {
+         size += blob_file_size(c->entries[j++].size);
+      } while (j < last &&
+               c->entries[j].cache_db_file_offset == offset + size &&
+               size + blob_file_size(c->entries[j].size) <=
+                  MESA_DB_COMPACTION_CHUNK_SIZE);
+
+      if (size > c->buffer_size) {
+         void *buffer = realloc(c->buffer, size);
+         if (!buffer)
+            return false;
+
+         c->buffer = buffer;
+         c->buffer_size = size;
+      }
+
+      if (pread(c->cache_fd, c->buffer, size, offset) != (ssize_t)size)
+         return false;
+
+      new_offset = ftell(c->new_cache.file);
+
+      for (k = i; k < j; k++) {
+         uint64_t chunk_offset = c->entries[k].cache_db_file_offset - offset;
+
+         memcpy(&cache_entry, (uint8_t *)c->buffer + chunk_offset,
+                sizeof(cache_entry));
+
+         if (!mesa_db_cache_entry_valid(&cache_entry) ||
+             cache_entry.size != c->entries[k].size)
+            return false;
+
+         c->entries[k].new_cache_db_file_offset = new_offset + chunk_offset;
+      }
+
+      if (!mesa_db_write_data(c->new_cache.file, c->buffer, size))
+         return false;
+
+      i = j;
+   }
+
+   return true;
+}
+
+static bool
+mesa_db_compaction_open_file(struct mesa_cache_db_file *new_file,
+                             const struct mesa_cache_db_file *db_file)
+{
+   if (asprintf(&new_file->path, "%s.tmp", db_file->path) == -1)
+      return false;
+
+   touch_file(new_file->path);
+
+   new_file->file = fopen(new_file->path, "r+b");
+   if (!new_file->file) {
+      free(new_file->path);
+      new_file->path = NULL;
+      return false;
+   }
+
+   /* Start with an invalid header, the UUID is set on completion */
+   return mesa_db_write_header(new_file, 0, true);
+}
+
+/* Carry the entries written since the selection over into the new files,
+ * write the new index and replace the DB files with the new ones. Called
+ * with the DB locked.
+ */
+static bool
+mesa_db_compaction_swap(struct mesa_cache_db *db,
+                        struct mesa_db_compaction *c)
+{
+   struct mesa_index_db_hash_entry *hash_entry;
+   struct mesa_index_db_file_entry index_entry;
+   struct mesa_db_compaction_entry *entries;
+   unsigned int i, num_old_entries = c->num_entries;
+   unsigned int num_entries = num_old_entries;
+   uint64_t uuid;
+
+   hash_table_u64_foreach(db->index_db, entry) {
+      hash_entry = entry.data;
+      if (hash_entry->cache_db_file_offset >= c->cache_file_length)
+         num_entries++;
+   }
+
+   if (num_entries > num_old_entries) {
+      entries = realloc(c->entries, num_entries * sizeof(*entries));
+      if (!entries)
+         return false;
+
+      c->entries = entries;
+   }
+
+   hash_table_u64_foreach(db->index_db, entry) {
+      hash_entry = entry.data;
+      if (hash_entry->cache_db_file_offset < c->cache_file_length)
+         continue;
+
+      c->entries[c->num_entries++] = (struct mesa_db_compaction_entry) {
+         .hash = entry.key,
+         .cache_db_file_offset = hash_entry->cache_db_file_offset,
+         .size = hash_entry->size,
+      };
+   }
+
+   util_qsort_r(c->entries + num_old_entries,
+                c->num_entries - num_old_entries, sizeof(*c->entries),
+                compaction_entry_sort_offset, NULL);
+
+   if (!mesa_db_compaction_copy(c, num_old_entries, c->num_entries))
+      return false;
+
+   for (i = 0; i < c->num_entries; i++) {
+      hash_entry = _mesa_hash_table_u64_search(db->index_db, c->entries[i].hash);
+
+      /* Entries are only removed by compaction, which changes the UUID */
+      if (!hash_entry ||
+          hash_entry->cache_db_file_offset != c->entries[i].cache_db_file_offset)
+         return false;
+
+      index_entry.hash = c->entries[i].hash;
+      index_entry.size = c->entries[i].size;
+      index_entry.last_access_time = hash_entry->last_access_time;
+      index_entry.cache_db_file_offset = c->entries[i].new_cache_db_file_offset;
+
+      if (!mesa_db_write(c->new_index.file, &index_entry))
+         return false;
+   }
+
+   uuid = mesa_db_generate_uuid();
+
+   if (!mesa_db_write_header(&c->new_cache, uuid, false) ||
+       !mesa_db_write_header(&c->new_index, uuid, false))
+      return false;
+
+   if (rename(c->new_cache.path, db->cache.path) == -1)
+      return false;
+
+   /* The new cache file is in place already, so a failure leaves a
+    * mismatching pair of files behind.
+    */
+   if (rename(c->new_index.path, db->index.path) == -1) {
+      mesa_db_zap(db);
+      return false;
+   }
+
+   return true;
+}
+
+/* Compact the DB by evicting at least evict_size bytes of the least
+ * recently used entries, unless the UUID of the DB changed from uuid, which
+ * means that somebody else compacted it meanwhile.
+ *
+ * Unlike mesa_db_compact(), which rewrites the files in place with the DB
+ * locked, this copies the surviving entries into new files without holding
+ * the DB lock. Readers and writers, in this process or others, keep using
+ * the DB during the copy. The lock is only held while selecting the
+ * entries and while the entries written meanwhile are carried over and the
+ * new files get swapped in under a new UUID. Compactions are serialized by
+ * a lock file.
+ */
+static bool
+mesa_db_compact_swap(struct mesa_cache_db *db, uint64_t uuid,
+                     int64_t evict_size)
+{
+   struct mesa_db_compaction c = { .cache_fd = -1 };
+   char *lock_path = NULL;
+   bool success = false;
+   int lock_fd = -1;
+
+   if (asprintf(&lock_path, "%s.lock", db->cache.path) == -1)
+      return false;
+
+   lock_fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+   if (lock_fd == -1 || flock(lock_fd, LOCK_EX) == -1)
+      goto cleanup;
+
+   if (!mesa_db_lock(db))
+      goto cleanup;
+
+   if (!db->alive)
+      goto unlock;
+
+   /* reload index to sync the last access times */
+   if (!mesa_db_reload(db)) {
+      mesa_db_zap(db);
+      goto unlock;
+   }
+
+   if (db->uuid != uuid) {
+      success = true;
+      goto unlock;
+   }
+
+   if (!mesa_db_seek_end(db->cache.file)) {
+      mesa_db_zap(db);
+      goto unlock;
+   }
+
+   c.cache_file_length = ftell(db->cache.file);
+   c.cache_fd = dup(fileno(db->cache.file));
+
+   if (c.cache_fd == -1 || !mesa_db_compaction_select(db, &c, evict_size))
+      goto unlock;
+
+   mesa_db_unlock(db);
+
+   if (!mesa_db_compaction_open_file(&c.new_cache, &db->cache) ||
+       !mesa_db_compaction_open_file(&c.new_index, &db->index) ||
+       !mesa_db_compaction_copy(&c, 0, c.num_entries))
+      goto cleanup;
+
+   if (!mesa_db_lock(db))
+      goto cleanup;
+
+   /* Give up if the DB changed other than by appending entries */
+   if (!db->alive || mesa_db_uuid_changed(db))
+      goto unlock;
+
+   /* reload index to sync the last access times and to pick up the entries
+    * written meanwhile */
+   if (!mesa_db_reload(db)) {
+      mesa_db_zap(db);
+      goto unlock;
+   }
+
+   success = mesa_db_compaction_swap(db, &c);
+
+unlock:
+   mesa_db_unlock(db);
+cleanup:
+   if (c.new_index.file)
+      mesa_db_close_file(&c.new_index);
+   if (c.new_cache.file)
+      mesa_db_close_file(&c.new_cache);
+   if (c.cache_fd != -1)
+      close(c.cache_fd);
+   if (lock_fd != -1)
+      close(lock_fd);
+   free(lock_path);
+   free(c.buffer);
+   free(c.entries);
+
+   return success;
+}
+
 bool
 mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path)
 {
@@ -642,6 +1142,7 @@ close_cache:
 bool
 mesa_db_wipe_path(const char *cache_path)
 {
+   struct mesa_cache_db_file new_cache = {0}, new_index = {0};
    struct mesa_cache_db db = {0};
    bool success = true;
 
@@ -649,8 +1150,14 @@ mesa_db_wipe_path(const char *cache_path)
        !mesa_db_remove_file(&db.index, cache_path, "mesa_cache.idx"))
       success = false;
 
+   /* Leftovers of an interrupted compaction */
+   mesa_db_remove_file(&new_cache, cache_path, "mesa_cache.db.tmp");
+   mesa_db_remove_file(&new_index, cache_path, "mesa_cache.idx.tmp");
+
    free(db.cache.path);
    free(db.index.path);
+   free(new_cache.path);
+   free(new_index.path);
 
    return success;
 }
@@ -679,16 +1186,48 @@ mesa_cache_db_file_entry_size(void)
    return sizeof(struct mesa_cache_db_file_entry);
 }
 
+static void *
+mesa_db_copy_entry(const void *data, size_t size, void *user_data)
+{
+   size_t *out_size = user_data;
+   void *copy = malloc(size);
+
+   if (copy) {
+      memcpy(copy, data, size);
+      *out_size = size;
+   }
+
+   return copy;
+}
+
 void *
 mesa_cache_db_read_entry(struct mesa_cache_db *db,
                          const uint8_t *cache_key_160bit,
                          size_t *size)
+{
+   return mesa_cache_db_read_entry_mapped(db, cache_key_160bit,
+                                          mesa_db_copy_entry, size);
+}
+
+/* Look up an entry and pass its payload to read_cb, which runs with the DB
+ * locked. The payload is read from the mapping of the cache file without
+ * being copied, unless the file can't be mapped. Returns what read_cb
+ * returned, or NULL if the entry wasn't found or is corrupted.
+ */
+void *
+mesa_cache_db_read_entry_mapped(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                mesa_cache_db_read_cb read_cb,
+                                void *user_data)
 {
    uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
    struct mesa_cache_db_file_entry cache_entry;
    struct mesa_index_db_file_entry index_entry;
    struct mesa_index_db_hash_entry *hash_entry;
-   void *data = NULL;
+   const uint8_t *mapped_entry;
+   const void *data = NULL;
+   void *buffer = NULL;
+   void *result;
 
    if (!mesa_db_lock(db))
       return NULL;
@@ -706,20 +1245,39 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    if (!hash_entry)
       goto fail;
 
-   if (!mesa_db_seek(db->cache.file, hash_entry->cache_db_file_offset) ||
-       !mesa_db_read(db->cache.file, &cache_entry) ||
-       !mesa_db_cache_entry_valid(&cache_entry))
+   mapped_entry = mesa_db_map_range(&db->cache,
+                                    hash_entry->cache_db_file_offset,
+                                    sizeof(cache_entry) +
+                                    (uint64_t)hash_entry->size);
+   if (mapped_entry) {
+      memcpy(&cache_entry, mapped_entry, sizeof(cache_entry));
+   } else {
+      if (!mesa_db_seek(db->cache.file, hash_entry->cache_db_file_offset) ||
+          !mesa_db_read(db->cache.file, &cache_entry))
+         goto fail_fatal;
+   }
+
+   if (!mesa_db_cache_entry_valid(&cache_entry) ||
+       cache_entry.size != hash_entry->size)
       goto fail_fatal;
 
    if (memcmp(cache_entry.key, cache_key_160bit, sizeof(cache_entry.key)))
       goto fail;
 
-   data = malloc(cache_entry.size);
-   if (!data)
-      goto fail;
+   if (mapped_entry) {
+      data = mapped_entry + sizeof(cache_entry);
+   } else {
+      buffer = malloc(cache_entry.size);
+      if (!buffer)
+         goto fail;
 
-   if (!mesa_db_read_data(db->cache.file, data, cache_entry.size) ||
-       util_hash_crc32(data, cache_entry.size) != cache_entry.crc)
+      if (!mesa_db_read_data(db->cache.file, buffer, cache_entry.size))
+         goto fail_fatal;
+
+      data = buffer;
+   }
+
+   if (util_hash_crc32(data, cache_entry.size) != cache_entry.crc)
       goto fail_fatal;
 
    if (!mesa_db_seek(db->index.file, hash_entry->index_db_file_offset) ||
@@ -738,16 +1296,18 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
 
    fflush(db->index.file);
 
+   result = read_cb(data, cache_entry.size, user_data);
+
    mesa_db_unlock(db);
 
-   *size = cache_entry.size;
+   free(buffer);
 
-   return data;
+   return result;
 
 fail_fatal:
    mesa_db_zap(db);
 fail:
-   free(data);
+   free(buffer);
 
    mesa_db_unlock(db);
 
@@ -767,17 +1327,21 @@ mesa_cache_db_eviction_size(struct mesa_cache_db *db)
    return db->max_cache_size / 2 - sizeof(struct mesa_db_file_header);
 }
 
-bool
-mesa_cache_db_entry_write(struct mesa_cache_db *db,
-                          const uint8_t *cache_key_160bit,
-                          const void *blob, size_t blob_size)
+static bool
+mesa_cache_db_entry_write_flags(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                const void *blob, size_t blob_size,
+                                bool nonblock, bool *busy)
 {
    uint64_t hash = to_mesa_cache_db_hash(cache_key_160bit);
    struct mesa_index_db_hash_entry *hash_entry = NULL;
    struct mesa_cache_db_file_entry cache_entry;
    struct mesa_index_db_file_entry index_entry;
 
-   if (!mesa_db_lock(db))
+   if (busy)
+      *busy = false;
+
+   if (!mesa_db_lock_flags(db, nonblock, busy))
       return false;
 
    if (!db->alive)
@@ -790,14 +1354,26 @@ mesa_cache_db_entry_write(struct mesa_cache_db *db,
       goto fail_fatal;
 
    if (!mesa_cache_db_has_space_locked(db, blob_size)) {
-      if (!mesa_db_compact(db, MAX2(blob_size, mesa_cache_db_eviction_size(db)),
-                           NULL))
-         goto fail_fatal;
-   } else {
-      if (!mesa_db_update_index(db))
+      uint64_t uuid = db->uuid;
+
+      /* Compaction takes the lock by itself, only for as long as needed */
+      mesa_db_unlock(db);
+
+      if (!mesa_db_compact_swap(db, uuid,
+                                MAX2(blob_size, mesa_cache_db_eviction_size(db))) ||
+          !mesa_db_lock(db))
+         return false;
+
+      if (!db->alive)
+         goto fail;
+
+      if (mesa_db_uuid_changed(db) && !mesa_db_reload(db))
          goto fail_fatal;
    }
 
+   if (!mesa_db_update_index(db))
+      goto fail_fatal;
+
    hash_entry = _mesa_hash_table_u64_search(db->index_db, hash);
    if (hash_entry) {
       hash_entry = NULL;
@@ -853,6 +1429,30 @@ fail:
    return false;
 }
 
+bool
+mesa_cache_db_entry_write(struct mesa_cache_db *db,
+                          const uint8_t *cache_key_160bit,
+                          const void *blob, size_t blob_size)
+{
+   return mesa_cache_db_entry_write_flags(db, cache_key_160bit, blob,
+                                          blob_size, false, NULL);
+}
+
+/**
+ * Like mesa_cache_db_entry_write(), but doesn't wait if the DB is locked by
+ * another process.  In that case false is returned and *busy is set, so that
+ * the caller may pick another DB instead.
+ */
+bool
+mesa_cache_db_entry_try_write(struct mesa_cache_db *db,
+                              const uint8_t *cache_key_160bit,
+                              const void *blob, size_t blob_size,
+                              bool *busy)
+{
+   return mesa_cache_db_entry_write_flags(db, cache_key_160bit, blob,
+                                          blob_size, true, busy);
+}
+
 bool
 mesa_cache_db_entry_remove(struct mesa_cache_db *db,
                            const uint8_t *cache_key_160bit)
@@ -900,28 +1500,33 @@ fail:
    return false;
 }
 
+/**
+ * Tells whether the DB can take the blob without eviction.
+ *
+ * This is only a hint, the file lock isn't taken so that looking for a DB
+ * with space doesn't wait for writers of other processes.  The write itself
+ * checks it again under the lock.
+ */
 bool
 mesa_cache_db_has_space(struct mesa_cache_db *db, size_t blob_size)
 {
+   struct stat st;
    bool has_space;
 
-   if (!mesa_db_lock(db))
-      return false;
+   /* The mutex keeps the file from being reopened under us */
+   simple_mtx_lock(&db->flock_mtx);
 
-   if (!mesa_db_seek_end(db->cache.file))
-      goto fail_fatal;
+   if (fstat(fileno(db->cache.file), &st) == -1) {
+      simple_mtx_unlock(&db->flock_mtx);
+      return false;
+   }
 
-   has_space = mesa_cache_db_has_space_locked(db, blob_size);
+   has_space = st.st_size + blob_file_size(blob_size) -
+               sizeof(struct mesa_db_file_header) <= db->max_cache_size;
 
-   mesa_db_unlock(db);
+   simple_mtx_unlock(&db->flock_mtx);
 
    return has_space;
-
-fail_fatal:
-   mesa_db_zap(db);
-   mesa_db_unlock(db);
-
-   return false;
 }
 
 static uint64_t
@@ -26,6 +26,12 @@ struct mesa_cache_db_file {
    char *path;
    off_t offset;
    uint64_t uuid;
+
+   /* Read-only mapping of the first map_size bytes of the file, NULL if the
+    * file isn't mapped.
+    */
+   void *map;
+   size_t map_size;
 };
 
 struct mesa_cache_db {
@@ -39,6 +45,13 @@ struct mesa_cache_db {
    bool alive;
 };
 
+/* Called by mesa_cache_db_read_entry_mapped() with the payload of the entry.
+ * The data points into a mapping of the database file that is only valid
+ * for the duration of the call. Returning NULL makes the lookup fail.
+ */
+typedef void *(*mesa_cache_db_read_cb)(const void *data, size_t size,
+                                       void *user_data);
+
 #if DETECT_OS_WINDOWS == 0
 bool
 mesa_cache_db_open(struct mesa_cache_db *db, const char *cache_path);
@@ -58,11 +71,23 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
                          const uint8_t *cache_key_160bit,
                          size_t *size);
 
+void *
+mesa_cache_db_read_entry_mapped(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                mesa_cache_db_read_cb read_cb,
+                                void *user_data);
+
 bool
 mesa_cache_db_entry_write(struct mesa_cache_db *db,
                           const uint8_t *cache_key_160bit,
                           const void *blob, size_t blob_size);
 
+bool
+mesa_cache_db_entry_try_write(struct mesa_cache_db *db,
+                              const uint8_t *cache_key_160bit,
+                              const void *blob, size_t blob_size,
+                              bool *busy);
+
 bool
 mesa_cache_db_entry_remove(struct mesa_cache_db *db,
                            const uint8_t *cache_key_160bit);
@@ -107,6 +132,15 @@ mesa_cache_db_read_entry(struct mesa_cache_db *db,
    return NULL;
 }
 
+static inline void *
+mesa_cache_db_read_entry_mapped(struct mesa_cache_db *db,
+                                const uint8_t *cache_key_160bit,
+                                mesa_cache_db_read_cb read_cb,
+                                void *user_data)
+{
+   return NULL;
+}
+
 static inline bool
 mesa_cache_db_entry_write(struct mesa_cache_db *db,
                           const uint8_t *cache_key_160bit,
@@ -115,6 +149,16 @@ mesa_cache_db_entry_write(struct mesa_cache_db *db,
    return false;
 }
 
+static inline bool
+mesa_cache_db_entry_try_write(struct mesa_cache_db *db,
+                              const uint8_t *cache_key_160bit,
+                              const void *blob, size_t blob_size,
+                              bool *busy)
+{
+   *busy = false;
+   return false;
+}
+
 static inline bool
 mesa_cache_db_entry_remove(struct mesa_cache_db *db,
                            const uint8_t *cache_key_160bit)
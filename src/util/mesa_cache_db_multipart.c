@@ -5,6 +5,7 @@
  */
 
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "detect_os.h"
 #include "string.h"
@@ -49,6 +50,11 @@ mesa_cache_db_multipart_open(struct mesa_cache_db_multipart *db,
    /* remove old pre multi-part cache */
    mesa_db_wipe_path(cache_path);
 
+   /* Processes sharing the cache start writing at different parts, so that
+    * they don't all queue up on the file lock of the first part.
+    */
+   db->last_written_part = getpid() % db->num_parts;
+
    return true;
 
 free_path:
@@ -103,6 +109,29 @@ mesa_cache_db_multipart_read_entry(struct mesa_cache_db_multipart *db,
    return NULL;
 }
 
+void *
+mesa_cache_db_multipart_read_entry_mapped(struct mesa_cache_db_multipart *db,
+                                          const uint8_t *cache_key_160bit,
+                                          mesa_cache_db_read_cb read_cb,
+                                          void *user_data)
+{
+   unsigned last_read_part = db->last_read_part;
+
+   for (unsigned int i = 0; i < db->num_parts; i++) {
+      unsigned int part = (last_read_part + i) % db->num_parts;
+
+      void *result = mesa_cache_db_read_entry_mapped(&db->parts[part],
+                                                     cache_key_160bit,
+                                                     read_cb, user_data);
+      if (result) {
+         db->last_read_part = part;
+         return result;
+      }
+   }
+
+   return NULL;
+}
+
 static unsigned
 mesa_cache_db_multipart_select_victim_part(struct mesa_cache_db_multipart *db)
 {
@@ -130,17 +159,33 @@ mesa_cache_db_multipart_entry_write(struct mesa_cache_db_multipart *db,
 
    for (unsigned int i = 0; i < db->num_parts; i++) {
       unsigned int part = (last_written_part + i) % db->num_parts;
+      bool busy;
 
-      /* Note that each DB part has own locking. */
-      if (mesa_cache_db_has_space(&db->parts[part], blob_size)) {
-         wpart = part;
-         break;
+      if (!mesa_cache_db_has_space(&db->parts[part], blob_size))
+         continue;
+
+      /* Note that each DB part has own locking. If another process is
+       * writing to this part, move on to the next part that has space
+       * instead of waiting for it.
+       */
+      if (mesa_cache_db_entry_try_write(&db->parts[part], cache_key_160bit,
+                                        blob, blob_size, &busy)) {
+         db->last_written_part = part;
+         return true;
       }
+
+      if (!busy)
+         return false;
+
+      if (wpart < 0)
+         wpart = part;
    }
 
    /* All DB parts are full. Writing to a full DB part will auto-trigger
     * eviction of LRU cache entries from the part. Select DB part that
     * contains majority of LRU cache entries.
+    *
+    * Otherwise all the parts with space were busy, wait for the first one.
     */
    if (wpart < 0)
       wpart = mesa_cache_db_multipart_select_victim_part(db);
@@ -32,6 +32,12 @@ mesa_cache_db_multipart_read_entry(struct mesa_cache_db_multipart *db,
                                    const uint8_t *cache_key_160bit,
                                    size_t *size);
 
+void *
+mesa_cache_db_multipart_read_entry_mapped(struct mesa_cache_db_multipart *db,
+                                          const uint8_t *cache_key_160bit,
+                                          mesa_cache_db_read_cb read_cb,
+                                          void *user_data);
+
 bool
 mesa_cache_db_multipart_entry_write(struct mesa_cache_db_multipart *db,
                                     const uint8_t *cache_key_160bit,
@@ -37,10 +37,14 @@
 #define TIMESTAMP_BUF_SIZE 0x1000
 #define TRACES_PER_CHUNK (TIMESTAMP_BUF_SIZE / sizeof(uint64_t))
 
+/* Maximum number of processed chunks kept for reuse per context. */
+#define CHUNK_POOL_MAX_SIZE 64
+
 struct u_trace_state {
    util_once_flag once;
    FILE *trace_file;
    enum u_trace_type enabled_traces;
+   uint32_t sample_rate;
 };
 static struct u_trace_state u_trace_state = { .once = UTIL_ONCE_FLAG_INIT };
 
@@ -102,6 +106,7 @@ struct u_trace_chunk {
 
    bool last; /* this chunk is last in batch */
    bool eof;  /* this chunk is last in frame */
+   bool skip; /* frame is not sampled, don't output the traces */
 
    void *flush_data; /* assigned by u_trace_flush */
 
@@ -305,6 +310,64 @@ free_chunks(struct list_head *chunks)
    }
 }
 
+/* Return a processed chunk to the context's pool, or free it if the pool
+ * is full.  Called from the queue thread once the timestamps were read.
+ */
+static void
+recycle_chunk(struct u_trace_chunk *chunk)
+{
+   struct u_trace_context *utctx = chunk->utctx;
+
+   struct u_trace_payload_buf **payload;
+   u_vector_foreach (payload, &chunk->payloads)
+      u_trace_payload_buf_unref(*payload);
+   chunk->payloads.head = chunk->payloads.tail = 0;
+   chunk->payload = NULL;
+
+   chunk->num_traces = 0;
+   chunk->eof = false;
+   chunk->skip = false;
+   chunk->flush_data = NULL;
+   chunk->free_flush_data = false;
+
+   simple_mtx_lock(&utctx->chunk_pool_mutex);
+   const bool keep = utctx->chunk_pool_size < CHUNK_POOL_MAX_SIZE;
+   if (keep) {
+      list_add(&chunk->node, &utctx->chunk_pool);
+      utctx->chunk_pool_size++;
+   }
+   simple_mtx_unlock(&utctx->chunk_pool_mutex);
+
+   if (!keep)
+      free_chunk(chunk);
+}
+
+static struct u_trace_chunk *
+alloc_chunk(struct u_trace_context *utctx)
+{
+   struct u_trace_chunk *chunk = NULL;
+
+   simple_mtx_lock(&utctx->chunk_pool_mutex);
+   if (!list_is_empty(&utctx->chunk_pool)) {
+      chunk = list_first_entry(&utctx->chunk_pool, struct u_trace_chunk, node);
+      list_del(&chunk->node);
+      utctx->chunk_pool_size--;
+   }
+   simple_mtx_unlock(&utctx->chunk_pool_mutex);
+
+   if (chunk)
+      return chunk;
+
+   chunk = calloc(1, sizeof(*chunk));
+
+   chunk->utctx = utctx;
+   chunk->timestamps =
+      utctx->create_timestamp_buffer(utctx, TIMESTAMP_BUF_SIZE);
+   u_vector_init(&chunk->payloads, 4, sizeof(struct u_trace_payload_buf *));
+
+   return chunk;
+}
+
 static struct u_trace_chunk *
 get_chunk(struct u_trace *ut, size_t payload_size)
 {
@@ -341,14 +404,9 @@ get_chunk(struct u_trace *ut, size_t payload_size)
       chunk->last = false;
    }
 
-   /* .. if not, then create a new one: */
-   chunk = calloc(1, sizeof(*chunk));
-
-   chunk->utctx = ut->utctx;
-   chunk->timestamps =
-      ut->utctx->create_timestamp_buffer(ut->utctx, TIMESTAMP_BUF_SIZE);
+   /* .. if not, then get a new one: */
+   chunk = alloc_chunk(ut->utctx);
    chunk->last = true;
-   u_vector_init(&chunk->payloads, 4, sizeof(struct u_trace_payload_buf *));
    if (payload_size > 0) {
       struct u_trace_payload_buf **buf = u_vector_add(&chunk->payloads);
       *buf = u_trace_payload_buf_create();
@@ -371,6 +429,7 @@ static const struct debug_named_value config_control[] = {
 };
 
 DEBUG_GET_ONCE_OPTION(trace_file, "MESA_GPU_TRACEFILE", NULL)
+DEBUG_GET_ONCE_NUM_OPTION(sample_rate, "MESA_GPU_TRACES_SAMPLE_RATE", 1)
 
 static void
 trace_file_fini(void)
@@ -384,6 +443,7 @@ u_trace_state_init_once(void)
 {
    u_trace_state.enabled_traces =
       debug_get_flags_option("MESA_GPU_TRACES", config_control, 0);
+   u_trace_state.sample_rate = MAX2(debug_get_option_sample_rate(), 1);
    const char *tracefile_name = debug_get_option_trace_file();
    if (tracefile_name && __normal_user()) {
       u_trace_state.trace_file = fopen(tracefile_name, "w");
@@ -458,6 +518,13 @@ u_trace_context_init(struct u_trace_context *utctx,
 
    list_inithead(&utctx->flushed_trace_chunks);
 
+   simple_mtx_init(&utctx->chunk_pool_mutex, mtx_plain);
+   list_inithead(&utctx->chunk_pool);
+   utctx->chunk_pool_size = 0;
+
+   utctx->sample_rate = u_trace_state.sample_rate;
+   utctx->submit_frame_nr = 0;
+
    if (utctx->enabled_traces & U_TRACE_TYPE_PRINT) {
       utctx->out = u_trace_state.trace_file;
 
@@ -507,11 +574,14 @@ u_trace_context_fini(struct u_trace_context *utctx)
       fflush(utctx->out);
    }
 
-   if (!utctx->queue.jobs)
-      return;
-   util_queue_finish(&utctx->queue);
-   util_queue_destroy(&utctx->queue);
-   free_chunks(&utctx->flushed_trace_chunks);
+   if (utctx->queue.jobs) {
+      util_queue_finish(&utctx->queue);
+      util_queue_destroy(&utctx->queue);
+      free_chunks(&utctx->flushed_trace_chunks);
+   }
+
+   free_chunks(&utctx->chunk_pool);
+   simple_mtx_destroy(&utctx->chunk_pool_mutex);
 }
 
 #ifdef HAVE_PERFETTO
@@ -555,6 +625,15 @@ process_chunk(void *job, void *gdata, int thread_index)
    struct u_trace_chunk *chunk = job;
    struct u_trace_context *utctx = chunk->utctx;
 
+   if (chunk->skip) {
+      /* The timestamp buffer is going to be reused, make sure the GPU is
+       * done writing it.
+       */
+      if (chunk->num_traces)
+         utctx->read_timestamp(utctx, chunk->timestamps, 0, chunk->flush_data);
+      goto out;
+   }
+
    if (utctx->start_of_frame) {
       utctx->start_of_frame = false;
       utctx->batch_nr = 0;
@@ -571,6 +650,11 @@ process_chunk(void *job, void *gdata, int thread_index)
       }
    }
 
+#ifdef HAVE_PERFETTO
+   /* Sampled once per chunk rather than per event: */
+   const bool perfetto_active = u_trace_perfetto_active(utctx);
+#endif
+
    for (unsigned idx = 0; idx < chunk->num_traces; idx++) {
       const struct u_trace_event *evt = &chunk->traces[idx];
 
@@ -599,9 +683,7 @@ process_chunk(void *job, void *gdata, int thread_index)
          utctx->out_printer->event(utctx, chunk, evt, ns, delta);
       }
 #ifdef HAVE_PERFETTO
-      if (evt->tp->perfetto &&
-          (p_atomic_read_relaxed(&utctx->enabled_traces) &
-           U_TRACE_TYPE_PERFETTO_ACTIVE)) {
+      if (perfetto_active && evt->tp->perfetto) {
          evt->tp->perfetto(utctx->pctx, ns, evt->tp->tp_idx, chunk->flush_data, evt->payload);
       }
 #endif
@@ -623,6 +705,10 @@ process_chunk(void *job, void *gdata, int thread_index)
       if (utctx->out) {
          utctx->out_printer->end_of_frame(utctx);
       }
+   }
+
+out:
+   if (chunk->eof) {
       utctx->frame_nr++;
       utctx->start_of_frame = true;
    }
@@ -635,7 +721,7 @@ process_chunk(void *job, void *gdata, int thread_index)
 static void
 cleanup_chunk(void *job, void *gdata, int thread_index)
 {
-   free_chunk(job);
+   recycle_chunk(job);
 }
 
 void
@@ -650,10 +736,16 @@ u_trace_context_process(struct u_trace_context *utctx, bool eof)
       list_last_entry(chunks, struct u_trace_chunk, node);
    last_chunk->eof = eof;
 
+   const bool skip = utctx->submit_frame_nr % utctx->sample_rate != 0;
+   if (eof)
+      utctx->submit_frame_nr++;
+
    while (!list_is_empty(chunks)) {
       struct u_trace_chunk *chunk =
          list_first_entry(chunks, struct u_trace_chunk, node);
 
+      chunk->skip = skip;
+
       /* remove from list before enqueuing, because chunk is freed
        * once it is processed by the queue:
        */
@@ -201,6 +201,21 @@ struct u_trace_context {
 
    /* list of unprocessed trace chunks in fifo order: */
    struct list_head flushed_trace_chunks;
+
+   /* Processed trace chunks, kept around along with their timestamp
+    * buffer to be reused by the next u_trace instead of reallocating
+    * them for every batch.  Filled from the queue thread, hence the lock.
+    */
+   simple_mtx_t chunk_pool_mutex;
+   struct list_head chunk_pool;
+   uint32_t chunk_pool_size;
+
+   /* Only every sample_rate'th frame is processed, see
+    * MESA_GPU_TRACES_SAMPLE_RATE.  submit_frame_nr counts the frames
+    * passed to u_trace_context_process().
+    */
+   uint32_t sample_rate;
+   uint32_t submit_frame_nr;
 };
 
 /**
@@ -970,13 +970,15 @@ gc_sweep_end(gc_ctx *ctx)
  *
  * The allocator uses a fixed-sized buffer with a monotonically increasing
  * offset after each allocation. If the buffer is all used, another buffer
- * is allocated, using the linear parent node as ralloc parent.
+ * is allocated, using the linear parent node as ralloc parent. Each new
+ * buffer is twice as big as the previous one, up to LINEAR_MAX_BUFFER_SIZE.
  *
  * The linear parent node is always the first buffer and keeps track of all
  * other buffers.
  */
 
 #define SUBALLOC_ALIGNMENT 8
+#define LINEAR_MAX_BUFFER_SIZE (64 * 1024)
 #define LMAGIC_CONTEXT 0x87b9c7d3
 #define LMAGIC_NODE    0x87b910d3
 
@@ -988,6 +990,7 @@ struct linear_ctx {
    unsigned magic;   /* for debugging */
 #endif
    unsigned min_buffer_size;
+   unsigned buffer_size; /* size of the next buffer */
 
    unsigned offset;  /* points to the first unused byte in the latest buffer */
    unsigned size;    /* size of the latest buffer */
@@ -1034,8 +1037,8 @@ linear_alloc_child(linear_ctx *ctx, unsigned size)
    if (unlikely(ctx->offset + size > ctx->size)) {
       /* allocate a new node */
       unsigned node_size = size;
-      if (likely(node_size < ctx->min_buffer_size))
-         node_size = ctx->min_buffer_size;
+      if (likely(node_size < ctx->buffer_size))
+         node_size = ctx->buffer_size;
 
       const unsigned canary_size = get_node_canary_size();
       const unsigned full_size = canary_size + node_size;
@@ -1067,6 +1070,12 @@ linear_alloc_child(linear_ctx *ctx, unsigned size)
       ctx->offset = 0;
       ctx->size = node_size;
       ctx->latest = ptr + canary_size;
+
+      /* Grow the buffers of big contexts, so that the number of buffers,
+       * and the cost of freeing them, doesn't grow linearly with the size.
+       */
+      ctx->buffer_size = MIN2(ctx->buffer_size * 2,
+                              MAX2(LINEAR_MAX_BUFFER_SIZE, ctx->min_buffer_size));
    }
 
    void *ptr = (char *)ctx->latest + ctx->offset;
@@ -1111,6 +1120,7 @@ linear_context_with_opts(void *ralloc_ctx, const linear_opts *opts)
       return NULL;
 
    ctx->min_buffer_size = min_buffer_size;
+   ctx->buffer_size = min_buffer_size;
 
    ctx->offset = 0;
    ctx->size = size;
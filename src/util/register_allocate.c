@@ -703,6 +703,19 @@ add_node_to_stack(struct ra_graph *g, unsigned int n)
    g->tmp.min_q_total[n / BITSET_WORDBITS] = UINT_MAX;
 }
 
+/* Returns the highest set bit of word that is not above bit, or -1.  This
+ * lets the loops below skip over runs of nodes that are of no interest
+ * while still visiting the others from the highest index down.
+ */
+static inline int
+ra_prev_set_bit(BITSET_WORD word, int bit)
+{
+   if (bit < 0)
+      return -1;
+
+   return util_last_bit(word & (~(BITSET_WORD)0 >> (BITSET_WORDBITS - 1 - bit))) - 1;
+}
+
 /**
  * Simplifies the interference graph by pushing all
  * trivially-colorable nodes into a stack of nodes to be colored,
@@ -765,17 +778,16 @@ ra_simplify(struct ra_graph *g)
              * know we're going to loop again before attempting to do anything
              * optimistic.
              */
-            for (int j = high_bit; j >= 0; j--) {
-               if (pq & BITSET_BIT(j)) {
-                  unsigned int n = i * BITSET_WORDBITS + j;
-                  assert(n < g->count);
-                  add_node_to_stack(g, n);
-                  /* add_node_to_stack() may update pq_test for this word so
-                   * we need to update our local copy.
-                   */
-                  pq = g->tmp.pq_test[i] & ~skip;
-                  progress = true;
-               }
+            for (int j = ra_prev_set_bit(pq, high_bit); j >= 0;
+                 j = ra_prev_set_bit(pq, j - 1)) {
+               unsigned int n = i * BITSET_WORDBITS + j;
+               assert(n < g->count);
+               add_node_to_stack(g, n);
+               /* add_node_to_stack() may update pq_test for this word so
+                * we need to update our local copy.
+                */
+               pq = g->tmp.pq_test[i] & ~skip;
+               progress = true;
             }
          } else if (!progress) {
             if (g->tmp.min_q_total[i] == UINT_MAX) {
@@ -783,10 +795,9 @@ ra_simplify(struct ra_graph *g)
                 * one of these nodes to the stack.  It needs to be
                 * recalculated.
                 */
-               for (int j = high_bit; j >= 0; j--) {
-                  if (skip & BITSET_BIT(j))
-                     continue;
-
+               const BITSET_WORD todo = ~skip;
+               for (int j = ra_prev_set_bit(todo, high_bit); j >= 0;
+                    j = ra_prev_set_bit(todo, j - 1)) {
                   unsigned int n = i * BITSET_WORDBITS + j;
                   assert(n < g->count);
                   if (g->nodes[n].tmp.q_total < g->tmp.min_q_total[i]) {
@@ -37,6 +37,7 @@
 #include <string.h>
 
 #include "hash_table.h"
+#include "hash_table_group.h"
 #include "macros.h"
 #include "ralloc.h"
 #include "set.h"
@@ -133,6 +134,7 @@ _mesa_set_init(struct set *ht, void *mem_ctx,
    ht->table = rzalloc_array(mem_ctx, struct set_entry, ht->size);
    ht->entries = 0;
    ht->deleted_entries = 0;
+   ht->ctrl = NULL;
 
    return ht->table != NULL;
 }
@@ -196,6 +198,16 @@ _mesa_set_clone(struct set *set, void *dst_mem_ctx)
 
    memcpy(clone->table, set->table, clone->size * sizeof(struct set_entry));
 
+   if (set->ctrl) {
+      clone->ctrl = ralloc_array(clone->table, uint8_t,
+                                 group_ctrl_size(clone->size));
+      if (clone->ctrl == NULL) {
+         ralloc_free(clone);
+         return NULL;
+      }
+      memcpy(clone->ctrl, set->ctrl, group_ctrl_size(clone->size));
+   }
+
    return clone;
 }
 
@@ -225,6 +237,8 @@ static void
 set_clear_fast(struct set *ht)
 {
    memset(ht->table, 0, sizeof(struct set_entry) * hash_sizes[ht->size_index].size);
+   if (ht->ctrl)
+      memset(ht->ctrl, CTRL_EMPTY, group_ctrl_size(ht->size));
    ht->entries = ht->deleted_entries = 0;
 }
 
@@ -249,12 +263,64 @@ _mesa_set_clear(struct set *set, void (*delete_function)(struct set_entry *entry
 
          entry->key = NULL;
       }
+      if (set->ctrl)
+         memset(set->ctrl, CTRL_EMPTY, group_ctrl_size(set->size));
       set->entries = 0;
       set->deleted_entries = 0;
    } else
       set_clear_fast(set);
 }
 
+/**
+ * Switches the set to probing through groups of control bytes.
+ *
+ * See _mesa_hash_table_enable_group_probing(). This must be called before
+ * any entries are added to the set.
+ */
+bool
+_mesa_set_enable_group_probing(struct set *set)
+{
+   assert(set->entries == 0 && set->deleted_entries == 0);
+
+   if (set->ctrl)
+      return true;
+
+   set->ctrl = ralloc_array(set->table, uint8_t, group_ctrl_size(set->size));
+   if (set->ctrl == NULL)
+      return false;
+
+   memset(set->ctrl, CTRL_EMPTY, group_ctrl_size(set->size));
+   return true;
+}
+
+static struct set_entry *
+set_search_group(const struct set *ht, uint32_t hash, const void *key)
+{
+   uint32_t size = ht->size;
+   uint32_t start_address = util_fast_urem32(hash, size, ht->size_magic);
+   uint8_t tag = group_tag(hash);
+
+   group_foreach_probe(hash_address, start_address, size) {
+      const uint8_t *ctrl = ht->ctrl + hash_address;
+      group_mask match = group_match(ctrl, tag);
+
+      while (match) {
+         uint32_t index = group_wrap_index(hash_address +
+                                           group_mask_next(&match), size);
+         struct set_entry *entry = ht->table + index;
+
+         if (entry->hash == hash && entry_is_present(entry) &&
+             ht->key_equals_function(key, entry->key))
+            return entry;
+      }
+
+      if (group_match_empty(ctrl))
+         return NULL;
+   }
+
+   return NULL;
+}
+
 /**
  * Finds a set entry with the given key and hash of that key.
  *
@@ -265,6 +331,9 @@ set_search(const struct set *ht, uint32_t hash, const void *key)
 {
    assert(!key_pointer_is_reserved(key));
 
+   if (ht->ctrl)
+      return set_search_group(ht, hash, key);
+
    uint32_t size = ht->size;
    uint32_t start_address = util_fast_urem32(hash, size, ht->size_magic);
    uint32_t double_hash = util_fast_urem32(hash, ht->rehash,
@@ -305,9 +374,36 @@ _mesa_set_search_pre_hashed(const struct set *set, uint32_t hash,
    return set_search(set, hash, key);
 }
 
+static void
+set_add_rehash_group(struct set *ht, uint32_t hash, const void *key)
+{
+   uint32_t size = ht->size;
+   uint32_t start_address = util_fast_urem32(hash, size, ht->size_magic);
+
+   group_foreach_probe(hash_address, start_address, size) {
+      group_mask empty = group_match_empty(ht->ctrl + hash_address);
+
+      if (likely(empty)) {
+         uint32_t index = group_wrap_index(hash_address +
+                                           group_mask_next(&empty), size);
+         struct set_entry *entry = ht->table + index;
+
+         entry->hash = hash;
+         entry->key = key;
+         group_set_ctrl(ht->ctrl, size, index, group_tag(hash));
+         return;
+      }
+   }
+}
+
 static void
 set_add_rehash(struct set *ht, uint32_t hash, const void *key)
 {
+   if (ht->ctrl) {
+      set_add_rehash_group(ht, hash, key);
+      return;
+   }
+
    uint32_t size = ht->size;
    uint32_t start_address = util_fast_urem32(hash, size, ht->size_magic);
    uint32_t double_hash = util_fast_urem32(hash, ht->rehash,
@@ -347,9 +443,22 @@ set_rehash(struct set *ht, unsigned new_size_index)
    if (table == NULL)
       return;
 
+   uint8_t *ctrl = NULL;
+   if (ht->ctrl) {
+      uint32_t ctrl_size = group_ctrl_size(hash_sizes[new_size_index].size);
+
+      ctrl = ralloc_array(table, uint8_t, ctrl_size);
+      if (ctrl == NULL) {
+         ralloc_free(table);
+         return;
+      }
+      memset(ctrl, CTRL_EMPTY, ctrl_size);
+   }
+
    old_ht = *ht;
 
    ht->table = table;
+   ht->ctrl = ctrl;
    ht->size_index = new_size_index;
    ht->size = hash_sizes[ht->size_index].size;
    ht->rehash = hash_sizes[ht->size_index].rehash;
@@ -389,6 +498,63 @@ _mesa_set_resize(struct set *set, uint32_t entries)
  * Note that insertion may rearrange the table on a resize or rehash,
  * so previously found hash_entries are no longer valid after this function.
  */
+static struct set_entry *
+set_search_or_add_group(struct set *ht, uint32_t hash, const void *key,
+                        bool *found)
+{
+   struct set_entry *available_entry = NULL;
+   uint32_t size = ht->size;
+   uint32_t start_address = util_fast_urem32(hash, size, ht->size_magic);
+   uint8_t tag = group_tag(hash);
+
+   group_foreach_probe(hash_address, start_address, size) {
+      const uint8_t *ctrl = ht->ctrl + hash_address;
+      group_mask match = group_match(ctrl, tag);
+
+      while (match) {
+         uint32_t index = group_wrap_index(hash_address +
+                                           group_mask_next(&match), size);
+         struct set_entry *entry = ht->table + index;
+
+         if (entry->hash == hash && entry_is_present(entry) &&
+             ht->key_equals_function(key, entry->key)) {
+            if (found)
+               *found = true;
+            return entry;
+         }
+      }
+
+      /* Stash the first available entry we find */
+      if (available_entry == NULL) {
+         group_mask available = group_match_empty_or_deleted(ctrl);
+         if (available) {
+            uint32_t index = group_wrap_index(hash_address +
+                                              group_mask_next(&available),
+                                              size);
+            available_entry = ht->table + index;
+         }
+      }
+
+      if (group_match_empty(ctrl))
+         break;
+   }
+
+   if (available_entry) {
+      /* There is no matching entry, create it. */
+      if (entry_is_deleted(available_entry))
+         ht->deleted_entries--;
+      available_entry->hash = hash;
+      available_entry->key = key;
+      group_set_ctrl(ht->ctrl, size, available_entry - ht->table, tag);
+      ht->entries++;
+      if (found)
+         *found = false;
+      return available_entry;
+   }
+
+   return NULL;
+}
+
 static struct set_entry *
 set_search_or_add(struct set *ht, uint32_t hash, const void *key, bool *found)
 {
@@ -402,6 +568,20 @@ set_search_or_add(struct set *ht, uint32_t hash, const void *key, bool *found)
       set_rehash(ht, ht->size_index);
    }
 
+   if (ht->ctrl) {
+      struct set_entry *entry = set_search_or_add_group(ht, hash, key, found);
+
+      /* Entries cleared behind our back by an interrupted
+       * set_foreach_remove() still look used in the control bytes.
+       * Rebuilding them from the entries fixes that.
+       */
+      if (unlikely(!entry)) {
+         set_rehash(ht, ht->size_index);
+         entry = set_search_or_add_group(ht, hash, key, found);
+      }
+      return entry;
+   }
+
    uint32_t size = ht->size;
    uint32_t start_address = util_fast_urem32(hash, size, ht->size_magic);
    uint32_t double_hash = util_fast_urem32(hash, ht->rehash,
@@ -547,6 +727,8 @@ _mesa_set_remove(struct set *ht, struct set_entry *entry)
       return;
 
    entry->key = deleted_key;
+   if (ht->ctrl)
+      group_set_ctrl(ht->ctrl, ht->size, entry - ht->table, CTRL_DELETED);
    ht->entries--;
    ht->deleted_entries++;
 }
@@ -569,8 +751,12 @@ struct set_entry *
 _mesa_set_next_entry_unsafe(const struct set *ht, struct set_entry *entry)
 {
    assert(!ht->deleted_entries);
-   if (!ht->entries)
+   if (!ht->entries) {
+      /* set_foreach_remove() has emptied the set. */
+      if (ht->ctrl)
+         memset(ht->ctrl, CTRL_EMPTY, group_ctrl_size(ht->size));
       return NULL;
+   }
    if (entry == NULL)
       entry = ht->table;
    else
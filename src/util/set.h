@@ -53,6 +53,8 @@ struct set {
    uint32_t size_index;
    uint32_t entries;
    uint32_t deleted_entries;
+   /* Control bytes for group probing, NULL unless enabled. */
+   uint8_t *ctrl;
 };
 
 bool
@@ -80,6 +82,8 @@ _mesa_set_resize(struct set *set, uint32_t entries);
 void
 _mesa_set_clear(struct set *set,
                 void (*delete_function)(struct set_entry *entry));
+bool
+_mesa_set_enable_group_probing(struct set *set);
 
 struct set_entry *
 _mesa_set_add(struct set *set, const void *key);
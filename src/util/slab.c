@@ -28,6 +28,11 @@
 #include <stdbool.h>
 #include <string.h>
 
+/* Number of elements of another pool that are collected by slab_free before
+ * they are handed back to their owner.
+ */
+#define SLAB_RETURN_BATCH 32
+
 #define SLAB_MAGIC_ALLOCATED 0xcafe4321
 #define SLAB_MAGIC_FREE 0x7ee01234
 
@@ -95,6 +100,32 @@ slab_free_orphaned(struct slab_element_header *elt)
       free(page);
 }
 
+/* Hand the elements collected by slab_free back to their owners. Must be
+ * called with the parent mutex held.
+ */
+static void
+slab_return_elements_locked(struct slab_child_pool *pool)
+{
+   while (pool->returned) {
+      struct slab_element_header *elt = pool->returned;
+      pool->returned = elt->next;
+
+      /* The owner may have been destroyed since the element was freed. */
+      intptr_t owner_int = p_atomic_read(&elt->owner);
+
+      if (!(owner_int & 1)) {
+         struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
+         elt->next = owner->migrated;
+         owner->migrated = elt;
+      } else {
+         slab_free_orphaned(elt);
+      }
+   }
+
+   pool->num_returned = 0;
+   pool->num_return_flushes++;
+}
+
 /**
  * Create a parent pool for the allocation of same-sized objects.
  *
@@ -129,6 +160,10 @@ void slab_create_child(struct slab_child_pool *pool,
    pool->pages = NULL;
    pool->free = NULL;
    pool->migrated = NULL;
+   pool->returned = NULL;
+   pool->num_returned = 0;
+   pool->num_foreign_frees = 0;
+   pool->num_return_flushes = 0;
 }
 
 /**
@@ -144,6 +179,9 @@ void slab_destroy_child(struct slab_child_pool *pool)
 
    simple_mtx_lock(&pool->parent->mutex);
 
+   if (pool->returned)
+      slab_return_elements_locked(pool);
+
    while (pool->pages) {
       struct slab_page_header *page = pool->pages;
       pool->pages = page->u.next;
@@ -215,6 +253,8 @@ slab_alloc(struct slab_child_pool *pool)
       simple_mtx_lock(&pool->parent->mutex);
       pool->free = pool->migrated;
       pool->migrated = NULL;
+      if (pool->returned)
+         slab_return_elements_locked(pool);
       simple_mtx_unlock(&pool->parent->mutex);
 
       /* Now allocate a new page. */
@@ -269,6 +309,25 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
       return;
    }
 
+   /* Elements of another live pool are collected and handed back in
+    * batches. Whether the owner is still alive is checked again under the
+    * mutex when they are handed back.
+    */
+   owner_int = p_atomic_read(&elt->owner);
+
+   if (pool->parent && !(owner_int & 1)) {
+      elt->next = pool->returned;
+      pool->returned = elt;
+      pool->num_foreign_frees++;
+
+      if (++pool->num_returned >= SLAB_RETURN_BATCH) {
+         simple_mtx_lock(&pool->parent->mutex);
+         slab_return_elements_locked(pool);
+         simple_mtx_unlock(&pool->parent->mutex);
+      }
+      return;
+   }
+
    /* The slow case: migration or an orphaned page. */
    if (pool->parent)
       simple_mtx_lock(&pool->parent->mutex);
@@ -72,6 +72,19 @@ struct slab_child_pool {
     * This list is protected by the parent mutex.
     */
    struct slab_element_header *migrated;
+
+   /* Elements owned by a different pool that were freed with this pool as
+    * the argument to slab_free. They are handed back to their owners in
+    * batches, so that the parent mutex isn't taken for every one of them.
+    */
+   struct slab_element_header *returned;
+   unsigned num_returned;
+
+   /* Statistics: the number of elements of other pools freed in this pool,
+    * and how many times they were handed back (i.e. the mutex was taken).
+    */
+   unsigned num_foreign_frees;
+   unsigned num_return_flushes;
 };
 
 void slab_create_parent(struct slab_parent_pool *parent,
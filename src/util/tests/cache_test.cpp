@@ -1342,3 +1342,106 @@ TEST_F(Cache, Disabled)
    EXPECT_EQ(err, 0) << "Removing " CACHE_TEST_TMP " again";
 #endif
 }
+
+#if defined(ENABLE_SHADER_CACHE) && defined(HAVE_ZSTD)
+static void
+fill_similar_item(uint8_t *item, size_t size, unsigned index)
+{
+   /* Items share most of their content, like binaries of similar shaders
+    * compiled by the same compiler.
+    */
+   uint32_t seed = 0x1234567;
+   for (size_t i = 0; i < size; i++) {
+      seed = seed * 1103515245 + 12345;
+      item[i] = seed >> 24;
+   }
+
+   for (size_t i = 0; i + sizeof(index) <= size; i += 61)
+      memcpy(&item[i], &index, sizeof(index));
+}
+
+static void
+test_compression_dict(const char *driver_id)
+{
+   const unsigned num_items = 1100;
+   const size_t item_size = 4096;
+   uint8_t item[item_size];
+   cache_key *keys = (cache_key *) calloc(num_items, sizeof(cache_key));
+   struct disk_cache *cache;
+   char *result;
+   size_t size;
+
+   setenv("MESA_SHADER_CACHE_MAX_SIZE", "64M", 1);
+   setenv("MESA_SHADER_CACHE_COMPRESSION_DICT", "true", 1);
+
+   cache = disk_cache_create("test_compression_dict", driver_id, 0);
+   EXPECT_EQ(cache->compress_dict.dict, nullptr)
+      << "no dictionary before training";
+
+   /* The dictionary is trained after 4MiB of items */
+   for (unsigned i = 0; i < num_items; i++) {
+      fill_similar_item(item, item_size, i);
+      disk_cache_compute_key(cache, item, item_size, keys[i]);
+      disk_cache_put(cache, keys[i], item, item_size, NULL);
+   }
+   disk_cache_wait_for_idle(cache);
+
+   EXPECT_NE(cache->compress_dict.dict, nullptr)
+      << "dictionary trained from the items";
+
+   for (unsigned i = 0; i < num_items; i++) {
+      fill_similar_item(item, item_size, i);
+      result = (char *) disk_cache_get(cache, keys[i], &size);
+      ASSERT_NE(result, nullptr) << "disk_cache_get of existing item";
+      EXPECT_EQ(size, item_size);
+      EXPECT_EQ(memcmp(result, item, item_size), 0);
+      free(result);
+   }
+
+   disk_cache_destroy(cache);
+
+   /* A new instance loads the stored dictionary and reads the items
+    * compressed with it.
+    */
+   cache = disk_cache_create("test_compression_dict", driver_id, 0);
+   EXPECT_NE(cache->compress_dict.dict, nullptr)
+      << "dictionary loaded from the cache directory";
+
+   for (unsigned i = 0; i < num_items; i++) {
+      fill_similar_item(item, item_size, i);
+      result = (char *) disk_cache_get(cache, keys[i], &size);
+      ASSERT_NE(result, nullptr) << "disk_cache_get of existing item";
+      EXPECT_EQ(size, item_size);
+      EXPECT_EQ(memcmp(result, item, item_size), 0);
+      free(result);
+   }
+
+   disk_cache_destroy(cache);
+
+   unsetenv("MESA_SHADER_CACHE_COMPRESSION_DICT");
+   unsetenv("MESA_SHADER_CACHE_MAX_SIZE");
+   free(keys);
+}
+#endif
+
+TEST_F(Cache, CompressionDict)
+{
+#ifndef ENABLE_SHADER_CACHE
+   GTEST_SKIP() << "ENABLE_SHADER_CACHE not defined.";
+#elif !defined(HAVE_ZSTD)
+   GTEST_SKIP() << "HAVE_ZSTD not defined.";
+#else
+   const char *driver_id = "make_check";
+
+#ifdef SHADER_CACHE_DISABLE_BY_DEFAULT
+   setenv("MESA_SHADER_CACHE_DISABLE", "false", 1);
+#endif /* SHADER_CACHE_DISABLE_BY_DEFAULT */
+
+   test_disk_cache_create(mem_ctx, CACHE_DIR_NAME, driver_id);
+
+   test_compression_dict(driver_id);
+
+   int err = rmrf_local(CACHE_TEST_TMP);
+   EXPECT_EQ(err, 0) << "Removing " CACHE_TEST_TMP " again";
+#endif
+}
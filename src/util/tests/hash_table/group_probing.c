@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2024 Advanced Micro Devices, Inc.
+ * SPDX-License-Identifier: MIT
+ */
+
+#undef NDEBUG
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "util/hash_table.h"
+
+#define SIZE 10000
+
+static uint32_t
+key_value(const void *key)
+{
+   return *(const uint32_t *)key;
+}
+
+/* Every key shares one of a handful of hashes, so groups fill up with
+ * matching tags and probing has to walk over many of them.
+ */
+static uint32_t
+colliding_hash(const void *key)
+{
+   return key_value(key) % 7;
+}
+
+static bool
+uint32_t_key_equals(const void *a, const void *b)
+{
+   return key_value(a) == key_value(b);
+}
+
+static void
+test_table(uint32_t (*hash)(const void *key), uint32_t size)
+{
+   struct hash_table *ht;
+   struct hash_entry *entry;
+   uint32_t *keys = malloc(size * sizeof(*keys));
+   uint32_t i;
+
+   ht = _mesa_hash_table_create(NULL, hash, uint32_t_key_equals);
+   assert(_mesa_hash_table_enable_group_probing(ht));
+
+   for (i = 0; i < size; i++) {
+      keys[i] = i;
+
+      _mesa_hash_table_insert(ht, keys + i, keys + i);
+
+      if (i >= 100) {
+         uint32_t delete_value = i - 100;
+         entry = _mesa_hash_table_search(ht, &delete_value);
+         assert(entry);
+         _mesa_hash_table_remove(ht, entry);
+      }
+   }
+
+   for (i = 0; i < size; i++) {
+      entry = _mesa_hash_table_search(ht, keys + i);
+      if (i >= size - 100) {
+         assert(entry);
+         assert(entry->data == keys + i);
+      } else {
+         assert(!entry);
+      }
+   }
+   assert(ht->entries == 100);
+
+   /* Replacing an existing key must not add an entry. */
+   _mesa_hash_table_insert(ht, keys + size - 1, NULL);
+   assert(ht->entries == 100);
+   assert(_mesa_hash_table_search(ht, keys + size - 1)->data == NULL);
+
+   _mesa_hash_table_clear(ht, NULL);
+   assert(!_mesa_hash_table_search(ht, keys + size - 1));
+
+   for (i = 0; i < 100; i++)
+      _mesa_hash_table_insert(ht, keys + i, NULL);
+   hash_table_foreach_remove(ht, entry) {
+   }
+   for (i = 0; i < 100; i++)
+      assert(!_mesa_hash_table_search(ht, keys + i));
+   for (i = 0; i < 100; i++)
+      _mesa_hash_table_insert(ht, keys + i, NULL);
+   assert(ht->entries == 100);
+
+   _mesa_hash_table_destroy(ht, NULL);
+   free(keys);
+}
+
+int
+main(int argc, char **argv)
+{
+   (void) argc;
+   (void) argv;
+
+   test_table(key_value, SIZE);
+   test_table(colliding_hash, 1000);
+
+   return 0;
+}
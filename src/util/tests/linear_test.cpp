@@ -89,3 +89,22 @@ TEST(LinearAlloc, Options)
 
    ralloc_free(ctx);
 }
+
+TEST(LinearAlloc, BufferGrowth)
+{
+   void *ctx = ralloc_context(NULL);
+   linear_ctx *lin_ctx = linear_context(ctx);
+
+   /* Fill the first two buffers of 2048 bytes. */
+   for (int i = 0; i < 4; i++)
+      linear_alloc_child(lin_ctx, 1024);
+
+   /* The next buffer is twice as big. */
+   char *first = (char *)linear_alloc_child(lin_ctx, 1024);
+   for (int i = 1; i < 4; i++) {
+      char *ptr = (char *)linear_alloc_child(lin_ctx, 1024);
+      EXPECT_EQ(ptr - first, 1024 * i);
+   }
+
+   ralloc_free(ctx);
+}
@@ -171,3 +171,60 @@ TEST(set, search_or_add)
 
    _mesa_set_destroy(s, NULL);
 }
+
+TEST(set, group_probing)
+{
+   struct set *s = _mesa_set_create(NULL, hash_int, cmp_int);
+   ASSERT_TRUE(_mesa_set_enable_group_probing(s));
+
+   /* Small keys hash to themselves, so this also covers runs of
+    * neighbouring slots and wrapping around the end of the table.
+    */
+   static int keys[10000];
+   for (int i = 0; i < 10000; i++) {
+      keys[i] = i;
+      _mesa_set_add(s, &keys[i]);
+
+      if (i >= 100) {
+         struct set_entry *entry = _mesa_set_search(s, &keys[i - 100]);
+         ASSERT_TRUE(entry);
+         _mesa_set_remove(s, entry);
+      }
+   }
+   EXPECT_EQ(s->entries, 100);
+
+   for (int i = 0; i < 10000; i++) {
+      struct set_entry *entry = _mesa_set_search(s, &keys[i]);
+      if (i >= 10000 - 100) {
+         ASSERT_TRUE(entry);
+         EXPECT_EQ(entry->key, &keys[i]);
+      } else {
+         EXPECT_FALSE(entry);
+      }
+   }
+
+   bool found;
+   int dup = 9999;
+   EXPECT_EQ(_mesa_set_search_or_add(s, &dup, &found)->key, &keys[9999]);
+   EXPECT_TRUE(found);
+
+   struct set *clone = _mesa_set_clone(s, NULL);
+   EXPECT_TRUE(_mesa_set_search(clone, &keys[9950]));
+   _mesa_set_destroy(clone, NULL);
+
+   _mesa_set_clear(s, NULL);
+   set_foreach(s, he) {
+      GTEST_FAIL();
+   }
+   for (int i = 0; i < 1000; i++)
+      _mesa_set_add(s, &keys[i]);
+   set_foreach_remove(s, he) {
+   }
+   for (int i = 0; i < 1000; i++)
+      EXPECT_FALSE(_mesa_set_search(s, &keys[i]));
+   for (int i = 0; i < 1000; i++)
+      _mesa_set_add(s, &keys[i]);
+   EXPECT_EQ(s->entries, 1000);
+
+   _mesa_set_destroy(s, NULL);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2024 Advanced Micro Devices, Inc.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+
+#include "util/u_atomic.h"
+#include "util/u_queue.h"
+
+#define NUM_TEST_JOBS 4096
+
+struct test_job {
+   struct util_queue_fence fence;
+   unsigned *counter;
+   unsigned cleanups;
+};
+
+static void
+test_job_execute(void *data, void *gdata, int thread_index)
+{
+   struct test_job *job = (struct test_job *)data;
+   p_atomic_inc(job->counter);
+}
+
+static void
+test_job_cleanup(void *data, void *gdata, int thread_index)
+{
+   struct test_job *job = (struct test_job *)data;
+   job->cleanups++;
+}
+
+class UtilQueue : public ::testing::TestWithParam<unsigned> {
+};
+
+TEST_P(UtilQueue, AllJobsExecute)
+{
+   struct util_queue queue;
+   struct test_job *jobs = new test_job[NUM_TEST_JOBS];
+   unsigned counter = 0;
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, 8, GetParam(), NULL));
+
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      jobs[i].counter = &counter;
+      jobs[i].cleanups = 0;
+      util_queue_add_job(&queue, &jobs[i], &jobs[i].fence, test_job_execute,
+                         test_job_cleanup, 0);
+   }
+
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+
+   util_queue_finish(&queue);
+   EXPECT_EQ(p_atomic_read(&counter), NUM_TEST_JOBS);
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++)
+      EXPECT_EQ(jobs[i].cleanups, 1);
+
+   util_queue_destroy(&queue);
+   delete[] jobs;
+}
+
+TEST_P(UtilQueue, DropJob)
+{
+   struct util_queue queue;
+   struct test_job *jobs = new test_job[NUM_TEST_JOBS];
+   unsigned counter = 0;
+
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, 4, GetParam(), NULL));
+
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      jobs[i].counter = &counter;
+      jobs[i].cleanups = 0;
+      util_queue_add_job(&queue, &jobs[i], &jobs[i].fence, test_job_execute,
+                         test_job_cleanup, 0);
+   }
+
+   /* Every fence must be signalled after dropping, whether the job was
+    * removed or had already started.
+    */
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++) {
+      util_queue_drop_job(&queue, &jobs[i].fence);
+      EXPECT_TRUE(util_queue_fence_is_signalled(&jobs[i].fence));
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+
+   util_queue_finish(&queue);
+   EXPECT_LE(p_atomic_read(&counter), NUM_TEST_JOBS);
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++)
+      EXPECT_EQ(jobs[i].cleanups, 1);
+
+   util_queue_destroy(&queue);
+   delete[] jobs;
+}
+
+TEST_P(UtilQueue, AddJobsBatch)
+{
+   struct util_queue queue;
+   struct test_job *jobs = new test_job[NUM_TEST_JOBS];
+   struct util_queue_job *entries = new util_queue_job[NUM_TEST_JOBS];
+   unsigned counter = 0;
+
+   /* The batch is much larger than the queue, so non-resizable queues have
+    * to wait for free slots in the middle of the batch.
+    */
+   ASSERT_TRUE(util_queue_init(&queue, "test", 8, 4, GetParam(), NULL));
+
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++) {
+      util_queue_fence_init(&jobs[i].fence);
+      jobs[i].counter = &counter;
+      jobs[i].cleanups = 0;
+      entries[i] = {};
+      entries[i].job = &jobs[i];
+      entries[i].fence = &jobs[i].fence;
+      entries[i].execute = test_job_execute;
+      entries[i].cleanup = test_job_cleanup;
+   }
+
+   util_queue_add_jobs(&queue, entries, NUM_TEST_JOBS);
+
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++) {
+      util_queue_fence_wait(&jobs[i].fence);
+      util_queue_fence_destroy(&jobs[i].fence);
+   }
+
+   util_queue_finish(&queue);
+   EXPECT_EQ(p_atomic_read(&counter), NUM_TEST_JOBS);
+   for (unsigned i = 0; i < NUM_TEST_JOBS; i++)
+      EXPECT_EQ(jobs[i].cleanups, 1);
+
+   util_queue_destroy(&queue);
+   delete[] entries;
+   delete[] jobs;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+   UtilQueue, UtilQueue,
+   ::testing::Values(0,
+                     UTIL_QUEUE_INIT_RESIZE_IF_FULL,
+                     UTIL_QUEUE_INIT_WORK_STEALING,
+                     UTIL_QUEUE_INIT_WORK_STEALING |
+                        UTIL_QUEUE_INIT_RESIZE_IF_FULL)
+);
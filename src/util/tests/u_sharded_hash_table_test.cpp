@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2024 Advanced Micro Devices, Inc.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "util/u_sharded_hash_table.h"
+
+#define NUM_TEST_KEYS 4096
+#define NUM_TEST_THREADS 8
+
+static uint32_t
+key_value(const void *key)
+{
+   return (uint32_t)(uintptr_t)key;
+}
+
+static bool
+key_equal(const void *a, const void *b)
+{
+   return a == b;
+}
+
+static void
+insert_key(struct util_sharded_hash_table *ht, uintptr_t k)
+{
+   const void *key = (const void *)k;
+   uint32_t hash = util_sharded_hash_table_hash(ht, key);
+   struct hash_table *table = util_sharded_hash_table_lock(ht, hash);
+
+   if (!_mesa_hash_table_search_pre_hashed(table, hash, key))
+      _mesa_hash_table_insert_pre_hashed(table, hash, key, (void *)(k * 2));
+   util_sharded_hash_table_unlock(ht, hash);
+}
+
+static void *
+search_key(struct util_sharded_hash_table *ht, uintptr_t k)
+{
+   const void *key = (const void *)k;
+   uint32_t hash = util_sharded_hash_table_hash(ht, key);
+   struct hash_table *table = util_sharded_hash_table_lock(ht, hash);
+   struct hash_entry *entry =
+      _mesa_hash_table_search_pre_hashed(table, hash, key);
+   void *data = entry ? entry->data : NULL;
+
+   util_sharded_hash_table_unlock(ht, hash);
+   return data;
+}
+
+TEST(ShardedHashTable, InsertSearchRemove)
+{
+   struct util_sharded_hash_table ht;
+
+   ASSERT_TRUE(util_sharded_hash_table_init(&ht, NULL, key_value, key_equal));
+
+   for (uintptr_t k = 1; k <= NUM_TEST_KEYS; k++)
+      insert_key(&ht, k);
+   EXPECT_EQ(util_sharded_hash_table_num_entries(&ht), NUM_TEST_KEYS);
+
+   /* Sequential keys must not all land in the same shard. */
+   util_sharded_hash_table_foreach_shard(&ht, shard)
+      EXPECT_GT(shard->table.entries, 0);
+
+   for (uintptr_t k = 1; k <= NUM_TEST_KEYS; k++)
+      EXPECT_EQ(search_key(&ht, k), (void *)(k * 2));
+   EXPECT_EQ(search_key(&ht, NUM_TEST_KEYS + 1), nullptr);
+
+   for (uintptr_t k = 1; k <= NUM_TEST_KEYS; k += 2) {
+      uint32_t hash = util_sharded_hash_table_hash(&ht, (const void *)k);
+      struct hash_table *table = util_sharded_hash_table_lock(&ht, hash);
+      struct hash_entry *entry =
+         _mesa_hash_table_search_pre_hashed(table, hash, (const void *)k);
+      ASSERT_NE(entry, nullptr);
+      _mesa_hash_table_remove(table, entry);
+      util_sharded_hash_table_unlock(&ht, hash);
+   }
+   EXPECT_EQ(util_sharded_hash_table_num_entries(&ht), NUM_TEST_KEYS / 2);
+
+   for (uintptr_t k = 1; k <= NUM_TEST_KEYS; k++)
+      EXPECT_EQ(search_key(&ht, k), k % 2 ? nullptr : (void *)(k * 2));
+
+   util_sharded_hash_table_clear(&ht, NULL);
+   EXPECT_EQ(util_sharded_hash_table_num_entries(&ht), 0);
+
+   util_sharded_hash_table_fini(&ht, NULL);
+}
+
+TEST(ShardedHashTable, ConcurrentInsert)
+{
+   struct util_sharded_hash_table ht;
+   std::vector<std::thread> threads;
+
+   ASSERT_TRUE(util_sharded_hash_table_init(&ht, NULL, key_value, key_equal));
+
+   /* Every thread inserts every key, so each insertion races with the same
+    * key being inserted from the other threads.
+    */
+   for (unsigned t = 0; t < NUM_TEST_THREADS; t++) {
+      threads.emplace_back([&ht]() {
+         for (uintptr_t k = 1; k <= NUM_TEST_KEYS; k++)
+            insert_key(&ht, k);
+      });
+   }
+   for (std::thread &thread : threads)
+      thread.join();
+
+   EXPECT_EQ(util_sharded_hash_table_num_entries(&ht), NUM_TEST_KEYS);
+   for (uintptr_t k = 1; k <= NUM_TEST_KEYS; k++)
+      EXPECT_EQ(search_key(&ht, k), (void *)(k * 2));
+
+   util_sharded_hash_table_fini(&ht, NULL);
+}
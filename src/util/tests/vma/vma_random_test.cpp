@@ -72,10 +72,12 @@ struct random_test {
    static const uint64_t MEM_SIZE = 0xfffffffffffff000;
    static const uint64_t MEM_PAGES = MEM_SIZE / MEM_PAGE_SIZE;
 
-   random_test(uint_fast32_t seed)
+   random_test(uint_fast32_t seed, uint64_t cache_size = 0)
       : heap_holes{allocation{MEM_START_PAGE, MEM_PAGES}}, rand{seed}
    {
       util_vma_heap_init(&heap, MEM_START_PAGE * MEM_PAGE_SIZE, MEM_SIZE);
+      if (cache_size)
+         util_vma_heap_enable_cache(&heap, cache_size);
    }
 
    ~random_test()
@@ -252,6 +254,10 @@ int main(int argc, char **argv)
    random_test r{(uint_fast32_t)seed};
    r.test(count);
 
+   /* Same again, with freed ranges of up to 64 pages being cached. */
+   random_test rc{(uint_fast32_t)seed, 64 * MEM_PAGE_SIZE};
+   rc.test(count);
+
    printf("ok\n");
    return 0;
 }
@@ -28,6 +28,7 @@
 
 #include "c11/threads.h"
 #include "util/u_cpu_detect.h"
+#include "util/u_math.h"
 #include "util/os_time.h"
 #include "util/u_string.h"
 #include "util/u_thread.h"
@@ -46,6 +47,8 @@
 static void
 util_queue_kill_threads(struct util_queue *queue, unsigned keep_num_threads,
                         bool locked);
+static void
+util_queue_finish_execute(void *data, void *gdata, int num_thread);
 
 /****************************************************************************
  * Wait for all queues to assert idle when exit() is called.
@@ -246,6 +249,281 @@ struct thread_input {
    int thread_index;
 };
 
+/****************************************************************************
+ * Work-stealing mode (UTIL_QUEUE_INIT_WORK_STEALING)
+ *
+ * Every thread owns a deque protected by its own lock. Producers distribute
+ * jobs round-robin across the deques of the active threads. A thread pops
+ * jobs from its own deque and, when that is empty, steals from the other
+ * deques. Both always take the oldest job of a deque, so a job still can't
+ * start before the older jobs of the same deque, which keeps jobs that wait
+ * on the fences of earlier jobs from deadlocking.
+ *
+ * The queue lock is only used to put idle threads to sleep and wake them up,
+ * to wait for space when the queue is bounded, and to start and stop
+ * threads.
+ */
+
+/* The sleep/wakeup handshakes below increment one counter and then read
+ * another one while the other side does the opposite. Plain acquire loads
+ * may be reordered before the preceding increment, so read the counters with
+ * a read-modify-write operation to order them.
+ */
+#define ws_read_ordered(v) p_atomic_add_return((v), 0)
+
+static bool
+util_queue_deque_init(struct util_queue_deque *dq, unsigned size)
+{
+   simple_mtx_init(&dq->lock, mtx_plain);
+   dq->head = 0;
+   dq->count = 0;
+   dq->size = util_next_power_of_two(MAX2(size, 4));
+   dq->jobs = (struct util_queue_job*)
+              calloc(dq->size, sizeof(struct util_queue_job));
+   return dq->jobs != NULL;
+}
+
+static void
+util_queue_deque_destroy(struct util_queue_deque *dq)
+{
+   simple_mtx_destroy(&dq->lock);
+   free(dq->jobs);
+}
+
+static void
+util_queue_deque_push(struct util_queue_deque *dq,
+                      const struct util_queue_job *job)
+{
+   if (dq->count == dq->size) {
+      unsigned new_size = dq->size * 2;
+      struct util_queue_job *jobs =
+         (struct util_queue_job*)calloc(new_size,
+                                        sizeof(struct util_queue_job));
+      assert(jobs);
+
+      for (unsigned i = 0; i < dq->count; i++)
+         jobs[i] = dq->jobs[(dq->head + i) & (dq->size - 1)];
+
+      free(dq->jobs);
+      dq->jobs = jobs;
+      dq->head = 0;
+      dq->size = new_size;
+   }
+
+   dq->jobs[(dq->head + dq->count) & (dq->size - 1)] = *job;
+   dq->count++;
+}
+
+static bool
+util_queue_deque_pop(struct util_queue_deque *dq, struct util_queue_job *job)
+{
+   if (!dq->count)
+      return false;
+
+   *job = dq->jobs[dq->head];
+   memset(&dq->jobs[dq->head], 0, sizeof(struct util_queue_job));
+   dq->head = (dq->head + 1) & (dq->size - 1);
+   dq->count--;
+   return true;
+}
+
+static bool
+util_queue_ws_get_job(struct util_queue *queue, unsigned thread_index,
+                      struct util_queue_job *job)
+{
+   bool found = false;
+
+   for (unsigned i = 0; i < queue->max_threads && !found; i++) {
+      struct util_queue_deque *dq =
+         &queue->deques[(thread_index + i) % queue->max_threads];
+
+      simple_mtx_lock(&dq->lock);
+      found = util_queue_deque_pop(dq, job);
+      simple_mtx_unlock(&dq->lock);
+   }
+
+   if (!found)
+      return false;
+
+   p_atomic_add(&queue->total_jobs_size, -(int64_t)job->job_size);
+   p_atomic_dec(&queue->num_queued);
+
+   if (ws_read_ordered(&queue->num_space_waiters)) {
+      mtx_lock(&queue->lock);
+      cnd_broadcast(&queue->has_space_cond);
+      mtx_unlock(&queue->lock);
+   }
+   return true;
+}
+
+static void
+util_queue_ws_signal_remaining_jobs(struct util_queue *queue)
+{
+   for (unsigned i = 0; i < queue->max_threads; i++) {
+      struct util_queue_deque *dq = &queue->deques[i];
+      struct util_queue_job job;
+
+      simple_mtx_lock(&dq->lock);
+      while (util_queue_deque_pop(dq, &job)) {
+         if (job.job && job.fence)
+            util_queue_fence_signal(job.fence);
+      }
+      simple_mtx_unlock(&dq->lock);
+   }
+   p_atomic_set(&queue->num_queued, 0);
+   p_atomic_set(&queue->total_jobs_size, 0);
+}
+
+static int
+util_queue_ws_thread_func(struct util_queue *queue, unsigned thread_index)
+{
+   while (1) {
+      struct util_queue_job job;
+
+      /* only kill threads that are above "num_threads" */
+      if (thread_index >= p_atomic_read(&queue->num_threads))
+         break;
+
+      if (!util_queue_ws_get_job(queue, thread_index, &job)) {
+         /* Producers check num_sleepers after incrementing num_queued, so
+          * either they see us here or we see their job below.
+          */
+         mtx_lock(&queue->lock);
+         p_atomic_inc(&queue->num_sleepers);
+         while (thread_index < queue->num_threads &&
+                ws_read_ordered(&queue->num_queued) == 0)
+            cnd_wait(&queue->has_queued_cond, &queue->lock);
+         p_atomic_dec(&queue->num_sleepers);
+         mtx_unlock(&queue->lock);
+         continue;
+      }
+
+      if (job.job) {
+         job.execute(job.job, job.global_data, thread_index);
+         if (job.fence)
+            util_queue_fence_signal(job.fence);
+         if (job.cleanup)
+            job.cleanup(job.job, job.global_data, thread_index);
+      }
+   }
+
+   /* signal remaining jobs if all threads are being terminated */
+   mtx_lock(&queue->lock);
+   if (queue->num_threads == 0)
+      util_queue_ws_signal_remaining_jobs(queue);
+   mtx_unlock(&queue->lock);
+   return 0;
+}
+
+static void
+util_queue_ws_add_jobs(struct util_queue *queue,
+                       const struct util_queue_job *jobs,
+                       unsigned num_jobs,
+                       bool locked)
+{
+   unsigned n;
+
+   for (n = 0; n < num_jobs; n++) {
+      struct util_queue_job job = jobs[n];
+      job.global_data = queue->global_data;
+
+      /* Scale the number of threads up if there's already one job waiting. */
+      if (p_atomic_read(&queue->num_queued) > 0 &&
+          queue->create_threads_on_demand &&
+          job.execute != util_queue_finish_execute &&
+          p_atomic_read(&queue->num_threads) < queue->max_threads) {
+         if (!locked)
+            mtx_lock(&queue->lock);
+         util_queue_adjust_num_threads(queue, queue->num_threads + 1, true);
+         if (!locked)
+            mtx_unlock(&queue->lock);
+      }
+
+      if (p_atomic_read(&queue->num_queued) >= queue->max_jobs &&
+          !(queue->flags & UTIL_QUEUE_INIT_RESIZE_IF_FULL &&
+            p_atomic_read(&queue->total_jobs_size) + job.job_size < S_256MB)) {
+         /* Wait until there is a free slot. The limit is only approximate
+          * because concurrent producers don't serialize on the queue lock,
+          * but the deques grow as needed, so overshooting it is harmless.
+          */
+         if (!locked)
+            mtx_lock(&queue->lock);
+         /* The jobs added so far haven't woken up any thread yet. */
+         if (n)
+            cnd_broadcast(&queue->has_queued_cond);
+         p_atomic_inc(&queue->num_space_waiters);
+         while (ws_read_ordered(&queue->num_queued) >= queue->max_jobs &&
+                queue->num_threads)
+            cnd_wait(&queue->has_space_cond, &queue->lock);
+         p_atomic_dec(&queue->num_space_waiters);
+         if (!locked)
+            mtx_unlock(&queue->lock);
+      }
+
+      unsigned num_threads = p_atomic_read(&queue->num_threads);
+      if (num_threads == 0)
+         break;
+
+      struct util_queue_deque *dq =
+         &queue->deques[p_atomic_inc_return(&queue->next_deque) % num_threads];
+
+      simple_mtx_lock(&dq->lock);
+      /* Checked again under the deque lock so that a job can't be added
+       * after the last thread flushed this deque on termination.
+       */
+      if (p_atomic_read(&queue->num_threads) == 0) {
+         simple_mtx_unlock(&dq->lock);
+         break;
+      }
+
+      if (job.fence)
+         util_queue_fence_reset(job.fence);
+
+      util_queue_deque_push(dq, &job);
+      simple_mtx_unlock(&dq->lock);
+
+      p_atomic_add(&queue->total_jobs_size, (int64_t)job.job_size);
+      p_atomic_inc(&queue->num_queued);
+   }
+
+   if (n && ws_read_ordered(&queue->num_sleepers)) {
+      if (!locked)
+         mtx_lock(&queue->lock);
+      if (n > 1)
+         cnd_broadcast(&queue->has_queued_cond);
+      else
+         cnd_signal(&queue->has_queued_cond);
+      if (!locked)
+         mtx_unlock(&queue->lock);
+   }
+}
+
+static bool
+util_queue_ws_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
+{
+   for (unsigned i = 0; i < queue->max_threads; i++) {
+      struct util_queue_deque *dq = &queue->deques[i];
+
+      simple_mtx_lock(&dq->lock);
+      for (unsigned j = 0; j < dq->count; j++) {
+         struct util_queue_job *job = &dq->jobs[(dq->head + j) & (dq->size - 1)];
+
+         if (job->fence == fence) {
+            if (job->cleanup)
+               job->cleanup(job->job, queue->global_data, -1);
+
+            /* Just clear it. The threads will treat as a no-op job. */
+            p_atomic_add(&queue->total_jobs_size, -(int64_t)job->job_size);
+            memset(job, 0, sizeof(*job));
+            simple_mtx_unlock(&dq->lock);
+            return true;
+         }
+      }
+      simple_mtx_unlock(&dq->lock);
+   }
+   return false;
+}
+
 static int
 util_queue_thread_func(void *input)
 {
@@ -279,6 +557,9 @@ util_queue_thread_func(void *input)
       u_thread_setname(name);
    }
 
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING)
+      return util_queue_ws_thread_func(queue, thread_index);
+
    while (1) {
       struct util_queue_job job;
 
@@ -460,6 +741,19 @@ util_queue_init(struct util_queue *queue,
    if (!queue->jobs)
       goto fail;
 
+   if (flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      queue->deques = (struct util_queue_deque*)
+                      calloc(queue->max_threads, sizeof(struct util_queue_deque));
+      if (!queue->deques)
+         goto fail;
+
+      for (i = 0; i < queue->max_threads; i++) {
+         if (!util_queue_deque_init(&queue->deques[i],
+                                    DIV_ROUND_UP(max_jobs, queue->max_threads)))
+            goto fail;
+      }
+   }
+
    queue->threads = (thrd_t*) calloc(queue->max_threads, sizeof(thrd_t));
    if (!queue->threads)
       goto fail;
@@ -484,6 +778,14 @@ util_queue_init(struct util_queue *queue,
 fail:
    free(queue->threads);
 
+   if (queue->deques) {
+      for (i = 0; i < queue->max_threads; i++) {
+         if (queue->deques[i].jobs)
+            util_queue_deque_destroy(&queue->deques[i]);
+      }
+      free(queue->deques);
+   }
+
    if (queue->jobs) {
       cnd_destroy(&queue->has_space_cond);
       cnd_destroy(&queue->has_queued_cond);
@@ -550,21 +852,28 @@ util_queue_destroy(struct util_queue *queue)
    cnd_destroy(&queue->has_space_cond);
    cnd_destroy(&queue->has_queued_cond);
    mtx_destroy(&queue->lock);
+   if (queue->deques) {
+      for (unsigned i = 0; i < queue->max_threads; i++)
+         util_queue_deque_destroy(&queue->deques[i]);
+      free(queue->deques);
+   }
    free(queue->jobs);
    free(queue->threads);
 }
 
 static void
-util_queue_add_job_locked(struct util_queue *queue,
-                          void *job,
-                          struct util_queue_fence *fence,
-                          util_queue_execute_func execute,
-                          util_queue_execute_func cleanup,
-                          const size_t job_size,
-                          bool locked)
+util_queue_add_jobs_locked(struct util_queue *queue,
+                           const struct util_queue_job *jobs,
+                           unsigned num_jobs,
+                           bool locked)
 {
    struct util_queue_job *ptr;
 
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      util_queue_ws_add_jobs(queue, jobs, num_jobs, locked);
+      return;
+   }
+
    if (!locked)
       mtx_lock(&queue->lock);
    if (queue->num_threads == 0) {
@@ -576,68 +885,76 @@ util_queue_add_job_locked(struct util_queue *queue,
       return;
    }
 
-   if (fence)
-      util_queue_fence_reset(fence);
+   for (unsigned n = 0; n < num_jobs; n++) {
+      const struct util_queue_job *job = &jobs[n];
 
-   assert(queue->num_queued >= 0 && queue->num_queued <= queue->max_jobs);
+      if (job->fence)
+         util_queue_fence_reset(job->fence);
 
-   /* Scale the number of threads up if there's already one job waiting. */
-   if (queue->num_queued > 0 &&
-       queue->create_threads_on_demand &&
-       execute != util_queue_finish_execute &&
-       queue->num_threads < queue->max_threads) {
-      util_queue_adjust_num_threads(queue, queue->num_threads + 1, true);
-   }
+      assert(queue->num_queued >= 0 && queue->num_queued <= queue->max_jobs);
 
-   if (queue->num_queued == queue->max_jobs) {
-      if (queue->flags & UTIL_QUEUE_INIT_RESIZE_IF_FULL &&
-          queue->total_jobs_size + job_size < S_256MB) {
-         /* If the queue is full, make it larger to avoid waiting for a free
-          * slot.
-          */
-         unsigned new_max_jobs = queue->max_jobs + 8;
-         struct util_queue_job *jobs =
-            (struct util_queue_job*)calloc(new_max_jobs,
-                                           sizeof(struct util_queue_job));
-         assert(jobs);
-
-         /* Copy all queued jobs into the new list. */
-         unsigned num_jobs = 0;
-         unsigned i = queue->read_idx;
-
-         do {
-            jobs[num_jobs++] = queue->jobs[i];
-            i = (i + 1) % queue->max_jobs;
-         } while (i != queue->write_idx);
-
-         assert(num_jobs == queue->num_queued);
-
-         free(queue->jobs);
-         queue->jobs = jobs;
-         queue->read_idx = 0;
-         queue->write_idx = num_jobs;
-         queue->max_jobs = new_max_jobs;
-      } else {
-         /* Wait until there is a free slot. */
-         while (queue->num_queued == queue->max_jobs)
-            cnd_wait(&queue->has_space_cond, &queue->lock);
+      /* Scale the number of threads up if there's already one job waiting. */
+      if (queue->num_queued > 0 &&
+          queue->create_threads_on_demand &&
+          job->execute != util_queue_finish_execute &&
+          queue->num_threads < queue->max_threads) {
+         util_queue_adjust_num_threads(queue, queue->num_threads + 1, true);
       }
-   }
 
-   ptr = &queue->jobs[queue->write_idx];
-   assert(ptr->job == NULL);
-   ptr->job = job;
-   ptr->global_data = queue->global_data;
-   ptr->fence = fence;
-   ptr->execute = execute;
-   ptr->cleanup = cleanup;
-   ptr->job_size = job_size;
+      if (queue->num_queued == queue->max_jobs) {
+         if (queue->flags & UTIL_QUEUE_INIT_RESIZE_IF_FULL &&
+             queue->total_jobs_size + job->job_size < S_256MB) {
+            /* If the queue is full, make it larger to avoid waiting for a free
+             * slot.
+             */
+            unsigned new_max_jobs = queue->max_jobs + MAX2(num_jobs - n, 8);
+            struct util_queue_job *new_jobs =
+               (struct util_queue_job*)calloc(new_max_jobs,
+                                              sizeof(struct util_queue_job));
+            assert(new_jobs);
+
+            /* Copy all queued jobs into the new list. */
+            unsigned num_queued = 0;
+            unsigned i = queue->read_idx;
+
+            do {
+               new_jobs[num_queued++] = queue->jobs[i];
+               i = (i + 1) % queue->max_jobs;
+            } while (i != queue->write_idx);
+
+            assert(num_queued == queue->num_queued);
+
+            free(queue->jobs);
+            queue->jobs = new_jobs;
+            queue->read_idx = 0;
+            queue->write_idx = num_queued;
+            queue->max_jobs = new_max_jobs;
+         } else {
+            /* The jobs added so far haven't woken up any thread yet. */
+            if (n)
+               cnd_broadcast(&queue->has_queued_cond);
+
+            /* Wait until there is a free slot. */
+            while (queue->num_queued == queue->max_jobs)
+               cnd_wait(&queue->has_space_cond, &queue->lock);
+         }
+      }
+
+      ptr = &queue->jobs[queue->write_idx];
+      assert(ptr->job == NULL);
+      *ptr = *job;
+      ptr->global_data = queue->global_data;
+
+      queue->write_idx = (queue->write_idx + 1) % queue->max_jobs;
+      queue->total_jobs_size += ptr->job_size;
 
-   queue->write_idx = (queue->write_idx + 1) % queue->max_jobs;
-   queue->total_jobs_size += ptr->job_size;
+      queue->num_queued++;
+   }
 
-   queue->num_queued++;
-   cnd_signal(&queue->has_queued_cond);
+   if (num_jobs > 1)
+      cnd_broadcast(&queue->has_queued_cond);
+   else
+      cnd_signal(&queue->has_queued_cond);
    if (!locked)
       mtx_unlock(&queue->lock);
 }
@@ -650,8 +967,32 @@ util_queue_add_job(struct util_queue *queue,
                    util_queue_execute_func cleanup,
                    const size_t job_size)
 {
-   util_queue_add_job_locked(queue, job, fence, execute, cleanup, job_size,
-                             false);
+   struct util_queue_job entry = {
+      .job = job,
+      .job_size = job_size,
+      .fence = fence,
+      .execute = execute,
+      .cleanup = cleanup,
+   };
+
+   util_queue_add_jobs_locked(queue, &entry, 1, false);
+}
+
+/**
+ * Add \p num_jobs jobs at once. This is equivalent to calling
+ * util_queue_add_job for each of them in order, but the queue lock is only
+ * taken once and the worker threads are woken up once for the whole batch.
+ *
+ * The global_data field of each job is ignored; the queue's global data is
+ * passed to the callbacks as with util_queue_add_job.
+ */
+void
+util_queue_add_jobs(struct util_queue *queue,
+                    const struct util_queue_job *jobs,
+                    unsigned num_jobs)
+{
+   if (num_jobs)
+      util_queue_add_jobs_locked(queue, jobs, num_jobs, false);
 }
 
 /**
@@ -672,6 +1013,14 @@ util_queue_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
    if (util_queue_fence_is_signalled(fence))
       return;
 
+   if (queue->flags & UTIL_QUEUE_INIT_WORK_STEALING) {
+      if (util_queue_ws_drop_job(queue, fence))
+         util_queue_fence_signal(fence);
+      else
+         util_queue_fence_wait(fence);
+      return;
+   }
+
    mtx_lock(&queue->lock);
    for (unsigned i = queue->read_idx; i != queue->write_idx;
         i = (i + 1) % queue->max_jobs) {
@@ -701,6 +1050,7 @@ util_queue_finish(struct util_queue *queue)
 {
    util_barrier barrier;
    struct util_queue_fence *fences;
+   struct util_queue_job *jobs;
 
    /* If 2 threads were adding jobs for 2 different barries at the same time,
     * a deadlock would happen, because 1 barrier requires that all threads
@@ -723,13 +1073,18 @@ util_queue_finish(struct util_queue *queue)
    queue->create_threads_on_demand = false;
 
    fences = malloc(queue->num_threads * sizeof(*fences));
+   jobs = malloc(queue->num_threads * sizeof(*jobs));
    util_barrier_init(&barrier, queue->num_threads);
 
    for (unsigned i = 0; i < queue->num_threads; ++i) {
       util_queue_fence_init(&fences[i]);
-      util_queue_add_job_locked(queue, &barrier, &fences[i],
-                                util_queue_finish_execute, NULL, 0, true);
+      jobs[i] = (struct util_queue_job) {
+         .job = &barrier,
+         .fence = &fences[i],
+         .execute = util_queue_finish_execute,
+      };
    }
+   util_queue_add_jobs_locked(queue, jobs, queue->num_threads, true);
    queue->create_threads_on_demand = true;
    mtx_unlock(&queue->lock);
 
@@ -738,6 +1093,7 @@ util_queue_finish(struct util_queue *queue)
       util_queue_fence_destroy(&fences[i]);
    }
 
+   free(jobs);
    free(fences);
 }
 
@@ -50,6 +50,11 @@ extern "C" {
 #define UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY      (1 << 0)
 #define UTIL_QUEUE_INIT_RESIZE_IF_FULL            (1 << 1)
 #define UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY  (1 << 2)
+/* Give every thread its own job deque and let idle threads steal jobs from
+ * the others instead of all threads contending on the queue lock. Jobs may
+ * execute out of submission order in this mode.
+ */
+#define UTIL_QUEUE_INIT_WORK_STEALING             (1 << 3)
 
 #if UTIL_FUTEX_SUPPORTED
 #define UTIL_QUEUE_FENCE_FUTEX
@@ -219,6 +224,15 @@ struct util_queue_job {
    util_queue_execute_func cleanup;
 };
 
+/* Per-thread job deque used by UTIL_QUEUE_INIT_WORK_STEALING. */
+struct util_queue_deque {
+   simple_mtx_t lock;
+   unsigned head;  /* index of the oldest job */
+   unsigned count; /* number of jobs in the deque */
+   unsigned size;  /* capacity, always a power of two */
+   struct util_queue_job *jobs;
+};
+
 /* Put this into your context. */
 struct util_queue {
    char name[14]; /* 13 characters = the thread name without the index */
@@ -237,6 +251,14 @@ struct util_queue {
    struct util_queue_job *jobs;
    void *global_data;
 
+   /* UTIL_QUEUE_INIT_WORK_STEALING only. num_queued and total_jobs_size are
+    * updated atomically in this mode and "jobs" is unused.
+    */
+   struct util_queue_deque *deques; /* one per thread, max_threads entries */
+   unsigned next_deque;             /* round-robin submission cursor */
+   unsigned num_sleepers;           /* threads waiting for has_queued_cond */
+   unsigned num_space_waiters;      /* producers waiting for has_space_cond */
+
    /* for cleanup at exit(), protected by exit_mutex */
    struct list_head head;
 };
@@ -256,6 +278,9 @@ void util_queue_add_job(struct util_queue *queue,
                         util_queue_execute_func execute,
                         util_queue_execute_func cleanup,
                         const size_t job_size);
+void util_queue_add_jobs(struct util_queue *queue,
+                         const struct util_queue_job *jobs,
+                         unsigned num_jobs);
 void util_queue_drop_job(struct util_queue *queue,
                          struct util_queue_fence *fence);
 
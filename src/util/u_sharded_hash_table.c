@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2024 Advanced Micro Devices, Inc.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "util/u_sharded_hash_table.h"
+
+#include "util/ralloc.h"
+
+bool
+util_sharded_hash_table_init(struct util_sharded_hash_table *ht,
+                             void *mem_ctx,
+                             uint32_t (*key_hash_function)(const void *key),
+                             bool (*key_equals_function)(const void *a,
+                                                         const void *b))
+{
+   ht->key_hash_function = key_hash_function;
+
+   for (unsigned i = 0; i < UTIL_SHARDED_HASH_TABLE_NUM_SHARDS; i++) {
+      struct util_sharded_hash_table_shard *shard = &ht->shards[i];
+
+      if (!_mesa_hash_table_init(&shard->table, mem_ctx, key_hash_function,
+                                 key_equals_function)) {
+         while (i--) {
+            ralloc_free(ht->shards[i].table.table);
+            simple_mtx_destroy(&ht->shards[i].lock);
+         }
+         return false;
+      }
+      simple_mtx_init(&shard->lock, mtx_plain);
+   }
+   return true;
+}
+
+void
+util_sharded_hash_table_fini(struct util_sharded_hash_table *ht,
+                             void (*delete_function)(struct hash_entry *entry))
+{
+   util_sharded_hash_table_foreach_shard(ht, shard) {
+      if (delete_function) {
+         hash_table_foreach(&shard->table, entry)
+            delete_function(entry);
+      }
+      ralloc_free(shard->table.table);
+      shard->table.table = NULL;
+      simple_mtx_destroy(&shard->lock);
+   }
+}
+
+void
+util_sharded_hash_table_clear(struct util_sharded_hash_table *ht,
+                              void (*delete_function)(struct hash_entry *entry))
+{
+   util_sharded_hash_table_foreach_shard(ht, shard) {
+      simple_mtx_lock(&shard->lock);
+      _mesa_hash_table_clear(&shard->table, delete_function);
+      simple_mtx_unlock(&shard->lock);
+   }
+}
+
+uint32_t
+util_sharded_hash_table_num_entries(struct util_sharded_hash_table *ht)
+{
+   uint32_t entries = 0;
+
+   util_sharded_hash_table_foreach_shard(ht, shard) {
+      simple_mtx_lock(&shard->lock);
+      entries += _mesa_hash_table_num_entries(&shard->table);
+      simple_mtx_unlock(&shard->lock);
+   }
+   return entries;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright © 2024 Advanced Micro Devices, Inc.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Lock-striped hash table for caches that are shared between threads.
+ *
+ * The key space is split into a fixed number of shards, each of which is a
+ * regular struct hash_table protected by its own mutex. Threads looking up
+ * or inserting different keys mostly end up in different shards, so they
+ * don't serialize on a single cache lock.
+ *
+ * The shard is selected by the key hash, so the caller locks the shard with
+ * the hash of the key, uses the regular _mesa_hash_table_*_pre_hashed
+ * functions on the returned table, and unlocks the shard with the same hash:
+ *
+ *    uint32_t hash = util_sharded_hash_table_hash(ht, key);
+ *    struct hash_table *table = util_sharded_hash_table_lock(ht, hash);
+ *    struct hash_entry *entry =
+ *       _mesa_hash_table_search_pre_hashed(table, hash, key);
+ *    ...
+ *    util_sharded_hash_table_unlock(ht, hash);
+ *
+ * Keeping the shard locked across lookup and insertion allows "create if
+ * missing" patterns without racing other threads on the same key.
+ */
+
+#ifndef U_SHARDED_HASH_TABLE_H
+#define U_SHARDED_HASH_TABLE_H
+
+#include "util/hash_table.h"
+#include "util/simple_mtx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UTIL_SHARDED_HASH_TABLE_SHARDS_LOG2 4
+#define UTIL_SHARDED_HASH_TABLE_NUM_SHARDS (1 << UTIL_SHARDED_HASH_TABLE_SHARDS_LOG2)
+
+/* The table is embedded in driver screens and contexts, which aren't
+ * allocated with cache line alignment, so the shards aren't aligned
+ * either. A shard is bigger than a cache line though, so two locks never
+ * share one.
+ */
+struct util_sharded_hash_table_shard {
+   simple_mtx_t lock;
+   struct hash_table table;
+};
+
+struct util_sharded_hash_table {
+   struct util_sharded_hash_table_shard shards[UTIL_SHARDED_HASH_TABLE_NUM_SHARDS];
+   uint32_t (*key_hash_function)(const void *key);
+};
+
+bool
+util_sharded_hash_table_init(struct util_sharded_hash_table *ht,
+                             void *mem_ctx,
+                             uint32_t (*key_hash_function)(const void *key),
+                             bool (*key_equals_function)(const void *a,
+                                                         const void *b));
+
+void
+util_sharded_hash_table_fini(struct util_sharded_hash_table *ht,
+                             void (*delete_function)(struct hash_entry *entry));
+
+void
+util_sharded_hash_table_clear(struct util_sharded_hash_table *ht,
+                              void (*delete_function)(struct hash_entry *entry));
+
+uint32_t
+util_sharded_hash_table_num_entries(struct util_sharded_hash_table *ht);
+
+static inline uint32_t
+util_sharded_hash_table_hash(const struct util_sharded_hash_table *ht,
+                             const void *key)
+{
+   return ht->key_hash_function(key);
+}
+
+static inline struct util_sharded_hash_table_shard *
+util_sharded_hash_table_get_shard(struct util_sharded_hash_table *ht,
+                                  uint32_t hash)
+{
+   /* Many key hashes (e.g. _mesa_hash_pointer) have almost constant high
+    * bits, and the tables inside the shards consume the low bits, so mix
+    * the hash before taking the shard index from the top bits.
+    */
+   uint32_t index = (hash * 0x9e3779b1u) >>
+                    (32 - UTIL_SHARDED_HASH_TABLE_SHARDS_LOG2);
+   return &ht->shards[index];
+}
+
+/* Lock the shard owning \p hash and return its table. */
+static inline struct hash_table *
+util_sharded_hash_table_lock(struct util_sharded_hash_table *ht, uint32_t hash)
+{
+   struct util_sharded_hash_table_shard *shard =
+      util_sharded_hash_table_get_shard(ht, hash);
+
+   simple_mtx_lock(&shard->lock);
+   return &shard->table;
+}
+
+static inline void
+util_sharded_hash_table_unlock(struct util_sharded_hash_table *ht,
+                               uint32_t hash)
+{
+   simple_mtx_unlock(&util_sharded_hash_table_get_shard(ht, hash)->lock);
+}
+
+/* Iterate over all shards. The body is responsible for locking
+ * shard->lock if other threads can access the table concurrently.
+ */
+#define util_sharded_hash_table_foreach_shard(ht, shard)                  \
+   for (struct util_sharded_hash_table_shard *shard = &(ht)->shards[0];  \
+        shard != &(ht)->shards[UTIL_SHARDED_HASH_TABLE_NUM_SHARDS];      \
+        shard++)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* U_SHARDED_HASH_TABLE_H */
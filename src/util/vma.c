@@ -43,12 +43,32 @@ struct util_vma_hole {
 #define util_vma_foreach_hole_safe_rev(_hole, _heap) \
    list_for_each_entry_safe_rev(struct util_vma_hole, _hole, &(_heap)->holes, link)
 
+/* Maximum number of free ranges kept in one size class of the cache.  This
+ * bounds both the cost of looking up a range and the fragmentation caused by
+ * ranges not being merged back into the holes.
+ */
+#define UTIL_VMA_CACHE_BIN_MAX_RANGES 32
+
+/* Freed ranges with a size of [2^i, 2^(i+1)) are cached in bin i.  They use
+ * the same struct as the holes.
+ */
+struct util_vma_cache_bin {
+   struct list_head ranges;
+   unsigned num_ranges;
+};
+
+static void util_vma_heap_free_hole(struct util_vma_heap *heap,
+                                    uint64_t offset, uint64_t size);
+
 void
 util_vma_heap_init(struct util_vma_heap *heap,
                    uint64_t start, uint64_t size)
 {
    list_inithead(&heap->holes);
    heap->free_size = 0;
+   heap->cache_bins = NULL;
+   heap->cache_max_size = 0;
+   heap->cached_size = 0;
    if (size > 0)
       util_vma_heap_free(heap, start, size);
 
@@ -64,6 +84,120 @@ util_vma_heap_finish(struct util_vma_heap *heap)
 {
    util_vma_foreach_hole_safe(hole, heap)
       free(hole);
+
+   if (heap->cache_bins) {
+      for (unsigned i = 0; i <= util_logbase2_64(heap->cache_max_size); i++) {
+         list_for_each_entry_safe(struct util_vma_hole, range,
+                                  &heap->cache_bins[i].ranges, link)
+            free(range);
+      }
+      free(heap->cache_bins);
+   }
+}
+
+/**
+ * Makes util_vma_heap_free() keep freed ranges of up to max_size in a small
+ * cache segregated by size, instead of merging them back into the holes.
+ * util_vma_heap_alloc() hands out a cached range of the exact size without
+ * walking the holes, which is a lot cheaper for heaps with many holes where
+ * the same sizes are allocated and freed over and over (ie. BOs).
+ *
+ * The cache is flushed back into the holes whenever an allocation can't be
+ * satisfied otherwise, so this never makes an allocation fail.
+ */
+void
+util_vma_heap_enable_cache(struct util_vma_heap *heap, uint64_t max_size)
+{
+   assert(!heap->cache_bins && max_size > 0);
+
+   const unsigned num_bins = util_logbase2_64(max_size) + 1;
+   heap->cache_bins = calloc(num_bins, sizeof(*heap->cache_bins));
+   if (!heap->cache_bins)
+      return;
+
+   for (unsigned i = 0; i < num_bins; i++)
+      list_inithead(&heap->cache_bins[i].ranges);
+
+   heap->cache_max_size = max_size;
+}
+
+static void
+util_vma_heap_flush_cache(struct util_vma_heap *heap)
+{
+   if (!heap->cached_size)
+      return;
+
+   for (unsigned i = 0; i <= util_logbase2_64(heap->cache_max_size); i++) {
+      struct util_vma_cache_bin *bin = &heap->cache_bins[i];
+
+      list_for_each_entry_safe(struct util_vma_hole, range,
+                               &bin->ranges, link) {
+         heap->free_size -= range->size;
+         heap->cached_size -= range->size;
+         util_vma_heap_free_hole(heap, range->offset, range->size);
+         free(range);
+      }
+      list_inithead(&bin->ranges);
+      bin->num_ranges = 0;
+   }
+
+   assert(heap->cached_size == 0);
+}
+
+static uint64_t
+util_vma_heap_alloc_cached(struct util_vma_heap *heap,
+                           uint64_t size, uint64_t alignment)
+{
+   if (size > heap->cache_max_size)
+      return 0;
+
+   struct util_vma_cache_bin *bin =
+      &heap->cache_bins[util_logbase2_64(size)];
+
+   list_for_each_entry(struct util_vma_hole, range, &bin->ranges, link) {
+      if (range->size != size || range->offset % alignment)
+         continue;
+
+      const uint64_t offset = range->offset;
+
+      list_del(&range->link);
+      free(range);
+      bin->num_ranges--;
+      heap->cached_size -= size;
+      heap->free_size -= size;
+
+      return offset;
+   }
+
+   return 0;
+}
+
+static bool
+util_vma_heap_free_cached(struct util_vma_heap *heap,
+                          uint64_t offset, uint64_t size)
+{
+   if (size > heap->cache_max_size)
+      return false;
+
+   struct util_vma_cache_bin *bin =
+      &heap->cache_bins[util_logbase2_64(size)];
+   if (bin->num_ranges >= UTIL_VMA_CACHE_BIN_MAX_RANGES)
+      return false;
+
+   struct util_vma_hole *range = malloc(sizeof(*range));
+   if (!range)
+      return false;
+
+   range->offset = offset;
+   range->size = size;
+
+   /* Most recently freed first, it's the most likely to be reused. */
+   list_add(&range->link, &bin->ranges);
+   bin->num_ranges++;
+   heap->cached_size += size;
+   heap->free_size += size;
+
+   return true;
 }
 
 #ifndef NDEBUG
@@ -96,7 +230,7 @@ util_vma_heap_validate(struct util_vma_heap *heap)
       prev_offset = hole->offset;
    }
 
-   assert(free_size == heap->free_size);
+   assert(free_size + heap->cached_size == heap->free_size);
 }
 #else
 #define util_vma_heap_validate(heap)
@@ -153,16 +287,10 @@ util_vma_hole_alloc(struct util_vma_heap *heap,
    heap->free_size -= size;
 }
 
-uint64_t
-util_vma_heap_alloc(struct util_vma_heap *heap,
-                    uint64_t size, uint64_t alignment)
+static uint64_t
+util_vma_heap_alloc_hole(struct util_vma_heap *heap,
+                         uint64_t size, uint64_t alignment)
 {
-   /* The caller is expected to reject zero-size allocations */
-   assert(size > 0);
-   assert(alignment > 0);
-
-   util_vma_heap_validate(heap);
-
    /* The requested alignment should not be stronger than the block/nospan
     * alignment.
     */
@@ -205,7 +333,6 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
             continue;
 
          util_vma_hole_alloc(heap, hole, offset, size);
-         util_vma_heap_validate(heap);
          return offset;
       }
    } else {
@@ -236,7 +363,6 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
          }
 
          util_vma_hole_alloc(heap, hole, offset, size);
-         util_vma_heap_validate(heap);
          return offset;
       }
    }
@@ -245,6 +371,31 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
    return 0;
 }
 
+uint64_t
+util_vma_heap_alloc(struct util_vma_heap *heap,
+                    uint64_t size, uint64_t alignment)
+{
+   /* The caller is expected to reject zero-size allocations */
+   assert(size > 0);
+   assert(alignment > 0);
+
+   util_vma_heap_validate(heap);
+
+   uint64_t offset = util_vma_heap_alloc_cached(heap, size, alignment);
+   if (offset)
+      return offset;
+
+   offset = util_vma_heap_alloc_hole(heap, size, alignment);
+   if (!offset && heap->cached_size) {
+      /* The space we need may be held by the cache, give it back. */
+      util_vma_heap_flush_cache(heap);
+      offset = util_vma_heap_alloc_hole(heap, size, alignment);
+   }
+
+   util_vma_heap_validate(heap);
+   return offset;
+}
+
 bool
 util_vma_heap_alloc_addr(struct util_vma_heap *heap,
                          uint64_t offset, uint64_t size)
@@ -262,6 +413,9 @@ util_vma_heap_alloc_addr(struct util_vma_heap *heap,
     */
    assert(offset + size == 0 || offset + size > offset);
 
+   /* The range may be held by the cache. */
+   util_vma_heap_flush_cache(heap);
+
    /* Find the hole if one exists. */
    util_vma_foreach_hole_safe(hole, heap) {
       if (hole->offset > offset)
@@ -283,25 +437,10 @@ util_vma_heap_alloc_addr(struct util_vma_heap *heap,
    return false;
 }
 
-void
-util_vma_heap_free(struct util_vma_heap *heap,
-                   uint64_t offset, uint64_t size)
+static void
+util_vma_heap_free_hole(struct util_vma_heap *heap,
+                        uint64_t offset, uint64_t size)
 {
-   /* An offset of 0 is reserved for allocation failure.  It is not a valid
-    * address and cannot be freed.
-    */
-   assert(offset > 0);
-
-   /* Freeing something with a size of 0 is also not valid. */
-   assert(size > 0);
-
-   /* It's possible for offset + size to wrap around if we touch the top of
-    * the 64-bit address space, but we cannot go any higher than 2^64.
-    */
-   assert(offset + size == 0 || offset + size > offset);
-
-   util_vma_heap_validate(heap);
-
    /* Find immediately higher and lower holes if they exist. */
    struct util_vma_hole *high_hole = NULL, *low_hole = NULL;
    util_vma_foreach_hole(hole, heap) {
@@ -349,12 +488,38 @@ util_vma_heap_free(struct util_vma_heap *heap,
    }
 
    heap->free_size += size;
+}
+
+void
+util_vma_heap_free(struct util_vma_heap *heap,
+                   uint64_t offset, uint64_t size)
+{
+   /* An offset of 0 is reserved for allocation failure.  It is not a valid
+    * address and cannot be freed.
+    */
+   assert(offset > 0);
+
+   /* Freeing something with a size of 0 is also not valid. */
+   assert(size > 0);
+
+   /* It's possible for offset + size to wrap around if we touch the top of
+    * the 64-bit address space, but we cannot go any higher than 2^64.
+    */
+   assert(offset + size == 0 || offset + size > offset);
+
+   util_vma_heap_validate(heap);
+
+   if (!util_vma_heap_free_cached(heap, offset, size))
+      util_vma_heap_free_hole(heap, offset, size);
+
    util_vma_heap_validate(heap);
 }
 
 uint64_t
 util_vma_heap_get_max_free_continuous_size(struct util_vma_heap *heap)
 {
+   util_vma_heap_flush_cache(heap);
+
    if (list_is_empty(&heap->holes))
       return 0;
 
@@ -368,6 +533,8 @@ util_vma_heap_print(struct util_vma_heap *heap, FILE *fp,
 {
    fprintf(fp, "%sutil_vma_heap:\n", tab);
 
+   util_vma_heap_flush_cache(heap);
+
    uint64_t total_free = 0;
    util_vma_foreach_hole(hole, heap) {
       fprintf(fp, "%s    hole: offset = %"PRIu64" (0x%"PRIx64"), "
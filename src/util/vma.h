@@ -33,12 +33,21 @@
 extern "C" {
 #endif
 
+struct util_vma_cache_bin;
+
 struct util_vma_heap {
    struct list_head holes;
 
-   /** Total size of free memory. */
+   /** Total size of free memory, including the cached ranges. */
    uint64_t free_size;
 
+   /**
+    * Free ranges cached by size class, see util_vma_heap_enable_cache().
+    */
+   struct util_vma_cache_bin *cache_bins;
+   uint64_t cache_max_size;
+   uint64_t cached_size;
+
    /** If true, util_vma_heap_alloc will prefer high addresses
     *
     * Default is true.
@@ -57,6 +66,9 @@ void util_vma_heap_init(struct util_vma_heap *heap,
                         uint64_t start, uint64_t size);
 void util_vma_heap_finish(struct util_vma_heap *heap);
 
+void util_vma_heap_enable_cache(struct util_vma_heap *heap,
+                                uint64_t max_size);
+
 uint64_t util_vma_heap_alloc(struct util_vma_heap *heap,
                              uint64_t size, uint64_t alignment);
 
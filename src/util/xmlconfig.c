@@ -60,6 +60,12 @@ static inline void regfree(regex_t* r) {}
 #include "u_process.h"
 #include "os_file.h"
 #include "os_misc.h"
+#if WITH_XMLCONFIG
+#include "hash_table.h"
+#include "ralloc.h"
+#include "simple_mtx.h"
+#include "u_dynarray.h"
+#endif
 
 /* For systems like Hurd */
 #ifndef PATH_MAX
@@ -559,43 +565,21 @@ __driUtilMessage(const char *f, ...)
    }
 }
 
-/* We don't have real line/column # info in static-config case: */
-#if !WITH_XML_CONFIG
-#  define XML_GetCurrentLineNumber(p) -1
-#  define XML_GetCurrentColumnNumber(p) -1
-#endif
-
 /** \brief Output a warning message. */
 #define XML_WARNING1(msg) do {                                          \
       __driUtilMessage("Warning in %s line %d, column %d: "msg, data->name, \
-                        (int) XML_GetCurrentLineNumber(data->parser),   \
-                        (int) XML_GetCurrentColumnNumber(data->parser)); \
+                        data->line, data->column);                      \
    } while (0)
 #define XML_WARNING(msg, ...) do {                                      \
       __driUtilMessage("Warning in %s line %d, column %d: "msg, data->name, \
-                        (int) XML_GetCurrentLineNumber(data->parser),   \
-                        (int) XML_GetCurrentColumnNumber(data->parser), \
-                        ##__VA_ARGS__);                                 \
-   } while (0)
-/** \brief Output an error message. */
-#define XML_ERROR1(msg) do {                                            \
-      __driUtilMessage("Error in %s line %d, column %d: "msg, data->name, \
-                        (int) XML_GetCurrentLineNumber(data->parser),   \
-                        (int) XML_GetCurrentColumnNumber(data->parser)); \
-   } while (0)
-#define XML_ERROR(msg, ...) do {                                        \
-      __driUtilMessage("Error in %s line %d, column %d: "msg, data->name, \
-                        (int) XML_GetCurrentLineNumber(data->parser),   \
-                        (int) XML_GetCurrentColumnNumber(data->parser), \
-                        ##__VA_ARGS__);                                 \
+                        data->line, data->column, ##__VA_ARGS__);       \
    } while (0)
 
 /** \brief Parser context for configuration files. */
 struct OptConfData {
    const char *name;
-#if WITH_XMLCONFIG
-   XML_Parser parser;
-#endif
+   /* Position of the current element, -1 in the static-config case. */
+   int line, column;
    driOptionCache *cache;
    int screenNum;
    const char *driverName, *execName;
@@ -942,23 +926,106 @@ optConfEndElem(void *userData, const char *name)
    }
 }
 
+/* Parsing the configuration files is a big part of screen creation, and
+ * the same files are parsed over and over again: by the loader, for each
+ * screen and for each Vulkan instance and device.  So the elements of each
+ * file (and the files of each directory) are recorded the first time, and
+ * replayed as long as the file doesn't change.
+ */
+
+/** \brief Recorded element of a configuration file. */
+struct OptConfElemRecord {
+   const char *name;
+   /* NULL for an end element. */
+   const char **attr;
+   int line, column;
+};
+
+/** \brief Recorded configuration file or directory. */
+struct OptConfRecord {
+   /* What stat() returned when it was recorded. */
+   bool exists;
+   ino_t ino;
+   off_t size;
+   time_t mtime;
+
+   /* OptConfElemRecord for a file, file names (char *) for a directory. */
+   struct util_dynarray elems;
+};
+
+/** \brief Context of the expat callbacks recording an OptConfRecord. */
+struct OptConfRecorder {
+   XML_Parser parser;
+   struct OptConfRecord *record;
+};
+
+static simple_mtx_t conf_records_mtx = SIMPLE_MTX_INITIALIZER;
+static struct hash_table *conf_records;
+
+static void
+destroyConfRecords(void)
+{
+   ralloc_free(conf_records);
+   conf_records = NULL;
+}
+
+static void
+recordElem(struct OptConfRecorder *rec, const char *name, const char **attr)
+{
+   struct OptConfElemRecord elem = {
+      .name = ralloc_strdup(rec->record, name),
+      .line = XML_GetCurrentLineNumber(rec->parser),
+      .column = XML_GetCurrentColumnNumber(rec->parser),
+   };
+
+   if (attr) {
+      unsigned n = 0;
+      while (attr[n])
+         n++;
+
+      elem.attr = ralloc_array(rec->record, const char *, n + 1);
+      for (unsigned i = 0; i < n; i++)
+         elem.attr[i] = ralloc_strdup(rec->record, attr[i]);
+      elem.attr[n] = NULL;
+   }
+
+   util_dynarray_append(&rec->record->elems, struct OptConfElemRecord, elem);
+}
+
+static void
+recordStartElem(void *userData, const char *name, const char **attr)
+{
+   recordElem(userData, name, attr);
+}
+
+static void
+recordEndElem(void *userData, const char *name)
+{
+   recordElem(userData, name, NULL);
+}
+
+/** \brief Record the elements of the named configuration file */
 static void
-_parseOneConfigFile(XML_Parser p)
+recordConfigFile(struct OptConfRecord *record, const char *filename)
 {
 #define BUF_SIZE 0x1000
-   struct OptConfData *data = (struct OptConfData *)XML_GetUserData(p);
+   struct OptConfRecorder rec = { .record = record };
    int status;
    int fd;
 
-   if ((fd = open(data->name, O_RDONLY)) == -1) {
+   if ((fd = open(filename, O_RDONLY)) == -1) {
       __driUtilMessage("Can't open configuration file %s: %s.",
-                       data->name, strerror(errno));
+                       filename, strerror(errno));
       return;
    }
 
+   rec.parser = XML_ParserCreate(NULL); /* use encoding specified by file */
+   XML_SetElementHandler(rec.parser, recordStartElem, recordEndElem);
+   XML_SetUserData(rec.parser, &rec);
+
    while (1) {
       int bytesRead;
-      void *buffer = XML_GetBuffer(p, BUF_SIZE);
+      void *buffer = XML_GetBuffer(rec.parser, BUF_SIZE);
       if (!buffer) {
          __driUtilMessage("Can't allocate parser buffer.");
          break;
@@ -966,32 +1033,104 @@ _parseOneConfigFile(XML_Parser p)
       bytesRead = read(fd, buffer, BUF_SIZE);
       if (bytesRead == -1) {
          __driUtilMessage("Error reading from configuration file %s: %s.",
-                          data->name, strerror(errno));
+                          filename, strerror(errno));
          break;
       }
-      status = XML_ParseBuffer(p, bytesRead, bytesRead == 0);
+      status = XML_ParseBuffer(rec.parser, bytesRead, bytesRead == 0);
       if (!status) {
-         XML_ERROR("%s.", XML_ErrorString(XML_GetErrorCode(p)));
+         __driUtilMessage("Error in %s line %d, column %d: %s.", filename,
+                          (int) XML_GetCurrentLineNumber(rec.parser),
+                          (int) XML_GetCurrentColumnNumber(rec.parser),
+                          XML_ErrorString(XML_GetErrorCode(rec.parser)));
          break;
       }
       if (bytesRead == 0)
          break;
    }
 
+   XML_ParserFree(rec.parser);
    close(fd);
 #undef BUF_SIZE
 }
 
+static void
+recordConfigDir(struct OptConfRecord *record, const char *dirname);
+
+/**
+ * \brief Get the record of a configuration file or directory, recording it
+ * if it's not known yet or changed since.
+ *
+ * Records are never freed before exit, so they can be used without holding
+ * the lock.
+ */
+static const struct OptConfRecord *
+getConfRecord(const char *path, bool is_dir)
+{
+   struct OptConfRecord *record = NULL;
+   struct stat st;
+   const bool exists = stat(path, &st) == 0;
+
+   simple_mtx_lock(&conf_records_mtx);
+
+   if (!conf_records) {
+      conf_records = _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                             _mesa_key_string_equal);
+      if (!conf_records)
+         goto out;
+
+      atexit(destroyConfRecords);
+   }
+
+   struct hash_entry *entry = _mesa_hash_table_search(conf_records, path);
+   if (entry) {
+      record = entry->data;
+      if (record->exists == exists &&
+          (!exists || (record->ino == st.st_ino &&
+                       record->size == st.st_size &&
+                       record->mtime == st.st_mtime)))
+         goto out;
+   }
+
+   record = rzalloc(conf_records, struct OptConfRecord);
+   if (!record)
+      goto out;
+
+   util_dynarray_init(&record->elems, record);
+   record->exists = exists;
+   if (exists) {
+      record->ino = st.st_ino;
+      record->size = st.st_size;
+      record->mtime = st.st_mtime;
+   }
+
+   if (is_dir)
+      recordConfigDir(record, path);
+   else
+      recordConfigFile(record, path);
+
+   /* A replaced record may still be in use by another thread, it's freed
+    * together with the others at exit.
+    */
+   if (entry)
+      entry->data = record;
+   else
+      _mesa_hash_table_insert(conf_records, ralloc_strdup(conf_records, path),
+                              record);
+
+out:
+   simple_mtx_unlock(&conf_records_mtx);
+
+   return record;
+}
+
 /** \brief Parse the named configuration file */
 static void
 parseOneConfigFile(struct OptConfData *data, const char *filename)
 {
-   XML_Parser p;
+   const struct OptConfRecord *record = getConfRecord(filename, false);
+   if (!record)
+      return;
 
-   p = XML_ParserCreate(NULL); /* use encoding specified by file */
-   XML_SetElementHandler(p, optConfStartElem, optConfEndElem);
-   XML_SetUserData(p, data);
-   data->parser = p;
    data->name = filename;
    data->ignoringDevice = 0;
    data->ignoringApp = 0;
@@ -1000,8 +1139,15 @@ parseOneConfigFile(struct OptConfData *data, const char *filename)
    data->inApp = 0;
    data->inOption = 0;
 
-   _parseOneConfigFile(p);
-   XML_ParserFree(p);
+   util_dynarray_foreach(&record->elems, struct OptConfElemRecord, elem) {
+      data->line = elem->line;
+      data->column = elem->column;
+
+      if (elem->attr)
+         optConfStartElem(data, elem->name, elem->attr);
+      else
+         optConfEndElem(data, elem->name);
+   }
 }
 
 static int
@@ -1028,9 +1174,9 @@ scandir_filter(const struct dirent *ent)
    return 1;
 }
 
-/** \brief Parse configuration files in a directory */
+/** \brief Record the configuration files in a directory */
 static void
-parseConfigDir(struct OptConfData *data, const char *dirname)
+recordConfigDir(struct OptConfRecord *record, const char *dirname)
 {
    int i, count;
    struct dirent **entries = NULL;
@@ -1061,11 +1207,24 @@ parseConfigDir(struct OptConfData *data, const char *dirname)
       }
 #endif
 
-      parseOneConfigFile(data, filename);
+      util_dynarray_append(&record->elems, char *,
+                           ralloc_strdup(record, filename));
    }
 
    free(entries);
 }
+
+/** \brief Parse configuration files in a directory */
+static void
+parseConfigDir(struct OptConfData *data, const char *dirname)
+{
+   const struct OptConfRecord *record = getConfRecord(dirname, true);
+   if (!record)
+      return;
+
+   util_dynarray_foreach(&record->elems, char *, filename)
+      parseOneConfigFile(data, *filename);
+}
 #else
 #  include "driconf_static.h"
 
@@ -1088,6 +1247,9 @@ parseStaticOptions(struct OptConfData *data, const struct driconf_option *option
 static void
 parseStaticConfig(struct OptConfData *data)
 {
+   /* We don't have real line/column # info in static-config case: */
+   data->line = -1;
+   data->column = -1;
    data->ignoringDevice = 0;
    data->ignoringApp = 0;
    data->inDriConf = 0;
@@ -421,8 +421,15 @@ vn_GetBufferDeviceAddress(VkDevice device,
                           const VkBufferDeviceAddressInfo *pInfo)
 {
    struct vn_device *dev = vn_device_from_handle(device);
+   struct vn_buffer *buf = vn_buffer_from_handle(pInfo->buffer);
 
-   return vn_call_vkGetBufferDeviceAddress(dev->primary_ring, device, pInfo);
+   /* Some apps query this every frame, avoid a renderer round trip each. */
+   if (!buf->device_address) {
+      buf->device_address =
+         vn_call_vkGetBufferDeviceAddress(dev->primary_ring, device, pInfo);
+   }
+
+   return buf->device_address;
 }
 
 uint64_t
@@ -48,6 +48,9 @@ struct vn_buffer {
    struct vn_object_base base;
 
    struct vn_buffer_memory_requirements requirements;
+
+   /* Lazily queried, a bound buffer's address never changes. */
+   VkDeviceAddress device_address;
 };
 VK_DEFINE_NONDISP_HANDLE_CASTS(vn_buffer,
                                base.base,
@@ -69,6 +69,20 @@ struct vk_meta_device {
                            struct vk_meta_device *meta,
                            const struct vk_meta_rect *rect,
                            uint32_t layer_count);
+
+   /** Optional: return true to write dst_image with a compute shader
+    *
+    * This is asked by color blits, resolves and image clears.  When it
+    * returns true, the destination is bound as a storage image with
+    * dst_format and the operation is done with vkCmdDispatch() instead of
+    * a rendering pass, which also makes it usable on compute-only queues.
+    * The driver is then responsible for saving and restoring its compute
+    * state around the meta operation instead of its graphics state.
+    */
+   bool (*cmd_use_compute)(struct vk_command_buffer *cmd,
+                           struct vk_meta_device *meta,
+                           const struct vk_image *dst_image,
+                           VkFormat dst_format);
 };
 
 VkResult vk_meta_device_init(struct vk_device *device,
@@ -82,6 +96,7 @@ enum vk_meta_object_key_type {
    VK_META_OBJECT_KEY_CLEAR_PIPELINE,
    VK_META_OBJECT_KEY_BLIT_PIPELINE,
    VK_META_OBJECT_KEY_BLIT_SAMPLER,
+   VK_META_OBJECT_KEY_CLEAR_IMAGE_COMPUTE_PIPELINE,
 };
 
 uint64_t vk_meta_lookup_object(struct vk_meta_device *meta,
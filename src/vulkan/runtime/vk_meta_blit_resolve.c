@@ -39,6 +39,8 @@ struct vk_meta_blit_key {
    bool stencil_as_discard;
    VkFormat dst_format;
    VkImageAspectFlags aspects;
+   bool use_compute;
+   enum glsl_sampler_dim dst_dim;
 };
 
 static enum glsl_sampler_dim
@@ -61,6 +63,7 @@ enum blit_desc_binding {
    BLIT_DESC_BINDING_COLOR,
    BLIT_DESC_BINDING_DEPTH,
    BLIT_DESC_BINDING_STENCIL,
+   BLIT_DESC_BINDING_DST,
 };
 
 static enum blit_desc_binding
@@ -79,6 +82,10 @@ struct vk_meta_blit_push_data {
    float z_off, z_scale;
    int32_t arr_delta;
    uint32_t stencil_bit;
+
+   /* Only used by the compute path */
+   uint32_t dst_x0, dst_y0, dst_x1, dst_y1;
+   uint32_t dst_layer;
 };
 
 static inline void
@@ -189,22 +196,62 @@ build_tex_resolve(nir_builder *b, nir_deref_instr *t,
    return accum;
 }
 
+static void
+build_compute_store(nir_builder *b, const struct vk_meta_blit_key *key,
+                    enum glsl_base_type base_type,
+                    nir_def *dst_pixel, nir_def *dst_layer, nir_def *val)
+{
+   assert(key->aspects == VK_IMAGE_ASPECT_COLOR_BIT);
+
+   const bool is_array = key->dst_dim != GLSL_SAMPLER_DIM_3D;
+   const struct glsl_type *image_type =
+      glsl_image_type(key->dst_dim, is_array, base_type);
+   nir_variable *image = nir_variable_create(b->shader, nir_var_image,
+                                             image_type, "dst_img");
+   image->data.descriptor_set = 0;
+   image->data.binding = BLIT_DESC_BINDING_DST;
+   image->data.access = ACCESS_NON_READABLE;
+   image->data.image.format = vk_format_to_pipe_format(key->dst_format);
+
+   nir_def *coord;
+   if (key->dst_dim == GLSL_SAMPLER_DIM_1D) {
+      coord = nir_vec2(b, nir_channel(b, dst_pixel, 0), dst_layer);
+   } else {
+      coord = nir_vec3(b, nir_channel(b, dst_pixel, 0),
+                          nir_channel(b, dst_pixel, 1), dst_layer);
+   }
+
+   nir_image_deref_store(b, &nir_build_deref_var(b, image)->def,
+                         nir_pad_vector(b, coord, 4), nir_undef(b, 1, 32),
+                         val, nir_imm_int(b, 0),
+                         .image_dim = key->dst_dim,
+                         .image_array = is_array);
+}
+
 static nir_shader *
 build_blit_shader(const struct vk_meta_blit_key *key)
 {
+   const gl_shader_stage stage = key->use_compute ? MESA_SHADER_COMPUTE :
+                                                    MESA_SHADER_FRAGMENT;
    nir_builder build;
    if (key->resolve_mode || key->stencil_resolve_mode) {
-      build = nir_builder_init_simple_shader(MESA_SHADER_FRAGMENT, NULL,
-                                             "vk-meta-resolve");
+      build = nir_builder_init_simple_shader(stage, NULL, "vk-meta-resolve");
    } else {
-      build = nir_builder_init_simple_shader(MESA_SHADER_FRAGMENT,
-                                             NULL, "vk-meta-blit");
+      build = nir_builder_init_simple_shader(stage, NULL, "vk-meta-blit");
    }
    nir_builder *b = &build;
 
+   if (key->use_compute) {
+      b->shader->info.workgroup_size[0] = 8;
+      b->shader->info.workgroup_size[1] = 8;
+      b->shader->info.workgroup_size[2] = 1;
+   }
+
    struct glsl_struct_field push_fields[] = {
       { .type = glsl_vec4_type(), .name = "xy_xform", .offset = 0 },
       { .type = glsl_vec4_type(), .name = "z_xform", .offset = 16 },
+      { .type = glsl_uvec4_type(), .name = "dst_rect", .offset = 32 },
+      { .type = glsl_uint_type(), .name = "dst_layer", .offset = 48 },
    };
    const struct glsl_type *push_iface_type =
       glsl_interface_type(push_fields, ARRAY_SIZE(push_fields),
@@ -217,12 +264,27 @@ build_blit_shader(const struct vk_meta_blit_key *key)
    nir_def *xy_off = nir_channels(b, xy_xform, 3 << 0);
    nir_def *xy_scale = nir_channels(b, xy_xform, 3 << 2);
 
-   nir_def *out_coord_xy = nir_load_frag_coord(b);
-   out_coord_xy = nir_trim_vector(b, out_coord_xy, 2);
+   nir_def *out_coord_xy, *out_layer, *dst_pixel = NULL;
+   if (key->use_compute) {
+      nir_def *dst_rect = load_struct_var(b, push, 2);
+      nir_def *id = nir_load_global_invocation_id(b, 32);
+
+      dst_pixel = nir_iadd(b, nir_trim_vector(b, id, 2),
+                              nir_channels(b, dst_rect, 3 << 0));
+      nir_push_if(b, nir_ball(b, nir_ult(b, dst_pixel,
+                                            nir_channels(b, dst_rect, 3 << 2))));
+
+      out_coord_xy = nir_fadd_imm(b, nir_u2f32(b, dst_pixel), 0.5);
+      out_layer = nir_iadd(b, nir_channel(b, id, 2),
+                              load_struct_var(b, push, 3));
+   } else {
+      out_coord_xy = nir_load_frag_coord(b);
+      out_coord_xy = nir_trim_vector(b, out_coord_xy, 2);
+      out_layer = nir_load_layer_id(b);
+   }
    nir_def *src_coord_xy = nir_ffma(b, out_coord_xy, xy_scale, xy_off);
 
    nir_def *z_xform = load_struct_var(b, push, 1);
-   nir_def *out_layer = nir_load_layer_id(b);
    nir_def *src_coord;
    if (key->dim == GLSL_SAMPLER_DIM_3D) {
       nir_def *z_off = nir_channel(b, z_xform, 0);
@@ -312,7 +374,9 @@ build_blit_shader(const struct vk_meta_blit_key *key)
       }
       val = nir_trim_vector(b, val, out_comps);
 
-      if (key->stencil_as_discard) {
+      if (key->use_compute) {
+         build_compute_store(b, key, base_type, dst_pixel, out_layer, val);
+      } else if (key->stencil_as_discard) {
          assert(key->aspects == VK_IMAGE_ASPECT_STENCIL_BIT);
          nir_def *stencil_bit = nir_channel(b, z_xform, 3);
          nir_discard_if(b, nir_ieq(b, nir_iand(b, val, stencil_bit),
@@ -328,53 +392,75 @@ build_blit_shader(const struct vk_meta_blit_key *key)
       }
    }
 
+   if (key->use_compute)
+      nir_pop_if(b, NULL);
+
    return b->shader;
 }
 
 static VkResult
 get_blit_pipeline_layout(struct vk_device *device,
                          struct vk_meta_device *meta,
+                         bool use_compute,
                          VkPipelineLayout *layout_out)
 {
-   const char key[] = "vk-meta-blit-pipeline-layout";
+   const char gfx_key[] = "vk-meta-blit-pipeline-layout";
+   const char cs_key[] = "vk-meta-blit-cs-pipeline-layout";
+   const VkShaderStageFlags stage = use_compute ?
+                                    VK_SHADER_STAGE_COMPUTE_BIT :
+                                    VK_SHADER_STAGE_FRAGMENT_BIT;
 
    const VkDescriptorSetLayoutBinding bindings[] = {{
       .binding = BLIT_DESC_BINDING_SAMPLER,
       .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
       .descriptorCount = 1,
-      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .stageFlags = stage,
    }, {
       .binding = BLIT_DESC_BINDING_COLOR,
       .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
       .descriptorCount = 1,
-      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .stageFlags = stage,
    }, {
       .binding = BLIT_DESC_BINDING_DEPTH,
       .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
       .descriptorCount = 1,
-      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .stageFlags = stage,
    }, {
       .binding = BLIT_DESC_BINDING_STENCIL,
       .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
       .descriptorCount = 1,
-      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .stageFlags = stage,
+   }, {
+      .binding = BLIT_DESC_BINDING_DST,
+      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      .descriptorCount = 1,
+      .stageFlags = stage,
    }};
 
+   /* The storage image binding only exists in the compute layout */
    const VkDescriptorSetLayoutCreateInfo desc_info = {
       .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
       .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
-      .bindingCount = ARRAY_SIZE(bindings),
+      .bindingCount = use_compute ? ARRAY_SIZE(bindings) :
+                                    ARRAY_SIZE(bindings) - 1,
       .pBindings = bindings,
    };
 
    const VkPushConstantRange push_range = {
-      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+      .stageFlags = stage,
       .offset = 0,
       .size = sizeof(struct vk_meta_blit_push_data),
    };
 
-   return vk_meta_get_pipeline_layout(device, meta, &desc_info, &push_range,
-                                      key, sizeof(key), layout_out);
+   if (use_compute) {
+      return vk_meta_get_pipeline_layout(device, meta, &desc_info,
+                                         &push_range, cs_key, sizeof(cs_key),
+                                         layout_out);
+   } else {
+      return vk_meta_get_pipeline_layout(device, meta, &desc_info,
+                                         &push_range, gfx_key, sizeof(gfx_key),
+                                         layout_out);
+   }
 }
 
 static VkResult
@@ -390,6 +476,30 @@ get_blit_pipeline(struct vk_device *device,
       return VK_SUCCESS;
    }
 
+   if (key->use_compute) {
+      const VkPipelineShaderStageNirCreateInfoMESA cs_nir_info = {
+         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_NIR_CREATE_INFO_MESA,
+         .nir = build_blit_shader(key),
+      };
+      const VkComputePipelineCreateInfo info = {
+         .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+         .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext = &cs_nir_info,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .pName = "main",
+         },
+         .layout = layout,
+      };
+
+      VkResult result = vk_meta_create_compute_pipeline(device, meta, &info,
+                                                        key, sizeof(*key),
+                                                        pipeline_out);
+      ralloc_free(cs_nir_info.nir);
+
+      return result;
+   }
+
    const VkPipelineShaderStageNirCreateInfoMESA fs_nir_info = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_NIR_CREATE_INFO_MESA,
       .nir = build_blit_shader(key),
@@ -491,6 +601,96 @@ get_blit_sampler(struct vk_device *device,
                                  &key, sizeof(key), sampler_out);
 }
 
+static void
+do_blit_compute(struct vk_command_buffer *cmd,
+                struct vk_meta_device *meta,
+                struct vk_image *dst_image,
+                VkFormat dst_format,
+                VkImageLayout dst_image_layout,
+                VkImageSubresourceLayers dst_subres,
+                VkPipelineLayout pipeline_layout,
+                struct vk_meta_blit_key *key,
+                struct vk_meta_blit_push_data *push,
+                const struct vk_meta_rect *dst_rect,
+                uint32_t dst_layer_count,
+                uint32_t desc_count,
+                VkDescriptorImageInfo *image_infos,
+                VkWriteDescriptorSet *desc_writes)
+{
+   struct vk_device *device = cmd->base.device;
+   const struct vk_device_dispatch_table *disp = &device->dispatch_table;
+   VkCommandBuffer _cmd = vk_command_buffer_to_handle(cmd);
+   VkResult result;
+
+   assert(dst_subres.aspectMask == VK_IMAGE_ASPECT_COLOR_BIT);
+   key->aspects = VK_IMAGE_ASPECT_COLOR_BIT;
+
+   VkImageView dst_view;
+   const VkImageViewUsageCreateInfo dst_view_usage = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+      .usage = VK_IMAGE_USAGE_STORAGE_BIT,
+   };
+   const VkImageViewCreateInfo dst_view_info = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+      .pNext = &dst_view_usage,
+      .image = vk_image_to_handle(dst_image),
+      .viewType = vk_image_sampled_view_type(dst_image),
+      .format = dst_format,
+      .subresourceRange = {
+         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+         .baseMipLevel = dst_subres.mipLevel,
+         .levelCount = 1,
+         .baseArrayLayer = dst_subres.baseArrayLayer,
+         .layerCount = dst_subres.layerCount,
+      },
+   };
+   result = vk_meta_create_image_view(cmd, meta, &dst_view_info, &dst_view);
+   if (unlikely(result != VK_SUCCESS)) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   image_infos[desc_count] = (VkDescriptorImageInfo) {
+      .imageView = dst_view,
+      .imageLayout = dst_image_layout,
+   };
+   desc_writes[desc_count] = (VkWriteDescriptorSet) {
+      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+      .dstBinding = BLIT_DESC_BINDING_DST,
+      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      .descriptorCount = 1,
+      .pImageInfo = &image_infos[desc_count],
+   };
+   desc_count++;
+
+   VkPipeline pipeline;
+   result = get_blit_pipeline(device, meta, key, pipeline_layout, &pipeline);
+   if (unlikely(result != VK_SUCCESS)) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   disp->CmdBindPipeline(_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+   disp->CmdPushDescriptorSetKHR(_cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                 pipeline_layout, 0,
+                                 desc_count, desc_writes);
+
+   push->dst_x0 = dst_rect->x0;
+   push->dst_y0 = dst_rect->y0;
+   push->dst_x1 = dst_rect->x1;
+   push->dst_y1 = dst_rect->y1;
+   push->dst_layer = dst_rect->layer;
+
+   disp->CmdPushConstants(_cmd, pipeline_layout,
+                          VK_SHADER_STAGE_COMPUTE_BIT,
+                          0, sizeof(*push), push);
+
+   disp->CmdDispatch(_cmd, DIV_ROUND_UP(dst_rect->x1 - dst_rect->x0, 8),
+                           DIV_ROUND_UP(dst_rect->y1 - dst_rect->y0, 8),
+                           dst_layer_count);
+}
+
 static void
 do_blit(struct vk_command_buffer *cmd,
         struct vk_meta_device *meta,
@@ -513,7 +713,8 @@ do_blit(struct vk_command_buffer *cmd,
    VkResult result;
 
    VkPipelineLayout pipeline_layout;
-   result = get_blit_pipeline_layout(device, meta, &pipeline_layout);
+   result = get_blit_pipeline_layout(device, meta, key->use_compute,
+                                     &pipeline_layout);
    if (unlikely(result != VK_SUCCESS)) {
       vk_command_buffer_set_error(cmd, result);
       return;
@@ -581,6 +782,13 @@ do_blit(struct vk_command_buffer *cmd,
       desc_count++;
    }
 
+   if (key->use_compute) {
+      do_blit_compute(cmd, meta, dst_image, dst_format, dst_image_layout,
+                      dst_subres, pipeline_layout, key, push, dst_rect,
+                      dst_layer_count, desc_count, image_infos, desc_writes);
+      return;
+   }
+
    disp->CmdPushDescriptorSetKHR(vk_command_buffer_to_handle(cmd),
                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
                                  pipeline_layout, 0,
@@ -735,6 +943,9 @@ vk_meta_blit_image(struct vk_command_buffer *cmd,
    key.src_samples = src_image->samples;
    key.dim = vk_image_sampler_dim(src_image);
    key.dst_format = dst_format;
+   key.use_compute = vk_meta_use_compute(cmd, meta, dst_image, dst_format);
+   if (key.use_compute)
+      key.dst_dim = vk_image_sampler_dim(dst_image);
 
    for (uint32_t r = 0; r < region_count; r++) {
       struct vk_meta_blit_push_data push = {0};
@@ -828,6 +1039,9 @@ vk_meta_resolve_image(struct vk_command_buffer *cmd,
    key.resolve_mode = resolve_mode;
    key.stencil_resolve_mode = stencil_resolve_mode;
    key.dst_format = dst_format;
+   key.use_compute = vk_meta_use_compute(cmd, meta, dst_image, dst_format);
+   if (key.use_compute)
+      key.dst_dim = vk_image_sampler_dim(dst_image);
 
    for (uint32_t r = 0; r < region_count; r++) {
       struct vk_meta_blit_push_data push = {
@@ -557,6 +557,276 @@ clear_image_level(struct vk_command_buffer *cmd,
    }
 }
 
+struct vk_meta_clear_image_key {
+   enum vk_meta_object_key_type key_type;
+   enum glsl_sampler_dim dim;
+   VkFormat format;
+};
+
+struct vk_meta_clear_image_push_data {
+   VkClearColorValue color;
+   uint32_t width, height;
+};
+
+static enum glsl_sampler_dim
+vk_image_storage_dim(const struct vk_image *image)
+{
+   switch (image->image_type) {
+   case VK_IMAGE_TYPE_1D: return GLSL_SAMPLER_DIM_1D;
+   case VK_IMAGE_TYPE_2D: return GLSL_SAMPLER_DIM_2D;
+   case VK_IMAGE_TYPE_3D: return GLSL_SAMPLER_DIM_3D;
+   default: unreachable("Invalid image type");
+   }
+}
+
+static nir_shader *
+build_clear_image_shader(const struct vk_meta_clear_image_key *key)
+{
+   nir_builder build = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE,
+                                                      NULL,
+                                                      "vk-meta-clear-image");
+   nir_builder *b = &build;
+
+   b->shader->info.workgroup_size[0] = 8;
+   b->shader->info.workgroup_size[1] = 8;
+   b->shader->info.workgroup_size[2] = 1;
+
+   struct glsl_struct_field push_fields[] = {
+      { .type = glsl_vec4_type(), .name = "color", .offset = 0 },
+      { .type = glsl_uvec2_type(), .name = "extent", .offset = 16 },
+   };
+   const struct glsl_type *push_iface_type =
+      glsl_interface_type(push_fields, ARRAY_SIZE(push_fields),
+                          GLSL_INTERFACE_PACKING_STD140,
+                          false /* row_major */, "push");
+   nir_variable *push = nir_variable_create(b->shader, nir_var_mem_push_const,
+                                            push_iface_type, "push");
+
+   enum glsl_base_type base_type;
+   if (vk_format_is_sint(key->format))
+      base_type = GLSL_TYPE_INT;
+   else if (vk_format_is_uint(key->format))
+      base_type = GLSL_TYPE_UINT;
+   else
+      base_type = GLSL_TYPE_FLOAT;
+
+   const bool is_array = key->dim != GLSL_SAMPLER_DIM_3D;
+   nir_variable *image =
+      nir_variable_create(b->shader, nir_var_image,
+                          glsl_image_type(key->dim, is_array, base_type),
+                          "dst_img");
+   image->data.descriptor_set = 0;
+   image->data.binding = 0;
+   image->data.access = ACCESS_NON_READABLE;
+   image->data.image.format = vk_format_to_pipe_format(key->format);
+
+   nir_def *color = nir_load_deref(b,
+      nir_build_deref_struct(b, nir_build_deref_var(b, push), 0));
+   nir_def *extent = nir_load_deref(b,
+      nir_build_deref_struct(b, nir_build_deref_var(b, push), 1));
+
+   nir_def *id = nir_load_global_invocation_id(b, 32);
+   nir_push_if(b, nir_ball(b, nir_ult(b, nir_trim_vector(b, id, 2), extent)));
+   {
+      /* The Z invocation ID is the array layer or the 3D slice */
+      nir_def *coord;
+      if (key->dim == GLSL_SAMPLER_DIM_1D) {
+         coord = nir_vec2(b, nir_channel(b, id, 0), nir_channel(b, id, 2));
+      } else {
+         coord = id;
+      }
+
+      nir_image_deref_store(b, &nir_build_deref_var(b, image)->def,
+                            nir_pad_vector(b, coord, 4), nir_undef(b, 1, 32),
+                            color, nir_imm_int(b, 0),
+                            .image_dim = key->dim,
+                            .image_array = is_array);
+   }
+   nir_pop_if(b, NULL);
+
+   return b->shader;
+}
+
+static VkResult
+get_clear_image_pipeline_layout(struct vk_device *device,
+                                struct vk_meta_device *meta,
+                                VkPipelineLayout *layout_out)
+{
+   const char key[] = "vk-meta-clear-image-pipeline-layout";
+
+   const VkDescriptorSetLayoutBinding binding = {
+      .binding = 0,
+      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+      .descriptorCount = 1,
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+   };
+
+   const VkDescriptorSetLayoutCreateInfo desc_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+      .bindingCount = 1,
+      .pBindings = &binding,
+   };
+
+   const VkPushConstantRange push_range = {
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(struct vk_meta_clear_image_push_data),
+   };
+
+   return vk_meta_get_pipeline_layout(device, meta, &desc_info, &push_range,
+                                      key, sizeof(key), layout_out);
+}
+
+static VkResult
+get_clear_image_pipeline(struct vk_device *device,
+                         struct vk_meta_device *meta,
+                         const struct vk_meta_clear_image_key *key,
+                         VkPipelineLayout layout,
+                         VkPipeline *pipeline_out)
+{
+   VkPipeline from_cache = vk_meta_lookup_pipeline(meta, key, sizeof(*key));
+   if (from_cache != VK_NULL_HANDLE) {
+      *pipeline_out = from_cache;
+      return VK_SUCCESS;
+   }
+
+   const VkPipelineShaderStageNirCreateInfoMESA cs_nir_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_NIR_CREATE_INFO_MESA,
+      .nir = build_clear_image_shader(key),
+   };
+   const VkComputePipelineCreateInfo info = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage = {
+         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+         .pNext = &cs_nir_info,
+         .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+         .pName = "main",
+      },
+      .layout = layout,
+   };
+
+   VkResult result = vk_meta_create_compute_pipeline(device, meta, &info,
+                                                     key, sizeof(*key),
+                                                     pipeline_out);
+   ralloc_free(cs_nir_info.nir);
+
+   return result;
+}
+
+static void
+clear_color_image_compute(struct vk_command_buffer *cmd,
+                          struct vk_meta_device *meta,
+                          struct vk_image *image,
+                          VkImageLayout image_layout,
+                          VkFormat format,
+                          const VkClearColorValue *color,
+                          uint32_t range_count,
+                          const VkImageSubresourceRange *ranges)
+{
+   struct vk_device *device = cmd->base.device;
+   const struct vk_device_dispatch_table *disp = &device->dispatch_table;
+   VkCommandBuffer _cmd = vk_command_buffer_to_handle(cmd);
+   VkResult result;
+
+   struct vk_meta_clear_image_key key;
+   memset(&key, 0, sizeof(key));
+   key.key_type = VK_META_OBJECT_KEY_CLEAR_IMAGE_COMPUTE_PIPELINE;
+   key.dim = vk_image_storage_dim(image);
+   key.format = format;
+
+   VkPipelineLayout layout;
+   result = get_clear_image_pipeline_layout(device, meta, &layout);
+   if (unlikely(result != VK_SUCCESS)) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   VkPipeline pipeline;
+   result = get_clear_image_pipeline(device, meta, &key, layout, &pipeline);
+   if (unlikely(result != VK_SUCCESS)) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   disp->CmdBindPipeline(_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+   for (uint32_t r = 0; r < range_count; r++) {
+      const uint32_t level_count =
+         vk_image_subresource_level_count(image, &ranges[r]);
+
+      for (uint32_t l = 0; l < level_count; l++) {
+         const uint32_t level = ranges[r].baseMipLevel + l;
+         const VkExtent3D level_extent =
+            vk_image_mip_level_extent(image, level);
+
+         uint32_t base_array_layer, layer_count, z_count;
+         if (image->image_type == VK_IMAGE_TYPE_3D) {
+            base_array_layer = 0;
+            layer_count = 1;
+            z_count = level_extent.depth;
+         } else {
+            base_array_layer = ranges[r].baseArrayLayer;
+            layer_count = vk_image_subresource_layer_count(image, &ranges[r]);
+            z_count = layer_count;
+         }
+
+         const VkImageViewUsageCreateInfo view_usage = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+            .usage = VK_IMAGE_USAGE_STORAGE_BIT,
+         };
+         const VkImageViewCreateInfo view_info = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = &view_usage,
+            .image = vk_image_to_handle(image),
+            .viewType = vk_image_sampled_view_type(image),
+            .format = format,
+            .subresourceRange = {
+               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+               .baseMipLevel = level,
+               .levelCount = 1,
+               .baseArrayLayer = base_array_layer,
+               .layerCount = layer_count,
+            },
+         };
+
+         VkImageView image_view;
+         result = vk_meta_create_image_view(cmd, meta, &view_info,
+                                            &image_view);
+         if (unlikely(result != VK_SUCCESS)) {
+            vk_command_buffer_set_error(cmd, result);
+            return;
+         }
+
+         const VkDescriptorImageInfo image_info = {
+            .imageView = image_view,
+            .imageLayout = image_layout,
+         };
+         const VkWriteDescriptorSet desc_write = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstBinding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = 1,
+            .pImageInfo = &image_info,
+         };
+         disp->CmdPushDescriptorSetKHR(_cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                       layout, 0, 1, &desc_write);
+
+         const struct vk_meta_clear_image_push_data push = {
+            .color = *color,
+            .width = level_extent.width,
+            .height = level_extent.height,
+         };
+         disp->CmdPushConstants(_cmd, layout, VK_SHADER_STAGE_COMPUTE_BIT,
+                                0, sizeof(push), &push);
+
+         disp->CmdDispatch(_cmd, DIV_ROUND_UP(level_extent.width, 8),
+                                 DIV_ROUND_UP(level_extent.height, 8),
+                                 z_count);
+      }
+   }
+}
+
 void
 vk_meta_clear_color_image(struct vk_command_buffer *cmd,
                           struct vk_meta_device *meta,
@@ -567,6 +837,15 @@ vk_meta_clear_color_image(struct vk_command_buffer *cmd,
                           uint32_t range_count,
                           const VkImageSubresourceRange *ranges)
 {
+   const VkClearValue clear_value = {
+      .color = *color,
+   };
+   if (vk_meta_use_compute(cmd, meta, image, format)) {
+      clear_color_image_compute(cmd, meta, image, image_layout, format,
+                                color, range_count, ranges);
+      return;
+   }
+
    const VkClearValue clear_value = {
       .color = *color,
    };
@@ -80,6 +80,18 @@ vk_image_render_view_type(const struct vk_image *image, uint32_t layer_count)
    }
 }
 
+static inline bool
+vk_meta_use_compute(struct vk_command_buffer *cmd,
+                    struct vk_meta_device *meta,
+                    const struct vk_image *dst_image,
+                    VkFormat dst_format)
+{
+   return dst_image->aspects == VK_IMAGE_ASPECT_COLOR_BIT &&
+          dst_image->samples == 1 &&
+          meta->cmd_use_compute != NULL &&
+          meta->cmd_use_compute(cmd, meta, dst_image, dst_format);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,7 @@
 
 #include "compiler/nir/nir_xfb_info.h"
 #include "compiler/spirv/nir_spirv.h"
+#include "compiler/spirv/spirv.h"
 #include "vk_log.h"
 #include "vk_util.h"
 
@@ -39,6 +40,43 @@ vk_spirv_version(const uint32_t *spirv_data, size_t spirv_size_B)
    return spirv_data[1];
 }
 
+/* Sets used[i] for every entry of spec_info whose constantID is the SpecId
+ * of a specialization constant in the SPIR-V module.  The other entries
+ * don't affect the compiled shader.
+ */
+void
+vk_spirv_find_used_spec_constants(const uint32_t *spirv_data,
+                                  size_t spirv_size_B,
+                                  const VkSpecializationInfo *spec_info,
+                                  bool *used)
+{
+   const uint32_t *w = spirv_data + 5;
+   const uint32_t *end = spirv_data + spirv_size_B / 4;
+
+   memset(used, 0, spec_info->mapEntryCount * sizeof(*used));
+
+   while (w < end) {
+      SpvOp opcode = w[0] & SpvOpCodeMask;
+      unsigned count = w[0] >> SpvWordCountShift;
+      if (count == 0 || w + count > end)
+         break;
+
+      /* Decorations all come before the first function. */
+      if (opcode == SpvOpFunction)
+         break;
+
+      if (opcode == SpvOpDecorate && count >= 4 &&
+          w[2] == SpvDecorationSpecId) {
+         for (uint32_t i = 0; i < spec_info->mapEntryCount; i++) {
+            if (spec_info->pMapEntries[i].constantID == w[3])
+               used[i] = true;
+         }
+      }
+
+      w += count;
+   }
+}
+
 static void
 spirv_nir_debug(void *private_data,
                 enum nir_spirv_debug_level level,
@@ -36,6 +36,11 @@ extern "C" {
 
 uint32_t vk_spirv_version(const uint32_t *spirv_data, size_t spirv_size_B);
 
+void vk_spirv_find_used_spec_constants(const uint32_t *spirv_data,
+                                       size_t spirv_size_B,
+                                       const VkSpecializationInfo *spec_info,
+                                       bool *used);
+
 bool
 nir_vk_is_not_xfb_output(nir_variable *var, void *data);
 
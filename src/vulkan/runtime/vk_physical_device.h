@@ -107,7 +107,8 @@ struct vk_physical_device {
     * when importing the cache. If an object type isn't in this list, then it
     * will be loaded as a raw data object and then deserialized when we first
     * look it up. Deserializing immediately avoids a copy but may be more
-    * expensive for objects that aren't hit.
+    * expensive for objects that aren't hit. Large initial data is always
+    * loaded as raw data objects, so that creating the cache stays cheap.
     */
    const struct vk_pipeline_cache_object_ops *const *pipeline_cache_import_ops;
 };
@@ -177,10 +177,62 @@ vk_pipeline_shader_stage_to_nir(struct vk_device *device,
    return VK_SUCCESS;
 }
 
-void
-vk_pipeline_hash_shader_stage(const VkPipelineShaderStageCreateInfo *info,
-                              const struct vk_pipeline_robustness_state *rstate,
-                              unsigned char *stage_sha1)
+static void
+hash_spec_entry(struct mesa_sha1 *ctx, const VkSpecializationInfo *spec_info,
+                uint32_t i)
+{
+   const VkSpecializationMapEntry *entry = &spec_info->pMapEntries[i];
+
+   _mesa_sha1_update(ctx, &entry->constantID, sizeof(entry->constantID));
+   _mesa_sha1_update(ctx, &entry->size, sizeof(entry->size));
+   _mesa_sha1_update(ctx, (const uint8_t *)spec_info->pData + entry->offset,
+                     entry->size);
+}
+
+/* Hashes the specialization constants by value, so that the layout of
+ * pMapEntries and pData doesn't matter.  If spec_used is not NULL, only
+ * the used entries are hashed and they are hashed in constantID order, which
+ * gives the same hash as the plain one when all entries are used and already
+ * sorted.
+ */
+static void
+hash_spec_info(struct mesa_sha1 *ctx, const VkSpecializationInfo *spec_info,
+               const bool *spec_used)
+{
+   if (spec_used == NULL) {
+      for (uint32_t i = 0; i < spec_info->mapEntryCount; i++)
+         hash_spec_entry(ctx, spec_info, i);
+      return;
+   }
+
+   STACK_ARRAY(uint32_t, order, spec_info->mapEntryCount);
+   uint32_t count = 0;
+
+   /* Insertion sort, there are typically only a handful of entries. */
+   for (uint32_t i = 0; i < spec_info->mapEntryCount; i++) {
+      if (!spec_used[i])
+         continue;
+
+      const uint32_t id = spec_info->pMapEntries[i].constantID;
+      uint32_t j = count++;
+      while (j > 0 && spec_info->pMapEntries[order[j - 1]].constantID > id) {
+         order[j] = order[j - 1];
+         j--;
+      }
+      order[j] = i;
+   }
+
+   for (uint32_t i = 0; i < count; i++)
+      hash_spec_entry(ctx, spec_info, order[i]);
+
+   STACK_ARRAY_FINISH(order);
+}
+
+static void
+hash_shader_stage(const VkPipelineShaderStageCreateInfo *info,
+                  const struct vk_pipeline_robustness_state *rstate,
+                  const bool *spec_used,
+                  unsigned char *stage_sha1)
 {
    VK_FROM_HANDLE(vk_shader_module, module, info->module);
 
@@ -238,13 +290,8 @@ vk_pipeline_hash_shader_stage(const VkPipelineShaderStageCreateInfo *info,
 
    _mesa_sha1_update(&ctx, info->pName, strlen(info->pName));
 
-   if (info->pSpecializationInfo) {
-      _mesa_sha1_update(&ctx, info->pSpecializationInfo->pMapEntries,
-                        info->pSpecializationInfo->mapEntryCount *
-                        sizeof(*info->pSpecializationInfo->pMapEntries));
-      _mesa_sha1_update(&ctx, info->pSpecializationInfo->pData,
-                        info->pSpecializationInfo->dataSize);
-   }
+   if (info->pSpecializationInfo)
+      hash_spec_info(&ctx, info->pSpecializationInfo, spec_used);
 
    uint32_t req_subgroup_size = get_required_subgroup_size(info);
    _mesa_sha1_update(&ctx, &req_subgroup_size, sizeof(req_subgroup_size));
@@ -252,6 +299,58 @@ vk_pipeline_hash_shader_stage(const VkPipelineShaderStageCreateInfo *info,
    _mesa_sha1_final(&ctx, stage_sha1);
 }
 
+void
+vk_pipeline_hash_shader_stage(const VkPipelineShaderStageCreateInfo *info,
+                              const struct vk_pipeline_robustness_state *rstate,
+                              unsigned char *stage_sha1)
+{
+   hash_shader_stage(info, rstate, NULL, stage_sha1);
+}
+
+/* Same as vk_pipeline_hash_shader_stage() but only hashes the
+ * specialization constants which are actually used by the SPIR-V, in a
+ * canonical order.  Pipelines which only differ by unused specialization
+ * constants (or by the order in which they are given) get the same hash.
+ *
+ * Returns false if the SPIR-V isn't available or there are no
+ * specialization constants, in which case there is nothing to canonicalize.
+ */
+static bool
+hash_shader_stage_used_spec(const VkPipelineShaderStageCreateInfo *info,
+                            const struct vk_pipeline_robustness_state *rstate,
+                            unsigned char *stage_sha1)
+{
+   VK_FROM_HANDLE(vk_shader_module, module, info->module);
+   const VkSpecializationInfo *spec_info = info->pSpecializationInfo;
+
+   if (spec_info == NULL || spec_info->mapEntryCount == 0)
+      return false;
+
+   const uint32_t *spirv_data;
+   uint32_t spirv_size;
+   if (module != NULL) {
+      if (module->nir != NULL)
+         return false;
+      spirv_data = (const uint32_t *)module->data;
+      spirv_size = module->size;
+   } else {
+      const VkShaderModuleCreateInfo *minfo =
+         vk_find_struct_const(info->pNext, SHADER_MODULE_CREATE_INFO);
+      if (minfo == NULL)
+         return false;
+      spirv_data = minfo->pCode;
+      spirv_size = minfo->codeSize;
+   }
+
+   STACK_ARRAY(bool, spec_used, spec_info->mapEntryCount);
+   vk_spirv_find_used_spec_constants(spirv_data, spirv_size, spec_info,
+                                     spec_used);
+   hash_shader_stage(info, rstate, spec_used, stage_sha1);
+   STACK_ARRAY_FINISH(spec_used);
+
+   return true;
+}
+
 static VkPipelineRobustnessBufferBehaviorEXT
 vk_device_default_robust_buffer_behavior(const struct vk_device *device)
 {
@@ -689,6 +788,42 @@ fail_blob:
    return NULL;
 }
 
+/* Creates a copy of shader with a different cache key. */
+static struct vk_pipeline_precomp_shader *
+vk_pipeline_precomp_shader_clone(struct vk_device *device,
+                                 const void *key_data, size_t key_size,
+                                 const struct vk_pipeline_precomp_shader *src)
+{
+   struct vk_pipeline_precomp_shader *shader =
+      vk_zalloc(&device->alloc, sizeof(*shader), 8,
+                VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (shader == NULL)
+      return NULL;
+
+   blob_init(&shader->nir_blob);
+   blob_write_bytes(&shader->nir_blob, src->nir_blob.data, src->nir_blob.size);
+   if (shader->nir_blob.out_of_memory) {
+      blob_finish(&shader->nir_blob);
+      vk_free(&device->alloc, shader);
+      return NULL;
+   }
+
+   assert(sizeof(shader->cache_key) == key_size);
+   memcpy(shader->cache_key, key_data, sizeof(shader->cache_key));
+
+   vk_pipeline_cache_object_init(device, &shader->cache_obj,
+                                 &pipeline_precomp_shader_cache_ops,
+                                 shader->cache_key,
+                                 sizeof(shader->cache_key));
+
+   shader->stage = src->stage;
+   shader->rs = src->rs;
+   shader->tess = src->tess;
+   memcpy(shader->blake3, src->blake3, sizeof(shader->blake3));
+
+   return shader;
+}
+
 static bool
 vk_pipeline_precomp_shader_serialize(struct vk_pipeline_cache_object *obj,
                                      struct blob *blob)
@@ -809,6 +944,19 @@ vk_pipeline_precompile_shader(struct vk_device *device,
    uint8_t stage_sha1[SHA1_DIGEST_LENGTH];
    vk_pipeline_hash_shader_stage(info, &rs, stage_sha1);
 
+   /* Applications often pass the same big set of specialization constants
+    * to every pipeline, most of which a given shader doesn't use.  Those
+    * don't change the NIR, so also look the shader up by a hash of only the
+    * used ones, which saves running spirv_to_nir and preprocess_nir again.
+    * The plain hash is still the primary key so that lookups by module
+    * identifier, which don't have the SPIR-V to look at, keep working.
+    */
+   uint8_t spec_sha1[SHA1_DIGEST_LENGTH];
+   const bool has_spec_sha1 =
+      cache != NULL &&
+      hash_shader_stage_used_spec(info, &rs, spec_sha1) &&
+      memcmp(spec_sha1, stage_sha1, sizeof(stage_sha1)) != 0;
+
    if (cache != NULL) {
       struct vk_pipeline_cache_object *cache_obj =
          vk_pipeline_cache_lookup_object(cache, stage_sha1, sizeof(stage_sha1),
@@ -820,6 +968,27 @@ vk_pipeline_precompile_shader(struct vk_device *device,
       }
    }
 
+   if (has_spec_sha1) {
+      struct vk_pipeline_cache_object *cache_obj =
+         vk_pipeline_cache_lookup_object(cache, spec_sha1, sizeof(spec_sha1),
+                                         &pipeline_precomp_shader_cache_ops,
+                                         NULL /* cache_hit */);
+      if (cache_obj != NULL) {
+         struct vk_pipeline_precomp_shader *spec_shader =
+            vk_pipeline_precomp_shader_from_cache_obj(cache_obj);
+         struct vk_pipeline_precomp_shader *shader =
+            vk_pipeline_precomp_shader_clone(device, stage_sha1,
+                                             sizeof(stage_sha1), spec_shader);
+         vk_pipeline_precomp_shader_unref(device, spec_shader);
+         if (shader == NULL)
+            return vk_error(device, VK_ERROR_OUT_OF_HOST_MEMORY);
+
+         cache_obj = vk_pipeline_cache_add_object(cache, &shader->cache_obj);
+         *ps_out = vk_pipeline_precomp_shader_from_cache_obj(cache_obj);
+         return VK_SUCCESS;
+      }
+   }
+
    if (pipeline_flags &
        VK_PIPELINE_CREATE_2_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_KHR)
       return VK_PIPELINE_COMPILE_REQUIRED;
@@ -847,6 +1016,17 @@ vk_pipeline_precompile_shader(struct vk_device *device,
    if (shader == NULL)
       return vk_error(device, VK_ERROR_OUT_OF_HOST_MEMORY);
 
+   if (has_spec_sha1) {
+      struct vk_pipeline_precomp_shader *spec_shader =
+         vk_pipeline_precomp_shader_clone(device, spec_sha1,
+                                          sizeof(spec_sha1), shader);
+      if (spec_shader != NULL) {
+         struct vk_pipeline_cache_object *cache_obj =
+            vk_pipeline_cache_add_object(cache, &spec_shader->cache_obj);
+         vk_pipeline_cache_object_unref(device, cache_obj);
+      }
+   }
+
    if (cache != NULL) {
       struct vk_pipeline_cache_object *cache_obj = &shader->cache_obj;
       cache_obj = vk_pipeline_cache_add_object(cache, cache_obj);
@@ -37,6 +37,9 @@
 #include "util/hash_table.h"
 #include "util/set.h"
 
+/* Initial data size above which objects are deserialized on first lookup */
+#define VK_PIPELINE_CACHE_LAZY_IMPORT_SIZE (16 * 1024 * 1024)
+
 #define vk_pipeline_cache_log(cache, ...)                                      \
    if (cache->base.client_visible)                                             \
       vk_logw(VK_LOG_OBJS(cache), __VA_ARGS__)
@@ -139,14 +142,32 @@ vk_pipeline_cache_lock(struct vk_pipeline_cache *cache)
 {
 
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_lock(&cache->lock);
+      u_rwlock_wrlock(&cache->lock);
 }
 
 static void
 vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache)
 {
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_unlock(&cache->lock);
+      u_rwlock_wrunlock(&cache->lock);
+}
+
+/* Only for searching object_cache.  Taking a reference on a found object is
+ * fine under the read lock: the ref count of a weakly owned object only
+ * drops to zero with the write lock held, see vk_pipeline_cache_object_unref.
+ */
+static void
+vk_pipeline_cache_read_lock(struct vk_pipeline_cache *cache)
+{
+   if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
+      u_rwlock_rdlock(&cache->lock);
+}
+
+static void
+vk_pipeline_cache_read_unlock(struct vk_pipeline_cache *cache)
+{
+   if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
+      u_rwlock_rdunlock(&cache->lock);
 }
 
 /* cache->lock must be held when calling */
@@ -344,7 +365,7 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
    struct vk_pipeline_cache_object *object = NULL;
 
    if (cache != NULL && cache->object_cache != NULL) {
-      vk_pipeline_cache_lock(cache);
+      vk_pipeline_cache_read_lock(cache);
       struct set_entry *entry =
          _mesa_set_search_pre_hashed(cache->object_cache, hash, &key);
       if (entry) {
@@ -352,7 +373,7 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
          if (cache_hit != NULL)
             *cache_hit = true;
       }
-      vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_read_unlock(cache);
    }
 
    if (object == NULL) {
@@ -571,6 +592,13 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
    if (memcmp(&header, &cache->header, sizeof(header)) != 0)
       return;
 
+   /* Deserializing everything up front makes creating a cache from a large
+    * blob take as long as compiling a good part of it did.  Past a certain
+    * size, import everything as raw data and deserialize objects on their
+    * first lookup instead, which only costs a copy for the ones never hit.
+    */
+   const bool lazy = size >= VK_PIPELINE_CACHE_LAZY_IMPORT_SIZE;
+
    for (uint32_t i = 0; i < count; i++) {
       int32_t type = blob_read_uint32(&blob);
       uint32_t key_size = blob_read_uint32(&blob);
@@ -581,7 +609,7 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
       if (blob.overrun)
          break;
 
-      const struct vk_pipeline_cache_object_ops *ops =
+      const struct vk_pipeline_cache_object_ops *ops = lazy ? NULL :
          find_ops_for_type(cache->base.device->physical, type);
 
       struct vk_pipeline_cache_object *object =
@@ -637,7 +665,7 @@ vk_pipeline_cache_create(struct vk_device *device,
    };
    memcpy(cache->header.uuid, pdevice_props.pipelineCacheUUID, VK_UUID_SIZE);
 
-   simple_mtx_init(&cache->lock, mtx_plain);
+   u_rwlock_init(&cache->lock);
 
    if (info->force_enable ||
        debug_get_bool_option("VK_ENABLE_PIPELINE_CACHE", true)) {
@@ -667,7 +695,7 @@ vk_pipeline_cache_destroy(struct vk_pipeline_cache *cache,
       }
       _mesa_set_destroy(cache->object_cache, NULL);
    }
-   simple_mtx_destroy(&cache->lock);
+   u_rwlock_destroy(&cache->lock);
    vk_object_free(cache->base.device, pAllocator, cache);
 }
 
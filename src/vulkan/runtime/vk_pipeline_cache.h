@@ -26,6 +26,7 @@
 #include "vk_object.h"
 #include "vk_util.h"
 
+#include "util/rwlock.h"
 #include "util/simple_mtx.h"
 
 #ifdef __cplusplus
@@ -158,8 +159,12 @@ struct vk_pipeline_cache {
 
    struct vk_pipeline_cache_header header;
 
-   /** Protects object_cache */
-   simple_mtx_t lock;
+   /** Protects object_cache
+    *
+    * Lookups only need it for reading, so concurrent cache hits from
+    * several threads don't serialize.
+    */
+   struct u_rwlock lock;
 
    struct set *object_cache;
 };
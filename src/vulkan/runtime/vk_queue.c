@@ -23,6 +23,7 @@
 
 #include "vk_queue.h"
 
+#include "util/log.h"
 #include "util/perf/cpu_trace.h"
 #include "util/u_debug.h"
 #include <inttypes.h>
@@ -44,6 +45,16 @@
 
 #include "vulkan/wsi/wsi_common.h"
 
+/* Number of consecutive submits which could have been submitted directly
+ * before an on-demand submit thread is stopped again.  This keeps a queue
+ * that only occasionally sees a wait-before-signal from paying the thread
+ * hand-off on every submit, without starting and joining a thread per frame
+ * for applications that do it constantly.
+ */
+#define VK_QUEUE_SUBMIT_THREAD_IDLE_SUBMITS 64
+
+DEBUG_GET_ONCE_BOOL_OPTION(queue_stats, "MESA_VK_QUEUE_STATS", false)
+
 static VkResult
 vk_queue_start_submit_thread(struct vk_queue *queue);
 
@@ -454,6 +465,80 @@ done:
    return result;
 }
 
+static bool
+vk_queue_submit_has_bind(const struct vk_queue_submit *submit)
+{
+   return submit->buffer_bind_count > 0 ||
+          submit->image_opaque_bind_count > 0 ||
+          submit->image_bind_count > 0;
+}
+
+/* Merges the submit following first in the queue into it, if nothing can
+ * happen between the two on the queue: first signals nothing and the next
+ * one waits on nothing.  Returns the merged submit, which replaces both in
+ * the list, or first if the two can't be merged.
+ *
+ * queue->submit.mutex must be held.
+ */
+static struct vk_queue_submit *
+vk_queue_merge_next_submit(struct vk_queue *queue,
+                           struct vk_queue_submit *first)
+{
+   if (first->link.next == &queue->submit.submits)
+      return first;
+
+   struct vk_queue_submit *next =
+      list_entry(first->link.next, struct vk_queue_submit, link);
+
+   if (first->signal_count > 0 || first->_mem_signal_temp != NULL ||
+       next->wait_count > 0 ||
+       first->perf_pass_index != next->perf_pass_index ||
+       vk_queue_submit_has_bind(first) || vk_queue_submit_has_bind(next))
+      return first;
+
+   struct vk_queue_submit *merged =
+      vk_queue_submit_alloc(queue, first->wait_count,
+                            first->command_buffer_count +
+                            next->command_buffer_count,
+                            0, 0, 0, 0, 0,
+                            next->signal_count,
+                            NULL, NULL);
+   if (merged == NULL)
+      return first;
+
+   merged->perf_pass_index = first->perf_pass_index;
+
+   /* Ownership of the temporaries and time points moves to the merged
+    * submit, so the originals are freed without being cleaned up.
+    */
+   for (uint32_t i = 0; i < first->wait_count; i++) {
+      merged->waits[i] = first->waits[i];
+      merged->_wait_temps[i] = first->_wait_temps[i];
+      if (merged->_wait_points != NULL)
+         merged->_wait_points[i] = first->_wait_points[i];
+   }
+
+   typed_memcpy(merged->command_buffers, first->command_buffers,
+                first->command_buffer_count);
+   typed_memcpy(merged->command_buffers + first->command_buffer_count,
+                next->command_buffers, next->command_buffer_count);
+
+   for (uint32_t i = 0; i < next->signal_count; i++) {
+      merged->signals[i] = next->signals[i];
+      if (merged->_signal_points != NULL)
+         merged->_signal_points[i] = next->_signal_points[i];
+   }
+   merged->_mem_signal_temp = next->_mem_signal_temp;
+
+   list_add(&merged->link, &first->link);
+   list_del(&first->link);
+   list_del(&next->link);
+   vk_queue_submit_free(queue, first);
+   vk_queue_submit_free(queue, next);
+
+   return merged;
+}
+
 static int
 vk_queue_submit_thread_func(void *_data)
 {
@@ -488,6 +573,17 @@ vk_queue_submit_thread_func(void *_data)
          return 1;
       }
 
+      /* Submits queued up while we were waiting can often go along with
+       * this one in a single driver_submit.
+       */
+      if (queue->submit.merge) {
+         mtx_lock(&queue->submit.mutex);
+         struct vk_queue_submit *merged;
+         while ((merged = vk_queue_merge_next_submit(queue, submit)) != submit)
+            submit = merged;
+         mtx_unlock(&queue->submit.mutex);
+      }
+
       result = vk_queue_submit_final(queue, submit);
       if (unlikely(result != VK_SUCCESS)) {
          vk_queue_set_lost(queue, "queue::driver_submit failed");
@@ -564,6 +660,47 @@ vk_queue_enable_submit_thread(struct vk_queue *queue)
       return result;
 
    queue->submit.mode = VK_QUEUE_SUBMIT_MODE_THREADED;
+   queue->submit.idle_submits = 0;
+   queue->submit.stats.thread_starts++;
+
+   return VK_SUCCESS;
+}
+
+/* Stops an on-demand submit thread once it has stopped being useful, that
+ * is once enough consecutive submits found their dependencies already
+ * submitted while the thread had nothing queued.
+ */
+static VkResult
+vk_queue_check_submit_thread_idle(struct vk_queue *queue,
+                                  struct vk_queue_submit *submit)
+{
+   assert(queue->submit.mode == VK_QUEUE_SUBMIT_MODE_THREADED);
+
+   mtx_lock(&queue->submit.mutex);
+   const bool thread_busy = !list_is_empty(&queue->submit.submits);
+   mtx_unlock(&queue->submit.mutex);
+
+   if (thread_busy) {
+      queue->submit.idle_submits = 0;
+      return VK_SUCCESS;
+   }
+
+   VkResult result = vk_sync_wait_many(queue->base.device,
+                                       submit->wait_count, submit->waits,
+                                       VK_SYNC_WAIT_PENDING, 0);
+   if (result == VK_TIMEOUT) {
+      queue->submit.idle_submits = 0;
+      return VK_SUCCESS;
+   }
+   if (unlikely(result != VK_SUCCESS))
+      return result;
+
+   if (++queue->submit.idle_submits < VK_QUEUE_SUBMIT_THREAD_IDLE_SUBMITS)
+      return VK_SUCCESS;
+
+   vk_queue_stop_submit_thread(queue);
+   queue->submit.idle_submits = 0;
+   queue->submit.stats.thread_stops++;
 
    return VK_SUCCESS;
 }
@@ -843,8 +980,14 @@ vk_queue_submit(struct vk_queue *queue,
          result = vk_queue_enable_submit_thread(queue);
       if (unlikely(result != VK_SUCCESS))
          goto fail;
+   } else if (device->submit_mode == VK_QUEUE_SUBMIT_MODE_THREADED_ON_DEMAND) {
+      result = vk_queue_check_submit_thread_idle(queue, submit);
+      if (unlikely(result != VK_SUCCESS))
+         goto fail;
    }
 
+   queue->submit.stats.submits++;
+
    switch (queue->submit.mode) {
    case VK_QUEUE_SUBMIT_MODE_IMMEDIATE:
       result = vk_queue_submit_final(queue, submit);
@@ -894,6 +1037,8 @@ vk_queue_submit(struct vk_queue *queue,
       return vk_device_flush(queue->base.device);
 
    case VK_QUEUE_SUBMIT_MODE_THREADED:
+      queue->submit.stats.threaded_submits++;
+
       if (has_binary_permanent_semaphore_wait) {
          for (uint32_t i = 0; i < info->wait_count; i++) {
             VK_FROM_HANDLE(vk_semaphore, semaphore,
@@ -1114,6 +1259,16 @@ vk_queue_signal_sync(struct vk_queue *queue,
 void
 vk_queue_finish(struct vk_queue *queue)
 {
+   if (debug_get_option_queue_stats()) {
+      mesa_logi("queue %u.%u: %" PRIu64 " submits, %" PRIu64 " threaded, "
+                "submit thread started %u times, stopped %u times",
+                queue->queue_family_index, queue->index_in_family,
+                queue->submit.stats.submits,
+                queue->submit.stats.threaded_submits,
+                queue->submit.stats.thread_starts,
+                queue->submit.stats.thread_stops);
+   }
+
    if (queue->submit.mode == VK_QUEUE_SUBMIT_MODE_THREADED)
       vk_queue_stop_submit_thread(queue);
 
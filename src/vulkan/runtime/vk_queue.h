@@ -96,6 +96,32 @@ struct vk_queue {
 
       bool thread_run;
       thrd_t thread;
+
+      /** Whether the submit thread may merge consecutive submits
+       *
+       * When set, the submit thread merges a submit that signals nothing
+       * with a following one that waits on nothing into a single call to
+       * driver_submit.  Only drivers whose driver_submit handles any number
+       * of command buffers in one go should set this.
+       */
+      bool merge;
+
+      /** Consecutive submits which did not need the on-demand submit thread
+       *
+       * Once this reaches VK_QUEUE_SUBMIT_THREAD_IDLE_SUBMITS, the thread is
+       * stopped and the queue goes back to immediate submission.
+       */
+      uint32_t idle_submits;
+
+      /** Submit statistics, printed at queue destruction when
+       * MESA_VK_QUEUE_STATS is set
+       */
+      struct {
+         uint64_t submits;
+         uint64_t threaded_submits;
+         uint32_t thread_starts;
+         uint32_t thread_stops;
+      } stats;
    } submit;
 
    struct {
@@ -6,6 +6,9 @@
 #include "vk_texcompress_etc2.h"
 
 #include "compiler/nir/nir_builder.h"
+#include "vk_command_buffer.h"
+#include "vk_image.h"
+#include "vk_meta.h"
 #include "vk_shader_module.h"
 
 /* Based on
@@ -174,6 +177,7 @@ etc2_build_shader(struct vk_device *dev, const struct nir_shader_compiler_option
 
    nir_def *consts = nir_load_push_constant(&b, 4, 32, nir_imm_int(&b, 0), .range = 16);
    nir_def *consts2 = nir_load_push_constant(&b, 1, 32, nir_imm_int(&b, 0), .base = 16, .range = 4);
+   nir_def *extent = nir_load_push_constant(&b, 3, 32, nir_imm_int(&b, 0), .base = 20, .range = 12);
    nir_def *offset = nir_channels(&b, consts, 7);
    nir_def *format = nir_channel(&b, consts, 3);
    nir_def *image_type = nir_channel(&b, consts2, 0);
@@ -418,6 +422,8 @@ etc2_build_shader(struct vk_device *dev, const struct nir_shader_compiler_option
    nir_def *img_coord = nir_vec4(&b, nir_channel(&b, coord, 0), nir_channel(&b, coord, 1), nir_channel(&b, coord, 2),
                                  nir_undef(&b, 1, 32));
 
+   /* Dispatches are rounded up to whole workgroups. */
+   nir_push_if(&b, nir_ball(&b, nir_ult(&b, global_id, extent)));
    nir_push_if(&b, is_3d);
    {
       nir_image_deref_store(&b, &nir_build_deref_var(&b, output_img_3d)->def, img_coord, nir_undef(&b, 1, 32), outval,
@@ -429,6 +435,7 @@ etc2_build_shader(struct vk_device *dev, const struct nir_shader_compiler_option
                             nir_imm_int(&b, 0), .image_dim = GLSL_SAMPLER_DIM_2D, .image_array = true);
    }
    nir_pop_if(&b, NULL);
+   nir_pop_if(&b, NULL);
    return b.shader;
 }
 
@@ -470,7 +477,7 @@ etc2_init_pipeline_layout(struct vk_device *device, struct vk_texcompress_etc2_s
       .pPushConstantRanges =
          &(VkPushConstantRange){
             .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-            .size = 20,
+            .size = 32,
          },
    };
 
@@ -563,3 +570,107 @@ vk_texcompress_etc2_finish(struct vk_device *device, struct vk_texcompress_etc2_
 
    simple_mtx_destroy(&etc2->mutex);
 }
+
+void
+vk_texcompress_etc2_decode(struct vk_command_buffer *cmd,
+                           struct vk_meta_device *meta,
+                           struct vk_texcompress_etc2_state *etc2,
+                           struct vk_image *image,
+                           VkImageAspectFlagBits emu_aspect,
+                           VkImageLayout layout,
+                           const VkImageSubresourceLayers *subresource,
+                           VkOffset3D offset, VkExtent3D extent)
+{
+   struct vk_device *device = cmd->base.device;
+   const struct vk_device_dispatch_table *disp = &device->dispatch_table;
+   VkCommandBuffer _cmd = vk_command_buffer_to_handle(cmd);
+   VkResult result;
+
+   result = vk_texcompress_etc2_late_init(device, etc2);
+   if (result != VK_SUCCESS) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   const bool is_3d = image->image_type == VK_IMAGE_TYPE_3D;
+   const uint32_t base_slice = is_3d ? offset.z : subresource->baseArrayLayer;
+   const uint32_t slice_count = is_3d ? extent.depth : vk_image_subresource_layer_count(image, subresource);
+
+   extent = vk_image_sanitize_extent(image, extent);
+   offset = vk_image_sanitize_offset(image, offset);
+
+   /* Both views start at layer 0, the shader offsets into them by base_slice. */
+   const VkImageSubresourceRange range = {
+      .baseMipLevel = subresource->mipLevel,
+      .levelCount = 1,
+      .baseArrayLayer = 0,
+      .layerCount = is_3d ? 1 : base_slice + slice_count,
+   };
+
+   VkImageView src_view, dst_view;
+   const VkImageViewUsageCreateInfo src_usage = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+      .usage = VK_IMAGE_USAGE_SAMPLED_BIT,
+   };
+   VkImageViewCreateInfo view_info = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+      .pNext = &src_usage,
+      .image = vk_image_to_handle(image),
+      .viewType = vk_texcompress_etc2_image_view_type(image->image_type),
+      .format = vk_texcompress_etc2_load_format(image->format),
+      .subresourceRange = range,
+   };
+   view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+   result = vk_meta_create_image_view(cmd, meta, &view_info, &src_view);
+   if (unlikely(result != VK_SUCCESS)) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   const VkImageViewUsageCreateInfo dst_usage = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+      .usage = VK_IMAGE_USAGE_STORAGE_BIT,
+   };
+   view_info.pNext = &dst_usage;
+   view_info.format = vk_texcompress_etc2_store_format(image->format);
+   view_info.subresourceRange.aspectMask = emu_aspect;
+   result = vk_meta_create_image_view(cmd, meta, &view_info, &dst_view);
+   if (unlikely(result != VK_SUCCESS)) {
+      vk_command_buffer_set_error(cmd, result);
+      return;
+   }
+
+   disp->CmdBindPipeline(_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, etc2->pipeline);
+
+   const VkDescriptorImageInfo image_infos[] = {
+      { .imageView = src_view, .imageLayout = layout },
+      { .imageView = dst_view, .imageLayout = layout },
+   };
+   const VkWriteDescriptorSet writes[] = {
+      {
+         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .dstBinding = 0,
+         .descriptorCount = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+         .pImageInfo = &image_infos[0],
+      },
+      {
+         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+         .dstBinding = 1,
+         .descriptorCount = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+         .pImageInfo = &image_infos[1],
+      },
+   };
+   disp->CmdPushDescriptorSetKHR(_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, etc2->pipeline_layout, 0,
+                                 ARRAY_SIZE(writes), writes);
+
+   const uint32_t push_constants[8] = {
+      offset.x, offset.y, base_slice, image->format, image->image_type,
+      extent.width, extent.height, slice_count,
+   };
+   disp->CmdPushConstants(_cmd, etc2->pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push_constants),
+                          push_constants);
+
+   disp->CmdDispatch(_cmd, DIV_ROUND_UP(extent.width, 8), DIV_ROUND_UP(extent.height, 8), slice_count);
+}
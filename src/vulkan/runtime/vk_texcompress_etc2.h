@@ -17,6 +17,9 @@ extern "C" {
 #endif
 
 struct nir_shader_compiler_options;
+struct vk_command_buffer;
+struct vk_image;
+struct vk_meta_device;
 
 struct vk_texcompress_etc2_state {
    /* these are specified by the driver */
@@ -36,6 +39,7 @@ struct vk_texcompress_etc2_state {
     *      ivec3 offset;
     *      int vk_format;
     *      int vk_image_type;
+    *      uvec3 extent;
     *    } registers;
     *
     * There are other implications, such as
@@ -67,6 +71,18 @@ VkResult vk_texcompress_etc2_late_init(struct vk_device *device, struct vk_texco
 
 void vk_texcompress_etc2_finish(struct vk_device *device, struct vk_texcompress_etc2_state *etc2);
 
+/* Records a decode of the given region of an ETC2/EAC image into its
+ * emulation plane, addressed with emu_aspect, using vk_meta for the image
+ * views.  This lets any driver built on vk_meta emulate ETC2 without a
+ * decoder of its own.  The caller is responsible for saving and restoring
+ * the compute state and for the barriers around the decode.
+ */
+void vk_texcompress_etc2_decode(struct vk_command_buffer *cmd, struct vk_meta_device *meta,
+                                struct vk_texcompress_etc2_state *etc2, struct vk_image *image,
+                                VkImageAspectFlagBits emu_aspect, VkImageLayout layout,
+                                const VkImageSubresourceLayers *subresource, VkOffset3D offset,
+                                VkExtent3D extent);
+
 static inline VkImageViewType
 vk_texcompress_etc2_image_view_type(VkImageType image_type)
 {
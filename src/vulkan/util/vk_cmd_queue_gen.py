@@ -72,6 +72,7 @@ TEMPLATE_H = Template(COPYRIGHT + """\
 #pragma once
 
 #include "util/list.h"
+#include "util/ralloc.h"
 
 #define VK_PROTOTYPES
 #include <vulkan/vulkan_core.h>
@@ -88,6 +89,12 @@ struct vk_device_dispatch_table;
 struct vk_cmd_queue {
    const VkAllocationCallbacks *alloc;
    struct list_head cmds;
+
+   /* Every recorded command and all of its copied parameters are allocated
+    * from this context, so the whole queue is freed at once on reset.
+    * Created on the first allocation.
+    */
+   linear_ctx *ctx;
 };
 
 enum vk_cmd_type {
@@ -124,6 +131,12 @@ struct ${to_struct_name(c.name)} {
 
 struct vk_cmd_queue_entry;
 
+/* driver_free_cb, if set, is called for every entry when the queue is reset
+ * or finished, before the queue's memory is released.  It is meant for
+ * releasing references; anything allocated with vk_cmd_queue_zalloc() is
+ * freed along with the queue.
+ */
+
 /* this ordering must match vk_cmd_queue_entry */
 struct vk_cmd_queue_entry_base {
    struct list_head cmd_link;
@@ -180,9 +193,22 @@ static inline void
 vk_cmd_queue_init(struct vk_cmd_queue *queue, VkAllocationCallbacks *alloc)
 {
    queue->alloc = alloc;
+   queue->ctx = NULL;
    list_inithead(&queue->cmds);
 }
 
+static inline void *
+vk_cmd_queue_zalloc(struct vk_cmd_queue *queue, size_t size)
+{
+   if (unlikely(queue->ctx == NULL)) {
+      queue->ctx = linear_context(NULL);
+      if (queue->ctx == NULL)
+         return NULL;
+   }
+
+   return linear_zalloc_child(queue->ctx, size);
+}
+
 static inline void
 vk_cmd_queue_reset(struct vk_cmd_queue *queue)
 {
@@ -254,25 +280,6 @@ size_t vk_cmd_queue_type_sizes[] = {
 % if c.guard is not None:
 #ifdef ${c.guard}
 % endif
-static void
-vk_free_${to_underscore(c.name)}(struct vk_cmd_queue *queue,
-${' ' * len('vk_free_' + to_underscore(c.name) + '(')}\\
-struct vk_cmd_queue_entry *cmd)
-{
-   if (cmd->driver_free_cb)
-      cmd->driver_free_cb(queue, cmd);
-   else
-      vk_free(queue->alloc, cmd->driver_data);
-% for p in c.params[1:]:
-% if p.len:
-   vk_free(queue->alloc, (${remove_suffix(p.decl.replace("const", ""), p.name)})cmd->u.${to_struct_field_name(c.name)}.${to_field_name(p.name)});
-% elif '*' in p.decl:
-   ${get_struct_free(c, p, types)}
-% endif
-% endfor
-   vk_free(queue->alloc, cmd);
-}
-
 % if c.name not in manual_commands and c.name not in no_enqueue_commands:
 VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 % for p in c.params[1:]:
@@ -280,8 +287,8 @@ VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 % endfor
 )
 {
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(queue->alloc, vk_cmd_queue_type_sizes[${to_enum_name(c.name)}], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue_entry *cmd =
+      vk_cmd_queue_zalloc(queue, vk_cmd_queue_type_sizes[${to_enum_name(c.name)}]);
    if (!cmd) return VK_ERROR_OUT_OF_HOST_MEMORY;
 
    cmd->type = ${to_enum_name(c.name)};
@@ -311,8 +318,7 @@ VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 
 % if need_error_handling:
 err:
-   if (cmd)
-      vk_free_${to_underscore(c.name)}(queue, cmd);
+   /* Whatever was allocated is released with the rest of the queue. */
    return VK_ERROR_OUT_OF_HOST_MEMORY;
 % endif
 }
@@ -326,22 +332,13 @@ err:
 void
 vk_free_queue(struct vk_cmd_queue *queue)
 {
-   struct vk_cmd_queue_entry *tmp, *cmd;
-   LIST_FOR_EACH_ENTRY_SAFE(cmd, tmp, &queue->cmds, cmd_link) {
-      switch(cmd->type) {
-% for c in commands:
-% if c.guard is not None:
-#ifdef ${c.guard}
-% endif
-      case ${to_enum_name(c.name)}:
-         vk_free_${to_underscore(c.name)}(queue, cmd);
-         break;
-% if c.guard is not None:
-#endif // ${c.guard}
-% endif
-% endfor
-      }
+   list_for_each_entry(struct vk_cmd_queue_entry, cmd, &queue->cmds, cmd_link) {
+      if (cmd->driver_free_cb)
+         cmd->driver_free_cb(queue, cmd);
    }
+
+   linear_free_context(queue->ctx);
+   queue->ctx = NULL;
 }
 
 void
@@ -465,7 +462,7 @@ def get_array_copy(command, param):
         field_size = "1"
     else:
         field_size = "sizeof(*%s)" % field_name
-    allocation = "%s = vk_zalloc(queue->alloc, %s * (%s), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, param.len, field_name)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s * (%s));\n   if (%s == NULL) goto err;\n" % (field_name, field_size, param.len, field_name)
     copy = "memcpy((void*)%s, %s, %s * (%s));" % (field_name, param.name, field_size, param.len)
     return "%s\n   %s" % (allocation, copy)
 
@@ -475,7 +472,7 @@ def get_array_member_copy(struct, src_name, member):
         field_size = "sizeof(*%s)" % (field_name)
     else:
         field_size = "sizeof(*%s) * %s->%s" % (field_name, struct, member.len)
-    allocation = "%s = vk_zalloc(queue->alloc, %s, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, field_name)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, field_name)
     copy = "memcpy((void*)%s, %s->%s, %s);" % (field_name, src_name, member.name, field_size)
     return "if (%s->%s) {\n   %s\n   %s\n}\n" % (src_name, member.name, allocation, copy)
 
@@ -511,7 +508,7 @@ def get_struct_copy(dst, src_name, src_type, size, types, level=0):
     global tmp_dst_idx
     global tmp_src_idx
 
-    allocation = "%s = vk_zalloc(queue->alloc, %s, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n      if (%s == NULL) goto err;\n" % (dst, size, dst)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s);\n      if (%s == NULL) goto err;\n" % (dst, size, dst)
     copy = "memcpy((void*)%s, %s, %s);" % (dst, src_name, size)
 
     level += 1
@@ -531,19 +528,6 @@ def get_struct_copy(dst, src_name, src_type, size, types, level=0):
     indent = "   " * level
     return "%s\n      %s\n      %s\n      %s\n      %s\n      %s\n%s} else {\n      %s\n%s}" % (if_stmt, allocation, copy, tmp_dst, tmp_src, member_copies, indent, null_assignment, indent)
 
-def get_struct_free(command, param, types):
-    field_name = "cmd->u.%s.%s" % (to_struct_field_name(command.name), to_field_name(param.name))
-    const_cast = remove_suffix(param.decl.replace("const", ""), param.name)
-    struct_free = "vk_free(queue->alloc, (%s)%s);" % (const_cast, field_name)
-    member_frees = ""
-    if (param.type in types):
-        for member in types[param.type].members:
-            if member.len and member.len != 'null-terminated':
-                member_name = "cmd->u.%s.%s->%s" % (to_struct_field_name(command.name), to_field_name(param.name), member.name)
-                const_cast = remove_suffix(member.decl.replace("const", ""), member.name)
-                member_frees += "vk_free(queue->alloc, (%s)%s);\n" % (const_cast, member_name)
-    return "%s      %s\n" % (member_frees, struct_free)
-
 EntrypointType = namedtuple('EntrypointType', 'name enum members extended_by guard')
 
 def get_types_defines(doc):
@@ -254,6 +254,9 @@ wsi_device_init(struct wsi_device *wsi,
    wsi->force_headless_swapchain =
       debug_get_bool_option("MESA_VK_WSI_HEADLESS_SWAPCHAIN", false);
 
+   wsi->prime_direct =
+      debug_get_bool_option("MESA_VK_WSI_PRIME_DIRECT", false);
+
    if (dri_options) {
       if (driCheckOption(dri_options, "adaptive_sync", DRI_BOOL))
          wsi->enable_adaptive_sync = driQueryOptionb(dri_options,
@@ -437,6 +440,7 @@ wsi_swapchain_init(const struct wsi_device *wsi,
    memset(chain, 0, sizeof(*chain));
 
    vk_object_base_init(device, &chain->base, VK_OBJECT_TYPE_SWAPCHAIN_KHR);
+   simple_mtx_init(&chain->timing.mtx, mtx_plain);
 
    chain->wsi = wsi;
    chain->device = _device;
@@ -578,6 +582,8 @@ wsi_swapchain_finish(struct wsi_swapchain *chain)
    }
    vk_free(&chain->alloc, chain->cmd_pools);
 
+   simple_mtx_destroy(&chain->timing.mtx);
+
    vk_object_base_finish(&chain->base);
 }
 
@@ -1374,6 +1380,8 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       vk_find_struct_const(pPresentInfo->pNext, SWAPCHAIN_PRESENT_FENCE_INFO_EXT);
    const VkSwapchainPresentModeInfoEXT *present_mode_info =
       vk_find_struct_const(pPresentInfo->pNext, SWAPCHAIN_PRESENT_MODE_INFO_EXT);
+   const VkPresentTimesInfoGOOGLE *present_times =
+      vk_find_struct_const(pPresentInfo->pNext, PRESENT_TIMES_INFO_GOOGLE);
 
    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
       VK_FROM_HANDLE(wsi_swapchain, swapchain, pPresentInfo->pSwapchains[i]);
@@ -1566,6 +1574,20 @@ wsi_common_queue_present(const struct wsi_device *wsi,
             goto fail_present;
       }
 
+      if (present_times && present_times->pTimes) {
+         image->timing = (struct wsi_present_timing) {
+            .present_id = present_times->pTimes[i].presentID,
+            .desired_present_time = present_times->pTimes[i].desiredPresentTime,
+         };
+         if (!swapchain->timing.enabled) {
+            simple_mtx_lock(&swapchain->timing.mtx);
+            swapchain->timing.enabled = true;
+            simple_mtx_unlock(&swapchain->timing.mtx);
+         }
+      } else {
+         image->timing = (struct wsi_present_timing) { 0 };
+      }
+
       result = swapchain->queue_present(swapchain, image_index, present_id, region);
       if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
          goto fail_present;
@@ -1602,6 +1624,104 @@ wsi_QueuePresentKHR(VkQueue _queue, const VkPresentInfoKHR *pPresentInfo)
                                    pPresentInfo);
 }
 
+void
+wsi_swapchain_record_presentation(struct wsi_swapchain *chain,
+                                  const struct wsi_present_timing *timing,
+                                  uint64_t actual_present_time,
+                                  uint64_t refresh_duration)
+{
+   simple_mtx_lock(&chain->timing.mtx);
+
+   if (refresh_duration)
+      chain->timing.refresh_duration = refresh_duration;
+
+   /* Only presents which came with a VkPresentTimeGOOGLE are reported. */
+   if (chain->timing.enabled && timing->present_id) {
+      /* Drop the oldest entry if the application doesn't keep up. */
+      if (chain->timing.count == WSI_PAST_PRESENTATION_TIMING_COUNT) {
+         chain->timing.first = (chain->timing.first + 1) %
+                               WSI_PAST_PRESENTATION_TIMING_COUNT;
+         chain->timing.count--;
+      }
+
+      uint32_t idx = (chain->timing.first + chain->timing.count) %
+                     WSI_PAST_PRESENTATION_TIMING_COUNT;
+      chain->timing.count++;
+
+      /* We have no way to know how much earlier the image could have been
+       * shown without compositor cooperation, so report the actual time as
+       * the earliest one with no margin.
+       */
+      chain->timing.past[idx] = (VkPastPresentationTimingGOOGLE) {
+         .presentID = timing->present_id,
+         .desiredPresentTime = timing->desired_present_time,
+         .actualPresentTime = actual_present_time,
+         .earliestPresentTime = actual_present_time,
+         .presentMargin = 0,
+      };
+   }
+
+   simple_mtx_unlock(&chain->timing.mtx);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+wsi_GetRefreshCycleDurationGOOGLE(VkDevice device,
+                                  VkSwapchainKHR _swapchain,
+                                  VkRefreshCycleDurationGOOGLE *pDisplayTimingProperties)
+{
+   VK_FROM_HANDLE(wsi_swapchain, swapchain, _swapchain);
+
+   if (swapchain->poll_presentation_timing)
+      swapchain->poll_presentation_timing(swapchain);
+
+   simple_mtx_lock(&swapchain->timing.mtx);
+   uint64_t refresh_duration = swapchain->timing.refresh_duration;
+   simple_mtx_unlock(&swapchain->timing.mtx);
+
+   /* Assume 60Hz until the backend has seen the display refresh. */
+   pDisplayTimingProperties->refreshDuration =
+      refresh_duration ? refresh_duration : 16666667;
+
+   return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+wsi_GetPastPresentationTimingGOOGLE(VkDevice device,
+                                    VkSwapchainKHR _swapchain,
+                                    uint32_t *pPresentationTimingCount,
+                                    VkPastPresentationTimingGOOGLE *pPresentationTimings)
+{
+   VK_FROM_HANDLE(wsi_swapchain, swapchain, _swapchain);
+   VK_OUTARRAY_MAKE_TYPED(VkPastPresentationTimingGOOGLE, out,
+                          pPresentationTimings, pPresentationTimingCount);
+
+   if (swapchain->poll_presentation_timing)
+      swapchain->poll_presentation_timing(swapchain);
+
+   simple_mtx_lock(&swapchain->timing.mtx);
+
+   /* Entries are consumed once returned, a count-only query leaves them. */
+   uint32_t consumed = 0;
+   for (uint32_t i = 0; i < swapchain->timing.count; i++) {
+      uint32_t idx = (swapchain->timing.first + i) %
+                     WSI_PAST_PRESENTATION_TIMING_COUNT;
+      vk_outarray_append_typed(VkPastPresentationTimingGOOGLE, &out, t) {
+         *t = swapchain->timing.past[idx];
+         consumed++;
+      }
+   }
+
+   if (pPresentationTimings) {
+      swapchain->timing.first = (swapchain->timing.first + consumed) %
+                                WSI_PAST_PRESENTATION_TIMING_COUNT;
+      swapchain->timing.count -= consumed;
+   }
+
+   simple_mtx_unlock(&swapchain->timing.mtx);
+
+   return vk_outarray_status(&out);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 wsi_GetDeviceGroupPresentCapabilitiesKHR(VkDevice device,
                                          VkDeviceGroupPresentCapabilitiesKHR *pCapabilities)
@@ -138,6 +138,11 @@ struct wsi_device {
    /* Create headless swapchains. */
    bool force_headless_swapchain;
 
+   /* Render PRIME swapchains straight into a linear image the display GPU
+    * can import, instead of blitting to a linear buffer on every present.
+    */
+   bool prime_direct;
+
    bool force_swapchain_to_currentExtent;
 
    struct {
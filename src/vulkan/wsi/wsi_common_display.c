@@ -965,7 +965,7 @@ wsi_display_surface_get_capabilities2(VkIcdSurfaceBase *icd_surface,
       }
 
       case VK_STRUCTURE_TYPE_SURFACE_PRESENT_MODE_COMPATIBILITY_EXT: {
-         /* We only support FIFO. */
+         /* Switching present modes is not supported. */
          VkSurfacePresentModeCompatibilityEXT *compat = (void *)ext;
          if (compat->pPresentModes) {
             if (compat->presentModeCount) {
@@ -1073,18 +1073,44 @@ wsi_display_surface_get_formats2(VkIcdSurfaceBase *surface,
    return vk_outarray_status(&out);
 }
 
+/*
+ * Whether the kernel can flip without waiting for vblank
+ */
+static bool
+wsi_display_has_async_flip(struct wsi_display *wsi)
+{
+#ifdef DRM_CAP_ASYNC_PAGE_FLIP
+   uint64_t cap;
+
+   return wsi->fd >= 0 &&
+          drmGetCap(wsi->fd, DRM_CAP_ASYNC_PAGE_FLIP, &cap) == 0 && cap;
+#else
+   return false;
+#endif
+}
+
 static VkResult
 wsi_display_surface_get_present_modes(VkIcdSurfaceBase *surface,
                                       struct wsi_device *wsi_device,
                                       uint32_t *present_mode_count,
                                       VkPresentModeKHR *present_modes)
 {
+   struct wsi_display *wsi =
+      (struct wsi_display *) wsi_device->wsi[VK_ICD_WSI_PLATFORM_DISPLAY];
    VK_OUTARRAY_MAKE_TYPED(VkPresentModeKHR, conn,
                           present_modes, present_mode_count);
 
    vk_outarray_append_typed(VkPresentModeKHR, &conn, present) {
       *present = VK_PRESENT_MODE_FIFO_KHR;
    }
+   vk_outarray_append_typed(VkPresentModeKHR, &conn, present) {
+      *present = VK_PRESENT_MODE_MAILBOX_KHR;
+   }
+   if (wsi_display_has_async_flip(wsi)) {
+      vk_outarray_append_typed(VkPresentModeKHR, &conn, present) {
+         *present = VK_PRESENT_MODE_IMMEDIATE_KHR;
+      }
+   }
 
    return vk_outarray_status(&conn);
 }
@@ -1928,8 +1954,24 @@ _wsi_display_queue_next(struct wsi_swapchain *drv_chain)
 
       int ret;
       if (connector->active) {
+         uint32_t flags = DRM_MODE_PAGE_FLIP_EVENT;
+
+         /* Tear instead of waiting for vblank.  The kernel refuses async
+          * flips which change more than the framebuffer, fall back to a
+          * regular flip in that case.
+          */
+         if (chain->base.present_mode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
+            ret = drmModePageFlip(wsi->fd, connector->crtc_id, image->fb_id,
+                                  flags | DRM_MODE_PAGE_FLIP_ASYNC, image);
+            if (ret == 0) {
+               image->state = WSI_IMAGE_FLIPPING;
+               return VK_SUCCESS;
+            }
+            wsi_display_debug("async page flip err %d %s\n", ret, strerror(-ret));
+         }
+
          ret = drmModePageFlip(wsi->fd, connector->crtc_id, image->fb_id,
-                                   DRM_MODE_PAGE_FLIP_EVENT, image);
+                                   flags, image);
          if (ret == 0) {
             image->state = WSI_IMAGE_FLIPPING;
             return VK_SUCCESS;
@@ -2015,6 +2057,28 @@ wsi_display_queue_present(struct wsi_swapchain *drv_chain,
    if (present_id)
       wsi_display_start_wait_thread(wsi);
 
+   /* In MAILBOX and IMMEDIATE modes a new present replaces any image which
+    * has not been handed to the kernel yet, so we never queue more than one
+    * frame behind the one being flipped.
+    */
+   if (chain->base.present_mode != VK_PRESENT_MODE_FIFO_KHR) {
+      bool replaced = false;
+
+      for (uint32_t i = 0; i < chain->base.image_count; i++) {
+         if (chain->images[i].state == WSI_IMAGE_QUEUED) {
+            wsi_display_debug("replace queued image %d\n", i);
+            /* Present waits on the replaced image complete with this one */
+            image->present_id = MAX2(image->present_id,
+                                     chain->images[i].present_id);
+            chain->images[i].state = WSI_IMAGE_IDLE;
+            replaced = true;
+         }
+      }
+
+      if (replaced)
+         pthread_cond_broadcast(&wsi->wait_cond);
+   }
+
    image->flip_sequence = ++chain->flip_sequence;
    image->state = WSI_IMAGE_QUEUED;
 
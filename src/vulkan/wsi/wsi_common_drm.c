@@ -603,6 +603,11 @@ wsi_configure_native_image(const struct wsi_swapchain *chain,
           * modifiers.
           */
          for (uint32_t i = 0; i < params->num_modifiers[l]; i++) {
+            /* Another GPU can only be trusted to read linear images. */
+            if (!params->same_gpu &&
+                params->modifiers[l][i] != DRM_FORMAT_MOD_LINEAR)
+               continue;
+
             if (get_modifier_props(info, params->modifiers[l][i]))
                image_modifiers[image_modifier_count++] = params->modifiers[l][i];
          }
@@ -631,6 +636,9 @@ wsi_configure_native_image(const struct wsi_swapchain *chain,
    }
 
    info->create_mem = wsi_create_native_image_mem;
+   info->select_image_memory_type =
+      params->same_gpu ? wsi_select_device_memory_type :
+                         prime_select_buffer_memory_type;
 
    return VK_SUCCESS;
 
@@ -688,7 +696,7 @@ wsi_create_native_image_mem(const struct wsi_swapchain *chain,
       .pNext = &memory_dedicated_info,
       .allocationSize = reqs.size,
       .memoryTypeIndex =
-         wsi_select_device_memory_type(wsi, reqs.memoryTypeBits),
+         info->select_image_memory_type(wsi, reqs.memoryTypeBits),
    };
    result = wsi->AllocateMemory(chain->device, &memory_info,
                                 &chain->alloc, &image->memory);
@@ -802,12 +810,33 @@ wsi_configure_prime_image(UNUSED const struct wsi_swapchain *chain,
    return VK_SUCCESS;
 }
 
+/*
+ * Whether a PRIME swapchain can skip the blit and render straight into a
+ * linear image the other GPU imports.
+ */
+static bool
+wsi_drm_can_prime_direct(const struct wsi_device *wsi,
+                         const struct wsi_drm_image_params *params)
+{
+   if (!wsi->prime_direct || !wsi->supports_modifiers)
+      return false;
+
+   for (uint32_t l = 0; l < params->num_modifier_lists; l++) {
+      for (uint32_t i = 0; i < params->num_modifiers[l]; i++) {
+         if (params->modifiers[l][i] == DRM_FORMAT_MOD_LINEAR)
+            return true;
+      }
+   }
+
+   return false;
+}
+
 bool
 wsi_drm_image_needs_buffer_blit(const struct wsi_device *wsi,
                                 const struct wsi_drm_image_params *params)
 {
    if (!params->same_gpu)
-      return true;
+      return !wsi_drm_can_prime_direct(wsi, params);
 
    if (params->num_modifier_lists > 0 || wsi->supports_scanout)
       return false;
@@ -27,6 +27,7 @@
 #include "util/perf/cpu_trace.h"
 #include "vk_object.h"
 #include "vk_sync.h"
+#include "util/simple_mtx.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -130,6 +131,17 @@ struct wsi_image_explicit_sync_timeline {
    uint32_t handle;
 };
 
+/* Number of VkPastPresentationTimingGOOGLE entries a swapchain keeps
+ * around until the application queries them.  Older entries are dropped.
+ */
+#define WSI_PAST_PRESENTATION_TIMING_COUNT 16
+
+/* Timing information from VkPresentTimesInfoGOOGLE for one present */
+struct wsi_present_timing {
+   uint32_t present_id;
+   uint64_t desired_present_time;
+};
+
 enum wsi_swapchain_blit_type {
    WSI_SWAPCHAIN_NO_BLIT,
    WSI_SWAPCHAIN_BUFFER_BLIT,
@@ -152,6 +164,9 @@ struct wsi_image {
    bool acquired;
    uint64_t present_serial;
 
+   /* VK_GOOGLE_display_timing info of the last present of this image */
+   struct wsi_present_timing timing;
+
    struct wsi_image_explicit_sync_timeline explicit_sync[WSI_ES_COUNT];
 
 #ifndef _WIN32
@@ -200,6 +215,25 @@ struct wsi_swapchain {
 
    bool capture_key_pressed;
 
+   /* VK_GOOGLE_display_timing state.  Backends append an entry with
+    * wsi_swapchain_record_presentation() once they know when an image hit
+    * the screen, the application drains them with
+    * vkGetPastPresentationTimingGOOGLE().
+    */
+   struct {
+      simple_mtx_t mtx;
+
+      /* Set once the application passed a VkPresentTimesInfoGOOGLE */
+      bool enabled;
+
+      /* Last known refresh duration in nanoseconds, 0 if unknown */
+      uint64_t refresh_duration;
+
+      uint32_t first;
+      uint32_t count;
+      VkPastPresentationTimingGOOGLE past[WSI_PAST_PRESENTATION_TIMING_COUNT];
+   } timing;
+
    /* Command pools, one per queue family */
    VkCommandPool *cmd_pools;
 
@@ -222,6 +256,10 @@ struct wsi_swapchain {
                               const uint32_t *indices);
    void (*set_present_mode)(struct wsi_swapchain *swap_chain,
                             VkPresentModeKHR mode);
+   /* Optional, gives the backend a chance to process pending presentation
+    * feedback before the timing entries are returned to the application.
+    */
+   void (*poll_presentation_timing)(struct wsi_swapchain *swap_chain);
 };
 
 bool
@@ -249,6 +287,12 @@ wsi_swapchain_get_present_mode(struct wsi_device *wsi,
 
 void wsi_swapchain_finish(struct wsi_swapchain *chain);
 
+void
+wsi_swapchain_record_presentation(struct wsi_swapchain *chain,
+                                  const struct wsi_present_timing *timing,
+                                  uint64_t actual_present_time,
+                                  uint64_t refresh_duration);
+
 uint32_t
 wsi_select_memory_type(const struct wsi_device *wsi,
                        VkMemoryPropertyFlags req_flags,
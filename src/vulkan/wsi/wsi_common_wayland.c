@@ -1677,6 +1677,7 @@ struct wsi_wl_present_id {
     * which uses frame callback to signal DRI3 COMPLETE. */
    struct wl_callback *frame;
    uint64_t present_id;
+   struct wsi_present_timing timing;
    const VkAllocationCallbacks *alloc;
    struct wsi_wl_swapchain *chain;
    struct wl_list link;
@@ -1842,6 +1843,33 @@ wsi_wl_swapchain_wait_for_present(struct wsi_swapchain *wsi_chain,
    return ret;
 }
 
+static void
+wsi_wl_swapchain_poll_presentation_timing(struct wsi_swapchain *wsi_chain)
+{
+   struct wsi_wl_swapchain *chain = (struct wsi_wl_swapchain *)wsi_chain;
+   struct wl_display *wl_display = chain->wsi_wl_surface->display->wl_display;
+
+   /* If a present wait is dispatching, the feedback events will be handled
+    * by it and there is nothing to do.
+    */
+   pthread_mutex_lock(&chain->present_ids.lock);
+   if (chain->present_ids.dispatch_in_progress) {
+      pthread_mutex_unlock(&chain->present_ids.lock);
+      return;
+   }
+   chain->present_ids.dispatch_in_progress = true;
+   pthread_mutex_unlock(&chain->present_ids.lock);
+
+   const struct timespec no_wait = { 0 };
+   wl_display_dispatch_queue_timeout(wl_display, chain->present_ids.queue,
+                                     &no_wait);
+
+   pthread_mutex_lock(&chain->present_ids.lock);
+   chain->present_ids.dispatch_in_progress = false;
+   pthread_cond_broadcast(&chain->present_ids.list_advanced);
+   pthread_mutex_unlock(&chain->present_ids.lock);
+}
+
 static VkResult
 wsi_wl_swapchain_acquire_next_image_explicit(struct wsi_swapchain *wsi_chain,
                                              const VkAcquireNextImageInfoKHR *info,
@@ -1942,6 +1970,15 @@ presentation_handle_presented(void *data,
                               uint32_t flags)
 {
    struct wsi_wl_present_id *id = data;
+
+   /* The timestamp is in the clock advertised by wp_presentation.clock_id,
+    * which is CLOCK_MONOTONIC on every compositor we care about.
+    */
+   uint64_t tv_sec = ((uint64_t)tv_sec_hi << 32) | tv_sec_lo;
+   wsi_swapchain_record_presentation(&id->chain->base, &id->timing,
+                                     tv_sec * 1000000000ull + tv_nsec,
+                                     refresh);
+
    wsi_wl_presentation_update_present_id(id);
    wp_presentation_feedback_destroy(feedback);
 }
@@ -2067,12 +2104,18 @@ wsi_wl_swapchain_queue_present(struct wsi_swapchain *wsi_chain,
       chain->fifo_ready = true;
    }
 
-   if (present_id > 0) {
+   /* Display timing can only be reported with wp_presentation, frame
+    * callbacks carry no usable timestamp.
+    */
+   const struct wsi_present_timing *timing = &chain->images[image_index].base.timing;
+   if (present_id > 0 ||
+       (timing->present_id && chain->present_ids.wp_presentation)) {
       struct wsi_wl_present_id *id =
          vk_zalloc(chain->wsi_wl_surface->display->wsi_wl->alloc, sizeof(*id), sizeof(uintptr_t),
                    VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
       id->chain = chain;
       id->present_id = present_id;
+      id->timing = *timing;
       id->alloc = chain->wsi_wl_surface->display->wsi_wl->alloc;
 
       pthread_mutex_lock(&chain->present_ids.lock);
@@ -2463,6 +2506,7 @@ wsi_wl_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
    chain->base.release_images = wsi_wl_swapchain_release_images;
    chain->base.set_present_mode = wsi_wl_swapchain_set_present_mode;
    chain->base.wait_for_present = wsi_wl_swapchain_wait_for_present;
+   chain->base.poll_presentation_timing = wsi_wl_swapchain_poll_presentation_timing;
    chain->base.present_mode = present_mode;
    chain->base.image_count = num_images;
    chain->extent = pCreateInfo->imageExtent;
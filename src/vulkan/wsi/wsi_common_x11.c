@@ -1047,6 +1047,7 @@ wsi_CreateXlibSurfaceKHR(VkInstance _instance,
 struct x11_image_pending_completion {
    uint32_t serial;
    uint64_t signal_present_id;
+   struct wsi_present_timing timing;
 };
 
 struct x11_image {
@@ -1095,6 +1096,9 @@ struct x11_swapchain {
    xcb_special_event_t *                        special_event;
    uint64_t                                     send_sbc;
    uint64_t                                     last_present_msc;
+   uint64_t                                     last_present_ust;
+   /* Refresh duration in ns derived from COMPLETE events, 0 if unknown */
+   uint64_t                                     refresh_duration;
    uint32_t                                     stamp;
    uint32_t                                     sent_image_count;
 
@@ -1296,16 +1300,30 @@ x11_handle_dri3_present_event(struct x11_swapchain *chain,
    case XCB_PRESENT_EVENT_COMPLETE_NOTIFY: {
       xcb_present_complete_notify_event_t *complete = (void *) event;
       if (complete->kind == XCB_PRESENT_COMPLETE_KIND_PIXMAP) {
+         /* UST is in microseconds of CLOCK_MONOTONIC. */
+         if (chain->last_present_ust &&
+             complete->msc > chain->last_present_msc &&
+             complete->ust > chain->last_present_ust) {
+            chain->refresh_duration =
+               (complete->ust - chain->last_present_ust) * 1000 /
+               (complete->msc - chain->last_present_msc);
+         }
+
          unsigned i, j;
          for (i = 0; i < chain->base.image_count; i++) {
             struct x11_image *image = &chain->images[i];
             for (j = 0; j < image->present_queued_count; j++) {
                if (image->pending_completions[j].serial == complete->serial) {
+                  wsi_swapchain_record_presentation(&chain->base,
+                                                    &image->pending_completions[j].timing,
+                                                    complete->ust * 1000,
+                                                    chain->refresh_duration);
                   x11_present_complete(chain, image, j);
                }
             }
          }
          chain->last_present_msc = complete->msc;
+         chain->last_present_ust = complete->ust;
       }
 
       VkResult result = VK_SUCCESS;
@@ -1406,6 +1424,7 @@ x11_present_to_x11_dri3(struct x11_swapchain *chain, uint32_t image_index,
       (struct x11_image_pending_completion) {
          .signal_present_id = image->present_id,
          .serial = serial,
+         .timing = image->base.timing,
       };
 
    xcb_void_cookie_t cookie;
@@ -1651,6 +1670,30 @@ x11_requires_mailbox_image_count(const struct wsi_device *device,
           present_mode == VK_PRESENT_MODE_MAILBOX_KHR;
 }
 
+/**
+ * Turn the VK_GOOGLE_display_timing desired present time of an image into
+ * a target MSC, extrapolated from the last COMPLETE event.  Times more than
+ * a second away are treated as bogus and ignored.
+ */
+static uint64_t
+x11_paced_target_msc(const struct x11_swapchain *chain, uint32_t image_index,
+                     uint64_t target_msc)
+{
+   const uint64_t desired = chain->images[image_index].base.timing.desired_present_time;
+   const uint64_t last_ns = chain->last_present_ust * 1000;
+
+   if (!desired || !chain->last_present_ust || !chain->refresh_duration)
+      return target_msc;
+
+   if (desired <= last_ns || desired - last_ns > 1000000000ull)
+      return target_msc;
+
+   uint64_t msc = chain->last_present_msc +
+                  DIV_ROUND_UP(desired - last_ns, chain->refresh_duration);
+
+   return MAX2(target_msc, msc);
+}
+
 /**
  * Send image to the X server for presentation at target_msc.
  */
@@ -1964,7 +2007,9 @@ x11_manage_present_queue(void *state)
          break;
       }
 
-      result = x11_present_to_x11(chain, image_index, target_msc, present_mode);
+      result = x11_present_to_x11(chain, image_index,
+                                  x11_paced_target_msc(chain, image_index, target_msc),
+                                  present_mode);
 
       if (result < 0) {
          pthread_mutex_unlock(&chain->thread_state_lock);
@@ -2641,6 +2686,8 @@ x11_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
    chain->send_sbc = 0;
    chain->sent_image_count = 0;
    chain->last_present_msc = 0;
+   chain->last_present_ust = 0;
+   chain->refresh_duration = 0;
    chain->status = VK_SUCCESS;
    chain->has_dri3_modifiers = wsi_conn->has_dri3_modifiers;
    chain->has_mit_shm = wsi_conn->has_mit_shm;